@@ -74,6 +74,8 @@ void CHLMVState::ResetToDefaults()
 
 	drawnPolys = 0;
 
+	skinnedSubModels = 0;
+
 	wireframeOverlay = false;
 
 	backfaceCulling = true;
@@ -90,6 +92,10 @@ void CHLMVState::ResetToDefaults()
 
 	antiAliasUVLines = false;
 
+	fillUVIslands = false;
+
+	uvOverlapHeatmap = false;
+
 	drawAxes = false;
 }
 
@@ -166,6 +172,79 @@ void CHLMVState::SetEntity( CHLMVStudioModelEntity* pEntity )
 		m_pEntity = pEntity;
 }
 
+void CHLMVState::CheckForChanges()
+{
+	ViewSnapshot snapshot;
+
+	if( m_pEntity )
+	{
+		snapshot.pModel = m_pEntity->GetModel();
+		snapshot.iSequence = m_pEntity->GetSequence();
+		snapshot.flFrame = m_pEntity->GetFrame();
+		snapshot.iBodygroup = m_pEntity->GetBodygroup();
+		snapshot.iSkin = m_pEntity->GetSkin();
+
+		for( int i = 0; i < STUDIO_MAX_CONTROLLERS; ++i )
+		{
+			snapshot.uiControllers[ i ] = m_pEntity->GetControllerByIndex( i );
+		}
+
+		for( int i = 0; i < STUDIO_MAX_BLENDERS; ++i )
+		{
+			snapshot.uiBlenders[ i ] = m_pEntity->GetBlendingByIndex( i );
+		}
+
+		snapshot.uiMouth = m_pEntity->GetMouth();
+
+		snapshot.vecOrigin = m_pEntity->GetOrigin();
+		snapshot.vecAngles = m_pEntity->GetAngles();
+		snapshot.vecScale = m_pEntity->GetScale();
+	}
+
+	snapshot.vecCameraOrigin = pCurrentCamera->GetOrigin();
+	snapshot.vecCameraViewDirection = pCurrentCamera->GetViewDirection();
+	snapshot.flFOV = *pCurrentFOV;
+
+	if( !( snapshot == m_ViewSnapshot ) )
+	{
+		m_ViewSnapshot = snapshot;
+		RequestRedraw();
+	}
+}
+
+void CHLMVState::FrameFinished( const bool bDrawn )
+{
+	if( bDrawn )
+	{
+		m_bRedrawRequested = false;
+		++m_ullFramesDrawn;
+	}
+	else
+	{
+		++m_ullFramesSkipped;
+	}
+
+	m_bLastFrameSkipped = !bDrawn;
+}
+
+bool CHLMVState::ViewSnapshot::operator==( const ViewSnapshot& other ) const
+{
+	return pModel == other.pModel
+		&& iSequence == other.iSequence
+		&& flFrame == other.flFrame
+		&& iBodygroup == other.iBodygroup
+		&& iSkin == other.iSkin
+		&& !memcmp( uiControllers, other.uiControllers, sizeof( uiControllers ) )
+		&& !memcmp( uiBlenders, other.uiBlenders, sizeof( uiBlenders ) )
+		&& uiMouth == other.uiMouth
+		&& vecOrigin == other.vecOrigin
+		&& vecAngles == other.vecAngles
+		&& vecScale == other.vecScale
+		&& vecCameraOrigin == other.vecCameraOrigin
+		&& vecCameraViewDirection == other.vecCameraViewDirection
+		&& flFOV == other.flFOV;
+}
+
 void CHLMVState::SetUseWeaponOrigin( const bool bUse )
 {
 	useWeaponOrigin = bUse;
@@ -59,6 +59,61 @@ public:
 
 	bool DumpModelInfo( const char* const pszFilename );
 
+	/**
+	*	@brief Requests that the 3D view is drawn on the next frame
+	*	Changes to the entity and camera are detected by CheckForChanges, everything else must request a redraw.
+	*/
+	void RequestRedraw() { m_bRedrawRequested = true; }
+
+	bool IsRedrawRequested() const { return m_bRedrawRequested; }
+
+	/**
+	*	@brief Compares the entity and camera with what they were the last time this was called, and requests a redraw if anything changed
+	*	Playing animations change the entity's frame, so they are redrawn every frame.
+	*/
+	void CheckForChanges();
+
+	/**
+	*	@brief Must be called by the 3D view every frame, after it decided whether to draw
+	*/
+	void FrameFinished( const bool bDrawn );
+
+	/**
+	*	@brief Whether the last frame was skipped because nothing changed
+	*/
+	bool WasLastFrameSkipped() const { return m_bLastFrameSkipped; }
+
+	unsigned long long GetFramesDrawnCount() const { return m_ullFramesDrawn; }
+
+	unsigned long long GetFramesSkippedCount() const { return m_ullFramesSkipped; }
+
+private:
+	/**
+	*	@brief Everything outside of the settings that affects what the 3D view shows
+	*/
+	struct ViewSnapshot
+	{
+		const studiomdl::CStudioModel* pModel = nullptr;
+
+		int iSequence = 0;
+		float flFrame = 0;
+		int iBodygroup = 0;
+		int iSkin = 0;
+		byte uiControllers[ STUDIO_MAX_CONTROLLERS ] = {};
+		byte uiBlenders[ STUDIO_MAX_BLENDERS ] = {};
+		byte uiMouth = 0;
+
+		glm::vec3 vecOrigin{ 0 };
+		glm::vec3 vecAngles{ 0 };
+		glm::vec3 vecScale{ 0 };
+
+		glm::vec3 vecCameraOrigin{ 0 };
+		glm::vec3 vecCameraViewDirection{ 0 };
+		float flFOV = 0;
+
+		bool operator==( const ViewSnapshot& other ) const;
+	};
+
 public:
 	graphics::CCamera camera;
 
@@ -118,6 +173,11 @@ public:
 	*/
 	unsigned int drawnPolys;
 
+	/**
+	*	How many times a submodel was skinned and lit in the last frame. Passes that reuse an earlier pose, like the wireframe overlay and the mirror, don't add to this.
+	*/
+	unsigned int skinnedSubModels;
+
 	bool wireframeOverlay;
 
 	bool backfaceCulling;
@@ -134,6 +194,11 @@ public:
 
 	bool antiAliasUVLines;
 
+	//Only used by exported UV maps.
+	bool fillUVIslands;
+
+	bool uvOverlapHeatmap;
+
 	bool drawAxes;
 
 	bool drawCrosshair = false;
@@ -147,6 +212,14 @@ public:
 private:
 	CHLMVStudioModelEntity* m_pEntity;
 
+	ViewSnapshot m_ViewSnapshot;
+
+	bool m_bRedrawRequested = true;
+	bool m_bLastFrameSkipped = false;
+
+	unsigned long long m_ullFramesDrawn = 0;
+	unsigned long long m_ullFramesSkipped = 0;
+
 private:
 	CHLMVState( const CHLMVState& ) = delete;
 	CHLMVState& operator=( const CHLMVState& other ) = delete;
@@ -0,0 +1,145 @@
+#ifndef ASSETINDEX_ASSETINDEXFORMAT_H
+#define ASSETINDEX_ASSETINDEXFORMAT_H
+
+#include <cstdint>
+
+/**
+*	@defgroup AssetIndex Asset index
+*
+*	On-disk index of the models and sprites in a game configuration's directories.
+*
+*	The file is designed to be memory mapped and used in place: all sections are arrays of fixed size little endian records,
+*	aligned to 8 bytes and referenced by offset from the start of the file.
+*
+*	@{
+*/
+
+namespace assetindex
+{
+/**
+*	Little-endian "HLAI"
+*/
+const std::uint32_t ASSET_INDEX_ID = ('I' << 24) + ('A' << 16) + ('L' << 8) + 'H';
+
+const std::uint32_t ASSET_INDEX_VERSION = 1;
+
+/**
+*	Alignment of every section in the file.
+*/
+const std::uint32_t ASSET_INDEX_SECTION_ALIGNMENT = 8;
+
+enum class AssetType : std::uint32_t
+{
+	STUDIOMODEL = 0,
+	STUDIOTEXTURES,
+	STUDIOSEQUENCEGROUP,
+	SPRITE
+};
+
+/**
+*	Categories of names that can be searched for. Names are stored in lowercase.
+*/
+enum class TermCategory : std::uint32_t
+{
+	BONE = 0,
+	SEQUENCE,
+
+	/**
+	*	Activity name (e.g. ACT_IDLE), or the number if it's not a known activity.
+	*/
+	ACTIVITY,
+	TEXTURE,
+
+	/**
+	*	Sound played by an animation event.
+	*/
+	SOUND,
+
+	COUNT
+};
+
+struct IndexHeader
+{
+	std::uint32_t id;
+	std::uint32_t version;
+
+	std::uint32_t numAssets;
+	std::uint32_t assetsOffset;
+
+	/**
+	*	Sorted by category, then name.
+	*/
+	std::uint32_t numTerms;
+	std::uint32_t termsOffset;
+
+	/**
+	*	Asset indices of each term, in ascending order.
+	*/
+	std::uint32_t numPostings;
+	std::uint32_t postingsOffset;
+
+	/**
+	*	Term indices of each asset.
+	*/
+	std::uint32_t numAssetTerms;
+	std::uint32_t assetTermsOffset;
+
+	/**
+	*	numAssets asset indices, sorted by polygon count.
+	*/
+	std::uint32_t polygonOrderOffset;
+
+	std::uint32_t stringsSize;
+	std::uint32_t stringsOffset;
+
+	std::uint32_t padding;
+};
+
+struct AssetRecord
+{
+	/**
+	*	Path relative to the base path, using '/' as separator.
+	*/
+	std::uint32_t pathOffset;
+	std::uint32_t type;
+
+	std::int64_t lastWriteTime;
+	std::uint64_t fileSize;
+
+	std::uint32_t numBones;
+	std::uint32_t numSequences;
+	std::uint32_t numTextures;
+
+	/**
+	*	Polygon count of the default body.
+	*/
+	std::uint32_t numPolygons;
+
+	//Sprite only
+	std::uint32_t width;
+	std::uint32_t height;
+	std::uint32_t numFrames;
+
+	std::uint32_t firstTerm;
+	std::uint32_t numTerms;
+
+	std::uint32_t padding;
+};
+
+struct TermRecord
+{
+	std::uint32_t category;
+	std::uint32_t nameOffset;
+
+	std::uint32_t firstPosting;
+	std::uint32_t numPostings;
+};
+
+static_assert(sizeof(IndexHeader) % ASSET_INDEX_SECTION_ALIGNMENT == 0, "Index header must keep sections aligned");
+static_assert(sizeof(AssetRecord) % ASSET_INDEX_SECTION_ALIGNMENT == 0, "Asset records must keep sections aligned");
+static_assert(sizeof(TermRecord) % 4 == 0, "Term records must be 4 byte aligned");
+}
+
+/** @} */
+
+#endif //ASSETINDEX_ASSETINDEXFORMAT_H
@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <string>
+
+#include "CAssetIndex.h"
+
+namespace assetindex
+{
+template<typename T>
+const T* CAssetIndex::GetSection(std::uint32_t offset, std::uint32_t count) const
+{
+	if (offset % alignof(T) != 0 || offset > m_File.GetSize() || (m_File.GetSize() - offset) / sizeof(T) < count)
+	{
+		return nullptr;
+	}
+
+	return reinterpret_cast<const T*>(m_File.GetData() + offset);
+}
+
+bool CAssetIndex::Open(const std::filesystem::path& fileName)
+{
+	Close();
+
+	if (!m_File.Open(fileName))
+	{
+		return false;
+	}
+
+	auto pHeader = GetSection<IndexHeader>(0, 1);
+
+	if (!pHeader || pHeader->id != ASSET_INDEX_ID || pHeader->version != ASSET_INDEX_VERSION)
+	{
+		Close();
+		return false;
+	}
+
+	m_pAssets = GetSection<AssetRecord>(pHeader->assetsOffset, pHeader->numAssets);
+	m_pTerms = GetSection<TermRecord>(pHeader->termsOffset, pHeader->numTerms);
+	m_pPostings = GetSection<std::uint32_t>(pHeader->postingsOffset, pHeader->numPostings);
+	m_pAssetTerms = GetSection<std::uint32_t>(pHeader->assetTermsOffset, pHeader->numAssetTerms);
+	m_pPolygonOrder = GetSection<std::uint32_t>(pHeader->polygonOrderOffset, pHeader->numAssets);
+	m_pStrings = GetSection<char>(pHeader->stringsOffset, pHeader->stringsSize);
+
+	bool valid = m_pAssets && m_pTerms && m_pPostings && m_pAssetTerms && m_pPolygonOrder && m_pStrings
+		&& pHeader->stringsSize > 0 && m_pStrings[pHeader->stringsSize - 1] == '\0';
+
+	//Validate all references up front so queries don't need to
+	for (std::uint32_t index = 0; valid && index < pHeader->numAssets; ++index)
+	{
+		const auto& asset = m_pAssets[index];
+
+		valid = asset.pathOffset < pHeader->stringsSize
+			&& asset.firstTerm <= pHeader->numAssetTerms && asset.numTerms <= pHeader->numAssetTerms - asset.firstTerm
+			&& m_pPolygonOrder[index] < pHeader->numAssets;
+	}
+
+	for (std::uint32_t index = 0; valid && index < pHeader->numTerms; ++index)
+	{
+		const auto& term = m_pTerms[index];
+
+		valid = term.category < static_cast<std::uint32_t>(TermCategory::COUNT)
+			&& term.nameOffset < pHeader->stringsSize
+			&& term.firstPosting <= pHeader->numPostings && term.numPostings <= pHeader->numPostings - term.firstPosting;
+	}
+
+	for (std::uint32_t index = 0; valid && index < pHeader->numPostings; ++index)
+	{
+		valid = m_pPostings[index] < pHeader->numAssets;
+	}
+
+	for (std::uint32_t index = 0; valid && index < pHeader->numAssetTerms; ++index)
+	{
+		valid = m_pAssetTerms[index] < pHeader->numTerms;
+	}
+
+	if (!valid)
+	{
+		Close();
+		return false;
+	}
+
+	m_pHeader = pHeader;
+
+	return true;
+}
+
+void CAssetIndex::Close()
+{
+	m_pHeader = nullptr;
+	m_pAssets = nullptr;
+	m_pTerms = nullptr;
+	m_pPostings = nullptr;
+	m_pAssetTerms = nullptr;
+	m_pPolygonOrder = nullptr;
+	m_pStrings = nullptr;
+
+	m_File.Close();
+}
+
+std::vector<std::pair<TermCategory, const char*>> CAssetIndex::GetAssetTerms(std::uint32_t index) const
+{
+	std::vector<std::pair<TermCategory, const char*>> terms;
+
+	const auto& asset = GetAsset(index);
+
+	terms.reserve(asset.numTerms);
+
+	for (std::uint32_t termIndex = 0; termIndex < asset.numTerms; ++termIndex)
+	{
+		const auto& term = GetTerm(m_pAssetTerms[asset.firstTerm + termIndex]);
+
+		terms.emplace_back(static_cast<TermCategory>(term.category), GetTermName(term));
+	}
+
+	return terms;
+}
+
+std::vector<std::uint32_t> CAssetIndex::FindAssets(TermCategory category, const char* pszName) const
+{
+	std::vector<std::uint32_t> result;
+
+	if (!IsOpen() || !pszName)
+	{
+		return result;
+	}
+
+	std::string name{pszName};
+
+	std::transform(name.begin(), name.end(), name.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+	const bool isPrefix = !name.empty() && name.back() == '*';
+
+	if (isPrefix)
+	{
+		name.pop_back();
+	}
+
+	const auto end = m_pTerms + m_pHeader->numTerms;
+
+	auto it = std::lower_bound(m_pTerms, end, name, [&](const TermRecord& term, const std::string& value)
+		{
+			if (term.category != static_cast<std::uint32_t>(category))
+			{
+				return term.category < static_cast<std::uint32_t>(category);
+			}
+
+			return strcmp(GetTermName(term), value.c_str()) < 0;
+		});
+
+	for (; it != end && it->category == static_cast<std::uint32_t>(category); ++it)
+	{
+		const char* pszTermName = GetTermName(*it);
+
+		if (isPrefix ? strncmp(pszTermName, name.c_str(), name.size()) != 0 : strcmp(pszTermName, name.c_str()) != 0)
+		{
+			break;
+		}
+
+		result.insert(result.end(), m_pPostings + it->firstPosting, m_pPostings + it->firstPosting + it->numPostings);
+
+		if (!isPrefix)
+		{
+			break;
+		}
+	}
+
+	if (isPrefix)
+	{
+		std::sort(result.begin(), result.end());
+		result.erase(std::unique(result.begin(), result.end()), result.end());
+	}
+
+	return result;
+}
+
+std::vector<std::uint32_t> CAssetIndex::FindAssetsByPolygonCount(std::uint32_t minimum, std::uint32_t maximum) const
+{
+	if (!IsOpen() || minimum > maximum)
+	{
+		return {};
+	}
+
+	const auto begin = m_pPolygonOrder;
+	const auto end = m_pPolygonOrder + m_pHeader->numAssets;
+
+	const auto first = std::lower_bound(begin, end, minimum, [this](std::uint32_t index, std::uint32_t value)
+		{
+			return m_pAssets[index].numPolygons < value;
+		});
+
+	const auto last = std::upper_bound(first, end, maximum, [this](std::uint32_t value, std::uint32_t index)
+		{
+			return value < m_pAssets[index].numPolygons;
+		});
+
+	return {first, last};
+}
+}
@@ -0,0 +1,100 @@
+#ifndef ASSETINDEX_CASSETINDEX_H
+#define ASSETINDEX_CASSETINDEX_H
+
+#include <cstdint>
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+#include "utility/CMappedFile.h"
+
+#include "AssetIndexFormat.h"
+
+/**
+*	@ingroup AssetIndex
+*
+*	@{
+*/
+
+namespace assetindex
+{
+/**
+*	@brief Read-only view of an asset index file
+*	The file is memory mapped, so nothing is copied and queries only touch the pages they need.
+*	Opening an index validates every record once, so that costs time linear in the size of the file.
+*/
+class CAssetIndex final
+{
+public:
+	CAssetIndex() = default;
+	~CAssetIndex() = default;
+
+	/**
+	*	@brief Opens and validates the given index file
+	*	Every asset, term and posting is checked, so queries can use the references without checking them again.
+	*	This reads the whole file once.
+	*	@return Whether the file is a valid index of the current version
+	*/
+	bool Open(const std::filesystem::path& fileName);
+
+	void Close();
+
+	bool IsOpen() const { return m_pHeader != nullptr; }
+
+	std::uint32_t GetAssetCount() const { return m_pHeader ? m_pHeader->numAssets : 0; }
+
+	const AssetRecord& GetAsset(std::uint32_t index) const { return m_pAssets[index]; }
+
+	const char* GetAssetPath(const AssetRecord& asset) const { return GetString(asset.pathOffset); }
+
+	std::uint32_t GetTermCount() const { return m_pHeader ? m_pHeader->numTerms : 0; }
+
+	const TermRecord& GetTerm(std::uint32_t index) const { return m_pTerms[index]; }
+
+	const char* GetTermName(const TermRecord& term) const { return GetString(term.nameOffset); }
+
+	/**
+	*	@brief Gets the names indexed for the given asset
+	*/
+	std::vector<std::pair<TermCategory, const char*>> GetAssetTerms(std::uint32_t index) const;
+
+	/**
+	*	@brief Finds all assets that contain the given name, case insensitive
+	*	@param category Category to search in
+	*	@param pszName Name to search for. If it ends with '*', all names starting with the text before it are matched
+	*	@return Sorted list of asset indices
+	*/
+	std::vector<std::uint32_t> FindAssets(TermCategory category, const char* pszName) const;
+
+	/**
+	*	@brief Finds all assets whose polygon count is in the range [minimum, maximum]
+	*	@return List of asset indices, sorted by polygon count
+	*/
+	std::vector<std::uint32_t> FindAssetsByPolygonCount(std::uint32_t minimum, std::uint32_t maximum) const;
+
+private:
+	const char* GetString(std::uint32_t offset) const { return m_pStrings + offset; }
+
+	template<typename T>
+	const T* GetSection(std::uint32_t offset, std::uint32_t count) const;
+
+private:
+	CMappedFile m_File;
+
+	const IndexHeader* m_pHeader = nullptr;
+	const AssetRecord* m_pAssets = nullptr;
+	const TermRecord* m_pTerms = nullptr;
+	const std::uint32_t* m_pPostings = nullptr;
+	const std::uint32_t* m_pAssetTerms = nullptr;
+	const std::uint32_t* m_pPolygonOrder = nullptr;
+	const char* m_pStrings = nullptr;
+
+private:
+	CAssetIndex(const CAssetIndex&) = delete;
+	CAssetIndex& operator=(const CAssetIndex&) = delete;
+};
+}
+
+/** @} */
+
+#endif //ASSETINDEX_CASSETINDEX_H
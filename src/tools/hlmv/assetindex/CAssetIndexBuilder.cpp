@@ -0,0 +1,735 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "shared/Logging.h"
+#include "shared/Platform.h"
+
+#include "engine/shared/activity.h"
+#include "engine/shared/sprite/sprite.h"
+#include "engine/shared/studiomodel/studio.h"
+
+#include "filesystem/CFileSystem.h"
+
+#include "game/Events.h"
+
+#include "settings/CGameConfig.h"
+
+#include "utility/IOUtils.h"
+
+#include "CAssetIndex.h"
+#include "CAssetIndexBuilder.h"
+
+namespace assetindex
+{
+namespace
+{
+std::string ToLower(const char* pszString, size_t maxLength)
+{
+	std::string result{pszString, strnlen(pszString, maxLength)};
+
+	std::transform(result.begin(), result.end(), result.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+	return result;
+}
+
+std::string GetActivityName(int activity)
+{
+	for (const activity_map_t* pEntry = activity_map; pEntry->name; ++pEntry)
+	{
+		if (pEntry->type == activity)
+		{
+			return ToLower(pEntry->name, strlen(pEntry->name));
+		}
+	}
+
+	return std::to_string(activity);
+}
+
+/**
+*	Reads tables from a file, making sure they are within the file's bounds.
+*/
+class CTableReader final
+{
+public:
+	CTableReader(FILE* file, long fileSize)
+		: m_File(file)
+		, m_FileSize(fileSize)
+	{
+	}
+
+	template<typename T>
+	bool Read(int offset, int count, std::vector<T>& data)
+	{
+		data.clear();
+
+		if (offset < 0 || count < 0 || offset > m_FileSize || static_cast<long>((m_FileSize - offset) / sizeof(T)) < count)
+		{
+			return false;
+		}
+
+		if (count == 0)
+		{
+			return true;
+		}
+
+		data.resize(count);
+
+		return fseek(m_File, offset, SEEK_SET) == 0 && fread(data.data(), sizeof(T), count, m_File) == static_cast<size_t>(count);
+	}
+
+private:
+	FILE* const m_File;
+	const long m_FileSize;
+};
+
+bool ReadStudioModelInfo(FILE* file, long fileSize, AssetInfo& info)
+{
+	CTableReader reader{file, fileSize};
+
+	std::vector<studiohdr_t> header;
+
+	if (!reader.Read(0, 1, header))
+	{
+		return false;
+	}
+
+	const auto& hdr = header[0];
+
+	if (hdr.version != STUDIO_VERSION)
+	{
+		return false;
+	}
+
+	if (!strncmp(reinterpret_cast<const char*>(&hdr.id), STUDIOMDL_SEQ_ID, 4))
+	{
+		info.Type = AssetType::STUDIOSEQUENCEGROUP;
+		return true;
+	}
+
+	if (strncmp(reinterpret_cast<const char*>(&hdr.id), STUDIOMDL_HDR_ID, 4))
+	{
+		return false;
+	}
+
+	info.Type = hdr.name[0] != '\0' ? AssetType::STUDIOMODEL : AssetType::STUDIOTEXTURES;
+
+	std::vector<mstudiotexture_t> textures;
+
+	if (reader.Read(hdr.textureindex, hdr.numtextures, textures))
+	{
+		info.NumTextures = textures.size();
+
+		for (const auto& texture : textures)
+		{
+			info.Terms.emplace_back(TermCategory::TEXTURE, ToLower(texture.name, sizeof(texture.name)));
+		}
+	}
+
+	if (info.Type == AssetType::STUDIOTEXTURES)
+	{
+		return true;
+	}
+
+	std::vector<mstudiobone_t> bones;
+
+	if (reader.Read(hdr.boneindex, hdr.numbones, bones))
+	{
+		info.NumBones = bones.size();
+
+		for (const auto& bone : bones)
+		{
+			info.Terms.emplace_back(TermCategory::BONE, ToLower(bone.name, sizeof(bone.name)));
+		}
+	}
+
+	std::vector<mstudioseqdesc_t> sequences;
+
+	if (reader.Read(hdr.seqindex, hdr.numseq, sequences))
+	{
+		info.NumSequences = sequences.size();
+
+		std::vector<mstudioevent_t> events;
+
+		for (const auto& sequence : sequences)
+		{
+			info.Terms.emplace_back(TermCategory::SEQUENCE, ToLower(sequence.label, sizeof(sequence.label)));
+
+			if (sequence.activity != 0)
+			{
+				info.Terms.emplace_back(TermCategory::ACTIVITY, GetActivityName(sequence.activity));
+			}
+
+			if (reader.Read(sequence.eventindex, std::min(sequence.numevents, static_cast<int>(MAXSTUDIOEVENTS)), events))
+			{
+				for (const auto& event : events)
+				{
+					switch (event.event)
+					{
+					case SCRIPT_EVENT_SOUND:
+					case SCRIPT_EVENT_SOUND_VOICE:
+					case SCRIPT_CLIENT_EVENT_SOUND:
+						info.Terms.emplace_back(TermCategory::SOUND, ToLower(event.options, sizeof(event.options)));
+						break;
+
+					default: break;
+					}
+				}
+			}
+		}
+	}
+
+	//Count the polygons in the default body, i.e. the first model of every body part
+	std::vector<mstudiobodyparts_t> bodyparts;
+	std::vector<mstudiomodel_t> models;
+	std::vector<mstudiomesh_t> meshes;
+
+	if (reader.Read(hdr.bodypartindex, hdr.numbodyparts, bodyparts))
+	{
+		for (const auto& bodypart : bodyparts)
+		{
+			if (bodypart.nummodels > 0 && reader.Read(bodypart.modelindex, 1, models)
+				&& reader.Read(models[0].meshindex, models[0].nummesh, meshes))
+			{
+				for (const auto& mesh : meshes)
+				{
+					info.NumPolygons += std::max(mesh.numtris, 0);
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+bool ReadSpriteInfo(FILE* file, long fileSize, AssetInfo& info)
+{
+	CTableReader reader{file, fileSize};
+
+	std::vector<sprite::dsprite_t> header;
+
+	if (!reader.Read(0, 1, header) || header[0].version != SPRITE_VERSION)
+	{
+		return false;
+	}
+
+	info.Type = AssetType::SPRITE;
+	info.Width = std::max(header[0].width, 0);
+	info.Height = std::max(header[0].height, 0);
+	info.NumFrames = std::max(header[0].numframes, 0);
+
+	return true;
+}
+
+bool IsIndexedExtension(const std::filesystem::path& fileName)
+{
+	const auto extension = fileName.extension().u8string();
+
+	return !strcasecmp(extension.c_str(), ".mdl") || !strcasecmp(extension.c_str(), ".spr");
+}
+
+/**
+*	Runs the given function on all available cores until it returns false.
+*/
+template<typename FUNCTION>
+void RunOnAllCores(FUNCTION function)
+{
+	const unsigned int numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	std::vector<std::thread> threads;
+
+	threads.reserve(numThreads - 1);
+
+	for (unsigned int index = 1; index < numThreads; ++index)
+	{
+		threads.emplace_back([&] { while (function()) {} });
+	}
+
+	while (function()) {}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+struct FoundFile
+{
+	std::filesystem::path FileName;
+	std::string Path;
+	std::int64_t LastWriteTime;
+	std::uint64_t FileSize;
+};
+
+std::uint32_t AlignSection(std::uint32_t offset)
+{
+	return (offset + ASSET_INDEX_SECTION_ALIGNMENT - 1) & ~(ASSET_INDEX_SECTION_ALIGNMENT - 1);
+}
+}
+
+bool ReadAssetInfo(const std::filesystem::path& fileName, AssetInfo& info)
+{
+	info.Type = AssetType::STUDIOMODEL;
+	info.NumBones = info.NumSequences = info.NumTextures = info.NumPolygons = 0;
+	info.Width = info.Height = info.NumFrames = 0;
+	info.Terms.clear();
+
+	FILE* file = utf8_fopen(fileName.u8string().c_str(), "rb");
+
+	if (!file)
+	{
+		return false;
+	}
+
+	bool success = false;
+
+	int id;
+
+	if (fseek(file, 0, SEEK_END) == 0)
+	{
+		const long fileSize = ftell(file);
+
+		if (fileSize > 0 && fseek(file, 0, SEEK_SET) == 0 && fread(&id, sizeof(id), 1, file) == 1)
+		{
+			success = id == SPRITE_ID ? ReadSpriteInfo(file, fileSize, info) : ReadStudioModelInfo(file, fileSize, info);
+		}
+	}
+
+	fclose(file);
+
+	//Names are deduplicated per asset; the counts still reflect the actual number of bones, sequences, etc
+	std::sort(info.Terms.begin(), info.Terms.end());
+	info.Terms.erase(std::unique(info.Terms.begin(), info.Terms.end()), info.Terms.end());
+
+	return success;
+}
+
+std::vector<AssetInfo> CAssetIndexBuilder::Collect(const settings::CGameConfig& config, const CAssetIndex* pPrevious, BuildStatistics* pStatistics)
+{
+	BuildStatistics statistics;
+
+	const auto basePath = std::filesystem::u8path(config.GetBasePath());
+
+	//Collect the directories to index. Mod and game directories can be the same.
+	std::vector<std::string> directories;
+
+	{
+		filesystem::CFileSystem fileSystem;
+
+		const char* const* ppszDirectoryExts;
+
+		const size_t uiNumExts = fileSystem.GetSteamPipeDirectoryExtensions(ppszDirectoryExts);
+
+		for (const char* pszDirectory : {config.GetModDir(), config.GetGameDir()})
+		{
+			if (!(*pszDirectory))
+			{
+				continue;
+			}
+
+			for (size_t uiIndex = 0; uiIndex < uiNumExts; ++uiIndex)
+			{
+				std::string directory{std::string{pszDirectory} + ppszDirectoryExts[uiIndex]};
+
+				if (std::find(directories.begin(), directories.end(), directory) == directories.end())
+				{
+					directories.emplace_back(std::move(directory));
+				}
+			}
+		}
+	}
+
+	//Walk the top level subdirectories of each directory in parallel
+	std::vector<std::filesystem::path> walkRoots;
+	std::vector<std::filesystem::path> topLevelFiles;
+
+	for (const auto& directory : directories)
+	{
+		std::error_code error;
+
+		for (std::filesystem::directory_iterator it{basePath / std::filesystem::u8path(directory), error}, end; !error && it != end; it.increment(error))
+		{
+			std::error_code typeError;
+
+			if (it->is_directory(typeError))
+			{
+				walkRoots.emplace_back(it->path());
+			}
+			else if (it->is_regular_file(typeError) && IsIndexedExtension(it->path()))
+			{
+				topLevelFiles.emplace_back(it->path());
+			}
+		}
+	}
+
+	std::vector<FoundFile> files;
+	std::mutex filesMutex;
+
+	auto addFile = [&](const std::filesystem::path& path, std::vector<FoundFile>& list)
+	{
+		std::error_code error;
+
+		FoundFile file;
+
+		file.FileSize = std::filesystem::file_size(path, error);
+
+		if (error)
+		{
+			return;
+		}
+
+		file.LastWriteTime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+
+		if (error)
+		{
+			return;
+		}
+
+		file.Path = std::filesystem::relative(path, basePath, error).generic_u8string();
+
+		if (error)
+		{
+			return;
+		}
+
+		file.FileName = path;
+
+		list.emplace_back(std::move(file));
+	};
+
+	for (const auto& path : topLevelFiles)
+	{
+		addFile(path, files);
+	}
+
+	{
+		std::atomic<size_t> nextRoot{0};
+
+		RunOnAllCores([&]
+			{
+				const size_t index = nextRoot++;
+
+				if (index >= walkRoots.size())
+				{
+					return false;
+				}
+
+				std::vector<FoundFile> found;
+
+				std::error_code error;
+
+				for (std::filesystem::recursive_directory_iterator it{walkRoots[index], error}, end; !error && it != end; it.increment(error))
+				{
+					std::error_code typeError;
+
+					if (it->is_regular_file(typeError) && IsIndexedExtension(it->path()))
+					{
+						addFile(it->path(), found);
+					}
+				}
+
+				std::lock_guard<std::mutex> lock(filesMutex);
+
+				files.insert(files.end(), std::make_move_iterator(found.begin()), std::make_move_iterator(found.end()));
+
+				return true;
+			});
+	}
+
+	//Sort so the index is deterministic regardless of thread scheduling
+	std::sort(files.begin(), files.end(), [](const FoundFile& lhs, const FoundFile& rhs) { return lhs.Path < rhs.Path; });
+
+	std::unordered_map<std::string, std::uint32_t> previousAssets;
+
+	if (pPrevious && pPrevious->IsOpen())
+	{
+		previousAssets.reserve(pPrevious->GetAssetCount());
+
+		for (std::uint32_t index = 0; index < pPrevious->GetAssetCount(); ++index)
+		{
+			previousAssets.emplace(pPrevious->GetAssetPath(pPrevious->GetAsset(index)), index);
+		}
+	}
+
+	//Parse the files that are new or have changed
+	std::vector<AssetInfo> assets{files.size()};
+	std::vector<char> valid(files.size(), false);
+
+	{
+		std::atomic<size_t> nextFile{0};
+		std::atomic<std::uint32_t> numReused{0};
+		std::atomic<std::uint32_t> numParsed{0};
+
+		RunOnAllCores([&]
+			{
+				const size_t index = nextFile++;
+
+				if (index >= files.size())
+				{
+					return false;
+				}
+
+				const auto& file = files[index];
+				auto& asset = assets[index];
+
+				asset.Path = file.Path;
+				asset.LastWriteTime = file.LastWriteTime;
+				asset.FileSize = file.FileSize;
+
+				if (auto it = previousAssets.find(file.Path); it != previousAssets.end())
+				{
+					const auto& record = pPrevious->GetAsset(it->second);
+
+					if (record.lastWriteTime == file.LastWriteTime && record.fileSize == file.FileSize)
+					{
+						asset.Type = static_cast<AssetType>(record.type);
+						asset.NumBones = record.numBones;
+						asset.NumSequences = record.numSequences;
+						asset.NumTextures = record.numTextures;
+						asset.NumPolygons = record.numPolygons;
+						asset.Width = record.width;
+						asset.Height = record.height;
+						asset.NumFrames = record.numFrames;
+
+						for (const auto& term : pPrevious->GetAssetTerms(it->second))
+						{
+							asset.Terms.emplace_back(term.first, term.second);
+						}
+
+						valid[index] = true;
+						++numReused;
+
+						return true;
+					}
+				}
+
+				valid[index] = ReadAssetInfo(file.FileName, asset);
+				++numParsed;
+
+				return true;
+			});
+
+		statistics.NumReused = numReused;
+		statistics.NumParsed = numParsed;
+	}
+
+	std::vector<AssetInfo> validAssets;
+
+	validAssets.reserve(assets.size());
+
+	for (size_t index = 0; index < assets.size(); ++index)
+	{
+		if (valid[index])
+		{
+			validAssets.emplace_back(std::move(assets[index]));
+		}
+		else
+		{
+			++statistics.NumInvalid;
+		}
+	}
+
+	statistics.NumAssets = validAssets.size();
+
+	if (pStatistics)
+	{
+		*pStatistics = statistics;
+	}
+
+	return validAssets;
+}
+
+bool CAssetIndexBuilder::Write(const std::filesystem::path& fileName, const std::vector<AssetInfo>& assets)
+{
+	//Build the string pool and the inverted tables
+	std::vector<char> strings{'\0'};
+	std::unordered_map<std::string, std::uint32_t> stringOffsets;
+
+	auto addString = [&](const std::string& string)
+	{
+		auto it = stringOffsets.find(string);
+
+		if (it == stringOffsets.end())
+		{
+			it = stringOffsets.emplace(string, static_cast<std::uint32_t>(strings.size())).first;
+			strings.insert(strings.end(), string.c_str(), string.c_str() + string.size() + 1);
+		}
+
+		return it->second;
+	};
+
+	struct InvertedEntry
+	{
+		std::uint32_t TermIndex = 0;
+		std::vector<std::uint32_t> Postings;
+	};
+
+	std::map<std::pair<TermCategory, std::string>, InvertedEntry> inverted;
+
+	for (std::uint32_t index = 0; index < assets.size(); ++index)
+	{
+		for (const auto& term : assets[index].Terms)
+		{
+			inverted[term].Postings.push_back(index);
+		}
+	}
+
+	std::vector<TermRecord> terms;
+	std::vector<std::uint32_t> postings;
+
+	terms.reserve(inverted.size());
+
+	for (auto& entry : inverted)
+	{
+		TermRecord term;
+
+		term.category = static_cast<std::uint32_t>(entry.first.first);
+		term.nameOffset = addString(entry.first.second);
+		term.firstPosting = postings.size();
+		term.numPostings = entry.second.Postings.size();
+
+		postings.insert(postings.end(), entry.second.Postings.begin(), entry.second.Postings.end());
+
+		entry.second.TermIndex = terms.size();
+
+		terms.emplace_back(term);
+	}
+
+	std::vector<AssetRecord> records;
+	std::vector<std::uint32_t> assetTerms;
+
+	records.reserve(assets.size());
+
+	for (const auto& asset : assets)
+	{
+		AssetRecord record{};
+
+		record.pathOffset = addString(asset.Path);
+		record.type = static_cast<std::uint32_t>(asset.Type);
+		record.lastWriteTime = asset.LastWriteTime;
+		record.fileSize = asset.FileSize;
+		record.numBones = asset.NumBones;
+		record.numSequences = asset.NumSequences;
+		record.numTextures = asset.NumTextures;
+		record.numPolygons = asset.NumPolygons;
+		record.width = asset.Width;
+		record.height = asset.Height;
+		record.numFrames = asset.NumFrames;
+		record.firstTerm = assetTerms.size();
+		record.numTerms = asset.Terms.size();
+
+		for (const auto& term : asset.Terms)
+		{
+			assetTerms.push_back(inverted.find(term)->second.TermIndex);
+		}
+
+		records.emplace_back(record);
+	}
+
+	std::vector<std::uint32_t> polygonOrder(assets.size());
+
+	for (std::uint32_t index = 0; index < polygonOrder.size(); ++index)
+	{
+		polygonOrder[index] = index;
+	}
+
+	std::stable_sort(polygonOrder.begin(), polygonOrder.end(), [&](std::uint32_t lhs, std::uint32_t rhs)
+		{
+			return records[lhs].numPolygons < records[rhs].numPolygons;
+		});
+
+	IndexHeader header{};
+
+	header.id = ASSET_INDEX_ID;
+	header.version = ASSET_INDEX_VERSION;
+
+	std::uint32_t offset = sizeof(IndexHeader);
+
+	auto placeSection = [&](std::uint32_t& sectionOffset, size_t size)
+	{
+		sectionOffset = offset = AlignSection(offset);
+		offset += size;
+	};
+
+	header.numAssets = records.size();
+	placeSection(header.assetsOffset, records.size() * sizeof(AssetRecord));
+
+	header.numTerms = terms.size();
+	placeSection(header.termsOffset, terms.size() * sizeof(TermRecord));
+
+	header.numPostings = postings.size();
+	placeSection(header.postingsOffset, postings.size() * sizeof(std::uint32_t));
+
+	header.numAssetTerms = assetTerms.size();
+	placeSection(header.assetTermsOffset, assetTerms.size() * sizeof(std::uint32_t));
+
+	placeSection(header.polygonOrderOffset, polygonOrder.size() * sizeof(std::uint32_t));
+
+	header.stringsSize = strings.size();
+	placeSection(header.stringsOffset, strings.size());
+
+	//Write to a temporary file first so readers never see a partially written index
+	auto tempFileName = fileName;
+	tempFileName += ".tmp";
+
+	FILE* file = utf8_fopen(tempFileName.u8string().c_str(), "wb");
+
+	if (!file)
+	{
+		Error("CAssetIndexBuilder::Write: Couldn't open \"%s\" for writing\n", tempFileName.u8string().c_str());
+		return false;
+	}
+
+	std::uint32_t written = 0;
+	bool success = true;
+
+	auto writeSection = [&](std::uint32_t sectionOffset, const void* pData, size_t size)
+	{
+		static const char padding[ASSET_INDEX_SECTION_ALIGNMENT] = {};
+
+		if (sectionOffset > written)
+		{
+			success = success && fwrite(padding, sectionOffset - written, 1, file) == 1;
+		}
+
+		if (size > 0)
+		{
+			success = success && fwrite(pData, size, 1, file) == 1;
+		}
+
+		written = sectionOffset + size;
+	};
+
+	writeSection(0, &header, sizeof(header));
+	writeSection(header.assetsOffset, records.data(), records.size() * sizeof(AssetRecord));
+	writeSection(header.termsOffset, terms.data(), terms.size() * sizeof(TermRecord));
+	writeSection(header.postingsOffset, postings.data(), postings.size() * sizeof(std::uint32_t));
+	writeSection(header.assetTermsOffset, assetTerms.data(), assetTerms.size() * sizeof(std::uint32_t));
+	writeSection(header.polygonOrderOffset, polygonOrder.data(), polygonOrder.size() * sizeof(std::uint32_t));
+	writeSection(header.stringsOffset, strings.data(), strings.size());
+
+	success = fclose(file) == 0 && success;
+
+	std::error_code error;
+
+	if (success)
+	{
+		std::filesystem::rename(tempFileName, fileName, error);
+	}
+
+	if (!success || error)
+	{
+		Error("CAssetIndexBuilder::Write: Couldn't write \"%s\"\n", fileName.u8string().c_str());
+		std::filesystem::remove(tempFileName, error);
+		return false;
+	}
+
+	return true;
+}
+}
@@ -0,0 +1,111 @@
+#ifndef ASSETINDEX_CASSETINDEXBUILDER_H
+#define ASSETINDEX_CASSETINDEXBUILDER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AssetIndexFormat.h"
+
+namespace settings
+{
+class CGameConfig;
+}
+
+/**
+*	@ingroup AssetIndex
+*
+*	@{
+*/
+
+namespace assetindex
+{
+class CAssetIndex;
+
+/**
+*	@brief Information extracted from a single asset
+*/
+struct AssetInfo
+{
+	/**
+	*	Path relative to the base path, using '/' as separator.
+	*/
+	std::string Path;
+
+	AssetType Type = AssetType::STUDIOMODEL;
+
+	std::int64_t LastWriteTime = 0;
+	std::uint64_t FileSize = 0;
+
+	std::uint32_t NumBones = 0;
+	std::uint32_t NumSequences = 0;
+	std::uint32_t NumTextures = 0;
+	std::uint32_t NumPolygons = 0;
+
+	std::uint32_t Width = 0;
+	std::uint32_t Height = 0;
+	std::uint32_t NumFrames = 0;
+
+	std::vector<std::pair<TermCategory, std::string>> Terms;
+};
+
+/**
+*	@brief Reads the header and name tables of a studio model or sprite
+*	Only the tables needed for the index are read; vertex and animation data are skipped.
+*	@param fileName File to read
+*	@param info Receives the asset's information. Path, LastWriteTime and FileSize are left untouched
+*	@return Whether the file is a valid studio model or sprite
+*/
+bool ReadAssetInfo(const std::filesystem::path& fileName, AssetInfo& info);
+
+struct BuildStatistics
+{
+	std::uint32_t NumAssets = 0;
+
+	/**
+	*	Number of assets whose information was taken from the previous index because they did not change.
+	*/
+	std::uint32_t NumReused = 0;
+
+	std::uint32_t NumParsed = 0;
+	std::uint32_t NumInvalid = 0;
+};
+
+/**
+*	@brief Builds asset indices for game configurations
+*/
+class CAssetIndexBuilder final
+{
+public:
+	CAssetIndexBuilder() = default;
+	~CAssetIndexBuilder() = default;
+
+	/**
+	*	@brief Collects all models and sprites in the game and mod directories of the given configuration, including SteamPipe variants
+	*	Directories are walked and files are parsed on all available cores.
+	*	@param config Configuration whose directories to index
+	*	@param pPrevious Optional previous index. Files whose size and modification time are unchanged are taken from it instead of being parsed again.
+	*		The returned assets do not reference it, so it can be closed before writing the new index
+	*	@param pStatistics Optional statistics about the collection
+	*	@return Valid assets, sorted by path
+	*/
+	std::vector<AssetInfo> Collect(const settings::CGameConfig& config, const CAssetIndex* pPrevious, BuildStatistics* pStatistics = nullptr);
+
+	/**
+	*	@brief Writes an index containing the given assets
+	*	The index is written to a temporary file first and then moved into place, so a failed write never leaves a partial index behind.
+	*	On Windows the destination must not be open in a CAssetIndex.
+	*/
+	static bool Write(const std::filesystem::path& fileName, const std::vector<AssetInfo>& assets);
+
+private:
+	CAssetIndexBuilder(const CAssetIndexBuilder&) = delete;
+	CAssetIndexBuilder& operator=(const CAssetIndexBuilder&) = delete;
+};
+}
+
+/** @} */
+
+#endif //ASSETINDEX_CASSETINDEXBUILDER_H
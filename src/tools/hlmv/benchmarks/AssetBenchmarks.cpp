@@ -0,0 +1,369 @@
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "shared/Logging.h"
+
+#include "shared/sprite/CSprite.h"
+#include "shared/studiomodel/CStudioModel.h"
+#include "shared/studiomodel/StudioTextureFiles.h"
+#include "shared/studiomodel/TriangleCommands.h"
+
+#include "graphics/Palette.h"
+
+#include "keyvalues/Keyvalues.h"
+
+#include "modelinfo/ModelInfo.h"
+
+#include "utility/CBackgroundJobs.h"
+
+#include "Benchmarks.h"
+#include "CBenchmarkRunner.h"
+
+namespace benchmarks
+{
+namespace
+{
+std::uint64_t GetFileSize(const std::filesystem::path& fileName)
+{
+	std::error_code error;
+
+	const auto size = std::filesystem::file_size(fileName, error);
+
+	return error ? 0 : static_cast<std::uint64_t>(size);
+}
+
+/**
+*	@brief Collects the triangle commands of every mesh in every submodel
+*/
+std::vector<const short*> GetTriangleCommands(const studiohdr_t& header)
+{
+	std::vector<const short*> triCmds;
+
+	for (int bodypart = 0; bodypart < header.numbodyparts; ++bodypart)
+	{
+		const auto pBodypart = header.GetBodypart(bodypart);
+
+		const auto pModels = reinterpret_cast<const mstudiomodel_t*>(header.GetData() + pBodypart->modelindex);
+
+		for (int model = 0; model < pBodypart->nummodels; ++model)
+		{
+			const auto pMeshes = reinterpret_cast<const mstudiomesh_t*>(header.GetData() + pModels[model].meshindex);
+
+			for (int mesh = 0; mesh < pModels[model].nummesh; ++mesh)
+			{
+				triCmds.push_back(reinterpret_cast<const short*>(header.GetData() + pMeshes[mesh].triindex));
+			}
+		}
+	}
+
+	return triCmds;
+}
+
+/**
+*	@brief Times exporting all textures of a model to BMP files and loading them back for import, on all cores and on one,
+*	and checks that the files round trip to the original pixels and palettes
+*/
+void RunTextureFileBenchmarks(CBenchmarkRunner& runner, const BenchmarkAsset& asset, const studiomdl::CStudioModel& model)
+{
+	const auto& textureHdr = *model.GetTextureHeader();
+
+	if (textureHdr.numtextures == 0)
+	{
+		return;
+	}
+
+	auto directory = asset.FileName;
+
+	directory.replace_extension();
+	directory += "_textures";
+
+	std::error_code error;
+
+	std::filesystem::create_directories(directory, error);
+
+	std::vector<std::string> fileNames;
+	std::uint64_t bytes = 0;
+
+	for (int i = 0; i < textureHdr.numtextures; ++i)
+	{
+		const auto& texture = *textureHdr.GetTexture(i);
+
+		fileNames.emplace_back((directory / (std::to_string(i) + ".bmp")).u8string());
+		bytes += static_cast<std::uint64_t>(texture.width) * texture.height + PALETTE_SIZE;
+	}
+
+	auto exportAll = [&](const unsigned int numThreads)
+	{
+		std::vector<studiomdl::TextureFileResult> results(fileNames.size());
+
+		{
+			CBackgroundJobs jobs(fileNames.size(), [&](std::size_t index)
+				{
+					results[index] = studiomdl::ExportTextureFile(textureHdr, static_cast<int>(index), fileNames[index].c_str());
+				}, numThreads);
+
+			jobs.Wait();
+		}
+
+		return results;
+	};
+
+	auto loadAll = [&](const unsigned int numThreads)
+	{
+		std::vector<studiomdl::TextureImport> imports(fileNames.size());
+
+		for (size_t i = 0; i < imports.size(); ++i)
+		{
+			imports[i].Texture = static_cast<int>(i);
+			imports[i].FileName = fileNames[i];
+		}
+
+		{
+			CBackgroundJobs jobs(imports.size(), [&](std::size_t index)
+				{
+					studiomdl::LoadTextureImport(textureHdr, imports[index], true);
+				}, numThreads);
+
+			jobs.Wait();
+		}
+
+		return imports;
+	};
+
+	const auto results = exportAll(0);
+	const auto imports = loadAll(0);
+
+	for (int i = 0; i < textureHdr.numtextures; ++i)
+	{
+		const auto& texture = *textureHdr.GetTexture(i);
+
+		const auto pPixels = textureHdr.GetData() + texture.index;
+
+		const size_t pixels = static_cast<size_t>(texture.width) * texture.height;
+
+		if (results[i] != studiomdl::TextureFileResult::SUCCESS || imports[i].Result != studiomdl::TextureFileResult::SUCCESS)
+		{
+			Error("Texture %d of \"%s\" could not be exported and imported: %s\n", i, asset.Name.c_str(),
+				studiomdl::TextureFileResultToString(results[i] != studiomdl::TextureFileResult::SUCCESS ? results[i] : imports[i].Result));
+			return;
+		}
+
+		if (imports[i].Pixels.size() != pixels || memcmp(imports[i].Pixels.data(), pPixels, pixels)
+			|| memcmp(imports[i].Palette, pPixels + pixels, PALETTE_SIZE))
+		{
+			Error("Texture %d of \"%s\" does not round trip through a BMP file\n", i, asset.Name.c_str());
+			return;
+		}
+	}
+
+	//Items are textures, bytes are the pixels and palettes written or read
+	for (const unsigned int numThreads : {0u, 1u})
+	{
+		const std::string suffix = numThreads == 1 ? "/SingleThread" : "";
+
+		runner.Run("ExportTextureFiles/" + asset.Name + suffix, fileNames.size(), bytes, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					DoNotOptimize(exportAll(numThreads));
+				}
+			});
+
+		runner.Run("LoadTextureFiles/" + asset.Name + suffix, fileNames.size(), bytes, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					DoNotOptimize(loadAll(numThreads));
+				}
+			});
+	}
+}
+
+void RunModelBenchmarks(CBenchmarkRunner& runner, const BenchmarkAsset& asset)
+{
+	const auto fileSize = GetFileSize(asset.FileName);
+
+	const auto fileName = asset.FileName.u8string();
+
+	std::unique_ptr<studiomdl::CStudioModel> model;
+
+	try
+	{
+		model = LoadBenchmarkModel(asset.FileName);
+	}
+	catch (const studiomdl::StudioModelException& e)
+	{
+		Error("Couldn't load model \"%s\": %s\n", fileName.c_str(), e.what());
+		return;
+	}
+
+	runner.Run("LoadStudioHeader/" + asset.Name, 1, fileSize, [&](std::uint64_t uiIterations)
+		{
+			for (std::uint64_t i = 0; i < uiIterations; ++i)
+			{
+				auto header = studiomdl::LoadStudioHeader<studiohdr_t>(fileName.c_str(), false);
+				DoNotOptimize(header);
+			}
+		});
+
+	const auto triCmds = GetTriangleCommands(*model->GetStudioHeader());
+
+	std::uint64_t triangles = 0;
+
+	for (auto pTriCmds : triCmds)
+	{
+		triangles += studiomdl::DecodeTriangleCommands(pTriCmds, [](const short*, const short*, const short*) {});
+	}
+
+	runner.Run("DecodeTriangleCommands/" + asset.Name, triangles, 0, [&](std::uint64_t uiIterations)
+		{
+			for (std::uint64_t i = 0; i < uiIterations; ++i)
+			{
+				int sum = 0;
+
+				for (auto pTriCmds : triCmds)
+				{
+					studiomdl::DecodeTriangleCommands(pTriCmds, [&](const short* pVertex0, const short* pVertex1, const short* pVertex2)
+						{
+							sum += pVertex0[0] + pVertex1[0] + pVertex2[0];
+						});
+				}
+
+				DoNotOptimize(sum);
+			}
+		});
+
+	const auto pTextureHdr = model->GetTextureHeader();
+
+	if (pTextureHdr->numtextures > 0)
+	{
+		const auto& texture = *pTextureHdr->GetTexture(0);
+
+		const auto pPixels = pTextureHdr->GetData() + texture.index;
+
+		const std::uint64_t pixels = static_cast<std::uint64_t>(texture.width) * texture.height;
+
+		//Conversion modifies the palette of masked textures
+		byte palette[PALETTE_SIZE];
+
+		memcpy(palette, pPixels + pixels, sizeof(palette));
+
+		const std::string textureName = asset.Name + "/" + std::to_string(texture.width) + "x" + std::to_string(texture.height);
+
+		for (const bool bPowerOf2 : {false, true})
+		{
+			runner.Run("ConvertTextureToRGBA/" + textureName + (bPowerOf2 ? "/PowerOf2" : ""), pixels, pixels, [&](std::uint64_t uiIterations)
+				{
+					for (std::uint64_t i = 0; i < uiIterations; ++i)
+					{
+						int width, height;
+
+						auto rgba = studiomdl::ConvertTextureToRGBA(texture, pPixels, palette, bPowerOf2, width, height);
+						DoNotOptimize(rgba);
+					}
+				});
+		}
+	}
+
+	RunTextureFileBenchmarks(runner, asset, *model);
+
+	std::string json;
+
+	if (modelinfo::WriteModelInfo(asset.FileName, asset.Name, json) != modelinfo::ModelInfoResult::WRITTEN)
+	{
+		Error("Couldn't write information of model \"%s\": %s\n", fileName.c_str(), json.c_str());
+		return;
+	}
+
+	runner.Run("WriteModelInfo/" + asset.Name, 1, fileSize, [&](std::uint64_t uiIterations)
+		{
+			for (std::uint64_t i = 0; i < uiIterations; ++i)
+			{
+				json.clear();
+				modelinfo::WriteModelInfo(asset.FileName, asset.Name, json);
+				DoNotOptimize(json);
+			}
+		});
+}
+
+void RunSpriteBenchmarks(CBenchmarkRunner& runner, const BenchmarkAsset& asset)
+{
+	const auto fileName = asset.FileName.u8string();
+
+	runner.Run("LoadSprite/" + asset.Name, 1, GetFileSize(asset.FileName), [&](std::uint64_t uiIterations)
+		{
+			for (std::uint64_t i = 0; i < uiIterations; ++i)
+			{
+				sprite::msprite_t* pSprite;
+
+				if (!sprite::LoadSprite(fileName.c_str(), pSprite, false))
+				{
+					Error("Couldn't load sprite \"%s\"\n", fileName.c_str());
+					return;
+				}
+
+				DoNotOptimize(pSprite);
+
+				sprite::FreeSprite(pSprite);
+			}
+		});
+}
+
+void RunKeyvaluesBenchmarks(CBenchmarkRunner& runner, const BenchmarkAsset& asset)
+{
+	std::ifstream stream(asset.FileName, std::ios::binary);
+
+	const std::vector<char> text{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+
+	if (text.empty())
+	{
+		Error("Couldn't read keyvalues file \"%s\"\n", asset.FileName.u8string().c_str());
+		return;
+	}
+
+	runner.Run("ParseKeyvalues/" + asset.Name, 1, text.size(), [&](std::uint64_t uiIterations)
+		{
+			for (std::uint64_t i = 0; i < uiIterations; ++i)
+			{
+				keyvalues::CKeyvaluesLexer::Memory_t memory;
+
+				memory.Init(text.data(), text.size(), false);
+
+				keyvalues::CKeyvaluesParser parser(memory);
+
+				if (parser.Parse() != keyvalues::CKeyvaluesParser::ParseResult::SUCCESS)
+				{
+					Error("Couldn't parse keyvalues file \"%s\"\n", asset.FileName.u8string().c_str());
+					return;
+				}
+
+				DoNotOptimize(parser.GetKeyvalues());
+			}
+		});
+}
+}
+
+void RunAssetBenchmarks(CBenchmarkRunner& runner, const BenchmarkAssets& assets)
+{
+	for (const auto& asset : assets.Models)
+	{
+		RunModelBenchmarks(runner, asset);
+	}
+
+	for (const auto& asset : assets.Sprites)
+	{
+		RunSpriteBenchmarks(runner, asset);
+	}
+
+	for (const auto& asset : assets.Keyvalues)
+	{
+		RunKeyvaluesBenchmarks(runner, asset);
+	}
+}
+}
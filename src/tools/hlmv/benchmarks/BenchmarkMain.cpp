@@ -0,0 +1,246 @@
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "shared/Logging.h"
+
+#include "Benchmarks.h"
+#include "CBenchmarkRunner.h"
+#include "ProceduralAssets.h"
+
+/**
+*	@file
+*
+*	Entry point of hlmv_benchmarks. Runs without a window or render context so it can be used in automated builds.
+*/
+
+namespace
+{
+const double DEFAULT_REGRESSION_THRESHOLD = 10;
+
+/**
+*	Generated models, from small to large. Covers bone heavy, vertex heavy and frame heavy models.
+*/
+const benchmarks::StudioModelParameters MODEL_CONFIGURATIONS[] =
+{
+	{16, 30, 256, 2, 64},
+	{64, 60, 1024, 4, 128},
+	{128, 30, 2048, 8, 256},
+	{32, 240, 512, 2, 512}
+};
+
+struct SpriteConfiguration
+{
+	int Width;
+	int Height;
+	int Frames;
+};
+
+const SpriteConfiguration SPRITE_CONFIGURATIONS[] =
+{
+	{32, 32, 16},
+	{256, 256, 4}
+};
+
+struct KeyvaluesConfiguration
+{
+	int Blocks;
+	int KeysPerBlock;
+};
+
+const KeyvaluesConfiguration KEYVALUES_CONFIGURATIONS[] =
+{
+	{16, 8},
+	{512, 16}
+};
+
+void PrintUsage()
+{
+	Message(
+		"Usage: hlmv_benchmarks [options]\n"
+		"  --filter <text>        Only run benchmarks whose name contains text\n"
+		"  --min-time <seconds>   Minimum time spent on each benchmark (default 0.5)\n"
+		"  --repetitions <count>  Number of timed repetitions, the median is reported (default 5)\n"
+		"  --model <file>         Also benchmark the given model. Can be used multiple times\n"
+		"  --json <file>          Write results to a JSON file\n"
+		"  --compare <file>       Compare results to a JSON file written by an earlier run\n"
+		"  --threshold <percent>  Slowdown relative to the baseline that counts as a regression (default %.0f)\n"
+		"Exits with status 2 if a benchmark regressed.\n",
+		DEFAULT_REGRESSION_THRESHOLD);
+}
+
+/**
+*	@brief Writes the generated assets to the given directory
+*/
+benchmarks::BenchmarkAssets GenerateAssets(const std::filesystem::path& directory)
+{
+	benchmarks::BenchmarkAssets assets;
+
+	for (const auto& parameters : MODEL_CONFIGURATIONS)
+	{
+		const auto data = benchmarks::GenerateStudioModel(parameters);
+
+		benchmarks::BenchmarkAsset asset{parameters.GetName(), directory / (parameters.GetName() + ".mdl")};
+
+		benchmarks::WriteAssetFile(asset.FileName, data.data(), data.size());
+
+		assets.Models.emplace_back(std::move(asset));
+	}
+
+	for (const auto& configuration : SPRITE_CONFIGURATIONS)
+	{
+		const auto data = benchmarks::GenerateSprite(configuration.Width, configuration.Height, configuration.Frames);
+
+		const std::string name = std::to_string(configuration.Width) + "x" + std::to_string(configuration.Height) + "x" + std::to_string(configuration.Frames);
+
+		benchmarks::BenchmarkAsset asset{name, directory / (name + ".spr")};
+
+		benchmarks::WriteAssetFile(asset.FileName, data.data(), data.size());
+
+		assets.Sprites.emplace_back(std::move(asset));
+	}
+
+	for (const auto& configuration : KEYVALUES_CONFIGURATIONS)
+	{
+		const auto text = benchmarks::GenerateKeyvalues(configuration.Blocks, configuration.KeysPerBlock);
+
+		const std::string name = std::to_string(configuration.Blocks) + "x" + std::to_string(configuration.KeysPerBlock);
+
+		benchmarks::BenchmarkAsset asset{name, directory / (name + ".txt")};
+
+		benchmarks::WriteAssetFile(asset.FileName, text.data(), text.size());
+
+		assets.Keyvalues.emplace_back(std::move(asset));
+	}
+
+	return assets;
+}
+}
+
+int main(int argc, char* argv[])
+{
+	SetDefaultLogListener(GetStdOutLogListener());
+
+	benchmarks::CBenchmarkRunner::Settings settings;
+
+	std::vector<std::filesystem::path> extraModels;
+	std::filesystem::path resultsFileName;
+	std::filesystem::path baselineFileName;
+	double flThreshold = DEFAULT_REGRESSION_THRESHOLD;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* const pszArg = argv[i];
+
+		if (!strcmp(pszArg, "--help") || !strcmp(pszArg, "-h"))
+		{
+			PrintUsage();
+			return EXIT_SUCCESS;
+		}
+
+		if (i + 1 >= argc)
+		{
+			Error("Missing value for option \"%s\"\n", pszArg);
+			PrintUsage();
+			return EXIT_FAILURE;
+		}
+
+		const char* const pszValue = argv[++i];
+
+		if (!strcmp(pszArg, "--filter"))
+		{
+			settings.Filter = pszValue;
+		}
+		else if (!strcmp(pszArg, "--min-time"))
+		{
+			settings.MinTime = strtod(pszValue, nullptr);
+		}
+		else if (!strcmp(pszArg, "--repetitions"))
+		{
+			settings.Repetitions = static_cast<unsigned int>(strtoul(pszValue, nullptr, 10));
+		}
+		else if (!strcmp(pszArg, "--model"))
+		{
+			extraModels.emplace_back(std::filesystem::u8path(pszValue));
+		}
+		else if (!strcmp(pszArg, "--json"))
+		{
+			resultsFileName = std::filesystem::u8path(pszValue);
+		}
+		else if (!strcmp(pszArg, "--compare"))
+		{
+			baselineFileName = std::filesystem::u8path(pszValue);
+		}
+		else if (!strcmp(pszArg, "--threshold"))
+		{
+			flThreshold = strtod(pszValue, nullptr);
+		}
+		else
+		{
+			Error("Unknown option \"%s\"\n", pszArg);
+			PrintUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::vector<benchmarks::BenchmarkResult> baseline;
+
+	//Read the baseline first so a bad file doesn't waste a run
+	if (!baselineFileName.empty() && !benchmarks::ReadResults(baselineFileName, baseline))
+	{
+		return EXIT_FAILURE;
+	}
+
+	const auto assetDirectory = std::filesystem::temp_directory_path() / "hlmv_benchmark_assets";
+
+	benchmarks::BenchmarkAssets assets;
+
+	try
+	{
+		std::filesystem::create_directories(assetDirectory);
+
+		assets = GenerateAssets(assetDirectory);
+	}
+	catch (const std::exception& e)
+	{
+		Error("Couldn't generate benchmark assets: %s\n", e.what());
+		return EXIT_FAILURE;
+	}
+
+	for (const auto& fileName : extraModels)
+	{
+		assets.Models.push_back({fileName.stem().u8string(), fileName});
+	}
+
+	benchmarks::CBenchmarkRunner runner{settings};
+
+	benchmarks::RunStudioModelRendererBenchmarks(runner, assets);
+	benchmarks::RunSoftwareRenderBenchmarks(runner, assets);
+	benchmarks::RunAssetBenchmarks(runner, assets);
+
+	std::error_code error;
+
+	std::filesystem::remove_all(assetDirectory, error);
+
+	if (!resultsFileName.empty() && !benchmarks::WriteResults(resultsFileName, runner.GetResults()))
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!baselineFileName.empty())
+	{
+		const unsigned int uiRegressions = benchmarks::CompareResults(baseline, runner.GetResults(), flThreshold);
+
+		if (uiRegressions > 0)
+		{
+			Error("%u benchmarks regressed by more than %.1f%%\n", uiRegressions, flThreshold);
+			return 2;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
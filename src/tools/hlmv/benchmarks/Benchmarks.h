@@ -0,0 +1,77 @@
+#ifndef BENCHMARKS_BENCHMARKS_H
+#define BENCHMARKS_BENCHMARKS_H
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+*	@ingroup Benchmarks
+*
+*	@{
+*/
+
+namespace renderer
+{
+class IRenderContext;
+}
+
+namespace studiomdl
+{
+class CStudioModel;
+}
+
+namespace benchmarks
+{
+class CBenchmarkRunner;
+
+/**
+*	@brief An asset file used by benchmarks
+*/
+struct BenchmarkAsset
+{
+	/**
+	*	Name used in benchmark names.
+	*/
+	std::string Name;
+
+	std::filesystem::path FileName;
+};
+
+/**
+*	@brief Assets shared by all benchmarks. Generated once before any benchmark runs
+*/
+struct BenchmarkAssets
+{
+	std::vector<BenchmarkAsset> Models;
+	std::vector<BenchmarkAsset> Sprites;
+	std::vector<BenchmarkAsset> Keyvalues;
+};
+
+/**
+*	@brief Loads a model, its texture file and its sequence groups
+*	@param pRenderContext If not null, textures are created in this context. Otherwise they are not uploaded
+*	@exception studiomdl::StudioModelException If a file could not be loaded
+*/
+std::unique_ptr<studiomdl::CStudioModel> LoadBenchmarkModel(const std::filesystem::path& fileName, renderer::IRenderContext* pRenderContext = nullptr);
+
+/**
+*	@brief Times bone setup and vertex skinning of the studio model renderer
+*/
+void RunStudioModelRendererBenchmarks(CBenchmarkRunner& runner, const BenchmarkAssets& assets);
+
+/**
+*	@brief Times drawing models with the software render context on all cores and on one
+*/
+void RunSoftwareRenderBenchmarks(CBenchmarkRunner& runner, const BenchmarkAssets& assets);
+
+/**
+*	@brief Times loading and decoding of models, textures, sprites and keyvalues
+*/
+void RunAssetBenchmarks(CBenchmarkRunner& runner, const BenchmarkAssets& assets);
+}
+
+/** @} */
+
+#endif //BENCHMARKS_BENCHMARKS_H
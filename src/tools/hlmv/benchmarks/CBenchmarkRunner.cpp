@@ -0,0 +1,309 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#include "shared/CProfiler.h"
+#include "shared/Logging.h"
+
+#include "CBenchmarkRunner.h"
+
+namespace benchmarks
+{
+#ifdef _MSC_VER
+const void* volatile g_pOptimizationSink = nullptr;
+#endif
+
+namespace
+{
+/**
+*	Iteration counts are calibrated until a run takes at least this fraction of the time of a repetition.
+*/
+const double CALIBRATION_FRACTION = 0.1;
+
+const std::uint64_t MAX_ITERATIONS = 1ULL << 40;
+
+/**
+*	@brief Finds the value of the given key in a line written by WriteResults
+*	@return Pointer to the first character of the value, or null if the key isn't present
+*/
+const char* FindValue(const std::string& line, const char* pszKey)
+{
+	const std::string key = std::string{"\""} + pszKey + "\":";
+
+	const auto index = line.find(key);
+
+	if (index == std::string::npos)
+	{
+		return nullptr;
+	}
+
+	return line.c_str() + index + key.size();
+}
+
+double ReadNumber(const std::string& line, const char* pszKey)
+{
+	const char* pszValue = FindValue(line, pszKey);
+
+	return pszValue ? strtod(pszValue, nullptr) : 0;
+}
+
+void FormatRate(char* pszBuffer, const size_t uiBufferSize, const double flRate, const char* pszUnit)
+{
+	if (flRate <= 0)
+	{
+		snprintf(pszBuffer, uiBufferSize, "-");
+	}
+	else if (flRate >= 1e9)
+	{
+		snprintf(pszBuffer, uiBufferSize, "%.2f G%s/s", flRate / 1e9, pszUnit);
+	}
+	else if (flRate >= 1e6)
+	{
+		snprintf(pszBuffer, uiBufferSize, "%.2f M%s/s", flRate / 1e6, pszUnit);
+	}
+	else
+	{
+		snprintf(pszBuffer, uiBufferSize, "%.2f K%s/s", flRate / 1e3, pszUnit);
+	}
+}
+}
+
+CBenchmarkRunner::CBenchmarkRunner(const Settings& settings)
+	: m_Settings(settings)
+{
+}
+
+bool CBenchmarkRunner::ShouldRun(const std::string& name) const
+{
+	return m_Settings.Filter.empty() || name.find(m_Settings.Filter) != std::string::npos;
+}
+
+void CBenchmarkRunner::Run(const std::string& name, std::uint64_t itemsPerOp, std::uint64_t bytesPerOp, const Function& function)
+{
+	if (!ShouldRun(name))
+	{
+		return;
+	}
+
+	const unsigned int uiRepetitions = std::max(1u, m_Settings.Repetitions);
+
+	const double flRepetitionTime = (m_Settings.MinTime * 1e9) / uiRepetitions;
+
+	//Also warms up caches and branch predictors
+	std::uint64_t uiIterations = 1;
+	std::uint64_t elapsed = Time(function, uiIterations);
+
+	while (elapsed < flRepetitionTime * CALIBRATION_FRACTION && uiIterations < MAX_ITERATIONS)
+	{
+		uiIterations *= 2;
+		elapsed = Time(function, uiIterations);
+	}
+
+	if (elapsed > 0)
+	{
+		const double flScale = flRepetitionTime / elapsed;
+
+		uiIterations = std::clamp(static_cast<std::uint64_t>(std::ceil(uiIterations * flScale)), static_cast<std::uint64_t>(1), MAX_ITERATIONS);
+	}
+
+	std::vector<double> timings;
+
+	timings.reserve(uiRepetitions);
+
+	for (unsigned int repetition = 0; repetition < uiRepetitions; ++repetition)
+	{
+		timings.push_back(static_cast<double>(Time(function, uiIterations)) / uiIterations);
+	}
+
+	std::sort(timings.begin(), timings.end());
+
+	BenchmarkResult result;
+
+	result.Name = name;
+	result.Iterations = uiIterations;
+	result.NsPerOp = timings[timings.size() / 2];
+	result.MinNsPerOp = timings.front();
+
+	if (result.NsPerOp > 0)
+	{
+		result.ItemsPerSecond = itemsPerOp * 1e9 / result.NsPerOp;
+		result.BytesPerSecond = bytesPerOp * 1e9 / result.NsPerOp;
+	}
+
+	char szItems[32];
+	char szBytes[32];
+
+	FormatRate(szItems, sizeof(szItems), result.ItemsPerSecond, "items");
+	FormatRate(szBytes, sizeof(szBytes), result.BytesPerSecond, "B");
+
+	Message("%-52s %14.1f ns/op %14.1f min %18s %14s\n", name.c_str(), result.NsPerOp, result.MinNsPerOp, szItems, szBytes);
+
+	m_Results.emplace_back(std::move(result));
+}
+
+std::uint64_t CBenchmarkRunner::Time(const Function& function, std::uint64_t uiIterations)
+{
+	const std::uint64_t start = profiler::CProfiler::GetTimestamp();
+
+	function(uiIterations);
+
+	return profiler::CProfiler::GetTimestamp() - start;
+}
+
+bool WriteResults(const std::filesystem::path& fileName, const std::vector<BenchmarkResult>& results)
+{
+	std::ofstream stream(fileName, std::ios::out | std::ios::trunc);
+
+	if (!stream)
+	{
+		Error("Couldn't open benchmark results file \"%s\" for writing\n", fileName.u8string().c_str());
+		return false;
+	}
+
+	stream.setf(std::ios::fixed);
+	stream.precision(3);
+
+	stream << "{\"schema_version\":" << RESULTS_SCHEMA_VERSION << ",\"benchmarks\":[";
+
+	bool bFirst = true;
+
+	//Names are generated by the benchmarks and never contain characters that need escaping
+	for (const auto& result : results)
+	{
+		stream << (bFirst ? "\n" : ",\n");
+		bFirst = false;
+
+		stream << "{\"name\":\"" << result.Name << '"'
+			<< ",\"iterations\":" << result.Iterations
+			<< ",\"ns_per_op\":" << result.NsPerOp
+			<< ",\"min_ns_per_op\":" << result.MinNsPerOp
+			<< ",\"items_per_second\":" << result.ItemsPerSecond
+			<< ",\"bytes_per_second\":" << result.BytesPerSecond << '}';
+	}
+
+	stream << "\n]}\n";
+
+	if (!stream)
+	{
+		Error("Error writing benchmark results file \"%s\"\n", fileName.u8string().c_str());
+		return false;
+	}
+
+	Message("Wrote %u benchmark results to \"%s\"\n", static_cast<unsigned int>(results.size()), fileName.u8string().c_str());
+
+	return true;
+}
+
+bool ReadResults(const std::filesystem::path& fileName, std::vector<BenchmarkResult>& results)
+{
+	std::ifstream stream(fileName);
+
+	if (!stream)
+	{
+		Error("Couldn't open benchmark results file \"%s\"\n", fileName.u8string().c_str());
+		return false;
+	}
+
+	results.clear();
+
+	std::string line;
+	bool bFoundVersion = false;
+
+	while (std::getline(stream, line))
+	{
+		if (!bFoundVersion)
+		{
+			if (FindValue(line, "schema_version"))
+			{
+				const int version = static_cast<int>(ReadNumber(line, "schema_version"));
+
+				if (version != RESULTS_SCHEMA_VERSION)
+				{
+					Error("Benchmark results file \"%s\" has schema version %d, expected %d\n",
+						fileName.u8string().c_str(), version, RESULTS_SCHEMA_VERSION);
+					return false;
+				}
+
+				bFoundVersion = true;
+			}
+
+			continue;
+		}
+
+		const char* pszName = FindValue(line, "name");
+
+		if (!pszName || *pszName != '"')
+		{
+			continue;
+		}
+
+		const char* pszNameEnd = strchr(pszName + 1, '"');
+
+		if (!pszNameEnd)
+		{
+			continue;
+		}
+
+		BenchmarkResult result;
+
+		result.Name.assign(pszName + 1, pszNameEnd);
+		result.Iterations = static_cast<std::uint64_t>(ReadNumber(line, "iterations"));
+		result.NsPerOp = ReadNumber(line, "ns_per_op");
+		result.MinNsPerOp = ReadNumber(line, "min_ns_per_op");
+		result.ItemsPerSecond = ReadNumber(line, "items_per_second");
+		result.BytesPerSecond = ReadNumber(line, "bytes_per_second");
+
+		results.emplace_back(std::move(result));
+	}
+
+	if (!bFoundVersion)
+	{
+		Error("Benchmark results file \"%s\" has no schema version\n", fileName.u8string().c_str());
+		return false;
+	}
+
+	return true;
+}
+
+unsigned int CompareResults(const std::vector<BenchmarkResult>& baseline, const std::vector<BenchmarkResult>& results, const double flThresholdPercent)
+{
+	std::unordered_map<std::string, const BenchmarkResult*> baselineByName;
+
+	for (const auto& result : baseline)
+	{
+		baselineByName.emplace(result.Name, &result);
+	}
+
+	unsigned int uiRegressions = 0;
+
+	Message("\n%-52s %14s %14s %10s\n", "Benchmark", "Baseline ns", "Current ns", "Change");
+
+	for (const auto& result : results)
+	{
+		const auto it = baselineByName.find(result.Name);
+
+		if (it == baselineByName.end() || it->second->NsPerOp <= 0)
+		{
+			Message("%-52s %14s %14.1f %10s\n", result.Name.c_str(), "-", result.NsPerOp, "new");
+			continue;
+		}
+
+		const double flChange = (result.NsPerOp / it->second->NsPerOp - 1.0) * 100.0;
+
+		const bool bRegressed = flChange > flThresholdPercent;
+
+		if (bRegressed)
+		{
+			++uiRegressions;
+		}
+
+		Message("%-52s %14.1f %14.1f %+9.1f%%%s\n", result.Name.c_str(), it->second->NsPerOp, result.NsPerOp, flChange, bRegressed ? "  REGRESSION" : "");
+	}
+
+	return uiRegressions;
+}
+}
@@ -0,0 +1,162 @@
+#ifndef BENCHMARKS_CBENCHMARKRUNNER_H
+#define BENCHMARKS_CBENCHMARKRUNNER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+*	@defgroup Benchmarks Benchmarks
+*
+*	Headless microbenchmarks of the CPU side of loading and rendering assets.
+*
+*	@{
+*/
+
+namespace benchmarks
+{
+/**
+*	Version of the results file format. Increment when fields are renamed or change meaning.
+*/
+const int RESULTS_SCHEMA_VERSION = 1;
+
+/**
+*	@brief Timings of a single benchmark
+*/
+struct BenchmarkResult
+{
+	std::string Name;
+
+	/**
+	*	Number of operations timed per repetition.
+	*/
+	std::uint64_t Iterations = 0;
+
+	/**
+	*	Median time per operation over all repetitions, in nanoseconds.
+	*/
+	double NsPerOp = 0;
+
+	/**
+	*	Fastest time per operation over all repetitions, in nanoseconds.
+	*/
+	double MinNsPerOp = 0;
+
+	/**
+	*	Number of items (bones, vertices, triangles, ...) processed per second, or 0 if not applicable.
+	*/
+	double ItemsPerSecond = 0;
+
+	/**
+	*	Number of bytes processed per second, or 0 if not applicable.
+	*/
+	double BytesPerSecond = 0;
+};
+
+/**
+*	@brief Runs benchmarks and collects their results
+*/
+class CBenchmarkRunner final
+{
+public:
+	/**
+	*	Runs the operation being measured the given number of times.
+	*/
+	using Function = std::function<void(std::uint64_t uiIterations)>;
+
+	struct Settings
+	{
+		/**
+		*	Only benchmarks whose name contains this string are run. Empty runs all benchmarks.
+		*/
+		std::string Filter;
+
+		/**
+		*	Minimum time spent timing each benchmark, in seconds.
+		*/
+		double MinTime = 0.5;
+
+		/**
+		*	Number of times each benchmark is timed. The median is reported.
+		*/
+		unsigned int Repetitions = 5;
+	};
+
+public:
+	explicit CBenchmarkRunner(const Settings& settings);
+	~CBenchmarkRunner() = default;
+
+	/**
+	*	@brief Whether a benchmark with the given name passes the filter
+	*	Use this to skip expensive setup of benchmarks that won't run.
+	*/
+	bool ShouldRun(const std::string& name) const;
+
+	/**
+	*	@brief Times a benchmark and prints its result
+	*	@param name Unique name of the benchmark
+	*	@param itemsPerOp Number of items processed by a single operation, or 0
+	*	@param bytesPerOp Number of bytes processed by a single operation, or 0
+	*	@param function Runs the operation
+	*/
+	void Run(const std::string& name, std::uint64_t itemsPerOp, std::uint64_t bytesPerOp, const Function& function);
+
+	const std::vector<BenchmarkResult>& GetResults() const { return m_Results; }
+
+private:
+	/**
+	*	@brief Runs the function and returns the elapsed time in nanoseconds
+	*/
+	static std::uint64_t Time(const Function& function, std::uint64_t uiIterations);
+
+private:
+	const Settings m_Settings;
+
+	std::vector<BenchmarkResult> m_Results;
+
+private:
+	CBenchmarkRunner(const CBenchmarkRunner&) = delete;
+	CBenchmarkRunner& operator=(const CBenchmarkRunner&) = delete;
+};
+
+/**
+*	@brief Writes results as JSON, one benchmark per line so files can be diffed
+*/
+bool WriteResults(const std::filesystem::path& fileName, const std::vector<BenchmarkResult>& results);
+
+/**
+*	@brief Reads results written by WriteResults
+*	@return Whether the file could be read and has the current schema version
+*/
+bool ReadResults(const std::filesystem::path& fileName, std::vector<BenchmarkResult>& results);
+
+/**
+*	@brief Prints the change of each benchmark relative to a baseline
+*	@param flThresholdPercent How much slower than the baseline a benchmark can be before it is a regression
+*	@return Number of regressions
+*/
+unsigned int CompareResults(const std::vector<BenchmarkResult>& baseline, const std::vector<BenchmarkResult>& results, const double flThresholdPercent);
+
+#ifdef _MSC_VER
+extern const void* volatile g_pOptimizationSink;
+#endif
+
+/**
+*	@brief Prevents the compiler from optimizing away the computation of the given value
+*/
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+#ifdef _MSC_VER
+	g_pOptimizationSink = &value;
+#else
+	asm volatile("" : : "g"(&value) : "memory");
+#endif
+}
+}
+
+/** @} */
+
+#endif //BENCHMARKS_CBENCHMARKRUNNER_H
@@ -0,0 +1,128 @@
+#include "CMockRenderContext.h"
+
+namespace benchmarks
+{
+bool CMockRenderContext::AppliedState::operator==(const AppliedState& other) const
+{
+	return CullFace == other.CullFace
+		&& Capabilities == other.Capabilities
+		&& BlendSrc == other.BlendSrc
+		&& BlendDst == other.BlendDst
+		&& bDepthMask == other.bDepthMask
+		&& DepthFunc == other.DepthFunc
+		&& AlphaFunc == other.AlphaFunc
+		&& flAlphaRef == other.flAlphaRef
+		&& Color == other.Color
+		&& PolygonMode == other.PolygonMode
+		&& ShadeModel == other.ShadeModel
+		&& uiActiveTextureUnit == other.uiActiveTextureUnit
+		&& BoundTextures == other.BoundTextures;
+}
+
+renderer::HTexture_t CMockRenderContext::CreateTexture(const int, const renderer::ImageFormat, const int, const int, const byte*)
+{
+	auto hTexture = reinterpret_cast<renderer::HTexture_t>(m_NextTexture++);
+
+	BindTexture(hTexture);
+
+	return hTexture;
+}
+
+void CMockRenderContext::DestroyTexture(renderer::HTexture_t hTexture)
+{
+	if (hTexture == NULL_TEXTURE_HANDLE)
+		return;
+
+	//Like OpenGL, destroying a texture unbinds it
+	for (auto& texture : m_State.BoundTextures)
+	{
+		if (texture == hTexture)
+		{
+			texture = NULL_TEXTURE_HANDLE;
+		}
+	}
+
+	ForgetTexture(hTexture);
+}
+
+void CMockRenderContext::DrawVertices(const renderer::PrimitiveType, const renderer::Vertex*, const size_t uiCount)
+{
+	m_DrawnVertexCount += uiCount;
+
+	//Like OpenGL, per-vertex colors leave the current color undefined
+	ForgetColor();
+}
+
+void CMockRenderContext::DrawPositions(const renderer::PrimitiveType, const glm::vec3*, const unsigned short*, const size_t uiCount)
+{
+	m_DrawnVertexCount += uiCount;
+}
+
+void CMockRenderContext::ApplyCullFace(const renderer::CullFace cullFace)
+{
+	m_State.CullFace = cullFace;
+	++m_uiAppliedCount;
+}
+
+void CMockRenderContext::ApplyCapability(const renderer::Capability capability, const bool bEnable)
+{
+	m_State.Capabilities[static_cast<size_t>(capability)] = bEnable;
+	++m_uiAppliedCount;
+}
+
+void CMockRenderContext::ApplyBlendFunc(const renderer::BlendFactor src, const renderer::BlendFactor dst)
+{
+	m_State.BlendSrc = src;
+	m_State.BlendDst = dst;
+	++m_uiAppliedCount;
+}
+
+void CMockRenderContext::ApplyDepthMask(const bool bWrite)
+{
+	m_State.bDepthMask = bWrite;
+	++m_uiAppliedCount;
+}
+
+void CMockRenderContext::ApplyDepthFunc(const renderer::CompareFunc func)
+{
+	m_State.DepthFunc = func;
+	++m_uiAppliedCount;
+}
+
+void CMockRenderContext::ApplyAlphaFunc(const renderer::CompareFunc func, const float flRef)
+{
+	m_State.AlphaFunc = func;
+	m_State.flAlphaRef = flRef;
+	++m_uiAppliedCount;
+}
+
+void CMockRenderContext::ApplyColor(const glm::vec4& color)
+{
+	m_State.Color = color;
+	++m_uiAppliedCount;
+}
+
+void CMockRenderContext::ApplyPolygonMode(const renderer::PolygonMode mode)
+{
+	m_State.PolygonMode = mode;
+	++m_uiAppliedCount;
+}
+
+void CMockRenderContext::ApplyShadeModel(const renderer::ShadeModel model)
+{
+	m_State.ShadeModel = model;
+	++m_uiAppliedCount;
+}
+
+void CMockRenderContext::ApplyActiveTextureUnit(const unsigned int uiUnit)
+{
+	m_State.uiActiveTextureUnit = uiUnit;
+	++m_uiAppliedCount;
+}
+
+void CMockRenderContext::ApplyBindTexture(renderer::HTexture_t hTexture)
+{
+	m_State.BoundTextures[m_State.uiActiveTextureUnit] = hTexture;
+	++m_uiAppliedCount;
+}
+}
@@ -0,0 +1,123 @@
+#ifndef BENCHMARKS_CMOCKRENDERCONTEXT_H
+#define BENCHMARKS_CMOCKRENDERCONTEXT_H
+
+#include <array>
+
+#include <glm/vec4.hpp>
+
+#include "engine/renderer/CBaseRenderContext.h"
+
+namespace benchmarks
+{
+/**
+*	@brief Render context that records the state changes passed on to it instead of making graphics API calls
+*	Lets renderer code run without a window, and shows which state changes the shadowed state lets through.
+*/
+class CMockRenderContext final : public renderer::CBaseRenderContext
+{
+public:
+	/**
+	*	@brief State as a graphics API would have it. Starts out with OpenGL's defaults
+	*/
+	struct AppliedState
+	{
+		renderer::CullFace CullFace = renderer::CullFace::BACK;
+		std::array<bool, static_cast<size_t>(renderer::Capability::COUNT)> Capabilities{};
+		renderer::BlendFactor BlendSrc = renderer::BlendFactor::ONE;
+		renderer::BlendFactor BlendDst = renderer::BlendFactor::ZERO;
+		bool bDepthMask = true;
+		renderer::CompareFunc DepthFunc = renderer::CompareFunc::LESS;
+		renderer::CompareFunc AlphaFunc = renderer::CompareFunc::ALWAYS;
+		float flAlphaRef = 0;
+		glm::vec4 Color{1};
+		renderer::PolygonMode PolygonMode = renderer::PolygonMode::FILL;
+		renderer::ShadeModel ShadeModel = renderer::ShadeModel::SMOOTH;
+		unsigned int uiActiveTextureUnit = 0;
+		std::array<renderer::HTexture_t, renderer::MAX_TEXTURE_UNITS> BoundTextures{};
+
+		bool operator==(const AppliedState& other) const;
+		bool operator!=(const AppliedState& other) const { return !(*this == other); }
+	};
+
+public:
+	CMockRenderContext() = default;
+
+	const AppliedState& GetAppliedState() const { return m_State; }
+
+	/**
+	*	@return Number of state changes that were passed on to this context since it was created
+	*/
+	unsigned int GetAppliedCount() const { return m_uiAppliedCount; }
+
+	/**
+	*	@return Number of vertices that were drawn with this context since it was created
+	*/
+	size_t GetDrawnVertexCount() const { return m_DrawnVertexCount; }
+
+	void Viewport(int, int, int, int) override {}
+
+	void PerspectiveY(vec_t, vec_t, vec_t, vec_t) override {}
+
+	void ClearColor(const Color32&) override {}
+
+	void ClearColor(const Color24&, float = 0) override {}
+
+	void ClearColor(float = 0, float = 0, float = 0, float = 0) override {}
+
+	void Clear(const renderer::ClearBits_t) override {}
+
+	renderer::ReadBuffer GetReadBuffer() const override { return m_ReadBuffer; }
+
+	void SetReadBuffer(const renderer::ReadBuffer buffer) override { m_ReadBuffer = buffer; }
+
+	bool ReadPixels(int, int, int, int, const renderer::ImageFormat, byte*) override { return false; }
+
+	renderer::HTexture_t CreateTexture(const int mipmaps, const renderer::ImageFormat format, const int iWidth, const int iHeight, const byte* pData) override;
+
+	void DestroyTexture(renderer::HTexture_t hTexture) override;
+
+	void SetMinMagFilters(const renderer::MinFilter, const renderer::MagFilter) override {}
+
+	void DrawVertices(const renderer::PrimitiveType type, const renderer::Vertex* pVertices, const size_t uiCount) override;
+
+	void DrawPositions(const renderer::PrimitiveType type, const glm::vec3* pPositions, const unsigned short* pIndices, const size_t uiCount) override;
+
+	void Flush() override {}
+
+protected:
+	void ApplyCullFace(const renderer::CullFace cullFace) override;
+
+	void ApplyCapability(const renderer::Capability capability, const bool bEnable) override;
+
+	void ApplyBlendFunc(const renderer::BlendFactor src, const renderer::BlendFactor dst) override;
+
+	void ApplyDepthMask(const bool bWrite) override;
+
+	bool QueryDepthMask() const override { return m_State.bDepthMask; }
+
+	void ApplyDepthFunc(const renderer::CompareFunc func) override;
+
+	void ApplyAlphaFunc(const renderer::CompareFunc func, const float flRef) override;
+
+	void ApplyColor(const glm::vec4& color) override;
+
+	void ApplyPolygonMode(const renderer::PolygonMode mode) override;
+
+	void ApplyShadeModel(const renderer::ShadeModel model) override;
+
+	void ApplyActiveTextureUnit(const unsigned int uiUnit) override;
+
+	void ApplyBindTexture(renderer::HTexture_t hTexture) override;
+
+private:
+	AppliedState m_State;
+	unsigned int m_uiAppliedCount = 0;
+	size_t m_DrawnVertexCount = 0;
+
+	renderer::ReadBuffer m_ReadBuffer = renderer::ReadBuffer::BACK;
+
+	size_t m_NextTexture = 1;
+};
+}
+
+#endif //BENCHMARKS_CMOCKRENDERCONTEXT_H
@@ -0,0 +1,581 @@
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <glm/vec3.hpp>
+
+#include "shared/studiomodel/studio.h"
+#include "shared/sprite/sprite.h"
+
+#include "graphics/Palette.h"
+
+#include "utility/IOUtils.h"
+
+#include "ProceduralAssets.h"
+
+namespace benchmarks
+{
+namespace
+{
+const double PI = 3.14159265358979323846;
+
+/**
+*	Maximum number of frames in the blended sequence.
+*/
+const int MAX_BLENDED_FRAMES = 30;
+
+const int MAX_TEXTURES = 4;
+
+const int SKIN_FAMILIES = 2;
+
+const float BONE_LENGTH = 4;
+
+const float MODEL_RADIUS = 4;
+
+const float ROTATION_SCALE = 0.0005f;
+
+const float POSITION_SCALE = 0.01f;
+
+/**
+*	@brief Builds a file in memory. Sections are addressed by offset because appending may reallocate the buffer
+*/
+class CBufferWriter final
+{
+public:
+	explicit CBufferWriter(const size_t uiAlignment)
+		: m_uiAlignment(uiAlignment)
+	{
+	}
+
+	/**
+	*	@brief Appends the given objects, or zeroed objects if pData is null
+	*	@return Offset of the first object
+	*/
+	template<typename T>
+	int Append(const T* pData, const size_t uiCount)
+	{
+		const size_t uiOffset = ((m_Data.size() + m_uiAlignment - 1) / m_uiAlignment) * m_uiAlignment;
+
+		m_Data.resize(uiOffset + sizeof(T) * uiCount, 0);
+
+		if (pData)
+		{
+			memcpy(m_Data.data() + uiOffset, pData, sizeof(T) * uiCount);
+		}
+
+		return static_cast<int>(uiOffset);
+	}
+
+	template<typename T>
+	T* Get(const int offset)
+	{
+		return reinterpret_cast<T*>(m_Data.data() + offset);
+	}
+
+	size_t GetSize() const { return m_Data.size(); }
+
+	std::vector<byte> Release() { return std::move(m_Data); }
+
+private:
+	const size_t m_uiAlignment;
+
+	std::vector<byte> m_Data;
+};
+
+/**
+*	@brief Run-length encodes animation values the way studiomdl does
+*	Each span stores values that change, followed by a count of frames that repeat the last value.
+*/
+std::vector<mstudioanimvalue_t> EncodeAnimationValues(const std::vector<short>& values)
+{
+	std::vector<mstudioanimvalue_t> encoded;
+
+	const size_t uiCount = values.size();
+
+	for (size_t uiStart = 0; uiStart < uiCount;)
+	{
+		size_t uiEnd = uiStart + 1;
+
+		while (uiEnd < uiCount && uiEnd - uiStart < UCHAR_MAX && values[uiEnd] != values[uiEnd - 1])
+		{
+			++uiEnd;
+		}
+
+		const size_t uiValid = uiEnd - uiStart;
+		size_t uiTotal = uiValid;
+
+		while (uiStart + uiTotal < uiCount && uiTotal < UCHAR_MAX && values[uiStart + uiTotal] == values[uiEnd - 1])
+		{
+			++uiTotal;
+		}
+
+		mstudioanimvalue_t span;
+
+		span.num.valid = static_cast<byte>(uiValid);
+		span.num.total = static_cast<byte>(uiTotal);
+
+		encoded.push_back(span);
+
+		for (size_t uiValue = uiStart; uiValue < uiEnd; ++uiValue)
+		{
+			mstudioanimvalue_t value;
+			value.value = values[uiValue];
+			encoded.push_back(value);
+		}
+
+		uiStart += uiTotal;
+	}
+
+	//Interpolating the last frame reads the first value of the next span, so loop back to the first frame
+	mstudioanimvalue_t span;
+
+	span.num.valid = 1;
+	span.num.total = 1;
+
+	mstudioanimvalue_t value;
+	value.value = values.front();
+
+	encoded.push_back(span);
+	encoded.push_back(value);
+
+	return encoded;
+}
+
+/**
+*	@brief Generates the values of an animation channel
+*	Values are quantized so that some frames repeat and get run-length encoded.
+*/
+std::vector<short> GenerateChannel(const int bone, const int channel, const int frames, const int blend)
+{
+	std::vector<short> values(frames);
+
+	//Some channels don't move at all
+	if ((bone + channel) % 5 == 4)
+	{
+		return values;
+	}
+
+	const double flPhase = bone * 0.7 + channel * 1.3 + blend * 0.5;
+
+	const bool bIsRotation = channel >= 3;
+
+	for (int frame = 0; frame < frames; ++frame)
+	{
+		const double flSine = std::sin((2 * PI * frame) / frames + flPhase);
+
+		values[frame] = static_cast<short>(bIsRotation ? std::lround(flSine * 24) * 32 : std::lround(flSine * 16) * 50);
+	}
+
+	return values;
+}
+
+/**
+*	@brief Writes the animations of all blends of a sequence
+*	@return Offset of the animations of the first blend
+*/
+int WriteAnimations(CBufferWriter& writer, const int bones, const int frames, const int blends)
+{
+	const int animIndex = writer.Append<mstudioanim_t>(nullptr, bones * blends);
+
+	for (int blend = 0; blend < blends; ++blend)
+	{
+		for (int bone = 0; bone < bones; ++bone)
+		{
+			const int anim = blend * bones + bone;
+
+			//Only the root bone moves, all bones rotate
+			for (int channel = bone == 0 ? 0 : 3; channel < 6; ++channel)
+			{
+				const auto encoded = EncodeAnimationValues(GenerateChannel(bone, channel, frames, blend));
+
+				const int valueIndex = writer.Append(encoded.data(), encoded.size());
+
+				const int offset = valueIndex - (animIndex + anim * static_cast<int>(sizeof(mstudioanim_t)));
+
+				if (offset > USHRT_MAX)
+				{
+					throw std::runtime_error("Animation data of the generated model exceeds the maximum offset, reduce the number of bones or frames");
+				}
+
+				writer.Get<mstudioanim_t>(animIndex)[anim].offset[channel] = static_cast<unsigned short>(offset);
+			}
+		}
+	}
+
+	return animIndex;
+}
+
+void InitializeSequence(mstudioseqdesc_t& sequence, const char* pszLabel, const int frames, const int blends)
+{
+	sequence = {};
+
+	snprintf(sequence.label, sizeof(sequence.label), "%s", pszLabel);
+
+	sequence.fps = 30;
+	sequence.flags = STUDIO_LOOPING;
+	sequence.numframes = frames;
+	sequence.bbmin = glm::vec3{-16, -16, 0};
+	sequence.bbmax = glm::vec3{16, 16, 72};
+	sequence.numblends = blends;
+	sequence.seqgroup = 0;
+	sequence.entrynode = sequence.exitnode = 1;
+}
+
+void GeneratePalette(byte* pPalette, const int seed)
+{
+	for (size_t uiIndex = 0; uiIndex < PALETTE_ENTRIES; ++uiIndex)
+	{
+		pPalette[uiIndex * PALETTE_CHANNELS] = static_cast<byte>(uiIndex);
+		pPalette[uiIndex * PALETTE_CHANNELS + 1] = static_cast<byte>(uiIndex * 3 + seed * 50);
+		pPalette[uiIndex * PALETTE_CHANNELS + 2] = static_cast<byte>(255 - uiIndex);
+	}
+}
+
+void GeneratePixels(byte* pPixels, const int width, const int height, const int seed)
+{
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			pPixels[y * width + x] = static_cast<byte>((x ^ y) + seed * 16);
+		}
+	}
+}
+}
+
+std::string StudioModelParameters::GetName() const
+{
+	char szName[128];
+
+	snprintf(szName, sizeof(szName), "b%d_f%d_v%d", Bones, Frames, Vertices);
+
+	return szName;
+}
+
+std::vector<byte> GenerateStudioModel(const StudioModelParameters& parameters)
+{
+	if (parameters.Bones < 1 || parameters.Bones > MAXSTUDIOBONES ||
+		parameters.Frames < 1 ||
+		parameters.Meshes < 1 || parameters.Meshes > MAXSTUDIOMESHES ||
+		parameters.Vertices < 1 || parameters.Vertices > MAXSTUDIOVERTS ||
+		parameters.Vertices % (MODEL_GRID_WIDTH * parameters.Meshes) != 0 ||
+		(parameters.Vertices / (MODEL_GRID_WIDTH * parameters.Meshes)) < 2 ||
+		parameters.TextureSize < 1 || parameters.TextureSize > MAX_TEXTURE_DIMS)
+	{
+		throw std::runtime_error("Invalid studio model parameters " + parameters.GetName());
+	}
+
+	CBufferWriter writer{4};
+
+	studiohdr_t header{};
+
+	writer.Append(&header, 1);
+
+	memcpy(&header.id, STUDIOMDL_HDR_ID, sizeof(header.id));
+	header.version = STUDIO_VERSION;
+	snprintf(header.name, sizeof(header.name), "%s.mdl", parameters.GetName().c_str());
+
+	header.bbmin = glm::vec3{-16, -16, 0};
+	header.bbmax = glm::vec3{16, 16, 72};
+
+	//Bones form a binary tree so the hierarchy is reasonably deep
+	std::vector<mstudiobone_t> bones(parameters.Bones);
+	std::vector<mstudiobbox_t> hitboxes(parameters.Bones);
+
+	for (int index = 0; index < parameters.Bones; ++index)
+	{
+		auto& bone = bones[index];
+
+		bone = {};
+
+		snprintf(bone.name, sizeof(bone.name), "Bone%d", index);
+
+		bone.parent = index == 0 ? -1 : (index - 1) / 2;
+
+		for (int controller = 0; controller < STUDIO_MAX_PER_BONE_CONTROLLERS; ++controller)
+		{
+			bone.bonecontroller[controller] = -1;
+			bone.scale[controller] = controller < 3 ? POSITION_SCALE : ROTATION_SCALE;
+		}
+
+		if (index != 0)
+		{
+			bone.value[2] = BONE_LENGTH;
+		}
+
+		auto& hitbox = hitboxes[index];
+
+		hitbox.bone = index;
+		hitbox.group = index % 8;
+		hitbox.bbmin = glm::vec3{-2, -2, 0};
+		hitbox.bbmax = glm::vec3{2, 2, BONE_LENGTH};
+	}
+
+	header.numbones = parameters.Bones;
+	header.boneindex = writer.Append(bones.data(), bones.size());
+
+	header.numhitboxes = parameters.Bones;
+	header.hitboxindex = writer.Append(hitboxes.data(), hitboxes.size());
+
+	//Animations are stored in the main file
+	mstudioseqgroup_t sequenceGroup{};
+
+	snprintf(sequenceGroup.label, sizeof(sequenceGroup.label), "default");
+
+	header.numseqgroups = 1;
+	header.seqgroupindex = writer.Append(&sequenceGroup, 1);
+
+	mstudioseqdesc_t sequences[2];
+
+	InitializeSequence(sequences[0], "idle", parameters.Frames, 1);
+	sequences[0].animindex = WriteAnimations(writer, parameters.Bones, parameters.Frames, 1);
+
+	const int blendedFrames = std::min(parameters.Frames, MAX_BLENDED_FRAMES);
+
+	InitializeSequence(sequences[1], "aim", blendedFrames, 2);
+	sequences[1].blendtype[0] = STUDIO_XR;
+	sequences[1].blendstart[0] = -45;
+	sequences[1].blendend[0] = 45;
+	sequences[1].animindex = WriteAnimations(writer, parameters.Bones, blendedFrames, 2);
+
+	header.numseq = 2;
+	header.seqindex = writer.Append(sequences, 2);
+
+	//Each mesh covers its own rows of a grid wrapped around the bones
+	const int rows = parameters.Vertices / MODEL_GRID_WIDTH;
+	const int rowsPerMesh = rows / parameters.Meshes;
+
+	std::vector<byte> vertexBones(parameters.Vertices);
+	std::vector<glm::vec3> vertices(parameters.Vertices);
+	std::vector<glm::vec3> normals(parameters.Vertices);
+
+	for (int row = 0; row < rows; ++row)
+	{
+		const auto bone = static_cast<byte>((row * parameters.Bones) / rows);
+
+		for (int column = 0; column < MODEL_GRID_WIDTH; ++column)
+		{
+			const int index = row * MODEL_GRID_WIDTH + column;
+
+			const double flAngle = (2 * PI * column) / MODEL_GRID_WIDTH;
+
+			const glm::vec3 normal{static_cast<float>(std::cos(flAngle)), static_cast<float>(std::sin(flAngle)), 0.f};
+
+			vertexBones[index] = bone;
+			normals[index] = normal;
+			vertices[index] = normal * MODEL_RADIUS + glm::vec3{0, 0, (BONE_LENGTH * (row % 2))};
+		}
+	}
+
+	mstudiomodel_t model{};
+
+	snprintf(model.name, sizeof(model.name), "body");
+
+	model.boundingradius = BONE_LENGTH * parameters.Bones;
+	model.numverts = parameters.Vertices;
+	model.vertinfoindex = writer.Append(vertexBones.data(), vertexBones.size());
+	model.vertindex = writer.Append(vertices.data(), vertices.size());
+	model.numnorms = parameters.Vertices;
+	model.norminfoindex = writer.Append(vertexBones.data(), vertexBones.size());
+	model.normindex = writer.Append(normals.data(), normals.size());
+
+	const int numTextures = std::min(parameters.Meshes, MAX_TEXTURES);
+
+	std::vector<mstudiomesh_t> meshes(parameters.Meshes);
+
+	const int maxCoordinate = parameters.TextureSize - 1;
+
+	for (int meshIndex = 0; meshIndex < parameters.Meshes; ++meshIndex)
+	{
+		auto& mesh = meshes[meshIndex];
+
+		const int firstRow = meshIndex * rowsPerMesh;
+
+		std::vector<short> triCmds;
+
+		for (int row = firstRow; row < firstRow + rowsPerMesh - 1; ++row)
+		{
+			triCmds.push_back(MODEL_GRID_WIDTH * 2);
+
+			for (int column = 0; column < MODEL_GRID_WIDTH; ++column)
+			{
+				for (int strip = 0; strip < 2; ++strip)
+				{
+					const int vertexRow = row + strip;
+					const auto vertex = static_cast<short>(vertexRow * MODEL_GRID_WIDTH + column);
+
+					triCmds.push_back(vertex);
+					triCmds.push_back(vertex);
+					triCmds.push_back(static_cast<short>((column * maxCoordinate) / (MODEL_GRID_WIDTH - 1)));
+					triCmds.push_back(static_cast<short>(((vertexRow - firstRow) * maxCoordinate) / (rowsPerMesh - 1)));
+				}
+			}
+		}
+
+		triCmds.push_back(0);
+
+		mesh.numtris = (rowsPerMesh - 1) * (MODEL_GRID_WIDTH * 2 - 2);
+		mesh.triindex = writer.Append(triCmds.data(), triCmds.size());
+		mesh.skinref = meshIndex % numTextures;
+		mesh.numnorms = rowsPerMesh * MODEL_GRID_WIDTH;
+		mesh.normindex = model.normindex + firstRow * MODEL_GRID_WIDTH * static_cast<int>(sizeof(glm::vec3));
+	}
+
+	model.nummesh = parameters.Meshes;
+	model.meshindex = writer.Append(meshes.data(), meshes.size());
+
+	mstudiobodyparts_t bodypart{};
+
+	snprintf(bodypart.name, sizeof(bodypart.name), "body");
+
+	bodypart.nummodels = 1;
+	bodypart.base = 1;
+	bodypart.modelindex = writer.Append(&model, 1);
+
+	header.numbodyparts = 1;
+	header.bodypartindex = writer.Append(&bodypart, 1);
+
+	//Texture 1 is chrome so both lighting paths are covered
+	std::vector<mstudiotexture_t> textures(numTextures);
+
+	header.numtextures = numTextures;
+	header.textureindex = writer.Append<mstudiotexture_t>(nullptr, numTextures);
+
+	const size_t uiPixels = static_cast<size_t>(parameters.TextureSize) * parameters.TextureSize;
+
+	for (int textureIndex = 0; textureIndex < numTextures; ++textureIndex)
+	{
+		auto& texture = textures[textureIndex];
+
+		texture = {};
+
+		snprintf(texture.name, sizeof(texture.name), "texture%d.bmp", textureIndex);
+
+		texture.flags = textureIndex == 1 ? STUDIO_NF_CHROME : 0;
+		texture.width = parameters.TextureSize;
+		texture.height = parameters.TextureSize;
+		texture.index = writer.Append<byte>(nullptr, uiPixels + PALETTE_SIZE);
+
+		if (textureIndex == 0)
+		{
+			header.texturedataindex = texture.index;
+		}
+
+		GeneratePixels(writer.Get<byte>(texture.index), texture.width, texture.height, textureIndex);
+		GeneratePalette(writer.Get<byte>(texture.index) + uiPixels, textureIndex);
+	}
+
+	memcpy(writer.Get<mstudiotexture_t>(header.textureindex), textures.data(), sizeof(mstudiotexture_t) * numTextures);
+
+	//The second family uses the textures in reverse order
+	std::vector<short> skins(numTextures * SKIN_FAMILIES);
+
+	for (int textureIndex = 0; textureIndex < numTextures; ++textureIndex)
+	{
+		skins[textureIndex] = static_cast<short>(textureIndex);
+		skins[numTextures + textureIndex] = static_cast<short>(numTextures - 1 - textureIndex);
+	}
+
+	header.numskinref = numTextures;
+	header.numskinfamilies = SKIN_FAMILIES;
+	header.skinindex = writer.Append(skins.data(), skins.size());
+
+	header.length = static_cast<int>(writer.GetSize());
+
+	memcpy(writer.Get<studiohdr_t>(0), &header, sizeof(header));
+
+	return writer.Release();
+}
+
+std::vector<byte> GenerateSprite(const int width, const int height, const int frames)
+{
+	//Sprites are packed
+	CBufferWriter writer{1};
+
+	sprite::dsprite_t header{};
+
+	header.ident = SPRITE_ID;
+	header.version = SPRITE_VERSION;
+	header.type = sprite::Type::VP_PARALLEL;
+	header.texFormat = sprite::TexFormat::SPR_NORMAL;
+	header.boundingradius = static_cast<float>(std::sqrt(width * width + height * height) / 2);
+	header.width = width;
+	header.height = height;
+	header.numframes = frames;
+	header.synctype = sprite::synctype_t::SYNC;
+
+	writer.Append(&header, 1);
+
+	const short paletteEntries = static_cast<short>(PALETTE_ENTRIES);
+
+	writer.Append(&paletteEntries, 1);
+
+	GeneratePalette(writer.Get<byte>(writer.Append<byte>(nullptr, PALETTE_SIZE)), 0);
+
+	for (int frame = 0; frame < frames; ++frame)
+	{
+		const auto type = sprite::spriteframetype_t::SINGLE;
+
+		writer.Append(&type, 1);
+
+		sprite::dspriteframe_t spriteFrame;
+
+		spriteFrame.origin = glm::ivec2{-width / 2, height / 2};
+		spriteFrame.width = width;
+		spriteFrame.height = height;
+
+		writer.Append(&spriteFrame, 1);
+
+		GeneratePixels(writer.Get<byte>(writer.Append<byte>(nullptr, static_cast<size_t>(width) * height)), width, height, frame);
+	}
+
+	return writer.Release();
+}
+
+std::string GenerateKeyvalues(const int blocks, const int keysPerBlock)
+{
+	std::string text;
+
+	char szLine[256];
+
+	for (int block = 0; block < blocks; ++block)
+	{
+		snprintf(szLine, sizeof(szLine), "\"block%d\"\n{\n", block);
+		text += szLine;
+
+		for (int key = 0; key < keysPerBlock; ++key)
+		{
+			snprintf(szLine, sizeof(szLine), "\t\"key%d\" \"value %d of block %d\"\n", key, key, block);
+			text += szLine;
+		}
+
+		snprintf(szLine, sizeof(szLine), "\t\"nested\"\n\t{\n\t\t\"origin\" \"%d %d %d\"\n\t\t\"scale\" \"%.2f\"\n\t}\n}\n",
+			block, block * 2, block * 3, block * 0.25f);
+		text += szLine;
+	}
+
+	return text;
+}
+
+void WriteAssetFile(const std::filesystem::path& fileName, const void* pData, const size_t uiSize)
+{
+	FILE* pFile = utf8_fopen(fileName.u8string().c_str(), "wb");
+
+	if (!pFile)
+	{
+		throw std::runtime_error("Couldn't open \"" + fileName.u8string() + "\" for writing");
+	}
+
+	const size_t uiWritten = fwrite(pData, uiSize, 1, pFile);
+
+	fclose(pFile);
+
+	if (uiWritten != 1)
+	{
+		throw std::runtime_error("Error writing \"" + fileName.u8string() + "\"");
+	}
+}
+}
@@ -0,0 +1,87 @@
+#ifndef BENCHMARKS_PROCEDURALASSETS_H
+#define BENCHMARKS_PROCEDURALASSETS_H
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "shared/Const.h"
+
+/**
+*	@ingroup Benchmarks
+*
+*	Generators for assets of configurable complexity, so benchmarks don't depend on game content.
+*
+*	@{
+*/
+
+namespace benchmarks
+{
+/**
+*	@brief Describes a generated studio model
+*/
+struct StudioModelParameters
+{
+	/**
+	*	Number of bones. Bones form a binary tree. At most MAXSTUDIOBONES.
+	*/
+	int Bones;
+
+	/**
+	*	Number of frames in the first sequence. The second sequence has 2 blends of at most 30 frames.
+	*/
+	int Frames;
+
+	/**
+	*	Number of vertices. Must be a multiple of MODEL_GRID_WIDTH * Meshes with at least 2 rows per mesh, and at most MAXSTUDIOVERTS.
+	*/
+	int Vertices;
+
+	/**
+	*	Number of meshes. Each mesh is a set of triangle strips over its own rows of vertices.
+	*/
+	int Meshes;
+
+	/**
+	*	Width and height of each texture.
+	*/
+	int TextureSize;
+
+	/**
+	*	@brief Gets a short description used in benchmark names
+	*/
+	std::string GetName() const;
+};
+
+/**
+*	Number of vertices in a row of a generated mesh.
+*/
+const int MODEL_GRID_WIDTH = 16;
+
+/**
+*	@brief Generates a studio model with embedded textures
+*	The first sequence animates all rotation channels and the root position, using run-length encoding where values repeat.
+*	@exception std::runtime_error If the parameters are out of range or the animation data exceeds the format's limits
+*/
+std::vector<byte> GenerateStudioModel(const StudioModelParameters& parameters);
+
+/**
+*	@brief Generates a sprite with single frames of the given size
+*/
+std::vector<byte> GenerateSprite(const int width, const int height, const int frames);
+
+/**
+*	@brief Generates keyvalues text with the given number of blocks, each containing keys and a nested block
+*/
+std::string GenerateKeyvalues(const int blocks, const int keysPerBlock);
+
+/**
+*	@brief Writes data to a file
+*	@exception std::runtime_error If the file could not be written
+*/
+void WriteAssetFile(const std::filesystem::path& fileName, const void* pData, const size_t uiSize);
+}
+
+/** @} */
+
+#endif //BENCHMARKS_PROCEDURALASSETS_H
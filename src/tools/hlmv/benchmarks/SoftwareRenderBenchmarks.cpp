@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "shared/Logging.h"
+
+#include "shared/studiomodel/CStudioModel.h"
+#include "shared/studiomodel/StudioBounds.h"
+
+#include "renderer/gl/CBaseGLRenderContext.h"
+#include "renderer/software/CRenderContextSoftware.h"
+#include "renderer/studiomodel/CStudioModelRenderer.h"
+
+#include "Benchmarks.h"
+#include "CBenchmarkRunner.h"
+
+namespace benchmarks
+{
+namespace
+{
+const int FRAMEBUFFER_WIDTH = 640;
+const int FRAMEBUFFER_HEIGHT = 480;
+
+const float FIELD_OF_VIEW = 65;
+
+/**
+*	@brief Draws a model in the software render context the way the 3D view draws it, framed like Center View does
+*/
+class CSoftwareRenderBenchmarks final
+{
+public:
+	CSoftwareRenderBenchmarks(CBenchmarkRunner& runner, const BenchmarkAsset& asset)
+		: m_Runner(runner)
+		, m_Asset(asset)
+		, m_Renderer(&m_RenderContext)
+	{
+		m_RenderContext.SetFramebufferSize(FRAMEBUFFER_WIDTH, FRAMEBUFFER_HEIGHT);
+		m_Renderer.Initialize();
+	}
+
+	~CSoftwareRenderBenchmarks()
+	{
+		if (m_Model)
+		{
+			for (auto texture : m_Model->ReleaseTextures())
+			{
+				m_RenderContext.DestroyTexture(renderer::GLToTexHandle(texture));
+			}
+		}
+	}
+
+	void Run()
+	{
+		try
+		{
+			m_Model = LoadBenchmarkModel(m_Asset.FileName, &m_RenderContext);
+		}
+		catch (const studiomdl::StudioModelException& e)
+		{
+			Error("Couldn't load model \"%s\": %s\n", m_Asset.FileName.u8string().c_str(), e.what());
+			return;
+		}
+
+		m_RenderInfo.vecOrigin = glm::vec3{0};
+		m_RenderInfo.vecAngles = glm::vec3{0};
+		m_RenderInfo.vecScale = glm::vec3{1};
+		m_RenderInfo.pModel = m_Model.get();
+		m_RenderInfo.flTransparency = 1;
+		m_RenderInfo.iSequence = 0;
+		m_RenderInfo.flFrame = 0;
+		m_RenderInfo.iBodygroup = 0;
+		m_RenderInfo.iSkin = 0;
+		m_RenderInfo.iBlender[0] = m_RenderInfo.iBlender[1] = 0;
+		m_RenderInfo.iController[0] = m_RenderInfo.iController[1] = m_RenderInfo.iController[2] = m_RenderInfo.iController[3] = 0;
+		m_RenderInfo.iMouth = 0;
+
+		SetUpView();
+
+		std::vector<byte> pixels(static_cast<size_t>(FRAMEBUFFER_WIDTH) * FRAMEBUFFER_HEIGHT * 4);
+		std::vector<byte> singleThreadPixels(pixels.size());
+
+		const auto uiFirstPrimitive = m_RenderContext.GetRasterizedPrimitiveCount();
+
+		DrawFrame(pixels);
+
+		const auto numPrimitives = m_RenderContext.GetRasterizedPrimitiveCount() - uiFirstPrimitive;
+
+		m_RenderContext.SetNumThreads(1);
+		DrawFrame(singleThreadPixels);
+		m_RenderContext.SetNumThreads(0);
+
+		if (pixels != singleThreadPixels)
+		{
+			Error("Software rendered image of \"%s\" depends on the number of threads\n", m_Asset.Name.c_str());
+		}
+
+		//Items are rasterized triangles
+		m_Runner.Run("StudioModel/SoftwareRender/" + m_Asset.Name, numPrimitives, 0, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					DrawFrame(pixels);
+					DoNotOptimize(pixels);
+				}
+			});
+
+		m_RenderContext.SetNumThreads(1);
+
+		m_Runner.Run("StudioModel/SoftwareRender/" + m_Asset.Name + "/SingleThread", numPrimitives, 0, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					DrawFrame(pixels);
+					DoNotOptimize(pixels);
+				}
+			});
+
+		m_RenderContext.SetNumThreads(0);
+	}
+
+private:
+	void SetUpView()
+	{
+		const auto bounds = studiomdl::CalcSequenceBounds(*m_Model);
+
+		const auto& mins = bounds[0].Mins;
+		const auto& maxs = bounds[0].Maxs;
+
+		const float flLargest = std::max({maxs.x - mins.x, maxs.y - mins.y, maxs.z - mins.z});
+
+		//See CHLMVState::CenterView and C3DView::DrawModel
+		const glm::vec3 vecOrigin{-(mins.z + (maxs.z - mins.z) / 2), flLargest, 0};
+		const glm::vec3 vecAngles{-90.0f, 0.0f, -90.0f};
+
+		m_View = Mat4x4ModelView();
+
+		m_View *= glm::translate(glm::mat4x4{1.0f}, -vecOrigin);
+		m_View *= glm::rotate(glm::mat4x4{1.0f}, glm::radians(vecAngles[2]), glm::vec3{1, 0, 0});
+		m_View *= glm::rotate(glm::mat4x4{1.0f}, glm::radians(vecAngles[0]), glm::vec3{0, 1, 0});
+		m_View *= glm::rotate(glm::mat4x4{1.0f}, glm::radians(vecAngles[1]), glm::vec3{0, 0, 1});
+
+		m_Renderer.SetViewerOrigin(glm::vec3(glm::inverse(m_View)[3]));
+
+		glm::vec3 vecViewerRight;
+
+		AngleVectors(-vecAngles + 180.0f, nullptr, nullptr, &vecViewerRight);
+
+		m_Renderer.SetViewerRight(-vecViewerRight);
+	}
+
+	void DrawFrame(std::vector<byte>& pixels)
+	{
+		m_RenderContext.ClearColor(63 / 255.0f, 95 / 255.0f, 127 / 255.0f, 1);
+		m_RenderContext.SetDepthMask(true);
+		m_RenderContext.Clear(renderer::ClearBit::COLOR | renderer::ClearBit::DEPTH);
+
+		m_RenderContext.MatrixMode(renderer::MatrixMode::PROJECTION);
+		m_RenderContext.LoadIdentity();
+		m_RenderContext.PerspectiveY(glm::radians(FIELD_OF_VIEW), static_cast<float>(FRAMEBUFFER_WIDTH) / FRAMEBUFFER_HEIGHT, 1.0f, static_cast<float>(1 << 24));
+
+		m_RenderContext.MatrixMode(renderer::MatrixMode::MODEL);
+		m_RenderContext.LoadMatrix(m_View);
+
+		//Textured render mode with backface culling
+		m_RenderContext.SetPolygonMode(renderer::PolygonMode::FILL);
+		m_RenderContext.Enable(renderer::Capability::TEXTURE_2D);
+		m_RenderContext.Enable(renderer::Capability::CULL_FACE);
+		m_RenderContext.Enable(renderer::Capability::DEPTH_TEST);
+		m_RenderContext.SetShadeModel(renderer::ShadeModel::SMOOTH);
+		m_RenderContext.SetCullFace(renderer::CullFace::FRONT);
+
+		m_Renderer.RunFrame();
+		m_Renderer.DrawModel(&m_RenderInfo, renderer::DrawFlag::DRAW_SHADOWS);
+
+		m_RenderContext.ReadPixels(0, 0, FRAMEBUFFER_WIDTH, FRAMEBUFFER_HEIGHT, renderer::ImageFormat::RGBA, pixels.data());
+	}
+
+private:
+	CBenchmarkRunner& m_Runner;
+	const BenchmarkAsset& m_Asset;
+
+	renderer::CRenderContextSoftware m_RenderContext;
+	studiomdl::CStudioModelRenderer m_Renderer;
+
+	std::unique_ptr<studiomdl::CStudioModel> m_Model;
+
+	studiomdl::CModelRenderInfo m_RenderInfo;
+
+	glm::mat4x4 m_View;
+
+private:
+	CSoftwareRenderBenchmarks(const CSoftwareRenderBenchmarks&) = delete;
+	CSoftwareRenderBenchmarks& operator=(const CSoftwareRenderBenchmarks&) = delete;
+};
+}
+
+void RunSoftwareRenderBenchmarks(CBenchmarkRunner& runner, const BenchmarkAssets& assets)
+{
+	for (const auto& asset : assets.Models)
+	{
+		auto benchmarks = std::make_unique<CSoftwareRenderBenchmarks>(runner, asset);
+
+		benchmarks->Run();
+	}
+}
+}
@@ -0,0 +1,857 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "shared/Logging.h"
+
+#include "shared/studiomodel/CStudioHitboxQuery.h"
+#include "shared/studiomodel/CStudioModel.h"
+#include "shared/studiomodel/CStudioModelPose.h"
+#include "shared/studiomodel/StudioAnimation.h"
+#include "shared/studiomodel/StudioAnimationOptimizer.h"
+#include "shared/studiomodel/StudioBounds.h"
+#include "shared/studiomodel/StudioUVMap.h"
+#include "shared/studiomodel/TriangleCommands.h"
+
+#include "renderer/gl/CBaseGLRenderContext.h"
+
+#include "renderer/studiomodel/BoneTransforms.h"
+#include "renderer/studiomodel/CStudioModelRenderer.h"
+#include "renderer/studiomodel/ShadowProjection.h"
+
+#include "Benchmarks.h"
+#include "CBenchmarkRunner.h"
+#include "CMockRenderContext.h"
+
+namespace benchmarks
+{
+std::unique_ptr<studiomdl::CStudioModel> LoadBenchmarkModel(const std::filesystem::path& fileName, renderer::IRenderContext* pRenderContext)
+{
+	auto mainHeader = studiomdl::LoadStudioHeader<studiohdr_t>(fileName.u8string().c_str(), false);
+
+	auto baseFileName = fileName;
+
+	baseFileName.replace_extension();
+
+	studiomdl::studio_ptr<studiohdr_t> textureHeader;
+
+	if (mainHeader->numtextures == 0)
+	{
+		auto textureFileName = baseFileName;
+
+		textureFileName += "T.mdl";
+
+		textureHeader = studiomdl::LoadStudioHeader<studiohdr_t>(textureFileName.u8string().c_str(), true);
+	}
+
+	std::vector<studiomdl::studio_ptr<studioseqhdr_t>> sequenceHeaders;
+
+	for (int i = 1; i < mainHeader->numseqgroups; ++i)
+	{
+		char szSuffix[16];
+
+		snprintf(szSuffix, sizeof(szSuffix), "%02d.mdl", i);
+
+		sequenceHeaders.emplace_back(studiomdl::LoadStudioHeader<studioseqhdr_t>((baseFileName.u8string() + szSuffix).c_str(), true));
+	}
+
+	std::vector<GLuint> textures;
+
+	if (pRenderContext)
+	{
+		auto& header = textureHeader ? *textureHeader : *mainHeader;
+
+		const auto pTextures = header.GetTextures();
+
+		for (int i = 0; i < header.numtextures; ++i)
+		{
+			const auto& texture = pTextures[i];
+
+			int width, height;
+
+			auto pixels = studiomdl::ConvertTextureToRGBA(texture, header.GetData() + texture.index,
+				header.GetData() + texture.index + texture.width * texture.height, true, width, height);
+
+			renderer::HTexture_t hTexture = NULL_TEXTURE_HANDLE;
+
+			if (pixels)
+			{
+				hTexture = pRenderContext->CreateTexture(0, renderer::ImageFormat::RGBA, width, height, pixels.get());
+				pRenderContext->SetMinMagFilters(renderer::MinFilter::LINEAR, renderer::MagFilter::LINEAR);
+			}
+
+			textures.push_back(renderer::TexHandleToGL(hTexture));
+		}
+	}
+
+	return std::make_unique<studiomdl::CStudioModel>(fileName.u8string(), std::move(mainHeader), std::move(textureHeader),
+		std::move(sequenceHeaders), std::move(textures));
+}
+
+/**
+*	@brief Drives the renderer's bone setup and vertex processing with a mock render context
+*/
+class CStudioModelRendererBenchmarks final
+{
+public:
+	CStudioModelRendererBenchmarks(CBenchmarkRunner& runner, const BenchmarkAsset& asset, std::unique_ptr<studiomdl::CStudioModel>&& model)
+		: m_Runner(runner)
+		, m_Asset(asset)
+		, m_Model(std::move(model))
+		, m_Renderer(std::make_unique<studiomdl::CStudioModelRenderer>(&m_RenderContext))
+	{
+		m_RenderInfo.vecOrigin = glm::vec3{0};
+		m_RenderInfo.vecAngles = glm::vec3{0};
+		m_RenderInfo.vecScale = glm::vec3{1};
+		m_RenderInfo.pModel = m_Model.get();
+		m_RenderInfo.flTransparency = 1;
+		m_RenderInfo.iSequence = 0;
+		m_RenderInfo.flFrame = 0;
+		m_RenderInfo.iBodygroup = 0;
+		m_RenderInfo.iSkin = 0;
+		m_RenderInfo.iBlender[0] = m_RenderInfo.iBlender[1] = 0;
+		m_RenderInfo.iController[0] = m_RenderInfo.iController[1] = m_RenderInfo.iController[2] = m_RenderInfo.iController[3] = 0;
+		m_RenderInfo.iMouth = 0;
+
+		m_Renderer->PrepareModel(&m_RenderInfo);
+	}
+
+	void Run()
+	{
+		auto pStudioHdr = m_Model->GetStudioHeader();
+
+		const auto numBones = static_cast<std::uint64_t>(pStudioHdr->numbones);
+
+		auto pSequence = pStudioHdr->GetSequence(0);
+
+		if (pSequence->seqgroup == 0)
+		{
+			auto panim = m_Model->GetAnim(pSequence);
+
+			const float flMaxFrame = static_cast<float>(std::max(1, pSequence->numframes - 1));
+
+			m_Runner.Run("StudioModel/CalcRotations/" + m_Asset.Name, numBones, 0, [&](std::uint64_t uiIterations)
+				{
+					for (std::uint64_t i = 0; i < uiIterations; ++i)
+					{
+						CalcRotations(m_Positions1, m_Quaternions1, pSequence, panim, GetFrame(i, flMaxFrame));
+						DoNotOptimize(m_Quaternions1);
+					}
+				});
+
+			CalcRotations(m_Positions1, m_Quaternions1, pSequence, panim, 0);
+			CalcRotations(m_Positions2, m_Quaternions2, pSequence, panim, flMaxFrame / 2);
+
+			m_Runner.Run("StudioModel/SlerpBones/" + m_Asset.Name, numBones, 0, [&](std::uint64_t uiIterations)
+				{
+					for (std::uint64_t i = 0; i < uiIterations; ++i)
+					{
+						for (std::uint64_t bone = 0; bone < numBones; ++bone)
+						{
+							studiomdl::BlendBone(m_Quaternions1[bone], m_Positions1[bone], m_Quaternions2[bone], m_Positions2[bone], 0.3f);
+						}
+
+						DoNotOptimize(m_Quaternions1);
+					}
+				});
+		}
+
+		RunSetUpBones("StudioModel/SetUpBones/" + m_Asset.Name, 0, numBones, 0, 0);
+
+		//Blended sequences decode each bone once per blend
+		for (int sequence = 0; sequence < pStudioHdr->numseq; ++sequence)
+		{
+			if (pStudioHdr->GetSequence(sequence)->numblends > 1)
+			{
+				RunSetUpBones("StudioModel/SetUpBonesBlended/" + m_Asset.Name, sequence, numBones, 64, 192);
+
+				//All weight on one blend, only that blend is evaluated
+				RunSetUpBones("StudioModel/SetUpBonesBlendedSingle/" + m_Asset.Name, sequence, numBones, 255, 0);
+				break;
+			}
+		}
+
+		RunBoneTransforms(numBones);
+
+		RunPose();
+
+		RunHitboxQuery();
+
+		RunSequenceBounds();
+
+		RunAnimationOptimizer(numBones);
+
+		RunUVMaps();
+
+		RunMeshState();
+
+		m_RenderInfo.iSequence = 0;
+		m_RenderInfo.flFrame = 0;
+
+		m_Renderer->SetUpBones();
+		m_Renderer->SetupLighting();
+		m_Renderer->SetupModel(0);
+
+		const auto pModel = m_Renderer->GetCurrentSubModel();
+
+		m_Runner.Run("StudioModel/TransformVertices/" + m_Asset.Name, static_cast<std::uint64_t>(pModel->numverts), 0, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					m_Renderer->TransformVertices();
+					DoNotOptimize(m_Renderer->GetTransformedVertices());
+				}
+			});
+
+		std::vector<glm::vec3> shadowVertices(static_cast<size_t>(pModel->numverts));
+
+		m_Runner.Run("StudioModel/ProjectShadowVertices/" + m_Asset.Name, static_cast<std::uint64_t>(pModel->numverts), 0, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					studiomdl::ProjectShadowVertices(m_Renderer->GetTransformedVertices(), shadowVertices.size(), m_Renderer->GetLightVector(), 0, 1, shadowVertices.data());
+					DoNotOptimize(shadowVertices);
+				}
+			});
+
+		const auto pTextures = m_Model->GetTextureHeader()->GetTextures();
+		const auto pSkinRef = m_Renderer->GetSkinReferences();
+
+		m_Runner.Run("StudioModel/LightVertices/" + m_Asset.Name, static_cast<std::uint64_t>(pModel->numnorms), 0, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					m_Renderer->LightVertices(pTextures, pSkinRef);
+					DoNotOptimize(m_Renderer->GetLightValues());
+				}
+			});
+	}
+
+private:
+	/**
+	*	@brief Times the vectorized bone matrix kernels against their scalar references and checks that they agree
+	*/
+	void RunBoneTransforms(const std::uint64_t numBones)
+	{
+		auto pStudioHdr = m_Model->GetStudioHeader();
+
+		auto pSequence = pStudioHdr->GetSequence(0);
+
+		if (pSequence->seqgroup != 0)
+		{
+			return;
+		}
+
+		CalcRotations(m_Positions1, m_Quaternions1, pSequence, m_Model->GetAnim(pSequence), 0);
+
+		auto pose = std::make_unique<studiomdl::BonePose>();
+
+		pose->Load(m_Positions1, m_Quaternions1, pStudioHdr->numbones);
+
+		const auto pBones = pStudioHdr->GetBones();
+
+		for (const bool bReference : {false, true})
+		{
+			const std::string suffix = m_Asset.Name + (bReference ? "/Reference" : "");
+
+			auto pLocal = bReference ? m_LocalReference : m_Local;
+			auto pTransforms = bReference ? m_TransformsReference : m_Transforms;
+
+			m_Runner.Run("StudioModel/QuaternionMatrices/" + suffix, numBones, 0, [&](std::uint64_t uiIterations)
+				{
+					for (std::uint64_t i = 0; i < uiIterations; ++i)
+					{
+						if (bReference)
+						{
+							studiomdl::QuaternionMatricesReference(*pose, pLocal);
+						}
+						else
+						{
+							studiomdl::QuaternionMatrices(*pose, pLocal);
+						}
+
+						DoNotOptimize(pLocal);
+					}
+				});
+
+			m_Runner.Run("StudioModel/ConcatenateBoneTransforms/" + suffix, numBones, 0, [&](std::uint64_t uiIterations)
+				{
+					for (std::uint64_t i = 0; i < uiIterations; ++i)
+					{
+						if (bReference)
+						{
+							studiomdl::ConcatenateBoneTransformsReference(pBones, pLocal, pStudioHdr->numbones, pTransforms);
+						}
+						else
+						{
+							studiomdl::ConcatenateBoneTransforms(pBones, pLocal, pStudioHdr->numbones, pTransforms);
+						}
+
+						DoNotOptimize(pTransforms);
+					}
+				});
+		}
+
+		//The reference converts quaternions in double precision, so allow for rounding that accumulates down the hierarchy
+		float flMaxError = 0;
+
+		for (int bone = 0; bone < pStudioHdr->numbones; ++bone)
+		{
+			for (int row = 0; row < 3; ++row)
+			{
+				for (int column = 0; column < 4; ++column)
+				{
+					const float flReference = m_TransformsReference[bone][row][column];
+					const float flError = std::abs(m_Transforms[bone][row][column] - flReference) / std::max(1.0f, std::abs(flReference));
+
+					flMaxError = std::max(flMaxError, flError);
+				}
+			}
+		}
+
+		if (flMaxError > 1e-4f)
+		{
+			Error("Bone transforms of \"%s\" differ from the reference by %g\n", m_Asset.Name.c_str(), flMaxError);
+		}
+	}
+
+	/**
+	*	@brief Times querying the hitbox of the last bone, which only evaluates that bone's ancestors, and checks the pose against the renderer's
+	*/
+	void RunPose()
+	{
+		auto pStudioHdr = m_Model->GetStudioHeader();
+
+		if (pStudioHdr->numhitboxes == 0)
+		{
+			return;
+		}
+
+		auto pose = std::make_unique<studiomdl::CStudioModelPose>();
+
+		m_RenderInfo.iSequence = 0;
+		m_RenderInfo.flFrame = 0;
+
+		m_Renderer->SetUpBones();
+		pose->SetPose(m_RenderInfo);
+
+		//The renderer converts quaternions in single precision, the pose uses QuaternionMatrix
+		float flMaxError = 0;
+
+		for (int bone = 0; bone < pStudioHdr->numbones; ++bone)
+		{
+			const auto& transform = pose->GetBoneTransform(bone);
+
+			for (int row = 0; row < 3; ++row)
+			{
+				for (int column = 0; column < 4; ++column)
+				{
+					const float flReference = m_Renderer->GetBoneTransforms()[bone][row][column];
+					const float flError = std::abs(transform[row][column] - flReference) / std::max(1.0f, std::abs(flReference));
+
+					flMaxError = std::max(flMaxError, flError);
+				}
+			}
+		}
+
+		if (flMaxError > 1e-4f)
+		{
+			Error("Pose of \"%s\" differs from the renderer by %g\n", m_Asset.Name.c_str(), flMaxError);
+		}
+
+		const float flMaxFrame = static_cast<float>(std::max(1, pStudioHdr->GetSequence(0)->numframes - 1));
+
+		const int hitbox = pStudioHdr->numhitboxes - 1;
+
+		m_Runner.Run("StudioModel/PoseHitbox/" + m_Asset.Name, 1, 0, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					m_RenderInfo.flFrame = GetFrame(i, flMaxFrame);
+					pose->SetPose(m_RenderInfo);
+
+					auto box = pose->GetHitbox(hitbox);
+					DoNotOptimize(box);
+				}
+			});
+
+		m_RenderInfo.flFrame = 0;
+	}
+
+	/**
+	*	@brief Times tracing a batch of rays aimed at the hitboxes, and checks the vectorized queries against the reference
+	*/
+	void RunHitboxQuery()
+	{
+		auto pStudioHdr = m_Model->GetStudioHeader();
+
+		if (pStudioHdr->numhitboxes == 0)
+		{
+			return;
+		}
+
+		m_RenderInfo.iSequence = 0;
+		m_RenderInfo.flFrame = 0;
+
+		m_Renderer->SetUpBones();
+
+		studiomdl::CStudioHitboxQuery query;
+
+		query.Update(pStudioHdr, m_Renderer->GetBoneTransforms());
+
+		//Rays from a ring around the model towards each hitbox, offset so some of them miss
+		const size_t numRays = 256;
+
+		std::vector<studiomdl::HitboxRay> rays(numRays);
+
+		for (size_t i = 0; i < numRays; ++i)
+		{
+			const auto pHitbox = pStudioHdr->GetHitBox(static_cast<int>(i % pStudioHdr->numhitboxes));
+			const auto box = studiomdl::CalcHitboxOBB(*pHitbox, m_Renderer->GetBoneTransforms()[pHitbox->bone]);
+
+			const float flAngle = i * 0.7f;
+			const float flOffset = static_cast<float>(i % 5) - 2.0f;
+
+			auto& ray = rays[i];
+
+			ray.Origin = box.Center + glm::vec3{std::cos(flAngle) * 256, std::sin(flAngle) * 256, flOffset * 16};
+			ray.Direction = box.Center + glm::vec3{flOffset * 3, -flOffset * 3, 0} - ray.Origin;
+			ray.MaxDistance = 2;
+		}
+
+		std::vector<studiomdl::HitboxHit> hits(numRays);
+
+		query.TraceRays(rays.data(), numRays, hits.data());
+
+		size_t mismatches = 0;
+
+		for (size_t i = 0; i < numRays; ++i)
+		{
+			studiomdl::HitboxHit reference;
+
+			query.TraceRayReference(rays[i], reference);
+
+			if (reference.Hitbox != hits[i].Hitbox || std::abs(reference.Distance - hits[i].Distance) > 1e-6f)
+			{
+				++mismatches;
+			}
+		}
+
+		if (mismatches > 0)
+		{
+			Error("Hitbox queries of \"%s\" differ from the reference for %u of %u rays\n",
+				m_Asset.Name.c_str(), static_cast<unsigned int>(mismatches), static_cast<unsigned int>(numRays));
+		}
+
+		m_Runner.Run("StudioModel/HitboxTraceRays/" + m_Asset.Name, static_cast<std::uint64_t>(numRays), 0, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					query.TraceRays(rays.data(), numRays, hits.data());
+					DoNotOptimize(hits);
+				}
+			});
+
+		m_Runner.Run("StudioModel/HitboxTraceRays/" + m_Asset.Name + "/Reference", static_cast<std::uint64_t>(numRays), 0, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					for (size_t ray = 0; ray < numRays; ++ray)
+					{
+						query.TraceRayReference(rays[ray], hits[ray]);
+					}
+
+					DoNotOptimize(hits);
+				}
+			});
+	}
+
+	/**
+	*	@brief Times recomputing the bounds of all sequences on all cores and on one, and checks that both agree
+	*/
+	void RunSequenceBounds()
+	{
+		auto pStudioHdr = m_Model->GetStudioHeader();
+
+		std::uint64_t numVertices = 0;
+
+		for (int bodypart = 0; bodypart < pStudioHdr->numbodyparts; ++bodypart)
+		{
+			const auto pBodypart = pStudioHdr->GetBodypart(bodypart);
+			const auto pModels = reinterpret_cast<const mstudiomodel_t*>(pStudioHdr->GetData() + pBodypart->modelindex);
+
+			for (int model = 0; model < pBodypart->nummodels; ++model)
+			{
+				numVertices += static_cast<std::uint64_t>(pModels[model].numverts);
+			}
+		}
+
+		std::uint64_t numFrames = 0;
+
+		for (int sequence = 0; sequence < pStudioHdr->numseq; ++sequence)
+		{
+			numFrames += static_cast<std::uint64_t>(pStudioHdr->GetSequence(sequence)->numframes * pStudioHdr->GetSequence(sequence)->numblends);
+		}
+
+		const auto bounds = studiomdl::CalcSequenceBounds(*m_Model);
+		const auto singleThreadBounds = studiomdl::CalcSequenceBounds(*m_Model, 1);
+
+		for (size_t sequence = 0; sequence < bounds.size(); ++sequence)
+		{
+			if (bounds[sequence].IsEmpty()
+				|| bounds[sequence].Mins != singleThreadBounds[sequence].Mins
+				|| bounds[sequence].Maxs != singleThreadBounds[sequence].Maxs)
+			{
+				Error("Bounds of sequence %u of \"%s\" are empty or depend on the number of threads\n",
+					static_cast<unsigned int>(sequence), m_Asset.Name.c_str());
+			}
+		}
+
+		//Items are transformed vertices
+		m_Runner.Run("StudioModel/SequenceBounds/" + m_Asset.Name, numFrames * numVertices, 0, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					auto result = studiomdl::CalcSequenceBounds(*m_Model);
+					DoNotOptimize(result);
+				}
+			});
+
+		m_Runner.Run("StudioModel/SequenceBounds/" + m_Asset.Name + "/SingleThread", numFrames * numVertices, 0, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					auto result = studiomdl::CalcSequenceBounds(*m_Model, 1);
+					DoNotOptimize(result);
+				}
+			});
+	}
+
+	/**
+	*	@brief Times decoding the first sequence of a copy of the model after optimizing its animations, and checks that every frame
+	*	decodes to the same pose as before
+	*/
+	void RunAnimationOptimizer(const std::uint64_t numBones)
+	{
+		auto pSequence = m_Model->GetStudioHeader()->GetSequence(0);
+
+		if (pSequence->seqgroup != 0)
+		{
+			return;
+		}
+
+		auto optimizedModel = LoadBenchmarkModel(m_Asset.FileName);
+
+		const auto results = studiomdl::OptimizeAnimations(*optimizedModel);
+
+		if (!results.empty() && !results[0].Optimized)
+		{
+			Error("The animations of \"%s\" could not be optimized\n", m_Asset.Name.c_str());
+			return;
+		}
+
+		auto panim = m_Model->GetAnim(pSequence);
+		auto pOptimizedAnim = optimizedModel->GetAnim(optimizedModel->GetStudioHeader()->GetSequence(0));
+
+		for (int frame = 0; frame < pSequence->numframes; ++frame)
+		{
+			CalcRotations(m_Positions1, m_Quaternions1, pSequence, panim, static_cast<float>(frame));
+			CalcRotations(m_Positions2, m_Quaternions2, pSequence, pOptimizedAnim, static_cast<float>(frame));
+
+			for (std::uint64_t bone = 0; bone < numBones; ++bone)
+			{
+				bool bSame = m_Positions1[bone] == m_Positions2[bone];
+
+				//Quaternions can differ in the last bit, since where a run ends changes whether the decoder slerps
+				for (int i = 0; i < 4; ++i)
+				{
+					bSame = bSame && std::fabs(m_Quaternions1[bone][i] - m_Quaternions2[bone][i]) <= 1e-6f;
+				}
+
+				if (!bSame)
+				{
+					Error("Optimized animations of \"%s\" decode differently at frame %d\n", m_Asset.Name.c_str(), frame);
+					return;
+				}
+			}
+		}
+
+		const float flMaxFrame = static_cast<float>(std::max(1, pSequence->numframes - 1));
+
+		m_Runner.Run("StudioModel/CalcRotations/" + m_Asset.Name + "/Optimized", numBones, 0, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					CalcRotations(m_Positions1, m_Quaternions1, pSequence, pOptimizedAnim, GetFrame(i, flMaxFrame));
+					DoNotOptimize(m_Quaternions1);
+				}
+			});
+	}
+
+	/**
+	*	@brief Times drawing the UV maps of all textures on all cores and on one, and checks that both agree
+	*/
+	void RunUVMaps()
+	{
+		const auto pTextureHdr = m_Model->GetTextureHeader();
+
+		std::uint64_t numTriangles = 0;
+
+		for (int texture = 0; texture < pTextureHdr->numtextures; ++texture)
+		{
+			for (auto pMesh : studiomdl::GetMeshesUsingTexture(*m_Model, texture))
+			{
+				numTriangles += studiomdl::DecodeTriangleCommands(
+					reinterpret_cast<const short*>(m_Model->GetStudioHeader()->GetData() + pMesh->triindex),
+					[](const short*, const short*, const short*) {});
+			}
+		}
+
+		studiomdl::UVMapSettings settings;
+
+		settings.AntiAliasLines = true;
+		settings.OverlapHeatmap = true;
+
+		std::vector<studiomdl::UVMapImage> images(pTextureHdr->numtextures);
+
+		studiomdl::DrawUVMaps(*m_Model, settings, [&](int texture, studiomdl::UVMapImage&& image)
+			{
+				images[texture] = std::move(image);
+			});
+
+		for (int texture = 0; texture < pTextureHdr->numtextures; ++texture)
+		{
+			if (images[texture].Pixels != studiomdl::DrawUVMap(*m_Model, texture, settings).Pixels)
+			{
+				Error("UV map of texture %d of \"%s\" depends on the number of threads\n", texture, m_Asset.Name.c_str());
+			}
+		}
+
+		//Items are triangles, counted once for each texture they are drawn in
+		m_Runner.Run("StudioModel/UVMaps/" + m_Asset.Name, numTriangles, 0, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					studiomdl::DrawUVMaps(*m_Model, settings, [](int, studiomdl::UVMapImage&& image)
+						{
+							DoNotOptimize(image);
+						});
+				}
+			});
+
+		m_Runner.Run("StudioModel/UVMaps/" + m_Asset.Name + "/SingleThread", numTriangles, 0, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					studiomdl::DrawUVMaps(*m_Model, settings, [](int, studiomdl::UVMapImage&& image)
+						{
+							DoNotOptimize(image);
+						}, 1);
+				}
+			});
+	}
+
+	/**
+	*	@brief Times setting up the state of every mesh of every submodel and skin family, in draw order,
+	*	and checks that filtering redundant changes leaves the same state as passing on every change
+	*/
+	void RunMeshState()
+	{
+		auto pStudioHdr = m_Model->GetStudioHeader();
+		auto pTextureHdr = m_Model->GetTextureHeader();
+
+		if (pTextureHdr->numtextures == 0)
+		{
+			return;
+		}
+
+		struct MeshState
+		{
+			const mstudiotexture_t* pTexture;
+			renderer::HTexture_t hTexture;
+		};
+
+		std::vector<MeshState> meshes;
+
+		for (int bodypart = 0; bodypart < pStudioHdr->numbodyparts; ++bodypart)
+		{
+			const auto pBodypart = pStudioHdr->GetBodypart(bodypart);
+			const auto pModels = reinterpret_cast<const mstudiomodel_t*>(pStudioHdr->GetData() + pBodypart->modelindex);
+
+			for (int model = 0; model < pBodypart->nummodels; ++model)
+			{
+				for (int skin = 0; skin < std::max(1, pTextureHdr->numskinfamilies); ++skin)
+				{
+					for (const auto& mesh : m_Model->GetSortedMeshes(pModels + model, skin, true))
+					{
+						meshes.push_back({pTextureHdr->GetTexture(mesh.texture), reinterpret_cast<renderer::HTexture_t>(static_cast<size_t>(mesh.texture + 1))});
+					}
+				}
+			}
+		}
+
+		auto setupMesh = [](studiomdl::CStudioModelRenderer& studioRenderer, renderer::IRenderContext& context, const MeshState& mesh)
+		{
+			studioRenderer.SetupMeshState(*mesh.pTexture);
+			context.BindTexture(mesh.hTexture);
+
+			if (mesh.pTexture->flags & STUDIO_NF_MASKED)
+			{
+				context.Disable(renderer::Capability::ALPHA_TEST);
+			}
+		};
+
+		CMockRenderContext referenceContext;
+		studiomdl::CStudioModelRenderer reference(&referenceContext);
+
+		reference.PrepareModel(&m_RenderInfo);
+
+		m_RenderContext.InvalidateState();
+		m_RenderContext.ResetStateChangeStats();
+
+		size_t mismatches = 0;
+
+		for (const auto& mesh : meshes)
+		{
+			setupMesh(*m_Renderer, m_RenderContext, mesh);
+
+			referenceContext.InvalidateState();
+			setupMesh(reference, referenceContext, mesh);
+
+			if (m_RenderContext.GetAppliedState() != referenceContext.GetAppliedState())
+			{
+				++mismatches;
+			}
+		}
+
+		if (mismatches > 0)
+		{
+			Error("Filtered mesh state of \"%s\" differs from the unfiltered state for %u of %u meshes\n",
+				m_Asset.Name.c_str(), static_cast<unsigned int>(mismatches), static_cast<unsigned int>(meshes.size()));
+		}
+
+		//Items are meshes
+		m_Runner.Run("StudioModel/MeshState/" + m_Asset.Name, meshes.size(), 0, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					for (const auto& mesh : meshes)
+					{
+						setupMesh(*m_Renderer, m_RenderContext, mesh);
+					}
+
+					DoNotOptimize(m_RenderContext.GetAppliedState());
+				}
+			});
+
+		m_Runner.Run("StudioModel/MeshState/" + m_Asset.Name + "/Unfiltered", meshes.size(), 0, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					for (const auto& mesh : meshes)
+					{
+						referenceContext.InvalidateState();
+						setupMesh(reference, referenceContext, mesh);
+					}
+
+					DoNotOptimize(referenceContext.GetAppliedState());
+				}
+			});
+	}
+
+	/**
+	*	@brief Gets a frame for the given iteration. Fractional so frames are interpolated
+	*/
+	static float GetFrame(const std::uint64_t uiIteration, const float flMaxFrame)
+	{
+		return static_cast<float>(std::fmod(uiIteration * 0.37, flMaxFrame));
+	}
+
+	void RunSetUpBones(const std::string& name, const int sequence, const std::uint64_t numBones, const byte blenderX, const byte blenderY)
+	{
+		auto pSequence = m_Model->GetStudioHeader()->GetSequence(sequence);
+
+		const float flMaxFrame = static_cast<float>(std::max(1, pSequence->numframes - 1));
+
+		m_RenderInfo.iSequence = sequence;
+		m_RenderInfo.iBlender[0] = blenderX;
+		m_RenderInfo.iBlender[1] = blenderY;
+
+		m_Runner.Run(name, numBones, 0, [&](std::uint64_t uiIterations)
+			{
+				for (std::uint64_t i = 0; i < uiIterations; ++i)
+				{
+					m_RenderInfo.flFrame = GetFrame(i, flMaxFrame);
+					m_Renderer->SetUpBones();
+					DoNotOptimize(m_Renderer->GetBoneTransforms());
+				}
+			});
+
+		m_RenderInfo.iBlender[0] = m_RenderInfo.iBlender[1] = 0;
+	}
+
+	/**
+	*	@brief Decodes all bones in the first blend of a sequence, as SetUpBones does for sequences without blending
+	*/
+	void CalcRotations(glm::vec3* pos, glm::vec4* q, const mstudioseqdesc_t* pSequence, const mstudioanim_t* panim, const float flFrame)
+	{
+		const byte blenders[STUDIO_MAX_BLENDERS] = {};
+
+		const auto sequence = studiomdl::GetBlendedSequence(m_Model->GetStudioHeader(), pSequence, panim, flFrame,
+			blenders, m_RenderInfo.iController, m_RenderInfo.iMouth);
+
+		studiomdl::CalcBlendedBones(sequence, pos, q);
+	}
+
+private:
+	CBenchmarkRunner& m_Runner;
+	const BenchmarkAsset& m_Asset;
+
+	std::unique_ptr<studiomdl::CStudioModel> m_Model;
+
+	CMockRenderContext m_RenderContext;
+	std::unique_ptr<studiomdl::CStudioModelRenderer> m_Renderer;
+
+	studiomdl::CModelRenderInfo m_RenderInfo;
+
+	glm::vec3 m_Positions1[MAXSTUDIOBONES];
+	glm::vec4 m_Quaternions1[MAXSTUDIOBONES];
+	glm::vec3 m_Positions2[MAXSTUDIOBONES];
+	glm::vec4 m_Quaternions2[MAXSTUDIOBONES];
+
+	glm::mat3x4 m_Local[MAXSTUDIOBONES];
+	glm::mat3x4 m_LocalReference[MAXSTUDIOBONES];
+	glm::mat3x4 m_Transforms[MAXSTUDIOBONES];
+	glm::mat3x4 m_TransformsReference[MAXSTUDIOBONES];
+
+private:
+	CStudioModelRendererBenchmarks(const CStudioModelRendererBenchmarks&) = delete;
+	CStudioModelRendererBenchmarks& operator=(const CStudioModelRendererBenchmarks&) = delete;
+};
+
+void RunStudioModelRendererBenchmarks(CBenchmarkRunner& runner, const BenchmarkAssets& assets)
+{
+	for (const auto& asset : assets.Models)
+	{
+		std::unique_ptr<studiomdl::CStudioModel> model;
+
+		try
+		{
+			model = LoadBenchmarkModel(asset.FileName);
+		}
+		catch (const studiomdl::StudioModelException& e)
+		{
+			Error("Couldn't load model \"%s\": %s\n", asset.FileName.u8string().c_str(), e.what());
+			continue;
+		}
+
+		auto benchmarks = std::make_unique<CStudioModelRendererBenchmarks>(runner, asset, std::move(model));
+
+		benchmarks->Run();
+	}
+}
+}
@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#include "Logging.h"
+
+#include "CProfiler.h"
+
+namespace profiler
+{
+thread_local unsigned int CScopedTimer::m_Depth = 0;
+thread_local std::uint64_t CScopedTimer::m_ChildTimes[MAX_ZONE_DEPTH];
+
+namespace
+{
+void WriteJSONString(std::ofstream& stream, const char* pszString)
+{
+	stream << '"';
+
+	for (; *pszString; ++pszString)
+	{
+		const char c = *pszString;
+
+		if (c == '"' || c == '\\')
+		{
+			stream << '\\' << c;
+		}
+		else if (static_cast<unsigned char>(c) < ' ')
+		{
+			stream << ' ';
+		}
+		else
+		{
+			stream << c;
+		}
+	}
+
+	stream << '"';
+}
+}
+
+CProfiler& Profiler()
+{
+	static CProfiler profiler;
+
+	return profiler;
+}
+
+std::uint64_t CProfiler::GetTimestamp()
+{
+	return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void CProfiler::SetHistoryEnabled(const bool bEnabled)
+{
+	m_bHistoryEnabled.store(bEnabled, std::memory_order_relaxed);
+
+	if (!bEnabled)
+	{
+		m_NextFrame = 0;
+		m_FrameCount = 0;
+	}
+
+	UpdateActive();
+}
+
+bool CProfiler::StartCapture(unsigned int uiFrameCount, const std::filesystem::path& fileName)
+{
+	if (m_bCapturing)
+	{
+		Warning("A profiler capture is already in progress\n");
+		return false;
+	}
+
+	m_bCapturing = true;
+	m_bCaptureStarted = false;
+	m_uiCaptureFramesLeft = std::clamp(uiFrameCount, 1u, MAX_CAPTURE_FRAMES);
+	m_CaptureFileName = fileName;
+
+	{
+		std::lock_guard<std::mutex> lock(m_CaptureMutex);
+		m_CapturedZones.clear();
+	}
+
+	UpdateActive();
+
+	return true;
+}
+
+void CProfiler::BeginFrame()
+{
+	m_FrameThreadId.store(std::this_thread::get_id(), std::memory_order_relaxed);
+
+	if (m_bCapturing && !m_bCaptureStarted)
+	{
+		//Drop anything recorded between the request and the first frame
+		std::lock_guard<std::mutex> lock(m_CaptureMutex);
+		m_CapturedZones.clear();
+		m_bCaptureStarted = true;
+	}
+
+	m_bTimingFrame = IsActive();
+
+	if (!m_bTimingFrame)
+	{
+		return;
+	}
+
+	std::fill(m_CurrentSelfTimes.begin(), m_CurrentSelfTimes.end(), 0);
+
+	m_FrameStart = GetTimestamp();
+}
+
+void CProfiler::EndFrame()
+{
+	if (!m_bTimingFrame)
+	{
+		return;
+	}
+
+	m_bTimingFrame = false;
+
+	const std::uint64_t end = GetTimestamp();
+
+	//The history may have been disabled during the frame
+	if (IsHistoryEnabled())
+	{
+		auto& frame = m_Frames[m_NextFrame];
+
+		frame.Duration = end - m_FrameStart;
+		frame.ZoneSelfTimes.assign(m_CurrentSelfTimes.begin(), m_CurrentSelfTimes.end());
+
+		m_NextFrame = (m_NextFrame + 1) % FRAME_HISTORY_SIZE;
+		m_FrameCount = std::min(m_FrameCount + 1, FRAME_HISTORY_SIZE);
+	}
+
+	if (m_bCapturing && m_bCaptureStarted)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_CaptureMutex);
+			m_CapturedZones.push_back({"Frame", m_FrameStart, end, std::this_thread::get_id()});
+		}
+
+		if (--m_uiCaptureFramesLeft == 0)
+		{
+			WriteCapture();
+
+			m_bCapturing = false;
+			UpdateActive();
+		}
+	}
+}
+
+void CProfiler::RecordZone(const char* pszName, std::uint64_t start, std::uint64_t end, std::uint64_t selfTime)
+{
+	if (m_bCapturing)
+	{
+		std::lock_guard<std::mutex> lock(m_CaptureMutex);
+		m_CapturedZones.push_back({pszName, start, end, std::this_thread::get_id()});
+	}
+
+	if (IsHistoryEnabled() && std::this_thread::get_id() == m_FrameThreadId.load(std::memory_order_relaxed))
+	{
+		m_CurrentSelfTimes[GetZoneId(pszName)] += selfTime;
+	}
+}
+
+void CProfiler::UpdateActive()
+{
+	m_bActive.store(IsHistoryEnabled() || IsCapturing(), std::memory_order_relaxed);
+}
+
+std::size_t CProfiler::GetZoneId(const char* pszName)
+{
+	//Names are usually literals, so the pointer comparison almost always succeeds
+	for (std::size_t zone = 0; zone < m_ZoneNames.size(); ++zone)
+	{
+		if (m_ZoneNames[zone] == pszName || !strcmp(m_ZoneNames[zone], pszName))
+		{
+			return zone;
+		}
+	}
+
+	m_ZoneNames.push_back(pszName);
+	m_CurrentSelfTimes.push_back(0);
+
+	return m_ZoneNames.size() - 1;
+}
+
+void CProfiler::WriteCapture()
+{
+	std::vector<CapturedZone> zones;
+
+	{
+		std::lock_guard<std::mutex> lock(m_CaptureMutex);
+		zones.swap(m_CapturedZones);
+	}
+
+	std::ofstream stream(m_CaptureFileName, std::ios::out | std::ios::trunc);
+
+	if (!stream)
+	{
+		Error("Couldn't open profiler capture file \"%s\" for writing\n", m_CaptureFileName.u8string().c_str());
+		return;
+	}
+
+	//Chrome wants parents before children when timestamps are equal
+	std::stable_sort(zones.begin(), zones.end(), [](const auto& lhs, const auto& rhs)
+		{
+			return lhs.Start < rhs.Start || (lhs.Start == rhs.Start && lhs.End > rhs.End);
+		});
+
+	const std::uint64_t origin = zones.empty() ? 0 : zones.front().Start;
+
+	std::unordered_map<std::thread::id, unsigned int> threadIds;
+
+	stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	stream.setf(std::ios::fixed);
+	stream.precision(3);
+
+	bool bFirst = true;
+
+	for (const auto& zone : zones)
+	{
+		const auto threadId = threadIds.emplace(zone.ThreadId, static_cast<unsigned int>(threadIds.size())).first->second;
+
+		stream << (bFirst ? "\n" : ",\n");
+		bFirst = false;
+
+		stream << "{\"name\":";
+		WriteJSONString(stream, zone.Name);
+		stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadId
+			<< ",\"ts\":" << ((zone.Start - origin) / 1000.0)
+			<< ",\"dur\":" << ((zone.End - zone.Start) / 1000.0) << '}';
+	}
+
+	stream << "\n]}\n";
+
+	if (!stream)
+	{
+		Error("Error writing profiler capture file \"%s\"\n", m_CaptureFileName.u8string().c_str());
+		return;
+	}
+
+	Message("Wrote %u profiler zones to \"%s\"\n", static_cast<unsigned int>(zones.size()), m_CaptureFileName.u8string().c_str());
+}
+}
@@ -0,0 +1,238 @@
+#ifndef COMMON_CPROFILER_H
+#define COMMON_CPROFILER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+*	@defgroup Profiler Frame profiler
+*
+*	Scoped timers that feed a rolling per-frame history and optional Chrome trace captures.
+*	When neither the history nor a capture is active a timer costs a single atomic load.
+*
+*	@{
+*/
+
+namespace profiler
+{
+/**
+*	Number of frames kept in the rolling history.
+*/
+const std::size_t FRAME_HISTORY_SIZE = 128;
+
+/**
+*	Maximum nesting depth of timers on a single thread. Deeper timers are ignored.
+*/
+const unsigned int MAX_ZONE_DEPTH = 32;
+
+/**
+*	Maximum number of frames that can be captured at once.
+*/
+const unsigned int MAX_CAPTURE_FRAMES = 10000;
+
+/**
+*	@brief Time spent in a single frame, in nanoseconds
+*/
+struct FrameRecord
+{
+	std::uint64_t Duration = 0;
+
+	/**
+	*	Time spent in each zone excluding time spent in nested zones, indexed by zone id.
+	*	Only covers zones timed on the thread that runs frames.
+	*/
+	std::vector<std::uint64_t> ZoneSelfTimes;
+};
+
+/**
+*	@brief Collects timings from scoped timers
+*	Frames are delimited by BeginFrame and EndFrame, which must be called from the same thread.
+*	The history is only updated by timers on that thread; captures include timers on all threads.
+*/
+class CProfiler final
+{
+public:
+	CProfiler() = default;
+	~CProfiler() = default;
+
+	/**
+	*	@brief Gets the current time in nanoseconds, relative to an arbitrary fixed point
+	*/
+	static std::uint64_t GetTimestamp();
+
+	/**
+	*	@brief Whether timers should record anything
+	*/
+	bool IsActive() const { return m_bActive.load(std::memory_order_relaxed); }
+
+	bool IsHistoryEnabled() const { return m_bHistoryEnabled.load(std::memory_order_relaxed); }
+
+	/**
+	*	@brief Enables or disables the rolling history. Disabling it clears the history
+	*/
+	void SetHistoryEnabled(const bool bEnabled);
+
+	bool IsCapturing() const { return m_bCapturing.load(std::memory_order_relaxed); }
+
+	/**
+	*	@brief Starts capturing the given number of frames
+	*	The capture begins with the next frame. When the last frame ends it is written as a Chrome trace (chrome://tracing, Perfetto).
+	*	@return Whether the capture was started. Fails if a capture is already in progress
+	*/
+	bool StartCapture(unsigned int uiFrameCount, const std::filesystem::path& fileName);
+
+	void BeginFrame();
+
+	void EndFrame();
+
+	/**
+	*	@brief Records a finished timer. Called by CScopedTimer
+	*	@param pszName Name of the timer. Must remain valid for the lifetime of the program
+	*	@param start Start timestamp
+	*	@param end End timestamp
+	*	@param selfTime Time not spent in nested timers
+	*/
+	void RecordZone(const char* pszName, std::uint64_t start, std::uint64_t end, std::uint64_t selfTime);
+
+	/**
+	*	@brief Number of distinct zones seen by the history
+	*/
+	std::size_t GetZoneCount() const { return m_ZoneNames.size(); }
+
+	const char* GetZoneName(const std::size_t zone) const { return m_ZoneNames[zone]; }
+
+	/**
+	*	@brief Number of frames in the history
+	*/
+	std::size_t GetFrameCount() const { return m_FrameCount; }
+
+	/**
+	*	@brief Gets a frame from the history. 0 is the oldest frame
+	*/
+	const FrameRecord& GetFrame(const std::size_t index) const
+	{
+		return m_Frames[(m_NextFrame + FRAME_HISTORY_SIZE - m_FrameCount + index) % FRAME_HISTORY_SIZE];
+	}
+
+private:
+	struct CapturedZone
+	{
+		const char* Name;
+		std::uint64_t Start;
+		std::uint64_t End;
+		std::thread::id ThreadId;
+	};
+
+	void UpdateActive();
+
+	std::size_t GetZoneId(const char* pszName);
+
+	void WriteCapture();
+
+private:
+	std::atomic<bool> m_bActive{false};
+
+	/**
+	*	Read by timers on any thread, so these are atomic.
+	*/
+	std::atomic<bool> m_bHistoryEnabled{false};
+	std::atomic<std::thread::id> m_FrameThreadId;
+
+	/**
+	*	Whether the frame in progress is being timed. Activating the profiler mid-frame only takes effect on the next frame.
+	*/
+	bool m_bTimingFrame = false;
+	std::uint64_t m_FrameStart = 0;
+
+	std::vector<const char*> m_ZoneNames;
+
+	/**
+	*	Self times of the frame in progress.
+	*/
+	std::vector<std::uint64_t> m_CurrentSelfTimes;
+
+	std::array<FrameRecord, FRAME_HISTORY_SIZE> m_Frames;
+	std::size_t m_NextFrame = 0;
+	std::size_t m_FrameCount = 0;
+
+	std::atomic<bool> m_bCapturing{false};
+	bool m_bCaptureStarted = false;
+	unsigned int m_uiCaptureFramesLeft = 0;
+	std::filesystem::path m_CaptureFileName;
+
+	std::mutex m_CaptureMutex;
+	std::vector<CapturedZone> m_CapturedZones;
+
+private:
+	CProfiler(const CProfiler&) = delete;
+	CProfiler& operator=(const CProfiler&) = delete;
+};
+
+CProfiler& Profiler();
+
+/**
+*	@brief Times the scope it is declared in. Use through the PROFILE_SCOPE macro
+*/
+class CScopedTimer final
+{
+public:
+	explicit CScopedTimer(const char* const pszName)
+	{
+		if (Profiler().IsActive() && m_Depth < MAX_ZONE_DEPTH)
+		{
+			m_pszName = pszName;
+			m_uiDepth = m_Depth++;
+			m_ChildTimes[m_uiDepth] = 0;
+			m_Start = CProfiler::GetTimestamp();
+		}
+	}
+
+	~CScopedTimer()
+	{
+		if (m_pszName)
+		{
+			const std::uint64_t end = CProfiler::GetTimestamp();
+			const std::uint64_t duration = end - m_Start;
+
+			--m_Depth;
+
+			if (m_uiDepth > 0)
+			{
+				m_ChildTimes[m_uiDepth - 1] += duration;
+			}
+
+			Profiler().RecordZone(m_pszName, m_Start, end, duration - m_ChildTimes[m_uiDepth]);
+		}
+	}
+
+private:
+	const char* m_pszName = nullptr;
+	unsigned int m_uiDepth = 0;
+	std::uint64_t m_Start = 0;
+
+	static thread_local unsigned int m_Depth;
+	static thread_local std::uint64_t m_ChildTimes[MAX_ZONE_DEPTH];
+
+private:
+	CScopedTimer(const CScopedTimer&) = delete;
+	CScopedTimer& operator=(const CScopedTimer&) = delete;
+};
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+/**
+*	Times the enclosing scope under the given name. The name must be a string literal.
+*/
+#define PROFILE_SCOPE(name) const profiler::CScopedTimer PROFILE_CONCAT(profileTimer, __LINE__)(name)
+
+/** @} */
+
+#endif //COMMON_CPROFILER_H
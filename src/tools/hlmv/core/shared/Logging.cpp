@@ -53,10 +53,21 @@ public:
 	}
 };
 
+class CStdErrLogListener final : public ILogListener
+{
+public:
+	void LogMessage( const LogType type, const char* const pszMessage ) override final
+	{
+		fprintf( stderr, "%s%s", GetLogTypePrefix( type ), pszMessage );
+	}
+};
+
 static CNullLogListener g_NullLogListener;
 
 static CStdOutLogListener g_StdOutListener;
 
+static CStdErrLogListener g_StdErrListener;
+
 static ILogListener* m_pDefaultLogListener = &g_NullLogListener;
 
 static CLogging g_Logging;
@@ -72,6 +83,11 @@ ILogListener* GetStdOutLogListener()
 	return &g_StdOutListener;
 }
 
+ILogListener* GetStdErrLogListener()
+{
+	return &g_StdErrListener;
+}
+
 ILogListener* GetDefaultLogListener()
 {
 	return m_pDefaultLogListener;
@@ -72,6 +72,11 @@ ILogListener* GetNullLogListener();
 */
 ILogListener* GetStdOutLogListener();
 
+/**
+*	Gets the listener that outputs to stderr. Used by tools that write their results to stdout.
+*/
+ILogListener* GetStdErrLogListener();
+
 /**
 *	Gets the default log listener. If there is a way to log anything, this will provide a means to do so.
 *	Must be installed by the application itself.
@@ -1,5 +1,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "core/shared/Logging.h"
+
 #include "CBaseRenderContext.h"
 
 namespace renderer
@@ -48,4 +50,159 @@ void CBaseRenderContext::Ortho( vec_t flLeft, vec_t flRight, vec_t flBottom, vec
 {
 	MultMatrix( glm::ortho( flLeft, flRight, flBottom, flTop, flNear, flFar ) );
 }
-}
\ No newline at end of file
+
+void CBaseRenderContext::SetCullFace( const CullFace cullFace )
+{
+	if( ShouldApply( m_CullFace, cullFace ) )
+		ApplyCullFace( cullFace );
+}
+
+void CBaseRenderContext::Enable( const Capability capability )
+{
+	SetCapability( capability, true );
+}
+
+void CBaseRenderContext::Disable( const Capability capability )
+{
+	SetCapability( capability, false );
+}
+
+void CBaseRenderContext::SetBlendFunc( const BlendFactor src, const BlendFactor dst )
+{
+	if( ShouldApply( m_BlendFunc, { src, dst } ) )
+		ApplyBlendFunc( src, dst );
+}
+
+bool CBaseRenderContext::GetDepthMask() const
+{
+	return m_DepthMask.bValid ? m_DepthMask.Value : QueryDepthMask();
+}
+
+void CBaseRenderContext::SetDepthMask( const bool bWrite )
+{
+	if( ShouldApply( m_DepthMask, bWrite ) )
+		ApplyDepthMask( bWrite );
+}
+
+void CBaseRenderContext::SetDepthFunc( const CompareFunc func )
+{
+	if( ShouldApply( m_DepthFunc, func ) )
+		ApplyDepthFunc( func );
+}
+
+void CBaseRenderContext::SetAlphaFunc( const CompareFunc func, const float flRef )
+{
+	if( ShouldApply( m_AlphaFunc, { func, flRef } ) )
+		ApplyAlphaFunc( func, flRef );
+}
+
+void CBaseRenderContext::SetColor( float flR, float flG, float flB, float flA )
+{
+	const glm::vec4 color{ flR, flG, flB, flA };
+
+	if( ShouldApply( m_Color, color ) )
+		ApplyColor( color );
+}
+
+void CBaseRenderContext::SetPolygonMode( const PolygonMode mode )
+{
+	if( ShouldApply( m_PolygonMode, mode ) )
+		ApplyPolygonMode( mode );
+}
+
+void CBaseRenderContext::SetShadeModel( const ShadeModel model )
+{
+	if( ShouldApply( m_ShadeModel, model ) )
+		ApplyShadeModel( model );
+}
+
+void CBaseRenderContext::SetActiveTextureUnit( const unsigned int uiUnit )
+{
+	if( uiUnit >= MAX_TEXTURE_UNITS )
+	{
+		Error( "CBaseRenderContext::SetActiveTextureUnit: Invalid texture unit \"%u\" specified!\n", uiUnit );
+		return;
+	}
+
+	if( ShouldApply( m_ActiveTextureUnit, uiUnit ) )
+		ApplyActiveTextureUnit( uiUnit );
+}
+
+void CBaseRenderContext::BindTexture( HTexture_t hTexture )
+{
+	//If the active unit isn't known, neither is the unit that the texture ends up bound to.
+	if( !m_ActiveTextureUnit.bValid )
+	{
+		++m_StateChangeStats.uiIssued;
+		ApplyBindTexture( hTexture );
+		return;
+	}
+
+	if( ShouldApply( m_BoundTextures[ m_ActiveTextureUnit.Value ], hTexture ) )
+		ApplyBindTexture( hTexture );
+}
+
+void CBaseRenderContext::InvalidateState()
+{
+	m_CullFace.bValid = false;
+
+	for( auto& capability : m_Capabilities )
+	{
+		capability.bValid = false;
+	}
+
+	m_BlendFunc.bValid = false;
+	m_DepthMask.bValid = false;
+	m_DepthFunc.bValid = false;
+	m_AlphaFunc.bValid = false;
+	m_Color.bValid = false;
+	m_PolygonMode.bValid = false;
+	m_ShadeModel.bValid = false;
+	m_ActiveTextureUnit.bValid = false;
+
+	for( auto& texture : m_BoundTextures )
+	{
+		texture.bValid = false;
+	}
+}
+
+void CBaseRenderContext::ForgetTexture( HTexture_t hTexture )
+{
+	for( auto& texture : m_BoundTextures )
+	{
+		if( texture.Value == hTexture )
+		{
+			texture.bValid = false;
+		}
+	}
+}
+
+template<typename T>
+bool CBaseRenderContext::ShouldApply( ShadowedState<T>& state, const T& value )
+{
+	if( state.bValid && state.Value == value )
+	{
+		++m_StateChangeStats.uiFiltered;
+		return false;
+	}
+
+	state.Value = value;
+	state.bValid = true;
+
+	++m_StateChangeStats.uiIssued;
+
+	return true;
+}
+
+void CBaseRenderContext::SetCapability( const Capability capability, const bool bEnable )
+{
+	if( capability < Capability::BLEND || capability >= Capability::COUNT )
+	{
+		Error( "CBaseRenderContext::SetCapability: Invalid capability \"%d\" specified!\n", capability );
+		return;
+	}
+
+	if( ShouldApply( m_Capabilities[ static_cast<size_t>( capability ) ], bEnable ) )
+		ApplyCapability( capability, bEnable );
+}
+}
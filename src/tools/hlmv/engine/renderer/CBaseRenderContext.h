@@ -1,6 +1,10 @@
 #ifndef ENGINE_RENDERER_CBASERENDERCONTEXT_H
 #define ENGINE_RENDERER_CBASERENDERCONTEXT_H
 
+#include <array>
+
+#include <glm/vec4.hpp>
+
 #include "engine/shared/renderer/IRenderContext.h"
 
 #include "engine/renderer/util/CMatrixStack.h"
@@ -37,6 +41,79 @@ public:
 
 	void Ortho( vec_t flLeft, vec_t flRight, vec_t flBottom, vec_t flTop, vec_t flNear, vec_t flFar ) override;
 
+	//State operations
+	void SetCullFace( const CullFace cullFace ) override;
+
+	void Enable( const Capability capability ) override;
+
+	void Disable( const Capability capability ) override;
+
+	void SetBlendFunc( const BlendFactor src, const BlendFactor dst ) override;
+
+	bool GetDepthMask() const override;
+
+	void SetDepthMask( const bool bWrite ) override;
+
+	void SetDepthFunc( const CompareFunc func ) override;
+
+	void SetAlphaFunc( const CompareFunc func, const float flRef ) override;
+
+	void SetColor( float flR, float flG, float flB, float flA = 1 ) override;
+
+	void SetPolygonMode( const PolygonMode mode ) override;
+
+	void SetShadeModel( const ShadeModel model ) override;
+
+	void SetActiveTextureUnit( const unsigned int uiUnit ) override;
+
+	void BindTexture( HTexture_t hTexture ) override;
+
+	void InvalidateState() override;
+
+	const StateChangeStats& GetStateChangeStats() const override { return m_StateChangeStats; }
+
+	void ResetStateChangeStats() override { m_StateChangeStats = StateChangeStats(); }
+
+protected:
+	//Called when a state change has to be passed on to the graphics API.
+	virtual void ApplyCullFace( const CullFace cullFace ) = 0;
+
+	virtual void ApplyCapability( const Capability capability, const bool bEnable ) = 0;
+
+	virtual void ApplyBlendFunc( const BlendFactor src, const BlendFactor dst ) = 0;
+
+	virtual void ApplyDepthMask( const bool bWrite ) = 0;
+
+	/**
+	*	Gets the depth mask from the graphics API. Used when the shadowed depth mask is not known.
+	*/
+	virtual bool QueryDepthMask() const = 0;
+
+	virtual void ApplyDepthFunc( const CompareFunc func ) = 0;
+
+	virtual void ApplyAlphaFunc( const CompareFunc func, const float flRef ) = 0;
+
+	virtual void ApplyColor( const glm::vec4& color ) = 0;
+
+	virtual void ApplyPolygonMode( const PolygonMode mode ) = 0;
+
+	virtual void ApplyShadeModel( const ShadeModel model ) = 0;
+
+	virtual void ApplyActiveTextureUnit( const unsigned int uiUnit ) = 0;
+
+	virtual void ApplyBindTexture( HTexture_t hTexture ) = 0;
+
+	/**
+	*	Forgets the given texture on every unit it is bound to. Must be called when a texture is destroyed,
+	*	since the graphics API unbinds it and a new texture can get the same handle.
+	*/
+	void ForgetTexture( HTexture_t hTexture );
+
+	/**
+	*	Forgets the current color. Must be called when drawing changed it without going through SetColor.
+	*/
+	void ForgetColor() { m_Color.bValid = false; }
+
 protected:
 	/**
 	*	Gets the matrix stack for use by subclasses.
@@ -55,6 +132,55 @@ private:
 	//Needed for all renderers because our API separates the Model and View matrices.
 	//We need to keep track of them separately so mult operations work in graphics APIs that combine matrices.
 	CMatrixStack m_MatrixStack;
+
+	/**
+	*	A state value as the graphics API last saw it. Invalid if it is not known.
+	*/
+	template<typename T>
+	struct ShadowedState
+	{
+		T Value{};
+		bool bValid = false;
+	};
+
+	struct BlendFunc
+	{
+		BlendFactor Src;
+		BlendFactor Dst;
+
+		bool operator==( const BlendFunc& other ) const { return Src == other.Src && Dst == other.Dst; }
+	};
+
+	struct AlphaFunc
+	{
+		CompareFunc Func;
+		float flRef;
+
+		bool operator==( const AlphaFunc& other ) const { return Func == other.Func && flRef == other.flRef; }
+	};
+
+	/**
+	*	Records a requested change.
+	*	@return Whether the change has to be passed on to the graphics API.
+	*/
+	template<typename T>
+	bool ShouldApply( ShadowedState<T>& state, const T& value );
+
+	void SetCapability( const Capability capability, const bool bEnable );
+
+	ShadowedState<CullFace> m_CullFace;
+	std::array<ShadowedState<bool>, static_cast<size_t>( Capability::COUNT )> m_Capabilities;
+	ShadowedState<BlendFunc> m_BlendFunc;
+	ShadowedState<bool> m_DepthMask;
+	ShadowedState<CompareFunc> m_DepthFunc;
+	ShadowedState<AlphaFunc> m_AlphaFunc;
+	ShadowedState<glm::vec4> m_Color;
+	ShadowedState<PolygonMode> m_PolygonMode;
+	ShadowedState<ShadeModel> m_ShadeModel;
+	ShadowedState<unsigned int> m_ActiveTextureUnit;
+	std::array<ShadowedState<HTexture_t>, MAX_TEXTURE_UNITS> m_BoundTextures;
+
+	StateChangeStats m_StateChangeStats;
 };
 }
 
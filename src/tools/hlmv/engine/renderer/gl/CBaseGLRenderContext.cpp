@@ -64,6 +64,81 @@ GLenum MagFilterToGL( const MagFilter mag )
 	}
 }
 
+GLenum CapabilityToGL( const Capability capability )
+{
+	switch( capability )
+	{
+	case Capability::BLEND:			return GL_BLEND;
+	case Capability::DEPTH_TEST:	return GL_DEPTH_TEST;
+	case Capability::ALPHA_TEST:	return GL_ALPHA_TEST;
+	case Capability::CULL_FACE:		return GL_CULL_FACE;
+	case Capability::TEXTURE_2D:	return GL_TEXTURE_2D;
+
+	default:
+		{
+			Error( "CapabilityToGL: Invalid capability \"%d\"\n", capability );
+			return GL_BLEND;
+		}
+	}
+}
+
+GLenum BlendFactorToGL( const BlendFactor factor )
+{
+	switch( factor )
+	{
+	case BlendFactor::ZERO:					return GL_ZERO;
+	case BlendFactor::ONE:					return GL_ONE;
+	case BlendFactor::SRC_ALPHA:			return GL_SRC_ALPHA;
+	case BlendFactor::ONE_MINUS_SRC_ALPHA:	return GL_ONE_MINUS_SRC_ALPHA;
+
+	default:
+		{
+			Error( "BlendFactorToGL: Invalid blend factor \"%d\"\n", factor );
+			return GL_ONE;
+		}
+	}
+}
+
+GLenum CompareFuncToGL( const CompareFunc func )
+{
+	switch( func )
+	{
+	case CompareFunc::NEVER:	return GL_NEVER;
+	case CompareFunc::LESS:		return GL_LESS;
+	case CompareFunc::EQUAL:	return GL_EQUAL;
+	case CompareFunc::LEQUAL:	return GL_LEQUAL;
+	case CompareFunc::GREATER:	return GL_GREATER;
+	case CompareFunc::NOTEQUAL:	return GL_NOTEQUAL;
+	case CompareFunc::GEQUAL:	return GL_GEQUAL;
+	case CompareFunc::ALWAYS:	return GL_ALWAYS;
+
+	default:
+		{
+			Error( "CompareFuncToGL: Invalid compare function \"%d\"\n", func );
+			return GL_ALWAYS;
+		}
+	}
+}
+
+GLenum PrimitiveTypeToGL( const PrimitiveType type )
+{
+	switch( type )
+	{
+	case PrimitiveType::POINTS:			return GL_POINTS;
+	case PrimitiveType::LINES:			return GL_LINES;
+	case PrimitiveType::TRIANGLES:		return GL_TRIANGLES;
+	case PrimitiveType::TRIANGLE_STRIP:	return GL_TRIANGLE_STRIP;
+	case PrimitiveType::TRIANGLE_FAN:	return GL_TRIANGLE_FAN;
+	case PrimitiveType::QUAD_STRIP:		return GL_QUAD_STRIP;
+
+	default:
+		{
+			Error( "PrimitiveTypeToGL: Invalid primitive type \"%d\"\n", type );
+			return GL_POINTS;
+		}
+	}
+}
+
 void CBaseGLRenderContext::Viewport( int iX, int iY, int iWidth, int iHeight )
 {
 	glViewport( iX, iY, iWidth, iHeight );
@@ -105,7 +180,7 @@ void CBaseGLRenderContext::Clear( const ClearBits_t bits )
 	glClear( mask );
 }
 
-void CBaseGLRenderContext::SetCullFace( const CullFace cullFace )
+void CBaseGLRenderContext::ApplyCullFace( const CullFace cullFace )
 {
 	GLenum mode;
 
@@ -131,7 +206,7 @@ void CBaseGLRenderContext::SetCullFace( const CullFace cullFace )
 
 	default:
 		{
-			Error( "CBaseGLRenderContext::SetCullFace: Invalid mode \"%d\" specified!\n", cullFace );
+			Error( "CBaseGLRenderContext::ApplyCullFace: Invalid mode \"%d\" specified!\n", cullFace );
 			return;
 		}
 	}
@@ -170,7 +245,7 @@ HTexture_t CBaseGLRenderContext::CreateTexture( const int mipmaps, const ImageFo
 
 	glGenTextures( 1, &texture );
 
-	glBindTexture( GL_TEXTURE_2D, texture );
+	BindTexture( GLToTexHandle( texture ) );
 
 	//Set pack alignment to 1 so images will load correctly if rows are not multiple of 4
 	GLint oldUnpackAlignment;
@@ -200,11 +275,8 @@ void CBaseGLRenderContext::DestroyTexture( HTexture_t hTexture )
 	GLuint tex = TexHandleToGL( hTexture );
 
 	glDeleteTextures( 1, &tex );
-}
 
-void CBaseGLRenderContext::BindTexture( HTexture_t hTexture )
-{
-	glBindTexture( GL_TEXTURE_2D, TexHandleToGL( hTexture ) );
+	ForgetTexture( hTexture );
 }
 
 void CBaseGLRenderContext::SetMinMagFilters( const MinFilter min, const MagFilter mag )
@@ -212,4 +284,66 @@ void CBaseGLRenderContext::SetMinMagFilters( const MinFilter min, const MagFilte
 	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, MinFilterToGL( min ) );
 	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, MagFilterToGL( mag ) );
 }
-}
\ No newline at end of file
+
+void CBaseGLRenderContext::ApplyCapability( const Capability capability, const bool bEnable )
+{
+	if( bEnable )
+		glEnable( CapabilityToGL( capability ) );
+	else
+		glDisable( CapabilityToGL( capability ) );
+}
+
+void CBaseGLRenderContext::ApplyBlendFunc( const BlendFactor src, const BlendFactor dst )
+{
+	glBlendFunc( BlendFactorToGL( src ), BlendFactorToGL( dst ) );
+}
+
+void CBaseGLRenderContext::ApplyDepthMask( const bool bWrite )
+{
+	glDepthMask( bWrite ? GL_TRUE : GL_FALSE );
+}
+
+bool CBaseGLRenderContext::QueryDepthMask() const
+{
+	GLboolean depthMask;
+
+	glGetBooleanv( GL_DEPTH_WRITEMASK, &depthMask );
+
+	return depthMask != GL_FALSE;
+}
+
+void CBaseGLRenderContext::ApplyDepthFunc( const CompareFunc func )
+{
+	glDepthFunc( CompareFuncToGL( func ) );
+}
+
+void CBaseGLRenderContext::ApplyAlphaFunc( const CompareFunc func, const float flRef )
+{
+	glAlphaFunc( CompareFuncToGL( func ), flRef );
+}
+
+void CBaseGLRenderContext::ApplyColor( const glm::vec4& color )
+{
+	glColor4f( color.r, color.g, color.b, color.a );
+}
+
+void CBaseGLRenderContext::ApplyPolygonMode( const PolygonMode mode )
+{
+	glPolygonMode( GL_FRONT_AND_BACK, mode == PolygonMode::LINE ? GL_LINE : GL_FILL );
+}
+
+void CBaseGLRenderContext::ApplyShadeModel( const ShadeModel model )
+{
+	glShadeModel( model == ShadeModel::FLAT ? GL_FLAT : GL_SMOOTH );
+}
+
+void CBaseGLRenderContext::ApplyActiveTextureUnit( const unsigned int uiUnit )
+{
+	glActiveTexture( GL_TEXTURE0 + uiUnit );
+}
+
+void CBaseGLRenderContext::ApplyBindTexture( HTexture_t hTexture )
+{
+	glBindTexture( GL_TEXTURE_2D, TexHandleToGL( hTexture ) );
+}
+}
@@ -23,6 +23,14 @@ GLenum MinFilterToGL( const MinFilter min );
 
 GLenum MagFilterToGL( const MagFilter mag );
 
+GLenum CapabilityToGL( const Capability capability );
+
+GLenum BlendFactorToGL( const BlendFactor factor );
+
+GLenum CompareFuncToGL( const CompareFunc func );
+
+GLenum PrimitiveTypeToGL( const PrimitiveType type );
+
 class CBaseGLRenderContext : public CBaseRenderContext
 {
 public:
@@ -39,8 +47,6 @@ public:
 
 	void Clear( const ClearBits_t bits ) override;
 
-	void SetCullFace( const CullFace cullFace ) override;
-
 	ReadBuffer GetReadBuffer() const override;
 
 	void SetReadBuffer( const ReadBuffer buffer ) override;
@@ -51,10 +57,33 @@ public:
 
 	void DestroyTexture( HTexture_t hTexture ) override;
 
-	void BindTexture( HTexture_t hTexture ) override;
-
 	void SetMinMagFilters( const MinFilter min, const MagFilter mag ) override;
 
+protected:
+	void ApplyCullFace( const CullFace cullFace ) override;
+
+	void ApplyCapability( const Capability capability, const bool bEnable ) override;
+
+	void ApplyBlendFunc( const BlendFactor src, const BlendFactor dst ) override;
+
+	void ApplyDepthMask( const bool bWrite ) override;
+
+	bool QueryDepthMask() const override;
+
+	void ApplyDepthFunc( const CompareFunc func ) override;
+
+	void ApplyAlphaFunc( const CompareFunc func, const float flRef ) override;
+
+	void ApplyColor( const glm::vec4& color ) override;
+
+	void ApplyPolygonMode( const PolygonMode mode ) override;
+
+	void ApplyShadeModel( const ShadeModel model ) override;
+
+	void ApplyActiveTextureUnit( const unsigned int uiUnit ) override;
+
+	void ApplyBindTexture( HTexture_t hTexture ) override;
+
 private:
 };
 }
@@ -1,5 +1,6 @@
-#include <glm/gtc/type_ptr.hpp>
+#include <glm/matrix.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
 
 #include "core/shared/Logging.h"
 
@@ -128,18 +129,26 @@ void CRenderContextIMode::MultMatrix( const Mat4x4& mat )
 
 	const auto mode = GetMatrixMode();
 
-	//Model and View need to be combined.
+	//Model and View are combined as Model * View, and OpenGL's matrix may hold transforms made outside the context.
+	//Multiply it by whatever turns the old combined matrix into the new one instead of replacing it.
 	if( mode == MatrixMode::MODEL )
 	{
-		Mat4x4 newMat = GetMatrixStack().GetMatrix( MatrixMode::MODEL ) * mat * GetMatrixStack().GetMatrix( MatrixMode::VIEW );
+		const auto& view = GetMatrixStack().GetMatrix( MatrixMode::VIEW );
+
+		if( view == Mat4x4{ 1.0f } )
+		{
+			glMultMatrixf( glm::value_ptr( mat ) );
+		}
+		else
+		{
+			Mat4x4 newMat = glm::inverse( view ) * mat * view;
 
-		glMultMatrixf( glm::value_ptr( newMat ) );
+			glMultMatrixf( glm::value_ptr( newMat ) );
+		}
 	}
 	else if( mode == MatrixMode::VIEW )
 	{
-		Mat4x4 newMat = GetMatrixStack().GetMatrix( MatrixMode::MODEL ) * GetMatrixStack().GetMatrix( MatrixMode::VIEW ) * mat;
-
-		glMultMatrixf( glm::value_ptr( newMat ) );
+		glMultMatrixf( glm::value_ptr( mat ) );
 	}
 	else
 	{
@@ -157,18 +166,26 @@ void CRenderContextIMode::MultTransposeMatrix( const Mat4x4& mat )
 	//Transposing here and handling it like a regular matrix will have the same effect.
 	Mat4x4 transMat = glm::transpose( mat );
 
-	//Model and View need to be combined.
+	//Model and View are combined as Model * View, and OpenGL's matrix may hold transforms made outside the context.
+	//Multiply it by whatever turns the old combined matrix into the new one instead of replacing it.
 	if( mode == MatrixMode::MODEL )
 	{
-		Mat4x4 newMat = GetMatrixStack().GetMatrix( MatrixMode::MODEL ) * transMat * GetMatrixStack().GetMatrix( MatrixMode::VIEW );
+		const auto& view = GetMatrixStack().GetMatrix( MatrixMode::VIEW );
+
+		if( view == Mat4x4{ 1.0f } )
+		{
+			glMultMatrixf( glm::value_ptr( transMat ) );
+		}
+		else
+		{
+			Mat4x4 newMat = glm::inverse( view ) * transMat * view;
 
-		glMultMatrixf( glm::value_ptr( newMat ) );
+			glMultMatrixf( glm::value_ptr( newMat ) );
+		}
 	}
 	else if( mode == MatrixMode::VIEW )
 	{
-		Mat4x4 newMat = GetMatrixStack().GetMatrix( MatrixMode::MODEL ) * GetMatrixStack().GetMatrix( MatrixMode::VIEW ) * transMat;
-
-		glMultMatrixf( glm::value_ptr( newMat ) );
+		glMultMatrixf( glm::value_ptr( transMat ) );
 	}
 	else
 	{
@@ -176,4 +193,33 @@ void CRenderContextIMode::MultTransposeMatrix( const Mat4x4& mat )
 		glMultMatrixf( glm::value_ptr( transMat ) );
 	}
 }
+
+void CRenderContextIMode::DrawVertices( const PrimitiveType type, const Vertex* pVertices, const size_t uiCount )
+{
+	glBegin( PrimitiveTypeToGL( type ) );
+
+	for( size_t i = 0; i < uiCount; ++i )
+	{
+		glTexCoord2fv( glm::value_ptr( pVertices[ i ].TexCoord ) );
+		glColor4fv( glm::value_ptr( pVertices[ i ].Color ) );
+		glVertex3fv( glm::value_ptr( pVertices[ i ].Position ) );
+	}
+
+	glEnd();
+
+	ForgetColor();
+}
+
+void CRenderContextIMode::DrawPositions( const PrimitiveType type, const glm::vec3* pPositions, const unsigned short* pIndices, const size_t uiCount )
+{
+	glEnableClientState( GL_VERTEX_ARRAY );
+	glVertexPointer( 3, GL_FLOAT, 0, pPositions );
+
+	if( pIndices )
+		glDrawElements( PrimitiveTypeToGL( type ), static_cast<GLsizei>( uiCount ), GL_UNSIGNED_SHORT, pIndices );
+	else
+		glDrawArrays( PrimitiveTypeToGL( type ), 0, static_cast<GLsizei>( uiCount ) );
+
+	glDisableClientState( GL_VERTEX_ARRAY );
+}
 }
\ No newline at end of file
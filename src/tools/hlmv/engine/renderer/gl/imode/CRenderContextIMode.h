@@ -31,6 +31,13 @@ public:
 	void MultMatrix( const Mat4x4& mat ) override;
 
 	void MultTransposeMatrix( const Mat4x4& mat ) override;
+
+	void DrawVertices( const PrimitiveType type, const Vertex* pVertices, const size_t uiCount ) override;
+
+	void DrawPositions( const PrimitiveType type, const glm::vec3* pPositions, const unsigned short* pIndices, const size_t uiCount ) override;
+
+	//Draws immediately, so there is nothing to flush.
+	void Flush() override {}
 };
 }
 
@@ -0,0 +1,759 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include "core/shared/Logging.h"
+
+#include "CRenderContextVBO.h"
+
+namespace renderer
+{
+namespace
+{
+enum VertexAttribute : GLuint
+{
+	ATTRIB_POSITION = 0,
+	ATTRIB_TEXCOORD,
+	ATTRIB_COLOR
+};
+
+//The shaders are compiled as GLSL 1.20 in compatibility profile contexts and as GLSL 1.50 in core profile contexts.
+const char VERTEX_SHADER[] =
+R"(
+#if __VERSION__ >= 130
+#define ATTRIBUTE in
+#define VARYING out
+#else
+#define ATTRIBUTE attribute
+#define VARYING varying
+#endif
+
+uniform mat4 u_ModelView;
+uniform mat4 u_Projection;
+
+ATTRIBUTE vec3 a_Position;
+ATTRIBUTE vec2 a_TexCoord;
+ATTRIBUTE vec4 a_Color;
+
+VARYING vec2 v_TexCoord;
+VARYING vec4 v_Color;
+
+void main()
+{
+	vec4 eyePosition = u_ModelView * vec4( a_Position, 1.0 );
+
+#if __VERSION__ < 130
+	//Lets the fixed function user clip planes clip this.
+	gl_ClipVertex = eyePosition;
+#endif
+
+	gl_Position = u_Projection * eyePosition;
+
+	v_TexCoord = a_TexCoord;
+	v_Color = a_Color;
+}
+)";
+
+//Textures are modulated with the vertex color, like GL_MODULATE does.
+//u_AlphaFunc is a CompareFunc value. It is ALWAYS if alpha testing is disabled.
+const char FRAGMENT_SHADER[] =
+R"(
+#if __VERSION__ >= 130
+#define VARYING in
+#define TEXTURE2D texture
+out vec4 o_FragColor;
+#else
+#define VARYING varying
+#define TEXTURE2D texture2D
+#define o_FragColor gl_FragColor
+#endif
+
+uniform sampler2D u_Texture;
+uniform bool u_Textured;
+uniform int u_AlphaFunc;
+uniform float u_AlphaRef;
+
+VARYING vec2 v_TexCoord;
+VARYING vec4 v_Color;
+
+bool AlphaTest( float alpha )
+{
+	if( u_AlphaFunc == 0 ) return false;
+	if( u_AlphaFunc == 1 ) return alpha < u_AlphaRef;
+	if( u_AlphaFunc == 2 ) return alpha == u_AlphaRef;
+	if( u_AlphaFunc == 3 ) return alpha <= u_AlphaRef;
+	if( u_AlphaFunc == 4 ) return alpha > u_AlphaRef;
+	if( u_AlphaFunc == 5 ) return alpha != u_AlphaRef;
+	if( u_AlphaFunc == 6 ) return alpha >= u_AlphaRef;
+	return true;
+}
+
+void main()
+{
+	vec4 color = v_Color;
+
+	if( u_Textured )
+		color *= TEXTURE2D( u_Texture, v_TexCoord );
+
+	if( !AlphaTest( color.a ) )
+		discard;
+
+	o_FragColor = color;
+}
+)";
+
+static_assert( static_cast<int>( CompareFunc::NEVER ) == 0 && static_cast<int>( CompareFunc::ALWAYS ) == 7, "Update the alpha test in the fragment shader" );
+
+GLuint CompileShader( const GLenum type, const char* const pszVersion, const char* const pszSource )
+{
+	const GLuint shader = glCreateShader( type );
+
+	const char* const sources[] = { pszVersion, pszSource };
+
+	glShaderSource( shader, 2, sources, nullptr );
+	glCompileShader( shader );
+
+	GLint status = GL_FALSE;
+
+	glGetShaderiv( shader, GL_COMPILE_STATUS, &status );
+
+	if( status == GL_FALSE )
+	{
+		char szLog[ 1024 ] = {};
+
+		glGetShaderInfoLog( shader, sizeof( szLog ), nullptr, szLog );
+
+		Error( "CRenderContextVBO: Error compiling %s shader:\n%s\n", type == GL_VERTEX_SHADER ? "vertex" : "fragment", szLog );
+
+		glDeleteShader( shader );
+
+		return 0;
+	}
+
+	return shader;
+}
+}
+
+void CRenderContextVBO::MatrixMode( const MatrixMode::MatrixMode mode )
+{
+	if( IsCoreProfile() )
+		CBaseRenderContext::MatrixMode( mode );
+	else
+		BaseClass::MatrixMode( mode );
+}
+
+void CRenderContextVBO::PushMatrix()
+{
+	if( IsCoreProfile() )
+		CBaseRenderContext::PushMatrix();
+	else
+		BaseClass::PushMatrix();
+}
+
+void CRenderContextVBO::PopMatrix()
+{
+	Flush();
+
+	if( IsCoreProfile() )
+		CBaseRenderContext::PopMatrix();
+	else
+		BaseClass::PopMatrix();
+}
+
+void CRenderContextVBO::LoadIdentity()
+{
+	Flush();
+
+	if( IsCoreProfile() )
+		CBaseRenderContext::LoadIdentity();
+	else
+		BaseClass::LoadIdentity();
+}
+
+void CRenderContextVBO::LoadMatrix( const Mat4x4& mat )
+{
+	Flush();
+
+	if( IsCoreProfile() )
+		CBaseRenderContext::LoadMatrix( mat );
+	else
+		BaseClass::LoadMatrix( mat );
+}
+
+void CRenderContextVBO::LoadTransposeMatrix( const Mat4x4& mat )
+{
+	Flush();
+
+	if( IsCoreProfile() )
+		CBaseRenderContext::LoadTransposeMatrix( mat );
+	else
+		BaseClass::LoadTransposeMatrix( mat );
+}
+
+void CRenderContextVBO::MultMatrix( const Mat4x4& mat )
+{
+	Flush();
+
+	if( IsCoreProfile() )
+		CBaseRenderContext::MultMatrix( mat );
+	else
+		BaseClass::MultMatrix( mat );
+}
+
+void CRenderContextVBO::MultTransposeMatrix( const Mat4x4& mat )
+{
+	Flush();
+
+	if( IsCoreProfile() )
+		CBaseRenderContext::MultTransposeMatrix( mat );
+	else
+		BaseClass::MultTransposeMatrix( mat );
+}
+
+void CRenderContextVBO::Viewport( int iX, int iY, int iWidth, int iHeight )
+{
+	Flush();
+
+	BaseClass::Viewport( iX, iY, iWidth, iHeight );
+}
+
+void CRenderContextVBO::Clear( const ClearBits_t bits )
+{
+	Flush();
+
+	BaseClass::Clear( bits );
+}
+
+bool CRenderContextVBO::ReadPixels( int iX, int iY, int iWidth, int iHeight, const ImageFormat format, byte* pOutBuffer )
+{
+	Flush();
+
+	return BaseClass::ReadPixels( iX, iY, iWidth, iHeight, format, pOutBuffer );
+}
+
+void CRenderContextVBO::DestroyTexture( HTexture_t hTexture )
+{
+	Flush();
+
+	if( hTexture == m_hTexture )
+		m_hTexture = NULL_TEXTURE_HANDLE;
+
+	BaseClass::DestroyTexture( hTexture );
+}
+
+void CRenderContextVBO::SetMinMagFilters( const MinFilter min, const MagFilter mag )
+{
+	Flush();
+
+	BaseClass::SetMinMagFilters( min, mag );
+}
+
+void CRenderContextVBO::InvalidateState()
+{
+	BaseClass::InvalidateState();
+
+	m_bColorValid = false;
+
+	if( m_InitState == InitState::INITIALIZED && !m_bCoreProfile )
+		ReadFixedFunctionState();
+}
+
+void CRenderContextVBO::DrawVertices( const PrimitiveType type, const Vertex* pVertices, const size_t uiCount )
+{
+	if( !EnsureInitialized() )
+	{
+		BaseClass::DrawVertices( type, pVertices, uiCount );
+		return;
+	}
+
+	if( CVertexBatch::GetListType( type, m_PolygonMode ) != m_Batch.GetListType() )
+		Flush();
+
+	m_Batch.Append( type, pVertices, uiCount, m_PolygonMode, m_ShadeModel );
+}
+
+void CRenderContextVBO::DrawPositions( const PrimitiveType type, const glm::vec3* pPositions, const unsigned short* pIndices, const size_t uiCount )
+{
+	if( !EnsureInitialized() )
+	{
+		BaseClass::DrawPositions( type, pPositions, pIndices, uiCount );
+		return;
+	}
+
+	if( CVertexBatch::GetListType( type, m_PolygonMode ) != m_Batch.GetListType() )
+		Flush();
+
+	m_Batch.Append( type, pPositions, pIndices, uiCount, GetCurrentColor(), m_PolygonMode );
+}
+
+void CRenderContextVBO::Flush()
+{
+	if( m_Batch.IsEmpty() )
+		return;
+
+	GLenum mode;
+
+	switch( m_Batch.GetListType() )
+	{
+	case CVertexBatch::ListType::POINTS:	mode = GL_POINTS; break;
+	case CVertexBatch::ListType::LINES:		mode = GL_LINES; break;
+	default:								mode = GL_TRIANGLES; break;
+	}
+
+	const auto& vertices = m_Batch.GetVertices();
+
+	BeginDraw();
+
+	for( size_t uiFirst = 0; uiFirst < vertices.size(); uiFirst += MAX_UPLOAD_VERTICES )
+	{
+		const size_t uiCount = std::min( vertices.size() - uiFirst, MAX_UPLOAD_VERTICES );
+
+		glDrawArrays( mode, Upload( vertices.data() + uiFirst, uiCount ), static_cast<GLsizei>( uiCount ) );
+
+		++m_uiDrawCallCount;
+	}
+
+	EndDraw();
+
+	m_Batch.Clear();
+}
+
+void CRenderContextVBO::ApplyCullFace( const CullFace cullFace )
+{
+	Flush();
+
+	BaseClass::ApplyCullFace( cullFace );
+}
+
+void CRenderContextVBO::ApplyCapability( const Capability capability, const bool bEnable )
+{
+	Flush();
+
+	switch( capability )
+	{
+	case Capability::TEXTURE_2D:
+		{
+			m_bTexture2D = bEnable;
+			break;
+		}
+
+	case Capability::ALPHA_TEST:
+		{
+			m_bAlphaTest = bEnable;
+			break;
+		}
+
+	default: break;
+	}
+
+	//These only exist in the fixed function pipeline.
+	if( ( capability == Capability::TEXTURE_2D || capability == Capability::ALPHA_TEST ) && IsCoreProfile() )
+		return;
+
+	BaseClass::ApplyCapability( capability, bEnable );
+}
+
+void CRenderContextVBO::ApplyBlendFunc( const BlendFactor src, const BlendFactor dst )
+{
+	Flush();
+
+	BaseClass::ApplyBlendFunc( src, dst );
+}
+
+void CRenderContextVBO::ApplyDepthMask( const bool bWrite )
+{
+	Flush();
+
+	BaseClass::ApplyDepthMask( bWrite );
+}
+
+void CRenderContextVBO::ApplyDepthFunc( const CompareFunc func )
+{
+	Flush();
+
+	BaseClass::ApplyDepthFunc( func );
+}
+
+void CRenderContextVBO::ApplyAlphaFunc( const CompareFunc func, const float flRef )
+{
+	Flush();
+
+	m_AlphaFunc = func;
+	m_flAlphaRef = flRef;
+
+	if( !IsCoreProfile() )
+		BaseClass::ApplyAlphaFunc( func, flRef );
+}
+
+void CRenderContextVBO::ApplyColor( const glm::vec4& color )
+{
+	//Vertices carry their own color, so batched draws are not affected.
+	m_Color = color;
+	m_bColorValid = true;
+
+	if( !IsCoreProfile() )
+		BaseClass::ApplyColor( color );
+}
+
+void CRenderContextVBO::ApplyPolygonMode( const PolygonMode mode )
+{
+	Flush();
+
+	m_PolygonMode = mode;
+
+	BaseClass::ApplyPolygonMode( mode );
+}
+
+void CRenderContextVBO::ApplyShadeModel( const ShadeModel model )
+{
+	//Applied to vertices as they are batched.
+	m_ShadeModel = model;
+
+	if( !IsCoreProfile() )
+		BaseClass::ApplyShadeModel( model );
+}
+
+void CRenderContextVBO::ApplyActiveTextureUnit( const unsigned int uiUnit )
+{
+	m_uiActiveTextureUnit = uiUnit;
+
+	BaseClass::ApplyActiveTextureUnit( uiUnit );
+}
+
+void CRenderContextVBO::ApplyBindTexture( HTexture_t hTexture )
+{
+	//The shaders only sample from the first unit.
+	if( m_uiActiveTextureUnit == 0 )
+	{
+		Flush();
+
+		m_hTexture = hTexture;
+	}
+
+	BaseClass::ApplyBindTexture( hTexture );
+}
+
+bool CRenderContextVBO::EnsureInitialized()
+{
+	if( m_InitState == InitState::NOT_INITIALIZED )
+	{
+		//No GL context has been made current yet.
+		if( !glGetString( GL_VERSION ) )
+			return false;
+
+		m_InitState = Initialize() ? InitState::INITIALIZED : InitState::FAILED;
+
+		if( m_InitState == InitState::INITIALIZED && !m_bCoreProfile )
+			ReadFixedFunctionState();
+	}
+
+	return m_InitState == InitState::INITIALIZED;
+}
+
+bool CRenderContextVBO::Initialize()
+{
+	if( !GLEW_VERSION_2_1 )
+	{
+		Warning( "CRenderContextVBO::Initialize: OpenGL 2.1 is required to draw with shaders, falling back to immediate mode\n" );
+		return false;
+	}
+
+	if( GLEW_VERSION_3_2 )
+	{
+		GLint profileMask = 0;
+
+		glGetIntegerv( GL_CONTEXT_PROFILE_MASK, &profileMask );
+
+		m_bCoreProfile = ( profileMask & GL_CONTEXT_CORE_PROFILE_BIT ) != 0;
+	}
+
+	if( !CreateProgram() )
+	{
+		Warning( "CRenderContextVBO::Initialize: Could not create shaders, falling back to immediate mode\n" );
+		return false;
+	}
+
+	CreateBuffer();
+
+	Message( "Drawing with shaders from a %s vertex buffer\n", m_bPersistent ? "persistently mapped" : "streamed" );
+
+	return true;
+}
+
+bool CRenderContextVBO::CreateProgram()
+{
+	const char* const pszVersion = m_bCoreProfile ? "#version 150 core\n" : "#version 120\n";
+
+	const GLuint vertexShader = CompileShader( GL_VERTEX_SHADER, pszVersion, VERTEX_SHADER );
+
+	if( !vertexShader )
+		return false;
+
+	const GLuint fragmentShader = CompileShader( GL_FRAGMENT_SHADER, pszVersion, FRAGMENT_SHADER );
+
+	if( !fragmentShader )
+	{
+		glDeleteShader( vertexShader );
+		return false;
+	}
+
+	m_Program = glCreateProgram();
+
+	glAttachShader( m_Program, vertexShader );
+	glAttachShader( m_Program, fragmentShader );
+
+	glBindAttribLocation( m_Program, ATTRIB_POSITION, "a_Position" );
+	glBindAttribLocation( m_Program, ATTRIB_TEXCOORD, "a_TexCoord" );
+	glBindAttribLocation( m_Program, ATTRIB_COLOR, "a_Color" );
+
+	if( m_bCoreProfile )
+		glBindFragDataLocation( m_Program, 0, "o_FragColor" );
+
+	glLinkProgram( m_Program );
+
+	//The program keeps them alive.
+	glDeleteShader( vertexShader );
+	glDeleteShader( fragmentShader );
+
+	GLint status = GL_FALSE;
+
+	glGetProgramiv( m_Program, GL_LINK_STATUS, &status );
+
+	if( status == GL_FALSE )
+	{
+		char szLog[ 1024 ] = {};
+
+		glGetProgramInfoLog( m_Program, sizeof( szLog ), nullptr, szLog );
+
+		Error( "CRenderContextVBO: Error linking shaders:\n%s\n", szLog );
+
+		glDeleteProgram( m_Program );
+		m_Program = 0;
+
+		return false;
+	}
+
+	m_Uniforms.ModelView = glGetUniformLocation( m_Program, "u_ModelView" );
+	m_Uniforms.Projection = glGetUniformLocation( m_Program, "u_Projection" );
+	m_Uniforms.Texture = glGetUniformLocation( m_Program, "u_Texture" );
+	m_Uniforms.Textured = glGetUniformLocation( m_Program, "u_Textured" );
+	m_Uniforms.AlphaFunc = glGetUniformLocation( m_Program, "u_AlphaFunc" );
+	m_Uniforms.AlphaRef = glGetUniformLocation( m_Program, "u_AlphaRef" );
+
+	glUseProgram( m_Program );
+	glUniform1i( m_Uniforms.Texture, 0 );
+	glUseProgram( 0 );
+
+	return true;
+}
+
+void CRenderContextVBO::CreateBuffer()
+{
+	const GLsizeiptr size = NUM_REGIONS * REGION_VERTICES * sizeof( Vertex );
+
+	glGenBuffers( 1, &m_Buffer );
+	glBindBuffer( GL_ARRAY_BUFFER, m_Buffer );
+
+	if( ( GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage ) && ( GLEW_VERSION_3_2 || GLEW_ARB_sync ) )
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glBufferStorage( GL_ARRAY_BUFFER, size, nullptr, flags );
+
+		m_pMappedVertices = static_cast<Vertex*>( glMapBufferRange( GL_ARRAY_BUFFER, 0, size, flags ) );
+
+		m_bPersistent = m_pMappedVertices != nullptr;
+
+		if( !m_bPersistent )
+		{
+			//Buffer storage can't be respecified, so start over with a new buffer.
+			glDeleteBuffers( 1, &m_Buffer );
+			glGenBuffers( 1, &m_Buffer );
+			glBindBuffer( GL_ARRAY_BUFFER, m_Buffer );
+		}
+	}
+
+	if( !m_bPersistent )
+		glBufferData( GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW );
+
+	m_bVertexArrays = GLEW_VERSION_3_0 || GLEW_ARB_vertex_array_object;
+
+	if( m_bVertexArrays )
+	{
+		glGenVertexArrays( 1, &m_VertexArray );
+		glBindVertexArray( m_VertexArray );
+
+		SetUpVertexAttributes();
+
+		glBindVertexArray( 0 );
+	}
+
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+}
+
+void CRenderContextVBO::SetUpVertexAttributes()
+{
+	glVertexAttribPointer( ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof( Vertex ), reinterpret_cast<const void*>( offsetof( Vertex, Position ) ) );
+	glVertexAttribPointer( ATTRIB_TEXCOORD, 2, GL_FLOAT, GL_FALSE, sizeof( Vertex ), reinterpret_cast<const void*>( offsetof( Vertex, TexCoord ) ) );
+	glVertexAttribPointer( ATTRIB_COLOR, 4, GL_FLOAT, GL_FALSE, sizeof( Vertex ), reinterpret_cast<const void*>( offsetof( Vertex, Color ) ) );
+
+	glEnableVertexAttribArray( ATTRIB_POSITION );
+	glEnableVertexAttribArray( ATTRIB_TEXCOORD );
+	glEnableVertexAttribArray( ATTRIB_COLOR );
+}
+
+bool CRenderContextVBO::IsCoreProfile()
+{
+	EnsureInitialized();
+
+	return m_bCoreProfile;
+}
+
+glm::vec4 CRenderContextVBO::GetCurrentColor()
+{
+	if( !m_bColorValid && !m_bCoreProfile )
+	{
+		glGetFloatv( GL_CURRENT_COLOR, glm::value_ptr( m_Color ) );
+		m_bColorValid = true;
+	}
+
+	return m_Color;
+}
+
+GLint CRenderContextVBO::Upload( const Vertex* pVertices, const size_t uiCount )
+{
+	if( m_uiRegionOffset + uiCount > REGION_VERTICES )
+	{
+		if( m_bPersistent )
+			m_RegionFences[ m_uiRegion ] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+
+		m_uiRegion = ( m_uiRegion + 1 ) % NUM_REGIONS;
+		m_uiRegionOffset = 0;
+
+		if( m_bPersistent )
+		{
+			if( m_RegionFences[ m_uiRegion ] )
+			{
+				//Wait until the GPU is done with the draws that used this region the last time around.
+				while( glClientWaitSync( m_RegionFences[ m_uiRegion ], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000 ) == GL_TIMEOUT_EXPIRED )
+				{
+				}
+
+				glDeleteSync( m_RegionFences[ m_uiRegion ] );
+				m_RegionFences[ m_uiRegion ] = nullptr;
+			}
+		}
+		else if( m_uiRegion == 0 )
+		{
+			//Orphan the buffer so the driver doesn't have to wait for draws that still use it.
+			glBufferData( GL_ARRAY_BUFFER, NUM_REGIONS * REGION_VERTICES * sizeof( Vertex ), nullptr, GL_STREAM_DRAW );
+		}
+	}
+
+	const size_t uiFirst = m_uiRegion * REGION_VERTICES + m_uiRegionOffset;
+
+	if( m_bPersistent )
+		memcpy( m_pMappedVertices + uiFirst, pVertices, uiCount * sizeof( Vertex ) );
+	else
+		glBufferSubData( GL_ARRAY_BUFFER, uiFirst * sizeof( Vertex ), uiCount * sizeof( Vertex ), pVertices );
+
+	m_uiRegionOffset += uiCount;
+
+	return static_cast<GLint>( uiFirst );
+}
+
+void CRenderContextVBO::ReadFixedFunctionState()
+{
+	m_bTexture2D = glIsEnabled( GL_TEXTURE_2D ) != GL_FALSE;
+	m_bAlphaTest = glIsEnabled( GL_ALPHA_TEST ) != GL_FALSE;
+
+	GLint alphaFunc;
+	glGetIntegerv( GL_ALPHA_TEST_FUNC, &alphaFunc );
+	glGetFloatv( GL_ALPHA_TEST_REF, &m_flAlphaRef );
+
+	m_AlphaFunc = CompareFunc::ALWAYS;
+
+	for( int func = static_cast<int>( CompareFunc::NEVER ); func <= static_cast<int>( CompareFunc::ALWAYS ); ++func )
+	{
+		if( CompareFuncToGL( static_cast<CompareFunc>( func ) ) == static_cast<GLenum>( alphaFunc ) )
+		{
+			m_AlphaFunc = static_cast<CompareFunc>( func );
+			break;
+		}
+	}
+
+	GLint polygonMode[ 2 ];
+	glGetIntegerv( GL_POLYGON_MODE, polygonMode );
+	m_PolygonMode = polygonMode[ 0 ] == GL_LINE ? PolygonMode::LINE : PolygonMode::FILL;
+
+	GLint shadeModel;
+	glGetIntegerv( GL_SHADE_MODEL, &shadeModel );
+	m_ShadeModel = shadeModel == GL_FLAT ? ShadeModel::FLAT : ShadeModel::SMOOTH;
+
+	GLint activeTexture;
+	glGetIntegerv( GL_ACTIVE_TEXTURE, &activeTexture );
+	m_uiActiveTextureUnit = static_cast<unsigned int>( activeTexture - GL_TEXTURE0 );
+
+	if( m_uiActiveTextureUnit == 0 )
+	{
+		GLint texture;
+		glGetIntegerv( GL_TEXTURE_BINDING_2D, &texture );
+		m_hTexture = GLToTexHandle( static_cast<GLuint>( texture ) );
+	}
+}
+
+void CRenderContextVBO::BeginDraw()
+{
+	glUseProgram( m_Program );
+	glBindBuffer( GL_ARRAY_BUFFER, m_Buffer );
+
+	if( m_bVertexArrays )
+		glBindVertexArray( m_VertexArray );
+	else
+		SetUpVertexAttributes();
+
+	Mat4x4 modelView;
+	Mat4x4 projection;
+
+	if( m_bCoreProfile )
+	{
+		const auto& matrices = GetMatrixStack();
+
+		modelView = matrices.GetMatrix( MatrixMode::MODEL ) * matrices.GetMatrix( MatrixMode::VIEW );
+		projection = matrices.GetMatrix( MatrixMode::PROJECTION );
+	}
+	else
+	{
+		//Code outside the context still changes these directly.
+		glGetFloatv( GL_MODELVIEW_MATRIX, glm::value_ptr( modelView ) );
+		glGetFloatv( GL_PROJECTION_MATRIX, glm::value_ptr( projection ) );
+	}
+
+	glUniformMatrix4fv( m_Uniforms.ModelView, 1, GL_FALSE, glm::value_ptr( modelView ) );
+	glUniformMatrix4fv( m_Uniforms.Projection, 1, GL_FALSE, glm::value_ptr( projection ) );
+
+	glUniform1i( m_Uniforms.Textured, m_bTexture2D && m_hTexture != NULL_TEXTURE_HANDLE );
+	glUniform1i( m_Uniforms.AlphaFunc, static_cast<GLint>( m_bAlphaTest ? m_AlphaFunc : CompareFunc::ALWAYS ) );
+	glUniform1f( m_Uniforms.AlphaRef, m_flAlphaRef );
+}
+
+void CRenderContextVBO::EndDraw()
+{
+	//Leave things as immediate mode code expects them.
+	if( m_bVertexArrays )
+	{
+		glBindVertexArray( 0 );
+	}
+	else
+	{
+		glDisableVertexAttribArray( ATTRIB_POSITION );
+		glDisableVertexAttribArray( ATTRIB_TEXCOORD );
+		glDisableVertexAttribArray( ATTRIB_COLOR );
+	}
+
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+	glUseProgram( 0 );
+}
+}
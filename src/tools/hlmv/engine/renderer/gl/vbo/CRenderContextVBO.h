@@ -0,0 +1,199 @@
+#ifndef ENGINE_RENDERER_GL_VBO_CRENDERCONTEXTVBO_H
+#define ENGINE_RENDERER_GL_VBO_CRENDERCONTEXTVBO_H
+
+#include <array>
+
+#include "engine/renderer/gl/imode/CRenderContextIMode.h"
+#include "engine/renderer/util/CVertexBatch.h"
+
+namespace renderer
+{
+/**
+*	Render context that batches draws into a vertex buffer and draws them with shaders.
+*	The vertex buffer is a persistently mapped ring buffer if the driver supports it, and is orphaned when it wraps around otherwise.
+*	Draws only use core profile features. In a compatibility profile context, the fixed function matrices
+*	and user clip planes are used so code that still uses immediate mode can be mixed in.
+*	GL objects are created the first time they are needed, since the GL context is created along with the first 3D view.
+*	If they cannot be created, this draws like the immediate mode context.
+*/
+class CRenderContextVBO : public CRenderContextIMode
+{
+public:
+	typedef CRenderContextIMode BaseClass;
+
+public:
+	CRenderContextVBO() = default;
+
+	//GL objects belong to the GL context and are destroyed along with it.
+	~CRenderContextVBO() = default;
+
+	void MatrixMode( const MatrixMode::MatrixMode mode ) override;
+
+	void PushMatrix() override;
+
+	void PopMatrix() override;
+
+	void LoadIdentity() override;
+
+	void LoadMatrix( const Mat4x4& mat ) override;
+
+	void LoadTransposeMatrix( const Mat4x4& mat ) override;
+
+	void MultMatrix( const Mat4x4& mat ) override;
+
+	void MultTransposeMatrix( const Mat4x4& mat ) override;
+
+	void Viewport( int iX, int iY, int iWidth, int iHeight ) override;
+
+	void Clear( const ClearBits_t bits ) override;
+
+	bool ReadPixels( int iX, int iY, int iWidth, int iHeight, const ImageFormat format, byte* pOutBuffer ) override;
+
+	void DestroyTexture( HTexture_t hTexture ) override;
+
+	void SetMinMagFilters( const MinFilter min, const MagFilter mag ) override;
+
+	void InvalidateState() override;
+
+	void DrawVertices( const PrimitiveType type, const Vertex* pVertices, const size_t uiCount ) override;
+
+	void DrawPositions( const PrimitiveType type, const glm::vec3* pPositions, const unsigned short* pIndices, const size_t uiCount ) override;
+
+	void Flush() override;
+
+	/**
+	*	@return Number of draw calls made since the context was created.
+	*/
+	unsigned int GetDrawCallCount() const { return m_uiDrawCallCount; }
+
+protected:
+	void ApplyCullFace( const CullFace cullFace ) override;
+
+	void ApplyCapability( const Capability capability, const bool bEnable ) override;
+
+	void ApplyBlendFunc( const BlendFactor src, const BlendFactor dst ) override;
+
+	void ApplyDepthMask( const bool bWrite ) override;
+
+	void ApplyDepthFunc( const CompareFunc func ) override;
+
+	void ApplyAlphaFunc( const CompareFunc func, const float flRef ) override;
+
+	void ApplyColor( const glm::vec4& color ) override;
+
+	void ApplyPolygonMode( const PolygonMode mode ) override;
+
+	void ApplyShadeModel( const ShadeModel model ) override;
+
+	void ApplyActiveTextureUnit( const unsigned int uiUnit ) override;
+
+	void ApplyBindTexture( HTexture_t hTexture ) override;
+
+private:
+	/**
+	*	Number of regions that the vertex buffer is split into. The GPU can read from one while the next one is written to.
+	*/
+	static constexpr size_t NUM_REGIONS = 3;
+
+	static constexpr size_t REGION_VERTICES = ( 1 << 20 ) / sizeof( Vertex );
+
+	/**
+	*	Largest number of vertices uploaded at once. A multiple of the vertices per primitive of every list type.
+	*/
+	static constexpr size_t MAX_UPLOAD_VERTICES = REGION_VERTICES - REGION_VERTICES % 6;
+
+	enum class InitState
+	{
+		NOT_INITIALIZED,
+		INITIALIZED,
+		FAILED
+	};
+
+	struct Uniforms
+	{
+		GLint ModelView = -1;
+		GLint Projection = -1;
+		GLint Texture = -1;
+		GLint Textured = -1;
+		GLint AlphaFunc = -1;
+		GLint AlphaRef = -1;
+	};
+
+	/**
+	*	Creates the GL objects if that has not been attempted yet.
+	*	@return Whether draws can use them.
+	*/
+	bool EnsureInitialized();
+
+	bool Initialize();
+
+	bool CreateProgram();
+
+	void CreateBuffer();
+
+	void SetUpVertexAttributes();
+
+	/**
+	*	@return Whether the fixed function pipeline is unavailable.
+	*/
+	bool IsCoreProfile();
+
+	glm::vec4 GetCurrentColor();
+
+	/**
+	*	Reads the fixed function state that the shaders emulate, since code outside the context can change it directly.
+	*/
+	void ReadFixedFunctionState();
+
+	/**
+	*	Copies vertices into the vertex buffer.
+	*	@return Index of the first vertex in the buffer.
+	*/
+	GLint Upload( const Vertex* pVertices, const size_t uiCount );
+
+	void BeginDraw();
+
+	void EndDraw();
+
+private:
+	InitState m_InitState = InitState::NOT_INITIALIZED;
+
+	bool m_bCoreProfile = false;
+	bool m_bPersistent = false;
+	bool m_bVertexArrays = false;
+
+	GLuint m_Program = 0;
+	Uniforms m_Uniforms;
+
+	GLuint m_Buffer = 0;
+	GLuint m_VertexArray = 0;
+
+	//Only set if the buffer is persistently mapped.
+	Vertex* m_pMappedVertices = nullptr;
+
+	size_t m_uiRegion = 0;
+	size_t m_uiRegionOffset = 0;
+	std::array<GLsync, NUM_REGIONS> m_RegionFences{};
+
+	CVertexBatch m_Batch;
+
+	unsigned int m_uiDrawCallCount = 0;
+
+	//The shaders do what the fixed function pipeline does for these states.
+	bool m_bTexture2D = false;
+	bool m_bAlphaTest = false;
+	CompareFunc m_AlphaFunc = CompareFunc::ALWAYS;
+	float m_flAlphaRef = 0;
+	unsigned int m_uiActiveTextureUnit = 0;
+	HTexture_t m_hTexture = NULL_TEXTURE_HANDLE;
+
+	//Needed to fill in the vertices of DrawPositions.
+	glm::vec4 m_Color{ 1 };
+	bool m_bColorValid = false;
+
+	PolygonMode m_PolygonMode = PolygonMode::FILL;
+	ShadeModel m_ShadeModel = ShadeModel::SMOOTH;
+};
+}
+
+#endif //ENGINE_RENDERER_GL_VBO_CRENDERCONTEXTVBO_H
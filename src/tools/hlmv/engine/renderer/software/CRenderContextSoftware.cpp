@@ -0,0 +1,607 @@
+#include <algorithm>
+#include <cstring>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "core/shared/Logging.h"
+
+#include "CRenderContextSoftware.h"
+
+namespace renderer
+{
+namespace
+{
+/**
+*	Number of frustum planes that vertices are clipped against.
+*/
+const int NUM_CLIP_PLANES = 6;
+
+/**
+*	@return Signed distance of a clip space position to a frustum plane. Positive inside.
+*/
+float GetPlaneDistance( const glm::vec4& position, const int iPlane )
+{
+	switch( iPlane )
+	{
+	case 0:		return position.w + position.x;
+	case 1:		return position.w - position.x;
+	case 2:		return position.w + position.y;
+	case 3:		return position.w - position.y;
+	case 4:		return position.w + position.z;
+
+	default:
+	case 5:		return position.w - position.z;
+	}
+}
+
+template<typename T>
+T Lerp( const T& from, const T& to, const float flFraction )
+{
+	return from + ( to - from ) * flFraction;
+}
+}
+
+CRenderContextSoftware::CRenderContextSoftware( unsigned int uiNumThreads )
+	: m_Rasterizer( uiNumThreads )
+{
+}
+
+void CRenderContextSoftware::SetFramebufferSize( const int iWidth, const int iHeight )
+{
+	m_Rasterizer.Resize( iWidth, iHeight );
+
+	Viewport( 0, 0, iWidth, iHeight );
+}
+
+void CRenderContextSoftware::Viewport( int iX, int iY, int iWidth, int iHeight )
+{
+	m_iViewportX = iX;
+	m_iViewportY = iY;
+	m_iViewportWidth = std::max( 0, iWidth );
+	m_iViewportHeight = std::max( 0, iHeight );
+}
+
+void CRenderContextSoftware::PerspectiveY( vec_t flFOVY, vec_t flAspect, vec_t flNear, vec_t flFar )
+{
+	MultMatrix( glm::perspective( flFOVY, flAspect, flNear, flFar ) );
+}
+
+void CRenderContextSoftware::ClearColor( const Color32& color )
+{
+	m_ClearColor = glm::clamp( glm::vec4{ color.r, color.g, color.b, color.a }, 0.0f, 1.0f );
+}
+
+void CRenderContextSoftware::ClearColor( const Color24& color, float flA )
+{
+	m_ClearColor = glm::clamp( glm::vec4{ color.r, color.g, color.b, flA }, 0.0f, 1.0f );
+}
+
+void CRenderContextSoftware::ClearColor( float flR, float flG, float flB, float flA )
+{
+	m_ClearColor = glm::clamp( glm::vec4{ flR, flG, flB, flA }, 0.0f, 1.0f );
+}
+
+void CRenderContextSoftware::Clear( const ClearBits_t bits )
+{
+	//Like OpenGL, the depth buffer is only cleared if it can be written to.
+	m_Rasterizer.AddClear( ( bits & ClearBit::COLOR ) != 0, m_ClearColor, ( bits & ClearBit::DEPTH ) != 0 && m_bDepthMask, 1.0f );
+}
+
+void CRenderContextSoftware::DrawVertices( const PrimitiveType type, const Vertex* pVertices, const size_t uiCount )
+{
+	m_Batch.Append( type, pVertices, uiCount, m_PolygonMode, m_ShadeModel );
+
+	DrawBatch();
+}
+
+void CRenderContextSoftware::DrawPositions( const PrimitiveType type, const glm::vec3* pPositions, const unsigned short* pIndices, const size_t uiCount )
+{
+	m_Batch.Append( type, pPositions, pIndices, uiCount, m_Color, m_PolygonMode );
+
+	DrawBatch();
+}
+
+void CRenderContextSoftware::Flush()
+{
+	//Primitives are rasterized when the framebuffer is read.
+}
+
+bool CRenderContextSoftware::ReadPixels( int iX, int iY, int iWidth, int iHeight, const ImageFormat format, byte* pOutBuffer )
+{
+	if( iX < 0 || iY < 0 || iWidth < 0 || iHeight < 0 || iX + iWidth > m_Rasterizer.GetWidth() || iY + iHeight > m_Rasterizer.GetHeight() )
+	{
+		Error( "CRenderContextSoftware::ReadPixels: Rectangle %d %d %d %d is outside the %dx%d framebuffer\n",
+			iX, iY, iWidth, iHeight, m_Rasterizer.GetWidth(), m_Rasterizer.GetHeight() );
+		return false;
+	}
+
+	size_t uiChannels;
+	size_t uiFirstChannel;
+
+	switch( format )
+	{
+	case ImageFormat::RGB:		uiChannels = 3; uiFirstChannel = 0; break;
+	case ImageFormat::RGBA:		uiChannels = 4; uiFirstChannel = 0; break;
+	case ImageFormat::ALPHA:	uiChannels = 1; uiFirstChannel = 3; break;
+
+	default:
+		{
+			Error( "CRenderContextSoftware::ReadPixels: Unsupported image format \"%d\"\n", format );
+			return false;
+		}
+	}
+
+	m_Rasterizer.Resolve();
+
+	const byte* const pColorBuffer = m_Rasterizer.GetColorBuffer();
+
+	for( int iRow = 0; iRow < iHeight; ++iRow )
+	{
+		const byte* pSource = pColorBuffer + ( static_cast<size_t>( iY + iRow ) * m_Rasterizer.GetWidth() + iX ) * 4 + uiFirstChannel;
+
+		for( int iColumn = 0; iColumn < iWidth; ++iColumn, pSource += 4, pOutBuffer += uiChannels )
+		{
+			memcpy( pOutBuffer, pSource, uiChannels );
+		}
+	}
+
+	return true;
+}
+
+HTexture_t CRenderContextSoftware::CreateTexture( const int mipmaps, const ImageFormat format, const int iWidth, const int iHeight, const byte* pData )
+{
+	if( iWidth <= 0 || iHeight <= 0 )
+	{
+		Error( "CRenderContextSoftware::CreateTexture: Invalid texture size %dx%d\n", iWidth, iHeight );
+		return NULL_TEXTURE_HANDLE;
+	}
+
+	size_t uiChannels;
+
+	switch( format )
+	{
+	case ImageFormat::RGB:				uiChannels = 3; break;
+	case ImageFormat::RGBA:				uiChannels = 4; break;
+	case ImageFormat::ALPHA:			uiChannels = 1; break;
+	case ImageFormat::LUMINANCE:		uiChannels = 1; break;
+	case ImageFormat::LUMINANCE_ALPHA:	uiChannels = 2; break;
+
+	default:
+		{
+			Error( "CRenderContextSoftware::CreateTexture: Invalid image format \"%d\"\n", format );
+			return NULL_TEXTURE_HANDLE;
+		}
+	}
+
+	auto texture = std::make_unique<CSoftwareRasterizer::Texture>();
+
+	texture->iWidth = iWidth;
+	texture->iHeight = iHeight;
+
+	const size_t uiPixels = static_cast<size_t>( iWidth ) * iHeight;
+
+	texture->Pixels.resize( uiPixels * 4 );
+
+	//Expand to RGBA the way OpenGL does.
+	if( pData )
+	{
+		byte* pDest = texture->Pixels.data();
+
+		for( size_t uiPixel = 0; uiPixel < uiPixels; ++uiPixel, pData += uiChannels, pDest += 4 )
+		{
+			switch( format )
+			{
+			case ImageFormat::RGB:
+				{
+					pDest[ 0 ] = pData[ 0 ];
+					pDest[ 1 ] = pData[ 1 ];
+					pDest[ 2 ] = pData[ 2 ];
+					pDest[ 3 ] = 0xFF;
+					break;
+				}
+
+			case ImageFormat::RGBA:
+				{
+					memcpy( pDest, pData, 4 );
+					break;
+				}
+
+			case ImageFormat::ALPHA:
+				{
+					pDest[ 0 ] = pDest[ 1 ] = pDest[ 2 ] = 0;
+					pDest[ 3 ] = pData[ 0 ];
+					break;
+				}
+
+			case ImageFormat::LUMINANCE:
+				{
+					pDest[ 0 ] = pDest[ 1 ] = pDest[ 2 ] = pData[ 0 ];
+					pDest[ 3 ] = 0xFF;
+					break;
+				}
+
+			case ImageFormat::LUMINANCE_ALPHA:
+				{
+					pDest[ 0 ] = pDest[ 1 ] = pDest[ 2 ] = pData[ 0 ];
+					pDest[ 3 ] = pData[ 1 ];
+					break;
+				}
+			}
+		}
+	}
+
+	const auto hTexture = reinterpret_cast<HTexture_t>( m_uiNextTexture++ );
+
+	m_Textures.emplace( hTexture, std::move( texture ) );
+
+	BindTexture( hTexture );
+
+	return hTexture;
+}
+
+void CRenderContextSoftware::DestroyTexture( HTexture_t hTexture )
+{
+	auto it = m_Textures.find( hTexture );
+
+	if( it == m_Textures.end() )
+		return;
+
+	//Primitives that have not been rasterized yet may still use it.
+	m_Rasterizer.Resolve();
+
+	m_Textures.erase( it );
+
+	for( auto& boundTexture : m_BoundTextures )
+	{
+		if( boundTexture == hTexture )
+			boundTexture = NULL_TEXTURE_HANDLE;
+	}
+
+	m_bStateChanged = true;
+
+	ForgetTexture( hTexture );
+}
+
+void CRenderContextSoftware::SetMinMagFilters( const MinFilter min, const MagFilter mag )
+{
+	auto pTexture = GetTexture( m_BoundTextures[ m_uiActiveTextureUnit ] );
+
+	if( !pTexture )
+		return;
+
+	m_Rasterizer.Resolve();
+
+	pTexture->bLinear = mag == MagFilter::LINEAR;
+}
+
+void CRenderContextSoftware::ApplyCullFace( const CullFace cullFace )
+{
+	m_CullFace = cullFace;
+}
+
+void CRenderContextSoftware::ApplyCapability( const Capability capability, const bool bEnable )
+{
+	m_Capabilities[ static_cast<size_t>( capability ) ] = bEnable;
+	m_bStateChanged = true;
+}
+
+void CRenderContextSoftware::ApplyBlendFunc( const BlendFactor src, const BlendFactor dst )
+{
+	m_BlendSrc = src;
+	m_BlendDst = dst;
+	m_bStateChanged = true;
+}
+
+void CRenderContextSoftware::ApplyDepthMask( const bool bWrite )
+{
+	m_bDepthMask = bWrite;
+	m_bStateChanged = true;
+}
+
+void CRenderContextSoftware::ApplyDepthFunc( const CompareFunc func )
+{
+	m_DepthFunc = func;
+	m_bStateChanged = true;
+}
+
+void CRenderContextSoftware::ApplyAlphaFunc( const CompareFunc func, const float flRef )
+{
+	m_AlphaFunc = func;
+	m_flAlphaRef = flRef;
+	m_bStateChanged = true;
+}
+
+void CRenderContextSoftware::ApplyColor( const glm::vec4& color )
+{
+	m_Color = color;
+}
+
+void CRenderContextSoftware::ApplyPolygonMode( const PolygonMode mode )
+{
+	m_PolygonMode = mode;
+}
+
+void CRenderContextSoftware::ApplyShadeModel( const ShadeModel model )
+{
+	m_ShadeModel = model;
+}
+
+void CRenderContextSoftware::ApplyActiveTextureUnit( const unsigned int uiUnit )
+{
+	m_uiActiveTextureUnit = uiUnit;
+}
+
+void CRenderContextSoftware::ApplyBindTexture( HTexture_t hTexture )
+{
+	m_BoundTextures[ m_uiActiveTextureUnit ] = hTexture;
+
+	//Only the first unit is sampled from.
+	if( m_uiActiveTextureUnit == 0 )
+		m_bStateChanged = true;
+}
+
+CSoftwareRasterizer::State CRenderContextSoftware::GetRasterizerState() const
+{
+	CSoftwareRasterizer::State state;
+
+	if( m_Capabilities[ static_cast<size_t>( Capability::TEXTURE_2D ) ] )
+	{
+		auto it = m_Textures.find( m_BoundTextures[ 0 ] );
+
+		if( it != m_Textures.end() )
+			state.pTexture = it->second.get();
+	}
+
+	state.bBlend = m_Capabilities[ static_cast<size_t>( Capability::BLEND ) ];
+	state.BlendSrc = m_BlendSrc;
+	state.BlendDst = m_BlendDst;
+
+	state.bDepthTest = m_Capabilities[ static_cast<size_t>( Capability::DEPTH_TEST ) ];
+	state.DepthFunc = m_DepthFunc;
+	state.bDepthWrite = m_bDepthMask;
+
+	state.AlphaFunc = m_Capabilities[ static_cast<size_t>( Capability::ALPHA_TEST ) ] ? m_AlphaFunc : CompareFunc::ALWAYS;
+	state.flAlphaRef = m_flAlphaRef;
+
+	return state;
+}
+
+void CRenderContextSoftware::DrawBatch()
+{
+	if( m_Batch.IsEmpty() )
+	{
+		m_Batch.Clear();
+		return;
+	}
+
+	if( m_bStateChanged )
+	{
+		m_Rasterizer.SetState( GetRasterizerState() );
+		m_bStateChanged = false;
+	}
+
+	const auto& matrices = GetMatrixStack();
+
+	const Mat4x4 modelViewProjection = matrices.GetMatrix( MatrixMode::PROJECTION ) * ( matrices.GetMatrix( MatrixMode::MODEL ) * matrices.GetMatrix( MatrixMode::VIEW ) );
+
+	const auto& vertices = m_Batch.GetVertices();
+
+	const size_t uiVerticesPerPrimitive = CVertexBatch::GetVerticesPerPrimitive( m_Batch.GetListType() );
+
+	ClipVertex primitive[ 3 ];
+
+	for( size_t uiFirst = 0; uiFirst + uiVerticesPerPrimitive <= vertices.size(); uiFirst += uiVerticesPerPrimitive )
+	{
+		for( size_t uiVertex = 0; uiVertex < uiVerticesPerPrimitive; ++uiVertex )
+		{
+			const auto& vertex = vertices[ uiFirst + uiVertex ];
+
+			//OpenGL clamps vertex colors before they are interpolated.
+			primitive[ uiVertex ] = ClipVertex
+			{
+				modelViewProjection * glm::vec4( vertex.Position, 1 ),
+				vertex.TexCoord,
+				glm::clamp( vertex.Color, 0.0f, 1.0f )
+			};
+		}
+
+		switch( m_Batch.GetListType() )
+		{
+		case CVertexBatch::ListType::POINTS:	DrawPoint( primitive[ 0 ] ); break;
+		case CVertexBatch::ListType::LINES:		DrawLine( primitive[ 0 ], primitive[ 1 ] ); break;
+		case CVertexBatch::ListType::TRIANGLES:	DrawTriangle( primitive ); break;
+
+		default: break;
+		}
+	}
+
+	m_Batch.Clear();
+}
+
+void CRenderContextSoftware::DrawTriangle( const ClipVertex* pVertices )
+{
+	ClipVertex buffers[ 2 ][ MAX_CLIPPED_VERTICES ];
+
+	std::copy( pVertices, pVertices + 3, buffers[ 0 ] );
+
+	const ClipVertex* pPolygon = buffers[ 0 ];
+	size_t uiCount = 3;
+
+	//Clip against each frustum plane in turn. Triangles that are completely inside are left as they are.
+	for( int iPlane = 0; iPlane < NUM_CLIP_PLANES && uiCount >= 3; ++iPlane )
+	{
+		float flDistances[ MAX_CLIPPED_VERTICES ];
+
+		bool bAllInside = true;
+
+		for( size_t uiVertex = 0; uiVertex < uiCount; ++uiVertex )
+		{
+			flDistances[ uiVertex ] = GetPlaneDistance( pPolygon[ uiVertex ].Position, iPlane );
+
+			if( flDistances[ uiVertex ] < 0 )
+				bAllInside = false;
+		}
+
+		if( bAllInside )
+			continue;
+
+		ClipVertex* pClipped = pPolygon == buffers[ 0 ] ? buffers[ 1 ] : buffers[ 0 ];
+		size_t uiClippedCount = 0;
+
+		for( size_t uiVertex = 0; uiVertex < uiCount; ++uiVertex )
+		{
+			const size_t uiNext = ( uiVertex + 1 ) % uiCount;
+
+			const float flDistance = flDistances[ uiVertex ];
+			const float flNextDistance = flDistances[ uiNext ];
+
+			if( flDistance >= 0 )
+				pClipped[ uiClippedCount++ ] = pPolygon[ uiVertex ];
+
+			if( ( flDistance >= 0 ) != ( flNextDistance >= 0 ) )
+			{
+				const float flFraction = flDistance / ( flDistance - flNextDistance );
+
+				const auto& from = pPolygon[ uiVertex ];
+				const auto& to = pPolygon[ uiNext ];
+
+				pClipped[ uiClippedCount++ ] = ClipVertex
+				{
+					Lerp( from.Position, to.Position, flFraction ),
+					Lerp( from.TexCoord, to.TexCoord, flFraction ),
+					Lerp( from.Color, to.Color, flFraction )
+				};
+			}
+		}
+
+		pPolygon = pClipped;
+		uiCount = uiClippedCount;
+	}
+
+	if( uiCount < 3 )
+		return;
+
+	CSoftwareRasterizer::WindowVertex windowVertices[ MAX_CLIPPED_VERTICES ];
+
+	for( size_t uiVertex = 0; uiVertex < uiCount; ++uiVertex )
+	{
+		windowVertices[ uiVertex ] = ToWindow( pPolygon[ uiVertex ] );
+	}
+
+	if( m_Capabilities[ static_cast<size_t>( Capability::CULL_FACE ) ] )
+	{
+		float flArea = 0;
+
+		for( size_t uiVertex = 0; uiVertex < uiCount; ++uiVertex )
+		{
+			const auto& vertex = windowVertices[ uiVertex ];
+			const auto& next = windowVertices[ ( uiVertex + 1 ) % uiCount ];
+
+			flArea += vertex.flX * next.flY - next.flX * vertex.flY;
+		}
+
+		//Counter-clockwise polygons face the viewer.
+		const bool bFront = flArea >= 0;
+
+		if( m_CullFace == CullFace::FRONT_AND_BACK
+			|| ( m_CullFace == CullFace::FRONT && bFront )
+			|| ( m_CullFace == CullFace::BACK && !bFront ) )
+		{
+			return;
+		}
+	}
+
+	const auto rect = GetViewportRect();
+
+	if( m_PolygonMode == PolygonMode::LINE )
+	{
+		for( size_t uiVertex = 0; uiVertex < uiCount; ++uiVertex )
+		{
+			m_Rasterizer.AddLine( windowVertices[ uiVertex ], windowVertices[ ( uiVertex + 1 ) % uiCount ], rect );
+		}
+	}
+	else
+	{
+		for( size_t uiVertex = 2; uiVertex < uiCount; ++uiVertex )
+		{
+			m_Rasterizer.AddTriangle( windowVertices[ 0 ], windowVertices[ uiVertex - 1 ], windowVertices[ uiVertex ], rect );
+		}
+	}
+}
+
+void CRenderContextSoftware::DrawLine( ClipVertex v0, ClipVertex v1 )
+{
+	float flStart = 0;
+	float flEnd = 1;
+
+	for( int iPlane = 0; iPlane < NUM_CLIP_PLANES; ++iPlane )
+	{
+		const float flDistance0 = GetPlaneDistance( v0.Position, iPlane );
+		const float flDistance1 = GetPlaneDistance( v1.Position, iPlane );
+
+		if( flDistance0 < 0 && flDistance1 < 0 )
+			return;
+
+		if( flDistance0 < 0 )
+			flStart = std::max( flStart, flDistance0 / ( flDistance0 - flDistance1 ) );
+		else if( flDistance1 < 0 )
+			flEnd = std::min( flEnd, flDistance0 / ( flDistance0 - flDistance1 ) );
+	}
+
+	if( flStart > flEnd )
+		return;
+
+	auto clip = [ & ]( const float flFraction )
+	{
+		return ClipVertex
+		{
+			Lerp( v0.Position, v1.Position, flFraction ),
+			Lerp( v0.TexCoord, v1.TexCoord, flFraction ),
+			Lerp( v0.Color, v1.Color, flFraction )
+		};
+	};
+
+	const auto start = flStart > 0 ? clip( flStart ) : v0;
+	const auto end = flEnd < 1 ? clip( flEnd ) : v1;
+
+	m_Rasterizer.AddLine( ToWindow( start ), ToWindow( end ), GetViewportRect() );
+}
+
+void CRenderContextSoftware::DrawPoint( const ClipVertex& v )
+{
+	for( int iPlane = 0; iPlane < NUM_CLIP_PLANES; ++iPlane )
+	{
+		if( GetPlaneDistance( v.Position, iPlane ) < 0 )
+			return;
+	}
+
+	m_Rasterizer.AddPoint( ToWindow( v ), GetViewportRect() );
+}
+
+CSoftwareRasterizer::WindowVertex CRenderContextSoftware::ToWindow( const ClipVertex& v ) const
+{
+	const float flInvW = 1.0f / v.Position.w;
+
+	return
+	{
+		m_iViewportX + ( v.Position.x * flInvW * 0.5f + 0.5f ) * m_iViewportWidth,
+		m_iViewportY + ( v.Position.y * flInvW * 0.5f + 0.5f ) * m_iViewportHeight,
+		v.Position.z * flInvW * 0.5f + 0.5f,
+		flInvW,
+		v.TexCoord,
+		v.Color
+	};
+}
+
+CSoftwareRasterizer::Rect CRenderContextSoftware::GetViewportRect() const
+{
+	return { m_iViewportX, m_iViewportY, m_iViewportX + m_iViewportWidth - 1, m_iViewportY + m_iViewportHeight - 1 };
+}
+
+CSoftwareRasterizer::Texture* CRenderContextSoftware::GetTexture( HTexture_t hTexture )
+{
+	auto it = m_Textures.find( hTexture );
+
+	return it != m_Textures.end() ? it->second.get() : nullptr;
+}
+}
@@ -0,0 +1,192 @@
+#ifndef ENGINE_RENDERER_SOFTWARE_CRENDERCONTEXTSOFTWARE_H
+#define ENGINE_RENDERER_SOFTWARE_CRENDERCONTEXTSOFTWARE_H
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+
+#include "engine/renderer/CBaseRenderContext.h"
+#include "engine/renderer/util/CVertexBatch.h"
+
+#include "CSoftwareRasterizer.h"
+
+namespace renderer
+{
+/**
+*	Render context that draws into a framebuffer in memory, without a GL context.
+*	Implements what the studio model and sprite renderers use: textured, depth tested, alpha tested and blended triangles,
+*	lines and points with flat or smooth shading. Stencil and user clip planes are not supported.
+*	Draws are rasterized when the framebuffer is read, so Flush does nothing.
+*	Rendering the same draws always produces the same image, regardless of the number of threads.
+*/
+class CRenderContextSoftware final : public CBaseRenderContext
+{
+public:
+	/**
+	*	@param uiNumThreads Number of threads to rasterize with. 0 uses all cores.
+	*/
+	CRenderContextSoftware( unsigned int uiNumThreads = 0 );
+	~CRenderContextSoftware() = default;
+
+	/**
+	*	Resizes the framebuffer and sets the viewport to cover it.
+	*/
+	void SetFramebufferSize( const int iWidth, const int iHeight );
+
+	int GetFramebufferWidth() const { return m_Rasterizer.GetWidth(); }
+	int GetFramebufferHeight() const { return m_Rasterizer.GetHeight(); }
+
+	unsigned int GetNumThreads() const { return m_Rasterizer.GetNumThreads(); }
+
+	/**
+	*	@copydoc CSoftwareRasterizer::SetNumThreads
+	*/
+	void SetNumThreads( const unsigned int uiNumThreads ) { m_Rasterizer.SetNumThreads( uiNumThreads ); }
+
+	/**
+	*	@return Number of triangles, lines and points rasterized since the context was created.
+	*/
+	std::uint64_t GetRasterizedPrimitiveCount() const { return m_Rasterizer.GetRasterizedPrimitiveCount(); }
+
+	void Viewport( int iX, int iY, int iWidth, int iHeight ) override;
+
+	void PerspectiveY( vec_t flFOVY, vec_t flAspect, vec_t flNear, vec_t flFar ) override;
+
+	void ClearColor( const Color32& color ) override;
+
+	void ClearColor( const Color24& color, float flA = 0 ) override;
+
+	void ClearColor( float flR = 0, float flG = 0, float flB = 0, float flA = 0 ) override;
+
+	void Clear( const ClearBits_t bits ) override;
+
+	void DrawVertices( const PrimitiveType type, const Vertex* pVertices, const size_t uiCount ) override;
+
+	void DrawPositions( const PrimitiveType type, const glm::vec3* pPositions, const unsigned short* pIndices, const size_t uiCount ) override;
+
+	void Flush() override;
+
+	//There is only one buffer, so the read buffer has no effect.
+	ReadBuffer GetReadBuffer() const override { return m_ReadBuffer; }
+
+	void SetReadBuffer( const ReadBuffer buffer ) override { m_ReadBuffer = buffer; }
+
+	bool ReadPixels( int iX, int iY, int iWidth, int iHeight, const ImageFormat format, byte* pOutBuffer ) override;
+
+	/**
+	*	@copydoc IRenderContext::CreateTexture
+	*	Only the base level is stored, minified textures are sampled from it.
+	*/
+	HTexture_t CreateTexture( const int mipmaps, const ImageFormat format, const int iWidth, const int iHeight, const byte* pData ) override;
+
+	void DestroyTexture( HTexture_t hTexture ) override;
+
+	void SetMinMagFilters( const MinFilter min, const MagFilter mag ) override;
+
+protected:
+	void ApplyCullFace( const CullFace cullFace ) override;
+
+	void ApplyCapability( const Capability capability, const bool bEnable ) override;
+
+	void ApplyBlendFunc( const BlendFactor src, const BlendFactor dst ) override;
+
+	void ApplyDepthMask( const bool bWrite ) override;
+
+	bool QueryDepthMask() const override { return m_bDepthMask; }
+
+	void ApplyDepthFunc( const CompareFunc func ) override;
+
+	void ApplyAlphaFunc( const CompareFunc func, const float flRef ) override;
+
+	void ApplyColor( const glm::vec4& color ) override;
+
+	void ApplyPolygonMode( const PolygonMode mode ) override;
+
+	void ApplyShadeModel( const ShadeModel model ) override;
+
+	void ApplyActiveTextureUnit( const unsigned int uiUnit ) override;
+
+	void ApplyBindTexture( HTexture_t hTexture ) override;
+
+private:
+	/**
+	*	Vertex in clip space.
+	*/
+	struct ClipVertex
+	{
+		glm::vec4 Position;
+		glm::vec2 TexCoord;
+		glm::vec4 Color;
+	};
+
+	/**
+	*	Enough room for a triangle clipped against all 6 frustum planes.
+	*/
+	static constexpr size_t MAX_CLIPPED_VERTICES = 9;
+
+	/**
+	*	@return The state that primitives are rasterized with.
+	*/
+	CSoftwareRasterizer::State GetRasterizerState() const;
+
+	/**
+	*	Transforms, clips and adds the primitives in the batch to the rasterizer, then clears it.
+	*/
+	void DrawBatch();
+
+	void DrawTriangle( const ClipVertex* pVertices );
+
+	void DrawLine( ClipVertex v0, ClipVertex v1 );
+
+	void DrawPoint( const ClipVertex& v );
+
+	CSoftwareRasterizer::WindowVertex ToWindow( const ClipVertex& v ) const;
+
+	CSoftwareRasterizer::Rect GetViewportRect() const;
+
+	CSoftwareRasterizer::Texture* GetTexture( HTexture_t hTexture );
+
+private:
+	CSoftwareRasterizer m_Rasterizer;
+
+	CVertexBatch m_Batch;
+
+	int m_iViewportX = 0;
+	int m_iViewportY = 0;
+	int m_iViewportWidth = 0;
+	int m_iViewportHeight = 0;
+
+	glm::vec4 m_ClearColor{ 0 };
+
+	ReadBuffer m_ReadBuffer = ReadBuffer::BACK;
+
+	std::unordered_map<HTexture_t, std::unique_ptr<CSoftwareRasterizer::Texture>> m_Textures;
+
+	//Handles are small integers so they survive being stored as GL texture names.
+	size_t m_uiNextTexture = 1;
+
+	//State as set through the context, with OpenGL's defaults.
+	CullFace m_CullFace = CullFace::BACK;
+	std::array<bool, static_cast<size_t>( Capability::COUNT )> m_Capabilities{};
+	BlendFactor m_BlendSrc = BlendFactor::ONE;
+	BlendFactor m_BlendDst = BlendFactor::ZERO;
+	bool m_bDepthMask = true;
+	CompareFunc m_DepthFunc = CompareFunc::LESS;
+	CompareFunc m_AlphaFunc = CompareFunc::ALWAYS;
+	float m_flAlphaRef = 0;
+	glm::vec4 m_Color{ 1 };
+	PolygonMode m_PolygonMode = PolygonMode::FILL;
+	ShadeModel m_ShadeModel = ShadeModel::SMOOTH;
+	unsigned int m_uiActiveTextureUnit = 0;
+	std::array<HTexture_t, MAX_TEXTURE_UNITS> m_BoundTextures{};
+
+	//Whether the rasterizer has to be given the state again before the next primitive.
+	bool m_bStateChanged = true;
+
+private:
+	CRenderContextSoftware( const CRenderContextSoftware& ) = delete;
+	CRenderContextSoftware& operator=( const CRenderContextSoftware& ) = delete;
+};
+}
+
+#endif //ENGINE_RENDERER_SOFTWARE_CRENDERCONTEXTSOFTWARE_H
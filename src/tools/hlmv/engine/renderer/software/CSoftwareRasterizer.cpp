@@ -0,0 +1,583 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <utility>
+
+#include "CSoftwareRasterizer.h"
+
+namespace renderer
+{
+namespace
+{
+bool Compare( const CompareFunc func, const float flValue, const float flRef )
+{
+	switch( func )
+	{
+	case CompareFunc::NEVER:	return false;
+	case CompareFunc::LESS:		return flValue < flRef;
+	case CompareFunc::EQUAL:	return flValue == flRef;
+	case CompareFunc::LEQUAL:	return flValue <= flRef;
+	case CompareFunc::GREATER:	return flValue > flRef;
+	case CompareFunc::NOTEQUAL:	return flValue != flRef;
+	case CompareFunc::GEQUAL:	return flValue >= flRef;
+
+	default:
+	case CompareFunc::ALWAYS:	return true;
+	}
+}
+
+float GetBlendFactor( const BlendFactor factor, const float flSrcAlpha )
+{
+	switch( factor )
+	{
+	case BlendFactor::ZERO:					return 0;
+	case BlendFactor::SRC_ALPHA:			return flSrcAlpha;
+	case BlendFactor::ONE_MINUS_SRC_ALPHA:	return 1 - flSrcAlpha;
+
+	default:
+	case BlendFactor::ONE:					return 1;
+	}
+}
+
+byte ToByte( const float flValue )
+{
+	return static_cast<byte>( std::clamp( flValue, 0.0f, 1.0f ) * 255.0f + 0.5f );
+}
+
+std::int64_t ToFixed( const float flValue )
+{
+	return static_cast<std::int64_t>( std::lround( flValue * ( 1 << CSoftwareRasterizer::SUBPIXEL_BITS ) ) );
+}
+
+int Wrap( const int iValue, const int iSize )
+{
+	const int iResult = iValue % iSize;
+
+	return iResult < 0 ? iResult + iSize : iResult;
+}
+
+CSoftwareRasterizer::Rect Intersect( const CSoftwareRasterizer::Rect& lhs, const CSoftwareRasterizer::Rect& rhs )
+{
+	return
+	{
+		std::max( lhs.iMinX, rhs.iMinX ),
+		std::max( lhs.iMinY, rhs.iMinY ),
+		std::min( lhs.iMaxX, rhs.iMaxX ),
+		std::min( lhs.iMaxY, rhs.iMaxY )
+	};
+}
+
+bool IsEmpty( const CSoftwareRasterizer::Rect& rect )
+{
+	return rect.iMinX > rect.iMaxX || rect.iMinY > rect.iMaxY;
+}
+}
+
+CSoftwareRasterizer::CSoftwareRasterizer( unsigned int uiNumThreads )
+{
+	SetNumThreads( uiNumThreads );
+
+	m_States.emplace_back();
+}
+
+void CSoftwareRasterizer::SetNumThreads( const unsigned int uiNumThreads )
+{
+	m_uiNumThreads = uiNumThreads > 0 ? uiNumThreads : std::max( 1u, std::thread::hardware_concurrency() );
+}
+
+void CSoftwareRasterizer::Resize( const int iWidth, const int iHeight )
+{
+	Resolve();
+
+	m_iWidth = std::max( 0, iWidth );
+	m_iHeight = std::max( 0, iHeight );
+
+	m_iTilesX = ( m_iWidth + TILE_SIZE - 1 ) / TILE_SIZE;
+	m_iTilesY = ( m_iHeight + TILE_SIZE - 1 ) / TILE_SIZE;
+
+	m_ColorBuffer.assign( static_cast<size_t>( m_iWidth ) * m_iHeight * 4, 0 );
+	m_DepthBuffer.assign( static_cast<size_t>( m_iWidth ) * m_iHeight, 1.0f );
+
+	m_TileBins.clear();
+	m_TileBins.resize( static_cast<size_t>( m_iTilesX ) * m_iTilesY );
+}
+
+void CSoftwareRasterizer::SetState( const State& state )
+{
+	//Nothing uses the current state yet, so it can be replaced.
+	if( m_Primitives.empty() || m_Primitives.back().uiState != m_States.size() - 1 )
+	{
+		m_States.back() = state;
+		return;
+	}
+
+	m_States.push_back( state );
+}
+
+void CSoftwareRasterizer::AddClear( const bool bColor, const glm::vec4& color, const bool bDepth, const float flDepth )
+{
+	if( !bColor && !bDepth )
+		return;
+
+	Primitive primitive{};
+
+	primitive.Type = PrimitiveType::CLEAR;
+	primitive.uiState = static_cast<std::uint32_t>( m_States.size() - 1 );
+	primitive.Bounds = { 0, 0, m_iWidth - 1, m_iHeight - 1 };
+	primitive.Vertices[ 0 ].Color = color;
+	primitive.Vertices[ 0 ].flZ = flDepth;
+	primitive.bClearColor = bColor;
+	primitive.bClearDepth = bDepth;
+
+	AddToTiles( std::move( primitive ) );
+}
+
+void CSoftwareRasterizer::AddTriangle( const WindowVertex& v0, const WindowVertex& v1, const WindowVertex& v2, const Rect& rect )
+{
+	Primitive primitive{};
+
+	primitive.Type = PrimitiveType::TRIANGLE;
+	primitive.uiState = static_cast<std::uint32_t>( m_States.size() - 1 );
+	primitive.Vertices[ 0 ] = v0;
+	primitive.Vertices[ 1 ] = v1;
+	primitive.Vertices[ 2 ] = v2;
+
+	std::int64_t x[ 3 ];
+	std::int64_t y[ 3 ];
+
+	for( int i = 0; i < 3; ++i )
+	{
+		x[ i ] = ToFixed( primitive.Vertices[ i ].flX );
+		y[ i ] = ToFixed( primitive.Vertices[ i ].flY );
+	}
+
+	std::int64_t area = ( x[ 1 ] - x[ 0 ] ) * ( y[ 2 ] - y[ 0 ] ) - ( x[ 2 ] - x[ 0 ] ) * ( y[ 1 ] - y[ 0 ] );
+
+	//Degenerate triangles cover no pixels.
+	if( area == 0 )
+		return;
+
+	//Make the winding counter-clockwise so the edge functions are positive inside.
+	if( area < 0 )
+	{
+		std::swap( primitive.Vertices[ 1 ], primitive.Vertices[ 2 ] );
+		std::swap( x[ 1 ], x[ 2 ] );
+		std::swap( y[ 1 ], y[ 2 ] );
+		area = -area;
+	}
+
+	for( int i = 0; i < 3; ++i )
+	{
+		const int a = ( i + 1 ) % 3;
+		const int b = ( i + 2 ) % 3;
+
+		const std::int64_t dx = x[ b ] - x[ a ];
+		const std::int64_t dy = y[ b ] - y[ a ];
+
+		primitive.EdgeA[ i ] = -dy;
+		primitive.EdgeB[ i ] = dx;
+		primitive.EdgeC[ i ] = dy * x[ a ] - dx * y[ a ];
+
+		//Pixels exactly on an edge belong to the triangle if it is a left or top edge, so shared edges are only drawn once.
+		const bool bTopLeft = dy < 0 || ( dy == 0 && dx < 0 );
+
+		primitive.EdgeBias[ i ] = bTopLeft ? 0 : -1;
+	}
+
+	primitive.flInvArea = 1.0f / static_cast<float>( area );
+
+	//Attributes are interpolated divided by w, and multiplied by the interpolated w per pixel.
+	for( auto& vertex : primitive.Vertices )
+	{
+		vertex.TexCoord *= vertex.flInvW;
+		vertex.Color *= vertex.flInvW;
+	}
+
+	const float flMinX = std::min( { v0.flX, v1.flX, v2.flX } );
+	const float flMinY = std::min( { v0.flY, v1.flY, v2.flY } );
+	const float flMaxX = std::max( { v0.flX, v1.flX, v2.flX } );
+	const float flMaxY = std::max( { v0.flY, v1.flY, v2.flY } );
+
+	primitive.Bounds = Intersect( rect,
+		{
+			static_cast<int>( std::floor( flMinX ) ),
+			static_cast<int>( std::floor( flMinY ) ),
+			static_cast<int>( std::floor( flMaxX ) ),
+			static_cast<int>( std::floor( flMaxY ) )
+		} );
+
+	AddToTiles( std::move( primitive ) );
+}
+
+void CSoftwareRasterizer::AddLine( const WindowVertex& v0, const WindowVertex& v1, const Rect& rect )
+{
+	Primitive primitive{};
+
+	primitive.Type = PrimitiveType::LINE;
+	primitive.uiState = static_cast<std::uint32_t>( m_States.size() - 1 );
+	primitive.Vertices[ 0 ] = v0;
+	primitive.Vertices[ 1 ] = v1;
+
+	const float flLength = std::max( std::abs( v1.flX - v0.flX ), std::abs( v1.flY - v0.flY ) );
+
+	primitive.iSteps = std::max( 1, static_cast<int>( std::ceil( flLength ) ) );
+
+	for( int i = 0; i < 2; ++i )
+	{
+		auto& vertex = primitive.Vertices[ i ];
+
+		vertex.TexCoord *= vertex.flInvW;
+		vertex.Color *= vertex.flInvW;
+	}
+
+	primitive.Bounds = Intersect( rect,
+		{
+			static_cast<int>( std::floor( std::min( v0.flX, v1.flX ) ) ),
+			static_cast<int>( std::floor( std::min( v0.flY, v1.flY ) ) ),
+			static_cast<int>( std::floor( std::max( v0.flX, v1.flX ) ) ),
+			static_cast<int>( std::floor( std::max( v0.flY, v1.flY ) ) )
+		} );
+
+	AddToTiles( std::move( primitive ) );
+}
+
+void CSoftwareRasterizer::AddPoint( const WindowVertex& v, const Rect& rect )
+{
+	Primitive primitive{};
+
+	primitive.Type = PrimitiveType::POINT;
+	primitive.uiState = static_cast<std::uint32_t>( m_States.size() - 1 );
+	primitive.Vertices[ 0 ] = v;
+
+	const int iX = static_cast<int>( std::floor( v.flX ) );
+	const int iY = static_cast<int>( std::floor( v.flY ) );
+
+	primitive.Bounds = Intersect( rect, { iX, iY, iX, iY } );
+
+	AddToTiles( std::move( primitive ) );
+}
+
+void CSoftwareRasterizer::Resolve()
+{
+	if( m_Primitives.empty() )
+		return;
+
+	const int iNumTiles = m_iTilesX * m_iTilesY;
+
+	const unsigned int uiNumThreads = std::min( m_uiNumThreads, static_cast<unsigned int>( std::max( 1, iNumTiles ) ) );
+
+	std::atomic<int> nextTile{ 0 };
+
+	auto worker = [ & ]()
+	{
+		for( int iTile; ( iTile = nextTile++ ) < iNumTiles; )
+		{
+			RasterizeTile( iTile );
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	threads.reserve( uiNumThreads - 1 );
+
+	for( unsigned int thread = 1; thread < uiNumThreads; ++thread )
+	{
+		threads.emplace_back( worker );
+	}
+
+	worker();
+
+	for( auto& thread : threads )
+	{
+		thread.join();
+	}
+
+	for( const auto& primitive : m_Primitives )
+	{
+		if( primitive.Type != PrimitiveType::CLEAR )
+			++m_uiRasterizedCount;
+	}
+
+	m_Primitives.clear();
+
+	for( auto& bin : m_TileBins )
+	{
+		bin.clear();
+	}
+
+	//Primitives added after this still use the current state.
+	m_States.erase( m_States.begin(), m_States.end() - 1 );
+}
+
+void CSoftwareRasterizer::AddToTiles( Primitive&& primitive )
+{
+	primitive.Bounds = Intersect( primitive.Bounds, { 0, 0, m_iWidth - 1, m_iHeight - 1 } );
+
+	if( IsEmpty( primitive.Bounds ) )
+		return;
+
+	const auto uiIndex = static_cast<std::uint32_t>( m_Primitives.size() );
+
+	m_Primitives.push_back( primitive );
+
+	const int iMaxTileX = primitive.Bounds.iMaxX / TILE_SIZE;
+	const int iMaxTileY = primitive.Bounds.iMaxY / TILE_SIZE;
+
+	for( int iTileY = primitive.Bounds.iMinY / TILE_SIZE; iTileY <= iMaxTileY; ++iTileY )
+	{
+		for( int iTileX = primitive.Bounds.iMinX / TILE_SIZE; iTileX <= iMaxTileX; ++iTileX )
+		{
+			m_TileBins[ iTileY * m_iTilesX + iTileX ].push_back( uiIndex );
+		}
+	}
+}
+
+void CSoftwareRasterizer::RasterizeTile( const int iTile )
+{
+	const int iTileX = ( iTile % m_iTilesX ) * TILE_SIZE;
+	const int iTileY = ( iTile / m_iTilesX ) * TILE_SIZE;
+
+	const Rect tile
+	{
+		iTileX,
+		iTileY,
+		std::min( iTileX + TILE_SIZE, m_iWidth ) - 1,
+		std::min( iTileY + TILE_SIZE, m_iHeight ) - 1
+	};
+
+	for( const auto uiIndex : m_TileBins[ iTile ] )
+	{
+		const auto& primitive = m_Primitives[ uiIndex ];
+		const auto& state = m_States[ primitive.uiState ];
+
+		const auto bounds = Intersect( primitive.Bounds, tile );
+
+		switch( primitive.Type )
+		{
+		case PrimitiveType::CLEAR:
+			{
+				ClearTile( primitive, bounds );
+				break;
+			}
+
+		case PrimitiveType::TRIANGLE:
+			{
+				RasterizeTriangle( primitive, state, bounds );
+				break;
+			}
+
+		case PrimitiveType::LINE:
+			{
+				RasterizeLine( primitive, state, bounds );
+				break;
+			}
+
+		case PrimitiveType::POINT:
+			{
+				const auto& vertex = primitive.Vertices[ 0 ];
+
+				ShadeFragment( state, bounds.iMinX, bounds.iMinY, vertex.flZ, vertex.TexCoord, vertex.Color );
+				break;
+			}
+		}
+	}
+}
+
+void CSoftwareRasterizer::ClearTile( const Primitive& primitive, const Rect& tile )
+{
+	const byte color[ 4 ] =
+	{
+		ToByte( primitive.Vertices[ 0 ].Color.r ),
+		ToByte( primitive.Vertices[ 0 ].Color.g ),
+		ToByte( primitive.Vertices[ 0 ].Color.b ),
+		ToByte( primitive.Vertices[ 0 ].Color.a )
+	};
+
+	for( int iY = tile.iMinY; iY <= tile.iMaxY; ++iY )
+	{
+		const size_t uiRow = static_cast<size_t>( iY ) * m_iWidth;
+
+		if( primitive.bClearColor )
+		{
+			for( int iX = tile.iMinX; iX <= tile.iMaxX; ++iX )
+			{
+				std::copy( color, color + 4, &m_ColorBuffer[ ( uiRow + iX ) * 4 ] );
+			}
+		}
+
+		if( primitive.bClearDepth )
+		{
+			std::fill( &m_DepthBuffer[ uiRow + tile.iMinX ], &m_DepthBuffer[ uiRow + tile.iMaxX ] + 1, primitive.Vertices[ 0 ].flZ );
+		}
+	}
+}
+
+void CSoftwareRasterizer::RasterizeTriangle( const Primitive& primitive, const State& state, const Rect& tile )
+{
+	const auto& v0 = primitive.Vertices[ 0 ];
+	const auto& v1 = primitive.Vertices[ 1 ];
+	const auto& v2 = primitive.Vertices[ 2 ];
+
+	const std::int64_t iPixelSize = 1 << SUBPIXEL_BITS;
+	const std::int64_t iHalfPixel = iPixelSize / 2;
+
+	for( int iY = tile.iMinY; iY <= tile.iMaxY; ++iY )
+	{
+		const std::int64_t iCenterX = tile.iMinX * iPixelSize + iHalfPixel;
+		const std::int64_t iCenterY = iY * iPixelSize + iHalfPixel;
+
+		std::int64_t edges[ 3 ];
+
+		for( int i = 0; i < 3; ++i )
+		{
+			edges[ i ] = primitive.EdgeA[ i ] * iCenterX + primitive.EdgeB[ i ] * iCenterY + primitive.EdgeC[ i ];
+		}
+
+		for( int iX = tile.iMinX; iX <= tile.iMaxX; ++iX )
+		{
+			if( edges[ 0 ] + primitive.EdgeBias[ 0 ] >= 0
+				&& edges[ 1 ] + primitive.EdgeBias[ 1 ] >= 0
+				&& edges[ 2 ] + primitive.EdgeBias[ 2 ] >= 0 )
+			{
+				const float l0 = static_cast<float>( edges[ 0 ] ) * primitive.flInvArea;
+				const float l1 = static_cast<float>( edges[ 1 ] ) * primitive.flInvArea;
+				const float l2 = static_cast<float>( edges[ 2 ] ) * primitive.flInvArea;
+
+				const float flW = 1.0f / ( l0 * v0.flInvW + l1 * v1.flInvW + l2 * v2.flInvW );
+
+				const float flZ = l0 * v0.flZ + l1 * v1.flZ + l2 * v2.flZ;
+
+				const glm::vec2 texCoord = ( l0 * v0.TexCoord + l1 * v1.TexCoord + l2 * v2.TexCoord ) * flW;
+				const glm::vec4 color = ( l0 * v0.Color + l1 * v1.Color + l2 * v2.Color ) * flW;
+
+				ShadeFragment( state, iX, iY, flZ, texCoord, color );
+			}
+
+			for( int i = 0; i < 3; ++i )
+			{
+				edges[ i ] += primitive.EdgeA[ i ] * iPixelSize;
+			}
+		}
+	}
+}
+
+void CSoftwareRasterizer::RasterizeLine( const Primitive& primitive, const State& state, const Rect& tile )
+{
+	const auto& v0 = primitive.Vertices[ 0 ];
+	const auto& v1 = primitive.Vertices[ 1 ];
+
+	const float flDX = v1.flX - v0.flX;
+	const float flDY = v1.flY - v0.flY;
+
+	const int iSteps = primitive.iSteps;
+
+	//Only visit the steps whose major axis coordinate can be inside this tile. One step of slack covers rounding.
+	int iFirst = 0;
+	int iLast = iSteps - 1;
+
+	const bool bXMajor = std::abs( flDX ) >= std::abs( flDY );
+	const float flDelta = bXMajor ? flDX : flDY;
+
+	if( flDelta != 0 )
+	{
+		const float flStart = bXMajor ? v0.flX : v0.flY;
+		const float flMin = static_cast<float>( bXMajor ? tile.iMinX : tile.iMinY );
+		const float flMax = static_cast<float>( ( bXMajor ? tile.iMaxX : tile.iMaxY ) + 1 );
+
+		float flFirst = ( flMin - flStart ) * iSteps / flDelta;
+		float flLast = ( flMax - flStart ) * iSteps / flDelta;
+
+		if( flFirst > flLast )
+			std::swap( flFirst, flLast );
+
+		iFirst = std::max( iFirst, static_cast<int>( std::floor( flFirst ) ) - 1 );
+		iLast = std::min( iLast, static_cast<int>( std::ceil( flLast ) ) + 1 );
+	}
+
+	for( int iStep = iFirst; iStep <= iLast; ++iStep )
+	{
+		const float t = static_cast<float>( iStep ) / iSteps;
+
+		const int iX = static_cast<int>( std::floor( v0.flX + flDX * t ) );
+		const int iY = static_cast<int>( std::floor( v0.flY + flDY * t ) );
+
+		if( iX < tile.iMinX || iX > tile.iMaxX || iY < tile.iMinY || iY > tile.iMaxY )
+			continue;
+
+		const float flW = 1.0f / ( v0.flInvW + ( v1.flInvW - v0.flInvW ) * t );
+
+		const float flZ = v0.flZ + ( v1.flZ - v0.flZ ) * t;
+
+		const glm::vec2 texCoord = ( v0.TexCoord + ( v1.TexCoord - v0.TexCoord ) * t ) * flW;
+		const glm::vec4 color = ( v0.Color + ( v1.Color - v0.Color ) * t ) * flW;
+
+		ShadeFragment( state, iX, iY, flZ, texCoord, color );
+	}
+}
+
+void CSoftwareRasterizer::ShadeFragment( const State& state, const int iX, const int iY, const float flZ, const glm::vec2& texCoord, glm::vec4 color )
+{
+	const size_t uiPixel = static_cast<size_t>( iY ) * m_iWidth + iX;
+
+	if( state.bDepthTest && !Compare( state.DepthFunc, flZ, m_DepthBuffer[ uiPixel ] ) )
+		return;
+
+	if( state.pTexture )
+		color *= SampleTexture( *state.pTexture, texCoord );
+
+	if( !Compare( state.AlphaFunc, color.a, state.flAlphaRef ) )
+		return;
+
+	if( state.bDepthTest && state.bDepthWrite )
+		m_DepthBuffer[ uiPixel ] = flZ;
+
+	byte* pDest = &m_ColorBuffer[ uiPixel * 4 ];
+
+	if( state.bBlend )
+	{
+		const glm::vec4 dest{ pDest[ 0 ] / 255.0f, pDest[ 1 ] / 255.0f, pDest[ 2 ] / 255.0f, pDest[ 3 ] / 255.0f };
+
+		const float flSrcAlpha = std::clamp( color.a, 0.0f, 1.0f );
+
+		color = color * GetBlendFactor( state.BlendSrc, flSrcAlpha ) + dest * GetBlendFactor( state.BlendDst, flSrcAlpha );
+	}
+
+	pDest[ 0 ] = ToByte( color.r );
+	pDest[ 1 ] = ToByte( color.g );
+	pDest[ 2 ] = ToByte( color.b );
+	pDest[ 3 ] = ToByte( color.a );
+}
+
+glm::vec4 CSoftwareRasterizer::SampleTexture( const Texture& texture, const glm::vec2& texCoord )
+{
+	auto texel = [ & ]( const int iX, const int iY )
+	{
+		const byte* pTexel = &texture.Pixels[ ( static_cast<size_t>( Wrap( iY, texture.iHeight ) ) * texture.iWidth + Wrap( iX, texture.iWidth ) ) * 4 ];
+
+		return glm::vec4{ pTexel[ 0 ], pTexel[ 1 ], pTexel[ 2 ], pTexel[ 3 ] };
+	};
+
+	const float flU = texCoord.x * texture.iWidth;
+	const float flV = texCoord.y * texture.iHeight;
+
+	if( !texture.bLinear )
+	{
+		return texel( static_cast<int>( std::floor( flU ) ), static_cast<int>( std::floor( flV ) ) ) / 255.0f;
+	}
+
+	const float flX = std::floor( flU - 0.5f );
+	const float flY = std::floor( flV - 0.5f );
+
+	const float flFracX = flU - 0.5f - flX;
+	const float flFracY = flV - 0.5f - flY;
+
+	const int iX = static_cast<int>( flX );
+	const int iY = static_cast<int>( flY );
+
+	const glm::vec4 bottom = texel( iX, iY ) * ( 1 - flFracX ) + texel( iX + 1, iY ) * flFracX;
+	const glm::vec4 top = texel( iX, iY + 1 ) * ( 1 - flFracX ) + texel( iX + 1, iY + 1 ) * flFracX;
+
+	return ( bottom * ( 1 - flFracY ) + top * flFracY ) / 255.0f;
+}
+}
@@ -0,0 +1,241 @@
+#ifndef ENGINE_RENDERER_SOFTWARE_CSOFTWARERASTERIZER_H
+#define ENGINE_RENDERER_SOFTWARE_CSOFTWARERASTERIZER_H
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include "engine/shared/renderer/IRenderContext.h"
+
+namespace renderer
+{
+/**
+*	Rasterizes triangles, lines and points into a color and depth buffer.
+*	Primitives are binned into tiles as they are added, and the tiles are rasterized on all cores when the framebuffer is resolved.
+*	Each tile is rasterized by a single thread in the order that primitives were added, and every pixel is computed
+*	from its primitive's setup alone, so the result does not depend on the number of threads.
+*/
+class CSoftwareRasterizer final
+{
+public:
+	/**
+	*	Width and height of a tile, in pixels.
+	*/
+	static constexpr int TILE_SIZE = 64;
+
+	/**
+	*	Number of fractional bits in the fixed point coordinates used to set up triangles.
+	*/
+	static constexpr int SUBPIXEL_BITS = 8;
+
+	/**
+	*	RGBA8 texture.
+	*/
+	struct Texture
+	{
+		int iWidth = 0;
+		int iHeight = 0;
+
+		//RGBA, bottom row first.
+		std::vector<byte> Pixels;
+
+		bool bLinear = true;
+	};
+
+	/**
+	*	State that applies to a primitive when it is rasterized.
+	*/
+	struct State
+	{
+		//If null, the primitive is not textured.
+		const Texture* pTexture = nullptr;
+
+		bool bBlend = false;
+		BlendFactor BlendSrc = BlendFactor::ONE;
+		BlendFactor BlendDst = BlendFactor::ZERO;
+
+		bool bDepthTest = false;
+		CompareFunc DepthFunc = CompareFunc::LESS;
+		bool bDepthWrite = true;
+
+		//ALWAYS if the alpha test is disabled.
+		CompareFunc AlphaFunc = CompareFunc::ALWAYS;
+		float flAlphaRef = 0;
+	};
+
+	/**
+	*	Vertex in window coordinates.
+	*/
+	struct WindowVertex
+	{
+		//Pixel coordinates, with the origin at the bottom left of the framebuffer.
+		float flX;
+		float flY;
+
+		//Depth in the range [0, 1].
+		float flZ;
+
+		//1 / w of the clip space position, used to interpolate attributes with perspective correction.
+		float flInvW;
+
+		glm::vec2 TexCoord;
+		glm::vec4 Color;
+	};
+
+	/**
+	*	Inclusive pixel rectangle that a primitive may write to.
+	*/
+	struct Rect
+	{
+		int iMinX;
+		int iMinY;
+		int iMaxX;
+		int iMaxY;
+	};
+
+public:
+	/**
+	*	@param uiNumThreads Number of threads to rasterize with. 0 uses all cores.
+	*/
+	CSoftwareRasterizer( unsigned int uiNumThreads = 0 );
+	~CSoftwareRasterizer() = default;
+
+	int GetWidth() const { return m_iWidth; }
+	int GetHeight() const { return m_iHeight; }
+
+	unsigned int GetNumThreads() const { return m_uiNumThreads; }
+
+	/**
+	*	@param uiNumThreads Number of threads to rasterize with. 0 uses all cores.
+	*/
+	void SetNumThreads( const unsigned int uiNumThreads );
+
+	/**
+	*	Resizes the framebuffer. Pending primitives are rasterized first, the new contents are undefined.
+	*/
+	void Resize( const int iWidth, const int iHeight );
+
+	/**
+	*	@return Whether any primitives have not been rasterized yet.
+	*/
+	bool HasPendingPrimitives() const { return !m_Primitives.empty(); }
+
+	/**
+	*	Adds the state that primitives added after this use.
+	*	Any texture it references must not be changed or destroyed until the framebuffer has been resolved.
+	*/
+	void SetState( const State& state );
+
+	/**
+	*	Clears the whole framebuffer.
+	*/
+	void AddClear( const bool bColor, const glm::vec4& color, const bool bDepth, const float flDepth );
+
+	/**
+	*	Adds a triangle. Either winding order is accepted, culling is up to the caller.
+	*/
+	void AddTriangle( const WindowVertex& v0, const WindowVertex& v1, const WindowVertex& v2, const Rect& rect );
+
+	void AddLine( const WindowVertex& v0, const WindowVertex& v1, const Rect& rect );
+
+	void AddPoint( const WindowVertex& v, const Rect& rect );
+
+	/**
+	*	Rasterizes all pending primitives.
+	*/
+	void Resolve();
+
+	/**
+	*	@return RGBA color buffer, bottom row first. Only up to date after Resolve.
+	*/
+	const byte* GetColorBuffer() const { return m_ColorBuffer.data(); }
+
+	/**
+	*	@return Number of triangles, lines and points rasterized since the rasterizer was created.
+	*/
+	std::uint64_t GetRasterizedPrimitiveCount() const { return m_uiRasterizedCount; }
+
+private:
+	enum class PrimitiveType : std::uint8_t
+	{
+		CLEAR,
+		TRIANGLE,
+		LINE,
+		POINT
+	};
+
+	struct Primitive
+	{
+		PrimitiveType Type;
+
+		std::uint32_t uiState;
+
+		Rect Bounds;
+
+		WindowVertex Vertices[ 3 ];
+
+		//Triangles: edge functions E( x, y ) = A * x + B * y + C in fixed point, positive inside.
+		//Edge i is opposite vertex i. Bias is -1 for edges that do not own pixels exactly on them.
+		std::int64_t EdgeA[ 3 ];
+		std::int64_t EdgeB[ 3 ];
+		std::int64_t EdgeC[ 3 ];
+		std::int64_t EdgeBias[ 3 ];
+		float flInvArea;
+
+		//Lines: number of pixels along the major axis.
+		int iSteps;
+
+		//Clears: which buffers to clear.
+		bool bClearColor;
+		bool bClearDepth;
+	};
+
+	/**
+	*	Clips the primitive's bounds to the framebuffer and adds it to the bins of the tiles that they overlap.
+	*/
+	void AddToTiles( Primitive&& primitive );
+
+	void RasterizeTile( const int iTile );
+
+	void ClearTile( const Primitive& primitive, const Rect& tile );
+
+	void RasterizeTriangle( const Primitive& primitive, const State& state, const Rect& tile );
+
+	void RasterizeLine( const Primitive& primitive, const State& state, const Rect& tile );
+
+	/**
+	*	Runs the per pixel operations for a fragment and writes the result.
+	*/
+	void ShadeFragment( const State& state, const int iX, const int iY, const float flZ, const glm::vec2& texCoord, glm::vec4 color );
+
+	static glm::vec4 SampleTexture( const Texture& texture, const glm::vec2& texCoord );
+
+private:
+	unsigned int m_uiNumThreads = 1;
+
+	int m_iWidth = 0;
+	int m_iHeight = 0;
+
+	int m_iTilesX = 0;
+	int m_iTilesY = 0;
+
+	std::vector<byte> m_ColorBuffer;
+	std::vector<float> m_DepthBuffer;
+
+	std::vector<State> m_States;
+	std::vector<Primitive> m_Primitives;
+
+	//Indices of the primitives that overlap each tile, in the order they were added.
+	std::vector<std::vector<std::uint32_t>> m_TileBins;
+
+	std::uint64_t m_uiRasterizedCount = 0;
+
+private:
+	CSoftwareRasterizer( const CSoftwareRasterizer& ) = delete;
+	CSoftwareRasterizer& operator=( const CSoftwareRasterizer& ) = delete;
+};
+}
+
+#endif //ENGINE_RENDERER_SOFTWARE_CSOFTWARERASTERIZER_H
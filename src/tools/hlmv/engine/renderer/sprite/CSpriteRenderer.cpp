@@ -9,6 +9,8 @@
 
 #include "shared/CWorldTime.h"
 
+#include "engine/renderer/gl/CBaseGLRenderContext.h"
+
 #include "engine/shared/renderer/sprite/CSpriteRenderInfo.h"
 
 #include "engine/shared/sprite/sprite.h"
@@ -19,7 +21,8 @@ namespace sprite
 {
 const float CSpriteRenderer::DEFAULT_FRAMERATE = 10;
 
-CSpriteRenderer::CSpriteRenderer()
+CSpriteRenderer::CSpriteRenderer( renderer::IRenderContext* pRenderContext )
+	: m_pRenderContext( pRenderContext )
 {
 }
 
@@ -170,9 +173,9 @@ void CSpriteRenderer::DrawSprite( const glm::vec3& vecOrigin, const glm::vec2& v
 		pFrame = pGroup->frames[ iIndex ];
 	}
 
-	glEnable( GL_TEXTURE_2D );
-	glColor4f( 1.0f, 1.0f, 1.0f, 1.0f );
-	glBindTexture( GL_TEXTURE_2D, pFrame->gl_texturenum );
+	m_pRenderContext->Enable( renderer::Capability::TEXTURE_2D );
+	m_pRenderContext->SetColor( 1.0f, 1.0f, 1.0f, 1.0f );
+	m_pRenderContext->BindTexture( renderer::GLToTexHandle( pFrame->gl_texturenum ) );
 
 	//TODO: set up the sprite's orientation in the world according to its type.
 	//TODO: the size of the sprite should change based on its distance from the viewer.
@@ -185,83 +188,78 @@ void CSpriteRenderer::DrawSprite( const glm::vec3& vecOrigin, const glm::vec2& v
 	case TexFormat::SPR_NORMAL:
 		{
 			glTexEnvi( GL_TEXTURE_2D, GL_TEXTURE_ENV_MODE, GL_MODULATE );
-			glDisable( GL_BLEND );
+			m_pRenderContext->Disable( renderer::Capability::BLEND );
 			break;
 		}
 
 	case TexFormat::SPR_ADDITIVE:
 		{
-			glEnable( GL_BLEND );
-			glBlendFunc( GL_SRC_ALPHA, GL_ONE );
+			m_pRenderContext->Enable( renderer::Capability::BLEND );
+			m_pRenderContext->SetBlendFunc( renderer::BlendFactor::SRC_ALPHA, renderer::BlendFactor::ONE );
 			break;
 		}
 
 	case TexFormat::SPR_INDEXALPHA:
 	case TexFormat::SPR_ALPHTEST:
 		{
-			glEnable( GL_BLEND );
-			glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+			m_pRenderContext->Enable( renderer::Capability::BLEND );
+			m_pRenderContext->SetBlendFunc( renderer::BlendFactor::SRC_ALPHA, renderer::BlendFactor::ONE_MINUS_SRC_ALPHA );
 			break;
 		}
 	}
 
 	if( texFormat == TexFormat::SPR_ALPHTEST )
 	{
-		glEnable( GL_ALPHA_TEST );
-		glAlphaFunc( GL_GREATER, 0.0f );
+		m_pRenderContext->Enable( renderer::Capability::ALPHA_TEST );
+		m_pRenderContext->SetAlphaFunc( renderer::CompareFunc::GREATER, 0.0f );
 	}
 	else
 	{
-		glDisable( GL_ALPHA_TEST );
+		m_pRenderContext->Disable( renderer::Capability::ALPHA_TEST );
 	}
 
 	const glm::vec4 vecRect{ vecOrigin.x - vecSize.x / 2, vecOrigin.y - vecSize.y / 2, vecOrigin.x + vecSize.x / 2, vecOrigin.y + vecSize.y / 2 };
 
-	if( !( flags & renderer::DrawFlag::NODRAW ) )
+	const glm::vec3 corners[] =
 	{
-		glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
-		glEnable( GL_TEXTURE_2D );
-		glEnable( GL_CULL_FACE );
-		glEnable( GL_DEPTH_TEST );
-		glShadeModel( GL_SMOOTH );
-		glColor4f( 1, 1, 1, 1 );
-
-		glBegin( GL_TRIANGLE_STRIP );
-
-		glTexCoord2f( 0, 0 );
-		glVertex3f( vecRect.x, vecRect.y, vecOrigin.z );
+		{ vecRect.x, vecRect.y, vecOrigin.z },
+		{ vecRect.z, vecRect.y, vecOrigin.z },
+		{ vecRect.x, vecRect.w, vecOrigin.z },
+		{ vecRect.z, vecRect.w, vecOrigin.z }
+	};
 
-		glTexCoord2f( 1, 0 );
-		glVertex3f( vecRect.z, vecRect.y, vecOrigin.z );
-
-		glTexCoord2f( 0, 1 );
-		glVertex3f( vecRect.x, vecRect.w, vecOrigin.z );
+	if( !( flags & renderer::DrawFlag::NODRAW ) )
+	{
+		m_pRenderContext->SetPolygonMode( renderer::PolygonMode::FILL );
+		m_pRenderContext->Enable( renderer::Capability::TEXTURE_2D );
+		m_pRenderContext->Enable( renderer::Capability::CULL_FACE );
+		m_pRenderContext->Enable( renderer::Capability::DEPTH_TEST );
+		m_pRenderContext->SetShadeModel( renderer::ShadeModel::SMOOTH );
 
-		glTexCoord2f( 1, 1 );
-		glVertex3f( vecRect.z, vecRect.w, vecOrigin.z );
+		const glm::vec4 white{ 1, 1, 1, 1 };
 
-		glEnd();
+		const renderer::Vertex vertices[] =
+		{
+			{ corners[ 0 ], { 0, 0 }, white },
+			{ corners[ 1 ], { 1, 0 }, white },
+			{ corners[ 2 ], { 0, 1 }, white },
+			{ corners[ 3 ], { 1, 1 }, white }
+		};
+
+		m_pRenderContext->DrawVertices( renderer::PrimitiveType::TRIANGLE_STRIP, vertices, ARRAYSIZE( vertices ) );
+		m_pRenderContext->Flush();
 	}
 
 	if( flags & renderer::DrawFlag::WIREFRAME_OVERLAY )
 	{
-		glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
-		glDisable( GL_TEXTURE_2D );
-		glDisable( GL_CULL_FACE );
-		glDisable( GL_DEPTH_TEST );
-		glColor4f( 1, 1, 1, 1 );
-
-		glBegin( GL_TRIANGLE_STRIP );
-
-		glVertex3f( vecRect.x, vecRect.y, vecOrigin.z );
-
-		glVertex3f( vecRect.z, vecRect.y, vecOrigin.z );
-
-		glVertex3f( vecRect.x, vecRect.w, vecOrigin.z );
-
-		glVertex3f( vecRect.z, vecRect.w, vecOrigin.z );
-
-		glEnd();
+		m_pRenderContext->SetPolygonMode( renderer::PolygonMode::LINE );
+		m_pRenderContext->Disable( renderer::Capability::TEXTURE_2D );
+		m_pRenderContext->Disable( renderer::Capability::CULL_FACE );
+		m_pRenderContext->Disable( renderer::Capability::DEPTH_TEST );
+		m_pRenderContext->SetColor( 1, 1, 1, 1 );
+
+		m_pRenderContext->DrawPositions( renderer::PrimitiveType::TRIANGLE_STRIP, corners, nullptr, ARRAYSIZE( corners ) );
+		m_pRenderContext->Flush();
 	}
 }
 }
\ No newline at end of file
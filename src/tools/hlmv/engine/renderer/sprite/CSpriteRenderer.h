@@ -5,6 +5,7 @@
 #include <glm/vec3.hpp>
 
 #include "engine/shared/renderer/DrawConstants.h"
+#include "engine/shared/renderer/IRenderContext.h"
 
 #include "engine/shared/renderer/sprite/ISpriteRenderer.h"
 
@@ -18,7 +19,10 @@ private:
 	static const float DEFAULT_FRAMERATE;
 
 public:
-	CSpriteRenderer();
+	/**
+	*	@param pRenderContext Context that state changes are made through.
+	*/
+	CSpriteRenderer( renderer::IRenderContext* pRenderContext );
 	~CSpriteRenderer();
 
 	void DrawSprite( const CSpriteRenderInfo* pRenderInfo, const renderer::DrawFlags_t flags ) override;
@@ -35,6 +39,9 @@ private:
 					 const msprite_t* pSprite, const float flFrame, 
 					 const renderer::DrawFlags_t flags, const sprite::Type::Type* pTypeOverride = nullptr, const sprite::TexFormat::TexFormat* pTexFormatOverride = nullptr );
 
+private:
+	renderer::IRenderContext* const m_pRenderContext;
+
 private:
 	CSpriteRenderer( const CSpriteRenderer& ) = delete;
 	CSpriteRenderer& operator=( const CSpriteRenderer& ) = delete;
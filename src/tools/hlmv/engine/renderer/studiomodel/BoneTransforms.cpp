@@ -0,0 +1,267 @@
+#include <algorithm>
+
+#include "utility/mathlib.h"
+
+#include "BoneTransforms.h"
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#define BONE_TRANSFORMS_SSE
+#include <xmmintrin.h>
+#endif
+
+#ifdef __AVX__
+#define BONE_TRANSFORMS_AVX
+#include <immintrin.h>
+#endif
+
+namespace studiomdl
+{
+//Kernels read and write matrices as 3 rows of 4 floats
+static_assert( sizeof( glm::mat3x4 ) == sizeof( float ) * 12, "glm::mat3x4 must be tightly packed" );
+
+void BonePose::Load( const glm::vec3* pPositions, const glm::vec4* pQuaternions, const int numBones )
+{
+	NumBones = numBones;
+
+	for( int i = 0; i < numBones; ++i )
+	{
+		QuatX[ i ] = pQuaternions[ i ].x;
+		QuatY[ i ] = pQuaternions[ i ].y;
+		QuatZ[ i ] = pQuaternions[ i ].z;
+		QuatW[ i ] = pQuaternions[ i ].w;
+
+		PosX[ i ] = pPositions[ i ].x;
+		PosY[ i ] = pPositions[ i ].y;
+		PosZ[ i ] = pPositions[ i ].z;
+	}
+
+	//Pad the last batch with identity transforms so kernels never read uninitialized lanes
+	const int paddedBones = std::min( static_cast<int>( MAXSTUDIOBONES ), ( numBones + LANES - 1 ) / LANES * LANES );
+
+	for( int i = numBones; i < paddedBones; ++i )
+	{
+		QuatX[ i ] = QuatY[ i ] = QuatZ[ i ] = 0;
+		QuatW[ i ] = 1;
+		PosX[ i ] = PosY[ i ] = PosZ[ i ] = 0;
+	}
+}
+
+#ifdef BONE_TRANSFORMS_SSE
+namespace
+{
+/**
+*	@brief Transposes 4 bones worth of matrix elements into 4 matrices
+*	Each row register holds one element for 4 consecutive bones.
+*	@param count Number of matrices to write, at most 4
+*/
+void StoreMatrices( __m128 row0[ 4 ], __m128 row1[ 4 ], __m128 row2[ 4 ], glm::mat3x4* pOut, const int count )
+{
+	_MM_TRANSPOSE4_PS( row0[ 0 ], row0[ 1 ], row0[ 2 ], row0[ 3 ] );
+	_MM_TRANSPOSE4_PS( row1[ 0 ], row1[ 1 ], row1[ 2 ], row1[ 3 ] );
+	_MM_TRANSPOSE4_PS( row2[ 0 ], row2[ 1 ], row2[ 2 ], row2[ 3 ] );
+
+	for( int bone = 0; bone < count; ++bone )
+	{
+		float* const pMatrix = &pOut[ bone ][ 0 ][ 0 ];
+
+		_mm_storeu_ps( pMatrix, row0[ bone ] );
+		_mm_storeu_ps( pMatrix + 4, row1[ bone ] );
+		_mm_storeu_ps( pMatrix + 8, row2[ bone ] );
+	}
+}
+}
+#endif
+
+void QuaternionMatrices( const BonePose& pose, glm::mat3x4* pOut )
+{
+#ifdef BONE_TRANSFORMS_AVX
+	const __m256 one8 = _mm256_set1_ps( 1 );
+
+	for( int i = 0; i < pose.NumBones; i += 8 )
+	{
+		const __m256 x = _mm256_load_ps( pose.QuatX + i );
+		const __m256 y = _mm256_load_ps( pose.QuatY + i );
+		const __m256 z = _mm256_load_ps( pose.QuatZ + i );
+		const __m256 w = _mm256_load_ps( pose.QuatW + i );
+
+		const __m256 x2 = _mm256_add_ps( x, x );
+		const __m256 y2 = _mm256_add_ps( y, y );
+		const __m256 z2 = _mm256_add_ps( z, z );
+
+		const __m256 xx = _mm256_mul_ps( x, x2 );
+		const __m256 yy = _mm256_mul_ps( y, y2 );
+		const __m256 zz = _mm256_mul_ps( z, z2 );
+		const __m256 xy = _mm256_mul_ps( x, y2 );
+		const __m256 xz = _mm256_mul_ps( x, z2 );
+		const __m256 yz = _mm256_mul_ps( y, z2 );
+		const __m256 wx = _mm256_mul_ps( w, x2 );
+		const __m256 wy = _mm256_mul_ps( w, y2 );
+		const __m256 wz = _mm256_mul_ps( w, z2 );
+
+		const __m256 elements[ 3 ][ 4 ] =
+		{
+			{
+				_mm256_sub_ps( _mm256_sub_ps( one8, yy ), zz ),
+				_mm256_sub_ps( xy, wz ),
+				_mm256_add_ps( xz, wy ),
+				_mm256_load_ps( pose.PosX + i )
+			},
+			{
+				_mm256_add_ps( xy, wz ),
+				_mm256_sub_ps( _mm256_sub_ps( one8, xx ), zz ),
+				_mm256_sub_ps( yz, wx ),
+				_mm256_load_ps( pose.PosY + i )
+			},
+			{
+				_mm256_sub_ps( xz, wy ),
+				_mm256_add_ps( yz, wx ),
+				_mm256_sub_ps( _mm256_sub_ps( one8, xx ), yy ),
+				_mm256_load_ps( pose.PosZ + i )
+			}
+		};
+
+		//Store each half of the batch as 4 bones
+		for( int half = 0; half < 2; ++half )
+		{
+			const int first = i + half * 4;
+
+			if( first >= pose.NumBones )
+			{
+				break;
+			}
+
+			__m128 rows[ 3 ][ 4 ];
+
+			for( int row = 0; row < 3; ++row )
+			{
+				for( int column = 0; column < 4; ++column )
+				{
+					rows[ row ][ column ] = half ? _mm256_extractf128_ps( elements[ row ][ column ], 1 ) : _mm256_castps256_ps128( elements[ row ][ column ] );
+				}
+			}
+
+			StoreMatrices( rows[ 0 ], rows[ 1 ], rows[ 2 ], pOut + first, std::min( 4, pose.NumBones - first ) );
+		}
+	}
+#elif defined( BONE_TRANSFORMS_SSE )
+	const __m128 one = _mm_set1_ps( 1 );
+
+	for( int i = 0; i < pose.NumBones; i += 4 )
+	{
+		const __m128 x = _mm_load_ps( pose.QuatX + i );
+		const __m128 y = _mm_load_ps( pose.QuatY + i );
+		const __m128 z = _mm_load_ps( pose.QuatZ + i );
+		const __m128 w = _mm_load_ps( pose.QuatW + i );
+
+		const __m128 x2 = _mm_add_ps( x, x );
+		const __m128 y2 = _mm_add_ps( y, y );
+		const __m128 z2 = _mm_add_ps( z, z );
+
+		const __m128 xx = _mm_mul_ps( x, x2 );
+		const __m128 yy = _mm_mul_ps( y, y2 );
+		const __m128 zz = _mm_mul_ps( z, z2 );
+		const __m128 xy = _mm_mul_ps( x, y2 );
+		const __m128 xz = _mm_mul_ps( x, z2 );
+		const __m128 yz = _mm_mul_ps( y, z2 );
+		const __m128 wx = _mm_mul_ps( w, x2 );
+		const __m128 wy = _mm_mul_ps( w, y2 );
+		const __m128 wz = _mm_mul_ps( w, z2 );
+
+		__m128 row0[ 4 ] =
+		{
+			_mm_sub_ps( _mm_sub_ps( one, yy ), zz ),
+			_mm_sub_ps( xy, wz ),
+			_mm_add_ps( xz, wy ),
+			_mm_load_ps( pose.PosX + i )
+		};
+
+		__m128 row1[ 4 ] =
+		{
+			_mm_add_ps( xy, wz ),
+			_mm_sub_ps( _mm_sub_ps( one, xx ), zz ),
+			_mm_sub_ps( yz, wx ),
+			_mm_load_ps( pose.PosY + i )
+		};
+
+		__m128 row2[ 4 ] =
+		{
+			_mm_sub_ps( xz, wy ),
+			_mm_add_ps( yz, wx ),
+			_mm_sub_ps( _mm_sub_ps( one, xx ), yy ),
+			_mm_load_ps( pose.PosZ + i )
+		};
+
+		StoreMatrices( row0, row1, row2, pOut + i, std::min( 4, pose.NumBones - i ) );
+	}
+#else
+	QuaternionMatricesReference( pose, pOut );
+#endif
+}
+
+void QuaternionMatricesReference( const BonePose& pose, glm::mat3x4* pOut )
+{
+	for( int i = 0; i < pose.NumBones; ++i )
+	{
+		QuaternionMatrix( glm::vec4{ pose.QuatX[ i ], pose.QuatY[ i ], pose.QuatZ[ i ], pose.QuatW[ i ] }, pOut[ i ] );
+
+		pOut[ i ][ 0 ][ 3 ] = pose.PosX[ i ];
+		pOut[ i ][ 1 ][ 3 ] = pose.PosY[ i ];
+		pOut[ i ][ 2 ][ 3 ] = pose.PosZ[ i ];
+	}
+}
+
+void ConcatenateBoneTransforms( const mstudiobone_t* pBones, const glm::mat3x4* pLocal, const int numBones, glm::mat3x4* pOut )
+{
+#ifdef BONE_TRANSFORMS_SSE
+	//Keeps only the translation column of a parent row
+	const __m128 translationMask = _mm_cmpeq_ps( _mm_setr_ps( 0, 0, 0, 1 ), _mm_set1_ps( 1 ) );
+
+	for( int i = 0; i < numBones; ++i )
+	{
+		if( pBones[ i ].parent == -1 )
+		{
+			pOut[ i ] = pLocal[ i ];
+			continue;
+		}
+
+		const float* const pParent = &pOut[ pBones[ i ].parent ][ 0 ][ 0 ];
+		const float* const pChild = &pLocal[ i ][ 0 ][ 0 ];
+		float* const pResult = &pOut[ i ][ 0 ][ 0 ];
+
+		const __m128 child0 = _mm_loadu_ps( pChild );
+		const __m128 child1 = _mm_loadu_ps( pChild + 4 );
+		const __m128 child2 = _mm_loadu_ps( pChild + 8 );
+
+		//Each result row is the parent row's rotation applied to the child rows, plus the parent's translation
+		for( int row = 0; row < 3; ++row )
+		{
+			const __m128 parent = _mm_loadu_ps( pParent + row * 4 );
+
+			__m128 result = _mm_mul_ps( _mm_shuffle_ps( parent, parent, _MM_SHUFFLE( 0, 0, 0, 0 ) ), child0 );
+			result = _mm_add_ps( result, _mm_mul_ps( _mm_shuffle_ps( parent, parent, _MM_SHUFFLE( 1, 1, 1, 1 ) ), child1 ) );
+			result = _mm_add_ps( result, _mm_mul_ps( _mm_shuffle_ps( parent, parent, _MM_SHUFFLE( 2, 2, 2, 2 ) ), child2 ) );
+			result = _mm_add_ps( result, _mm_and_ps( parent, translationMask ) );
+
+			_mm_storeu_ps( pResult + row * 4, result );
+		}
+	}
+#else
+	ConcatenateBoneTransformsReference( pBones, pLocal, numBones, pOut );
+#endif
+}
+
+void ConcatenateBoneTransformsReference( const mstudiobone_t* pBones, const glm::mat3x4* pLocal, const int numBones, glm::mat3x4* pOut )
+{
+	for( int i = 0; i < numBones; ++i )
+	{
+		if( pBones[ i ].parent == -1 )
+		{
+			pOut[ i ] = pLocal[ i ];
+		}
+		else
+		{
+			R_ConcatTransforms( pOut[ pBones[ i ].parent ], pLocal[ i ], pOut[ i ] );
+		}
+	}
+}
+}
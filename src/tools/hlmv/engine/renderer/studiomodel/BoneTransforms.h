@@ -0,0 +1,72 @@
+#ifndef GAME_STUDIOMODEL_BONETRANSFORMS_H
+#define GAME_STUDIOMODEL_BONETRANSFORMS_H
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat3x4.hpp>
+
+#include "shared/studiomodel/studio.h"
+
+namespace studiomdl
+{
+/**
+*	@brief Bone positions and rotations in structure-of-arrays layout, so kernels can work on several bones per instruction
+*	Bones past NumBones up to the next multiple of LANES are kept as identity transforms.
+*/
+struct BonePose
+{
+	/**
+	*	Widest batch of bones a kernel processes at once.
+	*/
+	static const int LANES = 8;
+
+	static_assert( MAXSTUDIOBONES % LANES == 0, "Bone arrays must be a multiple of the widest batch" );
+
+	int NumBones = 0;
+
+	alignas( 32 ) float QuatX[ MAXSTUDIOBONES ];
+	alignas( 32 ) float QuatY[ MAXSTUDIOBONES ];
+	alignas( 32 ) float QuatZ[ MAXSTUDIOBONES ];
+	alignas( 32 ) float QuatW[ MAXSTUDIOBONES ];
+
+	alignas( 32 ) float PosX[ MAXSTUDIOBONES ];
+	alignas( 32 ) float PosY[ MAXSTUDIOBONES ];
+	alignas( 32 ) float PosZ[ MAXSTUDIOBONES ];
+
+	/**
+	*	@brief Converts positions and quaternions as produced by CalcBlendedBones
+	*/
+	void Load( const glm::vec3* pPositions, const glm::vec4* pQuaternions, const int numBones );
+};
+
+/**
+*	@brief Converts the rotations and positions of a pose to bone-local matrices
+*	Uses AVX (8 bones) or SSE (4 bones) when the compiler targets them.
+*	@param pose Pose to convert
+*	@param pOut Receives pose.NumBones matrices
+*/
+void QuaternionMatrices( const BonePose& pose, glm::mat3x4* pOut );
+
+/**
+*	@brief Scalar version of QuaternionMatrices, using QuaternionMatrix. Used to validate the vectorized kernels
+*/
+void QuaternionMatricesReference( const BonePose& pose, glm::mat3x4* pOut );
+
+/**
+*	@brief Concatenates bone-local matrices with their parents, in bone order
+*	Parents always precede their children, so each bone can use its parent's final transform.
+*	Each row is computed 4 columns at a time when the compiler targets SSE.
+*	@param pBones Bones, used for their parents
+*	@param pLocal Bone-local matrices
+*	@param numBones Number of bones
+*	@param pOut Receives numBones model space transforms. Must not overlap pLocal
+*/
+void ConcatenateBoneTransforms( const mstudiobone_t* pBones, const glm::mat3x4* pLocal, const int numBones, glm::mat3x4* pOut );
+
+/**
+*	@brief Scalar version of ConcatenateBoneTransforms, using R_ConcatTransforms. Used to validate the vectorized kernel
+*/
+void ConcatenateBoneTransformsReference( const mstudiobone_t* pBones, const glm::mat3x4* pLocal, const int numBones, glm::mat3x4* pOut );
+}
+
+#endif //GAME_STUDIOMODEL_BONETRANSFORMS_H
@@ -1,7 +1,11 @@
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 #include <algorithm>
+#include <cstring>
 
+#include "shared/CProfiler.h"
 #include "shared/Logging.h"
 
 #include "cvar/CCVar.h"
@@ -9,10 +13,16 @@
 
 #include "graphics/GraphicsUtils.h"
 
+#include "engine/renderer/gl/CBaseGLRenderContext.h"
+
 #include "shared/studiomodel/CStudioModel.h"
+#include "shared/studiomodel/CStudioModelPose.h"
+#include "shared/studiomodel/StudioAnimation.h"
 #include "shared/renderer/studiomodel/IStudioModelRendererListener.h"
 
+#include "BoneTransforms.h"
 #include "CStudioModelRenderer.h"
+#include "ShadowProjection.h"
 
 //Double to float conversion
 #pragma warning( disable: 4244 )
@@ -30,7 +40,8 @@ DEFINE_COLOR_CVAR( , r_wireframecolor, 255, 0, 0, "Wireframe overlay color", cva
 
 namespace studiomdl
 {
-CStudioModelRenderer::CStudioModelRenderer()
+CStudioModelRenderer::CStudioModelRenderer( renderer::IRenderContext* pRenderContext )
+	: m_pRenderContext( pRenderContext )
 {
 }
 
@@ -42,8 +53,13 @@ bool CStudioModelRenderer::Initialize()
 {
 	m_uiModelsDrawnCount = 0;
 
+	//Chrome vectors are recomputed when their age differs from the draw count, so they must start out older than any draw
+	memset( m_chromeage, 0, sizeof( m_chromeage ) );
+
 	m_uiDrawnPolygonsCount = 0;
 
+	m_uiSkinnedSubModelsCount = 0;
+
 	return true;
 }
 
@@ -53,6 +69,20 @@ void CStudioModelRenderer::Shutdown()
 
 void CStudioModelRenderer::RunFrame()
 {
+	//Model data can change between frames without affecting the render inputs, so never reuse poses across frames
+	++m_uiFrameSerial;
+}
+
+void CStudioModelRenderer::PrepareModel( studiomdl::CModelRenderInfo* const pRenderInfo )
+{
+	m_pRenderInfo = pRenderInfo;
+
+	m_pStudioHdr = pRenderInfo->pModel->GetStudioHeader();
+	m_pTextureHdr = pRenderInfo->pModel->GetTextureHeader();
+
+	m_pxformverts = &m_xformverts[ 0 ];
+	m_pvlightvalues = &m_lightvalues[ 0 ];
+	m_pchrome = &m_chrome[ 0 ];
 }
 
 unsigned int CStudioModelRenderer::DrawModel( studiomdl::CModelRenderInfo* const pRenderInfo, const renderer::DrawFlags_t flags )
@@ -63,29 +93,19 @@ unsigned int CStudioModelRenderer::DrawModel( studiomdl::CModelRenderInfo* const
 		return 0;
 	}
 
-	m_pRenderInfo = pRenderInfo;
-
-	if( pRenderInfo->pModel )
-	{
-		m_pStudioHdr = pRenderInfo->pModel->GetStudioHeader();
-		m_pTextureHdr = pRenderInfo->pModel->GetTextureHeader();
-	}
-	else
+	if( !pRenderInfo->pModel )
 	{
 		Error( "CStudioModelRenderer::DrawModel: Called with null model!\n" );
 		return 0;
 	}
 
-	++m_uiModelsDrawnCount; // render data cache cookie
+	PrepareModel( pRenderInfo );
 
-	m_pxformverts = &m_xformverts[ 0 ];
-	m_pvlightvalues = &m_lightvalues[ 0 ];
+	++m_uiModelsDrawnCount; // render data cache cookie
 
 	if( m_pStudioHdr->numbodyparts == 0 )
 		return 0;
 
-	glPushMatrix();
-
 	auto origin = m_pRenderInfo->vecOrigin;
 
 	//The game applies a 1 unit offset to make view models look nicer
@@ -95,18 +115,33 @@ unsigned int CStudioModelRenderer::DrawModel( studiomdl::CModelRenderInfo* const
 		origin.z -= 1;
 	}
 
-	glTranslatef( origin[ 0 ], origin[ 1 ], origin[ 2 ] );
+	//Goes through the render context so contexts that do their own vertex processing see it.
+	Mat4x4 entityMatrix = glm::translate( Mat4x4{ 1.0f }, origin );
 
-	glRotatef( m_pRenderInfo->vecAngles[ 1 ], 0, 0, 1 );
-	glRotatef( m_pRenderInfo->vecAngles[ 0 ], 0, 1, 0 );
-	glRotatef( m_pRenderInfo->vecAngles[ 2 ], 1, 0, 0 );
+	entityMatrix = glm::rotate( entityMatrix, glm::radians( m_pRenderInfo->vecAngles[ 1 ] ), glm::vec3{ 0, 0, 1 } );
+	entityMatrix = glm::rotate( entityMatrix, glm::radians( m_pRenderInfo->vecAngles[ 0 ] ), glm::vec3{ 0, 1, 0 } );
+	entityMatrix = glm::rotate( entityMatrix, glm::radians( m_pRenderInfo->vecAngles[ 2 ] ), glm::vec3{ 1, 0, 0 } );
 
-	glScalef( m_pRenderInfo->vecScale.x, m_pRenderInfo->vecScale.y, m_pRenderInfo->vecScale.z );
+	entityMatrix = glm::scale( entityMatrix, m_pRenderInfo->vecScale );
 
-	SetUpBones();
+	m_pRenderContext->MatrixMode( renderer::MatrixMode::MODEL );
+	m_pRenderContext->PushMatrix();
+	m_pRenderContext->MultMatrix( entityMatrix );
 
 	SetupLighting();
 
+	//The passes and the mirrored draw of a frame draw the same pose, only evaluate its bones once
+	if( UpdateRenderPose() )
+	{
+		SetUpBones();
+
+		memcpy( m_RenderPose.boneTransforms, m_bonetransform, sizeof( glm::mat3x4 ) * m_pStudioHdr->numbones );
+	}
+	else
+	{
+		memcpy( m_bonetransform, m_RenderPose.boneTransforms, sizeof( glm::mat3x4 ) * m_pStudioHdr->numbones );
+	}
+
 	unsigned int uiDrawnPolys = 0;
 
 	if( m_pListener )
@@ -121,11 +156,11 @@ unsigned int CStudioModelRenderer::DrawModel( studiomdl::CModelRenderInfo* const
 			SetupModel( i );
 			if (m_pRenderInfo->flTransparency > 0.0f)
 			{
-				uiDrawnPolys += DrawPoints(false);
+				uiDrawnPolys += DrawPoints(i, false);
 
 				if (flags & renderer::DrawFlag::DRAW_SHADOWS)
 				{
-					uiDrawnPolys += DrawShadows(fixShadowZFighting, false);
+					uiDrawnPolys += DrawShadows(i, fixShadowZFighting, false);
 				}
 			}
 		}
@@ -134,21 +169,21 @@ unsigned int CStudioModelRenderer::DrawModel( studiomdl::CModelRenderInfo* const
 	if( flags & renderer::DrawFlag::WIREFRAME_OVERLAY )
 	{
 		//TODO: restore render mode after this? - Solokiller
-		glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
-		glDisable( GL_TEXTURE_2D );
-		glDisable( GL_CULL_FACE );
-		glEnable( GL_DEPTH_TEST );
+		m_pRenderContext->SetPolygonMode( renderer::PolygonMode::LINE );
+		m_pRenderContext->Disable( renderer::Capability::TEXTURE_2D );
+		m_pRenderContext->Disable( renderer::Capability::CULL_FACE );
+		m_pRenderContext->Enable( renderer::Capability::DEPTH_TEST );
 
 		for( int i = 0; i < m_pStudioHdr->numbodyparts; i++ )
 		{
 			SetupModel( i );
 			if (m_pRenderInfo->flTransparency > 0.0f)
 			{
-				uiDrawnPolys += DrawPoints(true);
+				uiDrawnPolys += DrawPoints(i, true);
 
 				if (flags & renderer::DrawFlag::DRAW_SHADOWS)
 				{
-					uiDrawnPolys += DrawShadows(fixShadowZFighting, true);
+					uiDrawnPolys += DrawShadows(i, fixShadowZFighting, true);
 				}
 			}
 		}
@@ -184,7 +219,7 @@ unsigned int CStudioModelRenderer::DrawModel( studiomdl::CModelRenderInfo* const
 	if( m_pListener )
 		m_pListener->OnPostDraw( *this, *m_pRenderInfo );
 
-	glPopMatrix();
+	m_pRenderContext->PopMatrix();
 
 	m_uiDrawnPolygonsCount += uiDrawnPolys;
 
@@ -197,19 +232,19 @@ void CStudioModelRenderer::DrawSingleBone( const int iBone )
 		return;
 
 	const mstudiobone_t* const pbones = m_pStudioHdr->GetBones();
-	glDisable( GL_TEXTURE_2D );
-	glDisable( GL_DEPTH_TEST );
+	m_pRenderContext->Disable( renderer::Capability::TEXTURE_2D );
+	m_pRenderContext->Disable( renderer::Capability::DEPTH_TEST );
 
 	if( pbones[ iBone ].parent >= 0 )
 	{
 		glPointSize( 10.0f );
-		glColor3f( 0, 0.7f, 1 );
+		m_pRenderContext->SetColor( 0, 0.7f, 1 );
 		glBegin( GL_LINES );
 		glVertex3f( m_bonetransform[ pbones[ iBone ].parent ][ 0 ][ 3 ], m_bonetransform[ pbones[ iBone ].parent ][ 1 ][ 3 ], m_bonetransform[ pbones[ iBone ].parent ][ 2 ][ 3 ] );
 		glVertex3f( m_bonetransform[ iBone ][ 0 ][ 3 ], m_bonetransform[ iBone ][ 1 ][ 3 ], m_bonetransform[ iBone ][ 2 ][ 3 ] );
 		glEnd();
 
-		glColor3f( 0, 0, 0.8f );
+		m_pRenderContext->SetColor( 0, 0, 0.8f );
 		glBegin( GL_POINTS );
 		if( pbones[ pbones[ iBone ].parent ].parent != -1 )
 			glVertex3f( m_bonetransform[ pbones[ iBone ].parent ][ 0 ][ 3 ], m_bonetransform[ pbones[ iBone ].parent ][ 1 ][ 3 ], m_bonetransform[ pbones[ iBone ].parent ][ 2 ][ 3 ] );
@@ -220,7 +255,7 @@ void CStudioModelRenderer::DrawSingleBone( const int iBone )
 	{
 		// draw parent bone node
 		glPointSize( 10.0f );
-		glColor3f( 0.8f, 0, 0 );
+		m_pRenderContext->SetColor( 0.8f, 0, 0 );
 		glBegin( GL_POINTS );
 		glVertex3f( m_bonetransform[ iBone ][ 0 ][ 3 ], m_bonetransform[ iBone ][ 1 ][ 3 ], m_bonetransform[ iBone ][ 2 ][ 3 ] );
 		glEnd();
@@ -229,130 +264,91 @@ void CStudioModelRenderer::DrawSingleBone( const int iBone )
 	glPointSize( 1.0f );
 }
 
-void CStudioModelRenderer::DrawSingleAttachment( const int iAttachment )
+void CStudioModelRenderer::DrawSingleAttachment( const AttachmentPose& attachment )
 {
-	if( !m_pStudioHdr || iAttachment < 0 || iAttachment >= m_pStudioHdr->numattachments )
-		return;
+	m_pRenderContext->Disable( renderer::Capability::TEXTURE_2D );
+	m_pRenderContext->Disable( renderer::Capability::CULL_FACE );
+	m_pRenderContext->Disable( renderer::Capability::DEPTH_TEST );
 
-	glDisable( GL_TEXTURE_2D );
-	glDisable( GL_CULL_FACE );
-	glDisable( GL_DEPTH_TEST );
-
-	mstudioattachment_t *pattachments = m_pStudioHdr->GetAttachments();
-	glm::vec3 v[ 4 ];
-	VectorTransform( pattachments[ iAttachment ].org, m_bonetransform[ pattachments[ iAttachment ].bone ], v[ 0 ] );
-	VectorTransform( pattachments[ iAttachment ].vectors[ 0 ], m_bonetransform[ pattachments[ iAttachment ].bone ], v[ 1 ] );
-	VectorTransform( pattachments[ iAttachment ].vectors[ 1 ], m_bonetransform[ pattachments[ iAttachment ].bone ], v[ 2 ] );
-	VectorTransform( pattachments[ iAttachment ].vectors[ 2 ], m_bonetransform[ pattachments[ iAttachment ].bone ], v[ 3 ] );
 	glBegin( GL_LINES );
-	glColor3f( 0, 1, 1 );
-	glVertex3fv( glm::value_ptr( v[ 0 ] ) );
-	glColor3f( 1, 1, 1 );
-	glVertex3fv( glm::value_ptr( v[ 1 ] ) );
-	glColor3f( 0, 1, 1 );
-	glVertex3fv( glm::value_ptr( v[ 0 ] ) );
-	glColor3f( 1, 1, 1 );
-	glVertex3fv( glm::value_ptr( v[ 2 ] ) );
-	glColor3f( 0, 1, 1 );
-	glVertex3fv( glm::value_ptr( v[ 0 ] ) );
-	glColor3f( 1, 1, 1 );
-	glVertex3fv( glm::value_ptr( v[ 3 ] ) );
+	for( const auto& vector : attachment.Vectors )
+	{
+		m_pRenderContext->SetColor( 0, 1, 1 );
+		glVertex3fv( glm::value_ptr( attachment.Origin ) );
+		m_pRenderContext->SetColor( 1, 1, 1 );
+		glVertex3fv( glm::value_ptr( vector ) );
+	}
 	glEnd();
 
 	glPointSize( 10 );
-	glColor3f( 0, 1, 0 );
+	m_pRenderContext->SetColor( 0, 1, 0 );
 	glBegin( GL_POINTS );
-	glVertex3fv( glm::value_ptr( v[ 0 ] ) );
+	glVertex3fv( glm::value_ptr( attachment.Origin ) );
 	glEnd();
 	glPointSize( 1 );
 }
 
-void CStudioModelRenderer::DrawSingleHitbox(const int hitboxIndex)
+void CStudioModelRenderer::DrawSingleHitbox(const HitboxOBB& hitbox)
 {
-	if (!m_pStudioHdr || hitboxIndex < 0 || hitboxIndex >= m_pStudioHdr->numhitboxes)
-		return;
-
-	glDisable(GL_TEXTURE_2D);
-	glDisable(GL_CULL_FACE);
+	m_pRenderContext->Disable(renderer::Capability::TEXTURE_2D);
+	m_pRenderContext->Disable(renderer::Capability::CULL_FACE);
 	if (m_pRenderInfo->flTransparency < 1.0f)
-		glDisable(GL_DEPTH_TEST);
+		m_pRenderContext->Disable(renderer::Capability::DEPTH_TEST);
 	else
-		glEnable(GL_DEPTH_TEST);
-
-	glColor4f(1, 0, 0, 0.5f);
-
-	glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	mstudiobbox_t* hitbox = m_pStudioHdr->GetHitBox(hitboxIndex);
-	glm::vec3 v[8], v2[8];
-
-	glm::vec3 bbmin = hitbox->bbmin;
-	glm::vec3 bbmax = hitbox->bbmax;
-
-	v[0][0] = bbmin[0];
-	v[0][1] = bbmax[1];
-	v[0][2] = bbmin[2];
-
-	v[1][0] = bbmin[0];
-	v[1][1] = bbmin[1];
-	v[1][2] = bbmin[2];
-
-	v[2][0] = bbmax[0];
-	v[2][1] = bbmax[1];
-	v[2][2] = bbmin[2];
+		m_pRenderContext->Enable(renderer::Capability::DEPTH_TEST);
 
-	v[3][0] = bbmax[0];
-	v[3][1] = bbmin[1];
-	v[3][2] = bbmin[2];
+	m_pRenderContext->SetColor(1, 0, 0, 0.5f);
 
-	v[4][0] = bbmax[0];
-	v[4][1] = bbmax[1];
-	v[4][2] = bbmax[2];
+	m_pRenderContext->SetPolygonMode(renderer::PolygonMode::LINE);
+	m_pRenderContext->Enable(renderer::Capability::BLEND);
+	m_pRenderContext->SetBlendFunc(renderer::BlendFactor::SRC_ALPHA, renderer::BlendFactor::ONE_MINUS_SRC_ALPHA);
 
-	v[5][0] = bbmax[0];
-	v[5][1] = bbmin[1];
-	v[5][2] = bbmax[2];
-
-	v[6][0] = bbmin[0];
-	v[6][1] = bbmax[1];
-	v[6][2] = bbmax[2];
-
-	v[7][0] = bbmin[0];
-	v[7][1] = bbmin[1];
-	v[7][2] = bbmax[2];
+	//Corners in the order DrawBox expects, as signs along each of the box's axes.
+	static const float signs[8][3] =
+	{
+		{-1,  1, -1},
+		{-1, -1, -1},
+		{ 1,  1, -1},
+		{ 1, -1, -1},
+		{ 1,  1,  1},
+		{ 1, -1,  1},
+		{-1,  1,  1},
+		{-1, -1,  1}
+	};
+
+	glm::vec3 v[8];
+
+	for (int corner = 0; corner < 8; ++corner)
+	{
+		v[corner] = hitbox.Center;
 
-	VectorTransform(v[0], m_bonetransform[hitbox->bone], v2[0]);
-	VectorTransform(v[1], m_bonetransform[hitbox->bone], v2[1]);
-	VectorTransform(v[2], m_bonetransform[hitbox->bone], v2[2]);
-	VectorTransform(v[3], m_bonetransform[hitbox->bone], v2[3]);
-	VectorTransform(v[4], m_bonetransform[hitbox->bone], v2[4]);
-	VectorTransform(v[5], m_bonetransform[hitbox->bone], v2[5]);
-	VectorTransform(v[6], m_bonetransform[hitbox->bone], v2[6]);
-	VectorTransform(v[7], m_bonetransform[hitbox->bone], v2[7]);
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			v[corner] += hitbox.Axes[axis] * (hitbox.Extents[axis] * signs[corner][axis]);
+		}
+	}
 
-	graphics::DrawBox(v2);
+	graphics::DrawBox(m_pRenderContext, v);
 }
 
 void CStudioModelRenderer::DrawBones()
 {
 	const mstudiobone_t* const pbones = m_pStudioHdr->GetBones();
-	glDisable( GL_TEXTURE_2D );
-	glDisable( GL_DEPTH_TEST );
+	m_pRenderContext->Disable( renderer::Capability::TEXTURE_2D );
+	m_pRenderContext->Disable( renderer::Capability::DEPTH_TEST );
 
 	for( int i = 0; i < m_pStudioHdr->numbones; i++ )
 	{
 		if( pbones[ i ].parent >= 0 )
 		{
 			glPointSize( 3.0f );
-			glColor3f( 1, 0.7f, 0 );
+			m_pRenderContext->SetColor( 1, 0.7f, 0 );
 			glBegin( GL_LINES );
 			glVertex3f( m_bonetransform[ pbones[ i ].parent ][ 0 ][ 3 ], m_bonetransform[ pbones[ i ].parent ][ 1 ][ 3 ], m_bonetransform[ pbones[ i ].parent ][ 2 ][ 3 ] );
 			glVertex3f( m_bonetransform[ i ][ 0 ][ 3 ], m_bonetransform[ i ][ 1 ][ 3 ], m_bonetransform[ i ][ 2 ][ 3 ] );
 			glEnd();
 
-			glColor3f( 0, 0, 0.8f );
+			m_pRenderContext->SetColor( 0, 0, 0.8f );
 			glBegin( GL_POINTS );
 			if( pbones[ pbones[ i ].parent ].parent != -1 )
 				glVertex3f( m_bonetransform[ pbones[ i ].parent ][ 0 ][ 3 ], m_bonetransform[ pbones[ i ].parent ][ 1 ][ 3 ], m_bonetransform[ pbones[ i ].parent ][ 2 ][ 3 ] );
@@ -363,7 +359,7 @@ void CStudioModelRenderer::DrawBones()
 		{
 			// draw parent bone node
 			glPointSize( 5.0f );
-			glColor3f( 0.8f, 0, 0 );
+			m_pRenderContext->SetColor( 0.8f, 0, 0 );
 			glBegin( GL_POINTS );
 			glVertex3f( m_bonetransform[ i ][ 0 ][ 3 ], m_bonetransform[ i ][ 1 ][ 3 ], m_bonetransform[ i ][ 2 ][ 3 ] );
 			glEnd();
@@ -375,9 +371,9 @@ void CStudioModelRenderer::DrawBones()
 
 void CStudioModelRenderer::DrawAttachments()
 {
-	glDisable( GL_TEXTURE_2D );
-	glDisable( GL_CULL_FACE );
-	glDisable( GL_DEPTH_TEST );
+	m_pRenderContext->Disable( renderer::Capability::TEXTURE_2D );
+	m_pRenderContext->Disable( renderer::Capability::CULL_FACE );
+	m_pRenderContext->Disable( renderer::Capability::DEPTH_TEST );
 
 	for( int i = 0; i < m_pStudioHdr->numattachments; i++ )
 	{
@@ -388,22 +384,22 @@ void CStudioModelRenderer::DrawAttachments()
 		VectorTransform( pattachments[ i ].vectors[ 1 ], m_bonetransform[ pattachments[ i ].bone ], v[ 2 ] );
 		VectorTransform( pattachments[ i ].vectors[ 2 ], m_bonetransform[ pattachments[ i ].bone ], v[ 3 ] );
 		glBegin( GL_LINES );
-		glColor3f( 1, 0, 0 );
+		m_pRenderContext->SetColor( 1, 0, 0 );
 		glVertex3fv( glm::value_ptr( v[ 0 ] ) );
-		glColor3f( 1, 1, 1 );
+		m_pRenderContext->SetColor( 1, 1, 1 );
 		glVertex3fv( glm::value_ptr( v[ 1 ] ) );
-		glColor3f( 1, 0, 0 );
+		m_pRenderContext->SetColor( 1, 0, 0 );
 		glVertex3fv( glm::value_ptr( v[ 0 ] ) );
-		glColor3f( 1, 1, 1 );
+		m_pRenderContext->SetColor( 1, 1, 1 );
 		glVertex3fv( glm::value_ptr( v[ 2 ] ) );
-		glColor3f( 1, 0, 0 );
+		m_pRenderContext->SetColor( 1, 0, 0 );
 		glVertex3fv( glm::value_ptr( v[ 0 ] ) );
-		glColor3f( 1, 1, 1 );
+		m_pRenderContext->SetColor( 1, 1, 1 );
 		glVertex3fv( glm::value_ptr( v[ 3 ] ) );
 		glEnd();
 
 		glPointSize( 5 );
-		glColor3f( 0, 1, 0 );
+		m_pRenderContext->SetColor( 0, 1, 0 );
 		glBegin( GL_POINTS );
 		glVertex3fv( glm::value_ptr( v[ 0 ] ) );
 		glEnd();
@@ -413,12 +409,12 @@ void CStudioModelRenderer::DrawAttachments()
 
 void CStudioModelRenderer::DrawEyePosition()
 {
-	glDisable( GL_TEXTURE_2D );
-	glDisable( GL_CULL_FACE );
-	glDisable( GL_DEPTH_TEST );
+	m_pRenderContext->Disable( renderer::Capability::TEXTURE_2D );
+	m_pRenderContext->Disable( renderer::Capability::CULL_FACE );
+	m_pRenderContext->Disable( renderer::Capability::DEPTH_TEST );
 
 	glPointSize( 7 );
-	glColor3f( 1, 0, 1 );
+	m_pRenderContext->SetColor( 1, 0, 1 );
 	glBegin( GL_POINTS );
 	glVertex3fv( glm::value_ptr( m_pStudioHdr->eyeposition ) );
 	glEnd();
@@ -427,18 +423,18 @@ void CStudioModelRenderer::DrawEyePosition()
 
 void CStudioModelRenderer::DrawHitBoxes()
 {
-	glDisable( GL_TEXTURE_2D );
-	glDisable( GL_CULL_FACE );
+	m_pRenderContext->Disable( renderer::Capability::TEXTURE_2D );
+	m_pRenderContext->Disable( renderer::Capability::CULL_FACE );
 	if( m_pRenderInfo->flTransparency < 1.0f )
-		glDisable( GL_DEPTH_TEST );
+		m_pRenderContext->Disable( renderer::Capability::DEPTH_TEST );
 	else
-		glEnable( GL_DEPTH_TEST );
+		m_pRenderContext->Enable( renderer::Capability::DEPTH_TEST );
 
-	glColor4f( 1, 0, 0, 0.5f );
+	m_pRenderContext->SetColor( 1, 0, 0, 0.5f );
 
-	glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
-	glEnable( GL_BLEND );
-	glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+	m_pRenderContext->SetPolygonMode( renderer::PolygonMode::LINE );
+	m_pRenderContext->Enable( renderer::Capability::BLEND );
+	m_pRenderContext->SetBlendFunc( renderer::BlendFactor::SRC_ALPHA, renderer::BlendFactor::ONE_MINUS_SRC_ALPHA );
 
 	for( int i = 0; i < m_pStudioHdr->numhitboxes; i++ )
 	{
@@ -489,15 +485,18 @@ void CStudioModelRenderer::DrawHitBoxes()
 		VectorTransform( v[ 6 ], m_bonetransform[ pbboxes[ i ].bone ], v2[ 6 ] );
 		VectorTransform( v[ 7 ], m_bonetransform[ pbboxes[ i ].bone ], v2[ 7 ] );
 
-		graphics::DrawBox( v2 );
+		graphics::DrawBox( m_pRenderContext, v2 );
 	}
 }
 
 void CStudioModelRenderer::DrawNormals()
 {
-	glDisable( GL_TEXTURE_2D );
+	//Transform into scratch space so the body part plans are left alone
+	m_pxformverts = &m_xformverts[ 0 ];
 
-	glColor4f( 1.0f, 1.0f, 1.0f, 1.0f );
+	m_pRenderContext->Disable( renderer::Capability::TEXTURE_2D );
+
+	m_pRenderContext->SetColor( 1.0f, 1.0f, 1.0f, 1.0f );
 	glBegin( GL_LINES );
 
 	for( int iBodyPart = 0; iBodyPart < m_pStudioHdr->numbodyparts; ++iBodyPart )
@@ -554,15 +553,10 @@ void CStudioModelRenderer::DrawNormals()
 
 void CStudioModelRenderer::SetUpBones()
 {
+	PROFILE_SCOPE("StudioModelRenderer::SetUpBones");
+
 	static glm::vec3 pos[ MAXSTUDIOBONES ];
 	static glm::vec4 q[ MAXSTUDIOBONES ];
-					 
-	static glm::vec3 pos2[ MAXSTUDIOBONES ];
-	static glm::vec4 q2[ MAXSTUDIOBONES ];
-	static glm::vec3 pos3[ MAXSTUDIOBONES ];
-	static glm::vec4 q3[ MAXSTUDIOBONES ];
-	static glm::vec3 pos4[ MAXSTUDIOBONES ];
-	static glm::vec4 q4[ MAXSTUDIOBONES ];
 
 	if( m_pRenderInfo->iSequence >= m_pStudioHdr->numseq )
 	{
@@ -573,390 +567,20 @@ void CStudioModelRenderer::SetUpBones()
 
 	const mstudioanim_t* panim = m_pRenderInfo->pModel->GetAnim( pseqdesc );
 
-	if (pseqdesc->numblends == 9)
-	{
-		const auto f = m_pRenderInfo->flFrame;
-
-		const auto blendX = static_cast<double>(m_pRenderInfo->iBlender[0]);
-		const auto blendY = static_cast<double>(m_pRenderInfo->iBlender[1]);
-
-		const mstudioanim_t* lastanim;
-
-		double interpolantX;
-		double interpolantY;
-
-		if (blendX > 127.0)
-		{
-			interpolantX = blendX - 127.0 + blendX - 127.0;
-
-			if (blendY > 127.0)
-			{
-				interpolantY = blendY - 127.0 + blendY - 127.0;
-
-				auto panim4 = panim;
-				if (pseqdesc->numblends > 4)
-					panim4 += 4 * m_pStudioHdr->numbones;
-				CalcRotations(pos, q, pseqdesc, panim4, f);
-
-				auto panim5 = panim;
-				if (pseqdesc->numblends > 5)
-					panim5 += 5 * m_pStudioHdr->numbones;
-				CalcRotations(pos2, q2, pseqdesc, panim5, f);
-
-				auto panim7 = panim;
-				if (pseqdesc->numblends > 7)
-					panim7 += 7 * m_pStudioHdr->numbones;
-				CalcRotations(pos3, q3, pseqdesc, panim7, f);
-
-				lastanim = panim;
-				if (pseqdesc->numblends > 8)
-					lastanim += 8 * m_pStudioHdr->numbones;
-			}
-			else
-			{
-				interpolantY = blendY + blendY;
-
-				auto panim1 = panim;
-				if (pseqdesc->numblends > 1)
-					panim1 += m_pStudioHdr->numbones;
-				CalcRotations(pos, q, pseqdesc, panim1, f);
-
-				auto panim2 = panim;
-				if (pseqdesc->numblends > 2)
-					panim2 += 2 * m_pStudioHdr->numbones;
-				CalcRotations(pos2, q2, pseqdesc, panim2, f);
-
-				auto panim4 = panim;
-				if (pseqdesc->numblends > 4)
-					panim4 += 4 * m_pStudioHdr->numbones;
-				CalcRotations(pos3, q3, pseqdesc, panim4, f);
-
-				lastanim = panim;
-				if (pseqdesc->numblends > 5)
-					lastanim += 5 * m_pStudioHdr->numbones;
-			}
-		}
-		else
-		{
-			interpolantX = blendX + blendX;
-
-			if (blendY <= 127.0)
-			{
-				interpolantY = blendY + blendY;
-
-				CalcRotations(pos, q, pseqdesc, panim, f);
-
-				auto panim1 = panim;
-				if (pseqdesc->numblends > 1)
-					panim1 += m_pStudioHdr->numbones;
-				CalcRotations(pos2, q2, pseqdesc, panim1, f);
-
-				auto panim3 = panim;
-				if (pseqdesc->numblends > 3)
-					panim3 += 3 * m_pStudioHdr->numbones;
-				CalcRotations(pos3, q3, pseqdesc, panim3, f);
-
-				lastanim = panim;
-				if (pseqdesc->numblends > 4)
-					lastanim += 4 * m_pStudioHdr->numbones;
-			}
-			else
-			{
-				interpolantY = blendY - 127.0 + blendY - 127.0;
-
-				auto panim3 = panim;
-				if (pseqdesc->numblends > 3)
-					panim3 += 3 * m_pStudioHdr->numbones;
-				CalcRotations(pos, q, pseqdesc, panim3, f);
-
-				auto panim4 = panim;
-				if (pseqdesc->numblends > 4)
-					panim4 += 4 * m_pStudioHdr->numbones;
-				CalcRotations(pos2, q2, pseqdesc, panim4, f);
-
-				auto panim6 = panim;
-				if (pseqdesc->numblends > 6)
-					panim6 += 6 * m_pStudioHdr->numbones;
-				CalcRotations(pos3, q3, pseqdesc, panim6, f);
-
-				lastanim = panim;
-				if (pseqdesc->numblends > 7)
-					lastanim += 7 * m_pStudioHdr->numbones;
-			}
-		}
-
-		CalcRotations(pos4, q4, pseqdesc, lastanim, f);
-
-		const auto normalizedInterpolantX = interpolantX / 255.0;
-		SlerpBones(q, pos, q2, pos2, normalizedInterpolantX);
-		SlerpBones(q3, pos3, q4, pos4, normalizedInterpolantX);
-
-		const auto normalizedInterpolantY = interpolantY / 255.0;
-		SlerpBones(q, pos, q3, pos3, normalizedInterpolantY);
-	}
-	else
-	{
-		CalcRotations(pos, q, pseqdesc, panim, m_pRenderInfo->flFrame);
-
-		if (pseqdesc->numblends > 1)
-		{
-			panim += m_pStudioHdr->numbones;
-			CalcRotations(pos2, q2, pseqdesc, panim, m_pRenderInfo->flFrame);
-			float s = m_pRenderInfo->iBlender[0] / 255.0;
-
-			SlerpBones(q, pos, q2, pos2, s);
+	//Shared with CStudioModelPose, so bones evaluated without a renderer match the drawn ones
+	const auto sequence = GetBlendedSequence( m_pStudioHdr, pseqdesc, panim, m_pRenderInfo->flFrame,
+		m_pRenderInfo->iBlender, m_pRenderInfo->iController, m_pRenderInfo->iMouth );
 
-			if (pseqdesc->numblends == 4)
-			{
-				panim += m_pStudioHdr->numbones;
-				CalcRotations(pos3, q3, pseqdesc, panim, m_pRenderInfo->flFrame);
+	CalcBlendedBones( sequence, pos, q );
 
-				panim += m_pStudioHdr->numbones;
-				CalcRotations(pos4, q4, pseqdesc, panim, m_pRenderInfo->flFrame);
+	static BonePose pose;
+	static glm::mat3x4 bonematrices[ MAXSTUDIOBONES ];
 
-				s = m_pRenderInfo->iBlender[0] / 255.0;
-				SlerpBones(q3, pos3, q4, pos4, s);
+	pose.Load( pos, q, m_pStudioHdr->numbones );
 
-				s = m_pRenderInfo->iBlender[1] / 255.0;
-				SlerpBones(q, pos, q3, pos3, s);
-			}
-		}
-	}
-
-	const mstudiobone_t* const pbones = m_pStudioHdr->GetBones();
+	QuaternionMatrices( pose, bonematrices );
 
-	glm::mat3x4 bonematrix;
-
-	for( int i = 0; i < m_pStudioHdr->numbones; i++ )
-	{
-		QuaternionMatrix( q[ i ], bonematrix );
-
-		bonematrix[ 0 ][ 3 ] = pos[ i ][ 0 ];
-		bonematrix[ 1 ][ 3 ] = pos[ i ][ 1 ];
-		bonematrix[ 2 ][ 3 ] = pos[ i ][ 2 ];
-
-		if( pbones[ i ].parent == -1 )
-		{
-			m_bonetransform[ i ] = bonematrix;
-		}
-		else
-		{
-			R_ConcatTransforms( m_bonetransform[ pbones[ i ].parent ], bonematrix, m_bonetransform[ i ] );
-		}
-	}
-}
-
-void CStudioModelRenderer::CalcRotations( glm::vec3* pos, glm::vec4* q, const mstudioseqdesc_t* const pseqdesc, const mstudioanim_t* panim, const float f )
-{
-	const int frame = ( int ) f;
-	const float s = ( f - frame );
-
-	// add in programatic controllers
-	CalcBoneAdj();
-
-	auto pbone = m_pStudioHdr->GetBones();
-
-	for( int i = 0; i < m_pStudioHdr->numbones; i++, pbone++, panim++ )
-	{
-		CalcBoneQuaternion( frame, s, pbone, panim, q[ i ] );
-		CalcBonePosition( frame, s, pbone, panim, pos[ i ] );
-	}
-
-	if( pseqdesc->motiontype & STUDIO_X )
-		pos[ pseqdesc->motionbone ][ 0 ] = 0.0;
-	if( pseqdesc->motiontype & STUDIO_Y )
-		pos[ pseqdesc->motionbone ][ 1 ] = 0.0;
-	if( pseqdesc->motiontype & STUDIO_Z )
-		pos[ pseqdesc->motionbone ][ 2 ] = 0.0;
-}
-
-void CStudioModelRenderer::CalcBoneAdj()
-{
-	const auto* const pbonecontroller = m_pStudioHdr->GetBoneControllers();
-
-	for( int j = 0; j < m_pStudioHdr->numbonecontrollers; j++ )
-	{
-		const auto i = pbonecontroller[ j ].index;
-
-		float value;
-
-		if( i <= 3 )
-		{
-			// check for 360% wrapping
-			if( pbonecontroller[ j ].type & STUDIO_RLOOP )
-			{
-				value = m_pRenderInfo->iController[ i ] * ( 360.0 / 256.0 ) + pbonecontroller[ j ].start;
-			}
-			else
-			{
-				value = m_pRenderInfo->iController[ i ] / 255.0;
-				if( value < 0 ) value = 0;
-				if( value > 1.0 ) value = 1.0;
-				value = ( 1.0 - value ) * pbonecontroller[ j ].start + value * pbonecontroller[ j ].end;
-			}
-			// Con_DPrintf( "%d %d %f : %f\n", m_controller[j], m_prevcontroller[j], value, dadt );
-		}
-		else
-		{
-			value = m_pRenderInfo->iMouth / 64.0;
-			if( value > 1.0 ) value = 1.0;
-			value = ( 1.0 - value ) * pbonecontroller[ j ].start + value * pbonecontroller[ j ].end;
-			// Con_DPrintf("%d %f\n", mouthopen, value );
-		}
-		switch( pbonecontroller[ j ].type & STUDIO_TYPES )
-		{
-		case STUDIO_XR:
-		case STUDIO_YR:
-		case STUDIO_ZR:
-			m_Adj[ j ] = value * ( Q_PI / 180.0 );
-			break;
-		case STUDIO_X:
-		case STUDIO_Y:
-		case STUDIO_Z:
-			m_Adj[ j ] = value;
-			break;
-		}
-	}
-}
-
-void CStudioModelRenderer::CalcBoneQuaternion( const int frame, const float s, const mstudiobone_t* const pbone, const mstudioanim_t* const panim, glm::vec4& q )
-{
-	glm::vec3			angle1, angle2;
-
-	for( int j = 0; j < 3; j++ )
-	{
-		if( panim->offset[ j + 3 ] == 0 )
-		{
-			angle2[ j ] = angle1[ j ] = pbone->value[ j + 3 ]; // default;
-		}
-		else
-		{
-			auto panimvalue = ( const mstudioanimvalue_t* ) ( ( const byte* ) panim + panim->offset[ j + 3 ] );
-			auto k = frame;
-			while( panimvalue->num.total <= k )
-			{
-				k -= panimvalue->num.total;
-				panimvalue += panimvalue->num.valid + 1;
-			}
-			// Bah, missing blend!
-			if( panimvalue->num.valid > k )
-			{
-				angle1[ j ] = panimvalue[ k + 1 ].value;
-
-				if( panimvalue->num.valid > k + 1 )
-				{
-					angle2[ j ] = panimvalue[ k + 2 ].value;
-				}
-				else
-				{
-					if( panimvalue->num.total > k + 1 )
-						angle2[ j ] = angle1[ j ];
-					else
-						angle2[ j ] = panimvalue[ panimvalue->num.valid + 2 ].value;
-				}
-			}
-			else
-			{
-				angle1[ j ] = panimvalue[ panimvalue->num.valid ].value;
-				if( panimvalue->num.total > k + 1 )
-				{
-					angle2[ j ] = angle1[ j ];
-				}
-				else
-				{
-					angle2[ j ] = panimvalue[ panimvalue->num.valid + 2 ].value;
-				}
-			}
-			angle1[ j ] = pbone->value[ j + 3 ] + angle1[ j ] * pbone->scale[ j + 3 ];
-			angle2[ j ] = pbone->value[ j + 3 ] + angle2[ j ] * pbone->scale[ j + 3 ];
-		}
-
-		if( pbone->bonecontroller[ j + 3 ] != -1 )
-		{
-			angle1[ j ] += m_Adj[ pbone->bonecontroller[ j + 3 ] ];
-			angle2[ j ] += m_Adj[ pbone->bonecontroller[ j + 3 ] ];
-		}
-	}
-
-	if( !VectorCompare( angle1, angle2 ) )
-	{
-		glm::vec4 q1, q2;
-
-		AngleQuaternion( angle1, q1 );
-		AngleQuaternion( angle2, q2 );
-		QuaternionSlerp( q1, q2, s, q );
-	}
-	else
-	{
-		AngleQuaternion( angle1, q );
-	}
-}
-
-void CStudioModelRenderer::CalcBonePosition( const int frame, const float s, const mstudiobone_t* const pbone, const mstudioanim_t* const panim, glm::vec3& pos )
-{
-	for( int j = 0; j < 3; j++ )
-	{
-		pos[ j ] = pbone->value[ j ]; // default;
-		if( panim->offset[ j ] != 0 )
-		{
-			auto panimvalue = ( mstudioanimvalue_t * ) ( ( byte * ) panim + panim->offset[ j ] );
-
-			auto k = frame;
-			// find span of values that includes the frame we want
-			while( panimvalue->num.total <= k )
-			{
-				k -= panimvalue->num.total;
-				panimvalue += panimvalue->num.valid + 1;
-			}
-			// if we're inside the span
-			if( panimvalue->num.valid > k )
-			{
-				// and there's more data in the span
-				if( panimvalue->num.valid > k + 1 )
-				{
-					pos[ j ] += ( panimvalue[ k + 1 ].value * ( 1.0 - s ) + s * panimvalue[ k + 2 ].value ) * pbone->scale[ j ];
-				}
-				else
-				{
-					pos[ j ] += panimvalue[ k + 1 ].value * pbone->scale[ j ];
-				}
-			}
-			else
-			{
-				// are we at the end of the repeating values section and there's another section with data?
-				if( panimvalue->num.total <= k + 1 )
-				{
-					pos[ j ] += ( panimvalue[ panimvalue->num.valid ].value * ( 1.0 - s ) + s * panimvalue[ panimvalue->num.valid + 2 ].value ) * pbone->scale[ j ];
-				}
-				else
-				{
-					pos[ j ] += panimvalue[ panimvalue->num.valid ].value * pbone->scale[ j ];
-				}
-			}
-		}
-		if( pbone->bonecontroller[ j ] != -1 )
-		{
-			pos[ j ] += m_Adj[ pbone->bonecontroller[ j ] ];
-		}
-	}
-}
-
-void CStudioModelRenderer::SlerpBones( glm::vec4* q1, glm::vec3* pos1, glm::vec4* q2, glm::vec3* pos2, float s )
-{
-	glm::vec4 q3;
-
-	if( s < 0 ) s = 0;
-	else if( s > 1.0 ) s = 1.0;
-
-	const float s1 = 1.0 - s;
-
-	for( int i = 0; i < m_pStudioHdr->numbones; i++ )
-	{
-		QuaternionSlerp( q1[ i ], q2[ i ], s, q3 );
-		q1[ i ] = q3;
-
-		pos1[ i ] = pos1[ i ] * s1 + pos2[ i ] * s;
-	}
+	ConcatenateBoneTransforms( m_pStudioHdr->GetBones(), bonematrices, m_pStudioHdr->numbones, m_bonetransform );
 }
 
 void CStudioModelRenderer::SetupLighting()
@@ -967,11 +591,6 @@ void CStudioModelRenderer::SetupLighting()
 	m_lightcolor[ 0 ] = r_lighting_r.GetInt();
 	m_lightcolor[ 1 ] = r_lighting_g.GetInt();
 	m_lightcolor[ 2 ] = r_lighting_b.GetInt();
-
-	for( int i = 0; i < m_pStudioHdr->numbones; i++ )
-	{
-		VectorIRotate( m_lightvec, m_bonetransform[ i ], m_blightvec[ i ] );
-	}
 }
 
 void CStudioModelRenderer::SetupModel( int bodypart )
@@ -985,42 +604,62 @@ void CStudioModelRenderer::SetupModel( int bodypart )
 	m_pModel = m_pRenderInfo->pModel->GetModelByBodyPart( m_pRenderInfo->iBodygroup, bodypart );
 }
 
-unsigned int CStudioModelRenderer::DrawPoints( const bool bWireframe )
+unsigned int CStudioModelRenderer::DrawPoints( const int bodypart, const bool bWireframe )
 {
-	unsigned int uiDrawnPolys = 0;
+	PROFILE_SCOPE("StudioModelRenderer::DrawPoints");
 
-	auto pvertbone = ( ( byte * ) m_pStudioHdr + m_pModel->vertinfoindex );
-	auto pnormbone = ( ( byte * ) m_pStudioHdr + m_pModel->norminfoindex );
-	auto ptexture = m_pTextureHdr->GetTextures();
+	const auto& plan = PrepareBodyPart( bodypart );
 
-	auto pmesh = ( mstudiomesh_t * ) ( ( byte * ) m_pStudioHdr + m_pModel->meshindex );
+	//Blended draws keep the model's mesh order
+	const auto& meshes = m_pRenderInfo->pModel->GetSortedMeshes( m_pModel, m_pRenderInfo->iSkin, m_pRenderInfo->flTransparency >= 1.0f );
 
-	auto pstudioverts = ( const glm::vec3* ) ( ( const byte* ) m_pStudioHdr + m_pModel->vertindex );
-	auto pstudionorms = ( const glm::vec3* ) ( ( const byte* ) m_pStudioHdr + m_pModel->normindex );
+	const unsigned int uiDrawnPolys = DrawMeshes( bWireframe, meshes.data(), m_pTextureHdr->GetTextures(), plan.pSkinRef );
+
+	m_pRenderContext->SetDepthMask( true );
 
+	return uiDrawnPolys;
+}
+
+const short* CStudioModelRenderer::GetSkinReferences() const
+{
 	auto pskinref = m_pTextureHdr->GetSkins();
 
 	if( m_pRenderInfo->iSkin != 0 && m_pRenderInfo->iSkin < m_pTextureHdr->numskinfamilies )
 		pskinref += ( m_pRenderInfo->iSkin * m_pTextureHdr->numskinref );
 
+	return pskinref;
+}
+
+void CStudioModelRenderer::TransformVertices()
+{
+	auto pvertbone = ( ( const byte* ) m_pStudioHdr + m_pModel->vertinfoindex );
+
+	auto pstudioverts = ( const glm::vec3* ) ( ( const byte* ) m_pStudioHdr + m_pModel->vertindex );
+
 	for( int i = 0; i < m_pModel->numverts; i++ )
 	{
 		VectorTransform( pstudioverts[ i ], m_bonetransform[ pvertbone[ i ] ], m_pxformverts[ i ] );
 	}
+}
 
-	SortedMesh_t meshes[ MAXSTUDIOMESHES ];
+void CStudioModelRenderer::LightVertices( const mstudiotexture_t* pTextures, const short* pSkinRef )
+{
+	auto pnormbone = ( ( const byte* ) m_pStudioHdr + m_pModel->norminfoindex );
 
-	//
-	// clip and draw all triangles
-	//
+	auto pmesh = ( const mstudiomesh_t* ) ( ( const byte* ) m_pStudioHdr + m_pModel->meshindex );
+
+	auto pstudionorms = ( const glm::vec3* ) ( ( const byte* ) m_pStudioHdr + m_pModel->normindex );
 
 	glm::vec3* lv = m_pvlightvalues;
-	for( int j = 0; j < m_pModel->nummesh; j++ )
+
+	for( int i = 0; i < m_pStudioHdr->numbones; i++ )
 	{
-		int flags = ptexture[ pskinref[ pmesh[ j ].skinref ] ].flags;
+		VectorIRotate( m_lightvec, m_bonetransform[ i ], m_blightvec[ i ] );
+	}
 
-		meshes[ j ].pMesh = &pmesh[ j ];
-		meshes[ j ].flags = flags;
+	for( int j = 0; j < m_pModel->nummesh; j++ )
+	{
+		const int flags = pTextures[ pSkinRef[ pmesh[ j ].skinref ] ].flags;
 
 		for( int i = 0; i < pmesh[ j ].numnorms; i++, ++lv, ++pstudionorms, pnormbone++ )
 		{
@@ -1029,37 +668,54 @@ unsigned int CStudioModelRenderer::DrawPoints( const bool bWireframe )
 			// FIX: move this check out of the inner loop
 			if (flags & STUDIO_NF_CHROME)
 			{
-				auto& c = m_chrome[reinterpret_cast<glm::vec3*>(lv) - m_pvlightvalues];
+				auto& c = m_pchrome[lv - m_pvlightvalues];
 
 				Chrome(c, *pnormbone, *pstudionorms);
 			}
 		}
 	}
+}
 
-	//Sort meshes by render modes so additive meshes are drawn after solid meshes.
-	//Masked meshes are drawn before solid meshes.
-	std::stable_sort( meshes, meshes + m_pModel->nummesh, CompareSortedMeshes );
-
-	uiDrawnPolys += DrawMeshes( bWireframe, meshes, ptexture, pskinref );
+void CStudioModelRenderer::SetupMeshState( const mstudiotexture_t& texture )
+{
+	if( texture.flags & STUDIO_NF_ADDITIVE )
+		m_pRenderContext->SetDepthMask( false );
+	else
+		m_pRenderContext->SetDepthMask( true );
 
-	glDepthMask( GL_TRUE );
+	if( texture.flags & STUDIO_NF_ADDITIVE )
+	{
+		m_pRenderContext->Enable( renderer::Capability::BLEND );
+		m_pRenderContext->SetBlendFunc( renderer::BlendFactor::SRC_ALPHA, renderer::BlendFactor::ONE );
+	}
+	else if( m_pRenderInfo->flTransparency < 1.0f )
+	{
+		m_pRenderContext->Enable( renderer::Capability::BLEND );
+		m_pRenderContext->SetBlendFunc( renderer::BlendFactor::SRC_ALPHA, renderer::BlendFactor::ONE_MINUS_SRC_ALPHA );
+	}
+	else
+		m_pRenderContext->Disable( renderer::Capability::BLEND );
 
-	return uiDrawnPolys;
+	if( texture.flags & STUDIO_NF_MASKED )
+	{
+		m_pRenderContext->Enable( renderer::Capability::ALPHA_TEST );
+		m_pRenderContext->SetAlphaFunc( renderer::CompareFunc::GREATER, 0.5f );
+	}
 }
 
 unsigned int CStudioModelRenderer::DrawMeshes( const bool bWireframe, const SortedMesh_t* pMeshes, const mstudiotexture_t* pTextures, const short* pSkinRef )
 {
-	//Set here since it never changes. Much more efficient.
-	if( bWireframe )
-		glColor4f( r_wireframecolor_r.GetFloat() / 255.0f,
-				   r_wireframecolor_g.GetFloat() / 255.0f,
-				   r_wireframecolor_b.GetFloat() / 255.0f,
-				   m_pRenderInfo->flTransparency );
+	PROFILE_SCOPE("StudioModelRenderer::DrawMeshes");
+
+	const glm::vec4 wireframeColor{ r_wireframecolor_r.GetFloat() / 255.0f,
+									r_wireframecolor_g.GetFloat() / 255.0f,
+									r_wireframecolor_b.GetFloat() / 255.0f,
+									m_pRenderInfo->flTransparency };
 
 	unsigned int uiDrawnPolys = 0;
 
 	//Polygons may overlap, so make sure they can blend together. - Solokiller
-	glDepthFunc( GL_LEQUAL );
+	m_pRenderContext->SetDepthFunc( renderer::CompareFunc::LEQUAL );
 
 	for( int j = 0; j < m_pModel->nummesh; j++ )
 	{
@@ -1071,116 +727,103 @@ unsigned int CStudioModelRenderer::DrawMeshes( const bool bWireframe, const Sort
 		const auto s = 1.0 / ( float ) texture.width;
 		const auto t = 1.0 / ( float ) texture.height;
 
-		if( texture.flags & STUDIO_NF_ADDITIVE )
-			glDepthMask( GL_FALSE );
-		else
-			glDepthMask( GL_TRUE );
-
-		if( texture.flags & STUDIO_NF_ADDITIVE )
-		{
-			glEnable( GL_BLEND );
-			glBlendFunc( GL_SRC_ALPHA, GL_ONE );
-		}
-		else if( m_pRenderInfo->flTransparency < 1.0f )
-		{
-			glEnable( GL_BLEND );
-			glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
-		}
-		else
-			glDisable( GL_BLEND );
-
-		if( texture.flags & STUDIO_NF_MASKED )
-		{
-			glEnable( GL_ALPHA_TEST );
-			glAlphaFunc( GL_GREATER, 0.5f );
-		}
+		SetupMeshState( texture );
 
+		//Meshes that share a texture are drawn one after the other, so the context filters out most binds
 		if( !bWireframe )
-		{
-			glBindTexture( GL_TEXTURE_2D, m_pRenderInfo->pModel->GetTextureId( pSkinRef[ pmesh->skinref ] ) );
-		}
+			m_pRenderContext->BindTexture( renderer::GLToTexHandle( m_pRenderInfo->pModel->GetTextureId( pMeshes[ j ].texture ) ) );
 
 		int i;
 
 		while( i = *( ptricmds++ ) )
 		{
+			renderer::PrimitiveType type;
+
 			if( i < 0 )
 			{
-				glBegin( GL_TRIANGLE_FAN );
+				type = renderer::PrimitiveType::TRIANGLE_FAN;
 				i = -i;
 			}
 			else
 			{
-				glBegin( GL_TRIANGLE_STRIP );
+				type = renderer::PrimitiveType::TRIANGLE_STRIP;
 			}
 
 			uiDrawnPolys += i - 2;
 
-			for( ; i > 0; i--, ptricmds += 4 )
+			m_StripVertices.resize( i );
+
+			for( auto& vertex : m_StripVertices )
 			{
-				if( !bWireframe )
+				vertex.Position = m_pxformverts[ ptricmds[ 0 ] ];
+
+				if( bWireframe )
+				{
+					vertex.TexCoord = glm::vec2{};
+					vertex.Color = wireframeColor;
+				}
+				else
 				{
 					if( texture.flags & STUDIO_NF_CHROME )
 					{
-						const auto& c = m_chrome[ptricmds[1]];
-
-						glTexCoord2f(c[0], c[1]);
+						vertex.TexCoord = m_pchrome[ ptricmds[ 1 ] ];
 					}
 					else
 					{
-						glTexCoord2f( ptricmds[ 2 ] * s, ptricmds[ 3 ] * t );
+						vertex.TexCoord = glm::vec2{ ptricmds[ 2 ] * s, ptricmds[ 3 ] * t };
 					}
 
 					if( texture.flags & STUDIO_NF_ADDITIVE )
 					{
-						glColor4f( 1.0f, 1.0f, 1.0f, m_pRenderInfo->flTransparency );
+						vertex.Color = glm::vec4{ 1.0f, 1.0f, 1.0f, m_pRenderInfo->flTransparency };
 					}
 					else
 					{
-						const glm::vec3& lightVec = m_pvlightvalues[ ptricmds[ 1 ] ];
-						glColor4f( lightVec[ 0 ], lightVec[ 1 ], lightVec[ 2 ], m_pRenderInfo->flTransparency );
+						vertex.Color = glm::vec4{ m_pvlightvalues[ ptricmds[ 1 ] ], m_pRenderInfo->flTransparency };
 					}
 				}
 
-				glVertex3fv( glm::value_ptr( m_pxformverts[ ptricmds[ 0 ] ] ) );
+				ptricmds += 4;
 			}
-			glEnd();
+
+			m_pRenderContext->DrawVertices( type, m_StripVertices.data(), m_StripVertices.size() );
 		}
 
 		if( texture.flags & STUDIO_NF_MASKED )
-			glDisable( GL_ALPHA_TEST );
+			m_pRenderContext->Disable( renderer::Capability::ALPHA_TEST );
 	}
 
+	m_pRenderContext->Flush();
+
 	return uiDrawnPolys;
 }
 
-unsigned int CStudioModelRenderer::DrawShadows(const bool fixZFighting, const bool wireframe)
+unsigned int CStudioModelRenderer::DrawShadows(const int bodypart, const bool fixZFighting, const bool wireframe)
 {
 	if (!(m_pStudioHdr->flags & EF_NOSHADELIGHT))
 	{
-		GLint oldDepthMask;
-		glGetIntegerv(GL_DEPTH_WRITEMASK, &oldDepthMask);
+		const bool oldDepthMask = m_pRenderContext->GetDepthMask();
 
 		if (fixZFighting)
 		{
-			glDepthMask(GL_FALSE);
+			m_pRenderContext->SetDepthMask(false);
 		}
 		else
 		{
-			glDepthMask(GL_TRUE);
+			m_pRenderContext->SetDepthMask(true);
 		}
 
 		const float r_blend = m_pRenderInfo->flTransparency;
 
 		const auto alpha = 0.5 * r_blend;
 
-		glDisable(GL_TEXTURE_2D);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glEnable(GL_BLEND);
+		m_pRenderContext->Disable(renderer::Capability::TEXTURE_2D);
+		m_pRenderContext->SetBlendFunc(renderer::BlendFactor::SRC_ALPHA, renderer::BlendFactor::ONE_MINUS_SRC_ALPHA);
+		m_pRenderContext->Enable(renderer::Capability::BLEND);
 
 		if (wireframe)
 		{
-			glColor4f(r_wireframecolor_r.GetFloat() / 255.0f,
+			m_pRenderContext->SetColor(r_wireframecolor_r.GetFloat() / 255.0f,
 				r_wireframecolor_g.GetFloat() / 255.0f,
 				r_wireframecolor_b.GetFloat() / 255.0f,
 				m_pRenderInfo->flTransparency);
@@ -1188,21 +831,21 @@ unsigned int CStudioModelRenderer::DrawShadows(const bool fixZFighting, const bo
 		else
 		{
 			//Render shadows as black
-			glColor4f(0.f, 0.f, 0.f, alpha);
+			m_pRenderContext->SetColor(0.f, 0.f, 0.f, alpha);
 		}
 
-		glDepthFunc(GL_LESS);
+		m_pRenderContext->SetDepthFunc(renderer::CompareFunc::LESS);
 
-		const auto drawnPolys = InternalDrawShadows();
+		const auto drawnPolys = InternalDrawShadows(bodypart);
 
-		glDepthFunc(GL_LEQUAL);
+		m_pRenderContext->SetDepthFunc(renderer::CompareFunc::LEQUAL);
 
-		glEnable(GL_TEXTURE_2D);
-		glDisable(GL_BLEND);
-		glColor4f(1.f, 1.f, 1.f, 1.f);
-		glShadeModel(GL_SMOOTH);
+		m_pRenderContext->Enable(renderer::Capability::TEXTURE_2D);
+		m_pRenderContext->Disable(renderer::Capability::BLEND);
+		m_pRenderContext->SetColor(1.f, 1.f, 1.f, 1.f);
+		m_pRenderContext->SetShadeModel(renderer::ShadeModel::SMOOTH);
 
-		glDepthMask(static_cast<GLboolean>(oldDepthMask));
+		m_pRenderContext->SetDepthMask(oldDepthMask);
 
 		return drawnPolys;
 	}
@@ -1212,53 +855,133 @@ unsigned int CStudioModelRenderer::DrawShadows(const bool fixZFighting, const bo
 	}
 }
 
-unsigned int CStudioModelRenderer::InternalDrawShadows()
+bool CStudioModelRenderer::UpdateRenderPose()
 {
-	unsigned int drawnPolys = 0;
+	auto& pose = m_RenderPose;
+
+	if (pose.uiFrameSerial == m_uiFrameSerial
+		&& pose.pModel == m_pRenderInfo->pModel
+		&& pose.iSequence == m_pRenderInfo->iSequence
+		&& pose.flFrame == m_pRenderInfo->flFrame
+		&& !memcmp(pose.iBlender, m_pRenderInfo->iBlender, sizeof(pose.iBlender))
+		&& !memcmp(pose.iController, m_pRenderInfo->iController, sizeof(pose.iController))
+		&& pose.iMouth == m_pRenderInfo->iMouth
+		&& pose.vecLight == m_lightvec
+		&& pose.lightColor.GetRed() == m_lightcolor.GetRed()
+		&& pose.lightColor.GetGreen() == m_lightcolor.GetGreen()
+		&& pose.lightColor.GetBlue() == m_lightcolor.GetBlue()
+		&& pose.flLambert == m_flLambert
+		&& pose.vecViewerOrigin == m_vecViewerOrigin
+		&& pose.vecViewerRight == m_vecViewerRight
+		&& pose.flOriginHeight == m_pRenderInfo->vecOrigin.z)
+	{
+		return false;
+	}
 
-	//Always at the entity origin
-	const auto lightSampleHeight = m_pRenderInfo->vecOrigin.z;
-	const auto shadowHeight = lightSampleHeight + 1.0;
+	++m_uiRenderPoseSerial;
+
+	pose.uiFrameSerial = m_uiFrameSerial;
+	pose.pModel = m_pRenderInfo->pModel;
+	pose.iSequence = m_pRenderInfo->iSequence;
+	pose.flFrame = m_pRenderInfo->flFrame;
+	memcpy(pose.iBlender, m_pRenderInfo->iBlender, sizeof(pose.iBlender));
+	memcpy(pose.iController, m_pRenderInfo->iController, sizeof(pose.iController));
+	pose.iMouth = m_pRenderInfo->iMouth;
+	pose.vecLight = m_lightvec;
+	pose.lightColor = m_lightcolor;
+	pose.flLambert = m_flLambert;
+	pose.vecViewerOrigin = m_vecViewerOrigin;
+	pose.vecViewerRight = m_vecViewerRight;
+	pose.flOriginHeight = m_pRenderInfo->vecOrigin.z;
 
-	for (int mesh = 0; mesh < m_pModel->nummesh; ++mesh)
+	return true;
+}
+
+const CStudioModelRenderer::BodyPartPlan& CStudioModelRenderer::PrepareBodyPart(const int bodypart)
+{
+	auto& plan = m_BodyPartPlans[bodypart];
+
+	const auto pTextures = m_pTextureHdr->GetTextures();
+	const short* const pSkinRef = GetSkinReferences();
+
+	if (plan.uiPoseSerial != m_uiRenderPoseSerial || plan.pSubModel != m_pModel || plan.pSkinRef != pSkinRef)
 	{
-		auto v4 = reinterpret_cast<mstudiomesh_t*>(m_pStudioHdr->GetData() + m_pModel->meshindex) + mesh;
-		drawnPolys += v4->numtris;
+		PROFILE_SCOPE("StudioModelRenderer::SkinBodyPart");
 
-		auto triCmds = reinterpret_cast<short*>(m_pStudioHdr->GetData() + v4->triindex);
+		plan.pSubModel = m_pModel;
+		plan.pSkinRef = pSkinRef;
+		plan.uiPoseSerial = m_uiRenderPoseSerial;
+		plan.uiShadowPoseSerial = 0;
 
-		for (int i; (i = *triCmds++) != 0;)
-		{
-			if (i < 0)
-			{
-				i = -i;
-				glBegin(GL_TRIANGLE_FAN);
-			}
-			else
-			{
-				glBegin(GL_TRIANGLE_STRIP);
-			}
+		plan.Vertices.resize(m_pModel->numverts);
+		plan.LightValues.resize(m_pModel->numnorms);
+		plan.Chrome.resize(m_pModel->numnorms);
 
-			for (; i > 0; --i, triCmds += 4)
-			{
-				const auto vertex{m_pxformverts[triCmds[0]]};
+		m_pxformverts = plan.Vertices.data();
+		m_pvlightvalues = plan.LightValues.data();
+		m_pchrome = plan.Chrome.data();
 
-				const auto lightDistance = vertex.z - lightSampleHeight;
+		TransformVertices();
 
-				glm::vec3 point;
+		LightVertices(pTextures, pSkinRef);
 
-				point.x = vertex.x - m_lightvec.x * lightDistance;
-				point.y = vertex.y - m_lightvec.y * lightDistance;
-				point.z = shadowHeight;
+		++m_uiSkinnedSubModelsCount;
+	}
+	else
+	{
+		m_pxformverts = plan.Vertices.data();
+		m_pvlightvalues = plan.LightValues.data();
+		m_pchrome = plan.Chrome.data();
+	}
 
-				glVertex3fv(glm::value_ptr(point));
-			}
+	return plan;
+}
 
-			glEnd();
-		}
+const CStudioModelRenderer::BodyPartPlan& CStudioModelRenderer::PrepareShadow(const int bodypart)
+{
+	auto& plan = m_BodyPartPlans[bodypart];
+
+	if (plan.uiShadowPoseSerial == plan.uiPoseSerial)
+	{
+		return plan;
+	}
+
+	PROFILE_SCOPE("StudioModelRenderer::ProjectShadows");
+
+	//Always at the entity origin
+	const float lightSampleHeight = m_pRenderInfo->vecOrigin.z;
+
+	plan.ShadowVertices.resize(plan.Vertices.size());
+
+	ProjectShadowVertices(plan.Vertices.data(), plan.Vertices.size(), m_lightvec, lightSampleHeight, lightSampleHeight + 1.0f, plan.ShadowVertices.data());
+
+	plan.uiShadowPoseSerial = plan.uiPoseSerial;
+	plan.uiShadowPolygons = 0;
+
+	const auto pMeshes = reinterpret_cast<const mstudiomesh_t*>(m_pStudioHdr->GetData() + m_pModel->meshindex);
+
+	for (int mesh = 0; mesh < m_pModel->nummesh; ++mesh)
+	{
+		plan.uiShadowPolygons += pMeshes[mesh].numtris;
+	}
+
+	return plan;
+}
+
+unsigned int CStudioModelRenderer::InternalDrawShadows(const int bodypart)
+{
+	const auto& plan = PrepareShadow(bodypart);
+
+	//Decoded once per submodel, so every pass draws the same indexed triangle list
+	const auto& indices = m_pRenderInfo->pModel->GetTriangleList(m_pModel);
+
+	if (!indices.empty())
+	{
+		m_pRenderContext->DrawPositions(renderer::PrimitiveType::TRIANGLES, plan.ShadowVertices.data(), indices.data(), indices.size());
+		m_pRenderContext->Flush();
 	}
 
-	return drawnPolys;
+	return plan.uiShadowPolygons;
 }
 
 void CStudioModelRenderer::Lighting( glm::vec3& lv, int bone, int flags, const glm::vec3& normal )
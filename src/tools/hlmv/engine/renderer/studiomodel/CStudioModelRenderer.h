@@ -1,6 +1,8 @@
 #ifndef GAME_STUDIOMODEL_CSTUDIOMODELRENDERER_H
 #define GAME_STUDIOMODEL_CSTUDIOMODELRENDERER_H
 
+#include <vector>
+
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
@@ -10,11 +12,11 @@
 #include "utility/Color.h"
 
 #include "shared/studiomodel/studio.h"
+#include "shared/studiomodel/StudioSorting.h"
 
+#include "shared/renderer/IRenderContext.h"
 #include "shared/renderer/studiomodel/IStudioModelRenderer.h"
 
-#include "StudioSorting.h"
-
 namespace studiomdl
 {
 class CStudioModel;
@@ -24,8 +26,9 @@ class CStudioModelRenderer final : public studiomdl::IStudioModelRenderer
 public:
 	/**
 	*	Constructor.
+	*	@param pRenderContext Context that state changes are made through.
 	*/
-	CStudioModelRenderer();
+	CStudioModelRenderer( renderer::IRenderContext* pRenderContext );
 
 	/**
 	*	Destructor.
@@ -42,6 +45,8 @@ public:
 
 	unsigned int GetDrawnPolygonsCount() const override final { return m_uiDrawnPolygonsCount; }
 
+	unsigned int GetSkinnedSubModelsCount() const override final { return m_uiSkinnedSubModelsCount; }
+
 	float GetLambert() const override final { return m_flLambert; }
 
 	const glm::vec3& GetViewerOrigin() const override final { return m_vecViewerOrigin; }
@@ -62,6 +67,8 @@ public:
 		m_lightvec = lightvec;
 	}
 
+	const glm::mat3x4* GetBoneTransforms() const override final { return m_bonetransform; }
+
 	unsigned int DrawModel( CModelRenderInfo* const pRenderInfo, const renderer::DrawFlags_t flags ) override final;
 
 	IStudioModelRendererListener* GetRendererListener() const override final { return m_pListener; }
@@ -73,9 +80,114 @@ public:
 
 	void DrawSingleBone( const int iBone ) override final;
 
-	void DrawSingleAttachment( const int iAttachment ) override final;
+	void DrawSingleAttachment( const AttachmentPose& attachment ) override final;
+
+	void DrawSingleHitbox(const HitboxOBB& hitbox) override final;
+
+public:
+	//The steps DrawModel takes before anything is drawn. They can be run and timed on their own after calling PrepareModel.
+	//Only SetupMeshState uses the render context.
+
+	/**
+	*	@brief Makes a model the current one the way DrawModel does, without drawing it
+	*/
+	void PrepareModel( CModelRenderInfo* const pRenderInfo );
+
+	/**
+	*	@brief Evaluates the bone transforms of the current model's sequence and frame
+	*	@see CalcBlendedBones
+	*/
+	void SetUpBones();
+
+	/**
+	*	@brief Sets the light levels and color. Doesn't depend on the bones
+	*/
+	void SetupLighting();
+
+	/**
+	*	@brief based on the body part, figure out which mesh it should be using
+	*/
+	void SetupModel( int bodypart );
+
+	/**
+	*	@brief Gets the skin references of the current skin family
+	*/
+	const short* GetSkinReferences() const;
+
+	/**
+	*	@brief Transforms the vertices of the current submodel by their bones
+	*/
+	void TransformVertices();
 
-	void DrawSingleHitbox(const int hitboxIndex) override final;
+	/**
+	*	@brief Computes the lighting and chrome texture coordinates of the normals of the current submodel
+	*/
+	void LightVertices( const mstudiotexture_t* pTextures, const short* pSkinRef );
+
+	/**
+	*	@brief Sets the depth, blend and alpha test state that a mesh with the given texture is drawn with
+	*/
+	void SetupMeshState( const mstudiotexture_t& texture );
+
+	/**
+	*	@brief Gets the submodel selected by the last call to SetupModel
+	*/
+	const mstudiomodel_t* GetCurrentSubModel() const { return m_pModel; }
+
+	/**
+	*	@brief Gets the vertices transformed by the last call to TransformVertices
+	*/
+	const glm::vec3* GetTransformedVertices() const { return m_pxformverts; }
+
+	/**
+	*	@brief Gets the lighting computed by the last call to LightVertices
+	*/
+	const glm::vec3* GetLightValues() const { return m_pvlightvalues; }
+
+private:
+	/**
+	*	@brief CPU results for one body part: skinned vertices, lighting and chrome
+	*	Computed once per render pose, then replayed by the solid, wireframe, shadow and mirrored passes.
+	*/
+	struct BodyPartPlan
+	{
+		const mstudiomodel_t* pSubModel = nullptr;
+		const short* pSkinRef = nullptr;
+		unsigned int uiPoseSerial = 0;
+
+		std::vector<glm::vec3> Vertices;
+		std::vector<glm::vec3> LightValues;
+		std::vector<glm::vec2> Chrome;
+
+		/**
+		*	Planar shadow, projected from Vertices the first time a pass needs it.
+		*/
+		unsigned int uiShadowPoseSerial = 0;
+		unsigned int uiShadowPolygons = 0;
+		std::vector<glm::vec3> ShadowVertices;
+	};
+
+	/**
+	*	@brief The render inputs that skinning, lighting and shadow projection depend on, and the bones they produce
+	*	Model data is assumed not to change during a frame.
+	*/
+	struct RenderPose
+	{
+		unsigned int uiFrameSerial = 0;
+		const CStudioModel* pModel = nullptr;
+		int iSequence = 0;
+		float flFrame = 0;
+		byte iBlender[ STUDIO_MAX_BLENDERS ] = {};
+		byte iController[ STUDIO_MAX_CONTROLLERS ] = {};
+		byte iMouth = 0;
+		glm::vec3 vecLight;
+		Color lightColor;
+		float flLambert = 0;
+		glm::vec3 vecViewerOrigin;
+		glm::vec3 vecViewerRight;
+		float flOriginHeight = 0;
+		glm::mat3x4 boneTransforms[ MAXSTUDIOBONES ];
+	};
 
 private:
 	void DrawBones();
@@ -88,36 +200,37 @@ private:
 
 	void DrawNormals();
 
-	void SetUpBones();
-	void CalcRotations( glm::vec3* pos, glm::vec4* q, const mstudioseqdesc_t* const pseqdesc, const mstudioanim_t* panim, const float f );
+	unsigned int DrawPoints( const int bodypart, const bool bWireframe );
 
-	void CalcBoneAdj();
-	void CalcBoneQuaternion( const int frame, const float s, const mstudiobone_t* const pbone, const mstudioanim_t* const panim, glm::vec4& q );
-	void CalcBonePosition( const int frame, const float s, const mstudiobone_t* const pbone, const mstudioanim_t* const panim, glm::vec3& pos );
-	void SlerpBones( glm::vec4* q1, glm::vec3* pos1, glm::vec4* q2, glm::vec3* pos2, float s );
+	unsigned int DrawMeshes( const bool bWireframe, const SortedMesh_t* pMeshes, const mstudiotexture_t* pTextures, const short* pSkinRef );
 
 	/**
-	*	@brief set some global variables based on entity position
+	*	@brief Starts a new render pose if this is a new frame, or if the model, animation, light or viewer changed since the last one
+	*	@return Whether a new pose was started. Its bones still need to be set up if so
 	*/
-	void SetupLighting();
+	bool UpdateRenderPose();
 
 	/**
-	*	@brief based on the body part, figure out which mesh it should be using
+	*	@brief Gets the plan of the current submodel, skinning and lighting it if it is out of date
+	*	Points m_pxformverts, m_pvlightvalues and m_pchrome at the plan's buffers.
 	*/
-	void SetupModel( int bodypart );
+	const BodyPartPlan& PrepareBodyPart( const int bodypart );
 
-	unsigned int DrawPoints( const bool bWireframe );
-
-	unsigned int DrawMeshes( const bool bWireframe, const SortedMesh_t* pMeshes, const mstudiotexture_t* pTextures, const short* pSkinRef );
+	/**
+	*	@brief Projects the shadow of a prepared body part if it is out of date
+	*/
+	const BodyPartPlan& PrepareShadow( const int bodypart );
 
-	unsigned int DrawShadows(const bool fixZFighting, const bool wireframe);
+	unsigned int DrawShadows(const int bodypart, const bool fixZFighting, const bool wireframe);
 
-	unsigned int InternalDrawShadows();
+	unsigned int InternalDrawShadows(const int bodypart);
 
 	void Lighting( glm::vec3& lv, int bone, int flags, const glm::vec3& normal );
 	void Chrome( glm::vec2& chrome, int bone, const glm::vec3& normal );
 
 private:
+	renderer::IRenderContext* const m_pRenderContext;
+
 	/**
 	*	Total number of models drawn by this renderer since the last time it was initialized.
 	*/
@@ -145,7 +258,25 @@ private:
 
 	glm::mat3x4		m_bonetransform[ MAXSTUDIOBONES ];	// bone transformation matrix
 
-	vec_t			m_Adj[ MAXSTUDIOCONTROLLERS ];		//This used to be a vec4, but it really needs to be this.
+	/**
+	*	The current render pose. A new pose starts every frame and whenever its inputs change,
+	*	so the passes and the mirrored draw of a frame share one set of body part plans.
+	*/
+	RenderPose		m_RenderPose;
+	unsigned int	m_uiRenderPoseSerial = 0;
+	unsigned int	m_uiFrameSerial = 1;
+
+	BodyPartPlan	m_BodyPartPlans[ MAXSTUDIOBODYPARTS ];
+
+	/**
+	*	Vertices of the triangle strip or fan being drawn. Kept around to avoid allocating memory for every strip.
+	*/
+	std::vector<renderer::Vertex> m_StripVertices;
+
+	/**
+	*	The number of times a submodel was skinned and lit since the last call to Initialize.
+	*/
+	unsigned int	m_uiSkinnedSubModelsCount = 0;
 
 	int				m_ambientlight;						// ambient world light
 	float			m_shadelight;						// direct world light
@@ -155,6 +286,7 @@ private:
 	glm::vec3		m_blightvec[ MAXSTUDIOBONES ];		// light vectors in bone reference frames
 
 	glm::vec2		m_chrome[ MAXSTUDIOVERTS ];			// texture coords for surface normals
+	glm::vec2*		m_pchrome;
 	unsigned int	m_chromeage[ MAXSTUDIOBONES ];		// last time chrome vectors were updated
 	glm::vec3		m_chromeup[ MAXSTUDIOBONES ];		// chrome vector "up" in bone reference frames
 	glm::vec3		m_chromeright[ MAXSTUDIOBONES ];	// chrome vector "right" in bone reference frames
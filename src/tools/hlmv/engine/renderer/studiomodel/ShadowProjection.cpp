@@ -0,0 +1,76 @@
+#include "ShadowProjection.h"
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#define SHADOW_PROJECTION_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace studiomdl
+{
+//The SSE path reads vertices as a flat array of floats
+static_assert( sizeof( glm::vec3 ) == sizeof( float ) * 3, "glm::vec3 must be tightly packed" );
+
+void ProjectShadowVertices( const glm::vec3* pVertices, const size_t count, const glm::vec3& vecLight,
+	const float flLightSampleHeight, const float flShadowHeight, glm::vec3* pOut )
+{
+	size_t i = 0;
+
+#ifdef SHADOW_PROJECTION_SSE
+	//4 vertices are 3 registers: x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+	//The light vector and the masks follow the same layout, so each register is projected without transposing
+	const __m128 sampleHeight = _mm_set1_ps( flLightSampleHeight );
+
+	const __m128 light0 = _mm_setr_ps( vecLight.x, vecLight.y, 0, vecLight.x );
+	const __m128 light1 = _mm_setr_ps( vecLight.y, 0, vecLight.x, vecLight.y );
+	const __m128 light2 = _mm_setr_ps( 0, vecLight.x, vecLight.y, 0 );
+
+	//All bits set in the x and y lanes, z is replaced by the shadow height
+	const __m128 one = _mm_set1_ps( 1 );
+	const __m128 keep0 = _mm_cmpeq_ps( _mm_setr_ps( 1, 1, 0, 1 ), one );
+	const __m128 keep1 = _mm_cmpeq_ps( _mm_setr_ps( 1, 0, 1, 1 ), one );
+	const __m128 keep2 = _mm_cmpeq_ps( _mm_setr_ps( 0, 1, 1, 0 ), one );
+
+	const __m128 height0 = _mm_setr_ps( 0, 0, flShadowHeight, 0 );
+	const __m128 height1 = _mm_setr_ps( 0, flShadowHeight, 0, 0 );
+	const __m128 height2 = _mm_setr_ps( flShadowHeight, 0, 0, flShadowHeight );
+
+	for( ; i + 4 <= count; i += 4 )
+	{
+		const float* const pIn = &pVertices[ i ].x;
+		float* const pDest = &pOut[ i ].x;
+
+		const __m128 in0 = _mm_loadu_ps( pIn );
+		const __m128 in1 = _mm_loadu_ps( pIn + 4 );
+		const __m128 in2 = _mm_loadu_ps( pIn + 8 );
+
+		//Distance to the light: d0 d0 d1 d1 and d2 d2 d3 d3
+		const __m128 distance01 = _mm_sub_ps( _mm_shuffle_ps( in0, in1, _MM_SHUFFLE( 1, 1, 2, 2 ) ), sampleHeight );
+		const __m128 distance23 = _mm_sub_ps( _mm_shuffle_ps( in2, in2, _MM_SHUFFLE( 3, 3, 0, 0 ) ), sampleHeight );
+
+		//Spread the distances over the lanes of their vertices
+		const __m128 distance0 = _mm_shuffle_ps( distance01, distance01, _MM_SHUFFLE( 2, 0, 0, 0 ) );
+		const __m128 distance1 = _mm_shuffle_ps( distance01, distance23, _MM_SHUFFLE( 1, 0, 3, 2 ) );
+		const __m128 distance2 = _mm_shuffle_ps( distance23, distance23, _MM_SHUFFLE( 2, 2, 2, 0 ) );
+
+		const __m128 out0 = _mm_sub_ps( in0, _mm_mul_ps( light0, distance0 ) );
+		const __m128 out1 = _mm_sub_ps( in1, _mm_mul_ps( light1, distance1 ) );
+		const __m128 out2 = _mm_sub_ps( in2, _mm_mul_ps( light2, distance2 ) );
+
+		_mm_storeu_ps( pDest, _mm_or_ps( _mm_and_ps( out0, keep0 ), height0 ) );
+		_mm_storeu_ps( pDest + 4, _mm_or_ps( _mm_and_ps( out1, keep1 ), height1 ) );
+		_mm_storeu_ps( pDest + 8, _mm_or_ps( _mm_and_ps( out2, keep2 ), height2 ) );
+	}
+#endif
+
+	for( ; i < count; ++i )
+	{
+		const auto& vertex = pVertices[ i ];
+
+		const float lightDistance = vertex.z - flLightSampleHeight;
+
+		pOut[ i ].x = vertex.x - vecLight.x * lightDistance;
+		pOut[ i ].y = vertex.y - vecLight.y * lightDistance;
+		pOut[ i ].z = flShadowHeight;
+	}
+}
+}
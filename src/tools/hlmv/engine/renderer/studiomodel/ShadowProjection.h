@@ -0,0 +1,25 @@
+#ifndef GAME_STUDIOMODEL_SHADOWPROJECTION_H
+#define GAME_STUDIOMODEL_SHADOWPROJECTION_H
+
+#include <cstddef>
+
+#include <glm/vec3.hpp>
+
+namespace studiomdl
+{
+/**
+*	@brief Projects vertices along the light vector onto the horizontal plane at flShadowHeight
+*	Matches the game: the distance to the light is measured from flLightSampleHeight, not from the shadow plane.
+*	Uses SSE when the compiler targets it, 4 vertices at a time.
+*	@param pVertices Vertices to project
+*	@param count Number of vertices
+*	@param vecLight Light vector. Only x and y are used
+*	@param flLightSampleHeight Height the light is sampled at
+*	@param flShadowHeight Height of the shadow plane
+*	@param pOut Receives count projected vertices. Must not overlap pVertices
+*/
+void ProjectShadowVertices( const glm::vec3* pVertices, const size_t count, const glm::vec3& vecLight,
+	const float flLightSampleHeight, const float flShadowHeight, glm::vec3* pOut );
+}
+
+#endif //GAME_STUDIOMODEL_SHADOWPROJECTION_H
@@ -20,7 +20,8 @@ const Mat4x4& CMatrixStack::GetMatrix( const MatrixMode::MatrixMode mode ) const
 
 void CMatrixStack::PushMatrix( const MatrixMode::MatrixMode mode )
 {
-	m_Stacks[ mode ].push( Mat4x4() );
+	//Like glPushMatrix, the new top starts as a copy of the current matrix.
+	m_Stacks[ mode ].push( m_Stacks[ mode ].top() );
 }
 
 void CMatrixStack::PopMatrix( const MatrixMode::MatrixMode mode )
@@ -0,0 +1,209 @@
+#include "core/shared/Logging.h"
+
+#include "CVertexBatch.h"
+
+namespace renderer
+{
+CVertexBatch::ListType CVertexBatch::GetListType( const PrimitiveType type, const PolygonMode polygonMode )
+{
+	switch( type )
+	{
+	case PrimitiveType::POINTS:			return ListType::POINTS;
+	case PrimitiveType::LINES:			return ListType::LINES;
+
+	case PrimitiveType::TRIANGLES:
+	case PrimitiveType::TRIANGLE_STRIP:
+	case PrimitiveType::TRIANGLE_FAN:	return ListType::TRIANGLES;
+
+	case PrimitiveType::QUAD_STRIP:		return polygonMode == PolygonMode::LINE ? ListType::LINES : ListType::TRIANGLES;
+
+	default:
+		{
+			Error( "CVertexBatch::GetListType: Invalid primitive type \"%d\"\n", type );
+			return ListType::NONE;
+		}
+	}
+}
+
+size_t CVertexBatch::GetVerticesPerPrimitive( const ListType type )
+{
+	switch( type )
+	{
+	case ListType::POINTS:		return 1;
+	case ListType::LINES:		return 2;
+	case ListType::TRIANGLES:	return 3;
+
+	default:					return 0;
+	}
+}
+
+void CVertexBatch::Append( const PrimitiveType type, const Vertex* pVertices, const size_t uiCount, const PolygonMode polygonMode, const ShadeModel shadeModel )
+{
+	AppendPrimitives( type, uiCount, polygonMode, shadeModel,
+		[ = ]( const size_t uiIndex )
+		{
+			return pVertices[ uiIndex ];
+		} );
+}
+
+void CVertexBatch::Append( const PrimitiveType type, const glm::vec3* pPositions, const unsigned short* pIndices, const size_t uiCount,
+	const glm::vec4& color, const PolygonMode polygonMode )
+{
+	//Every vertex has the same color, so flat shading would not change anything.
+	if( pIndices )
+	{
+		AppendPrimitives( type, uiCount, polygonMode, ShadeModel::SMOOTH,
+			[ & ]( const size_t uiIndex )
+			{
+				return Vertex{ pPositions[ pIndices[ uiIndex ] ], glm::vec2{}, color };
+			} );
+	}
+	else
+	{
+		AppendPrimitives( type, uiCount, polygonMode, ShadeModel::SMOOTH,
+			[ & ]( const size_t uiIndex )
+			{
+				return Vertex{ pPositions[ uiIndex ], glm::vec2{}, color };
+			} );
+	}
+}
+
+void CVertexBatch::Clear()
+{
+	m_ListType = ListType::NONE;
+	m_Vertices.clear();
+}
+
+template<typename GETVERTEX>
+void CVertexBatch::AppendPrimitives( const PrimitiveType type, const size_t uiCount, const PolygonMode polygonMode, const ShadeModel shadeModel, GETVERTEX getVertex )
+{
+	const auto listType = GetListType( type, polygonMode );
+
+	if( listType == ListType::NONE )
+		return;
+
+	if( m_ListType != ListType::NONE && m_ListType != listType )
+	{
+		Error( "CVertexBatch::Append: Cannot add primitives of a different list type\n" );
+		return;
+	}
+
+	m_ListType = listType;
+
+	const bool bFlat = shadeModel == ShadeModel::FLAT;
+
+	//OpenGL uses the last vertex of each primitive for flat shading, so every primitive added here ends with that vertex.
+	auto addTriangle = [ & ]( const size_t uiFirst, const size_t uiSecond, const size_t uiThird )
+	{
+		const auto third = getVertex( uiThird );
+
+		m_Vertices.push_back( getVertex( uiFirst ) );
+		m_Vertices.push_back( getVertex( uiSecond ) );
+		m_Vertices.push_back( third );
+
+		if( bFlat )
+		{
+			m_Vertices[ m_Vertices.size() - 3 ].Color = third.Color;
+			m_Vertices[ m_Vertices.size() - 2 ].Color = third.Color;
+		}
+	};
+
+	auto addLine = [ & ]( const size_t uiFirst, const size_t uiSecond, const glm::vec4* pFlatColor )
+	{
+		m_Vertices.push_back( getVertex( uiFirst ) );
+		m_Vertices.push_back( getVertex( uiSecond ) );
+
+		if( pFlatColor )
+		{
+			m_Vertices[ m_Vertices.size() - 2 ].Color = *pFlatColor;
+			m_Vertices[ m_Vertices.size() - 1 ].Color = *pFlatColor;
+		}
+	};
+
+	switch( type )
+	{
+	case PrimitiveType::POINTS:
+		{
+			for( size_t i = 0; i < uiCount; ++i )
+			{
+				m_Vertices.push_back( getVertex( i ) );
+			}
+
+			break;
+		}
+
+	case PrimitiveType::LINES:
+		{
+			for( size_t i = 0; i + 1 < uiCount; i += 2 )
+			{
+				const auto second = getVertex( i + 1 );
+
+				addLine( i, i + 1, bFlat ? &second.Color : nullptr );
+			}
+
+			break;
+		}
+
+	case PrimitiveType::TRIANGLES:
+		{
+			for( size_t i = 0; i + 2 < uiCount; i += 3 )
+			{
+				addTriangle( i, i + 1, i + 2 );
+			}
+
+			break;
+		}
+
+	case PrimitiveType::TRIANGLE_STRIP:
+		{
+			//Every other triangle has its first two vertices swapped to keep the winding order.
+			for( size_t i = 0; i + 2 < uiCount; ++i )
+			{
+				if( i & 1 )
+					addTriangle( i + 1, i, i + 2 );
+				else
+					addTriangle( i, i + 1, i + 2 );
+			}
+
+			break;
+		}
+
+	case PrimitiveType::TRIANGLE_FAN:
+		{
+			for( size_t i = 0; i + 2 < uiCount; ++i )
+			{
+				addTriangle( 0, i + 1, i + 2 );
+			}
+
+			break;
+		}
+
+	case PrimitiveType::QUAD_STRIP:
+		{
+			//Quad i has vertices 2i, 2i + 1, 2i + 3, 2i + 2 in winding order, and uses the color of 2i + 3 for flat shading.
+			for( size_t i = 0; i + 3 < uiCount; i += 2 )
+			{
+				if( listType == ListType::LINES )
+				{
+					const auto last = getVertex( i + 3 );
+					const glm::vec4* pFlatColor = bFlat ? &last.Color : nullptr;
+
+					addLine( i, i + 1, pFlatColor );
+					addLine( i + 1, i + 3, pFlatColor );
+					addLine( i + 3, i + 2, pFlatColor );
+					addLine( i + 2, i, pFlatColor );
+				}
+				else
+				{
+					addTriangle( i, i + 1, i + 3 );
+					addTriangle( i + 2, i, i + 3 );
+				}
+			}
+
+			break;
+		}
+
+	default: break;
+	}
+}
+}
@@ -0,0 +1,85 @@
+#ifndef ENGINE_RENDERER_UTIL_CVERTEXBATCH_H
+#define ENGINE_RENDERER_UTIL_CVERTEXBATCH_H
+
+#include <vector>
+
+#include "engine/shared/renderer/IRenderContext.h"
+
+namespace renderer
+{
+/**
+*	Collects primitives as a list of points, lines or triangles so consecutive draws can be submitted with a single draw call.
+*	Strips, fans and quad strips are split into separate primitives, since they cannot be joined.
+*/
+class CVertexBatch final
+{
+public:
+	/**
+	*	Kinds of primitive lists that a batch can hold.
+	*/
+	enum class ListType
+	{
+		NONE,
+		POINTS,
+		LINES,
+		TRIANGLES
+	};
+
+public:
+	CVertexBatch() = default;
+
+	/**
+	*	@return The list type that primitives of the given type are converted to.
+	*/
+	static ListType GetListType( const PrimitiveType type, const PolygonMode polygonMode );
+
+	/**
+	*	@return Number of vertices per primitive in the given list type.
+	*/
+	static size_t GetVerticesPerPrimitive( const ListType type );
+
+	/**
+	*	@return The list type of the primitives in this batch, or ListType::NONE if it is empty.
+	*/
+	ListType GetListType() const { return m_ListType; }
+
+	bool IsEmpty() const { return m_Vertices.empty(); }
+
+	const std::vector<Vertex>& GetVertices() const { return m_Vertices; }
+
+	/**
+	*	Appends primitives. Must only be called if the batch is empty or holds the list type that they convert to.
+	*	@param polygonMode Quad strips are converted to their edges if polygons are drawn as lines,
+	*		so the diagonals of the triangles they are split into do not show up.
+	*	@param shadeModel With flat shading, every vertex of a primitive gets the color of its last vertex.
+	*/
+	void Append( const PrimitiveType type, const Vertex* pVertices, const size_t uiCount, const PolygonMode polygonMode, const ShadeModel shadeModel );
+
+	/**
+	*	Appends primitives that all have the given color and no texture coordinates.
+	*	@see IRenderContext::DrawPositions
+	*/
+	void Append( const PrimitiveType type, const glm::vec3* pPositions, const unsigned short* pIndices, const size_t uiCount,
+		const glm::vec4& color, const PolygonMode polygonMode );
+
+	/**
+	*	Removes all primitives. Keeps the memory for reuse.
+	*/
+	void Clear();
+
+private:
+	/**
+	*	Appends primitives.
+	*	@param getVertex Returns the vertex at the given index.
+	*/
+	template<typename GETVERTEX>
+	void AppendPrimitives( const PrimitiveType type, const size_t uiCount, const PolygonMode polygonMode, const ShadeModel shadeModel, GETVERTEX getVertex );
+
+private:
+	ListType m_ListType = ListType::NONE;
+
+	std::vector<Vertex> m_Vertices;
+};
+}
+
+#endif //ENGINE_RENDERER_UTIL_CVERTEXBATCH_H
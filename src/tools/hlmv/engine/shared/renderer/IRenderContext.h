@@ -1,6 +1,10 @@
 #ifndef ENGINE_RENDERER_IRENDERCONTEXT_H
 #define ENGINE_RENDERER_IRENDERCONTEXT_H
 
+#include <cstddef>
+
+#include <glm/vec2.hpp>
+
 #include "core/shared/Const.h"
 #include "core/shared/Utility.h"
 
@@ -133,7 +137,124 @@ typedef void* HTexture_t;
 /**
 *	Null texture handle. This represents "no" texture.
 */
-#define NULL_TEXTURE_HANDLE ( reinterpret_cast<HTexture_t>( 0 ) )
+#define NULL_TEXTURE_HANDLE ( reinterpret_cast<renderer::HTexture_t>( 0 ) )
+
+/**
+*	Capabilities that can be enabled and disabled.
+*/
+enum class Capability
+{
+	BLEND,
+	DEPTH_TEST,
+	ALPHA_TEST,
+	CULL_FACE,
+	TEXTURE_2D,
+
+	COUNT
+};
+
+/**
+*	Blend factors.
+*/
+enum class BlendFactor
+{
+	ZERO,
+	ONE,
+	SRC_ALPHA,
+	ONE_MINUS_SRC_ALPHA
+};
+
+/**
+*	Comparison functions used by the depth and alpha tests.
+*/
+enum class CompareFunc
+{
+	NEVER,
+	LESS,
+	EQUAL,
+	LEQUAL,
+	GREATER,
+	NOTEQUAL,
+	GEQUAL,
+	ALWAYS
+};
+
+/**
+*	How polygons are rasterized.
+*/
+enum class PolygonMode
+{
+	/**
+	*	Fill the polygon.
+	*/
+	FILL,
+
+	/**
+	*	Draw the edges of the polygon.
+	*/
+	LINE
+};
+
+/**
+*	How colors are interpolated across primitives.
+*/
+enum class ShadeModel
+{
+	/**
+	*	Interpolate the colors of the vertices.
+	*/
+	SMOOTH,
+
+	/**
+	*	Use the color of the last vertex of each primitive.
+	*/
+	FLAT
+};
+
+/**
+*	Primitive types that vertices can be drawn as.
+*/
+enum class PrimitiveType
+{
+	POINTS,
+	LINES,
+	TRIANGLES,
+	TRIANGLE_STRIP,
+	TRIANGLE_FAN,
+	QUAD_STRIP
+};
+
+/**
+*	Vertex with its own texture coordinates and color.
+*	@see IRenderContext::DrawVertices
+*/
+struct Vertex
+{
+	glm::vec3 Position;
+	glm::vec2 TexCoord;
+	glm::vec4 Color;
+};
+
+/**
+*	Maximum number of texture units whose bound texture is tracked.
+*/
+const unsigned int MAX_TEXTURE_UNITS = 8;
+
+/**
+*	Number of state changes requested from a render context.
+*/
+struct StateChangeStats
+{
+	/**
+	*	Changes that were passed on to the graphics API.
+	*/
+	unsigned int uiIssued = 0;
+
+	/**
+	*	Changes that were dropped because the state already had the requested value.
+	*/
+	unsigned int uiFiltered = 0;
+};
 
 /**
 *	Renderer context. Provides access to a variety of context specific operations.
@@ -259,6 +380,110 @@ public:
 	*/
 	virtual void SetCullFace( const CullFace cullFace ) = 0;
 
+	//State operations
+	//The context shadows these states so changes that would not change anything are not passed on to the graphics API.
+	//Code that changes them without going through the context must call InvalidateState afterwards.
+
+	/**
+	*	Enables a capability.
+	*/
+	virtual void Enable( const Capability capability ) = 0;
+
+	/**
+	*	Disables a capability.
+	*/
+	virtual void Disable( const Capability capability ) = 0;
+
+	/**
+	*	Sets the blend function.
+	*	@param src Factor for the incoming color.
+	*	@param dst Factor for the color in the framebuffer.
+	*/
+	virtual void SetBlendFunc( const BlendFactor src, const BlendFactor dst ) = 0;
+
+	/**
+	*	@return Whether writing to the depth buffer is enabled.
+	*/
+	virtual bool GetDepthMask() const = 0;
+
+	/**
+	*	Sets whether writing to the depth buffer is enabled.
+	*/
+	virtual void SetDepthMask( const bool bWrite ) = 0;
+
+	/**
+	*	Sets the depth test function.
+	*/
+	virtual void SetDepthFunc( const CompareFunc func ) = 0;
+
+	/**
+	*	Sets the alpha test function.
+	*	@param func Comparison function.
+	*	@param flRef Reference value to compare alpha against.
+	*/
+	virtual void SetAlphaFunc( const CompareFunc func, const float flRef ) = 0;
+
+	/**
+	*	Sets the current color.
+	*/
+	virtual void SetColor( float flR, float flG, float flB, float flA = 1 ) = 0;
+
+	/**
+	*	Sets how polygons are rasterized. Applies to both front and back faces.
+	*/
+	virtual void SetPolygonMode( const PolygonMode mode ) = 0;
+
+	/**
+	*	Sets how colors are interpolated across primitives.
+	*/
+	virtual void SetShadeModel( const ShadeModel model ) = 0;
+
+	/**
+	*	Sets the texture unit that BindTexture and SetMinMagFilters operate on.
+	*	@param uiUnit Texture unit. Must be smaller than MAX_TEXTURE_UNITS.
+	*/
+	virtual void SetActiveTextureUnit( const unsigned int uiUnit ) = 0;
+
+	/**
+	*	Forgets the shadowed state, so the next change to each state is passed on to the graphics API.
+	*	Call when code outside the context may have changed state.
+	*/
+	virtual void InvalidateState() = 0;
+
+	/**
+	*	@return Number of state changes requested since the last call to ResetStateChangeStats.
+	*/
+	virtual const StateChangeStats& GetStateChangeStats() const = 0;
+
+	virtual void ResetStateChangeStats() = 0;
+
+	//Draw operations
+	//Contexts may batch draws until a state change requires them to be submitted.
+	//Code that changes state without going through the context must call Flush first.
+
+	/**
+	*	Draws vertices that have their own texture coordinates and color.
+	*	The current color is undefined afterwards.
+	*	@param type Primitive type.
+	*	@param pVertices Vertices.
+	*	@param uiCount Number of vertices.
+	*/
+	virtual void DrawVertices( const PrimitiveType type, const Vertex* pVertices, const size_t uiCount ) = 0;
+
+	/**
+	*	Draws positions in the current color, without texture coordinates.
+	*	@param type Primitive type.
+	*	@param pPositions Positions.
+	*	@param pIndices Indices into pPositions. If null, the positions are drawn in order.
+	*	@param uiCount Number of indices, or positions if pIndices is null.
+	*/
+	virtual void DrawPositions( const PrimitiveType type, const glm::vec3* pPositions, const unsigned short* pIndices, const size_t uiCount ) = 0;
+
+	/**
+	*	Submits draws that the context has batched.
+	*/
+	virtual void Flush() = 0;
+
 	/**
 	*	@return The current read buffer setting.
 	*	@see SetReadBuffer
@@ -305,7 +530,7 @@ public:
 	virtual void DestroyTexture( HTexture_t hTexture ) = 0;
 
 	/**
-	*	Binds the given texture. Can be NULL_TEXTURE_HANDLE, in which case the current texture is unbound.
+	*	Binds the given texture to the active texture unit. Can be NULL_TEXTURE_HANDLE, in which case the current texture is unbound.
 	*	TODO texture type
 	*	@see NULL_TEXTURE_HANDLE
 	*/
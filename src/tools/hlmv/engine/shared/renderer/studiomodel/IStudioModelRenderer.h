@@ -2,6 +2,7 @@
 #define ENGINE_STUDIOMODEL_ISTUDIOMODELRENDERER_H
 
 #include <glm/vec3.hpp>
+#include <glm/mat3x4.hpp>
 
 #include "shared/Const.h"
 
@@ -19,6 +20,8 @@ namespace studiomdl
 {
 class CStudioModel;
 class IStudioModelRendererListener;
+struct AttachmentPose;
+struct HitboxOBB;
 
 /**
 *	Used to render studio models. Only one instance of this class should be used, and should be kept around, in order to achieve reasonably performant and consistent rendering.
@@ -54,6 +57,12 @@ public:
 	*/
 	virtual unsigned int GetDrawnPolygonsCount() const = 0;
 
+	/**
+	*	@return The number of times a submodel was skinned and lit since the last call to Initialize.
+	*	Passes that replay an earlier pose of the same frame don't count.
+	*/
+	virtual unsigned int GetSkinnedSubModelsCount() const = 0;
+
 	/**
 	*	@return The current lambert value. Modifier for pseudo-hemispherical lighting.
 	*/
@@ -94,6 +103,12 @@ public:
 	*/
 	virtual void SetLightVector( const glm::vec3& lightvec ) = 0;
 
+	/**
+	*	@return The bone transforms of the last model that was drawn, relative to the model's origin.
+	*	Only the first studiohdr_t::numbones transforms are valid.
+	*/
+	virtual const glm::mat3x4* GetBoneTransforms() const = 0;
+
 	/**
 	*	Draws the given model.
 	*	@param pRenderInfo Render info that describes the model.
@@ -125,11 +140,15 @@ public:
 
 	/**
 	*	Draws a single attachment.
-	*	@param iAttachment Index of the attachment to draw.
+	*	@param attachment Posed attachment to draw, relative to the model's origin.
 	*/
-	virtual void DrawSingleAttachment( const int iAttachment ) = 0;
+	virtual void DrawSingleAttachment( const AttachmentPose& attachment ) = 0;
 
-	virtual void DrawSingleHitbox(const int hitboxIndex) = 0;
+	/**
+	*	Draws a single hitbox.
+	*	@param hitbox Posed hitbox to draw, relative to the model's origin.
+	*/
+	virtual void DrawSingleHitbox( const HitboxOBB& hitbox ) = 0;
 };
 }
 
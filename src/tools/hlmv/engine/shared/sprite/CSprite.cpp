@@ -76,7 +76,7 @@ void Convert8To32Bit( const byte* pInPalette, byte* pRGBAPalette, const TexForma
 	}
 }
 
-byte* LoadSpriteFrame( byte* pIn, mspriteframe_t** ppFrame, const int iFrame, const byte* pRGBAPalette )
+byte* LoadSpriteFrame( byte* pIn, mspriteframe_t** ppFrame, const int iFrame, const byte* pRGBAPalette, const bool bUploadTextures )
 {
 	assert( pIn );
 	assert( ppFrame );
@@ -104,8 +104,6 @@ byte* LoadSpriteFrame( byte* pIn, mspriteframe_t** ppFrame, const int iFrame, co
 
 	byte* pPixelData = reinterpret_cast<byte*>( pFrame + 1 );
 
-	glGenTextures( 1, &pSpriteFrame->gl_texturenum );
-
 	std::unique_ptr<byte[]> rgba = std::make_unique<byte[]>( iWidth * iHeight * 4 );
 
 	byte* out  = rgba.get();
@@ -121,6 +119,13 @@ byte* LoadSpriteFrame( byte* pIn, mspriteframe_t** ppFrame, const int iFrame, co
 		}
 	}
 
+	if( !bUploadTextures )
+	{
+		return pPixelData + ( iWidth * iHeight );
+	}
+
+	glGenTextures( 1, &pSpriteFrame->gl_texturenum );
+
 	//TODO: this is the same code as used by studiomodel. Refactor.
 	//TODO: it might be better to upload sprites as a single large texture containing all frames.
 	glBindTexture( GL_TEXTURE_2D, pSpriteFrame->gl_texturenum );
@@ -132,7 +137,7 @@ byte* LoadSpriteFrame( byte* pIn, mspriteframe_t** ppFrame, const int iFrame, co
 	return pPixelData + ( iWidth * iHeight );
 }
 
-byte* LoadSpriteGroup( byte* pIn, mspriteframe_t** ppFrame, const int iFrame, const byte* pRGBAPalette )
+byte* LoadSpriteGroup( byte* pIn, mspriteframe_t** ppFrame, const int iFrame, const byte* pRGBAPalette, const bool bUploadTextures )
 {
 	dspritegroup_t* pGroup = reinterpret_cast<dspritegroup_t*>( pIn );
 
@@ -163,13 +168,13 @@ byte* LoadSpriteGroup( byte* pIn, mspriteframe_t** ppFrame, const int iFrame, co
 
 	for( int iIndex = 0; iIndex < iNumFrames; ++iIndex )
 	{
-		pInput = LoadSpriteFrame( pInput, &pSpriteGroup->frames[ iIndex ], iFrame * 100 + iIndex, pRGBAPalette );
+		pInput = LoadSpriteFrame( pInput, &pSpriteGroup->frames[ iIndex ], iFrame * 100 + iIndex, pRGBAPalette, bUploadTextures );
 	}
 
 	return pInput;
 }
 
-bool LoadSpriteInternal( byte* pIn, msprite_t*& pSprite )
+bool LoadSpriteInternal( byte* pIn, msprite_t*& pSprite, const bool bUploadTextures )
 {
 	assert( pIn );
 
@@ -231,11 +236,11 @@ bool LoadSpriteInternal( byte* pIn, msprite_t*& pSprite )
 
 		if( type == spriteframetype_t::SINGLE )
 		{
-			pType = reinterpret_cast<spriteframetype_t*>( LoadSpriteFrame( reinterpret_cast<byte*>( pType + 1 ), &pSprite->frames[ iFrame ].frameptr, iFrame, convertedPalette ) );
+			pType = reinterpret_cast<spriteframetype_t*>( LoadSpriteFrame( reinterpret_cast<byte*>( pType + 1 ), &pSprite->frames[ iFrame ].frameptr, iFrame, convertedPalette, bUploadTextures ) );
 		}
 		else
 		{
-			pType = reinterpret_cast<spriteframetype_t*>( LoadSpriteGroup( reinterpret_cast<byte*>( pType + 1 ), &pSprite->frames[ iFrame ].frameptr, iFrame, convertedPalette ) );
+			pType = reinterpret_cast<spriteframetype_t*>( LoadSpriteGroup( reinterpret_cast<byte*>( pType + 1 ), &pSprite->frames[ iFrame ].frameptr, iFrame, convertedPalette, bUploadTextures ) );
 		}
 	}
 
@@ -243,7 +248,7 @@ bool LoadSpriteInternal( byte* pIn, msprite_t*& pSprite )
 }
 }
 
-bool LoadSprite( const char* const pszFilename, msprite_t*& pSprite )
+bool LoadSprite( const char* const pszFilename, msprite_t*& pSprite, const bool bUploadTextures )
 {
 	assert( pszFilename );
 
@@ -267,7 +272,7 @@ bool LoadSprite( const char* const pszFilename, msprite_t*& pSprite )
 
 	if( bSuccess )
 	{
-		bSuccess = LoadSpriteInternal( pBuffer.get(), pSprite );
+		bSuccess = LoadSpriteInternal( pBuffer.get(), pSprite, bUploadTextures );
 	}
 
 	if( !bSuccess )
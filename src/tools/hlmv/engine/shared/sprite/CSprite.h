@@ -5,7 +5,14 @@
 
 namespace sprite
 {
-bool LoadSprite( const char* const pszFilename, msprite_t*& pSprite );
+/**
+*	Loads a sprite.
+*	@param pszFilename Name of the sprite to load. This is the entire path, including the extension.
+*	@param pSprite Receives the sprite, or null on failure.
+*	@param bUploadTextures Whether to upload the frames to OpenGL. If false, frames are decoded but have no texture, which allows loading without a render context.
+*	@return Whether the sprite was loaded.
+*/
+bool LoadSprite( const char* const pszFilename, msprite_t*& pSprite, const bool bUploadTextures = true );
 
 void FreeSprite( msprite_t* pSprite );
 }
@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "shared/Platform.h"
+
+#include "utility/IOUtils.h"
+
+#include "studio.h"
+
+#include "CModelDirectoryCache.h"
+
+namespace studiomdl
+{
+namespace
+{
+bool CompareFileInfoByName(const ModelFileInfo& lhs, const ModelFileInfo& rhs)
+{
+	return lhs.FileName < rhs.FileName;
+}
+}
+
+void ReadModelFileInfo(const std::filesystem::path& fileName, ModelFileInfo& info)
+{
+	info.Id = 0;
+	info.Version = 0;
+	info.Type = ModelFileType::INVALID;
+
+	FILE* file = utf8_fopen(fileName.u8string().c_str(), "rb");
+
+	if (!file)
+	{
+		return;
+	}
+
+	//Main, texture and sequence group headers all start with the same layout, so only read that much
+	studioseqhdr_t header;
+
+	if (fread(&header, sizeof(header), 1, file) == 1)
+	{
+		info.Id = header.id;
+		info.Version = header.version;
+
+		if (header.version == STUDIO_VERSION)
+		{
+			if (!strncmp(reinterpret_cast<const char*>(&header.id), STUDIOMDL_HDR_ID, 4))
+			{
+				//Texture files have no name
+				info.Type = header.name[0] != '\0' ? ModelFileType::MAIN : ModelFileType::TEXTURE;
+			}
+			else if (!strncmp(reinterpret_cast<const char*>(&header.id), STUDIOMDL_SEQ_ID, 4))
+			{
+				info.Type = ModelFileType::SEQUENCEGROUP;
+			}
+		}
+	}
+
+	fclose(file);
+}
+
+CModelDirectoryCache::CModelDirectoryCache()
+{
+	m_Worker = std::thread(&CModelDirectoryCache::WorkerMain, this);
+}
+
+CModelDirectoryCache::~CModelDirectoryCache()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_bShutdown = true;
+	}
+
+	m_WorkCondition.notify_one();
+
+	m_Worker.join();
+}
+
+void CModelDirectoryCache::SetDirectory(const std::filesystem::path& directory)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		if (m_Directory != directory)
+		{
+			m_Directory = directory;
+			m_Files.clear();
+			m_bHasListing = false;
+		}
+
+		m_bScanRequested = true;
+	}
+
+	m_WorkCondition.notify_one();
+}
+
+void CModelDirectoryCache::Refresh()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		if (m_Directory.empty())
+		{
+			return;
+		}
+
+		m_bScanRequested = true;
+	}
+
+	m_WorkCondition.notify_one();
+}
+
+std::filesystem::path CModelDirectoryCache::FindRelativeModel(const std::filesystem::path& currentFile, bool next)
+{
+	std::filesystem::path result;
+
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+
+		if (m_Directory.empty())
+		{
+			return {};
+		}
+
+		m_ScanCompleteCondition.wait(lock, [this] { return m_bHasListing || m_bShutdown; });
+
+		ModelFileInfo key;
+		key.FileName = currentFile;
+
+		const auto it = std::lower_bound(m_Files.begin(), m_Files.end(), key, CompareFileInfoByName);
+
+		const auto count = static_cast<std::ptrdiff_t>(m_Files.size());
+
+		//If the current file is not in the listing (e.g. it was just created) then start from where it would have been
+		const bool found = it != m_Files.end() && it->FileName == currentFile;
+
+		const auto start = it - m_Files.begin();
+
+		if (count > 0)
+		{
+			const std::ptrdiff_t step = next ? 1 : count - 1;
+
+			auto index = found ? (start + step) % count : (next ? start % count : (start + count - 1) % count);
+
+			for (std::ptrdiff_t visited = 0; visited < count; ++visited, index = (index + step) % count)
+			{
+				const auto& info = m_Files[index];
+
+				if (info.Type == ModelFileType::MAIN && info.FileName != currentFile)
+				{
+					result = info.FileName;
+					break;
+				}
+			}
+		}
+
+		m_bScanRequested = true;
+	}
+
+	m_WorkCondition.notify_one();
+
+	return result;
+}
+
+std::vector<ModelFileInfo> CModelDirectoryCache::GetFiles() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	return m_Files;
+}
+
+void CModelDirectoryCache::WorkerMain()
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+
+	while (true)
+	{
+		m_WorkCondition.wait(lock, [this] { return m_bScanRequested || m_bShutdown; });
+
+		if (m_bShutdown)
+		{
+			break;
+		}
+
+		m_bScanRequested = false;
+
+		const auto directory = m_Directory;
+		const auto previous = m_Files;
+
+		lock.unlock();
+
+		auto files = ScanDirectory(directory, previous);
+
+		lock.lock();
+
+		//Discard the result if the directory was changed while scanning; a new scan has been queued already
+		if (directory == m_Directory)
+		{
+			m_Files = std::move(files);
+			m_bHasListing = true;
+		}
+
+		m_ScanCompleteCondition.notify_all();
+	}
+
+	m_ScanCompleteCondition.notify_all();
+}
+
+std::vector<ModelFileInfo> CModelDirectoryCache::ScanDirectory(const std::filesystem::path& directory, const std::vector<ModelFileInfo>& previous)
+{
+	std::vector<ModelFileInfo> files;
+
+	std::error_code error;
+
+	std::filesystem::directory_iterator it{directory, error};
+
+	if (error)
+	{
+		return files;
+	}
+
+	for (const std::filesystem::directory_iterator end; it != end; it.increment(error))
+	{
+		if (error)
+		{
+			break;
+		}
+
+		const auto& entry = *it;
+
+		if (!entry.is_regular_file(error) || strcasecmp(entry.path().extension().u8string().c_str(), ".mdl"))
+		{
+			continue;
+		}
+
+		ModelFileInfo info;
+
+		info.FileName = entry.path();
+		info.LastWriteTime = entry.last_write_time(error);
+
+		if (error)
+		{
+			continue;
+		}
+
+		const auto existing = std::lower_bound(previous.begin(), previous.end(), info, CompareFileInfoByName);
+
+		if (existing != previous.end() && existing->FileName == info.FileName && existing->LastWriteTime == info.LastWriteTime)
+		{
+			//Unchanged since the last scan, reuse the header information
+			files.emplace_back(*existing);
+		}
+		else
+		{
+			ReadModelFileInfo(info.FileName, info);
+
+			files.emplace_back(std::move(info));
+		}
+	}
+
+	std::sort(files.begin(), files.end(), CompareFileInfoByName);
+
+	return files;
+}
+}
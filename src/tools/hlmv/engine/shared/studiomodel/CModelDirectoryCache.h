@@ -0,0 +1,122 @@
+#ifndef GAME_STUDIOMODEL_CMODELDIRECTORYCACHE_H
+#define GAME_STUDIOMODEL_CMODELDIRECTORYCACHE_H
+
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace studiomdl
+{
+/**
+*	@brief The kind of studio model file, as determined by its header
+*/
+enum class ModelFileType
+{
+	/**
+	*	Not a studio model, wrong version or could not be read
+	*/
+	INVALID = 0,
+
+	/**
+	*	Main header, can be loaded by itself
+	*/
+	MAIN,
+
+	/**
+	*	External texture file (\<name\>T.mdl)
+	*/
+	TEXTURE,
+
+	/**
+	*	Sequence group file (\<name\>NN.mdl)
+	*/
+	SEQUENCEGROUP
+};
+
+/**
+*	@brief Metadata extracted from the header of a model file in a directory
+*/
+struct ModelFileInfo
+{
+	std::filesystem::path FileName;
+	std::filesystem::file_time_type LastWriteTime;
+
+	int Id = 0;
+	int Version = 0;
+
+	ModelFileType Type = ModelFileType::INVALID;
+};
+
+/**
+*	@brief Reads only the header identification of the given file
+*	@param fileName Name of the file to read
+*	@param info Receives the id, version and type. Type is ModelFileType::INVALID if the file could not be read or is not a version 10 studio model
+*/
+void ReadModelFileInfo(const std::filesystem::path& fileName, ModelFileInfo& info);
+
+/**
+*	@brief Caches the list of models in a directory along with their header metadata
+*	Scanning happens on a background thread. Rescans only re-read the headers of files whose modification time changed,
+*	so keeping the listing up to date is cheap even for very large directories.
+*/
+class CModelDirectoryCache final
+{
+public:
+	CModelDirectoryCache();
+	~CModelDirectoryCache();
+
+	/**
+	*	@brief Sets the directory to cache and queues a scan of it
+	*	If the directory is the same as the current one, this queues an incremental refresh instead
+	*/
+	void SetDirectory(const std::filesystem::path& directory);
+
+	/**
+	*	@brief Queues an incremental refresh of the current directory
+	*/
+	void Refresh();
+
+	/**
+	*	@brief Finds the next or previous main model file relative to the given file, wrapping around at the ends
+	*	Uses the last completed listing. Blocks only if the initial scan of the directory has not finished yet.
+	*	Queues a refresh afterwards so the next query sees any changes made in the meantime.
+	*	@param currentFile File to start from. Must be located in the cached directory
+	*	@param next Whether to search forward or backward
+	*	@return The file name, or an empty path if no other main model file exists in the directory
+	*/
+	std::filesystem::path FindRelativeModel(const std::filesystem::path& currentFile, bool next);
+
+	/**
+	*	@brief Gets a copy of the last completed listing, sorted by file name
+	*/
+	std::vector<ModelFileInfo> GetFiles() const;
+
+private:
+	void WorkerMain();
+
+	static std::vector<ModelFileInfo> ScanDirectory(const std::filesystem::path& directory, const std::vector<ModelFileInfo>& previous);
+
+private:
+	mutable std::mutex m_Mutex;
+	std::condition_variable m_WorkCondition;
+	std::condition_variable m_ScanCompleteCondition;
+
+	std::filesystem::path m_Directory;
+	std::vector<ModelFileInfo> m_Files;
+
+	bool m_bScanRequested = false;
+	bool m_bHasListing = false;
+	bool m_bShutdown = false;
+
+	std::thread m_Worker;
+
+private:
+	CModelDirectoryCache(const CModelDirectoryCache&) = delete;
+	CModelDirectoryCache& operator=(const CModelDirectoryCache&) = delete;
+};
+}
+
+#endif //GAME_STUDIOMODEL_CMODELDIRECTORYCACHE_H
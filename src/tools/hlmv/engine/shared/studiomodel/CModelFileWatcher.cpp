@@ -0,0 +1,343 @@
+#include <cstdio>
+#include <exception>
+
+#include "shared/Platform.h"
+
+#ifndef WIN32
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "CModelFileWatcher.h"
+
+namespace studiomdl
+{
+namespace
+{
+/**
+*	How long the worker waits for changes before checking whether it has to stop or watch another model.
+*/
+const std::chrono::milliseconds WAIT_INTERVAL{250};
+
+/**
+*	@brief Waits for changes in a directory
+*	Notifications only tell that something in the directory may have changed. If notifications are not available,
+*	every wait counts as a possible change so the files are checked periodically instead.
+*/
+class CDirectoryChangeNotifier final
+{
+public:
+	CDirectoryChangeNotifier() = default;
+
+	~CDirectoryChangeNotifier()
+	{
+		Close();
+	}
+
+	void Open(const std::filesystem::path& directory)
+	{
+		Close();
+
+#ifdef WIN32
+		m_hChange = FindFirstChangeNotificationW(directory.c_str(), FALSE,
+			FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+#else
+		m_Fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+		if (m_Fd != -1 && inotify_add_watch(m_Fd, directory.c_str(),
+			IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO) == -1)
+		{
+			Close();
+		}
+#endif
+	}
+
+	void Close()
+	{
+#ifdef WIN32
+		if (m_hChange != INVALID_HANDLE_VALUE)
+		{
+			FindCloseChangeNotification(m_hChange);
+			m_hChange = INVALID_HANDLE_VALUE;
+		}
+#else
+		if (m_Fd != -1)
+		{
+			close(m_Fd);
+			m_Fd = -1;
+		}
+#endif
+	}
+
+	/**
+	*	@return Whether something in the directory may have changed
+	*/
+	bool Wait(const std::chrono::milliseconds timeout)
+	{
+#ifdef WIN32
+		if (m_hChange != INVALID_HANDLE_VALUE)
+		{
+			if (WaitForSingleObject(m_hChange, static_cast<DWORD>(timeout.count())) != WAIT_OBJECT_0)
+			{
+				return false;
+			}
+
+			FindNextChangeNotification(m_hChange);
+
+			return true;
+		}
+#else
+		if (m_Fd != -1)
+		{
+			pollfd fd{m_Fd, POLLIN, 0};
+
+			if (poll(&fd, 1, static_cast<int>(timeout.count())) <= 0)
+			{
+				return false;
+			}
+
+			//Only the fact that something changed matters, so discard the events
+			alignas(inotify_event) char buffer[4096];
+
+			while (read(m_Fd, buffer, sizeof(buffer)) > 0)
+			{
+			}
+
+			return true;
+		}
+#endif
+
+		std::this_thread::sleep_for(timeout);
+
+		return true;
+	}
+
+private:
+#ifdef WIN32
+	HANDLE m_hChange = INVALID_HANDLE_VALUE;
+#else
+	int m_Fd = -1;
+#endif
+
+private:
+	CDirectoryChangeNotifier(const CDirectoryChangeNotifier&) = delete;
+	CDirectoryChangeNotifier& operator=(const CDirectoryChangeNotifier&) = delete;
+};
+}
+
+CModelFileWatcher::CModelFileWatcher(std::function<void()> changedCallback)
+	: m_ChangedCallback(std::move(changedCallback))
+{
+	m_Worker = std::thread(&CModelFileWatcher::WorkerMain, this);
+}
+
+CModelFileWatcher::~CModelFileWatcher()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_bShutdown = true;
+	}
+
+	m_WorkCondition.notify_one();
+
+	m_Worker.join();
+}
+
+void CModelFileWatcher::Watch(const std::filesystem::path& fileName)
+{
+	auto stamps = GetStamps(fileName);
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		m_FileName = fileName;
+		m_Stamps = std::move(stamps);
+
+		++m_Generation;
+
+		m_bHasChangedFiles = false;
+		m_ChangedFiles = {};
+		m_ErrorMessage.clear();
+	}
+
+	m_WorkCondition.notify_one();
+}
+
+void CModelFileWatcher::Stop()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	m_FileName.clear();
+	m_Stamps.clear();
+
+	++m_Generation;
+
+	m_bHasChangedFiles = false;
+	m_ChangedFiles = {};
+	m_ErrorMessage.clear();
+}
+
+bool CModelFileWatcher::TakeChangedFiles(StudioModelFiles& files, std::string& errorMessage)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	if (!m_bHasChangedFiles)
+	{
+		return false;
+	}
+
+	files = std::move(m_ChangedFiles);
+	errorMessage = std::move(m_ErrorMessage);
+
+	m_bHasChangedFiles = false;
+	m_ChangedFiles = {};
+	m_ErrorMessage.clear();
+
+	return true;
+}
+
+void CModelFileWatcher::WorkerMain()
+{
+	CDirectoryChangeNotifier notifier;
+
+	std::filesystem::path fileName;
+	unsigned int generation = 0;
+
+	//Stamps seen during the last check, and when they were first seen
+	std::vector<ModelFileStamp> lastStamps;
+	auto lastChangeTime = std::chrono::steady_clock::now();
+	bool bChanging = false;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+
+			m_WorkCondition.wait(lock, [this] { return m_bShutdown || !m_FileName.empty(); });
+
+			if (m_bShutdown)
+			{
+				break;
+			}
+
+			if (generation != m_Generation)
+			{
+				fileName = m_FileName;
+				generation = m_Generation;
+				lastStamps = m_Stamps;
+				bChanging = false;
+
+				const auto directory = fileName.parent_path();
+
+				notifier.Open(directory.empty() ? std::filesystem::path{"."} : directory);
+			}
+		}
+
+		if (!notifier.Wait(WAIT_INTERVAL) && !bChanging)
+		{
+			continue;
+		}
+
+		auto stamps = GetStamps(fileName);
+
+		const auto now = std::chrono::steady_clock::now();
+
+		if (stamps != lastStamps)
+		{
+			//Still being written, wait until it settles
+			lastStamps = std::move(stamps);
+			lastChangeTime = now;
+			bChanging = true;
+			continue;
+		}
+
+		if (!bChanging || (now - lastChangeTime) < DEBOUNCE_DELAY)
+		{
+			continue;
+		}
+
+		bChanging = false;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			if (generation != m_Generation || stamps == m_Stamps)
+			{
+				continue;
+			}
+
+			//Failures are not retried until the files change again
+			m_Stamps = stamps;
+		}
+
+		StudioModelFiles files;
+		std::string errorMessage;
+
+		try
+		{
+			files = ReadStudioModelFiles(fileName.u8string().c_str());
+		}
+		catch (const std::exception& e)
+		{
+			//Half written files can fail in more ways than a bad model, none of which may escape this thread
+			errorMessage = e.what();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			if (generation != m_Generation)
+			{
+				continue;
+			}
+
+			m_bHasChangedFiles = true;
+			m_ChangedFiles = std::move(files);
+			m_ErrorMessage = std::move(errorMessage);
+		}
+
+		if (m_ChangedCallback)
+		{
+			m_ChangedCallback();
+		}
+	}
+}
+
+std::vector<ModelFileStamp> CModelFileWatcher::GetStamps(const std::filesystem::path& fileName)
+{
+	std::vector<ModelFileStamp> stamps;
+
+	stamps.reserve(CStudioModel::MAX_SEQGROUPS + 1);
+
+	stamps.push_back(GetModelFileStamp(fileName));
+
+	//Use the same names as LoadStudioModel
+	auto baseFileName = fileName;
+
+	baseFileName.replace_extension();
+
+	const auto extension = fileName.extension() == ".dol" ? ".dol" : ".mdl";
+
+	auto textureFileName = baseFileName;
+
+	textureFileName += std::string{"T"} + extension;
+
+	stamps.push_back(GetModelFileStamp(textureFileName));
+
+	for (size_t i = 1; i < CStudioModel::MAX_SEQGROUPS; ++i)
+	{
+		char szSuffix[16];
+
+		snprintf(szSuffix, sizeof(szSuffix), "%02zu%s", i, extension);
+
+		auto sequenceFileName = baseFileName;
+
+		sequenceFileName += szSuffix;
+
+		stamps.push_back(GetModelFileStamp(sequenceFileName));
+	}
+
+	return stamps;
+}
+}
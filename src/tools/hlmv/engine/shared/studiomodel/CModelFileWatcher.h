@@ -0,0 +1,91 @@
+#ifndef GAME_STUDIOMODEL_CMODELFILEWATCHER_H
+#define GAME_STUDIOMODEL_CMODELFILEWATCHER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CStudioModel.h"
+#include "CStudioModelCache.h"
+
+namespace studiomdl
+{
+/**
+*	@brief Watches the main, texture and sequence group files of a model and reads them again when they change
+*	Changes are detected on a background thread, using inotify on Linux and change notifications on Windows.
+*	Other platforms check the files periodically. Reading starts once the files have not changed for DEBOUNCE_DELAY,
+*	so a compiler that writes the files one after the other causes a single reload.
+*/
+class CModelFileWatcher final
+{
+public:
+	static constexpr std::chrono::milliseconds DEBOUNCE_DELAY{500};
+
+	/**
+	*	@param changedCallback Called on the watcher thread after changed files were read, so the thread that takes them can be woken up
+	*/
+	explicit CModelFileWatcher(std::function<void()> changedCallback = {});
+	~CModelFileWatcher();
+
+	/**
+	*	@brief Starts watching the files of the given model. The files as they are now do not count as changed
+	*	Call this again after saving the model so the save does not count as a change.
+	*	@param fileName Main file of the model
+	*/
+	void Watch(const std::filesystem::path& fileName);
+
+	/**
+	*	@brief Stops watching. Files that were read but not taken yet are discarded
+	*/
+	void Stop();
+
+	/**
+	*	@brief Gets the files of the watched model if they changed and were read since the last call
+	*	@param files If the files could be read, receives them
+	*	@param errorMessage If the files could not be read, receives the reason. The model is read again the next time it changes
+	*	@return Whether the files changed
+	*/
+	bool TakeChangedFiles(StudioModelFiles& files, std::string& errorMessage);
+
+private:
+	void WorkerMain();
+
+	/**
+	*	@brief Gets the stamps of the files that belong to a model, including sequence group files that don't exist (yet)
+	*/
+	static std::vector<ModelFileStamp> GetStamps(const std::filesystem::path& fileName);
+
+private:
+	const std::function<void()> m_ChangedCallback;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_WorkCondition;
+
+	std::filesystem::path m_FileName;
+	std::vector<ModelFileStamp> m_Stamps;
+
+	/**
+	*	Incremented every time the watched model changes, so files read for a previous model are discarded.
+	*/
+	unsigned int m_Generation = 0;
+
+	bool m_bHasChangedFiles = false;
+	StudioModelFiles m_ChangedFiles;
+	std::string m_ErrorMessage;
+
+	bool m_bShutdown = false;
+
+	std::thread m_Worker;
+
+private:
+	CModelFileWatcher(const CModelFileWatcher&) = delete;
+	CModelFileWatcher& operator=(const CModelFileWatcher&) = delete;
+};
+}
+
+#endif //GAME_STUDIOMODEL_CMODELFILEWATCHER_H
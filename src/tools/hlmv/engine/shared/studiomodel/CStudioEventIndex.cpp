@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <limits>
+
+#include "CStudioEventIndex.h"
+
+namespace studiomdl
+{
+void CStudioEventIndex::Build( const studiohdr_t* pStudioHdr )
+{
+	Clear();
+
+	if( !pStudioHdr )
+	{
+		return;
+	}
+
+	m_SequenceOffsets.reserve( static_cast<size_t>( pStudioHdr->numseq ) + 1 );
+
+	for( int i = 0; i < pStudioHdr->numseq; ++i )
+	{
+		const mstudioseqdesc_t* const pseqdesc = pStudioHdr->GetSequence( i );
+		const auto pEvents = reinterpret_cast<const mstudioevent_t*>( pStudioHdr->GetData() + pseqdesc->eventindex );
+
+		const size_t first = m_Events.size();
+
+		m_SequenceOffsets.push_back( first );
+
+		for( int event = 0; event < pseqdesc->numevents; ++event )
+		{
+			m_Events.push_back( pEvents + event );
+		}
+
+		std::stable_sort( m_Events.begin() + first, m_Events.end(), []( const mstudioevent_t* pLHS, const mstudioevent_t* pRHS )
+			{
+				return pLHS->frame < pRHS->frame;
+			} );
+	}
+
+	m_SequenceOffsets.push_back( m_Events.size() );
+
+	m_Frames.reserve( m_Events.size() );
+
+	for( const auto pEvent : m_Events )
+	{
+		m_Frames.push_back( pEvent->frame );
+	}
+}
+
+void CStudioEventIndex::Clear()
+{
+	m_Frames.clear();
+	m_Events.clear();
+	m_SequenceOffsets.clear();
+}
+
+size_t CStudioEventIndex::GetEventCount( const int iSequence ) const
+{
+	if( iSequence < 0 || static_cast<size_t>( iSequence ) + 1 >= m_SequenceOffsets.size() )
+	{
+		return 0;
+	}
+
+	return m_SequenceOffsets[ iSequence + 1 ] - m_SequenceOffsets[ iSequence ];
+}
+
+size_t CStudioEventIndex::GetEvents( const int iSequence, float flStart, const float flEnd, const float flCycleLength,
+	std::vector<const mstudioevent_t*>& events ) const
+{
+	if( GetEventCount( iSequence ) == 0 )
+	{
+		return 0;
+	}
+
+	const size_t uiOldCount = events.size();
+
+	if( flStart < 0 )
+	{
+		//Wrapped: the rest of the last cycle, then the start of the new one
+		AddEvents( iSequence, flStart + flCycleLength, static_cast<float>( std::numeric_limits<int>::max() ), events );
+		flStart = 0;
+	}
+
+	if( flStart < flEnd )
+	{
+		AddEvents( iSequence, flStart, flEnd, events );
+	}
+
+	return events.size() - uiOldCount;
+}
+
+void CStudioEventIndex::AddEvents( const int iSequence, const float flStart, const float flEnd, std::vector<const mstudioevent_t*>& events ) const
+{
+	const auto begin = m_Frames.begin() + m_SequenceOffsets[ iSequence ];
+	const auto end = m_Frames.begin() + m_SequenceOffsets[ iSequence + 1 ];
+
+	const auto frameLess = []( const int frame, const float flFrame )
+	{
+		return frame < flFrame;
+	};
+
+	const auto first = std::lower_bound( begin, end, flStart, frameLess );
+	const auto last = std::lower_bound( first, end, flEnd, frameLess );
+
+	events.insert( events.end(), m_Events.begin() + ( first - m_Frames.begin() ), m_Events.begin() + ( last - m_Frames.begin() ) );
+}
+}
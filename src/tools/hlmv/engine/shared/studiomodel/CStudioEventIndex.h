@@ -0,0 +1,74 @@
+#ifndef GAME_STUDIOMODEL_CSTUDIOEVENTINDEX_H
+#define GAME_STUDIOMODEL_CSTUDIOEVENTINDEX_H
+
+#include <cstddef>
+#include <vector>
+
+#include "studio.h"
+
+namespace studiomdl
+{
+/**
+*	@brief Animation events of all sequences of a model, sorted by frame
+*	Events are looked up by binary search on their frame, so the cost of a query depends on the number of events returned,
+*	not on the number of events in the sequence. Events on the same frame keep the order they have in the model.
+*/
+class CStudioEventIndex final
+{
+public:
+	CStudioEventIndex() = default;
+	~CStudioEventIndex() = default;
+
+	/**
+	*	@brief Builds the index for the given model. Must be rebuilt if the events are changed
+	*/
+	void Build( const studiohdr_t* pStudioHdr );
+
+	void Clear();
+
+	/**
+	*	@brief Gets the number of events in a sequence
+	*/
+	size_t GetEventCount( const int iSequence ) const;
+
+	/**
+	*	@brief Gets the events of a sequence with a frame in [flStart, flEnd), in frame order
+	*	A range that starts before frame 0 has wrapped around the end of a looping sequence,
+	*	and also covers the events from flStart + flCycleLength up to the end of the sequence.
+	*	A range that ends before it starts is empty.
+	*	@param iSequence Sequence to get events for
+	*	@param flStart First frame of the range
+	*	@param flEnd End of the range, exclusive
+	*	@param flCycleLength Number of frames after which the sequence loops
+	*	@param events Events are appended to this list
+	*	@return Number of events that were added
+	*/
+	size_t GetEvents( const int iSequence, float flStart, const float flEnd, const float flCycleLength,
+		std::vector<const mstudioevent_t*>& events ) const;
+
+private:
+	/**
+	*	@brief Appends the events of a sequence with a frame in [flStart, flEnd)
+	*/
+	void AddEvents( const int iSequence, const float flStart, const float flEnd, std::vector<const mstudioevent_t*>& events ) const;
+
+private:
+	/**
+	*	Frames of all events, grouped by sequence and sorted by frame within each sequence.
+	*	Kept apart from the events so searches only touch frames.
+	*/
+	std::vector<int> m_Frames;
+
+	/**
+	*	Events, in the same order as m_Frames.
+	*/
+	std::vector<const mstudioevent_t*> m_Events;
+
+	/**
+	*	Offset of each sequence's first event, with one extra entry for the end of the last sequence.
+	*/
+	std::vector<size_t> m_SequenceOffsets;
+};
+}
+
+#endif //GAME_STUDIOMODEL_CSTUDIOEVENTINDEX_H
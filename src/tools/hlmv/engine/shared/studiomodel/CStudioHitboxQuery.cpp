@@ -0,0 +1,386 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "CStudioHitboxQuery.h"
+#include "CStudioModelPose.h"
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#define HITBOX_QUERY_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace studiomdl
+{
+namespace
+{
+const size_t LANES = 4;
+
+const float NO_HIT = std::numeric_limits<float>::infinity();
+}
+
+void CStudioHitboxQuery::Clear()
+{
+	Resize( 0 );
+}
+
+void CStudioHitboxQuery::Update( const studiohdr_t* pStudioHdr, const glm::mat3x4* pBoneTransforms )
+{
+	Resize( static_cast<size_t>( pStudioHdr->numhitboxes ) );
+
+	for( int i = 0; i < pStudioHdr->numhitboxes; ++i )
+	{
+		const auto& hitbox = *pStudioHdr->GetHitBox( i );
+
+		SetBox( i, CalcHitboxOBB( hitbox, pBoneTransforms[ hitbox.bone ] ), hitbox );
+	}
+}
+
+void CStudioHitboxQuery::Update( const studiohdr_t* pStudioHdr, CStudioModelPose& pose )
+{
+	Resize( static_cast<size_t>( pStudioHdr->numhitboxes ) );
+
+	for( int i = 0; i < pStudioHdr->numhitboxes; ++i )
+	{
+		SetBox( i, pose.GetHitbox( i ), *pStudioHdr->GetHitBox( i ) );
+	}
+}
+
+bool CStudioHitboxQuery::TraceRay( const HitboxRay& ray, HitboxHit& hit ) const
+{
+	hit = HitboxHit{};
+
+	const size_t count = GetHitboxCount();
+
+	float flClosest = NO_HIT;
+	size_t closest = 0;
+
+	for( size_t first = 0; first < count; first += LANES )
+	{
+		float distances[ LANES ];
+
+		CalcRayDistances( first, ray, distances );
+
+		const size_t lanes = std::min( LANES, count - first );
+
+		for( size_t lane = 0; lane < lanes; ++lane )
+		{
+			if( distances[ lane ] < flClosest )
+			{
+				flClosest = distances[ lane ];
+				closest = first + lane;
+			}
+		}
+	}
+
+	if( flClosest == NO_HIT )
+	{
+		return false;
+	}
+
+	hit = MakeHit( closest, flClosest );
+
+	return true;
+}
+
+size_t CStudioHitboxQuery::TraceRays( const HitboxRay* pRays, const size_t count, HitboxHit* pHits ) const
+{
+	size_t hits = 0;
+
+	for( size_t i = 0; i < count; ++i )
+	{
+		if( TraceRay( pRays[ i ], pHits[ i ] ) )
+		{
+			++hits;
+		}
+	}
+
+	return hits;
+}
+
+size_t CStudioHitboxQuery::TestPoint( const glm::vec3& point, std::vector<HitboxHit>& hits ) const
+{
+	const size_t oldCount = hits.size();
+	const size_t count = GetHitboxCount();
+
+	for( size_t first = 0; first < count; first += LANES )
+	{
+		float distancesSquared[ LANES ];
+
+		CalcDistancesSquared( first, point, distancesSquared );
+
+		const size_t lanes = std::min( LANES, count - first );
+
+		for( size_t lane = 0; lane < lanes; ++lane )
+		{
+			if( distancesSquared[ lane ] == 0 )
+			{
+				hits.push_back( MakeHit( first + lane, 0 ) );
+			}
+		}
+	}
+
+	return hits.size() - oldCount;
+}
+
+size_t CStudioHitboxQuery::TestSphere( const glm::vec3& center, const float flRadius, std::vector<HitboxHit>& hits ) const
+{
+	const size_t oldCount = hits.size();
+	const size_t count = GetHitboxCount();
+
+	const float flRadiusSquared = flRadius * flRadius;
+
+	for( size_t first = 0; first < count; first += LANES )
+	{
+		float distancesSquared[ LANES ];
+
+		CalcDistancesSquared( first, center, distancesSquared );
+
+		const size_t lanes = std::min( LANES, count - first );
+
+		for( size_t lane = 0; lane < lanes; ++lane )
+		{
+			if( distancesSquared[ lane ] <= flRadiusSquared )
+			{
+				hits.push_back( MakeHit( first + lane, std::sqrt( distancesSquared[ lane ] ) ) );
+			}
+		}
+	}
+
+	return hits.size() - oldCount;
+}
+
+bool CStudioHitboxQuery::TraceRayReference( const HitboxRay& ray, HitboxHit& hit ) const
+{
+	hit = HitboxHit{};
+
+	float flClosest = NO_HIT;
+	size_t closest = 0;
+
+	for( size_t i = 0; i < GetHitboxCount(); ++i )
+	{
+		const glm::vec3 center{ m_CenterX[ i ], m_CenterY[ i ], m_CenterZ[ i ] };
+		const glm::vec3 extents{ m_ExtentX[ i ], m_ExtentY[ i ], m_ExtentZ[ i ] };
+
+		const glm::vec3 offset = ray.Origin - center;
+
+		float tMin = 0;
+		float tMax = ray.MaxDistance;
+
+		for( int axis = 0; axis < 3; ++axis )
+		{
+			const glm::vec3 vecAxis{ m_Axes[ axis * 3 ][ i ], m_Axes[ axis * 3 + 1 ][ i ], m_Axes[ axis * 3 + 2 ][ i ] };
+
+			const float flOrigin = vecAxis.x * offset.x + vecAxis.y * offset.y + vecAxis.z * offset.z;
+			const float flDirection = vecAxis.x * ray.Direction.x + vecAxis.y * ray.Direction.y + vecAxis.z * ray.Direction.z;
+
+			const float flInvDirection = 1.0f / flDirection;
+
+			const float t1 = ( -extents[ axis ] - flOrigin ) * flInvDirection;
+			const float t2 = ( extents[ axis ] - flOrigin ) * flInvDirection;
+
+			tMin = std::max( tMin, std::min( t1, t2 ) );
+			tMax = std::min( tMax, std::max( t1, t2 ) );
+		}
+
+		if( tMin <= tMax && tMin < flClosest )
+		{
+			flClosest = tMin;
+			closest = i;
+		}
+	}
+
+	if( flClosest == NO_HIT )
+	{
+		return false;
+	}
+
+	hit = MakeHit( closest, flClosest );
+
+	return true;
+}
+
+void CStudioHitboxQuery::Resize( const size_t count )
+{
+	const size_t paddedCount = ( count + LANES - 1 ) / LANES * LANES;
+
+	//Padding is zero sized and never reported, but is kept initialized so the vectorized queries only see valid floats
+	for( auto pArray : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_ExtentX, &m_ExtentY, &m_ExtentZ } )
+	{
+		pArray->assign( paddedCount, 0.0f );
+	}
+
+	for( auto& axis : m_Axes )
+	{
+		axis.assign( paddedCount, 0.0f );
+	}
+
+	m_Bones.resize( count );
+	m_Groups.resize( count );
+}
+
+void CStudioHitboxQuery::SetBox( const size_t index, const HitboxOBB& box, const mstudiobbox_t& hitbox )
+{
+	m_CenterX[ index ] = box.Center.x;
+	m_CenterY[ index ] = box.Center.y;
+	m_CenterZ[ index ] = box.Center.z;
+
+	for( int axis = 0; axis < 3; ++axis )
+	{
+		for( int component = 0; component < 3; ++component )
+		{
+			m_Axes[ axis * 3 + component ][ index ] = box.Axes[ axis ][ component ];
+		}
+	}
+
+	m_ExtentX[ index ] = box.Extents.x;
+	m_ExtentY[ index ] = box.Extents.y;
+	m_ExtentZ[ index ] = box.Extents.z;
+
+	m_Bones[ index ] = hitbox.bone;
+	m_Groups[ index ] = hitbox.group;
+}
+
+HitboxHit CStudioHitboxQuery::MakeHit( const size_t index, const float flDistance ) const
+{
+	HitboxHit hit;
+
+	hit.Distance = flDistance;
+	hit.Hitbox = static_cast<int>( index );
+	hit.Bone = m_Bones[ index ];
+	hit.Group = m_Groups[ index ];
+
+	return hit;
+}
+
+void CStudioHitboxQuery::CalcDistancesSquared( const size_t first, const glm::vec3& point, float* pDistancesSquared ) const
+{
+#ifdef HITBOX_QUERY_SSE
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 signMask = _mm_set1_ps( -0.0f );
+
+	const __m128 offsetX = _mm_sub_ps( _mm_set1_ps( point.x ), _mm_loadu_ps( m_CenterX.data() + first ) );
+	const __m128 offsetY = _mm_sub_ps( _mm_set1_ps( point.y ), _mm_loadu_ps( m_CenterY.data() + first ) );
+	const __m128 offsetZ = _mm_sub_ps( _mm_set1_ps( point.z ), _mm_loadu_ps( m_CenterZ.data() + first ) );
+
+	const float* const extents[ 3 ] = { m_ExtentX.data(), m_ExtentY.data(), m_ExtentZ.data() };
+
+	__m128 distanceSquared = zero;
+
+	for( int axis = 0; axis < 3; ++axis )
+	{
+		//Position along the axis, in box space
+		__m128 position = _mm_mul_ps( _mm_loadu_ps( m_Axes[ axis * 3 ].data() + first ), offsetX );
+		position = _mm_add_ps( position, _mm_mul_ps( _mm_loadu_ps( m_Axes[ axis * 3 + 1 ].data() + first ), offsetY ) );
+		position = _mm_add_ps( position, _mm_mul_ps( _mm_loadu_ps( m_Axes[ axis * 3 + 2 ].data() + first ), offsetZ ) );
+
+		const __m128 outside = _mm_max_ps( _mm_sub_ps( _mm_andnot_ps( signMask, position ), _mm_loadu_ps( extents[ axis ] + first ) ), zero );
+
+		distanceSquared = _mm_add_ps( distanceSquared, _mm_mul_ps( outside, outside ) );
+	}
+
+	_mm_storeu_ps( pDistancesSquared, distanceSquared );
+#else
+	const float* const extents[ 3 ] = { m_ExtentX.data(), m_ExtentY.data(), m_ExtentZ.data() };
+
+	for( size_t lane = 0; lane < LANES; ++lane )
+	{
+		const size_t i = first + lane;
+
+		const glm::vec3 offset = point - glm::vec3{ m_CenterX[ i ], m_CenterY[ i ], m_CenterZ[ i ] };
+
+		float distanceSquared = 0;
+
+		for( int axis = 0; axis < 3; ++axis )
+		{
+			const float position = m_Axes[ axis * 3 ][ i ] * offset.x + m_Axes[ axis * 3 + 1 ][ i ] * offset.y + m_Axes[ axis * 3 + 2 ][ i ] * offset.z;
+
+			const float outside = std::max( std::abs( position ) - extents[ axis ][ i ], 0.0f );
+
+			distanceSquared += outside * outside;
+		}
+
+		pDistancesSquared[ lane ] = distanceSquared;
+	}
+#endif
+}
+
+void CStudioHitboxQuery::CalcRayDistances( const size_t first, const HitboxRay& ray, float* pDistances ) const
+{
+#ifdef HITBOX_QUERY_SSE
+	const __m128 one = _mm_set1_ps( 1 );
+	const __m128 zero = _mm_setzero_ps();
+
+	const __m128 offsetX = _mm_sub_ps( _mm_set1_ps( ray.Origin.x ), _mm_loadu_ps( m_CenterX.data() + first ) );
+	const __m128 offsetY = _mm_sub_ps( _mm_set1_ps( ray.Origin.y ), _mm_loadu_ps( m_CenterY.data() + first ) );
+	const __m128 offsetZ = _mm_sub_ps( _mm_set1_ps( ray.Origin.z ), _mm_loadu_ps( m_CenterZ.data() + first ) );
+
+	const __m128 directionX = _mm_set1_ps( ray.Direction.x );
+	const __m128 directionY = _mm_set1_ps( ray.Direction.y );
+	const __m128 directionZ = _mm_set1_ps( ray.Direction.z );
+
+	const float* const extents[ 3 ] = { m_ExtentX.data(), m_ExtentY.data(), m_ExtentZ.data() };
+
+	__m128 tMin = zero;
+	__m128 tMax = _mm_set1_ps( ray.MaxDistance );
+
+	//Slab test in box space, one axis of all 4 boxes at a time
+	for( int axis = 0; axis < 3; ++axis )
+	{
+		const __m128 axisX = _mm_loadu_ps( m_Axes[ axis * 3 ].data() + first );
+		const __m128 axisY = _mm_loadu_ps( m_Axes[ axis * 3 + 1 ].data() + first );
+		const __m128 axisZ = _mm_loadu_ps( m_Axes[ axis * 3 + 2 ].data() + first );
+
+		__m128 origin = _mm_mul_ps( axisX, offsetX );
+		origin = _mm_add_ps( origin, _mm_mul_ps( axisY, offsetY ) );
+		origin = _mm_add_ps( origin, _mm_mul_ps( axisZ, offsetZ ) );
+
+		__m128 direction = _mm_mul_ps( axisX, directionX );
+		direction = _mm_add_ps( direction, _mm_mul_ps( axisY, directionY ) );
+		direction = _mm_add_ps( direction, _mm_mul_ps( axisZ, directionZ ) );
+
+		const __m128 invDirection = _mm_div_ps( one, direction );
+
+		const __m128 extent = _mm_loadu_ps( extents[ axis ] + first );
+
+		const __m128 t1 = _mm_mul_ps( _mm_sub_ps( _mm_sub_ps( zero, extent ), origin ), invDirection );
+		const __m128 t2 = _mm_mul_ps( _mm_sub_ps( extent, origin ), invDirection );
+
+		tMin = _mm_max_ps( tMin, _mm_min_ps( t1, t2 ) );
+		tMax = _mm_min_ps( tMax, _mm_max_ps( t1, t2 ) );
+	}
+
+	const __m128 hit = _mm_cmple_ps( tMin, tMax );
+
+	_mm_storeu_ps( pDistances, _mm_or_ps( _mm_and_ps( hit, tMin ), _mm_andnot_ps( hit, _mm_set1_ps( NO_HIT ) ) ) );
+#else
+	const float* const extents[ 3 ] = { m_ExtentX.data(), m_ExtentY.data(), m_ExtentZ.data() };
+
+	for( size_t lane = 0; lane < LANES; ++lane )
+	{
+		const size_t i = first + lane;
+
+		const glm::vec3 offset = ray.Origin - glm::vec3{ m_CenterX[ i ], m_CenterY[ i ], m_CenterZ[ i ] };
+
+		float tMin = 0;
+		float tMax = ray.MaxDistance;
+
+		for( int axis = 0; axis < 3; ++axis )
+		{
+			const float flOrigin = m_Axes[ axis * 3 ][ i ] * offset.x + m_Axes[ axis * 3 + 1 ][ i ] * offset.y + m_Axes[ axis * 3 + 2 ][ i ] * offset.z;
+			const float flDirection = m_Axes[ axis * 3 ][ i ] * ray.Direction.x + m_Axes[ axis * 3 + 1 ][ i ] * ray.Direction.y + m_Axes[ axis * 3 + 2 ][ i ] * ray.Direction.z;
+
+			const float flInvDirection = 1.0f / flDirection;
+
+			const float t1 = ( -extents[ axis ][ i ] - flOrigin ) * flInvDirection;
+			const float t2 = ( extents[ axis ][ i ] - flOrigin ) * flInvDirection;
+
+			tMin = std::max( tMin, std::min( t1, t2 ) );
+			tMax = std::min( tMax, std::max( t1, t2 ) );
+		}
+
+		pDistances[ lane ] = tMin <= tMax ? tMin : NO_HIT;
+	}
+#endif
+}
+}
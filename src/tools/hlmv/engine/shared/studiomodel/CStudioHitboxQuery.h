@@ -0,0 +1,141 @@
+#ifndef GAME_STUDIOMODEL_CSTUDIOHITBOXQUERY_H
+#define GAME_STUDIOMODEL_CSTUDIOHITBOXQUERY_H
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/vec3.hpp>
+#include <glm/mat3x4.hpp>
+
+#include "studio.h"
+
+namespace studiomdl
+{
+class CStudioModelPose;
+struct HitboxOBB;
+
+/**
+*	@brief Ray to trace against hitboxes
+*/
+struct HitboxRay
+{
+	glm::vec3 Origin{0};
+	glm::vec3 Direction{0};
+
+	/**
+	*	Maximum distance along the ray, in units of the direction.
+	*/
+	float MaxDistance = 1;
+};
+
+/**
+*	@brief A hitbox that was hit by a query. Hitbox is -1 if nothing was hit
+*/
+struct HitboxHit
+{
+	/**
+	*	Rays: distance along the ray to the box, in units of the ray direction. 0 if the ray starts inside the box.
+	*	Spheres: distance from the center of the sphere to the box. 0 if the center is inside the box.
+	*	Points: always 0.
+	*/
+	float Distance = 0;
+
+	int Hitbox = -1;
+	int Bone = -1;
+	int Group = -1;
+
+	bool IsValid() const { return Hitbox != -1; }
+};
+
+/**
+*	@brief Answers ray, point and sphere queries against the posed hitboxes of a model
+*	Hitboxes are stored as oriented boxes in structure-of-arrays layout, so queries test 4 boxes per instruction when the compiler targets SSE.
+*	The boxes must be updated whenever the pose changes.
+*/
+class CStudioHitboxQuery final
+{
+public:
+	CStudioHitboxQuery() = default;
+	~CStudioHitboxQuery() = default;
+
+	void Clear();
+
+	/**
+	*	@brief Updates the boxes to match a pose
+	*	@param pStudioHdr Model header
+	*	@param pBoneTransforms Bone transforms of the pose, as produced by the renderer. Must contain the model's number of bones
+	*/
+	void Update( const studiohdr_t* pStudioHdr, const glm::mat3x4* pBoneTransforms );
+
+	/**
+	*	@brief Updates the boxes to match a pose, evaluating only the bones that have hitboxes
+	*/
+	void Update( const studiohdr_t* pStudioHdr, CStudioModelPose& pose );
+
+	size_t GetHitboxCount() const { return m_Bones.size(); }
+
+	/**
+	*	@brief Finds the closest hitbox along a ray
+	*	@return Whether a hitbox was hit
+	*/
+	bool TraceRay( const HitboxRay& ray, HitboxHit& hit ) const;
+
+	/**
+	*	@brief Finds the closest hitbox along each ray
+	*	@param pHits Receives one result per ray
+	*	@return Number of rays that hit a hitbox
+	*/
+	size_t TraceRays( const HitboxRay* pRays, const size_t count, HitboxHit* pHits ) const;
+
+	/**
+	*	@brief Finds all hitboxes that contain a point
+	*	@param hits Hits are appended to this list, in hitbox order
+	*	@return Number of hits that were added
+	*/
+	size_t TestPoint( const glm::vec3& point, std::vector<HitboxHit>& hits ) const;
+
+	/**
+	*	@brief Finds all hitboxes that touch a sphere
+	*	@see TestPoint
+	*/
+	size_t TestSphere( const glm::vec3& center, const float flRadius, std::vector<HitboxHit>& hits ) const;
+
+	/**
+	*	@brief Scalar version of TraceRay that tests one box at a time. Used to validate the vectorized queries
+	*/
+	bool TraceRayReference( const HitboxRay& ray, HitboxHit& hit ) const;
+
+private:
+	void Resize( const size_t count );
+
+	void SetBox( const size_t index, const HitboxOBB& box, const mstudiobbox_t& hitbox );
+
+	HitboxHit MakeHit( const size_t index, const float flDistance ) const;
+
+	/**
+	*	@brief Computes the squared distance from a point to each box of a batch of 4, 0 if the point is inside
+	*/
+	void CalcDistancesSquared( const size_t first, const glm::vec3& point, float* pDistancesSquared ) const;
+
+	/**
+	*	@brief Computes the distance along a ray to each box of a batch of 4, or infinity if the box is missed
+	*/
+	void CalcRayDistances( const size_t first, const HitboxRay& ray, float* pDistances ) const;
+
+private:
+	//Padded to a multiple of 4 boxes. Padding is never reported as hit.
+	std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+
+	/**
+	*	Component j of axis i is m_Axes[ i * 3 + j ].
+	*/
+	std::vector<float> m_Axes[ 9 ];
+
+	std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+
+	std::vector<int> m_Bones;
+	std::vector<int> m_Groups;
+};
+}
+
+#endif //GAME_STUDIOMODEL_CSTUDIOHITBOXQUERY_H
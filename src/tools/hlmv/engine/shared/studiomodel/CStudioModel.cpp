@@ -1,11 +1,21 @@
+#include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <cstring>
 #include <filesystem>
 #include <iomanip>
 #include <memory>
 #include <sstream>
 #include <string>
 
+#ifdef WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "shared/CProfiler.h"
 #include "shared/Platform.h"
 #include "shared/Logging.h"
 
@@ -18,6 +28,7 @@
 #include "graphics/Palette.h"
 
 #include "CStudioModel.h"
+#include "TriangleCommands.h"
 
 namespace studiomdl
 {
@@ -114,89 +125,297 @@ void ConvertDolToMdl(byte* pBuffer, const mstudiotexture_t& texture)
 
 void UploadTexture(const mstudiotexture_t* ptexture, const byte* data, byte* pal, GLuint name, const bool bFilterTextures, const bool bPowerOf2)
 {
-	// unsigned *in, int inwidth, int inheight, unsigned *out,  int outwidth, int outheight;
+	int outwidth;
+	int outheight;
+
+	auto tex = ConvertTextureToRGBA(*ptexture, data, pal, bPowerOf2, outwidth, outheight);
+
+	if (!tex)
+		return;
+
+	UploadRGBATexture(outwidth, outheight, tex.get(), name, bFilterTextures);
+}
+
+/**
+*	@brief Whether two textures have the same dimensions, flags, pixels and palette, so they look the same once uploaded
+*/
+bool IsSameTexture(const studiohdr_t& textureHdr, const mstudiotexture_t& texture, const studiohdr_t& otherTextureHdr, const mstudiotexture_t& otherTexture)
+{
+	if (texture.width != otherTexture.width || texture.height != otherTexture.height || texture.flags != otherTexture.flags)
+	{
+		return false;
+	}
+
+	const size_t size = static_cast<size_t>(texture.width) * texture.height + PALETTE_SIZE;
+
+	return !memcmp(textureHdr.GetData() + texture.index, otherTextureHdr.GetData() + otherTexture.index, size);
+}
+
+/**
+*	@param pPrevious If not null, textures that are identical to the texture at the same index in this model are taken from it instead of being uploaded
+*/
+size_t UploadTextures(studiohdr_t& textureHdr, std::vector<GLuint>& textures, const bool bFilterTextures, const bool bPowerOf2,
+	const studiohdr_t* pPreviousHdr, std::vector<GLuint>* pPreviousTextures)
+{
+	PROFILE_SCOPE("UploadTextures");
+
+	size_t uiNumTextures = 0;
+
+	if (textureHdr.textureindex > 0 && textureHdr.numtextures <= CStudioModel::MAX_TEXTURES)
+	{
+		mstudiotexture_t* ptexture = textureHdr.GetTextures();
+
+		byte* pIn = reinterpret_cast<byte*>(&textureHdr);
+
+		const int n = textureHdr.numtextures;
+
+		for (int i = 0; i < n; ++i)
+		{
+			if (pPreviousHdr && pPreviousTextures
+				&& i < pPreviousHdr->numtextures && static_cast<size_t>(i) < pPreviousTextures->size() && (*pPreviousTextures)[i] != 0
+				&& IsSameTexture(textureHdr, ptexture[i], *pPreviousHdr, *pPreviousHdr->GetTexture(i)))
+			{
+				//The previous model no longer owns it
+				textures.emplace_back(std::exchange((*pPreviousTextures)[i], 0));
+				continue;
+			}
+
+			GLuint name;
+
+			glBindTexture(GL_TEXTURE_2D, 0);
+			glGenTextures(1, &name);
+
+			UploadTexture(&ptexture[i], pIn + ptexture[i].index, pIn + ptexture[i].width * ptexture[i].height + ptexture[i].index, name, bFilterTextures, bPowerOf2);
+
+			textures.emplace_back(name);
+		}
+
+		uiNumTextures = n;
+	}
+
+	return uiNumTextures;
+}
+
+/**
+*	@brief Converts the textures of a PS2 model to the PC layout in place
+*/
+void ConvertDolTextures(studiohdr_t& textureHdr)
+{
+	if (textureHdr.textureindex > 0 && textureHdr.numtextures <= CStudioModel::MAX_TEXTURES)
+	{
+		for (int i = 0; i < textureHdr.numtextures; ++i)
+		{
+			ConvertDolToMdl(textureHdr.GetData(), *textureHdr.GetTexture(i));
+		}
+	}
+}
+
+/**
+*	@brief Hashes the contents of a file to detect whether they changed
+*	Not meant to resist deliberate collisions. Processes 8 bytes at a time, since models can be tens of megabytes.
+*/
+std::uint64_t HashStudioData(const void* pData, const std::size_t size)
+{
+	const auto pBytes = reinterpret_cast<const byte*>(pData);
+
+	std::uint64_t hash = 14695981039346656037ULL ^ size;
+
+	std::size_t offset = 0;
+
+	for (; offset + sizeof(std::uint64_t) <= size; offset += sizeof(std::uint64_t))
+	{
+		std::uint64_t value;
+
+		memcpy(&value, pBytes + offset, sizeof(value));
+
+		hash = (hash ^ value) * 0x9E3779B97F4A7C15ULL;
+		hash ^= hash >> 29;
+	}
+
+	for (; offset < size; ++offset)
+	{
+		hash = (hash ^ pBytes[offset]) * 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+std::filesystem::path NormalizeFileName(const std::filesystem::path& fileName)
+{
+	std::error_code error;
+
+	auto absoluteFileName = std::filesystem::absolute(fileName, error);
+
+	return (error ? fileName : absoluteFileName).lexically_normal();
+}
+
+/**
+*	@brief Loads a file with LoadStudioHeader and records its state
+*/
+template<typename T>
+studio_ptr<T> ReadStudioFile(const std::filesystem::path& fileName, const bool bAllowSeqGroup, std::vector<StudioFileState>& fileStates)
+{
+	//Stamp the file before reading it, so a write that happens during the read makes the stamp outdated instead of going unnoticed
+	StudioFileState state{NormalizeFileName(fileName), GetModelFileStamp(fileName)};
+
+	auto header = LoadStudioHeader<T>(fileName.u8string().c_str(), bAllowSeqGroup);
+
+	state.Hash = HashStudioData(header.get(), header->length);
+
+	fileStates.emplace_back(std::move(state));
+
+	return header;
+}
+
+/**
+*	@brief Makes sure file contents reach the disk before the file replaces anything
+*/
+bool FlushToDisk(FILE* pFile)
+{
+	if (fflush(pFile) != 0)
+	{
+		return false;
+	}
+
+#ifdef WIN32
+	return _commit(_fileno(pFile)) == 0;
+#else
+	return fsync(fileno(pFile)) == 0;
+#endif
+}
+
+/**
+*	@brief Writes a file through a temporary file in the same directory that replaces the original once it is complete
+*	@exception StudioModelException If the file could not be written. The original file is left as it was
+*/
+void WriteFileSafely(const std::filesystem::path& fileName, const void* pData, const std::size_t size, const char* const pszDescription)
+{
+	auto tempFileName = fileName;
+
+	tempFileName += ".tmp";
+
+	FILE* pFile = utf8_fopen(tempFileName.u8string().c_str(), "wb");
+
+	if (!pFile)
+	{
+		throw StudioModelException(std::string{"Could not open "} + pszDescription + " file for writing");
+	}
+
+	bool bSuccess = fwrite(pData, sizeof(byte), size, pFile) == size;
+
+	bSuccess = bSuccess && FlushToDisk(pFile);
+
+	bSuccess = fclose(pFile) == 0 && bSuccess;
+
+	std::error_code error;
+
+	if (bSuccess)
+	{
+		std::filesystem::rename(tempFileName, fileName, error);
+	}
+
+	if (!bSuccess || error)
+	{
+		std::filesystem::remove(tempFileName, error);
+
+		throw StudioModelException(std::string{"Error while writing to "} + pszDescription + " file");
+	}
+
+#ifndef WIN32
+	//The rename itself is only durable once the directory is flushed as well
+	const auto directory = fileName.parent_path();
+
+	if (const int directoryFd = open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY); directoryFd != -1)
+	{
+		fsync(directoryFd);
+		close(directoryFd);
+	}
+#endif
+}
+}
+
+std::unique_ptr<byte[]> ConvertTextureToRGBA(const mstudiotexture_t& texture, const byte* pData, byte* pPalette, const bool bPowerOf2,
+	int& outWidth, int& outHeight)
+{
 	int		i, j;
 	int		row1[MAX_TEXTURE_DIMS], row2[MAX_TEXTURE_DIMS], col1[MAX_TEXTURE_DIMS], col2[MAX_TEXTURE_DIMS];
 	const byte* pix1, * pix2, * pix3, * pix4;
 
 	// convert texture to power of 2
-	int outwidth;
-	int outheight;
-
 	if (bPowerOf2)
 	{
-		if (!graphics::CalculateImageDimensions(ptexture->width, ptexture->height, outwidth, outheight))
-			return;
+		if (!graphics::CalculateImageDimensions(texture.width, texture.height, outWidth, outHeight))
+			return {};
 	}
 	else
 	{
-		outwidth = ptexture->width;
-		outheight = ptexture->height;
+		outWidth = texture.width;
+		outHeight = texture.height;
 	}
 
-	const size_t uiSize = outwidth * outheight * 4;
+	const size_t uiSize = outWidth * outHeight * 4;
 
 	//Needs at least one pixel (satisfies code analysis)
 	if (uiSize < 4)
-		return;
+		return {};
 
 	auto tex = std::make_unique<byte[]>(uiSize);
 
 	/*
 	int k = 0;
-	for (i = 0; i < ptexture->height; i++)
+	for (i = 0; i < texture.height; i++)
 	{
-	for (j = 0; j < ptexture->width; j++)
+	for (j = 0; j < texture.width; j++)
 	{
 
-	in[k++] = pal[data[i * ptexture->width + j] * 3 + 0];
-	in[k++] = pal[data[i * ptexture->width + j] * 3 + 1];
-	in[k++] = pal[data[i * ptexture->width + j] * 3 + 2];
+	in[k++] = pPalette[pData[i * texture.width + j] * 3 + 0];
+	in[k++] = pPalette[pData[i * texture.width + j] * 3 + 1];
+	in[k++] = pPalette[pData[i * texture.width + j] * 3 + 2];
 	in[k++] = 0xff;;
 	}
 	}
 
-	gluScaleImage (GL_RGBA, ptexture->width, ptexture->height, GL_UNSIGNED_BYTE, in, outwidth, outheight, GL_UNSIGNED_BYTE, out);
+	gluScaleImage (GL_RGBA, texture.width, texture.height, GL_UNSIGNED_BYTE, in, outWidth, outHeight, GL_UNSIGNED_BYTE, out);
 	free (in);
 	*/
 
-	for (i = 0; i < outwidth; i++)
+	for (i = 0; i < outWidth; i++)
 	{
-		col1[i] = (int) ((i + 0.25) * (ptexture->width / (float) outwidth));
-		col2[i] = (int) ((i + 0.75) * (ptexture->width / (float) outwidth));
+		col1[i] = (int) ((i + 0.25) * (texture.width / (float) outWidth));
+		col2[i] = (int) ((i + 0.75) * (texture.width / (float) outWidth));
 	}
 
-	for (i = 0; i < outheight; i++)
+	for (i = 0; i < outHeight; i++)
 	{
-		row1[i] = (int) ((i + 0.25) * (ptexture->height / (float) outheight)) * ptexture->width;
-		row2[i] = (int) ((i + 0.75) * (ptexture->height / (float) outheight)) * ptexture->width;
+		row1[i] = (int) ((i + 0.25) * (texture.height / (float) outHeight)) * texture.width;
+		row2[i] = (int) ((i + 0.75) * (texture.height / (float) outHeight)) * texture.width;
 	}
 
-	const byte* const pAlpha = &pal[PALETTE_ALPHA_INDEX];
+	const byte* const pAlpha = &pPalette[PALETTE_ALPHA_INDEX];
 
 	//This modifies the model's data. Sets the mask color to black. This is also done by Jed's model viewer. (export texture has black)
-	if (ptexture->flags & STUDIO_NF_MASKED)
+	if (texture.flags & STUDIO_NF_MASKED)
 	{
-		pal[255 * 3 + 0] = pal[255 * 3 + 1] = pal[255 * 3 + 2] = 0;
+		pPalette[255 * 3 + 0] = pPalette[255 * 3 + 1] = pPalette[255 * 3 + 2] = 0;
 	}
 
 	auto out = tex.get();
 
 	// scale down and convert to 32bit RGB
-	for (i = 0; i < outheight; i++)
+	for (i = 0; i < outHeight; i++)
 	{
-		for (j = 0; j < outwidth; j++, out += 4)
+		for (j = 0; j < outWidth; j++, out += 4)
 		{
-			pix1 = &pal[data[row1[i] + col1[j]] * 3];
-			pix2 = &pal[data[row1[i] + col2[j]] * 3];
-			pix3 = &pal[data[row2[i] + col1[j]] * 3];
-			pix4 = &pal[data[row2[i] + col2[j]] * 3];
+			pix1 = &pPalette[pData[row1[i] + col1[j]] * 3];
+			pix2 = &pPalette[pData[row1[i] + col2[j]] * 3];
+			pix3 = &pPalette[pData[row2[i] + col1[j]] * 3];
+			pix4 = &pPalette[pData[row2[i] + col2[j]] * 3];
 
 			out[0] = (pix1[0] + pix2[0] + pix3[0] + pix4[0]) >> 2;
 			out[1] = (pix1[1] + pix2[1] + pix3[1] + pix4[1]) >> 2;
 			out[2] = (pix1[2] + pix2[2] + pix3[2] + pix4[2]) >> 2;
 
-			if (ptexture->flags & STUDIO_NF_MASKED && pix1 == pAlpha && pix2 == pAlpha && pix3 == pAlpha && pix4 == pAlpha)
+			if (texture.flags & STUDIO_NF_MASKED && pix1 == pAlpha && pix2 == pAlpha && pix3 == pAlpha && pix4 == pAlpha)
 			{
 				//Set alpha to 0 to enable transparent pixel.
 				out[3] = 0x00;
@@ -208,43 +427,12 @@ void UploadTexture(const mstudiotexture_t* ptexture, const byte* data, byte* pal
 		}
 	}
 
-	UploadRGBATexture(outwidth, outheight, tex.get(), name, bFilterTextures);
+	return tex;
 }
 
-size_t UploadTextures(studiohdr_t& textureHdr, std::vector<GLuint>& textures, const bool bFilterTextures, const bool bPowerOf2, const bool bIsDol)
+bool ShouldResizeTexturesToPowerOf2()
 {
-	size_t uiNumTextures = 0;
-
-	if (textureHdr.textureindex > 0 && textureHdr.numtextures <= CStudioModel::MAX_TEXTURES)
-	{
-		mstudiotexture_t* ptexture = textureHdr.GetTextures();
-
-		byte* pIn = reinterpret_cast<byte*>(&textureHdr);
-
-		const int n = textureHdr.numtextures;
-
-		for (int i = 0; i < n; ++i)
-		{
-			GLuint name;
-
-			glBindTexture(GL_TEXTURE_2D, 0);
-			glGenTextures(1, &name);
-
-			if (bIsDol)
-			{
-				ConvertDolToMdl(pIn, ptexture[i]);
-			}
-
-			UploadTexture(&ptexture[i], pIn + ptexture[i].index, pIn + ptexture[i].width * ptexture[i].height + ptexture[i].index, name, bFilterTextures, bPowerOf2);
-
-			textures.emplace_back(name);
-		}
-
-		uiNumTextures = n;
-	}
-
-	return uiNumTextures;
-}
+	return r_powerof2textures.GetBool();
 }
 
 CStudioModel::CStudioModel(std::string&& fileName, studio_ptr<studiohdr_t>&& pStudioHdr, studio_ptr<studiohdr_t>&& pTextureHdr,
@@ -256,12 +444,20 @@ CStudioModel::CStudioModel(std::string&& fileName, studio_ptr<studiohdr_t>&& pSt
 	, m_Textures(std::move(textures))
 {
 	assert(m_pStudioHdr);
+
+	RebuildEventIndex();
+	BuildTriangleLists();
+	UpdateMeshDrawOrder();
 }
 
 CStudioModel::~CStudioModel()
 {
-	glDeleteTextures(GetTextureHeader()->numtextures, m_Textures.data());
-	m_Textures.clear();
+	//Models created without a renderer (e.g. by tools) have no textures
+	if (!m_Textures.empty())
+	{
+		glDeleteTextures(static_cast<GLsizei>(m_Textures.size()), m_Textures.data());
+		m_Textures.clear();
+	}
 }
 
 mstudioanim_t* CStudioModel::GetAnim(mstudioseqdesc_t* pseqdesc) const
@@ -303,6 +499,16 @@ bool CStudioModel::CalculateBodygroup(const int iGroup, const int iValue, int& i
 	return true;
 }
 
+int CStudioModel::GetBodygroupValue(const int iGroup, const int iBodygroup) const
+{
+	if (iGroup < 0 || iGroup >= m_pStudioHdr->numbodyparts)
+		return 0;
+
+	const mstudiobodyparts_t* const pbodypart = m_pStudioHdr->GetBodypart(iGroup);
+
+	return (iBodygroup / pbodypart->base) % pbodypart->nummodels;
+}
+
 GLuint CStudioModel::GetTextureId(const int iIndex) const
 {
 	const studiohdr_t* const pHdr = GetTextureHeader();
@@ -321,6 +527,17 @@ void CStudioModel::ReplaceTexture(mstudiotexture_t* ptexture, byte* data, byte*
 	UploadTexture(ptexture, data, pal, textureId, r_filtertextures.GetBool(), r_powerof2textures.GetBool());
 }
 
+void CStudioModel::UploadConvertedTexture(const int iIndex, const int iWidth, const int iHeight, const byte* pRGBA)
+{
+	if (iIndex < 0 || static_cast<size_t>(iIndex) >= m_Textures.size())
+	{
+		Error("CStudioModel::UploadConvertedTexture: Invalid texture!");
+		return;
+	}
+
+	UploadRGBATexture(iWidth, iHeight, pRGBA, m_Textures[iIndex], r_filtertextures.GetBool());
+}
+
 void CStudioModel::ReuploadTexture(mstudiotexture_t* ptexture)
 {
 	assert(ptexture);
@@ -342,8 +559,118 @@ void CStudioModel::ReuploadTexture(mstudiotexture_t* ptexture)
 		header->GetData() + ptexture->index + ptexture->width * ptexture->height, textureId, r_filtertextures.GetBool(), r_powerof2textures.GetBool());
 }
 
-namespace
+const std::vector<unsigned short>& CStudioModel::GetTriangleList(const mstudiomodel_t* pModel) const
+{
+	assert(pModel);
+
+	return m_TriangleLists.at(pModel);
+}
+
+void CStudioModel::BuildTriangleLists()
+{
+	m_TriangleLists.clear();
+
+	for (int bodypart = 0; bodypart < m_pStudioHdr->numbodyparts; ++bodypart)
+	{
+		const auto pBodypart = m_pStudioHdr->GetBodypart(bodypart);
+
+		const auto pModels = reinterpret_cast<const mstudiomodel_t*>(m_pStudioHdr->GetData() + pBodypart->modelindex);
+
+		for (int model = 0; model < pBodypart->nummodels; ++model)
+		{
+			const auto pModel = &pModels[model];
+
+			const auto pMeshes = reinterpret_cast<const mstudiomesh_t*>(m_pStudioHdr->GetData() + pModel->meshindex);
+
+			auto& indices = m_TriangleLists[pModel];
+
+			for (int mesh = 0; mesh < pModel->nummesh; ++mesh)
+			{
+				const auto pTriCmds = reinterpret_cast<const short*>(m_pStudioHdr->GetData() + pMeshes[mesh].triindex);
+
+				indices.reserve(indices.size() + pMeshes[mesh].numtris * 3);
+
+				DecodeTriangleCommands(pTriCmds, [&](const short* pVertex0, const short* pVertex1, const short* pVertex2)
+					{
+						indices.push_back(static_cast<unsigned short>(pVertex0[0]));
+						indices.push_back(static_cast<unsigned short>(pVertex1[0]));
+						indices.push_back(static_cast<unsigned short>(pVertex2[0]));
+					});
+			}
+		}
+	}
+}
+
+void CStudioModel::RebuildEventIndex()
 {
+	m_EventIndex.Build(m_pStudioHdr.get());
+}
+
+const std::vector<SortedMesh_t>& CStudioModel::GetSortedMeshes(const mstudiomodel_t* pModel, const int iSkin, const bool bGroupByTexture) const
+{
+	assert(pModel);
+
+	const auto& skins = m_SortedMeshes.at(pModel);
+
+	const size_t skin = iSkin > 0 && static_cast<size_t>(iSkin) < skins.size() ? static_cast<size_t>(iSkin) : 0;
+
+	return bGroupByTexture ? skins[skin].MeshesByTexture : skins[skin].Meshes;
+}
+
+void CStudioModel::UpdateMeshDrawOrder()
+{
+	m_SortedMeshes.clear();
+
+	const auto pTextureHdr = GetTextureHeader();
+
+	const auto pTextures = pTextureHdr->GetTextures();
+
+	//Models without skin families still draw with the first one
+	const int numSkinFamilies = std::max(1, pTextureHdr->numskinfamilies);
+
+	for (int bodypart = 0; bodypart < m_pStudioHdr->numbodyparts; ++bodypart)
+	{
+		const auto pBodypart = m_pStudioHdr->GetBodypart(bodypart);
+
+		const auto pModels = reinterpret_cast<const mstudiomodel_t*>(m_pStudioHdr->GetData() + pBodypart->modelindex);
+
+		for (int model = 0; model < pBodypart->nummodels; ++model)
+		{
+			const auto pModel = &pModels[model];
+
+			const auto pMeshes = reinterpret_cast<mstudiomesh_t*>(m_pStudioHdr->GetData() + pModel->meshindex);
+
+			auto& skins = m_SortedMeshes[pModel];
+
+			skins.resize(numSkinFamilies);
+
+			for (int skin = 0; skin < numSkinFamilies; ++skin)
+			{
+				const short* const pSkinRef = pTextureHdr->GetSkins() + skin * pTextureHdr->numskinref;
+
+				auto& meshes = skins[skin].Meshes;
+
+				meshes.resize(pModel->nummesh);
+
+				for (int mesh = 0; mesh < pModel->nummesh; ++mesh)
+				{
+					const int texture = pSkinRef[pMeshes[mesh].skinref];
+
+					meshes[mesh].pMesh = &pMeshes[mesh];
+					meshes[mesh].flags = pTextures[texture].flags;
+					meshes[mesh].texture = texture;
+				}
+
+				SortMeshes(meshes);
+
+				skins[skin].MeshesByTexture = meshes;
+
+				GroupMeshesByTexture(skins[skin].MeshesByTexture);
+			}
+		}
+	}
+}
+
 template<typename T>
 studio_ptr<T> LoadStudioHeader(const char* const pszFilename, const bool bAllowSeqGroup)
 {
@@ -366,7 +693,7 @@ studio_ptr<T> LoadStudioHeader(const char* const pszFilename, const bool bAllowS
 	const size_t uiRead = fread(pStudioHdr, size, 1, pFile);
 	fclose(pFile);
 
-	if (uiRead != 1)
+	if (uiRead != 1 || size < sizeof(studioseqhdr_t))
 	{
 		throw StudioModelInvalidFormat(std::string{"Error reading file\""} + pszFilename + "\"");
 	}
@@ -389,14 +716,24 @@ studio_ptr<T> LoadStudioHeader(const char* const pszFilename, const bool bAllowS
 			pStudioHdr->version);
 	}
 
+	//Everything that works with the whole file, like saving, relies on this
+	if (pStudioHdr->length < static_cast<int>(sizeof(studioseqhdr_t)) || static_cast<size_t>(pStudioHdr->length) > size)
+	{
+		throw StudioModelInvalidFormat(std::string{"File \""} + pszFilename + "\": length in header does not match file size");
+	}
+
 	buffer.release();
 
 	return studio_ptr<T>(pStudioHdr);
 }
-}
 
-std::unique_ptr<CStudioModel> LoadStudioModel(const char* const pszFilename)
+template studio_ptr<studiohdr_t> LoadStudioHeader<studiohdr_t>(const char* const pszFilename, const bool bAllowSeqGroup);
+template studio_ptr<studioseqhdr_t> LoadStudioHeader<studioseqhdr_t>(const char* const pszFilename, const bool bAllowSeqGroup);
+
+StudioModelFiles ReadStudioModelFiles(const char* const pszFilename)
 {
+	PROFILE_SCOPE("ReadStudioModelFiles");
+
 	const std::filesystem::path fileName{std::filesystem::u8path(pszFilename)};
 
 	std::filesystem::path baseFileName{fileName};
@@ -405,8 +742,10 @@ std::unique_ptr<CStudioModel> LoadStudioModel(const char* const pszFilename)
 
 	const auto bIsDol = fileName.extension() == ".dol";
 
+	std::vector<StudioFileState> fileStates;
+
 	//Load the model
-	auto mainHeader = LoadStudioHeader<studiohdr_t>(pszFilename, false);
+	auto mainHeader = ReadStudioFile<studiohdr_t>(fileName, false, fileStates);
 
 	if (mainHeader->name[0] == '\0')
 	{
@@ -432,7 +771,7 @@ std::unique_ptr<CStudioModel> LoadStudioModel(const char* const pszFilename)
 
 		texturename += extension;
 
-		textureHeader = LoadStudioHeader<studiohdr_t>(texturename.u8string().c_str(), true);
+		textureHeader = ReadStudioFile<studiohdr_t>(texturename, true, fileStates);
 	}
 
 	std::vector<studio_ptr<studioseqhdr_t>> sequenceHeaders;
@@ -454,19 +793,47 @@ std::unique_ptr<CStudioModel> LoadStudioModel(const char* const pszFilename)
 				std::setfill('0') << std::setw(2) << i <<
 				std::setw(0) << suffix;
 
-			sequenceHeaders.emplace_back(LoadStudioHeader<studioseqhdr_t>(seqgroupname.str().c_str(), true));
+			sequenceHeaders.emplace_back(ReadStudioFile<studioseqhdr_t>(std::filesystem::u8path(seqgroupname.str()), true, fileStates));
 		}
 	}
 
+	if (bIsDol)
+	{
+		//The hashes are of the files as read, so saving still writes the converted file
+		ConvertDolTextures(textureHeader ? *textureHeader : *mainHeader);
+	}
+
+	return {pszFilename, std::move(mainHeader), std::move(textureHeader), std::move(sequenceHeaders), std::move(fileStates)};
+}
+
+std::unique_ptr<CStudioModel> CreateStudioModel(StudioModelFiles&& files, CStudioModel* pPrevious)
+{
+	PROFILE_SCOPE("CreateStudioModel");
+
+	assert(files.MainHeader);
+
 	std::vector<GLuint> textures;
 
-	UploadTextures(textureHeader ? *textureHeader : *mainHeader, textures, r_filtertextures.GetBool(), r_powerof2textures.GetBool(), bIsDol);
+	UploadTextures(files.TextureHeader ? *files.TextureHeader : *files.MainHeader, textures, r_filtertextures.GetBool(), r_powerof2textures.GetBool(),
+		pPrevious ? pPrevious->GetTextureHeader() : nullptr, pPrevious ? &pPrevious->m_Textures : nullptr);
+
+	auto model = std::make_unique<CStudioModel>(std::move(files.FileName), std::move(files.MainHeader), std::move(files.TextureHeader),
+		std::move(files.SequenceHeaders), std::move(textures));
+
+	model->m_FileStates = std::move(files.FileStates);
+
+	return model;
+}
+
+std::unique_ptr<CStudioModel> LoadStudioModel(const char* const pszFilename)
+{
+	PROFILE_SCOPE("LoadStudioModel");
 
-	return std::make_unique<CStudioModel>(pszFilename, std::move(mainHeader), std::move(textureHeader),
-		std::move(sequenceHeaders), std::move(textures));
+	return CreateStudioModel(ReadStudioModelFiles(pszFilename));
 }
 
-void SaveStudioModel(const char* const pszFilename, CStudioModel& model, bool correctSequenceGroupFileNames)
+
+StudioModelSaveResult SaveStudioModel(const char* const pszFilename, CStudioModel& model, bool correctSequenceGroupFileNames)
 {
 	if (!pszFilename)
 	{
@@ -546,52 +913,48 @@ void SaveStudioModel(const char* const pszFilename, CStudioModel& model, bool co
 		}
 	}
 
-	FILE* pFile = utf8_fopen(pszFilename, "wb");
-
-	if (!pFile)
-	{
-		throw StudioModelException("Could not open main file for writing");
-	}
-
-	bool bSuccess = fwrite(pStudioHdr, sizeof(byte), pStudioHdr->length, pFile) == pStudioHdr->length;
-
-	fclose(pFile);
-
-	if (!bSuccess)
-	{
-		throw StudioModelException("Error while writing to main file");
-	}
-
 	const std::filesystem::path fileName{std::filesystem::u8path(pszFilename)};
 
 	auto baseFileName{fileName};
 
 	baseFileName.replace_extension();
 
-	// write texture model
-	if (model.HasSeparateTextureHeader())
-	{
-		const studiohdr_t* const pTextureHdr = model.GetTextureHeader();
+	StudioModelSaveResult result;
 
-		auto texturename = baseFileName;
+	auto writeFile = [&](const std::filesystem::path& name, const void* pData, const int length, const char* const pszDescription)
+	{
+		const auto size = static_cast<std::size_t>(length);
 
-		texturename += "T.mdl";
+		StudioFileState state{NormalizeFileName(name), {}, HashStudioData(pData, size)};
 
-		pFile = utf8_fopen(texturename.u8string().c_str(), "wb");
+		auto it = std::find_if(model.m_FileStates.begin(), model.m_FileStates.end(), [&](const auto& candidate)
+			{
+				return candidate.FileName == state.FileName;
+			});
 
-		if (!pFile)
+		//Unchanged in memory and on disk since it was read or saved
+		if (it != model.m_FileStates.end() && it->Hash == state.Hash && it->Stamp.Size == size && GetModelFileStamp(name) == it->Stamp)
 		{
-			throw StudioModelException("Could not open texture file for writing");
+			++result.FilesUnchanged;
+			return;
 		}
 
-		bSuccess = fwrite(pTextureHdr, sizeof(byte), pTextureHdr->length, pFile) == pTextureHdr->length;
-		fclose(pFile);
+		WriteFileSafely(name, pData, size, pszDescription);
+
+		++result.FilesWritten;
+		result.BytesWritten += size;
 
-		if (!bSuccess)
+		state.Stamp = GetModelFileStamp(name);
+
+		if (it != model.m_FileStates.end())
 		{
-			throw StudioModelException("Error while writing to texture file");
+			*it = std::move(state);
 		}
-	}
+		else
+		{
+			model.m_FileStates.emplace_back(std::move(state));
+		}
+	};
 
 	// write seq groups
 	if (pStudioHdr->numseqgroups > 1)
@@ -606,24 +969,28 @@ void SaveStudioModel(const char* const pszFilename, CStudioModel& model, bool co
 				std::setfill('0') << std::setw(2) << i <<
 				std::setw(0) << ".mdl";
 
-			pFile = utf8_fopen(seqgroupname.str().c_str(), "wb");
+			const auto pAnimHdr = model.GetSeqGroupHeader(i - 1);
 
-			if (!pFile)
-			{
-				throw StudioModelException("Could not open sequence file for writing");
-			}
+			writeFile(std::filesystem::u8path(seqgroupname.str()), pAnimHdr, pAnimHdr->length, "sequence");
+		}
+	}
 
-			const auto pAnimHdr = model.GetSeqGroupHeader(i - 1);
+	// write texture model
+	if (model.HasSeparateTextureHeader())
+	{
+		const studiohdr_t* const pTextureHdr = model.GetTextureHeader();
 
-			bSuccess = fwrite(pAnimHdr, sizeof(byte), pAnimHdr->length, pFile) == pAnimHdr->length;
-			fclose(pFile);
+		auto texturename = baseFileName;
 
-			if (!bSuccess)
-			{
-				throw StudioModelException("Error while writing to sequence file");
-			}
-		}
+		texturename += "T.mdl";
+
+		writeFile(texturename, pTextureHdr, pTextureHdr->length, "texture");
 	}
+
+	//Written last, so it never refers to files that have not been written yet
+	writeFile(fileName, pStudioHdr, pStudioHdr->length, "main");
+
+	return result;
 }
 
 void ScaleMeshes(CStudioModel* pStudioModel, const float flScale)
@@ -1,9 +1,14 @@
 #ifndef GAME_STUDIOMODEL_CSTUDIOMODEL_H
 #define GAME_STUDIOMODEL_CSTUDIOMODEL_H
 
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <glm/vec3.hpp>
@@ -16,6 +21,9 @@
 #include "graphics/OpenGL.h"
 
 #include "studio.h"
+#include "CStudioEventIndex.h"
+#include "CStudioModelCache.h"
+#include "StudioSorting.h"
 
 namespace studiomdl
 {
@@ -94,6 +102,92 @@ using studio_ptr = std::unique_ptr<T, StudioDataDeleter>;
 
 class CStudioModel;
 
+/**
+*	Loads a single studio model, texture or sequence group file and validates its identifier and version
+*	@param pszFilename Name of the file to load. This is the entire path, including the extension
+*	@param bAllowSeqGroup Whether sequence group files are accepted
+*	@exception StudioModelNotFound If the file could not be found
+*	@exception StudioModelInvalidFormat If the file has an invalid format
+*	@exception StudioModelVersionDiffers If the file has the wrong studio version
+*/
+template<typename T>
+studio_ptr<T> LoadStudioHeader(const char* const pszFilename, const bool bAllowSeqGroup);
+
+extern template studio_ptr<studiohdr_t> LoadStudioHeader<studiohdr_t>(const char* const pszFilename, const bool bAllowSeqGroup);
+extern template studio_ptr<studioseqhdr_t> LoadStudioHeader<studioseqhdr_t>(const char* const pszFilename, const bool bAllowSeqGroup);
+
+/**
+*	Converts an 8 bit texture to 32 bit RGBA, resampling it to power of 2 dimensions if requested.
+*	If the texture is masked, the palette's mask color is set to black.
+*	@param texture Texture to convert
+*	@param pData Texture pixels
+*	@param pPalette Texture palette
+*	@param bPowerOf2 Whether to resample the texture to power of 2 dimensions
+*	@param outWidth Width of the converted texture
+*	@param outHeight Height of the converted texture
+*	@return Converted pixels, or null if the texture has invalid dimensions
+*/
+std::unique_ptr<byte[]> ConvertTextureToRGBA(const mstudiotexture_t& texture, const byte* pData, byte* pPalette, const bool bPowerOf2,
+	int& outWidth, int& outHeight);
+
+/**
+*	@return Whether textures are resampled to power of 2 dimensions when they are uploaded. Reads a cvar, so only call this on the main thread
+*/
+bool ShouldResizeTexturesToPowerOf2();
+
+/**
+*	@brief A file that a model was read from or saved to, as it was at that time
+*	Used by SaveStudioModel to leave files alone that would be written with the contents they already have.
+*/
+struct StudioFileState
+{
+	/**
+	*	Absolute, normalized path.
+	*/
+	std::filesystem::path FileName;
+
+	ModelFileStamp Stamp;
+
+	/**
+	*	Hash of the contents of the file.
+	*/
+	std::uint64_t Hash = 0;
+};
+
+/**
+*	@brief The files of a studio model, read into memory but not yet turned into a model
+*/
+struct StudioModelFiles
+{
+	std::string FileName;
+
+	studio_ptr<studiohdr_t> MainHeader;
+	studio_ptr<studiohdr_t> TextureHeader;
+	std::vector<studio_ptr<studioseqhdr_t>> SequenceHeaders;
+
+	std::vector<StudioFileState> FileStates;
+};
+
+/**
+*	Reads the main, texture and sequence group files of a studio model. PS2 textures are converted to the PC layout.
+*	Does not use the render context or cvars, and its profiler timing is safe on any thread, so this can be called from worker threads.
+*	Besides the exceptions below it can throw whatever the standard library throws when reading files or allocating memory.
+*	@param pszFilename Name of the model to read. This is the entire path, including the extension
+*	@exception StudioModelNotFound If a file could not be found
+*	@exception StudioModelInvalidFormat If a file has an invalid format
+*	@exception StudioModelVersionDiffers If a file has the wrong studio version
+*	@exception StudioModelIsNotMainHeader If the file is not a main header
+*/
+StudioModelFiles ReadStudioModelFiles(const char* const pszFilename);
+
+/**
+*	Creates a model from files that were read by ReadStudioModelFiles and uploads its textures. Must be called on the main thread.
+*	@param files Files to create the model from. Must have a main header
+*	@param pPrevious If not null, textures that are identical to the texture with the same index in this model are taken from it
+*		instead of being uploaded again. The previous model must not be drawn afterwards
+*/
+std::unique_ptr<CStudioModel> CreateStudioModel(StudioModelFiles&& files, CStudioModel* pPrevious = nullptr);
+
 /**
 *	Loads a studio model
 *	@param pszFilename Name of the model to load. This is the entire path, including the extension
@@ -103,14 +197,32 @@ class CStudioModel;
 */
 std::unique_ptr<CStudioModel> LoadStudioModel(const char* const pszFilename);
 
+/**
+*	@brief What SaveStudioModel did
+*/
+struct StudioModelSaveResult
+{
+	std::size_t FilesWritten = 0;
+
+	/**
+	*	Files that already had the contents they would have been saved with, and were left alone.
+	*/
+	std::size_t FilesUnchanged = 0;
+
+	std::uintmax_t BytesWritten = 0;
+};
+
 /**
 *	Saves a studio model.
+*	Only files whose contents changed since the model was read from or last saved to them are written,
+*	unless they were changed on disk in the meantime. Each file is written to a temporary file that replaces the original
+*	once it has been flushed to disk, so an interrupted save leaves the original intact.
 *	@param pszFilename Name of the file to save the model to. This is the entire path, including the extension.
 *	@param model Model to save.
 * *	@param correctSequenceGroupFileNames Whether the sequence group filenames embedded in the main file should be corrected
 *	@exception StudioModelException If an error occurs or if the given data is invalid
 */
-void SaveStudioModel( const char* const pszFilename, CStudioModel& model, bool correctSequenceGroupFileNames );
+StudioModelSaveResult SaveStudioModel( const char* const pszFilename, CStudioModel& model, bool correctSequenceGroupFileNames );
 
 /**
 *	Container representing a studiomodel and its data.
@@ -122,7 +234,8 @@ private:
 	typedef std::vector<MeshList_t> TextureMeshMap_t;
 
 protected:
-	friend std::unique_ptr<CStudioModel> LoadStudioModel(const char* const pszFilename);
+	friend std::unique_ptr<CStudioModel> CreateStudioModel(StudioModelFiles&& files, CStudioModel* pPrevious);
+	friend StudioModelSaveResult SaveStudioModel( const char* const pszFilename, CStudioModel& model, bool correctSequenceGroupFileNames );
 
 public:
 	static const size_t MAX_SEQGROUPS = 32;
@@ -162,6 +275,11 @@ public:
 
 	bool			CalculateBodygroup( const int iGroup, const int iValue, int& iInOutBodygroup ) const;
 
+	/**
+	*	@return The submodel that the given bodygroup value selects in the given body part, or 0 if the body part doesn't exist
+	*/
+	int				GetBodygroupValue( const int iGroup, const int iBodygroup ) const;
+
 	GLuint			GetTextureId( const int iIndex ) const;
 
 	void			ReplaceTexture( mstudiotexture_t* ptexture, byte *data, byte *pal, GLuint textureId );
@@ -172,6 +290,53 @@ public:
 	*/
 	void ReuploadTexture( mstudiotexture_t* ptexture );
 
+	/**
+	*	Uploads pixels that were already converted by ConvertTextureToRGBA, so the conversion can be done on another thread.
+	*	Does not change the texture's pixel or palette data.
+	*	@param iIndex Index of the texture to upload to.
+	*/
+	void UploadConvertedTexture( const int iIndex, const int iWidth, const int iHeight, const byte* pRGBA );
+
+	/**
+	*	@brief Gives up ownership of the textures, so they are not deleted through OpenGL when the model is destroyed
+	*	Used when the textures were created by a render context that is not backed by OpenGL. The model must not be drawn afterwards.
+	*	@return The texture ids, in texture order
+	*/
+	std::vector<GLuint> ReleaseTextures() { return std::exchange( m_Textures, {} ); }
+
+	/**
+	*	@brief Gets the triangles of all meshes in a submodel as vertex indices, 3 per triangle
+	*	Decoded from the triangle commands when the model is created.
+	*	@param pModel Submodel. Must be a submodel of this model
+	*/
+	const std::vector<unsigned short>& GetTriangleList( const mstudiomodel_t* pModel ) const;
+
+	/**
+	*	@brief Gets the meshes of a submodel in draw order for a skin family
+	*	@param pModel Submodel. Must be a submodel of this model
+	*	@param iSkin Skin family. Families that don't exist use the first one, like the renderer does
+	*	@param bGroupByTexture Whether to get the order that draws meshes sharing a texture next to each other.
+	*		Only use this when the model is drawn opaque, it changes the order in which blended meshes are drawn
+	*	@see SortMeshes
+	*	@see GroupMeshesByTexture
+	*/
+	const std::vector<SortedMesh_t>& GetSortedMeshes( const mstudiomodel_t* pModel, const int iSkin, const bool bGroupByTexture ) const;
+
+	/**
+	*	@brief Recomputes the draw order of all meshes. Computed when the model is created, must be called after texture render modes have been changed
+	*/
+	void UpdateMeshDrawOrder();
+
+	/**
+	*	@brief Gets the animation events of all sequences, sorted by frame. Built when the model is created
+	*/
+	const CStudioEventIndex& GetEventIndex() const { return m_EventIndex; }
+
+	/**
+	*	@brief Rebuilds the event index. Must be called after events have been changed
+	*/
+	void RebuildEventIndex();
+
 	std::vector<mstudiobone_t*> GetRootBones()
 	{
 		std::vector<mstudiobone_t*> bones;
@@ -189,6 +354,12 @@ public:
 		return bones;
 	}
 
+private:
+	/**
+	*	@brief Decodes the triangles of all submodels, so models can be read by several threads without any of them writing to it
+	*/
+	void BuildTriangleLists();
+
 private:
 	std::string m_FileName;
 
@@ -199,6 +370,29 @@ private:
 
 	std::vector<GLuint> m_Textures;
 
+	/**
+	*	Files this model was read from or saved to.
+	*/
+	std::vector<StudioFileState> m_FileStates;
+
+	/**
+	*	Triangles of each submodel, decoded from the triangle commands.
+	*/
+	std::unordered_map<const mstudiomodel_t*, std::vector<unsigned short>> m_TriangleLists;
+
+	struct SkinDrawOrder
+	{
+		std::vector<SortedMesh_t> Meshes;
+		std::vector<SortedMesh_t> MeshesByTexture;
+	};
+
+	/**
+	*	Draw order of each submodel's meshes, per skin family.
+	*/
+	std::unordered_map<const mstudiomodel_t*, std::vector<SkinDrawOrder>> m_SortedMeshes;
+
+	CStudioEventIndex m_EventIndex;
+
 private:
 	CStudioModel( const CStudioModel& ) = delete;
 	CStudioModel& operator=( const CStudioModel& ) = delete;
@@ -0,0 +1,231 @@
+#include <cstdio>
+#include <system_error>
+
+#include "cvar/CCVar.h"
+
+#include "CStudioModel.h"
+#include "CStudioModelCache.h"
+
+namespace studiomdl
+{
+namespace
+{
+static cvar::CCVar studio_cache_size("studio_cache_size",
+	cvar::CCVarArgsBuilder()
+	.Flags(cvar::Flag::ARCHIVE)
+	.FloatValue(256)
+	.MinValue(0)
+	.HelpInfo("Memory in megabytes that cached studio models can use before models that are not in use are destroyed"));
+
+/**
+*	@brief Gets the files a model was loaded from, using the same names as LoadStudioModel
+*/
+std::vector<std::filesystem::path> GetModelFiles(const std::filesystem::path& fileName, const CStudioModel& model)
+{
+	std::vector<std::filesystem::path> files{fileName};
+
+	auto baseFileName = fileName;
+
+	baseFileName.replace_extension();
+
+	const bool bIsDol = fileName.extension() == ".dol";
+
+	if (model.HasSeparateTextureHeader())
+	{
+		auto textureFileName = baseFileName;
+
+		textureFileName += bIsDol ? "T.dol" : "T.mdl";
+
+		files.emplace_back(std::move(textureFileName));
+	}
+
+	for (int i = 1; i < model.GetStudioHeader()->numseqgroups; ++i)
+	{
+		char szSuffix[16];
+
+		snprintf(szSuffix, sizeof(szSuffix), "%02d%s", i, bIsDol ? ".dol" : ".mdl");
+
+		auto sequenceFileName = baseFileName;
+
+		sequenceFileName += szSuffix;
+
+		files.emplace_back(std::move(sequenceFileName));
+	}
+
+	return files;
+}
+
+std::vector<ModelFileStamp> GetFileStamps(const std::filesystem::path& fileName, const CStudioModel& model)
+{
+	std::vector<ModelFileStamp> stamps;
+
+	for (const auto& file : GetModelFiles(fileName, model))
+	{
+		stamps.push_back(GetModelFileStamp(file));
+	}
+
+	return stamps;
+}
+
+/**
+*	@brief Estimates the memory used by the model's files and its uploaded textures
+*/
+std::size_t EstimateMemoryUsage(const CStudioModel& model)
+{
+	std::size_t size = model.GetStudioHeader()->length;
+
+	if (model.HasSeparateTextureHeader())
+	{
+		size += model.GetTextureHeader()->length;
+	}
+
+	for (int i = 1; i < model.GetStudioHeader()->numseqgroups; ++i)
+	{
+		size += model.GetSeqGroupHeader(i - 1)->length;
+	}
+
+	const auto pTextureHdr = model.GetTextureHeader();
+
+	for (int i = 0; i < pTextureHdr->numtextures; ++i)
+	{
+		const auto pTexture = pTextureHdr->GetTexture(i);
+
+		size += static_cast<std::size_t>(pTexture->width) * pTexture->height * 4;
+	}
+
+	return size;
+}
+}
+
+ModelFileStamp GetModelFileStamp(const std::filesystem::path& fileName)
+{
+	//Files that can't be read get an empty stamp, so they count as changed once they can be read again
+	std::error_code error;
+
+	ModelFileStamp stamp;
+
+	stamp.LastWriteTime = std::filesystem::last_write_time(fileName, error);
+
+	if (!error)
+	{
+		stamp.Size = std::filesystem::file_size(fileName, error);
+	}
+
+	if (error)
+	{
+		return {};
+	}
+
+	return stamp;
+}
+
+CStudioModelCache::~CStudioModelCache()
+{
+	Clear();
+}
+
+std::shared_ptr<CStudioModel> CStudioModelCache::Load(const char* const pszFilename)
+{
+	const auto fileName = std::filesystem::u8path(pszFilename);
+
+	std::error_code error;
+
+	const auto canonicalFileName = std::filesystem::weakly_canonical(fileName, error);
+
+	const auto key = (error ? fileName : canonicalFileName).u8string();
+
+	if (auto it = m_Lookup.find(key); it != m_Lookup.end())
+	{
+		const auto entry = it->second;
+
+		if (GetFileStamps(fileName, *entry->Model) == entry->Stamps)
+		{
+			++m_Statistics.Hits;
+
+			m_Entries.splice(m_Entries.begin(), m_Entries, entry);
+
+			return entry->Model;
+		}
+
+		//Anything still using the old model keeps it until it is released
+		++m_Statistics.Reloads;
+
+		Remove(entry);
+	}
+	else
+	{
+		++m_Statistics.Misses;
+	}
+
+	auto files = ReadStudioModelFiles(pszFilename);
+
+	Entry entry;
+
+	entry.Key = key;
+
+	//Each file was stamped before it was read, so a file written during the load makes the entry outdated instead of looking fresh.
+	//The files are in the same order as GetModelFiles.
+	for (const auto& state : files.FileStates)
+	{
+		entry.Stamps.push_back(state.Stamp);
+	}
+
+	std::shared_ptr<CStudioModel> model = CreateStudioModel(std::move(files));
+
+	entry.Model = model;
+	entry.MemoryUsage = EstimateMemoryUsage(*model);
+
+	m_MemoryUsage += entry.MemoryUsage;
+
+	m_Entries.push_front(std::move(entry));
+	m_Lookup.emplace(key, m_Entries.begin());
+
+	Trim(static_cast<std::size_t>(studio_cache_size.GetFloat() * 1024 * 1024));
+
+	return model;
+}
+
+void CStudioModelCache::Detach(const CStudioModel* pModel)
+{
+	for (auto it = m_Entries.begin(); it != m_Entries.end(); ++it)
+	{
+		if (it->Model.get() == pModel)
+		{
+			Remove(it);
+			break;
+		}
+	}
+}
+
+void CStudioModelCache::Trim(const std::size_t maxBytes)
+{
+	for (auto it = m_Entries.end(); m_MemoryUsage > maxBytes && it != m_Entries.begin();)
+	{
+		--it;
+
+		//Only the cache holds on to it
+		if (it->Model.use_count() == 1)
+		{
+			++m_Statistics.Evictions;
+
+			it = Remove(it);
+		}
+	}
+}
+
+void CStudioModelCache::Clear()
+{
+	m_Lookup.clear();
+	m_Entries.clear();
+	m_MemoryUsage = 0;
+}
+
+CStudioModelCache::EntryList::iterator CStudioModelCache::Remove(EntryList::iterator it)
+{
+	m_MemoryUsage -= it->MemoryUsage;
+
+	m_Lookup.erase(it->Key);
+
+	return m_Entries.erase(it);
+}
+}
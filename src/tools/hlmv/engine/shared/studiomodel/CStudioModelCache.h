@@ -0,0 +1,129 @@
+#ifndef GAME_STUDIOMODEL_CSTUDIOMODELCACHE_H
+#define GAME_STUDIOMODEL_CSTUDIOMODELCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace studiomdl
+{
+class CStudioModel;
+
+/**
+*	@brief Size and modification time of a file a model was loaded from
+*/
+struct ModelFileStamp
+{
+	std::filesystem::file_time_type LastWriteTime;
+	std::uintmax_t Size = 0;
+
+	bool operator==(const ModelFileStamp& other) const
+	{
+		return LastWriteTime == other.LastWriteTime && Size == other.Size;
+	}
+};
+
+/**
+*	@brief Gets the size and modification time of a file. Files that can't be read get an empty stamp
+*/
+ModelFileStamp GetModelFileStamp(const std::filesystem::path& fileName);
+
+struct ModelCacheStatistics
+{
+	std::size_t Hits = 0;
+	std::size_t Misses = 0;
+
+	/**
+	*	Number of models that were loaded again because one of their files changed.
+	*/
+	std::size_t Reloads = 0;
+
+	std::size_t Evictions = 0;
+};
+
+/**
+*	@brief Shares loaded studio models between everything that uses the same file
+*	Models are keyed by their canonical path. A model is loaded again if the size or modification time of its main,
+*	texture or sequence group files changed. Users keep a model alive by holding on to it; models nobody uses anymore
+*	stay in the cache so opening them again is free, until the memory used by the cache exceeds studio_cache_size.
+*	The least recently used unused models are destroyed first. Models that are in use are never destroyed.
+*	Models own OpenGL textures, so the cache must only be used on the thread that owns the context.
+*/
+class CStudioModelCache final
+{
+public:
+	CStudioModelCache() = default;
+	~CStudioModelCache();
+
+	/**
+	*	@brief Gets a model from the cache, loading it if needed
+	*	@param pszFilename Name of the model to load. This is the entire path, including the extension
+	*	@exception StudioModelException If the model could not be loaded. See LoadStudioModel
+	*/
+	std::shared_ptr<CStudioModel> Load(const char* const pszFilename);
+
+	/**
+	*	@brief Removes a model from the cache without destroying it
+	*	Must be called when a model is changed in memory or saved, so later loads of its file read the file instead of getting the changed model.
+	*/
+	void Detach(const CStudioModel* pModel);
+
+	/**
+	*	@brief Destroys the least recently used models that are not in use until the cache uses at most the given amount of memory
+	*/
+	void Trim(const std::size_t maxBytes);
+
+	/**
+	*	@brief Removes all models. Models that are in use stay alive until they are released
+	*/
+	void Clear();
+
+	std::size_t GetCount() const { return m_Entries.size(); }
+
+	/**
+	*	@return Estimated memory used by all cached models, in bytes
+	*/
+	std::size_t GetMemoryUsage() const { return m_MemoryUsage; }
+
+	const ModelCacheStatistics& GetStatistics() const { return m_Statistics; }
+
+private:
+	struct Entry
+	{
+		std::string Key;
+		std::vector<ModelFileStamp> Stamps;
+		std::shared_ptr<CStudioModel> Model;
+		std::size_t MemoryUsage = 0;
+	};
+
+	using EntryList = std::list<Entry>;
+
+	/**
+	*	@return Iterator to the entry after the removed one
+	*/
+	EntryList::iterator Remove(EntryList::iterator it);
+
+private:
+	/**
+	*	Most recently used first.
+	*/
+	EntryList m_Entries;
+
+	std::unordered_map<std::string, EntryList::iterator> m_Lookup;
+
+	std::size_t m_MemoryUsage = 0;
+
+	ModelCacheStatistics m_Statistics;
+
+private:
+	CStudioModelCache(const CStudioModelCache&) = delete;
+	CStudioModelCache& operator=(const CStudioModelCache&) = delete;
+};
+}
+
+#endif //GAME_STUDIOMODEL_CSTUDIOMODELCACHE_H
@@ -0,0 +1,479 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <glm/geometric.hpp>
+#include <glm/common.hpp>
+
+#include "utility/mathlib.h"
+
+#include "CStudioModel.h"
+#include "CStudioModelPicker.h"
+#include "TriangleCommands.h"
+
+namespace studiomdl
+{
+namespace
+{
+/**
+*	Maximum number of triangles in a leaf node.
+*/
+const std::uint32_t MAX_LEAF_TRIANGLES = 4;
+
+/**
+*	Deep enough for any tree built over the maximum number of triangles a model can have.
+*/
+const std::size_t MAX_TRAVERSAL_DEPTH = 64;
+
+bool IntersectBox(const glm::vec3& mins, const glm::vec3& maxs, const glm::vec3& vecOrigin, const glm::vec3& vecInvDirection, float flMaxDistance, float& flEntry)
+{
+	float tMin = 0;
+	float tMax = flMaxDistance;
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		float t1 = (mins[axis] - vecOrigin[axis]) * vecInvDirection[axis];
+		float t2 = (maxs[axis] - vecOrigin[axis]) * vecInvDirection[axis];
+
+		if (t1 > t2)
+		{
+			std::swap(t1, t2);
+		}
+
+		tMin = std::max(tMin, t1);
+		tMax = std::min(tMax, t2);
+
+		if (tMin > tMax)
+		{
+			return false;
+		}
+	}
+
+	flEntry = tMin;
+
+	return true;
+}
+
+/**
+*	Moller-Trumbore ray/triangle intersection, double sided.
+*/
+bool IntersectTriangle(const glm::vec3& vecOrigin, const glm::vec3& vecDirection,
+	const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, float& t, float& u, float& v)
+{
+	const glm::vec3 edge1 = v1 - v0;
+	const glm::vec3 edge2 = v2 - v0;
+
+	const glm::vec3 p = glm::cross(vecDirection, edge2);
+
+	const float det = glm::dot(edge1, p);
+
+	if (std::abs(det) < std::numeric_limits<float>::epsilon())
+	{
+		return false;
+	}
+
+	const float invDet = 1.0f / det;
+
+	const glm::vec3 s = vecOrigin - v0;
+
+	u = glm::dot(s, p) * invDet;
+
+	if (u < 0 || u > 1)
+	{
+		return false;
+	}
+
+	const glm::vec3 q = glm::cross(s, edge1);
+
+	v = glm::dot(vecDirection, q) * invDet;
+
+	if (v < 0 || u + v > 1)
+	{
+		return false;
+	}
+
+	t = glm::dot(edge2, q) * invDet;
+
+	return t >= 0;
+}
+}
+
+void CStudioModelPicker::Clear()
+{
+	m_pModel = nullptr;
+	m_iBodygroup = -1;
+
+	m_BoneTransforms.clear();
+	m_Vertices.clear();
+	m_PosedVertices.clear();
+	m_Triangles.clear();
+	m_Nodes.clear();
+}
+
+void CStudioModelPicker::Update(const CStudioModel* pModel, int iBodygroup, const glm::mat3x4* pBoneTransforms)
+{
+	if (!pModel)
+	{
+		Clear();
+		return;
+	}
+
+	const auto numBones = static_cast<std::size_t>(pModel->GetStudioHeader()->numbones);
+
+	if (pModel != m_pModel || iBodygroup != m_iBodygroup)
+	{
+		m_pModel = pModel;
+		m_iBodygroup = iBodygroup;
+
+		m_BoneTransforms.assign(pBoneTransforms, pBoneTransforms + numBones);
+
+		Build();
+		return;
+	}
+
+	//Nothing to do if the pose is unchanged
+	if (m_BoneTransforms.size() == numBones && !memcmp(m_BoneTransforms.data(), pBoneTransforms, numBones * sizeof(glm::mat3x4)))
+	{
+		return;
+	}
+
+	m_BoneTransforms.assign(pBoneTransforms, pBoneTransforms + numBones);
+
+	PoseVertices(m_BoneTransforms.data());
+	Refit();
+
+	++m_uiRefitCount;
+}
+
+void CStudioModelPicker::Build()
+{
+	++m_uiBuildCount;
+
+	m_Vertices.clear();
+	m_Triangles.clear();
+	m_Nodes.clear();
+
+	const auto pStudioHdr = m_pModel->GetStudioHeader();
+
+	for (int bodyPart = 0; bodyPart < pStudioHdr->numbodyparts; ++bodyPart)
+	{
+		const auto pSubModel = m_pModel->GetModelByBodyPart(m_iBodygroup, bodyPart);
+
+		const auto firstVertex = static_cast<std::uint32_t>(m_Vertices.size());
+
+		const auto pVertBones = reinterpret_cast<const byte*>(pStudioHdr) + pSubModel->vertinfoindex;
+
+		for (int index = 0; index < pSubModel->numverts; ++index)
+		{
+			m_Vertices.push_back({static_cast<std::uint16_t>(bodyPart), static_cast<std::uint16_t>(index), pVertBones[index]});
+		}
+
+		const auto pMeshes = reinterpret_cast<const mstudiomesh_t*>(reinterpret_cast<const byte*>(pStudioHdr) + pSubModel->meshindex);
+
+		for (int mesh = 0; mesh < pSubModel->nummesh; ++mesh)
+		{
+			const auto ptricmds = reinterpret_cast<const short*>(reinterpret_cast<const byte*>(pStudioHdr) + pMeshes[mesh].triindex);
+
+			DecodeTriangleCommands(ptricmds, [&](const short* pVertex0, const short* pVertex1, const short* pVertex2)
+				{
+					const short* const pVerts[3] = {pVertex0, pVertex1, pVertex2};
+
+					Triangle triangle;
+
+					bool isValid = true;
+
+					for (int corner = 0; corner < 3; ++corner)
+					{
+						isValid = isValid && pVerts[corner][0] >= 0 && pVerts[corner][0] < pSubModel->numverts;
+
+						triangle.Vertices[corner] = firstVertex + pVerts[corner][0];
+						triangle.S[corner] = pVerts[corner][2];
+						triangle.T[corner] = pVerts[corner][3];
+					}
+
+					triangle.BodyPart = static_cast<std::uint16_t>(bodyPart);
+					triangle.Mesh = static_cast<std::uint16_t>(mesh);
+
+					if (isValid)
+					{
+						m_Triangles.push_back(triangle);
+					}
+				});
+		}
+	}
+
+	PoseVertices(m_BoneTransforms.data());
+
+	if (m_Triangles.empty())
+	{
+		return;
+	}
+
+	std::vector<glm::vec3> centroids;
+
+	centroids.reserve(m_Triangles.size());
+
+	for (const auto& triangle : m_Triangles)
+	{
+		centroids.push_back((m_PosedVertices[triangle.Vertices[0]] + m_PosedVertices[triangle.Vertices[1]] + m_PosedVertices[triangle.Vertices[2]]) / 3.0f);
+	}
+
+	std::vector<std::uint32_t> order(m_Triangles.size());
+
+	for (std::uint32_t index = 0; index < order.size(); ++index)
+	{
+		order[index] = index;
+	}
+
+	m_Nodes.reserve(2 * (m_Triangles.size() / MAX_LEAF_TRIANGLES + 1));
+
+	BuildNode(0, static_cast<std::uint32_t>(m_Triangles.size()), centroids, order);
+
+	//Store triangles in leaf order so each leaf references a contiguous range
+	std::vector<Triangle> triangles;
+
+	triangles.reserve(m_Triangles.size());
+
+	for (const auto index : order)
+	{
+		triangles.push_back(m_Triangles[index]);
+	}
+
+	m_Triangles = std::move(triangles);
+
+	Refit();
+}
+
+void CStudioModelPicker::PoseVertices(const glm::mat3x4* pBoneTransforms)
+{
+	const auto pStudioHdr = m_pModel->GetStudioHeader();
+
+	m_PosedVertices.resize(m_Vertices.size());
+
+	int lastBodyPart = -1;
+	const glm::vec3* pStudioVerts = nullptr;
+
+	for (std::size_t index = 0; index < m_Vertices.size(); ++index)
+	{
+		const auto& vertex = m_Vertices[index];
+
+		if (vertex.BodyPart != lastBodyPart)
+		{
+			lastBodyPart = vertex.BodyPart;
+
+			const auto pSubModel = m_pModel->GetModelByBodyPart(m_iBodygroup, lastBodyPart);
+
+			pStudioVerts = reinterpret_cast<const glm::vec3*>(reinterpret_cast<const byte*>(pStudioHdr) + pSubModel->vertindex);
+		}
+
+		VectorTransform(pStudioVerts[vertex.Index], pBoneTransforms[vertex.Bone], m_PosedVertices[index]);
+	}
+}
+
+void CStudioModelPicker::ComputeTriangleBounds(std::uint32_t first, std::uint32_t count, glm::vec3& mins, glm::vec3& maxs) const
+{
+	mins = glm::vec3(std::numeric_limits<float>::max());
+	maxs = glm::vec3(std::numeric_limits<float>::lowest());
+
+	for (auto index = first; index < first + count; ++index)
+	{
+		for (const auto vertex : m_Triangles[index].Vertices)
+		{
+			mins = glm::min(mins, m_PosedVertices[vertex]);
+			maxs = glm::max(maxs, m_PosedVertices[vertex]);
+		}
+	}
+}
+
+std::uint32_t CStudioModelPicker::BuildNode(std::uint32_t first, std::uint32_t count, const std::vector<glm::vec3>& centroids, std::vector<std::uint32_t>& order)
+{
+	const auto nodeIndex = static_cast<std::uint32_t>(m_Nodes.size());
+
+	m_Nodes.emplace_back();
+
+	if (count <= MAX_LEAF_TRIANGLES)
+	{
+		m_Nodes[nodeIndex].Index = first;
+		m_Nodes[nodeIndex].Count = count;
+		return nodeIndex;
+	}
+
+	//Split at the median of the longest axis of the centroid bounds
+	glm::vec3 centroidMins{std::numeric_limits<float>::max()};
+	glm::vec3 centroidMaxs{std::numeric_limits<float>::lowest()};
+
+	for (auto index = first; index < first + count; ++index)
+	{
+		centroidMins = glm::min(centroidMins, centroids[order[index]]);
+		centroidMaxs = glm::max(centroidMaxs, centroids[order[index]]);
+	}
+
+	const glm::vec3 extents = centroidMaxs - centroidMins;
+
+	const int axis = extents.x > extents.y ? (extents.x > extents.z ? 0 : 2) : (extents.y > extents.z ? 1 : 2);
+
+	const auto middle = first + count / 2;
+
+	std::nth_element(order.begin() + first, order.begin() + middle, order.begin() + first + count, [&](std::uint32_t lhs, std::uint32_t rhs)
+		{
+			return centroids[lhs][axis] < centroids[rhs][axis];
+		});
+
+	BuildNode(first, middle - first, centroids, order);
+
+	const auto rightIndex = BuildNode(middle, first + count - middle, centroids, order);
+
+	m_Nodes[nodeIndex].Index = rightIndex;
+	m_Nodes[nodeIndex].Count = 0;
+
+	return nodeIndex;
+}
+
+void CStudioModelPicker::Refit()
+{
+	//Children are always stored after their parent, so a reverse walk updates children first
+	for (auto index = m_Nodes.size(); index-- > 0;)
+	{
+		auto& node = m_Nodes[index];
+
+		if (node.Count > 0)
+		{
+			ComputeTriangleBounds(node.Index, node.Count, node.Mins, node.Maxs);
+		}
+		else
+		{
+			const auto& left = m_Nodes[index + 1];
+			const auto& right = m_Nodes[node.Index];
+
+			node.Mins = glm::min(left.Mins, right.Mins);
+			node.Maxs = glm::max(left.Maxs, right.Maxs);
+		}
+	}
+}
+
+bool CStudioModelPicker::Pick(const glm::vec3& vecOrigin, const glm::vec3& vecDirection, int iSkin, PickResult& result) const
+{
+	result = PickResult{};
+
+	if (m_Nodes.empty())
+	{
+		return false;
+	}
+
+	const glm::vec3 vecInvDirection{1.0f / vecDirection.x, 1.0f / vecDirection.y, 1.0f / vecDirection.z};
+
+	float flClosest = std::numeric_limits<float>::max();
+	const Triangle* pClosest = nullptr;
+	float closestU = 0, closestV = 0;
+
+	std::uint32_t stack[MAX_TRAVERSAL_DEPTH];
+	std::size_t stackSize = 0;
+
+	stack[stackSize++] = 0;
+
+	float flEntry;
+
+	while (stackSize > 0)
+	{
+		const auto& node = m_Nodes[stack[--stackSize]];
+
+		if (!IntersectBox(node.Mins, node.Maxs, vecOrigin, vecInvDirection, flClosest, flEntry))
+		{
+			continue;
+		}
+
+		if (node.Count > 0)
+		{
+			for (auto index = node.Index; index < node.Index + node.Count; ++index)
+			{
+				const auto& triangle = m_Triangles[index];
+
+				float t, u, v;
+
+				if (IntersectTriangle(vecOrigin, vecDirection,
+					m_PosedVertices[triangle.Vertices[0]], m_PosedVertices[triangle.Vertices[1]], m_PosedVertices[triangle.Vertices[2]], t, u, v)
+					&& t < flClosest)
+				{
+					flClosest = t;
+					pClosest = &triangle;
+					closestU = u;
+					closestV = v;
+				}
+			}
+		}
+		else if (stackSize + 2 <= MAX_TRAVERSAL_DEPTH)
+		{
+			const auto leftIndex = static_cast<std::uint32_t>(&node - m_Nodes.data()) + 1;
+			const auto rightIndex = node.Index;
+
+			//Visit the nearer child first so farther subtrees are more likely to be culled
+			float leftEntry = std::numeric_limits<float>::max(), rightEntry = std::numeric_limits<float>::max();
+
+			const bool hitLeft = IntersectBox(m_Nodes[leftIndex].Mins, m_Nodes[leftIndex].Maxs, vecOrigin, vecInvDirection, flClosest, leftEntry);
+			const bool hitRight = IntersectBox(m_Nodes[rightIndex].Mins, m_Nodes[rightIndex].Maxs, vecOrigin, vecInvDirection, flClosest, rightEntry);
+
+			if (hitLeft && hitRight)
+			{
+				if (leftEntry < rightEntry)
+				{
+					stack[stackSize++] = rightIndex;
+					stack[stackSize++] = leftIndex;
+				}
+				else
+				{
+					stack[stackSize++] = leftIndex;
+					stack[stackSize++] = rightIndex;
+				}
+			}
+			else if (hitLeft)
+			{
+				stack[stackSize++] = leftIndex;
+			}
+			else if (hitRight)
+			{
+				stack[stackSize++] = rightIndex;
+			}
+		}
+	}
+
+	if (!pClosest)
+	{
+		return false;
+	}
+
+	const float weights[3] = {1 - closestU - closestV, closestU, closestV};
+
+	const int closestCorner = weights[0] >= weights[1] ? (weights[0] >= weights[2] ? 0 : 2) : (weights[1] >= weights[2] ? 1 : 2);
+
+	const auto& vertex = m_Vertices[pClosest->Vertices[closestCorner]];
+
+	result.Distance = flClosest;
+	result.Position = vecOrigin + vecDirection * flClosest;
+	result.BodyPart = pClosest->BodyPart;
+	result.Mesh = pClosest->Mesh;
+	result.Vertex = vertex.Index;
+	result.Bone = vertex.Bone;
+
+	for (int corner = 0; corner < 3; ++corner)
+	{
+		result.UV += weights[corner] * glm::vec2{pClosest->S[corner], pClosest->T[corner]};
+	}
+
+	const auto pStudioHdr = m_pModel->GetStudioHeader();
+	const auto pTextureHdr = m_pModel->GetTextureHeader();
+
+	const auto pSubModel = m_pModel->GetModelByBodyPart(m_iBodygroup, pClosest->BodyPart);
+	const auto pMeshes = reinterpret_cast<const mstudiomesh_t*>(reinterpret_cast<const byte*>(pStudioHdr) + pSubModel->meshindex);
+
+	auto pSkinRef = pTextureHdr->GetSkins();
+
+	if (iSkin != 0 && iSkin < pTextureHdr->numskinfamilies)
+	{
+		pSkinRef += iSkin * pTextureHdr->numskinref;
+	}
+
+	result.Texture = pSkinRef[pMeshes[pClosest->Mesh].skinref];
+
+	return true;
+}
+}
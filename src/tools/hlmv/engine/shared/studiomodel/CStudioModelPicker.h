@@ -0,0 +1,177 @@
+#ifndef GAME_STUDIOMODEL_CSTUDIOMODELPICKER_H
+#define GAME_STUDIOMODEL_CSTUDIOMODELPICKER_H
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/mat3x4.hpp>
+
+namespace studiomdl
+{
+class CStudioModel;
+
+/**
+*	@brief Result of a pick query. All indices are -1 if nothing was hit
+*/
+struct PickResult
+{
+	/**
+	*	Distance along the ray, in units of the ray direction.
+	*/
+	float Distance = 0;
+
+	/**
+	*	Position that was hit, relative to the model's origin.
+	*/
+	glm::vec3 Position{0};
+
+	int BodyPart = -1;
+
+	/**
+	*	Index of the mesh in the body part's current submodel.
+	*/
+	int Mesh = -1;
+
+	/**
+	*	Index of the texture in the texture header, after applying the skin family.
+	*/
+	int Texture = -1;
+
+	/**
+	*	Index of the vertex closest to the hit position, in the body part's current submodel.
+	*/
+	int Vertex = -1;
+
+	/**
+	*	Bone that the closest vertex is attached to.
+	*/
+	int Bone = -1;
+
+	/**
+	*	Texture coordinates, in pixels.
+	*/
+	glm::vec2 UV{0};
+
+	bool IsValid() const { return Mesh != -1; }
+};
+
+/**
+*	@brief Finds the triangle under a ray on the posed mesh of a studio model
+*	Keeps a bounding volume hierarchy over the skinned triangles of the current body. The hierarchy is rebuilt when the model or body changes
+*	and only refit (bounds recomputed, topology kept) when the pose changes, which is enough to keep hover queries interactive on large models.
+*/
+class CStudioModelPicker final
+{
+public:
+	CStudioModelPicker() = default;
+	~CStudioModelPicker() = default;
+
+	/**
+	*	@brief Releases all data. The next update rebuilds the hierarchy
+	*/
+	void Clear();
+
+	/**
+	*	@brief Updates the hierarchy to match the given model, body and pose
+	*	@param pModel Model to pick on
+	*	@param iBodygroup Body value used to select each body part's submodel
+	*	@param pBoneTransforms Bone transforms of the pose, relative to the model's origin. Must contain the model's number of bones
+	*/
+	void Update(const CStudioModel* pModel, int iBodygroup, const glm::mat3x4* pBoneTransforms);
+
+	/**
+	*	@brief Finds the closest triangle hit by the given ray
+	*	@param vecOrigin Ray origin, relative to the model's origin
+	*	@param vecDirection Ray direction, relative to the model's origin. Does not need to be normalized
+	*	@param iSkin Skin family used to look up the texture
+	*	@param result Receives the hit information
+	*	@return Whether a triangle was hit
+	*/
+	bool Pick(const glm::vec3& vecOrigin, const glm::vec3& vecDirection, int iSkin, PickResult& result) const;
+
+	std::size_t GetTriangleCount() const { return m_Triangles.size(); }
+
+	/**
+	*	Number of times the hierarchy was rebuilt from scratch.
+	*/
+	unsigned int GetBuildCount() const { return m_uiBuildCount; }
+
+	/**
+	*	Number of times the hierarchy was refit to a new pose.
+	*/
+	unsigned int GetRefitCount() const { return m_uiRefitCount; }
+
+private:
+	struct Triangle
+	{
+		//Indices into m_Vertices
+		std::uint32_t Vertices[3];
+
+		std::int16_t S[3];
+		std::int16_t T[3];
+
+		std::uint16_t BodyPart;
+		std::uint16_t Mesh;
+	};
+
+	struct Vertex
+	{
+		std::uint16_t BodyPart;
+		std::uint16_t Index;
+		std::uint16_t Bone;
+	};
+
+	struct Node
+	{
+		glm::vec3 Mins;
+		glm::vec3 Maxs;
+
+		/**
+		*	Leaves: index of the first triangle. Inner nodes: index of the right child; the left child follows this node.
+		*/
+		std::uint32_t Index;
+
+		/**
+		*	Number of triangles in a leaf, 0 for inner nodes.
+		*/
+		std::uint32_t Count;
+	};
+
+	void Build();
+
+	void PoseVertices(const glm::mat3x4* pBoneTransforms);
+
+	void Refit();
+
+	void ComputeTriangleBounds(std::uint32_t first, std::uint32_t count, glm::vec3& mins, glm::vec3& maxs) const;
+
+	/**
+	*	Builds the node for the triangles order[first, first + count), reordering that range so each leaf's triangles are contiguous.
+	*/
+	std::uint32_t BuildNode(std::uint32_t first, std::uint32_t count, const std::vector<glm::vec3>& centroids, std::vector<std::uint32_t>& order);
+
+private:
+	const CStudioModel* m_pModel = nullptr;
+	int m_iBodygroup = -1;
+
+	std::vector<glm::mat3x4> m_BoneTransforms;
+
+	std::vector<Vertex> m_Vertices;
+	std::vector<glm::vec3> m_PosedVertices;
+
+	std::vector<Triangle> m_Triangles;
+
+	std::vector<Node> m_Nodes;
+
+	unsigned int m_uiBuildCount = 0;
+	unsigned int m_uiRefitCount = 0;
+
+private:
+	CStudioModelPicker(const CStudioModelPicker&) = delete;
+	CStudioModelPicker& operator=(const CStudioModelPicker&) = delete;
+};
+}
+
+#endif //GAME_STUDIOMODEL_CSTUDIOMODELPICKER_H
@@ -0,0 +1,167 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#include "utility/mathlib.h"
+
+#include "shared/renderer/studiomodel/CModelRenderInfo.h"
+
+#include "CStudioModel.h"
+#include "CStudioModelPose.h"
+
+namespace studiomdl
+{
+HitboxOBB CalcHitboxOBB( const mstudiobbox_t& hitbox, const glm::mat3x4& boneTransform )
+{
+	HitboxOBB box;
+
+	VectorTransform( ( hitbox.bbmin + hitbox.bbmax ) * 0.5f, boneTransform, box.Center );
+
+	for( int axis = 0; axis < 3; ++axis )
+	{
+		box.Axes[ axis ] = glm::vec3{ boneTransform[ 0 ][ axis ], boneTransform[ 1 ][ axis ], boneTransform[ 2 ][ axis ] };
+		box.Extents[ axis ] = std::abs( hitbox.bbmax[ axis ] - hitbox.bbmin[ axis ] ) * 0.5f;
+	}
+
+	return box;
+}
+
+void CStudioModelPose::SetPose( const CModelRenderInfo& renderInfo )
+{
+	if( m_pModel == renderInfo.pModel
+		&& m_iSequence == renderInfo.iSequence
+		&& m_flFrame == renderInfo.flFrame
+		&& !memcmp( m_Blenders, renderInfo.iBlender, sizeof( m_Blenders ) )
+		&& !memcmp( m_Controllers, renderInfo.iController, sizeof( m_Controllers ) )
+		&& m_Mouth == renderInfo.iMouth )
+	{
+		return;
+	}
+
+	m_pModel = renderInfo.pModel;
+	m_iSequence = renderInfo.iSequence;
+	m_flFrame = renderInfo.flFrame;
+	memcpy( m_Blenders, renderInfo.iBlender, sizeof( m_Blenders ) );
+	memcpy( m_Controllers, renderInfo.iController, sizeof( m_Controllers ) );
+	m_Mouth = renderInfo.iMouth;
+
+	Invalidate();
+}
+
+void CStudioModelPose::Invalidate()
+{
+	m_Evaluated.reset();
+
+	m_Sequence = {};
+
+	if( !m_pModel )
+	{
+		return;
+	}
+
+	auto pStudioHdr = m_pModel->GetStudioHeader();
+
+	//Same as the renderer
+	const int iSequence = m_iSequence < pStudioHdr->numseq ? m_iSequence : 0;
+
+	auto pSequence = pStudioHdr->GetSequence( iSequence );
+
+	m_Sequence = GetBlendedSequence( pStudioHdr, pSequence, m_pModel->GetAnim( pSequence ), m_flFrame, m_Blenders, m_Controllers, m_Mouth );
+}
+
+const glm::mat3x4& CStudioModelPose::GetBoneTransform( const int iBone )
+{
+	assert( m_pModel );
+	assert( iBone >= 0 && iBone < m_pModel->GetStudioHeader()->numbones );
+
+	if( m_Evaluated[ iBone ] )
+	{
+		return m_BoneTransforms[ iBone ];
+	}
+
+	const auto pBones = m_pModel->GetStudioHeader()->GetBones();
+
+	//Walk up to the first evaluated ancestor, then evaluate back down
+	int chain[ MAXSTUDIOBONES ];
+	int chainLength = 0;
+
+	for( int bone = iBone; bone != -1 && !m_Evaluated[ bone ]; bone = pBones[ bone ].parent )
+	{
+		chain[ chainLength++ ] = bone;
+	}
+
+	while( chainLength > 0 )
+	{
+		const int bone = chain[ --chainLength ];
+
+		glm::vec3 pos;
+		glm::vec4 q;
+
+		CalcBlendedBone( m_Sequence, bone, pos, q );
+
+		glm::mat3x4 matrix;
+
+		QuaternionMatrix( q, matrix );
+
+		matrix[ 0 ][ 3 ] = pos[ 0 ];
+		matrix[ 1 ][ 3 ] = pos[ 1 ];
+		matrix[ 2 ][ 3 ] = pos[ 2 ];
+
+		if( pBones[ bone ].parent == -1 )
+		{
+			m_BoneTransforms[ bone ] = matrix;
+		}
+		else
+		{
+			R_ConcatTransforms( m_BoneTransforms[ pBones[ bone ].parent ], matrix, m_BoneTransforms[ bone ] );
+		}
+
+		m_Evaluated[ bone ] = true;
+	}
+
+	return m_BoneTransforms[ iBone ];
+}
+
+const glm::mat3x4* CStudioModelPose::GetBoneTransforms()
+{
+	assert( m_pModel );
+
+	const int numBones = m_pModel->GetStudioHeader()->numbones;
+
+	for( int bone = 0; bone < numBones; ++bone )
+	{
+		GetBoneTransform( bone );
+	}
+
+	return m_BoneTransforms;
+}
+
+AttachmentPose CStudioModelPose::GetAttachment( const int iAttachment )
+{
+	assert( m_pModel );
+
+	const auto pAttachment = m_pModel->GetStudioHeader()->GetAttachment( iAttachment );
+
+	const auto& transform = GetBoneTransform( pAttachment->bone );
+
+	AttachmentPose pose;
+
+	VectorTransform( pAttachment->org, transform, pose.Origin );
+
+	for( int i = 0; i < STUDIO_ATTACH_NUM_VECTORS; ++i )
+	{
+		VectorTransform( pAttachment->vectors[ i ], transform, pose.Vectors[ i ] );
+	}
+
+	return pose;
+}
+
+HitboxOBB CStudioModelPose::GetHitbox( const int iHitbox )
+{
+	assert( m_pModel );
+
+	const auto pHitbox = m_pModel->GetStudioHeader()->GetHitBox( iHitbox );
+
+	return CalcHitboxOBB( *pHitbox, GetBoneTransform( pHitbox->bone ) );
+}
+}
@@ -0,0 +1,115 @@
+#ifndef GAME_STUDIOMODEL_CSTUDIOMODELPOSE_H
+#define GAME_STUDIOMODEL_CSTUDIOMODELPOSE_H
+
+#include <bitset>
+
+#include <glm/vec3.hpp>
+#include <glm/mat3x4.hpp>
+
+#include "studio.h"
+#include "StudioAnimation.h"
+
+namespace studiomdl
+{
+class CStudioModel;
+struct CModelRenderInfo;
+
+/**
+*	@brief Attachment position and vectors relative to the model's origin
+*/
+struct AttachmentPose
+{
+	glm::vec3 Origin{0};
+
+	/**
+	*	The attachment's vectors, transformed as points like the renderer draws them.
+	*/
+	glm::vec3 Vectors[ STUDIO_ATTACH_NUM_VECTORS ];
+};
+
+/**
+*	@brief Hitbox as an oriented box relative to the model's origin
+*/
+struct HitboxOBB
+{
+	glm::vec3 Center{0};
+
+	/**
+	*	Axes of the box, which are those of the hitbox's bone.
+	*/
+	glm::vec3 Axes[ 3 ];
+
+	/**
+	*	Half the size of the box along each axis.
+	*/
+	glm::vec3 Extents{0};
+};
+
+/**
+*	@brief Computes the oriented box of a hitbox posed by its bone's transform
+*/
+HitboxOBB CalcHitboxOBB( const mstudiobbox_t& hitbox, const glm::mat3x4& boneTransform );
+
+/**
+*	@brief Poses a studio model on demand, without a renderer or render context
+*	Only the requested bones and their ancestors are evaluated. Evaluated bones are kept until the pose changes,
+*	so querying several attachments or hitboxes on the same chain decodes each bone once.
+*	Transforms are relative to the model's origin, like the renderer's bone transforms.
+*/
+class CStudioModelPose final
+{
+public:
+	CStudioModelPose() = default;
+	~CStudioModelPose() = default;
+
+	/**
+	*	@brief Sets the pose to evaluate. Only the model, sequence, frame, blenders, controllers and mouth are used
+	*	Evaluated bones are kept if none of these changed.
+	*/
+	void SetPose( const CModelRenderInfo& renderInfo );
+
+	/**
+	*	@brief Discards all evaluated bones. Must be called if the model's data is changed
+	*/
+	void Invalidate();
+
+	/**
+	*	@brief Gets the transform of a bone, evaluating it and its ancestors if needed
+	*/
+	const glm::mat3x4& GetBoneTransform( const int iBone );
+
+	/**
+	*	@brief Gets the transforms of all of the model's bones, evaluating the ones that weren't evaluated yet
+	*/
+	const glm::mat3x4* GetBoneTransforms();
+
+	AttachmentPose GetAttachment( const int iAttachment );
+
+	HitboxOBB GetHitbox( const int iHitbox );
+
+	/**
+	*	@brief Gets the number of bones evaluated since the pose last changed
+	*/
+	size_t GetEvaluatedBonesCount() const { return m_Evaluated.count(); }
+
+private:
+	CStudioModel* m_pModel = nullptr;
+
+	int m_iSequence = 0;
+	float m_flFrame = 0;
+	byte m_Blenders[ STUDIO_MAX_BLENDERS ] = {};
+	byte m_Controllers[ STUDIO_MAX_CONTROLLERS ] = {};
+	byte m_Mouth = 0;
+
+	/**
+	*	Evaluated with the renderer's code, so both produce the same bones.
+	*/
+	BlendedSequence m_Sequence;
+
+	std::bitset<MAXSTUDIOBONES> m_Evaluated;
+
+	glm::mat3x4 m_BoneTransforms[ MAXSTUDIOBONES ];
+};
+}
+
+#endif //GAME_STUDIOMODEL_CSTUDIOMODELPOSE_H
@@ -0,0 +1,368 @@
+#include <algorithm>
+
+#include <glm/geometric.hpp>
+
+#include "utility/mathlib.h"
+
+#include "StudioAnimation.h"
+
+//Double to float conversion
+#pragma warning( disable: 4244 )
+
+namespace studiomdl
+{
+void CalcBoneAdj( const studiohdr_t* const pStudioHdr, const byte* const pControllers, const byte mouth, float* const pAdj )
+{
+	const auto* const pbonecontroller = pStudioHdr->GetBoneControllers();
+
+	for( int j = 0; j < pStudioHdr->numbonecontrollers; j++ )
+	{
+		const auto i = pbonecontroller[ j ].index;
+
+		float value;
+
+		if( i <= 3 )
+		{
+			// check for 360% wrapping
+			if( pbonecontroller[ j ].type & STUDIO_RLOOP )
+			{
+				value = pControllers[ i ] * ( 360.0 / 256.0 ) + pbonecontroller[ j ].start;
+			}
+			else
+			{
+				value = pControllers[ i ] / 255.0;
+				if( value < 0 ) value = 0;
+				if( value > 1.0 ) value = 1.0;
+				value = ( 1.0 - value ) * pbonecontroller[ j ].start + value * pbonecontroller[ j ].end;
+			}
+			// Con_DPrintf( "%d %d %f : %f\n", m_controller[j], m_prevcontroller[j], value, dadt );
+		}
+		else
+		{
+			value = mouth / 64.0;
+			if( value > 1.0 ) value = 1.0;
+			value = ( 1.0 - value ) * pbonecontroller[ j ].start + value * pbonecontroller[ j ].end;
+			// Con_DPrintf("%d %f\n", mouthopen, value );
+		}
+		switch( pbonecontroller[ j ].type & STUDIO_TYPES )
+		{
+		case STUDIO_XR:
+		case STUDIO_YR:
+		case STUDIO_ZR:
+			pAdj[ j ] = value * ( Q_PI / 180.0 );
+			break;
+		case STUDIO_X:
+		case STUDIO_Y:
+		case STUDIO_Z:
+			pAdj[ j ] = value;
+			break;
+		}
+	}
+}
+
+void CalcBoneQuaternion( const int frame, const float s, const mstudiobone_t* const pbone, const mstudioanim_t* const panim, const float* const pAdj, glm::vec4& q )
+{
+	glm::vec3			angle1, angle2;
+
+	for( int j = 0; j < 3; j++ )
+	{
+		if( panim->offset[ j + 3 ] == 0 )
+		{
+			angle2[ j ] = angle1[ j ] = pbone->value[ j + 3 ]; // default;
+		}
+		else
+		{
+			auto panimvalue = ( const mstudioanimvalue_t* ) ( ( const byte* ) panim + panim->offset[ j + 3 ] );
+			auto k = frame;
+			while( panimvalue->num.total <= k )
+			{
+				k -= panimvalue->num.total;
+				panimvalue += panimvalue->num.valid + 1;
+			}
+			// Bah, missing blend!
+			if( panimvalue->num.valid > k )
+			{
+				angle1[ j ] = panimvalue[ k + 1 ].value;
+
+				if( panimvalue->num.valid > k + 1 )
+				{
+					angle2[ j ] = panimvalue[ k + 2 ].value;
+				}
+				else
+				{
+					if( panimvalue->num.total > k + 1 )
+						angle2[ j ] = angle1[ j ];
+					else
+						angle2[ j ] = panimvalue[ panimvalue->num.valid + 2 ].value;
+				}
+			}
+			else
+			{
+				angle1[ j ] = panimvalue[ panimvalue->num.valid ].value;
+				if( panimvalue->num.total > k + 1 )
+				{
+					angle2[ j ] = angle1[ j ];
+				}
+				else
+				{
+					angle2[ j ] = panimvalue[ panimvalue->num.valid + 2 ].value;
+				}
+			}
+			angle1[ j ] = pbone->value[ j + 3 ] + angle1[ j ] * pbone->scale[ j + 3 ];
+			angle2[ j ] = pbone->value[ j + 3 ] + angle2[ j ] * pbone->scale[ j + 3 ];
+		}
+
+		if( pbone->bonecontroller[ j + 3 ] != -1 )
+		{
+			angle1[ j ] += pAdj[ pbone->bonecontroller[ j + 3 ] ];
+			angle2[ j ] += pAdj[ pbone->bonecontroller[ j + 3 ] ];
+		}
+	}
+
+	if( !VectorCompare( angle1, angle2 ) )
+	{
+		glm::vec4 q1, q2;
+
+		AngleQuaternion( angle1, q1 );
+		AngleQuaternion( angle2, q2 );
+		QuaternionSlerp( q1, q2, s, q );
+	}
+	else
+	{
+		AngleQuaternion( angle1, q );
+	}
+}
+
+void CalcBonePosition( const int frame, const float s, const mstudiobone_t* const pbone, const mstudioanim_t* const panim, const float* const pAdj, glm::vec3& pos )
+{
+	for( int j = 0; j < 3; j++ )
+	{
+		pos[ j ] = pbone->value[ j ]; // default;
+		if( panim->offset[ j ] != 0 )
+		{
+			auto panimvalue = ( mstudioanimvalue_t * ) ( ( byte * ) panim + panim->offset[ j ] );
+
+			auto k = frame;
+			// find span of values that includes the frame we want
+			while( panimvalue->num.total <= k )
+			{
+				k -= panimvalue->num.total;
+				panimvalue += panimvalue->num.valid + 1;
+			}
+			// if we're inside the span
+			if( panimvalue->num.valid > k )
+			{
+				// and there's more data in the span
+				if( panimvalue->num.valid > k + 1 )
+				{
+					pos[ j ] += ( panimvalue[ k + 1 ].value * ( 1.0 - s ) + s * panimvalue[ k + 2 ].value ) * pbone->scale[ j ];
+				}
+				else
+				{
+					pos[ j ] += panimvalue[ k + 1 ].value * pbone->scale[ j ];
+				}
+			}
+			else
+			{
+				// are we at the end of the repeating values section and there's another section with data?
+				if( panimvalue->num.total <= k + 1 )
+				{
+					pos[ j ] += ( panimvalue[ panimvalue->num.valid ].value * ( 1.0 - s ) + s * panimvalue[ panimvalue->num.valid + 2 ].value ) * pbone->scale[ j ];
+				}
+				else
+				{
+					pos[ j ] += panimvalue[ panimvalue->num.valid ].value * pbone->scale[ j ];
+				}
+			}
+		}
+		if( pbone->bonecontroller[ j ] != -1 )
+		{
+			pos[ j ] += pAdj[ pbone->bonecontroller[ j ] ];
+		}
+	}
+}
+
+BlendGrid GetBlendGrid( const mstudioseqdesc_t* const pseqdesc, const byte* const pBlenders )
+{
+	BlendGrid grid;
+
+	double interpolantX = 0;
+	double interpolantY = 0;
+
+	if( pseqdesc->numblends == 9 )
+	{
+		//3x3 grid, centered on blend 4. Only the quadrant the blenders are in is used
+		const auto blendX = static_cast<double>( pBlenders[ 0 ] );
+		const auto blendY = static_cast<double>( pBlenders[ 1 ] );
+
+		grid.BlendsPerRow = 3;
+
+		if( blendX > 127.0 )
+		{
+			grid.FirstBlend += 1;
+			interpolantX = blendX - 127.0 + blendX - 127.0;
+		}
+		else
+		{
+			interpolantX = blendX + blendX;
+		}
+
+		if( blendY > 127.0 )
+		{
+			grid.FirstBlend += 3;
+			interpolantY = blendY - 127.0 + blendY - 127.0;
+		}
+		else
+		{
+			interpolantY = blendY + blendY;
+		}
+	}
+	else if( pseqdesc->numblends > 1 )
+	{
+		interpolantX = pBlenders[ 0 ];
+
+		if( pseqdesc->numblends == 4 )
+		{
+			grid.BlendsPerRow = 2;
+			interpolantY = pBlenders[ 1 ];
+		}
+	}
+
+	grid.S = std::clamp( static_cast<float>( interpolantX / 255.0 ), 0.0f, 1.0f );
+	grid.T = std::clamp( static_cast<float>( interpolantY / 255.0 ), 0.0f, 1.0f );
+
+	return grid;
+}
+
+void BlendBone( glm::vec4& q1, glm::vec3& pos1, const glm::vec4& q2, const glm::vec3& pos2, const float s )
+{
+	//Rotations closer than this use nlerp. At this cosine (bones about 5 degrees apart)
+	//the rotation differs from slerp by less than 3e-6 radians
+	const float NLERP_MIN_COSINE = 0.999f;
+
+	glm::vec4 q3;
+
+	if( fabs( glm::dot( q1, q2 ) ) >= NLERP_MIN_COSINE )
+	{
+		QuaternionNlerp( q1, q2, s, q3 );
+	}
+	else
+	{
+		//QuaternionSlerp flips its second quaternion if it is backwards
+		glm::vec4 q2Copy = q2;
+		QuaternionSlerp( q1, q2Copy, s, q3 );
+	}
+
+	q1 = q3;
+
+	pos1 = pos1 * ( 1.0f - s ) + pos2 * s;
+}
+
+BlendedSequence GetBlendedSequence( const studiohdr_t* const pStudioHdr, const mstudioseqdesc_t* const pseqdesc, const mstudioanim_t* const panim,
+	const float flFrame, const byte* const pBlenders, const byte* const pControllers, const byte mouth )
+{
+	BlendedSequence sequence;
+
+	sequence.pStudioHdr = pStudioHdr;
+	sequence.pSequence = pseqdesc;
+	sequence.pAnim = panim;
+	sequence.Grid = GetBlendGrid( pseqdesc, pBlenders );
+	sequence.flFrame = flFrame;
+
+	// add in programatic controllers
+	CalcBoneAdj( pStudioHdr, pControllers, mouth, sequence.Adj );
+
+	return sequence;
+}
+
+namespace
+{
+/**
+*	@brief Evaluates a bone in a single blend
+*	@param panim Animations of the blend
+*/
+void CalcBoneInBlend( const BlendedSequence& sequence, const int iBone, const mstudioanim_t* const panim, glm::vec3& pos, glm::vec4& q )
+{
+	const int frame = ( int ) sequence.flFrame;
+	const float s = ( sequence.flFrame - frame );
+
+	const auto pbone = sequence.pStudioHdr->GetBone( iBone );
+
+	CalcBoneQuaternion( frame, s, pbone, panim + iBone, sequence.Adj, q );
+	CalcBonePosition( frame, s, pbone, panim + iBone, sequence.Adj, pos );
+
+	if( iBone == sequence.pSequence->motionbone )
+	{
+		if( sequence.pSequence->motiontype & STUDIO_X )
+			pos[ 0 ] = 0.0;
+		if( sequence.pSequence->motiontype & STUDIO_Y )
+			pos[ 1 ] = 0.0;
+		if( sequence.pSequence->motiontype & STUDIO_Z )
+			pos[ 2 ] = 0.0;
+	}
+}
+
+/**
+*	@brief Evaluates a bone in a pair of adjacent blends and interpolates between them
+*	@param panim Animations of the first blend of the pair
+*/
+void CalcBoneInBlendPair( const BlendedSequence& sequence, const int iBone, const mstudioanim_t* const panim, glm::vec3& pos, glm::vec4& q )
+{
+	const int numBones = sequence.pStudioHdr->numbones;
+
+	const float s = sequence.Grid.S;
+
+	if( s >= 1 )
+	{
+		CalcBoneInBlend( sequence, iBone, panim + numBones, pos, q );
+		return;
+	}
+
+	CalcBoneInBlend( sequence, iBone, panim, pos, q );
+
+	if( s > 0 )
+	{
+		glm::vec3 pos2;
+		glm::vec4 q2;
+
+		CalcBoneInBlend( sequence, iBone, panim + numBones, pos2, q2 );
+		BlendBone( q, pos, q2, pos2, s );
+	}
+}
+}
+
+void CalcBlendedBone( const BlendedSequence& sequence, const int iBone, glm::vec3& pos, glm::vec4& q )
+{
+	const int numBones = sequence.pStudioHdr->numbones;
+
+	const auto panimRow1 = sequence.pAnim + sequence.Grid.FirstBlend * numBones;
+	const auto panimRow2 = panimRow1 + sequence.Grid.BlendsPerRow * numBones;
+
+	const float t = sequence.Grid.T;
+
+	if( t >= 1 )
+	{
+		CalcBoneInBlendPair( sequence, iBone, panimRow2, pos, q );
+		return;
+	}
+
+	CalcBoneInBlendPair( sequence, iBone, panimRow1, pos, q );
+
+	if( t > 0 )
+	{
+		glm::vec3 pos2;
+		glm::vec4 q2;
+
+		CalcBoneInBlendPair( sequence, iBone, panimRow2, pos2, q2 );
+		BlendBone( q, pos, q2, pos2, t );
+	}
+}
+
+void CalcBlendedBones( const BlendedSequence& sequence, glm::vec3* const pos, glm::vec4* const q )
+{
+	for( int i = 0; i < sequence.pStudioHdr->numbones; ++i )
+	{
+		CalcBlendedBone( sequence, i, pos[ i ], q[ i ] );
+	}
+}
+}
@@ -0,0 +1,127 @@
+#ifndef GAME_STUDIOMODEL_STUDIOANIMATION_H
+#define GAME_STUDIOMODEL_STUDIOANIMATION_H
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "studio.h"
+
+/**
+*	@file
+*
+*	Animation decoding shared by the renderer and by code that poses models without one. None of this needs a render context.
+*/
+
+namespace studiomdl
+{
+/**
+*	@brief Computes the adjustments made by bone controllers
+*	@param pStudioHdr Model header
+*	@param pControllers Controller values, one per controller index
+*	@param mouth Mouth value
+*	@param pAdj Receives one adjustment per bone controller. Must have room for MAXSTUDIOCONTROLLERS values
+*/
+void CalcBoneAdj( const studiohdr_t* const pStudioHdr, const byte* const pControllers, const byte mouth, float* const pAdj );
+
+/**
+*	@brief Decodes the rotation of a bone at a frame
+*	@param frame Frame to decode
+*	@param s Fraction towards the next frame
+*	@param pAdj Bone controller adjustments, as computed by CalcBoneAdj
+*/
+void CalcBoneQuaternion( const int frame, const float s, const mstudiobone_t* const pbone, const mstudioanim_t* const panim, const float* const pAdj, glm::vec4& q );
+
+/**
+*	@brief Decodes the position of a bone at a frame
+*	@see CalcBoneQuaternion
+*/
+void CalcBonePosition( const int frame, const float s, const mstudiobone_t* const pbone, const mstudioanim_t* const panim, const float* const pAdj, glm::vec3& pos );
+
+/**
+*	@brief Blends of a sequence that contribute to the pose, and how much
+*	Blends form a grid: pairs of blends are interpolated along x, then the 2 pairs along y.
+*/
+struct BlendGrid
+{
+	/**
+	*	Blend in the first corner of the grid.
+	*/
+	int FirstBlend = 0;
+
+	/**
+	*	Offset between the first blend of each row.
+	*/
+	int BlendsPerRow = 1;
+
+	/**
+	*	Weight of the second blend of each pair, in [0, 1].
+	*/
+	float S = 0;
+
+	/**
+	*	Weight of the second pair, in [0, 1].
+	*/
+	float T = 0;
+};
+
+/**
+*	@brief Works out the blends and weights of a sequence for the given blender values
+*/
+BlendGrid GetBlendGrid( const mstudioseqdesc_t* const pseqdesc, const byte* const pBlenders );
+
+/**
+*	@brief Interpolates a bone towards another pose by s, in (0, 1)
+*	Close rotations use nlerp instead of slerp.
+*/
+void BlendBone( glm::vec4& q1, glm::vec3& pos1, const glm::vec4& q2, const glm::vec3& pos2, const float s );
+
+/**
+*	@brief Everything needed to evaluate the bones of a sequence at a frame
+*/
+struct BlendedSequence
+{
+	const studiohdr_t* pStudioHdr = nullptr;
+	const mstudioseqdesc_t* pSequence = nullptr;
+
+	/**
+	*	Animations of the sequence's first blend.
+	*/
+	const mstudioanim_t* pAnim = nullptr;
+
+	BlendGrid Grid;
+
+	float flFrame = 0;
+
+	/**
+	*	Bone controller adjustments, as computed by CalcBoneAdj.
+	*/
+	float Adj[ MAXSTUDIOCONTROLLERS ] = {};
+};
+
+/**
+*	@brief Works out the blends and controller adjustments of a sequence
+*	@param pStudioHdr Model header
+*	@param pseqdesc Sequence to evaluate
+*	@param panim Animations of the sequence's first blend
+*	@param flFrame Frame to evaluate
+*	@param pBlenders Blender values, one per blender
+*	@param pControllers Controller values, one per controller index
+*	@param mouth Mouth value
+*/
+BlendedSequence GetBlendedSequence( const studiohdr_t* const pStudioHdr, const mstudioseqdesc_t* const pseqdesc, const mstudioanim_t* const panim,
+	const float flFrame, const byte* const pBlenders, const byte* const pControllers, const byte mouth );
+
+/**
+*	@brief Evaluates the position and rotation of a bone relative to its parent
+*	Blends without weight are not evaluated. The sequence's motion is removed from its motion bone.
+*/
+void CalcBlendedBone( const BlendedSequence& sequence, const int iBone, glm::vec3& pos, glm::vec4& q );
+
+/**
+*	@brief Evaluates all bones of the model, as CalcBlendedBone does
+*	@param pos, q Receive one value per bone
+*/
+void CalcBlendedBones( const BlendedSequence& sequence, glm::vec3* const pos, glm::vec4* const q );
+}
+
+#endif //GAME_STUDIOMODEL_STUDIOANIMATION_H
@@ -0,0 +1,535 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <utility>
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "CStudioModel.h"
+#include "StudioAnimation.h"
+#include "StudioAnimationOptimizer.h"
+
+namespace studiomdl
+{
+namespace
+{
+const int NUM_CHANNELS = 6;
+
+/**
+*	Runs store their frame count in a byte.
+*/
+const int MAX_RUN_LENGTH = std::numeric_limits<byte>::max();
+
+/**
+*	Decoding is timed this many times and the fastest time is used, to reduce noise.
+*/
+const int NUM_DECODE_TIMINGS = 5;
+
+/**
+*	@brief The animation data of a sequence, as located in the file that contains it
+*/
+struct AnimationBlock
+{
+	byte* pBuffer = nullptr;
+	std::size_t BufferSize = 0;
+
+	/**
+	*	Offset of the channel offsets of the first blend in the buffer.
+	*/
+	std::size_t Start = 0;
+
+	/**
+	*	One past the last byte used by any channel.
+	*/
+	std::size_t End = 0;
+
+	std::vector<int> Sequences;
+
+	bool bCanOptimize = true;
+
+	/**
+	*	Decoded values per blend, bone and channel. Empty if the channel has no values.
+	*/
+	std::vector<std::vector<short>> Channels;
+};
+
+/**
+*	@brief Decodes a channel into one value per frame
+*	@param offset Offset of the first run in the buffer
+*	@param outEnd Receives the offset one past the last run
+*	@return Whether the channel could be decoded without leaving the buffer
+*/
+bool DecodeChannel( const byte* const pBuffer, const std::size_t bufferSize, const std::size_t offset, const int numFrames,
+	std::vector<short>& values, std::size_t& outEnd )
+{
+	values.clear();
+	values.reserve( numFrames );
+
+	std::size_t position = offset;
+
+	while( values.size() < static_cast<std::size_t>( numFrames ) )
+	{
+		if( position + sizeof( mstudioanimvalue_t ) > bufferSize )
+		{
+			return false;
+		}
+
+		const auto pRun = reinterpret_cast<const mstudioanimvalue_t*>( pBuffer + position );
+
+		const int numValid = pRun->num.valid;
+		const int total = pRun->num.total;
+
+		//The decoder would either never get past this run or read its header as a value
+		if( numValid == 0 || total == 0 )
+		{
+			return false;
+		}
+
+		position += ( 1 + numValid ) * sizeof( mstudioanimvalue_t );
+
+		if( position > bufferSize )
+		{
+			return false;
+		}
+
+		//Frames past the stored values repeat the last one
+		for( int frame = 0; frame < total && values.size() < static_cast<std::size_t>( numFrames ); ++frame )
+		{
+			values.push_back( pRun[ 1 + std::min( frame, numValid - 1 ) ].value );
+		}
+	}
+
+	outEnd = position;
+
+	return true;
+}
+
+/**
+*	@brief Makes values that are within the tolerance of the value before them equal to it
+*	The first value is compared to 0, the bone's default, so channels that never leave the tolerance become 0.
+*/
+void QuantizeChannel( std::vector<short>& values, const int tolerance )
+{
+	if( tolerance <= 0 )
+	{
+		return;
+	}
+
+	short held = 0;
+
+	for( auto& value : values )
+	{
+		if( std::abs( value - held ) <= tolerance )
+		{
+			value = held;
+		}
+		else
+		{
+			held = value;
+		}
+	}
+}
+
+/**
+*	@brief Encodes values with the fewest runs and values possible
+*	A run can end with any number of repeats of its last stored value, so the best split is found by trying every run length
+*	from each frame, back to front. Of encodings that are equally small, the one with the fewest runs is used since that is faster to decode.
+*/
+void EncodeChannel( const std::vector<short>& values, std::vector<mstudioanimvalue_t>& encoded )
+{
+	const int numFrames = static_cast<int>( values.size() );
+
+	//Number of equal values ending at each frame
+	std::vector<int> repeats( numFrames );
+
+	for( int frame = 0; frame < numFrames; ++frame )
+	{
+		repeats[ frame ] = frame > 0 && values[ frame ] == values[ frame - 1 ] ? repeats[ frame - 1 ] + 1 : 1;
+	}
+
+	auto getNumValid = [ & ]( const int first, const int length )
+	{
+		return length - std::min( length, repeats[ first + length - 1 ] ) + 1;
+	};
+
+	//Cost of encoding all frames from each frame on: values stored, then runs
+	std::vector<std::pair<int, int>> costs( numFrames + 1, { 0, 0 } );
+	std::vector<int> runLengths( numFrames );
+
+	for( int first = numFrames - 1; first >= 0; --first )
+	{
+		costs[ first ] = { std::numeric_limits<int>::max(), 0 };
+
+		const int maxLength = std::min( MAX_RUN_LENGTH, numFrames - first );
+
+		for( int length = 1; length <= maxLength; ++length )
+		{
+			const auto& rest = costs[ first + length ];
+
+			const std::pair<int, int> cost{ 1 + getNumValid( first, length ) + rest.first, 1 + rest.second };
+
+			if( cost < costs[ first ] )
+			{
+				costs[ first ] = cost;
+				runLengths[ first ] = length;
+			}
+		}
+	}
+
+	for( int first = 0; first < numFrames; )
+	{
+		const int length = runLengths[ first ];
+		const int numValid = getNumValid( first, length );
+
+		mstudioanimvalue_t run;
+
+		run.num.valid = static_cast<byte>( numValid );
+		run.num.total = static_cast<byte>( length );
+
+		encoded.push_back( run );
+
+		for( int frame = 0; frame < numValid; ++frame )
+		{
+			mstudioanimvalue_t value;
+
+			value.value = values[ first + frame ];
+
+			encoded.push_back( value );
+		}
+
+		first += length;
+	}
+}
+
+/**
+*	@brief Times decoding every bone of every frame of every blend the way the renderer does
+*	@return Fastest time in seconds
+*/
+double TimeDecoding( const studiohdr_t* const pStudioHdr, const mstudioseqdesc_t* const pseqdesc, const mstudioanim_t* const pAnims )
+{
+	const float adj[ MAXSTUDIOCONTROLLERS ] = {};
+
+	const auto pBones = pStudioHdr->GetBones();
+
+	double bestTime = std::numeric_limits<double>::max();
+
+	//Keeps the decoding from being optimized away
+	float checksum = 0;
+
+	for( int timing = 0; timing < NUM_DECODE_TIMINGS; ++timing )
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		for( int blend = 0; blend < pseqdesc->numblends; ++blend )
+		{
+			const auto pBlendAnims = pAnims + blend * pStudioHdr->numbones;
+
+			for( int frame = 0; frame < pseqdesc->numframes; ++frame )
+			{
+				for( int bone = 0; bone < pStudioHdr->numbones; ++bone )
+				{
+					glm::vec4 q;
+					glm::vec3 pos;
+
+					CalcBoneQuaternion( frame, 0, &pBones[ bone ], &pBlendAnims[ bone ], adj, q );
+					CalcBonePosition( frame, 0, &pBones[ bone ], &pBlendAnims[ bone ], adj, pos );
+
+					checksum += q.x + pos.x;
+				}
+			}
+		}
+
+		const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+
+		bestTime = std::min( bestTime, time.count() );
+	}
+
+	volatile float sink = checksum;
+	( void ) sink;
+
+	return bestTime;
+}
+
+/**
+*	@brief Decodes all channels of a block and works out how much of the buffer it uses
+*/
+void DecodeBlock( const studiohdr_t* const pStudioHdr, const mstudioseqdesc_t* const pseqdesc, AnimationBlock& block,
+	SequenceAnimationOptimization& result )
+{
+	block.End = block.Start;
+
+	if( pseqdesc->numframes <= 0 || pseqdesc->numblends <= 0 || block.Start > block.BufferSize )
+	{
+		block.bCanOptimize = false;
+		return;
+	}
+
+	const std::size_t numAnims = static_cast<std::size_t>( pseqdesc->numblends ) * pStudioHdr->numbones;
+
+	if( numAnims * sizeof( mstudioanim_t ) > block.BufferSize - block.Start )
+	{
+		block.bCanOptimize = false;
+		return;
+	}
+
+	block.End = block.Start + numAnims * sizeof( mstudioanim_t );
+
+	const auto pAnims = reinterpret_cast<const mstudioanim_t*>( block.pBuffer + block.Start );
+
+	block.Channels.resize( numAnims * NUM_CHANNELS );
+
+	for( std::size_t anim = 0; anim < numAnims; ++anim )
+	{
+		for( int channel = 0; channel < NUM_CHANNELS; ++channel )
+		{
+			const auto offset = pAnims[ anim ].offset[ channel ];
+
+			if( offset == 0 )
+			{
+				continue;
+			}
+
+			++result.OriginalChannels;
+
+			std::size_t end;
+
+			if( !DecodeChannel( block.pBuffer, block.BufferSize, block.Start + anim * sizeof( mstudioanim_t ) + offset,
+				pseqdesc->numframes, block.Channels[ anim * NUM_CHANNELS + channel ], end ) )
+			{
+				block.bCanOptimize = false;
+				return;
+			}
+
+			block.End = std::max( block.End, end );
+		}
+	}
+
+	result.OriginalSize = block.End - block.Start;
+}
+
+/**
+*	@brief Encodes a block the way studiomdl lays it out: the channel offsets of all blends, followed by the values of all channels
+*	@return Whether every offset fits in its 16 bits
+*/
+bool EncodeBlock( const std::size_t numAnims, const AnimationBlock& block, const int tolerance, std::vector<byte>& data,
+	SequenceAnimationOptimization& result )
+{
+	std::vector<mstudioanimvalue_t> encoded;
+	std::vector<short> values;
+
+	std::vector<mstudioanim_t> anims( numAnims );
+
+	data.resize( numAnims * sizeof( mstudioanim_t ) );
+
+	for( std::size_t anim = 0; anim < numAnims; ++anim )
+	{
+		for( int channel = 0; channel < NUM_CHANNELS; ++channel )
+		{
+			values = block.Channels[ anim * NUM_CHANNELS + channel ];
+
+			QuantizeChannel( values, tolerance );
+
+			//Channels without values use the bone's default, which is what a value of 0 decodes to
+			if( std::all_of( values.begin(), values.end(), []( const short value ) { return value == 0; } ) )
+			{
+				continue;
+			}
+
+			const std::size_t offset = data.size() - anim * sizeof( mstudioanim_t );
+
+			if( offset > std::numeric_limits<unsigned short>::max() )
+			{
+				return false;
+			}
+
+			anims[ anim ].offset[ channel ] = static_cast<unsigned short>( offset );
+
+			++result.OptimizedChannels;
+
+			encoded.clear();
+
+			EncodeChannel( values, encoded );
+
+			const auto pBytes = reinterpret_cast<const byte*>( encoded.data() );
+
+			data.insert( data.end(), pBytes, pBytes + encoded.size() * sizeof( mstudioanimvalue_t ) );
+		}
+	}
+
+	memcpy( data.data(), anims.data(), numAnims * sizeof( mstudioanim_t ) );
+
+	return true;
+}
+}
+
+std::vector<SequenceAnimationOptimization> OptimizeAnimations( CStudioModel& model, const AnimationOptimizationSettings& settings )
+{
+	const auto pStudioHdr = model.GetStudioHeader();
+
+	std::vector<SequenceAnimationOptimization> results( pStudioHdr->numseq );
+
+	//Keyed by buffer and offset, so blocks in the same buffer are sorted by where they start
+	std::map<std::pair<byte*, std::size_t>, AnimationBlock> blocks;
+
+	for( int sequence = 0; sequence < pStudioHdr->numseq; ++sequence )
+	{
+		results[ sequence ].Sequence = sequence;
+
+		const auto pseqdesc = pStudioHdr->GetSequence( sequence );
+
+		if( pseqdesc->seqgroup < 0 || pseqdesc->seqgroup >= pStudioHdr->numseqgroups )
+		{
+			continue;
+		}
+
+		byte* pBuffer;
+		std::size_t bufferSize;
+
+		if( pseqdesc->seqgroup == 0 )
+		{
+			pBuffer = reinterpret_cast<byte*>( pStudioHdr );
+			bufferSize = pStudioHdr->length;
+		}
+		else
+		{
+			const auto pSeqGroupHdr = model.GetSeqGroupHeader( pseqdesc->seqgroup - 1 );
+
+			pBuffer = reinterpret_cast<byte*>( pSeqGroupHdr );
+			bufferSize = pSeqGroupHdr->length;
+		}
+
+		const std::size_t start = reinterpret_cast<byte*>( model.GetAnim( pseqdesc ) ) - pBuffer;
+
+		auto& block = blocks[ { pBuffer, start } ];
+
+		block.pBuffer = pBuffer;
+		block.BufferSize = bufferSize;
+		block.Start = start;
+		block.Sequences.push_back( sequence );
+	}
+
+	for( auto& [ key, block ] : blocks )
+	{
+		if( block.Sequences.size() == 1 )
+		{
+			DecodeBlock( pStudioHdr, pStudioHdr->GetSequence( block.Sequences.front() ), block, results[ block.Sequences.front() ] );
+
+			//The size of data that can't be decoded is unknown, so assume it runs to the end of the buffer
+			if( !block.bCanOptimize )
+			{
+				block.End = std::max( block.End, block.BufferSize );
+			}
+		}
+		else
+		{
+			//Decoding it differently for each sequence would be wrong for the others, but its size is still needed to protect other blocks
+			block.bCanOptimize = false;
+			block.End = block.Start;
+
+			for( const auto sequence : block.Sequences )
+			{
+				AnimationBlock extent;
+
+				extent.pBuffer = block.pBuffer;
+				extent.BufferSize = block.BufferSize;
+				extent.Start = block.Start;
+
+				SequenceAnimationOptimization extentResult;
+
+				DecodeBlock( pStudioHdr, pStudioHdr->GetSequence( sequence ), extent, extentResult );
+
+				block.End = std::max( block.End, extent.bCanOptimize ? extent.End : block.BufferSize );
+			}
+		}
+	}
+
+	//Rewriting a block that overlaps another would corrupt the other, so leave alone every block that starts before an earlier one ends
+	//and every block that ends after a later one starts
+	{
+		const byte* pBuffer = nullptr;
+		std::size_t end = 0;
+
+		for( auto& [ key, block ] : blocks )
+		{
+			if( block.pBuffer != pBuffer )
+			{
+				pBuffer = block.pBuffer;
+				end = 0;
+			}
+
+			if( block.Start < end )
+			{
+				block.bCanOptimize = false;
+			}
+
+			end = std::max( end, block.End );
+		}
+	}
+
+	{
+		const byte* pBuffer = nullptr;
+		std::size_t start = 0;
+
+		for( auto it = blocks.rbegin(); it != blocks.rend(); ++it )
+		{
+			auto& block = it->second;
+
+			if( block.pBuffer != pBuffer )
+			{
+				pBuffer = block.pBuffer;
+				start = std::numeric_limits<std::size_t>::max();
+			}
+
+			if( block.End > start )
+			{
+				block.bCanOptimize = false;
+			}
+
+			start = block.Start;
+		}
+	}
+
+	std::vector<byte> data;
+
+	for( auto& [ key, block ] : blocks )
+	{
+		if( !block.bCanOptimize )
+		{
+			continue;
+		}
+
+		const auto pseqdesc = pStudioHdr->GetSequence( block.Sequences.front() );
+
+		auto& result = results[ block.Sequences.front() ];
+
+		const auto pAnims = reinterpret_cast<const mstudioanim_t*>( block.pBuffer + block.Start );
+
+		result.OriginalDecodeTime = TimeDecoding( pStudioHdr, pseqdesc, pAnims );
+
+		data.clear();
+
+		SequenceAnimationOptimization encodeResult;
+
+		//Optimal runs are never longer than the existing ones, and quantizing only makes values equal, so this only fails on odd layouts
+		if( !EncodeBlock( block.Channels.size() / NUM_CHANNELS, block, settings.Tolerance, data, encodeResult )
+			|| data.size() > block.End - block.Start )
+		{
+			continue;
+		}
+
+		memcpy( block.pBuffer + block.Start, data.data(), data.size() );
+		memset( block.pBuffer + block.Start + data.size(), 0, block.End - block.Start - data.size() );
+
+		result.Optimized = true;
+		result.OptimizedSize = data.size();
+		result.OptimizedChannels = encodeResult.OptimizedChannels;
+		result.OptimizedDecodeTime = TimeDecoding( pStudioHdr, pseqdesc, pAnims );
+	}
+
+	return results;
+}
+}
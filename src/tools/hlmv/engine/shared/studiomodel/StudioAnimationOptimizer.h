@@ -0,0 +1,71 @@
+#ifndef GAME_STUDIOMODEL_STUDIOANIMATIONOPTIMIZER_H
+#define GAME_STUDIOMODEL_STUDIOANIMATIONOPTIMIZER_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+*	@file
+*
+*	Re-encodes the run length encoded animation values of a model as compactly as possible.
+*	Old compilers store channels that never move, repeat values a run could have implied and split runs that could have been merged,
+*	which makes files larger and makes CalcBoneQuaternion and CalcBonePosition walk more runs to find a frame.
+*/
+
+namespace studiomdl
+{
+class CStudioModel;
+
+struct AnimationOptimizationSettings
+{
+	/**
+	*	Values that differ from the value before them by at most this much, in the channel's own units, are made equal to it,
+	*	so they can share a run. 0 keeps the value of every frame exactly as it was. Poses between two frames can still change slightly,
+	*	because the engine doesn't interpolate into the next frame at the end of some runs.
+	*/
+	int Tolerance = 0;
+};
+
+/**
+*	@brief What optimizing the animations of a sequence did
+*/
+struct SequenceAnimationOptimization
+{
+	int Sequence = 0;
+
+	/**
+	*	Whether the animation data was rewritten. Data that is shared with other sequences, overlaps other data
+	*	or can't be decoded is left alone.
+	*/
+	bool Optimized = false;
+
+	/**
+	*	Size of the animation data of all blends, including the per bone channel offsets.
+	*/
+	std::size_t OriginalSize = 0;
+	std::size_t OptimizedSize = 0;
+
+	/**
+	*	Channels that have values stored. The others use the bone's default value.
+	*/
+	int OriginalChannels = 0;
+	int OptimizedChannels = 0;
+
+	/**
+	*	Time taken to decode every bone of every frame of every blend, in seconds.
+	*/
+	double OriginalDecodeTime = 0;
+	double OptimizedDecodeTime = 0;
+};
+
+/**
+*	@brief Optimizes the animations of all sequences in place, in the main and sequence group files
+*	Each sequence's channels are decoded, optionally quantized, channels that are always 0 are dropped and the rest are encoded
+*	with the fewest values possible. The new data never needs more room than the old data, so it is written where the old data was
+*	and the rest of that space is zeroed. The files keep their layout and size.
+*	@return What was done to each sequence, in sequence order
+*/
+std::vector<SequenceAnimationOptimization> OptimizeAnimations( CStudioModel& model, const AnimationOptimizationSettings& settings = {} );
+}
+
+#endif //GAME_STUDIOMODEL_STUDIOANIMATIONOPTIMIZER_H
@@ -0,0 +1,371 @@
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <thread>
+
+#include <glm/common.hpp>
+#include <glm/mat3x4.hpp>
+
+#include "utility/mathlib.h"
+
+#include "CStudioModel.h"
+#include "StudioAnimation.h"
+#include "StudioBounds.h"
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#define STUDIO_BOUNDS_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace studiomdl
+{
+namespace
+{
+const size_t LANES = 4;
+
+/**
+*	@brief Vertices of all submodels grouped by bone, in structure-of-arrays layout
+*	Each group is padded to a multiple of 4 by repeating its last vertex, which does not change the bounds.
+*/
+struct BoneVertices
+{
+	std::vector<float> X, Y, Z;
+
+	/**
+	*	Offset of the first vertex of each bone, plus the total count.
+	*/
+	std::vector<size_t> Offsets;
+};
+
+BoneVertices GroupVerticesByBone( const studiohdr_t* const pStudioHdr )
+{
+	std::vector<std::vector<glm::vec3>> vertices( pStudioHdr->numbones );
+
+	for( int bodypart = 0; bodypart < pStudioHdr->numbodyparts; ++bodypart )
+	{
+		const auto pBodypart = pStudioHdr->GetBodypart( bodypart );
+
+		const auto pModels = reinterpret_cast<const mstudiomodel_t*>( pStudioHdr->GetData() + pBodypart->modelindex );
+
+		for( int model = 0; model < pBodypart->nummodels; ++model )
+		{
+			const auto& submodel = pModels[ model ];
+
+			const auto pVerts = reinterpret_cast<const glm::vec3*>( pStudioHdr->GetData() + submodel.vertindex );
+			const auto pVertBones = pStudioHdr->GetData() + submodel.vertinfoindex;
+
+			for( int vertex = 0; vertex < submodel.numverts; ++vertex )
+			{
+				if( pVertBones[ vertex ] < pStudioHdr->numbones )
+				{
+					vertices[ pVertBones[ vertex ] ].push_back( pVerts[ vertex ] );
+				}
+			}
+		}
+	}
+
+	BoneVertices result;
+
+	result.Offsets.reserve( vertices.size() + 1 );
+
+	for( auto& boneVertices : vertices )
+	{
+		result.Offsets.push_back( result.X.size() );
+
+		if( boneVertices.empty() )
+		{
+			continue;
+		}
+
+		boneVertices.resize( ( boneVertices.size() + LANES - 1 ) / LANES * LANES, boneVertices.back() );
+
+		for( const auto& vertex : boneVertices )
+		{
+			result.X.push_back( vertex.x );
+			result.Y.push_back( vertex.y );
+			result.Z.push_back( vertex.z );
+		}
+	}
+
+	result.Offsets.push_back( result.X.size() );
+
+	return result;
+}
+
+/**
+*	@brief Accumulates the bounds of transformed vertices, 4 at a time
+*/
+class CBoundsAccumulator final
+{
+public:
+	CBoundsAccumulator()
+	{
+#ifdef STUDIO_BOUNDS_SSE
+		for( int axis = 0; axis < 3; ++axis )
+		{
+			m_Mins[ axis ] = _mm_set1_ps( m_Bounds.Mins[ axis ] );
+			m_Maxs[ axis ] = _mm_set1_ps( m_Bounds.Maxs[ axis ] );
+		}
+#endif
+	}
+
+	/**
+	*	@param count Number of vertices. Must be a multiple of 4
+	*/
+	void Add( const float* pX, const float* pY, const float* pZ, const size_t count, const glm::mat3x4& transform )
+	{
+#ifdef STUDIO_BOUNDS_SSE
+		__m128 rows[ 3 ][ 4 ];
+
+		for( int row = 0; row < 3; ++row )
+		{
+			for( int column = 0; column < 4; ++column )
+			{
+				rows[ row ][ column ] = _mm_set1_ps( transform[ row ][ column ] );
+			}
+		}
+
+		for( size_t i = 0; i < count; i += LANES )
+		{
+			const __m128 x = _mm_loadu_ps( pX + i );
+			const __m128 y = _mm_loadu_ps( pY + i );
+			const __m128 z = _mm_loadu_ps( pZ + i );
+
+			for( int row = 0; row < 3; ++row )
+			{
+				__m128 value = _mm_mul_ps( x, rows[ row ][ 0 ] );
+				value = _mm_add_ps( value, _mm_mul_ps( y, rows[ row ][ 1 ] ) );
+				value = _mm_add_ps( value, _mm_mul_ps( z, rows[ row ][ 2 ] ) );
+				value = _mm_add_ps( value, rows[ row ][ 3 ] );
+
+				m_Mins[ row ] = _mm_min_ps( m_Mins[ row ], value );
+				m_Maxs[ row ] = _mm_max_ps( m_Maxs[ row ], value );
+			}
+		}
+#else
+		for( size_t i = 0; i < count; ++i )
+		{
+			glm::vec3 vecTransformed;
+
+			VectorTransform( glm::vec3{ pX[ i ], pY[ i ], pZ[ i ] }, transform, vecTransformed );
+
+			m_Bounds.Mins = glm::min( m_Bounds.Mins, vecTransformed );
+			m_Bounds.Maxs = glm::max( m_Bounds.Maxs, vecTransformed );
+		}
+#endif
+	}
+
+	StudioBounds Get() const
+	{
+#ifdef STUDIO_BOUNDS_SSE
+		StudioBounds bounds;
+
+		for( int axis = 0; axis < 3; ++axis )
+		{
+			float mins[ LANES ], maxs[ LANES ];
+
+			_mm_storeu_ps( mins, m_Mins[ axis ] );
+			_mm_storeu_ps( maxs, m_Maxs[ axis ] );
+
+			bounds.Mins[ axis ] = *std::min_element( mins, mins + LANES );
+			bounds.Maxs[ axis ] = *std::max_element( maxs, maxs + LANES );
+		}
+
+		return bounds;
+#else
+		return m_Bounds;
+#endif
+	}
+
+private:
+	StudioBounds m_Bounds;
+
+#ifdef STUDIO_BOUNDS_SSE
+	__m128 m_Mins[ 3 ];
+	__m128 m_Maxs[ 3 ];
+#endif
+};
+
+/**
+*	@brief Poses a frame of a blend, like the renderer does with a whole frame and no bone controllers
+*/
+void SetUpFrameBones( const studiohdr_t* const pStudioHdr, const mstudioseqdesc_t* const pseqdesc, const mstudioanim_t* const panim,
+	const int frame, const float* const pAdj, glm::mat3x4* const pBoneTransforms )
+{
+	const auto pBones = pStudioHdr->GetBones();
+
+	for( int bone = 0; bone < pStudioHdr->numbones; ++bone )
+	{
+		glm::vec4 q;
+		glm::vec3 pos;
+
+		CalcBoneQuaternion( frame, 0, pBones + bone, panim + bone, pAdj, q );
+		CalcBonePosition( frame, 0, pBones + bone, panim + bone, pAdj, pos );
+
+		if( bone == pseqdesc->motionbone )
+		{
+			if( pseqdesc->motiontype & STUDIO_X )
+				pos[ 0 ] = 0.0;
+			if( pseqdesc->motiontype & STUDIO_Y )
+				pos[ 1 ] = 0.0;
+			if( pseqdesc->motiontype & STUDIO_Z )
+				pos[ 2 ] = 0.0;
+		}
+
+		glm::mat3x4 matrix;
+
+		QuaternionMatrix( q, matrix );
+
+		matrix[ 0 ][ 3 ] = pos[ 0 ];
+		matrix[ 1 ][ 3 ] = pos[ 1 ];
+		matrix[ 2 ][ 3 ] = pos[ 2 ];
+
+		if( pBones[ bone ].parent == -1 )
+		{
+			pBoneTransforms[ bone ] = matrix;
+		}
+		else
+		{
+			R_ConcatTransforms( pBoneTransforms[ pBones[ bone ].parent ], matrix, pBoneTransforms[ bone ] );
+		}
+	}
+}
+
+StudioBounds CalcBounds( CStudioModel& model, const int iSequence, const BoneVertices& vertices )
+{
+	const auto pStudioHdr = model.GetStudioHeader();
+
+	const auto pseqdesc = pStudioHdr->GetSequence( iSequence );
+
+	const auto panim = model.GetAnim( pseqdesc );
+
+	const float adj[ MAXSTUDIOCONTROLLERS ] = {};
+
+	glm::mat3x4 boneTransforms[ MAXSTUDIOBONES ];
+
+	CBoundsAccumulator accumulator;
+
+	for( int blend = 0; blend < pseqdesc->numblends; ++blend )
+	{
+		for( int frame = 0; frame < pseqdesc->numframes; ++frame )
+		{
+			SetUpFrameBones( pStudioHdr, pseqdesc, panim + blend * pStudioHdr->numbones, frame, adj, boneTransforms );
+
+			for( int bone = 0; bone < pStudioHdr->numbones; ++bone )
+			{
+				const size_t first = vertices.Offsets[ bone ];
+				const size_t count = vertices.Offsets[ bone + 1 ] - first;
+
+				if( count > 0 )
+				{
+					accumulator.Add( vertices.X.data() + first, vertices.Y.data() + first, vertices.Z.data() + first, count, boneTransforms[ bone ] );
+				}
+			}
+		}
+	}
+
+	return accumulator.Get();
+}
+}
+
+std::vector<StudioBounds> CalcSequenceBounds( CStudioModel& model, unsigned int numThreads )
+{
+	const auto pStudioHdr = model.GetStudioHeader();
+
+	std::vector<StudioBounds> bounds( pStudioHdr->numseq );
+
+	const auto vertices = GroupVerticesByBone( pStudioHdr );
+
+	if( vertices.X.empty() )
+	{
+		return bounds;
+	}
+
+	//Start with the longest sequences so threads finish at about the same time
+	std::vector<int> order( pStudioHdr->numseq );
+
+	std::iota( order.begin(), order.end(), 0 );
+
+	std::stable_sort( order.begin(), order.end(), [ = ]( const int lhs, const int rhs )
+		{
+			const auto pLhs = pStudioHdr->GetSequence( lhs );
+			const auto pRhs = pStudioHdr->GetSequence( rhs );
+
+			return pLhs->numframes * pLhs->numblends > pRhs->numframes * pRhs->numblends;
+		} );
+
+	if( numThreads == 0 )
+	{
+		numThreads = std::max( 1u, std::thread::hardware_concurrency() );
+	}
+
+	numThreads = std::min( numThreads, static_cast<unsigned int>( std::max( 1, pStudioHdr->numseq ) ) );
+
+	std::atomic<size_t> nextSequence{ 0 };
+
+	auto worker = [ & ]()
+	{
+		for( size_t index; ( index = nextSequence++ ) < order.size(); )
+		{
+			bounds[ order[ index ] ] = CalcBounds( model, order[ index ], vertices );
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	threads.reserve( numThreads - 1 );
+
+	for( unsigned int thread = 1; thread < numThreads; ++thread )
+	{
+		threads.emplace_back( worker );
+	}
+
+	worker();
+
+	for( auto& thread : threads )
+	{
+		thread.join();
+	}
+
+	return bounds;
+}
+
+int RecomputeSequenceBounds( CStudioModel& model )
+{
+	const auto bounds = CalcSequenceBounds( model );
+
+	auto pStudioHdr = model.GetStudioHeader();
+
+	StudioBounds modelBounds;
+
+	int updated = 0;
+
+	for( int i = 0; i < pStudioHdr->numseq; ++i )
+	{
+		if( bounds[ i ].IsEmpty() )
+		{
+			continue;
+		}
+
+		auto pseqdesc = pStudioHdr->GetSequence( i );
+
+		pseqdesc->bbmin = bounds[ i ].Mins;
+		pseqdesc->bbmax = bounds[ i ].Maxs;
+
+		modelBounds.Mins = glm::min( modelBounds.Mins, bounds[ i ].Mins );
+		modelBounds.Maxs = glm::max( modelBounds.Maxs, bounds[ i ].Maxs );
+
+		++updated;
+	}
+
+	const glm::vec3 vecZero{ 0 };
+
+	if( !modelBounds.IsEmpty() && ( pStudioHdr->bbmin != vecZero || pStudioHdr->bbmax != vecZero ) )
+	{
+		pStudioHdr->bbmin = modelBounds.Mins;
+		pStudioHdr->bbmax = modelBounds.Maxs;
+	}
+
+	return updated;
+}
+}
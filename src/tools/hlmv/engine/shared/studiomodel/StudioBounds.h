@@ -0,0 +1,48 @@
+#ifndef GAME_STUDIOMODEL_STUDIOBOUNDS_H
+#define GAME_STUDIOMODEL_STUDIOBOUNDS_H
+
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+/**
+*	@file
+*
+*	Recomputes the bounding boxes stored in a model from its animations and meshes.
+*/
+
+namespace studiomdl
+{
+class CStudioModel;
+
+/**
+*	@brief Axis aligned bounds. Mins is greater than Maxs if nothing was added
+*/
+struct StudioBounds
+{
+	glm::vec3 Mins{ 9999.0f };
+	glm::vec3 Maxs{ -9999.0f };
+
+	bool IsEmpty() const { return Mins.x > Maxs.x; }
+};
+
+/**
+*	@brief Computes the bounds of each sequence, as studiomdl does
+*	Every frame of every blend is posed without bone controllers and every vertex of every submodel is transformed.
+*	Poses between frames and between blends are not considered.
+*	Sequences are computed in parallel.
+*	@param numThreads Number of threads to use, or 0 to use all cores
+*	@return Bounds for each sequence. Sequences without frames or a model without vertices give empty bounds
+*/
+std::vector<StudioBounds> CalcSequenceBounds( CStudioModel& model, unsigned int numThreads = 0 );
+
+/**
+*	@brief Replaces the bounds of each sequence with freshly computed bounds
+*	The clipping box in the header is set to the bounds of all sequences, unless it is all zeroes,
+*	which studiomdl writes when the model does not specify one.
+*	@return Number of sequences whose bounds were updated
+*/
+int RecomputeSequenceBounds( CStudioModel& model );
+}
+
+#endif //GAME_STUDIOMODEL_STUDIOBOUNDS_H
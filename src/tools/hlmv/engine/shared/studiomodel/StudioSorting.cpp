@@ -0,0 +1,63 @@
+#include <algorithm>
+
+#include <glm/vec3.hpp>
+
+#include "shared/Const.h"
+
+#include "StudioSorting.h"
+
+namespace studiomdl
+{
+bool CompareSortedMeshes( const SortedMesh_t& lhs, const SortedMesh_t& rhs )
+{
+	if( ( lhs.flags & ( STUDIO_NF_ADDITIVE ) ) == 0 && rhs.flags & ( STUDIO_NF_ADDITIVE ) )
+		return true;
+
+	if( lhs.flags & ( STUDIO_NF_MASKED ) && ( rhs.flags & ( STUDIO_NF_MASKED ) ) == 0 )
+		return true;
+
+	return false;
+}
+
+void SortMeshes( std::vector<SortedMesh_t>& meshes )
+{
+	//Sort meshes by render modes so additive meshes are drawn after solid meshes.
+	//Masked meshes are drawn before solid meshes.
+	std::stable_sort( meshes.begin(), meshes.end(), CompareSortedMeshes );
+}
+
+void GroupMeshesByTexture( std::vector<SortedMesh_t>& meshes )
+{
+	const int renderModeFlags = STUDIO_NF_ADDITIVE | STUDIO_NF_MASKED;
+
+	//Within each run of meshes with the same render mode, pull later meshes that use the same texture up to the first one that does
+	for( auto first = meshes.begin(); first != meshes.end(); )
+	{
+		const int renderMode = first->flags & renderModeFlags;
+
+		const auto last = std::find_if( first, meshes.end(), [ = ]( const SortedMesh_t& mesh )
+			{
+				return ( mesh.flags & renderModeFlags ) != renderMode;
+			} );
+
+		//Additive meshes are blended, so their order matters
+		if( renderMode & STUDIO_NF_ADDITIVE )
+		{
+			first = last;
+			continue;
+		}
+
+		for( auto mesh = first; mesh != last; )
+		{
+			const int texture = mesh->texture;
+
+			mesh = std::stable_partition( mesh + 1, last, [ = ]( const SortedMesh_t& other )
+				{
+					return other.texture == texture;
+				} );
+		}
+
+		first = last;
+	}
+}
+}
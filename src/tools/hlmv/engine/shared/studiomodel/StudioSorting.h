@@ -0,0 +1,37 @@
+#ifndef GAME_STUDIOMODEL_STUDIOSORTING_H
+#define GAME_STUDIOMODEL_STUDIOSORTING_H
+
+#include <vector>
+
+#include "studio.h"
+
+namespace studiomdl
+{
+struct SortedMesh_t
+{
+	mstudiomesh_t* pMesh;
+	int flags;
+
+	/**
+	*	Index of the mesh's texture, after skin remapping.
+	*/
+	int texture;
+};
+
+bool CompareSortedMeshes( const SortedMesh_t& lhs, const SortedMesh_t& rhs );
+
+/**
+*	@brief Sorts meshes into draw order
+*	Masked meshes are drawn before solid meshes, and additive meshes after them. Meshes with the same render mode keep their order.
+*/
+void SortMeshes( std::vector<SortedMesh_t>& meshes );
+
+/**
+*	@brief Moves masked and solid meshes that share a texture and render mode next to each other, so drawing them needs one texture bind
+*	Additive meshes keep their order. Only valid when the model is drawn opaque, since blended meshes must be drawn in their original order.
+*	@param meshes Meshes sorted by SortMeshes
+*/
+void GroupMeshesByTexture( std::vector<SortedMesh_t>& meshes );
+}
+
+#endif //GAME_STUDIOMODEL_STUDIOSORTING_H
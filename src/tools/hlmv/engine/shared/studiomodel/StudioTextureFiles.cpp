@@ -0,0 +1,93 @@
+#include <cstring>
+
+#include "graphics/BMPFile.h"
+
+#include "CStudioModel.h"
+#include "StudioTextureFiles.h"
+
+namespace studiomdl
+{
+void LoadTextureImport( const studiohdr_t& textureHdr, TextureImport& import, const bool bPowerOf2 )
+{
+	const auto& texture = *textureHdr.GetTexture( import.Texture );
+
+	if( !graphics::bmpfile::LoadBMPFile( import.FileName.c_str(), import.ImageWidth, import.ImageHeight, import.Pixels, import.Palette ) )
+	{
+		import.Result = TextureFileResult::LOAD_FAILED;
+		return;
+	}
+
+	if( import.ImageWidth != texture.width || import.ImageHeight != texture.height )
+	{
+		import.Result = TextureFileResult::DIMENSIONS_DIFFER;
+		return;
+	}
+
+	//Conversion changes the mask color, so give it a copy
+	byte palette[ PALETTE_SIZE ];
+
+	memcpy( palette, import.Palette, sizeof( palette ) );
+
+	import.UploadPixels = ConvertTextureToRGBA( texture, import.Pixels.data(), palette, bPowerOf2, import.UploadWidth, import.UploadHeight );
+
+	import.Result = import.UploadPixels ? TextureFileResult::SUCCESS : TextureFileResult::CONVERSION_FAILED;
+}
+
+size_t ApplyTextureImports( CStudioModel& model, const std::vector<TextureImport>& imports )
+{
+	auto pTextureHdr = model.GetTextureHeader();
+
+	size_t uiApplied = 0;
+
+	for( const auto& import : imports )
+	{
+		if( import.Result != TextureFileResult::SUCCESS )
+		{
+			continue;
+		}
+
+		const auto& texture = *pTextureHdr->GetTexture( import.Texture );
+
+		const size_t uiPixels = static_cast<size_t>( texture.width ) * texture.height;
+
+		memcpy( pTextureHdr->GetData() + texture.index, import.Pixels.data(), uiPixels );
+		memcpy( pTextureHdr->GetData() + texture.index + uiPixels, import.Palette, PALETTE_SIZE );
+
+		model.UploadConvertedTexture( import.Texture, import.UploadWidth, import.UploadHeight, import.UploadPixels.get() );
+
+		++uiApplied;
+	}
+
+	return uiApplied;
+}
+
+TextureFileResult ExportTextureFile( const studiohdr_t& textureHdr, const int texture, const char* const pszFileName )
+{
+	const auto& studioTexture = *textureHdr.GetTexture( texture );
+
+	const auto pPixels = textureHdr.GetData() + studioTexture.index;
+
+	if( !graphics::bmpfile::SaveBMPFile( pszFileName, studioTexture.width, studioTexture.height,
+		pPixels, pPixels + studioTexture.width * studioTexture.height ) )
+	{
+		return TextureFileResult::SAVE_FAILED;
+	}
+
+	return TextureFileResult::SUCCESS;
+}
+
+const char* TextureFileResultToString( const TextureFileResult result )
+{
+	switch( result )
+	{
+	case TextureFileResult::NOT_RUN:			return "Cancelled";
+	case TextureFileResult::SUCCESS:			return "Success";
+	case TextureFileResult::LOAD_FAILED:		return "Could not load the image, it must be an uncompressed 8 bit BMP";
+	case TextureFileResult::DIMENSIONS_DIFFER:	return "Image dimensions do not match the texture";
+	case TextureFileResult::CONVERSION_FAILED:	return "Could not convert the image";
+	case TextureFileResult::SAVE_FAILED:		return "Could not save the image";
+	}
+
+	return "Unknown";
+}
+}
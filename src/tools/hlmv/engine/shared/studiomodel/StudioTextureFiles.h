@@ -0,0 +1,87 @@
+#ifndef GAME_STUDIOMODEL_STUDIOTEXTUREFILES_H
+#define GAME_STUDIOMODEL_STUDIOTEXTUREFILES_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "shared/Const.h"
+
+#include "graphics/Palette.h"
+
+/**
+*	@file
+*
+*	Imports and exports model textures as BMP files.
+*	Reading, validating and converting files only reads the model, so it can be done for many textures in parallel.
+*	Imports are then applied to the model in one step on the thread that owns the OpenGL context.
+*/
+
+struct studiohdr_t;
+
+namespace studiomdl
+{
+class CStudioModel;
+
+enum class TextureFileResult
+{
+	NOT_RUN = 0,
+	SUCCESS,
+	LOAD_FAILED,
+	DIMENSIONS_DIFFER,
+	CONVERSION_FAILED,
+	SAVE_FAILED
+};
+
+/**
+*	@brief A texture loaded from a file and converted for upload, waiting to be applied to the model
+*/
+struct TextureImport
+{
+	int Texture = -1;
+
+	std::string FileName;
+
+	TextureFileResult Result = TextureFileResult::NOT_RUN;
+
+	//Dimensions of the image in the file.
+	int ImageWidth = 0;
+	int ImageHeight = 0;
+
+	std::vector<byte> Pixels;
+	byte Palette[ PALETTE_SIZE ];
+
+	//Pixels as they are uploaded, see ConvertTextureToRGBA.
+	int UploadWidth = 0;
+	int UploadHeight = 0;
+	std::unique_ptr<byte[]> UploadPixels;
+};
+
+/**
+*	@brief Loads an uncompressed 8 bit BMP file for a texture, checks that it matches the texture and converts it for upload
+*	Only reads the texture header, so imports of different textures can be loaded in parallel.
+*	@param import Texture and FileName must be set. Result is set to the outcome
+*	@param bPowerOf2 Whether to resample to power of 2 dimensions. See ShouldResizeTexturesToPowerOf2
+*/
+void LoadTextureImport( const studiohdr_t& textureHdr, TextureImport& import, const bool bPowerOf2 );
+
+/**
+*	@brief Copies the pixels and palettes of successfully loaded imports into the model and uploads them
+*	Must be called on the thread that owns the OpenGL context.
+*	@return Number of textures that were replaced
+*/
+size_t ApplyTextureImports( CStudioModel& model, const std::vector<TextureImport>& imports );
+
+/**
+*	@brief Saves a texture as an 8 bit BMP file
+*	Only reads the texture header, so different textures can be exported in parallel.
+*/
+TextureFileResult ExportTextureFile( const studiohdr_t& textureHdr, const int texture, const char* const pszFileName );
+
+/**
+*	@return A description of the result, for error messages
+*/
+const char* TextureFileResultToString( const TextureFileResult result );
+}
+
+#endif //GAME_STUDIOMODEL_STUDIOTEXTUREFILES_H
@@ -0,0 +1,359 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
+#include "CStudioModel.h"
+#include "StudioUVMap.h"
+#include "TriangleCommands.h"
+
+namespace studiomdl
+{
+namespace
+{
+const byte BACKGROUND_COLOR[ 3 ] = { 0, 0, 0 };
+
+const byte ISLAND_COLOR[ 3 ] = { 64, 64, 64 };
+
+/**
+*	Colors for areas covered by 1, 2 and 3 or more triangles.
+*/
+const byte HEATMAP_COLORS[ 3 ][ 3 ] =
+{
+	{ 0, 112, 0 },
+	{ 192, 176, 0 },
+	{ 224, 0, 0 }
+};
+
+/**
+*	@brief Per pixel layers that are combined into the final image
+*/
+struct UVMapCanvas
+{
+	int Width;
+	int Height;
+
+	//Number of triangles covering each pixel center.
+	std::vector<std::uint16_t> Coverage;
+
+	//Edge coverage in the range [0, 255]. Overlapping edges keep the largest value, so the order they are drawn in does not matter.
+	std::vector<byte> Lines;
+
+	void PlotLine( const int x, const int y, const float flCoverage )
+	{
+		if( x < 0 || x >= Width || y < 0 || y >= Height )
+		{
+			return;
+		}
+
+		auto& pixel = Lines[ static_cast<size_t>( y ) * Width + x ];
+
+		pixel = std::max( pixel, static_cast<byte>( flCoverage * 255 + 0.5f ) );
+	}
+};
+
+/**
+*	@brief Draws a line between two points given in texels
+*	Steps one pixel at a time along the major axis. With anti-aliasing the coverage is split
+*	between the two pixels nearest the line on the minor axis, otherwise the nearest pixel is set.
+*/
+void DrawLine( UVMapCanvas& canvas, const short* pStart, const short* pEnd, const bool bAntiAlias )
+{
+	//Texel coordinates are pixel corners, move them so pixel centers are at whole numbers.
+	float x0 = pStart[ 0 ] - 0.5f;
+	float y0 = pStart[ 1 ] - 0.5f;
+	float x1 = pEnd[ 0 ] - 0.5f;
+	float y1 = pEnd[ 1 ] - 0.5f;
+
+	const bool bSteep = std::abs( y1 - y0 ) > std::abs( x1 - x0 );
+
+	if( bSteep )
+	{
+		std::swap( x0, y0 );
+		std::swap( x1, y1 );
+	}
+
+	if( x0 > x1 )
+	{
+		std::swap( x0, x1 );
+		std::swap( y0, y1 );
+	}
+
+	const float flGradient = x1 > x0 ? ( y1 - y0 ) / ( x1 - x0 ) : 0.0f;
+
+	auto plot = [ & ]( const int iMajor, const int iMinor, const float flCoverage )
+	{
+		if( bSteep )
+		{
+			canvas.PlotLine( iMinor, iMajor, flCoverage );
+		}
+		else
+		{
+			canvas.PlotLine( iMajor, iMinor, flCoverage );
+		}
+	};
+
+	const int iLast = static_cast<int>( std::floor( x1 + 0.5f ) );
+
+	for( int x = static_cast<int>( std::floor( x0 + 0.5f ) ); x <= iLast; ++x )
+	{
+		const float y = y0 + flGradient * ( x - x0 );
+
+		if( bAntiAlias )
+		{
+			const float flFloor = std::floor( y );
+			const float flFraction = y - flFloor;
+
+			plot( x, static_cast<int>( flFloor ), 1 - flFraction );
+			plot( x, static_cast<int>( flFloor ) + 1, flFraction );
+		}
+		else
+		{
+			plot( x, static_cast<int>( std::floor( y + 0.5f ) ), 1 );
+		}
+	}
+}
+
+/**
+*	@brief Counts the triangle in every pixel whose center it covers
+*	Uses exact integer edge functions. Pixels centered exactly on an edge shared by two triangles are counted once,
+*	so adjacent triangles do not show up as overlapping.
+*/
+void FillTriangle( UVMapCanvas& canvas, const short* pVertex0, const short* pVertex1, const short* pVertex2 )
+{
+	//Doubled so pixel centers are at odd whole numbers.
+	std::int64_t x[ 3 ] = { pVertex0[ 0 ] * 2, pVertex1[ 0 ] * 2, pVertex2[ 0 ] * 2 };
+	std::int64_t y[ 3 ] = { pVertex0[ 1 ] * 2, pVertex1[ 1 ] * 2, pVertex2[ 1 ] * 2 };
+
+	const auto area = ( x[ 1 ] - x[ 0 ] ) * ( y[ 2 ] - y[ 0 ] ) - ( y[ 1 ] - y[ 0 ] ) * ( x[ 2 ] - x[ 0 ] );
+
+	if( area == 0 )
+	{
+		return;
+	}
+
+	//Make the winding consistent so the inside is where all edge functions are positive.
+	if( area < 0 )
+	{
+		std::swap( x[ 1 ], x[ 2 ] );
+		std::swap( y[ 1 ], y[ 2 ] );
+	}
+
+	std::int64_t edgeX[ 3 ], edgeY[ 3 ], bias[ 3 ];
+
+	for( int edge = 0; edge < 3; ++edge )
+	{
+		const int next = ( edge + 1 ) % 3;
+
+		edgeX[ edge ] = x[ next ] - x[ edge ];
+		edgeY[ edge ] = y[ next ] - y[ edge ];
+
+		//A shared edge runs in opposite directions in its two triangles, so exactly one of them owns pixels on it.
+		bias[ edge ] = ( edgeY[ edge ] > 0 || ( edgeY[ edge ] == 0 && edgeX[ edge ] < 0 ) ) ? 0 : -1;
+	}
+
+	const int iMinX = std::max( 0, static_cast<int>( std::min( { x[ 0 ], x[ 1 ], x[ 2 ] } ) / 2 ) - 1 );
+	const int iMinY = std::max( 0, static_cast<int>( std::min( { y[ 0 ], y[ 1 ], y[ 2 ] } ) / 2 ) - 1 );
+	const int iMaxX = std::min( canvas.Width - 1, static_cast<int>( std::max( { x[ 0 ], x[ 1 ], x[ 2 ] } ) / 2 ) );
+	const int iMaxY = std::min( canvas.Height - 1, static_cast<int>( std::max( { y[ 0 ], y[ 1 ], y[ 2 ] } ) / 2 ) );
+
+	for( int iY = iMinY; iY <= iMaxY; ++iY )
+	{
+		const std::int64_t centerY = iY * 2 + 1;
+
+		auto pCoverage = canvas.Coverage.data() + static_cast<size_t>( iY ) * canvas.Width;
+
+		for( int iX = iMinX; iX <= iMaxX; ++iX )
+		{
+			const std::int64_t centerX = iX * 2 + 1;
+
+			bool bInside = true;
+
+			for( int edge = 0; edge < 3 && bInside; ++edge )
+			{
+				const auto value = edgeX[ edge ] * ( centerY - y[ edge ] ) - edgeY[ edge ] * ( centerX - x[ edge ] );
+
+				bInside = value + bias[ edge ] >= 0;
+			}
+
+			if( bInside && pCoverage[ iX ] < UINT16_MAX )
+			{
+				++pCoverage[ iX ];
+			}
+		}
+	}
+}
+}
+
+std::vector<const mstudiomesh_t*> GetMeshesUsingTexture( const CStudioModel& model, const int texture )
+{
+	std::vector<const mstudiomesh_t*> meshes;
+
+	const auto pStudioHdr = model.GetStudioHeader();
+	const auto pTextureHdr = model.GetTextureHeader();
+
+	const short* const pSkinRef = pTextureHdr->GetSkins();
+
+	for( int bodypart = 0; bodypart < pStudioHdr->numbodyparts; ++bodypart )
+	{
+		const auto pBodypart = pStudioHdr->GetBodypart( bodypart );
+
+		const auto pModels = reinterpret_cast<const mstudiomodel_t*>( pStudioHdr->GetData() + pBodypart->modelindex );
+
+		for( int submodel = 0; submodel < pBodypart->nummodels; ++submodel )
+		{
+			const auto pMeshes = reinterpret_cast<const mstudiomesh_t*>( pStudioHdr->GetData() + pModels[ submodel ].meshindex );
+
+			for( int mesh = 0; mesh < pModels[ submodel ].nummesh; ++mesh )
+			{
+				//Check each skin family to find textures used only by alternate skins
+				for( int skinFamily = 0; skinFamily < pTextureHdr->numskinfamilies; ++skinFamily )
+				{
+					if( pSkinRef[ skinFamily * pTextureHdr->numskinref + pMeshes[ mesh ].skinref ] == texture )
+					{
+						meshes.push_back( pMeshes + mesh );
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	return meshes;
+}
+
+UVMapImage DrawUVMap( const CStudioModel& model, const int texture, const UVMapSettings& settings, const mstudiomesh_t* pMesh )
+{
+	const auto pTexture = model.GetTextureHeader()->GetTexture( texture );
+
+	UVMapImage image;
+
+	if( pTexture->width <= 0 || pTexture->height <= 0 )
+	{
+		return image;
+	}
+
+	const size_t uiPixels = static_cast<size_t>( pTexture->width ) * pTexture->height;
+
+	UVMapCanvas canvas;
+
+	canvas.Width = pTexture->width;
+	canvas.Height = pTexture->height;
+	canvas.Lines.resize( uiPixels );
+
+	const bool bFill = settings.FillIslands || settings.OverlapHeatmap;
+
+	if( bFill )
+	{
+		canvas.Coverage.resize( uiPixels );
+	}
+
+	std::vector<const mstudiomesh_t*> meshes;
+
+	if( pMesh )
+	{
+		meshes.push_back( pMesh );
+	}
+	else
+	{
+		meshes = GetMeshesUsingTexture( model, texture );
+	}
+
+	const auto pStudioHdr = model.GetStudioHeader();
+
+	for( auto pCurrentMesh : meshes )
+	{
+		const auto pTriCmds = reinterpret_cast<const short*>( pStudioHdr->GetData() + pCurrentMesh->triindex );
+
+		DecodeTriangleCommands( pTriCmds, [ & ]( const short* pVertex0, const short* pVertex1, const short* pVertex2 )
+			{
+				//Skip the vertex and normal indices
+				pVertex0 += 2;
+				pVertex1 += 2;
+				pVertex2 += 2;
+
+				if( bFill )
+				{
+					FillTriangle( canvas, pVertex0, pVertex1, pVertex2 );
+				}
+
+				DrawLine( canvas, pVertex0, pVertex1, settings.AntiAliasLines );
+				DrawLine( canvas, pVertex1, pVertex2, settings.AntiAliasLines );
+				DrawLine( canvas, pVertex2, pVertex0, settings.AntiAliasLines );
+			} );
+	}
+
+	image.Width = pTexture->width;
+	image.Height = pTexture->height;
+	image.Pixels.resize( uiPixels * 3 );
+
+	for( size_t uiPixel = 0; uiPixel < uiPixels; ++uiPixel )
+	{
+		const byte* pBase = BACKGROUND_COLOR;
+
+		if( bFill && canvas.Coverage[ uiPixel ] > 0 )
+		{
+			if( settings.OverlapHeatmap )
+			{
+				pBase = HEATMAP_COLORS[ std::min<int>( canvas.Coverage[ uiPixel ], 3 ) - 1 ];
+			}
+			else
+			{
+				pBase = ISLAND_COLOR;
+			}
+		}
+
+		const int iLine = canvas.Lines[ uiPixel ];
+
+		auto pDest = image.Pixels.data() + uiPixel * 3;
+
+		//Blend white edges over the base color
+		for( int channel = 0; channel < 3; ++channel )
+		{
+			pDest[ channel ] = static_cast<byte>( ( pBase[ channel ] * ( 255 - iLine ) + 255 * iLine + 127 ) / 255 );
+		}
+	}
+
+	return image;
+}
+
+void DrawUVMaps( const CStudioModel& model, const UVMapSettings& settings,
+	const std::function<void( int texture, UVMapImage&& image )>& callback, unsigned int numThreads )
+{
+	const int numTextures = model.GetTextureHeader()->numtextures;
+
+	if( numThreads == 0 )
+	{
+		numThreads = std::max( 1u, std::thread::hardware_concurrency() );
+	}
+
+	numThreads = std::min( numThreads, static_cast<unsigned int>( std::max( 1, numTextures ) ) );
+
+	std::atomic<int> nextTexture{ 0 };
+
+	auto worker = [ & ]()
+	{
+		for( int texture; ( texture = nextTexture++ ) < numTextures; )
+		{
+			callback( texture, DrawUVMap( model, texture, settings ) );
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	threads.reserve( numThreads - 1 );
+
+	for( unsigned int thread = 1; thread < numThreads; ++thread )
+	{
+		threads.emplace_back( worker );
+	}
+
+	worker();
+
+	for( auto& thread : threads )
+	{
+		thread.join();
+	}
+}
+}
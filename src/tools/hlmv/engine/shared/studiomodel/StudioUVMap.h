@@ -0,0 +1,72 @@
+#ifndef GAME_STUDIOMODEL_STUDIOUVMAP_H
+#define GAME_STUDIOMODEL_STUDIOUVMAP_H
+
+#include <functional>
+#include <vector>
+
+#include "shared/Const.h"
+
+/**
+*	@file
+*
+*	Draws the UV layout of a model's textures on the CPU, from the s and t values in the triangle commands of its meshes.
+*/
+
+struct mstudiomesh_t;
+
+namespace studiomdl
+{
+class CStudioModel;
+
+struct UVMapSettings
+{
+	/**
+	*	Draw edges with coverage based anti-aliasing instead of as solid pixels.
+	*/
+	bool AntiAliasLines = false;
+
+	/**
+	*	Fill the area covered by triangles, so the islands of the layout stand out.
+	*/
+	bool FillIslands = false;
+
+	/**
+	*	Color the area covered by triangles by how many triangles overlap there. Replaces the island fill.
+	*/
+	bool OverlapHeatmap = false;
+};
+
+/**
+*	@brief RGB image the size of a texture, top row first
+*	Edges are white on black.
+*/
+struct UVMapImage
+{
+	int Width = 0;
+	int Height = 0;
+
+	std::vector<byte> Pixels;
+};
+
+/**
+*	@brief Gets the meshes of all submodels that use a texture in any skin family
+*/
+std::vector<const mstudiomesh_t*> GetMeshesUsingTexture( const CStudioModel& model, const int texture );
+
+/**
+*	@brief Draws the UV map of a texture
+*	The result only depends on the model and settings, so it is the same no matter which thread draws it.
+*	@param pMesh If not null, only this mesh is drawn. Otherwise all meshes that use the texture are drawn
+*/
+UVMapImage DrawUVMap( const CStudioModel& model, const int texture, const UVMapSettings& settings, const mstudiomesh_t* pMesh = nullptr );
+
+/**
+*	@brief Draws the UV maps of all textures in parallel
+*	@param callback Called as callback(texture, image) for each texture, from the thread that drew it
+*	@param numThreads Number of threads to use, or 0 to use all cores
+*/
+void DrawUVMaps( const CStudioModel& model, const UVMapSettings& settings,
+	const std::function<void( int texture, UVMapImage&& image )>& callback, unsigned int numThreads = 0 );
+}
+
+#endif //GAME_STUDIOMODEL_STUDIOUVMAP_H
@@ -0,0 +1,66 @@
+#ifndef GAME_STUDIOMODEL_TRIANGLECOMMANDS_H
+#define GAME_STUDIOMODEL_TRIANGLECOMMANDS_H
+
+namespace studiomdl
+{
+/**
+*	Number of shorts per vertex in a triangle command: vertex index, normal index, s, t.
+*/
+const int TRICMD_VERTEX_SIZE = 4;
+
+/**
+*	@brief Converts the triangle strips and fans of a mesh to individual triangles
+*	Every other triangle in a strip is flipped so all triangles have the same winding.
+*	@param pTriCmds Triangle commands of the mesh
+*	@param callback Called as callback(const short* pVertex0, const short* pVertex1, const short* pVertex2) for each triangle.
+*		Each pointer points to TRICMD_VERTEX_SIZE shorts
+*	@return Number of triangles
+*/
+template<typename Callback>
+unsigned int DecodeTriangleCommands(const short* pTriCmds, Callback&& callback)
+{
+	unsigned int uiTriangles = 0;
+
+	int i;
+
+	while ((i = *(pTriCmds++)))
+	{
+		const bool isFan = i < 0;
+
+		if (isFan)
+		{
+			i = -i;
+		}
+
+		const short* const pFirst = pTriCmds;
+
+		for (int vertex = 2; vertex < i; ++vertex)
+		{
+			const short* const pCurrent = pFirst + vertex * TRICMD_VERTEX_SIZE;
+			const short* const pPrevious = pCurrent - TRICMD_VERTEX_SIZE;
+
+			if (isFan)
+			{
+				callback(pFirst, pPrevious, pCurrent);
+			}
+			else if (vertex % 2)
+			{
+				//Keep the winding consistent for odd triangles in a strip
+				callback(pPrevious, pPrevious - TRICMD_VERTEX_SIZE, pCurrent);
+			}
+			else
+			{
+				callback(pPrevious - TRICMD_VERTEX_SIZE, pPrevious, pCurrent);
+			}
+		}
+
+		uiTriangles += i > 2 ? i - 2 : 0;
+
+		pTriCmds += i * TRICMD_VERTEX_SIZE;
+	}
+
+	return uiTriangles;
+}
+}
+
+#endif //GAME_STUDIOMODEL_TRIANGLECOMMANDS_H
@@ -14,8 +14,7 @@ extern studiomdl::IStudioModelRenderer* g_pStudioMdlRenderer;
 
 void CStudioModelEntity::OnDestroy()
 {
-	//TODO: once models are managed by a cache, don't do this
-	delete m_pModel;
+	m_Model.reset();
 
 	BaseClass::OnDestroy();
 }
@@ -29,7 +28,7 @@ bool CStudioModelEntity::Spawn()
 	SetController( 3, 0.0f );
 	SetMouth( 0.0f );
 
-	const studiohdr_t* pStudioHdr = m_pModel->GetStudioHeader();
+	const studiohdr_t* pStudioHdr = m_Model->GetStudioHeader();
 
 	for( int n = 0; n < pStudioHdr->numbodyparts; ++n )
 		SetBodygroup( n, 0 );
@@ -43,6 +42,13 @@ void CStudioModelEntity::Draw( renderer::DrawFlags_t flags )
 {
 	studiomdl::CModelRenderInfo renderInfo;
 
+	GetRenderInfo( renderInfo );
+
+	g_pStudioMdlRenderer->DrawModel( &renderInfo, flags );
+}
+
+void CStudioModelEntity::GetRenderInfo( studiomdl::CModelRenderInfo& renderInfo ) const
+{
 	renderInfo.vecOrigin = GetOrigin();
 	renderInfo.vecAngles = GetAngles();
 	renderInfo.vecScale = GetScale();
@@ -66,16 +72,14 @@ void CStudioModelEntity::Draw( renderer::DrawFlags_t flags )
 	}
 
 	renderInfo.iMouth = GetMouth();
-
-	g_pStudioMdlRenderer->DrawModel( &renderInfo, flags );
 }
 
 float CStudioModelEntity::AdvanceFrame( float dt, const float flMax )
 {
-	if( !m_pModel )
+	if( !m_Model )
 		return 0.0;
 
-	const studiohdr_t* pStudioHdr = m_pModel->GetStudioHeader();
+	const studiohdr_t* pStudioHdr = m_Model->GetStudioHeader();
 
 	const mstudioseqdesc_t* pseqdesc = pStudioHdr->GetSequence( m_iSequence );
 
@@ -151,63 +155,59 @@ float CStudioModelEntity::AdvanceFrame( float dt, const float flMax )
 	return dt;
 }
 
-int CStudioModelEntity::GetAnimationEvent( CAnimEvent& event, float flStart, float flEnd, int index, const bool bAllowClientEvents )
+size_t CStudioModelEntity::GetAnimationEvents( float flStart, float flEnd, const bool bAllowClientEvents, std::vector<CAnimEvent>& events ) const
 {
-	if( !m_pModel )
+	if( !m_Model )
 		return 0;
 
-	const studiohdr_t* pStudioHdr = m_pModel->GetStudioHeader();
+	const studiohdr_t* pStudioHdr = m_Model->GetStudioHeader();
 
 	if( m_iSequence >= pStudioHdr->numseq )
 		return 0;
 
-	int events = 0;
+	const auto& eventIndex = m_Model->GetEventIndex();
 
-	const mstudioseqdesc_t* pseqdesc = pStudioHdr->GetSequence( m_iSequence );
-	const mstudioevent_t* pevent = ( const mstudioevent_t * ) ( ( const byte * ) pStudioHdr + pseqdesc->eventindex );
-
-	if( pseqdesc->numevents == 0 || index > pseqdesc->numevents )
+	if( eventIndex.GetEventCount( m_iSequence ) == 0 )
 		return 0;
 
+	const mstudioseqdesc_t* pseqdesc = pStudioHdr->GetSequence( m_iSequence );
+
 	if( pseqdesc->numframes <= 1 )
 	{
 		flStart = 0;
 		flEnd = 1.0;
 	}
 
-	for( ; index < pseqdesc->numevents; index++ )
+	std::vector<const mstudioevent_t*> sequenceEvents;
+
+	eventIndex.GetEvents( m_iSequence, flStart, flEnd, static_cast<float>( pseqdesc->numframes - 1 ), sequenceEvents );
+
+	const size_t uiOldCount = events.size();
+
+	for( const auto pEvent : sequenceEvents )
 	{
 		//TODO: maybe leave it up to the listener to filter these out?
 		if( !bAllowClientEvents )
 		{
 			// Don't send client-side events to the server AI
-			if( pevent[ index ].event >= EVENT_CLIENT )
+			if( pEvent->event >= EVENT_CLIENT )
 				continue;
 		}
 
-		if( ( pevent[ index ].frame >= flStart && pevent[ index ].frame < flEnd ) ||
-			( ( pseqdesc->flags & STUDIO_LOOPING ) && flEnd >= pseqdesc->numframes - 1 && pevent[ index ].frame < flEnd - pseqdesc->numframes + 1 ) )
-		{
-			event.iEvent = pevent[ index ].event;
-			event.pszOptions = pevent[ index ].options;
-			return index + 1;
-		}
+		events.push_back( CAnimEvent{ pEvent->event, pEvent->options } );
 	}
-	return 0;
+
+	return events.size() - uiOldCount;
 }
 
 void CStudioModelEntity::DispatchAnimEvents( const bool bAllowClientEvents )
 {
-	if( !m_pModel )
+	if( !m_Model )
 	{
 		Message( "Gibbed monster is thinking!\n" );
 		return;
 	}
 
-	const studiohdr_t* pStudioHdr = m_pModel->GetStudioHeader();
-
-	const mstudioseqdesc_t* pseqdesc = pStudioHdr->GetSequence( m_iSequence );
-
 	//This is based on Source's DispatchAnimEvents. It fixes the bug where events don't get triggered, and get triggered multiple times due to the workaround.
 	//Plays from previous frame to current. This differs from GoldSource in that GoldSource plays from current to predicted future frame.
 	//This is more accurate, since it's based on actual frame data, rather than predicted frames, but results in events firing later than before.
@@ -216,11 +216,12 @@ void CStudioModelEntity::DispatchAnimEvents( const bool bAllowClientEvents )
 	float flEnd = m_flFrame;
 	m_flLastEventCheck = m_flFrame;
 
-	CAnimEvent event;
+	//Only allocates when events are found, which is rare compared to the number of thinks.
+	std::vector<CAnimEvent> events;
 
-	int index = 0;
+	GetAnimationEvents( flStart, flEnd, bAllowClientEvents, events );
 
-	while( ( index = GetAnimationEvent( event, flStart, flEnd, index, bAllowClientEvents ) ) != 0 )
+	for( const auto& event : events )
 	{
 		HandleAnimEvent( event );
 	}
@@ -235,10 +236,10 @@ int CStudioModelEntity::SetFrame( const int iFrame )
 	if( iFrame == -1 )
 		return static_cast<int>( m_flFrame );
 
-	if( !m_pModel )
+	if( !m_Model )
 		return 0;
 
-	mstudioseqdesc_t* pseqdesc = m_pModel->GetStudioHeader()->GetSequence( m_iSequence );
+	mstudioseqdesc_t* pseqdesc = m_Model->GetStudioHeader()->GetSequence( m_iSequence );
 
 	m_flFrame = static_cast<float>( iFrame );
 
@@ -257,24 +258,81 @@ int CStudioModelEntity::SetFrame( const int iFrame )
 	return static_cast<int>( m_flFrame );
 }
 
-void CStudioModelEntity::SetModel( studiomdl::CStudioModel* pModel )
+void CStudioModelEntity::SetModel( std::shared_ptr<studiomdl::CStudioModel> model )
+{
+	//Keep the settings that still apply to the new model, so a model can be replaced by a newer version of itself without starting over
+	std::vector<int> bodygroupValues;
+
+	if( m_Model )
+	{
+		for( int i = 0; i < m_Model->GetStudioHeader()->numbodyparts; ++i )
+		{
+			bodygroupValues.push_back( m_Model->GetBodygroupValue( i, m_iBodygroup ) );
+		}
+	}
+
+	m_Model = std::move( model );
+
+	//The new model can be at the address of the old one, so make sure the pose is evaluated anew
+	m_flPoseTime = -1;
+
+	m_iBodygroup = 0;
+
+	if( !m_Model )
+		return;
+
+	const studiohdr_t* const pStudioHdr = m_Model->GetStudioHeader();
+
+	if( m_iSequence >= pStudioHdr->numseq )
+	{
+		m_iSequence = 0;
+		m_flFrame = 0;
+		m_flLastEventCheck = 0;
+	}
+	else if( m_flFrame >= pStudioHdr->GetSequence( m_iSequence )->numframes )
+	{
+		m_flFrame = 0;
+		m_flLastEventCheck = 0;
+	}
+
+	for( size_t i = 0; i < bodygroupValues.size() && static_cast<int>( i ) < pStudioHdr->numbodyparts; ++i )
+	{
+		m_Model->CalculateBodygroup( static_cast<int>( i ), bodygroupValues[ i ], m_iBodygroup );
+	}
+
+	if( m_iSkin >= m_Model->GetTextureHeader()->numskinfamilies )
+	{
+		m_iSkin = 0;
+	}
+}
+
+studiomdl::CStudioModelPose& CStudioModelEntity::GetPose()
 {
-	//TODO: release old model.
-	m_pModel = pModel;
+	studiomdl::CModelRenderInfo renderInfo;
+
+	GetRenderInfo( renderInfo );
+
+	m_Pose.SetPose( renderInfo );
+
+	if( m_flPoseTime != WorldTime.GetCurrentTime() )
+	{
+		m_flPoseTime = WorldTime.GetCurrentTime();
+		m_Pose.Invalidate();
+	}
 
-	//TODO: reinit entity settings
+	return m_Pose;
 }
 
 int CStudioModelEntity::GetNumFrames() const
 {
-	const mstudioseqdesc_t* const pseqdesc = m_pModel->GetStudioHeader()->GetSequence( m_iSequence );
+	const mstudioseqdesc_t* const pseqdesc = m_Model->GetStudioHeader()->GetSequence( m_iSequence );
 
 	return pseqdesc->numframes;
 }
 
 int CStudioModelEntity::SetSequence( const int iSequence )
 {
-	if( iSequence > m_pModel->GetStudioHeader()->numseq )
+	if( iSequence > m_Model->GetStudioHeader()->numseq )
 		return m_iSequence;
 
 	m_iSequence = iSequence;
@@ -286,7 +344,7 @@ int CStudioModelEntity::SetSequence( const int iSequence )
 
 void CStudioModelEntity::GetSequenceInfo( float& flFrameRate, float& flGroundSpeed ) const
 {
-	const mstudioseqdesc_t* pseqdesc = m_pModel->GetStudioHeader()->GetSequence( m_iSequence );
+	const mstudioseqdesc_t* pseqdesc = m_Model->GetStudioHeader()->GetSequence( m_iSequence );
 
 	if( pseqdesc->numframes > 1 )
 	{
@@ -303,13 +361,13 @@ void CStudioModelEntity::GetSequenceInfo( float& flFrameRate, float& flGroundSpe
 
 int CStudioModelEntity::SetBodygroup( const int iBodygroup, const int iValue )
 {
-	if( !m_pModel )
+	if( !m_Model )
 		return 0;
 
-	if( iBodygroup > m_pModel->GetStudioHeader()->numbodyparts )
+	if( iBodygroup > m_Model->GetStudioHeader()->numbodyparts )
 		return -1;
 
-	if( m_pModel->CalculateBodygroup( iBodygroup, iValue, m_iBodygroup ) )
+	if( m_Model->CalculateBodygroup( iBodygroup, iValue, m_iBodygroup ) )
 		return iValue;
 
 	return -1;
@@ -317,10 +375,10 @@ int CStudioModelEntity::SetBodygroup( const int iBodygroup, const int iValue )
 
 int CStudioModelEntity::SetSkin( const int iSkin )
 {
-	if( !m_pModel )
+	if( !m_Model )
 		return 0;
 
-	if( iSkin < m_pModel->GetTextureHeader()->numskinfamilies )
+	if( iSkin < m_Model->GetTextureHeader()->numskinfamilies )
 	{
 		m_iSkin = iSkin;
 	}
@@ -337,13 +395,13 @@ byte CStudioModelEntity::GetControllerByIndex( const int iController ) const
 
 float CStudioModelEntity::GetControllerValue( const int iController ) const
 {
-	if( !m_pModel )
+	if( !m_Model )
 		return 0.0f;
 
 	if( iController < 0 || iController >= STUDIO_TOTAL_CONTROLLERS )
 		return 0;
 
-	const studiohdr_t* pStudioHdr = m_pModel->GetStudioHeader();
+	const studiohdr_t* pStudioHdr = m_Model->GetStudioHeader();
 
 	const mstudiobonecontroller_t* pbonecontroller = pStudioHdr->GetBoneControllers();
 
@@ -371,10 +429,10 @@ float CStudioModelEntity::GetControllerValue( const int iController ) const
 
 float CStudioModelEntity::SetController( const int iController, float flValue )
 {
-	if( !m_pModel )
+	if( !m_Model )
 		return 0.0f;
 
-	const studiohdr_t* pStudioHdr = m_pModel->GetStudioHeader();
+	const studiohdr_t* pStudioHdr = m_Model->GetStudioHeader();
 
 	const mstudiobonecontroller_t* pbonecontroller = pStudioHdr->GetBoneControllers();
 
@@ -426,10 +484,10 @@ float CStudioModelEntity::SetController( const int iController, float flValue )
 
 float CStudioModelEntity::SetMouth( float flValue )
 {
-	if( !m_pModel )
+	if( !m_Model )
 		return 0.0f;
 
-	const studiohdr_t* pStudioHdr = m_pModel->GetStudioHeader();
+	const studiohdr_t* pStudioHdr = m_Model->GetStudioHeader();
 
 	const mstudiobonecontroller_t* pbonecontroller = pStudioHdr->GetBoneControllers();
 
@@ -482,13 +540,13 @@ byte CStudioModelEntity::GetBlendingByIndex( const int iBlender ) const
 
 float CStudioModelEntity::GetBlendingValue( const int iBlender ) const
 {
-	if( !m_pModel )
+	if( !m_Model )
 		return 0.0f;
 
 	if( iBlender < 0 || iBlender >= STUDIO_MAX_BLENDERS )
 		return 0;
 
-	const studiohdr_t* pStudioHdr = m_pModel->GetStudioHeader();
+	const studiohdr_t* pStudioHdr = m_Model->GetStudioHeader();
 
 	const mstudioseqdesc_t* pseqdesc = pStudioHdr->GetSequence( m_iSequence );
 
@@ -500,13 +558,13 @@ float CStudioModelEntity::GetBlendingValue( const int iBlender ) const
 
 float CStudioModelEntity::SetBlending( const int iBlender, float flValue )
 {
-	if( !m_pModel )
+	if( !m_Model )
 		return 0.0f;
 
 	if( iBlender < 0 || iBlender >= STUDIO_MAX_BLENDERS )
 		return 0;
 
-	const studiohdr_t* pStudioHdr = m_pModel->GetStudioHeader();
+	const studiohdr_t* pStudioHdr = m_Model->GetStudioHeader();
 
 	const mstudioseqdesc_t* pseqdesc = pStudioHdr->GetSequence( m_iSequence );
 
@@ -541,7 +599,7 @@ float CStudioModelEntity::SetBlending( const int iBlender, float flValue )
 
 void CStudioModelEntity::ExtractBbox( glm::vec3& vecMins, glm::vec3& vecMaxs ) const
 {
-	const mstudioseqdesc_t* pseqdesc = m_pModel->GetStudioHeader()->GetSequence( m_iSequence );
+	const mstudioseqdesc_t* pseqdesc = m_Model->GetStudioHeader()->GetSequence( m_iSequence );
 
 	vecMins = pseqdesc->bbmin;
 	vecMaxs = pseqdesc->bbmax;
@@ -549,7 +607,7 @@ void CStudioModelEntity::ExtractBbox( glm::vec3& vecMins, glm::vec3& vecMaxs ) c
 
 mstudiomodel_t* CStudioModelEntity::GetModelByBodyPart( const int iBodyPart ) const
 {
-	return m_pModel->GetModelByBodyPart( m_iBodygroup, iBodyPart );
+	return m_Model->GetModelByBodyPart( m_iBodygroup, iBodyPart );
 }
 
 CStudioModelEntity::MeshList_t CStudioModelEntity::ComputeMeshList( const int iTexture ) const
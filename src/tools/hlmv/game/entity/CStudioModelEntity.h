@@ -1,9 +1,11 @@
 #ifndef GAME_CSTUDIOMODELENTITY_H
 #define GAME_CSTUDIOMODELENTITY_H
 
+#include <memory>
 #include <vector>
 
 #include "shared/studiomodel/CStudioModel.h"
+#include "shared/studiomodel/CStudioModelPose.h"
 
 #include "game/CAnimEvent.h"
 #include "game/Events.h"
@@ -45,15 +47,15 @@ public:
 	float	AdvanceFrame( float dt = 0.0f, const float flMax = -1.f );
 
 	/**
-	*	Gets an animation event for the current sequence for the given time range.
-	*	@param event Output. Event data.
+	*	Gets all animation events for the current sequence in the given range of frames, in frame order.
+	*	A negative start means the range has wrapped around the end of the sequence, events up to the end of the sequence are included as well.
 	*	@param flStart Start of the range of frames to check.
-	*	@param flEnd End of the range of frames to check.
-	*	@param index Event index to start checking at.
+	*	@param flEnd End of the range of frames to check, exclusive.
 	*	@param bAllowClientEvents Whether to process client events or not.
-	*	@return Next event index to use as the index parameter. If 0, no more events are left.
+	*	@param events Output. Events are appended to this list.
+	*	@return Number of events that were added.
 	*/
-	int		GetAnimationEvent( CAnimEvent& event, float flStart, float flEnd, int index, const bool bAllowClientEvents );
+	size_t	GetAnimationEvents( float flStart, float flEnd, const bool bAllowClientEvents, std::vector<CAnimEvent>& events ) const;
 
 	/**
 	*	Dispatches events for the current sequence and frame. This will dispatch events between the frame number during last call to DispatchAnimEvents and the current frame.
@@ -75,7 +77,16 @@ public:
 	int SetFrame( const int iFrame );
 
 private:
-	studiomdl::CStudioModel* m_pModel = nullptr;
+	/**
+	*	Fills in the render info from this entity's current state.
+	*/
+	void GetRenderInfo( studiomdl::CModelRenderInfo& renderInfo ) const;
+
+private:
+	/**
+	*	Shared with every other entity using the same model. Per-entity state is stored in this entity, not in the model.
+	*/
+	std::shared_ptr<studiomdl::CStudioModel> m_Model;
 
 	int		m_iSequence			= 0;				// sequence index
 	int		m_iBodygroup		= 0;				// bodypart selection	
@@ -89,16 +100,28 @@ private:
 
 	StudioLoopingMode m_LoopingMode = StudioLoopingMode::AlwaysLoop;
 
+	studiomdl::CStudioModelPose m_Pose;
+
+	float	m_flPoseTime		= -1;				//Time when the pose was last updated.
+
 public:
 	/**
 	*	Gets the model.
 	*/
-	studiomdl::CStudioModel* GetModel() const { return m_pModel; }
+	studiomdl::CStudioModel* GetModel() const { return m_Model.get(); }
+
+	/**
+	*	Sets the model. The previous model is released, and destroyed if nothing else uses it.
+	*	The sequence, frame, bodygroups and skin are kept if they exist in the new model. Controllers and blending are always kept.
+	*/
+	void SetModel( std::shared_ptr<studiomdl::CStudioModel> model );
 
 	/**
-	*	Sets the model.
+	*	Gets the pose for the entity's current state, as it will be drawn.
+	*	Bones evaluated earlier are reused for the rest of the frame, after which the pose is evaluated anew,
+	*	so edits made to the model's data show up on the next frame.
 	*/
-	void SetModel( studiomdl::CStudioModel* pModel );
+	studiomdl::CStudioModelPose& GetPose();
 
 	/**
 	*	Gets the number of frames that the current sequence has.
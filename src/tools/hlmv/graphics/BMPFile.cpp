@@ -1,5 +1,6 @@
 #include <cstdio>
 #include <cstring>
+#include <limits>
 #include <memory>
 
 #include "Palette.h"
@@ -56,7 +57,7 @@ bool SaveBMPFile( const char* const pszFilename, const int iWidth, const int iHe
 	}
 
 	infoHeader.biSize			= sizeof( infoHeader );
-	infoHeader.biWidth			= iDiskWidth;
+	infoHeader.biWidth			= iWidth;
 	infoHeader.biHeight			= iHeight;
 	infoHeader.biPlanes			= 1;
 	infoHeader.biBitCount		= 8;						//8 bit encoding.
@@ -111,5 +112,182 @@ bool SaveBMPFile( const char* const pszFilename, const int iWidth, const int iHe
 
 	return true;
 }
+
+bool SaveRGBBMPFile( const char* const pszFilename, const int iWidth, const int iHeight, const uint8_t* pPixels )
+{
+	if( !pszFilename || !( *pszFilename ) )
+		return false;
+
+	if( iWidth <= 0 || iHeight <= 0 )
+		return false;
+
+	if( !pPixels )
+		return false;
+
+	FILE* pFile = utf8_fopen( pszFilename, "wb" );
+
+	if( !pFile )
+		return false;
+
+	Header header;
+	InfoHeader infoHeader;
+
+	memset( &header, 0, sizeof( header ) );
+	memset( &infoHeader, 0, sizeof( infoHeader ) );
+
+	//Rows are padded to a multiple of 4 bytes.
+	const int32_t iDiskRowBytes = ( iWidth * 3 + 3 ) & ~3;
+
+	const int32_t iPixelsBytes = iDiskRowBytes * iHeight;
+
+	header.bfType		= BMP_TYPE_ID;
+
+	header.bfSize		= sizeof( Header ) + sizeof( InfoHeader ) + iPixelsBytes;
+	header.bfOffBits	= sizeof( Header ) + sizeof( InfoHeader );
+
+	if( fwrite( &header, sizeof( header ), 1, pFile ) != 1 )
+	{
+		fclose( pFile );
+		return false;
+	}
+
+	infoHeader.biSize			= sizeof( infoHeader );
+	infoHeader.biWidth			= iWidth;
+	infoHeader.biHeight			= iHeight;
+	infoHeader.biPlanes			= 1;
+	infoHeader.biBitCount		= 24;						//24 bit encoding.
+	infoHeader.biCompression	= COMPRESSION_RGB;			//Uncompressed.
+
+	if( fwrite( &infoHeader, sizeof( infoHeader ), 1, pFile ) != 1 )
+	{
+		fclose( pFile );
+		return false;
+	}
+
+	std::unique_ptr<uint8_t[]> pixels = std::make_unique<uint8_t[]>( iPixelsBytes );
+
+	memset( pixels.get(), 0, iPixelsBytes );
+
+	//Flip the image vertically and store the channels as BGR.
+	for( int iRow = 0; iRow < iHeight; ++iRow )
+	{
+		const uint8_t* pSrcData = pPixels + static_cast<size_t>( iHeight - 1 - iRow ) * iWidth * 3;
+		uint8_t* pDestData = pixels.get() + static_cast<size_t>( iDiskRowBytes ) * iRow;
+
+		for( int iColumn = 0; iColumn < iWidth; ++iColumn, pSrcData += 3, pDestData += 3 )
+		{
+			pDestData[ 0 ] = pSrcData[ 2 ];
+			pDestData[ 1 ] = pSrcData[ 1 ];
+			pDestData[ 2 ] = pSrcData[ 0 ];
+		}
+	}
+
+	if( fwrite( pixels.get(), iPixelsBytes, 1, pFile ) != 1 )
+	{
+		fclose( pFile );
+		return false;
+	}
+
+	fclose( pFile );
+
+	return true;
+}
+
+bool LoadBMPFile( const char* const pszFilename, int& iWidth, int& iHeight, std::vector<uint8_t>& pixels, uint8_t* pPalette )
+{
+	if( !pszFilename || !( *pszFilename ) || !pPalette )
+		return false;
+
+	FILE* pFile = utf8_fopen( pszFilename, "rb" );
+
+	if( !pFile )
+		return false;
+
+	Header header;
+	InfoHeader infoHeader;
+
+	if( fread( &header, sizeof( header ), 1, pFile ) != 1
+		|| fread( &infoHeader, sizeof( infoHeader ), 1, pFile ) != 1
+		|| header.bfType != BMP_TYPE_ID
+		|| infoHeader.biSize < sizeof( infoHeader )
+		|| infoHeader.biBitCount != 8
+		|| infoHeader.biCompression != COMPRESSION_RGB
+		|| infoHeader.biWidth <= 0
+		|| infoHeader.biHeight == 0
+		|| infoHeader.biHeight == std::numeric_limits<int32_t>::min()
+		|| infoHeader.biClrUsed > PALETTE_ENTRIES )
+	{
+		fclose( pFile );
+		return false;
+	}
+
+	//A negative height means the rows are stored top first.
+	const bool bTopDown = infoHeader.biHeight < 0;
+
+	iWidth = infoHeader.biWidth;
+	iHeight = bTopDown ? -infoHeader.biHeight : infoHeader.biHeight;
+
+	const size_t uiColors = infoHeader.biClrUsed ? infoHeader.biClrUsed : PALETTE_ENTRIES;
+
+	RGBQuad palette[ PALETTE_ENTRIES ];
+
+	//The palette follows the info header, which can be larger than the version we know.
+	if( fseek( pFile, sizeof( Header ) + infoHeader.biSize, SEEK_SET ) != 0
+		|| fread( palette, sizeof( RGBQuad ), uiColors, pFile ) != uiColors )
+	{
+		fclose( pFile );
+		return false;
+	}
+
+	memset( pPalette, 0, PALETTE_SIZE );
+
+	for( size_t uiIndex = 0; uiIndex < uiColors; ++uiIndex, pPalette += 3 )
+	{
+		pPalette[ 0 ] = palette[ uiIndex ].rgbRed;
+		pPalette[ 1 ] = palette[ uiIndex ].rgbGreen;
+		pPalette[ 2 ] = palette[ uiIndex ].rgbBlue;
+	}
+
+	const size_t uiDiskWidth = ( static_cast<size_t>( iWidth ) + 3 ) & ~3;
+
+	//Make sure the pixels fit in the file before allocating room for them, so a corrupt header can't ask for huge amounts of memory.
+	if( fseek( pFile, 0, SEEK_END ) != 0 )
+	{
+		fclose( pFile );
+		return false;
+	}
+
+	const long iFileSize = ftell( pFile );
+
+	if( iFileSize < 0
+		|| header.bfOffBits > static_cast<unsigned long>( iFileSize )
+		|| static_cast<size_t>( iHeight ) > ( static_cast<size_t>( iFileSize ) - header.bfOffBits ) / uiDiskWidth )
+	{
+		fclose( pFile );
+		return false;
+	}
+
+	std::vector<uint8_t> diskPixels( uiDiskWidth * iHeight );
+
+	if( fseek( pFile, header.bfOffBits, SEEK_SET ) != 0
+		|| fread( diskPixels.data(), diskPixels.size(), 1, pFile ) != 1 )
+	{
+		fclose( pFile );
+		return false;
+	}
+
+	fclose( pFile );
+
+	pixels.resize( static_cast<size_t>( iWidth ) * iHeight );
+
+	for( int iRow = 0; iRow < iHeight; ++iRow )
+	{
+		const int iDiskRow = bTopDown ? iRow : iHeight - 1 - iRow;
+
+		memcpy( pixels.data() + static_cast<size_t>( iRow ) * iWidth, diskPixels.data() + uiDiskWidth * iDiskRow, iWidth );
+	}
+
+	return true;
+}
 }
 }
\ No newline at end of file
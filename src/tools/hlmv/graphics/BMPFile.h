@@ -2,15 +2,14 @@
 #define GRAPHICS_BMPFILE_H
 
 #include <cstdint>
+#include <vector>
 
 namespace graphics
 {
 namespace bmpfile
 {
-//Required because the header is not aligned to > 2 bytes. TODO: figure out if other platforms need anything.
-#ifdef WIN32
-#include <pshpack2.h>
-#endif
+//Required because the header is not aligned to > 2 bytes.
+#pragma pack( push, 2 )
 
 struct Header final
 {
@@ -44,9 +43,7 @@ struct RGBQuad final
 	uint8_t rgbReserved;
 };
 
-#ifdef WIN32
-#include <poppack.h>
-#endif
+#pragma pack( pop )
 
 #define BMP_TYPE_ID 0x4D42
 
@@ -65,6 +62,27 @@ enum Compression
 *	@return true on success, false otherwise.
 */
 bool SaveBMPFile( const char* const pszFilename, const int iWidth, const int iHeight, const uint8_t* pPixels, const uint8_t* pPalette );
+
+/**
+*	Saves a 24 bit BMP file. Does not use any global state, so it can be called from any thread.
+*	@param pszFilename Filename to save to.
+*	@param iWidth Width of the image.
+*	@param iHeight Height of the image.
+*	@param pPixels Array of pixels, top row first. Must be iWidth * iHeight * 3 bytes in size, each pixel being 3 bytes (RGB 8 bit)
+*	@return true on success, false otherwise.
+*/
+bool SaveRGBBMPFile( const char* const pszFilename, const int iWidth, const int iHeight, const uint8_t* pPixels );
+
+/**
+*	Loads an uncompressed 8 bit BMP file. Does not use any global state, so it can be called from any thread.
+*	@param pszFilename Filename to load from.
+*	@param iWidth Width of the image.
+*	@param iHeight Height of the image.
+*	@param pixels Receives iWidth * iHeight palette indices, top row first.
+*	@param pPalette Receives 256 colors, each entry being 3 bytes (RGB 8 bit). Colors that the file does not have are black.
+*	@return true on success, false if the file could not be read or is not an uncompressed 8 bit BMP.
+*/
+bool LoadBMPFile( const char* const pszFilename, int& iWidth, int& iHeight, std::vector<uint8_t>& pixels, uint8_t* pPalette );
 }
 }
 
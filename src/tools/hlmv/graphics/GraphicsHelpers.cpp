@@ -6,11 +6,15 @@
 
 #include "utility/Color.h"
 
+#include "shared/renderer/IRenderContext.h"
 #include "shared/renderer/studiomodel/IStudioModelRenderer.h"
 
+#include "engine/renderer/gl/CBaseGLRenderContext.h"
+
 #include "GraphicsHelpers.h"
 
 //TODO: remove
+extern renderer::IRenderContext* g_pRenderContext;
 extern studiomdl::IStudioModelRenderer* g_pStudioMdlRenderer;
 
 namespace graphics
@@ -26,10 +30,10 @@ void SetupRenderMode( RenderMode renderMode, const bool bBackfaceCulling )
 	{
 	case RenderMode::WIREFRAME:
 		{
-			glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
-			glDisable( GL_TEXTURE_2D );
-			glDisable( GL_CULL_FACE );
-			glEnable( GL_DEPTH_TEST );
+			g_pRenderContext->SetPolygonMode( renderer::PolygonMode::LINE );
+			g_pRenderContext->Disable( renderer::Capability::TEXTURE_2D );
+			g_pRenderContext->Disable( renderer::Capability::CULL_FACE );
+			g_pRenderContext->Enable( renderer::Capability::DEPTH_TEST );
 
 			break;
 		}
@@ -37,44 +41,44 @@ void SetupRenderMode( RenderMode renderMode, const bool bBackfaceCulling )
 	case RenderMode::FLAT_SHADED:
 	case RenderMode::SMOOTH_SHADED:
 		{
-			glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
-			glDisable( GL_TEXTURE_2D );
+			g_pRenderContext->SetPolygonMode( renderer::PolygonMode::FILL );
+			g_pRenderContext->Disable( renderer::Capability::TEXTURE_2D );
 
 			if( bBackfaceCulling )
 			{
-				glEnable( GL_CULL_FACE );
+				g_pRenderContext->Enable( renderer::Capability::CULL_FACE );
 			}
 			else
 			{
-				glDisable( GL_CULL_FACE );
+				g_pRenderContext->Disable( renderer::Capability::CULL_FACE );
 			}
 
-			glEnable( GL_DEPTH_TEST );
+			g_pRenderContext->Enable( renderer::Capability::DEPTH_TEST );
 
 			if( renderMode == RenderMode::FLAT_SHADED )
-				glShadeModel( GL_FLAT );
+				g_pRenderContext->SetShadeModel( renderer::ShadeModel::FLAT );
 			else
-				glShadeModel( GL_SMOOTH );
+				g_pRenderContext->SetShadeModel( renderer::ShadeModel::SMOOTH );
 
 			break;
 		}
 
 	case RenderMode::TEXTURE_SHADED:
 		{
-			glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
-			glEnable( GL_TEXTURE_2D );
+			g_pRenderContext->SetPolygonMode( renderer::PolygonMode::FILL );
+			g_pRenderContext->Enable( renderer::Capability::TEXTURE_2D );
 
 			if( bBackfaceCulling )
 			{
-				glEnable( GL_CULL_FACE );
+				g_pRenderContext->Enable( renderer::Capability::CULL_FACE );
 			}
 			else
 			{
-				glDisable( GL_CULL_FACE );
+				g_pRenderContext->Disable( renderer::Capability::CULL_FACE );
 			}
 
-			glEnable( GL_DEPTH_TEST );
-			glShadeModel( GL_SMOOTH );
+			g_pRenderContext->Enable( renderer::Capability::DEPTH_TEST );
+			g_pRenderContext->SetShadeModel( renderer::ShadeModel::SMOOTH );
 
 			break;
 		}
@@ -87,76 +91,74 @@ void SetupRenderMode( RenderMode renderMode, const bool bBackfaceCulling )
 	}
 }
 
-void DrawFloorQuad( float flSideLength )
+void DrawFloorQuad( float flSideLength, const glm::vec4& color )
 {
 	flSideLength = std::abs( flSideLength );
 
-	glBegin( GL_TRIANGLE_STRIP );
-	glTexCoord2f( 0.0f, 0.0f );
-	glVertex3f( -flSideLength, flSideLength, 0.0f );
-
-	glTexCoord2f( 0.0f, 1.0f );
-	glVertex3f( -flSideLength, -flSideLength, 0.0f );
-
-	glTexCoord2f( 1.0f, 0.0f );
-	glVertex3f( flSideLength, flSideLength, 0.0f );
-
-	glTexCoord2f( 1.0f, 1.0f );
-	glVertex3f( flSideLength, -flSideLength, 0.0f );
+	const renderer::Vertex vertices[] =
+	{
+		{ { -flSideLength, flSideLength, 0.0f }, { 0.0f, 0.0f }, color },
+		{ { -flSideLength, -flSideLength, 0.0f }, { 0.0f, 1.0f }, color },
+		{ { flSideLength, flSideLength, 0.0f }, { 1.0f, 0.0f }, color },
+		{ { flSideLength, -flSideLength, 0.0f }, { 1.0f, 1.0f }, color }
+	};
 
-	glEnd();
+	g_pRenderContext->DrawVertices( renderer::PrimitiveType::TRIANGLE_STRIP, vertices, ARRAYSIZE( vertices ) );
+	g_pRenderContext->Flush();
 }
 
 void DrawFloor( float flSideLength, GLuint groundTexture, const Color& groundColor, const bool bMirror )
 {
-	glCullFace( GL_FRONT );
+	g_pRenderContext->SetCullFace( renderer::CullFace::FRONT );
 
-	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
-	glEnable( GL_DEPTH_TEST );
-	glEnable( GL_CULL_FACE );
+	g_pRenderContext->SetPolygonMode( renderer::PolygonMode::FILL );
+	g_pRenderContext->Enable( renderer::Capability::DEPTH_TEST );
+	g_pRenderContext->Enable( renderer::Capability::CULL_FACE );
 
 	if( bMirror )
 		glFrontFace( GL_CW );
 	else
-		glDisable( GL_CULL_FACE );
+		g_pRenderContext->Disable( renderer::Capability::CULL_FACE );
+
+	g_pRenderContext->Enable( renderer::Capability::BLEND );
+
+	glm::vec4 color;
 
-	glEnable( GL_BLEND );
 	if( groundTexture == GL_INVALID_TEXTURE_ID )
 	{
-		glDisable( GL_TEXTURE_2D );
-		glColor4f( groundColor[ 0 ] / 255.0f, groundColor[ 1 ] / 255.0f, groundColor[ 2 ] / 255.0f, 0.7f );
-		glBindTexture( GL_TEXTURE_2D, 0 );
+		g_pRenderContext->Disable( renderer::Capability::TEXTURE_2D );
+		color = glm::vec4{ groundColor[ 0 ] / 255.0f, groundColor[ 1 ] / 255.0f, groundColor[ 2 ] / 255.0f, 0.7f };
+		g_pRenderContext->BindTexture( NULL_TEXTURE_HANDLE );
 	}
 	else
 	{
-		glEnable( GL_TEXTURE_2D );
-		glColor4f( 1.0f, 1.0f, 1.0f, 0.6f );
-		glBindTexture( GL_TEXTURE_2D, groundTexture );
+		g_pRenderContext->Enable( renderer::Capability::TEXTURE_2D );
+		color = glm::vec4{ 1.0f, 1.0f, 1.0f, 0.6f };
+		g_pRenderContext->BindTexture( renderer::GLToTexHandle( groundTexture ) );
 	}
 
-	glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+	g_pRenderContext->SetBlendFunc( renderer::BlendFactor::SRC_ALPHA, renderer::BlendFactor::ONE_MINUS_SRC_ALPHA );
 
-	graphics::helpers::DrawFloorQuad( flSideLength );
+	graphics::helpers::DrawFloorQuad( flSideLength, color );
 
-	glDisable( GL_BLEND );
+	g_pRenderContext->Disable( renderer::Capability::BLEND );
 
 	if( bMirror )
 	{
-		glCullFace( GL_BACK );
-		glColor4f( 0.1f, 0.1f, 0.1f, 1.0f );
-		glBindTexture( GL_TEXTURE_2D, 0 );
-		graphics::helpers::DrawFloorQuad( flSideLength );
+		g_pRenderContext->SetCullFace( renderer::CullFace::BACK );
+		g_pRenderContext->BindTexture( NULL_TEXTURE_HANDLE );
+		graphics::helpers::DrawFloorQuad( flSideLength, glm::vec4{ 0.1f, 0.1f, 0.1f, 1.0f } );
 
 		glFrontFace( GL_CCW );
 	}
 	else
-		glEnable( GL_CULL_FACE );
+		g_pRenderContext->Enable( renderer::Capability::CULL_FACE );
 }
 
 unsigned int DrawMirroredModel( CStudioModelEntity* pEntity, const RenderMode renderMode, const bool bWireframeOverlay, const float flSideLength, const bool bBackfaceCulling )
 {
 	/* Don't update color or depth. */
-	glDisable( GL_DEPTH_TEST );
+	g_pRenderContext->Disable( renderer::Capability::DEPTH_TEST );
 	glColorMask( GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE );
 
 	/* Draw 1 into the stencil buffer. */
@@ -165,11 +167,11 @@ unsigned int DrawMirroredModel( CStudioModelEntity* pEntity, const RenderMode re
 	glStencilFunc( GL_ALWAYS, 1, 0xffffffff );
 
 	/* Now render floor; floor pixels just get their stencil set to 1. */
-	graphics::helpers::DrawFloorQuad( flSideLength );
+	graphics::helpers::DrawFloorQuad( flSideLength, glm::vec4{ 1.0f } );
 
 	/* Re-enable update of color and depth. */
 	glColorMask( GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE );
-	glEnable( GL_DEPTH_TEST );
+	g_pRenderContext->Enable( renderer::Capability::DEPTH_TEST );
 
 	/* Now, only render where stencil is set to 1. */
 	glStencilFunc( GL_EQUAL, 1, 0xffffffff );  /* draw if ==1 */
@@ -179,7 +181,7 @@ unsigned int DrawMirroredModel( CStudioModelEntity* pEntity, const RenderMode re
 
 	glPushMatrix();
 	glScalef( 1, 1, -1 );
-	glCullFace( GL_BACK );
+	g_pRenderContext->SetCullFace( renderer::CullFace::BACK );
 	SetupRenderMode( renderMode, bBackfaceCulling );
 
 	glEnable( GL_CLIP_PLANE0 );
@@ -202,7 +204,7 @@ unsigned int DrawMirroredModel( CStudioModelEntity* pEntity, const RenderMode re
 	//Determine if an odd number of scale values are negative. The cull face has to be changed if so.
 	const float flScale = vecScale.x * vecScale.y * vecScale.z;
 
-	glCullFace( flScale > 0 ? GL_BACK : GL_FRONT );
+	g_pRenderContext->SetCullFace( flScale > 0 ? renderer::CullFace::BACK : renderer::CullFace::FRONT );
 
 	const unsigned int uiOldPolys = g_pStudioMdlRenderer->GetDrawnPolygonsCount();
 
@@ -24,8 +24,9 @@ void SetupRenderMode( RenderMode renderMode, const bool bBackfaceCulling );
 /**
 *	Draws a floor quad.
 *	@param flSideLength Length of one side of the floor
+*	@param color Color of the floor
 */
-void DrawFloorQuad( float flSideLength );
+void DrawFloorQuad( float flSideLength, const glm::vec4& color );
 
 /**
 *	Draws a floor, optionally with a texture.
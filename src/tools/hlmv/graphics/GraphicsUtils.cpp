@@ -9,6 +9,8 @@
 
 #include "shared/studiomodel/studio.h"
 
+#include "engine/renderer/gl/CBaseGLRenderContext.h"
+
 #include "GraphicsUtils.h"
 #include "Palette.h"
 
@@ -75,12 +77,12 @@ void FlipImageVertically( const int iWidth, const int iHeight, byte* const pData
 	}
 }
 
-void DrawBackground( GLuint backgroundTexture )
+void DrawBackground( renderer::IRenderContext* pRenderContext, GLuint backgroundTexture )
 {
 	if( backgroundTexture == GL_INVALID_TEXTURE_ID )
 		return;
 
-	glDisable(GL_BLEND);
+	pRenderContext->Disable(renderer::Capability::BLEND);
 
 	glMatrixMode( GL_PROJECTION );
 	glLoadIdentity();
@@ -91,34 +93,30 @@ void DrawBackground( GLuint backgroundTexture )
 	glPushMatrix();
 	glLoadIdentity();
 
-	glDisable( GL_CULL_FACE );
-	glEnable( GL_TEXTURE_2D );
-
-	glColor4f( 1.0f, 1.0f, 1.0f, 1.0f );
-	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
-
-	glBindTexture( GL_TEXTURE_2D, backgroundTexture );
+	pRenderContext->Disable( renderer::Capability::CULL_FACE );
+	pRenderContext->Enable( renderer::Capability::TEXTURE_2D );
 
-	glBegin( GL_TRIANGLE_STRIP );
+	pRenderContext->SetPolygonMode( renderer::PolygonMode::FILL );
 
-	glTexCoord2f( 0, 0 );
-	glVertex2f( 0, 0 );
+	pRenderContext->BindTexture( renderer::GLToTexHandle( backgroundTexture ) );
 
-	glTexCoord2f( 1, 0 );
-	glVertex2f( 1, 0 );
+	const glm::vec4 white{ 1.0f };
 
-	glTexCoord2f( 0, 1 );
-	glVertex2f( 0, 1 );
-
-	glTexCoord2f( 1, 1 );
-	glVertex2f( 1, 1 );
+	const renderer::Vertex vertices[] =
+	{
+		{ { 0, 0, 0 }, { 0, 0 }, white },
+		{ { 1, 0, 0 }, { 1, 0 }, white },
+		{ { 0, 1, 0 }, { 0, 1 }, white },
+		{ { 1, 1, 0 }, { 1, 1 }, white }
+	};
 
-	glEnd();
+	pRenderContext->DrawVertices( renderer::PrimitiveType::TRIANGLE_STRIP, vertices, ARRAYSIZE( vertices ) );
+	pRenderContext->Flush();
 
 	glPopMatrix();
 
 	glClear( GL_DEPTH_BUFFER_BIT );
-	glBindTexture( GL_TEXTURE_2D, 0 );
+	pRenderContext->BindTexture( NULL_TEXTURE_HANDLE );
 }
 
 void SetProjection( const float flFOV, const int iWidth, const int iHeight )
@@ -128,28 +126,18 @@ void SetProjection( const float flFOV, const int iWidth, const int iHeight )
 	gluPerspective( flFOV, ( GLfloat ) iWidth / ( GLfloat ) iHeight, 1.0f, 1 << 24 );
 }
 
-void DrawBox( const glm::vec3* const v )
+void DrawBox( renderer::IRenderContext* pRenderContext, const glm::vec3* const v )
 {
-	glBegin( GL_QUAD_STRIP );
-	for( int i = 0; i < 10; ++i )
-	{
-		glVertex3fv( glm::value_ptr( v[ i & 7 ] ) );
-	}
-	glEnd();
-
-	glBegin( GL_QUAD_STRIP );
-	glVertex3fv( glm::value_ptr( v[ 6 ] ) );
-	glVertex3fv( glm::value_ptr( v[ 0 ] ) );
-	glVertex3fv( glm::value_ptr( v[ 4 ] ) );
-	glVertex3fv( glm::value_ptr( v[ 2 ] ) );
-	glEnd();
-
-	glBegin( GL_QUAD_STRIP );
-	glVertex3fv( glm::value_ptr( v[ 1 ] ) );
-	glVertex3fv( glm::value_ptr( v[ 7 ] ) );
-	glVertex3fv( glm::value_ptr( v[ 3 ] ) );
-	glVertex3fv( glm::value_ptr( v[ 5 ] ) );
-	glEnd();
+	//The sides, then the two ends.
+	static const unsigned short SIDES[] = { 0, 1, 2, 3, 4, 5, 6, 7, 0, 1 };
+	static const unsigned short FIRST_END[] = { 6, 0, 4, 2 };
+	static const unsigned short SECOND_END[] = { 1, 7, 3, 5 };
+
+	pRenderContext->DrawPositions( renderer::PrimitiveType::QUAD_STRIP, v, SIDES, ARRAYSIZE( SIDES ) );
+	pRenderContext->DrawPositions( renderer::PrimitiveType::QUAD_STRIP, v, FIRST_END, ARRAYSIZE( FIRST_END ) );
+	pRenderContext->DrawPositions( renderer::PrimitiveType::QUAD_STRIP, v, SECOND_END, ARRAYSIZE( SECOND_END ) );
+
+	pRenderContext->Flush();
 }
 
 const std::string_view DmBaseName{"DM_Base.bmp"};
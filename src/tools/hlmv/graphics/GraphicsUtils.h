@@ -8,6 +8,8 @@
 
 #include "shared/Const.h"
 
+#include "shared/renderer/IRenderContext.h"
+
 #include "OpenGL.h"
 
 namespace graphics
@@ -33,9 +35,10 @@ void FlipImageVertically( const int iWidth, const int iHeight, byte* const pData
 
 /**
 *	Draws a background texture, fitted to the viewport.
+*	@param pRenderContext Context that state changes are made through
 *	@param backgroundTexture OpenGL texture id that represents the background texture
 */
-void DrawBackground( GLuint backgroundTexture );
+void DrawBackground( renderer::IRenderContext* pRenderContext, GLuint backgroundTexture );
 
 /**
 *	Sets the projection matrix to the default perspective settings.
@@ -48,7 +51,7 @@ void SetProjection( const float flFOV, const int iWidth, const int iHeight );
 /**
 *	Draws a box using an array of 8 vectors as corner points.
 */
-void DrawBox( const glm::vec3* const v );
+void DrawBox( renderer::IRenderContext* pRenderContext, const glm::vec3* const v );
 
 /**
 *	@brief Tests if the given filename is a remap name, and returns the remap ranges if so
@@ -0,0 +1,686 @@
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "engine/shared/activity.h"
+
+#include "shared/studiomodel/CStudioModel.h"
+
+#include "ModelInfo.h"
+
+namespace modelinfo
+{
+namespace
+{
+struct FlagName
+{
+	int Flag;
+	const char* Name;
+};
+
+const FlagName MODEL_FLAGS[] =
+{
+	{EF_ROCKET, "rocket"},
+	{EF_GRENADE, "grenade"},
+	{EF_GIB, "gib"},
+	{EF_ROTATE, "rotate"},
+	{EF_TRACER, "tracer"},
+	{EF_ZOMGIB, "zombieGib"},
+	{EF_TRACER2, "tracer2"},
+	{EF_TRACER3, "tracer3"},
+	{EF_NOSHADELIGHT, "noShadeLight"},
+	{EF_HITBOXCOLLISIONS, "hitboxCollisions"},
+	{EF_FORCESKYLIGHT, "forceSkyLight"}
+};
+
+const FlagName TEXTURE_FLAGS[] =
+{
+	{STUDIO_NF_FLATSHADE, "flatShade"},
+	{STUDIO_NF_CHROME, "chrome"},
+	{STUDIO_NF_FULLBRIGHT, "fullbright"},
+	{STUDIO_NF_NOMIPS, "noMips"},
+	{STUDIO_NF_ALPHA, "alpha"},
+	{STUDIO_NF_ADDITIVE, "additive"},
+	{STUDIO_NF_MASKED, "masked"}
+};
+
+/**
+*	Unicode code points of the Windows-1252 characters 0x80 to 0x9F. The rest of the code page matches Latin-1.
+*	Unassigned characters map to themselves.
+*/
+const unsigned short WINDOWS_1252_HIGH[32] =
+{
+	0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021, 0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+	0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014, 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178
+};
+
+const char* GetActivityName(const int activity)
+{
+	for (const activity_map_t* pEntry = activity_map; pEntry->name; ++pEntry)
+	{
+		if (pEntry->type == activity)
+		{
+			return pEntry->name;
+		}
+	}
+
+	return nullptr;
+}
+
+/**
+*	Appends JSON values to a string, keeping track of the separators between them.
+*/
+class CJSONWriter final
+{
+public:
+	explicit CJSONWriter(std::string& output)
+		: m_Output(output)
+	{
+	}
+
+	void BeginObject(const char* pszKey = nullptr)
+	{
+		Prefix(pszKey);
+		m_Output += '{';
+		m_bFirst = true;
+	}
+
+	void EndObject()
+	{
+		m_Output += '}';
+		m_bFirst = false;
+	}
+
+	void BeginArray(const char* pszKey = nullptr)
+	{
+		Prefix(pszKey);
+		m_Output += '[';
+		m_bFirst = true;
+	}
+
+	void EndArray()
+	{
+		m_Output += ']';
+		m_bFirst = false;
+	}
+
+	void String(const char* pszKey, const char* pszValue)
+	{
+		Prefix(pszKey);
+		AppendString(pszValue, SIZE_MAX, false);
+	}
+
+	/**
+	*	@brief Writes a name stored in a model file, converting it from Windows-1252 to UTF-8
+	*	@param maxLength Size of the name's buffer. Names in model files are not always null terminated
+	*/
+	void Name(const char* pszKey, const char* pszValue, const size_t maxLength)
+	{
+		Prefix(pszKey);
+		AppendString(pszValue, maxLength, true);
+	}
+
+	void Int(const char* pszKey, const long long value)
+	{
+		Prefix(pszKey);
+		m_Output += std::to_string(value);
+	}
+
+	void Bool(const char* pszKey, const bool bValue)
+	{
+		Prefix(pszKey);
+		m_Output += bValue ? "true" : "false";
+	}
+
+	void Null(const char* pszKey)
+	{
+		Prefix(pszKey);
+		m_Output += "null";
+	}
+
+	void Float(const char* pszKey, const float flValue)
+	{
+		//JSON has no representation for these
+		if (!std::isfinite(flValue))
+		{
+			Null(pszKey);
+			return;
+		}
+
+		Prefix(pszKey);
+
+		//Shortest text that reads back as the exact same float
+		char szBuffer[32];
+
+		const auto result = std::to_chars(szBuffer, szBuffer + sizeof(szBuffer), flValue);
+
+		m_Output.append(szBuffer, result.ptr);
+	}
+
+	void Vector(const char* pszKey, const glm::vec3& value)
+	{
+		BeginArray(pszKey);
+		Float(nullptr, value.x);
+		Float(nullptr, value.y);
+		Float(nullptr, value.z);
+		EndArray();
+	}
+
+	void Flags(const char* pszKey, const int flags, const FlagName* pNames, const size_t numNames)
+	{
+		BeginArray(pszKey);
+
+		for (size_t i = 0; i < numNames; ++i)
+		{
+			if (flags & pNames[i].Flag)
+			{
+				String(nullptr, pNames[i].Name);
+			}
+		}
+
+		EndArray();
+	}
+
+private:
+	void Prefix(const char* pszKey)
+	{
+		if (!m_bFirst)
+		{
+			m_Output += ',';
+		}
+
+		m_bFirst = false;
+
+		if (pszKey)
+		{
+			AppendString(pszKey, SIZE_MAX, false);
+			m_Output += ':';
+		}
+	}
+
+	void AppendString(const char* pszString, const size_t maxLength, const bool bConvertFromWindows1252)
+	{
+		m_Output += '"';
+
+		for (size_t i = 0; i < maxLength && pszString[i]; ++i)
+		{
+			const auto c = static_cast<unsigned char>(pszString[i]);
+
+			if (c == '"' || c == '\\')
+			{
+				m_Output += '\\';
+				m_Output += static_cast<char>(c);
+			}
+			else if (c < ' ')
+			{
+				char szEscape[8];
+
+				snprintf(szEscape, sizeof(szEscape), "\\u%04x", c);
+
+				m_Output += szEscape;
+			}
+			else if (c < 0x80 || !bConvertFromWindows1252)
+			{
+				m_Output += static_cast<char>(c);
+			}
+			else
+			{
+				AppendUTF8(c < 0xA0 ? WINDOWS_1252_HIGH[c - 0x80] : c);
+			}
+		}
+
+		m_Output += '"';
+	}
+
+	void AppendUTF8(const unsigned int codePoint)
+	{
+		if (codePoint < 0x800)
+		{
+			m_Output += static_cast<char>(0xC0 | (codePoint >> 6));
+		}
+		else
+		{
+			m_Output += static_cast<char>(0xE0 | (codePoint >> 12));
+			m_Output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		}
+
+		m_Output += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+
+private:
+	std::string& m_Output;
+
+	bool m_bFirst = true;
+};
+
+/**
+*	A model file in memory. Tables are checked against the size of the file before they are accessed.
+*/
+class CModelFile final
+{
+public:
+	explicit CModelFile(const std::filesystem::path& fileName)
+	{
+		std::ifstream stream(fileName, std::ios::binary | std::ios::ate);
+
+		if (!stream)
+		{
+			throw studiomdl::StudioModelNotFound("File \"" + fileName.u8string() + "\" not found");
+		}
+
+		const auto size = static_cast<std::streamoff>(stream.tellg());
+
+		//Sequence group headers are smaller than main headers, so only the id and version are checked here
+		if (size < static_cast<std::streamoff>(sizeof(int) * 2))
+		{
+			throw studiomdl::StudioModelInvalidFormat("File \"" + fileName.u8string() + "\" is too small to be a studio model");
+		}
+
+		m_Data.resize(static_cast<size_t>(size));
+
+		stream.seekg(0);
+
+		if (!stream.read(reinterpret_cast<char*>(m_Data.data()), size))
+		{
+			throw studiomdl::StudioModelInvalidFormat("Error reading file \"" + fileName.u8string() + "\"");
+		}
+
+		const auto& header = GetHeader();
+
+		if (strncmp(reinterpret_cast<const char*>(&header.id), STUDIOMDL_HDR_ID, 4) &&
+			strncmp(reinterpret_cast<const char*>(&header.id), STUDIOMDL_SEQ_ID, 4))
+		{
+			throw studiomdl::StudioModelInvalidFormat("The file \"" + fileName.u8string() + "\" is neither a studio header nor a sequence header");
+		}
+
+		if (header.version != STUDIO_VERSION)
+		{
+			throw studiomdl::StudioModelVersionDiffers("File \"" + fileName.u8string() + "\": version differs: expected \"" +
+				std::to_string(STUDIO_VERSION) + "\", got \"" + std::to_string(header.version) + "\"", header.version);
+		}
+
+		if (!IsSequenceGroup() && m_Data.size() < sizeof(studiohdr_t))
+		{
+			throw studiomdl::StudioModelInvalidFormat("File \"" + fileName.u8string() + "\" is too small to be a studio model");
+		}
+	}
+
+	size_t GetSize() const { return m_Data.size(); }
+
+	const studiohdr_t& GetHeader() const { return *reinterpret_cast<const studiohdr_t*>(m_Data.data()); }
+
+	bool IsSequenceGroup() const
+	{
+		return !strncmp(reinterpret_cast<const char*>(&GetHeader().id), STUDIOMDL_SEQ_ID, 4);
+	}
+
+	/**
+	*	@exception studiomdl::StudioModelInvalidFormat If the table does not fit in the file
+	*/
+	template<typename T>
+	const T* GetTable(const int offset, const int count, const char* pszTable) const
+	{
+		if (offset < 0 || count < 0 || static_cast<size_t>(offset) > m_Data.size()
+			|| (m_Data.size() - offset) / sizeof(T) < static_cast<size_t>(count))
+		{
+			throw studiomdl::StudioModelInvalidFormat(std::string{"The "} + pszTable + " table is outside of the file");
+		}
+
+		return reinterpret_cast<const T*>(m_Data.data() + offset);
+	}
+
+private:
+	std::vector<byte> m_Data;
+};
+
+void WriteBones(CJSONWriter& writer, const CModelFile& file)
+{
+	const auto& header = file.GetHeader();
+
+	const auto pBones = file.GetTable<mstudiobone_t>(header.boneindex, header.numbones, "bone");
+
+	writer.BeginArray("bones");
+
+	for (int i = 0; i < header.numbones; ++i)
+	{
+		const auto& bone = pBones[i];
+
+		writer.BeginObject();
+		writer.Name("name", bone.name, sizeof(bone.name));
+		writer.Int("parent", bone.parent);
+		writer.Int("flags", bone.flags);
+
+		writer.BeginArray("controllers");
+
+		for (const auto controller : bone.bonecontroller)
+		{
+			writer.Int(nullptr, controller);
+		}
+
+		writer.EndArray();
+
+		writer.Vector("position", {bone.value[0], bone.value[1], bone.value[2]});
+		writer.Vector("rotation", {bone.value[3], bone.value[4], bone.value[5]});
+		writer.Vector("positionScale", {bone.scale[0], bone.scale[1], bone.scale[2]});
+		writer.Vector("rotationScale", {bone.scale[3], bone.scale[4], bone.scale[5]});
+		writer.EndObject();
+	}
+
+	writer.EndArray();
+
+	const auto pControllers = file.GetTable<mstudiobonecontroller_t>(header.bonecontrollerindex, header.numbonecontrollers, "bone controller");
+
+	writer.BeginArray("boneControllers");
+
+	for (int i = 0; i < header.numbonecontrollers; ++i)
+	{
+		const auto& controller = pControllers[i];
+
+		writer.BeginObject();
+		writer.Int("bone", controller.bone);
+		writer.Int("type", controller.type);
+		writer.Float("start", controller.start);
+		writer.Float("end", controller.end);
+		writer.Int("rest", controller.rest);
+		writer.Int("index", controller.index);
+		writer.EndObject();
+	}
+
+	writer.EndArray();
+
+	const auto pHitboxes = file.GetTable<mstudiobbox_t>(header.hitboxindex, header.numhitboxes, "hitbox");
+
+	writer.BeginArray("hitboxes");
+
+	for (int i = 0; i < header.numhitboxes; ++i)
+	{
+		const auto& hitbox = pHitboxes[i];
+
+		writer.BeginObject();
+		writer.Int("bone", hitbox.bone);
+		writer.Int("group", hitbox.group);
+		writer.Vector("min", hitbox.bbmin);
+		writer.Vector("max", hitbox.bbmax);
+		writer.EndObject();
+	}
+
+	writer.EndArray();
+
+	const auto pAttachments = file.GetTable<mstudioattachment_t>(header.attachmentindex, header.numattachments, "attachment");
+
+	writer.BeginArray("attachments");
+
+	for (int i = 0; i < header.numattachments; ++i)
+	{
+		const auto& attachment = pAttachments[i];
+
+		writer.BeginObject();
+		writer.Int("bone", attachment.bone);
+		writer.Vector("origin", attachment.org);
+		writer.EndObject();
+	}
+
+	writer.EndArray();
+}
+
+void WriteSequences(CJSONWriter& writer, const CModelFile& file)
+{
+	const auto& header = file.GetHeader();
+
+	const auto pSequences = file.GetTable<mstudioseqdesc_t>(header.seqindex, header.numseq, "sequence");
+
+	writer.BeginArray("sequences");
+
+	for (int i = 0; i < header.numseq; ++i)
+	{
+		const auto& sequence = pSequences[i];
+
+		writer.BeginObject();
+		writer.Name("name", sequence.label, sizeof(sequence.label));
+		writer.Float("fps", sequence.fps);
+		writer.Int("frames", sequence.numframes);
+		writer.Bool("looping", (sequence.flags & STUDIO_LOOPING) != 0);
+		writer.Int("flags", sequence.flags);
+		writer.Int("activity", sequence.activity);
+
+		if (const auto pszActivity = GetActivityName(sequence.activity); pszActivity)
+		{
+			writer.String("activityName", pszActivity);
+		}
+		else
+		{
+			writer.Null("activityName");
+		}
+
+		writer.Int("activityWeight", sequence.actweight);
+		writer.Int("motionType", sequence.motiontype);
+		writer.Int("motionBone", sequence.motionbone);
+		writer.Vector("linearMovement", sequence.linearmovement);
+		writer.Int("blends", sequence.numblends);
+		writer.Int("sequenceGroup", sequence.seqgroup);
+		writer.Vector("min", sequence.bbmin);
+		writer.Vector("max", sequence.bbmax);
+
+		const auto pEvents = file.GetTable<mstudioevent_t>(sequence.eventindex, sequence.numevents, "event");
+
+		writer.BeginArray("events");
+
+		for (int event = 0; event < sequence.numevents; ++event)
+		{
+			writer.BeginObject();
+			writer.Int("frame", pEvents[event].frame);
+			writer.Int("event", pEvents[event].event);
+			writer.Int("type", pEvents[event].type);
+			writer.Name("options", pEvents[event].options, sizeof(pEvents[event].options));
+			writer.EndObject();
+		}
+
+		writer.EndArray();
+		writer.EndObject();
+	}
+
+	writer.EndArray();
+
+	const auto pGroups = file.GetTable<mstudioseqgroup_t>(header.seqgroupindex, header.numseqgroups, "sequence group");
+
+	writer.BeginArray("sequenceGroups");
+
+	for (int i = 0; i < header.numseqgroups; ++i)
+	{
+		writer.BeginObject();
+		writer.Name("label", pGroups[i].label, sizeof(pGroups[i].label));
+		writer.Name("name", pGroups[i].name, sizeof(pGroups[i].name));
+		writer.EndObject();
+	}
+
+	writer.EndArray();
+}
+
+void WriteBodyparts(CJSONWriter& writer, const CModelFile& file)
+{
+	const auto& header = file.GetHeader();
+
+	const auto pBodyparts = file.GetTable<mstudiobodyparts_t>(header.bodypartindex, header.numbodyparts, "bodypart");
+
+	writer.BeginArray("bodyparts");
+
+	for (int i = 0; i < header.numbodyparts; ++i)
+	{
+		const auto& bodypart = pBodyparts[i];
+
+		writer.BeginObject();
+		writer.Name("name", bodypart.name, sizeof(bodypart.name));
+		writer.Int("base", bodypart.base);
+
+		const auto pModels = file.GetTable<mstudiomodel_t>(bodypart.modelindex, bodypart.nummodels, "model");
+
+		writer.BeginArray("models");
+
+		for (int model = 0; model < bodypart.nummodels; ++model)
+		{
+			const auto& submodel = pModels[model];
+
+			const auto pMeshes = file.GetTable<mstudiomesh_t>(submodel.meshindex, submodel.nummesh, "mesh");
+
+			long long triangles = 0;
+
+			for (int mesh = 0; mesh < submodel.nummesh; ++mesh)
+			{
+				triangles += pMeshes[mesh].numtris;
+			}
+
+			writer.BeginObject();
+			writer.Name("name", submodel.name, sizeof(submodel.name));
+			writer.Int("vertices", submodel.numverts);
+			writer.Int("normals", submodel.numnorms);
+			writer.Int("meshes", submodel.nummesh);
+			writer.Int("triangles", triangles);
+			writer.EndObject();
+		}
+
+		writer.EndArray();
+		writer.EndObject();
+	}
+
+	writer.EndArray();
+}
+
+void WriteTextures(CJSONWriter& writer, const CModelFile& file)
+{
+	const auto& header = file.GetHeader();
+
+	const auto pTextures = file.GetTable<mstudiotexture_t>(header.textureindex, header.numtextures, "texture");
+
+	writer.BeginArray("textures");
+
+	for (int i = 0; i < header.numtextures; ++i)
+	{
+		const auto& texture = pTextures[i];
+
+		writer.BeginObject();
+		writer.Name("name", texture.name, sizeof(texture.name));
+		writer.Int("width", texture.width);
+		writer.Int("height", texture.height);
+		writer.Int("flags", texture.flags);
+		writer.Flags("flagNames", texture.flags, TEXTURE_FLAGS, std::size(TEXTURE_FLAGS));
+		writer.EndObject();
+	}
+
+	writer.EndArray();
+
+	//Guard against overflow before multiplying, the counts come from the file
+	const bool bValidSkins = header.numskinfamilies >= 0 && header.numskinfamilies <= MAXSTUDIOSKINS
+		&& header.numskinref >= 0 && header.numskinref <= MAXSTUDIOSKINS;
+
+	const auto pSkins = file.GetTable<short>(header.skinindex, bValidSkins ? header.numskinfamilies * header.numskinref : -1, "skin");
+
+	writer.BeginArray("skinFamilies");
+
+	for (int family = 0; family < header.numskinfamilies; ++family)
+	{
+		writer.BeginArray();
+
+		for (int skinRef = 0; skinRef < header.numskinref; ++skinRef)
+		{
+			writer.Int(nullptr, pSkins[family * header.numskinref + skinRef]);
+		}
+
+		writer.EndArray();
+	}
+
+	writer.EndArray();
+}
+
+void WriteModel(CJSONWriter& writer, const std::filesystem::path& fileName, const CModelFile& file, const std::string& path)
+{
+	const auto& header = file.GetHeader();
+
+	//Textures are stored in a separate file if the main file has none
+	std::unique_ptr<CModelFile> textureFile;
+	std::string textureFileName;
+
+	if (header.numtextures == 0)
+	{
+		auto textureFilePath = fileName;
+
+		textureFilePath.replace_extension();
+		textureFilePath += "T";
+		textureFilePath += fileName.extension();
+
+		textureFile = std::make_unique<CModelFile>(textureFilePath);
+		textureFileName = textureFilePath.filename().u8string();
+	}
+
+	writer.BeginObject();
+	writer.String("path", path.c_str());
+	writer.Name("name", header.name, sizeof(header.name));
+	writer.Int("fileSize", static_cast<long long>(file.GetSize()));
+	writer.Int("flags", header.flags);
+	writer.Flags("flagNames", header.flags, MODEL_FLAGS, std::size(MODEL_FLAGS));
+	writer.Vector("eyePosition", header.eyeposition);
+	writer.Vector("movementMin", header.min);
+	writer.Vector("movementMax", header.max);
+	writer.Vector("clipMin", header.bbmin);
+	writer.Vector("clipMax", header.bbmax);
+
+	WriteBones(writer, file);
+	WriteSequences(writer, file);
+	WriteBodyparts(writer, file);
+
+	if (textureFile)
+	{
+		writer.String("textureFile", textureFileName.c_str());
+	}
+	else
+	{
+		writer.Null("textureFile");
+	}
+
+	WriteTextures(writer, textureFile ? *textureFile : file);
+
+	writer.EndObject();
+}
+}
+
+ModelInfoResult WriteModelInfo(const std::filesystem::path& fileName, const std::string& path, std::string& json)
+{
+	const auto start = json.size();
+
+	try
+	{
+		CModelFile file{fileName};
+
+		//Only the main file has a name
+		if (file.IsSequenceGroup() || file.GetHeader().name[0] == '\0')
+		{
+			return ModelInfoResult::SKIPPED;
+		}
+
+		CJSONWriter writer{json};
+
+		WriteModel(writer, fileName, file, path);
+
+		return ModelInfoResult::WRITTEN;
+	}
+	catch (const std::exception& e)
+	{
+		//Discard the partially written object
+		json.resize(start);
+
+		CJSONWriter writer{json};
+
+		writer.BeginObject();
+		writer.String("path", path.c_str());
+		writer.String("error", e.what());
+		writer.EndObject();
+
+		return ModelInfoResult::FAILED;
+	}
+}
+}
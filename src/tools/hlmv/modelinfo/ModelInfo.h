@@ -0,0 +1,54 @@
+#ifndef MODELINFO_MODELINFO_H
+#define MODELINFO_MODELINFO_H
+
+#include <filesystem>
+#include <string>
+
+/**
+*	@defgroup ModelInfo Model information dumps
+*
+*	Writes the metadata of studio models as JSON, without a window or render context.
+*
+*	@{
+*/
+
+namespace modelinfo
+{
+/**
+*	Version of the JSON layout. Incremented whenever a field is removed, renamed or changes meaning.
+*	Adding fields does not change the version, so readers should ignore fields they don't know.
+*/
+const int SCHEMA_VERSION = 1;
+
+enum class ModelInfoResult
+{
+	/**
+	*	The model's information was written.
+	*/
+	WRITTEN = 0,
+
+	/**
+	*	The file is a texture or sequence group file. These are included in the information of the model they belong to.
+	*/
+	SKIPPED,
+
+	/**
+	*	The file could not be read. An object with the path and an error message was written instead.
+	*/
+	FAILED
+};
+
+/**
+*	@brief Reads a studio model and its texture file and writes its information as a single line JSON object
+*	Names are written as if they were Windows-1252 encoded, which is what the compiler tools produce.
+*	Only reads files and constant tables, so any number of models can be written in parallel.
+*	@param fileName Model to read
+*	@param path Path to store in the object, usually relative to the directory that is being dumped
+*	@param json The object is appended to this
+*/
+ModelInfoResult WriteModelInfo(const std::filesystem::path& fileName, const std::string& path, std::string& json);
+}
+
+/** @} */
+
+#endif //MODELINFO_MODELINFO_H
@@ -0,0 +1,287 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "shared/Logging.h"
+
+#include "utility/CBackgroundJobs.h"
+
+#include "ModelInfo.h"
+
+/**
+*	@file
+*
+*	Entry point of hlmv_modelinfo. Dumps the information of any number of models as a single JSON document.
+*	Models are read and converted on all cores. Objects are written in the order of the files as soon as they are done,
+*	so only the models that finished ahead of the next one to be written are held in memory.
+*/
+
+namespace
+{
+struct ModelFile
+{
+	std::filesystem::path FileName;
+
+	/**
+	*	Path written to the document. Relative to the directory it was found in, using '/' as separator.
+	*/
+	std::string Path;
+};
+
+void PrintUsage()
+{
+	Message(
+		"Usage: hlmv_modelinfo [options] <file or directory>...\n"
+		"Directories are searched recursively for models.\n"
+		"  --output <file>    Write the document to a file instead of stdout\n"
+		"  --threads <count>  Number of threads to use, 0 uses all cores (default 0)\n");
+}
+
+bool IsModelFile(const std::filesystem::path& fileName)
+{
+	auto extension = fileName.extension().u8string();
+
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+	return extension == ".mdl" || extension == ".dol";
+}
+
+/**
+*	@brief Adds the models in a file or directory
+*	Files in a directory are sorted by path, so the document does not depend on the order the file system returns them in.
+*/
+bool CollectModels(const std::filesystem::path& input, std::vector<ModelFile>& files)
+{
+	std::error_code error;
+
+	if (!std::filesystem::is_directory(input, error))
+	{
+		if (!std::filesystem::is_regular_file(input, error))
+		{
+			Error("\"%s\" is not a file or directory\n", input.u8string().c_str());
+			return false;
+		}
+
+		files.push_back({input, input.generic_u8string()});
+		return true;
+	}
+
+	const auto first = files.size();
+
+	for (std::filesystem::recursive_directory_iterator it{input, error}, end; !error && it != end; it.increment(error))
+	{
+		std::error_code fileError;
+
+		if (it->is_regular_file(fileError) && IsModelFile(it->path()))
+		{
+			files.push_back({it->path(), it->path().lexically_relative(input).generic_u8string()});
+		}
+	}
+
+	if (error)
+	{
+		Error("Couldn't search directory \"%s\": %s\n", input.u8string().c_str(), error.message().c_str());
+		return false;
+	}
+
+	std::sort(files.begin() + first, files.end(), [](const auto& lhs, const auto& rhs) { return lhs.Path < rhs.Path; });
+
+	return true;
+}
+}
+
+int main(int argc, char* argv[])
+{
+	//The document can be written to stdout, so keep messages out of it
+	SetDefaultLogListener(GetStdErrLogListener());
+
+	std::vector<std::filesystem::path> inputs;
+	std::filesystem::path outputFileName;
+	unsigned int numThreads = 0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* const pszArg = argv[i];
+
+		if (!strcmp(pszArg, "--help") || !strcmp(pszArg, "-h"))
+		{
+			PrintUsage();
+			return EXIT_SUCCESS;
+		}
+
+		if (strncmp(pszArg, "--", 2))
+		{
+			inputs.emplace_back(std::filesystem::u8path(pszArg));
+			continue;
+		}
+
+		if (i + 1 >= argc)
+		{
+			Error("Missing value for option \"%s\"\n", pszArg);
+			PrintUsage();
+			return EXIT_FAILURE;
+		}
+
+		const char* const pszValue = argv[++i];
+
+		if (!strcmp(pszArg, "--output"))
+		{
+			outputFileName = std::filesystem::u8path(pszValue);
+		}
+		else if (!strcmp(pszArg, "--threads"))
+		{
+			numThreads = static_cast<unsigned int>(strtoul(pszValue, nullptr, 10));
+		}
+		else
+		{
+			Error("Unknown option \"%s\"\n", pszArg);
+			PrintUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (inputs.empty())
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+
+	std::vector<ModelFile> files;
+
+	for (const auto& input : inputs)
+	{
+		if (!CollectModels(input, files))
+		{
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::ofstream outputFile;
+
+	if (!outputFileName.empty())
+	{
+		outputFile.open(outputFileName, std::ios::binary | std::ios::trunc);
+
+		if (!outputFile)
+		{
+			Error("Couldn't open \"%s\" for writing\n", outputFileName.u8string().c_str());
+			return EXIT_FAILURE;
+		}
+	}
+	else
+	{
+		std::ios::sync_with_stdio(false);
+	}
+
+	std::ostream& output = outputFileName.empty() ? std::cout : outputFile;
+
+	output << "{\"schemaVersion\":" << modelinfo::SCHEMA_VERSION << ",\"models\":[";
+
+	struct Slot
+	{
+		bool bDone = false;
+		modelinfo::ModelInfoResult Result = modelinfo::ModelInfoResult::SKIPPED;
+		std::string JSON;
+	};
+
+	std::vector<Slot> slots(files.size());
+
+	std::mutex mutex;
+	std::condition_variable slotDone;
+
+	CBackgroundJobs jobs(files.size(), [&](std::size_t index)
+		{
+			const auto complete = [&](modelinfo::ModelInfoResult result, std::string&& json)
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+
+					slots[index].bDone = true;
+					slots[index].Result = result;
+					slots[index].JSON = std::move(json);
+				}
+
+				slotDone.notify_one();
+			};
+
+			std::string json;
+
+			try
+			{
+				const auto result = modelinfo::WriteModelInfo(files[index].FileName, files[index].Path, json);
+
+				complete(result, std::move(json));
+			}
+			catch (...)
+			{
+				//WriteModelInfo only turns std::exception into an error object, anything else still has to complete the slot
+				//or the writer below waits for it forever. The exception itself is reported by the jobs.
+				complete(modelinfo::ModelInfoResult::FAILED, {});
+				throw;
+			}
+		}, numThreads);
+
+	std::size_t numWritten = 0;
+	std::size_t numSkipped = 0;
+	std::size_t numFailed = 0;
+	std::size_t numObjects = 0;
+
+	//One object per line so documents can be diffed
+	for (std::size_t index = 0; index < slots.size(); ++index)
+	{
+		Slot slot;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			slotDone.wait(lock, [&] { return slots[index].bDone; });
+
+			slot = std::move(slots[index]);
+		}
+
+		switch (slot.Result)
+		{
+		case modelinfo::ModelInfoResult::WRITTEN: ++numWritten; break;
+		case modelinfo::ModelInfoResult::SKIPPED: ++numSkipped; continue;
+		case modelinfo::ModelInfoResult::FAILED: ++numFailed; break;
+		}
+
+		//A job that threw has no object to write
+		if (slot.JSON.empty())
+		{
+			continue;
+		}
+
+		output << (numObjects++ > 0 ? ",\n" : "\n") << slot.JSON;
+	}
+
+	jobs.Wait();
+
+	output << "\n]}\n";
+	output.flush();
+
+	if (!output)
+	{
+		Error("Couldn't write the document\n");
+		return EXIT_FAILURE;
+	}
+
+	const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+	Message("Wrote %zu models (%zu failed, %zu texture and sequence group files skipped) in %.2f seconds\n",
+		numWritten, numFailed, numSkipped, duration.count());
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,204 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+#include "shared/Logging.h"
+#include "shared/Platform.h"
+#include "shared/Utility.h"
+
+#include "assetindex/CAssetIndex.h"
+#include "assetindex/CAssetIndexBuilder.h"
+
+#include "cvar/CConCommand.h"
+
+#include "settings/CGameConfig.h"
+
+#include "utility/CCommand.h"
+
+#include "CModelViewerApp.h"
+
+/**
+*	@file
+*
+*	Console commands to build and query the asset index of the active game configuration.
+*/
+
+namespace hlmv
+{
+namespace
+{
+const char* const ASSET_INDEX_DIRECTORY = "assetindex";
+
+std::shared_ptr<settings::CGameConfig> GetActiveGameConfig()
+{
+	auto config = wxGetApp().GetSettings()->GetConfigManager()->GetActiveConfig();
+
+	if (!config)
+	{
+		Warning("No active game configuration\n");
+	}
+
+	return config;
+}
+
+std::filesystem::path GetAssetIndexFileName(const settings::CGameConfig& config)
+{
+	return std::filesystem::u8path(ASSET_INDEX_DIRECTORY) / std::filesystem::u8path(std::string{config.GetName()} + ".hlai");
+}
+
+bool OpenAssetIndex(assetindex::CAssetIndex& index)
+{
+	auto config = GetActiveGameConfig();
+
+	if (!config)
+	{
+		return false;
+	}
+
+	if (!index.Open(GetAssetIndexFileName(*config)))
+	{
+		Warning("No asset index for game configuration \"%s\", use assetindex_build to create it\n", config->GetName());
+		return false;
+	}
+
+	return true;
+}
+
+const char* AssetTypeToString(const assetindex::AssetType type)
+{
+	switch (type)
+	{
+	case assetindex::AssetType::STUDIOMODEL:			return "model";
+	case assetindex::AssetType::STUDIOTEXTURES:			return "textures";
+	case assetindex::AssetType::STUDIOSEQUENCEGROUP:	return "seqgroup";
+	case assetindex::AssetType::SPRITE:					return "sprite";
+	default:											return "unknown";
+	}
+}
+
+void PrintAssets(const assetindex::CAssetIndex& index, const std::vector<std::uint32_t>& assets)
+{
+	for (const auto assetIndex : assets)
+	{
+		const auto& asset = index.GetAsset(assetIndex);
+
+		Message("%s (%s, %u polygons)\n", index.GetAssetPath(asset), AssetTypeToString(static_cast<assetindex::AssetType>(asset.type)), asset.numPolygons);
+	}
+
+	Message("%u assets found\n", static_cast<unsigned int>(assets.size()));
+}
+
+void AssetIndex_Build(const util::CCommand& args)
+{
+	auto config = GetActiveGameConfig();
+
+	if (!config)
+	{
+		return;
+	}
+
+	const auto fileName = GetAssetIndexFileName(*config);
+
+	std::error_code error;
+
+	std::filesystem::create_directories(fileName.parent_path(), error);
+
+	const auto start = std::chrono::steady_clock::now();
+
+	assetindex::CAssetIndex previous;
+
+	//All files are parsed if there is no usable previous index or a full rebuild was requested
+	if (args.ArgC() < 2 || strcasecmp(args.Arg(1), "full"))
+	{
+		previous.Open(fileName);
+	}
+
+	assetindex::CAssetIndexBuilder builder;
+	assetindex::BuildStatistics statistics;
+
+	const auto assets = builder.Collect(*config, &previous, &statistics);
+
+	previous.Close();
+
+	if (!assetindex::CAssetIndexBuilder::Write(fileName, assets))
+	{
+		return;
+	}
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+	Message("Indexed %u assets (%u parsed, %u unchanged, %u invalid) in %lld ms\n",
+		statistics.NumAssets, statistics.NumParsed, statistics.NumReused, statistics.NumInvalid, static_cast<long long>(elapsed.count()));
+}
+
+void AssetIndex_Find(const util::CCommand& args)
+{
+	if (args.ArgC() < 3)
+	{
+		Message("Usage: assetindex_find <bone|sequence|activity|texture|sound> <name>\nAppend '*' to the name to search by prefix\n");
+		return;
+	}
+
+	static const char* const CATEGORY_NAMES[] = {"bone", "sequence", "activity", "texture", "sound"};
+
+	static_assert(ARRAYSIZE(CATEGORY_NAMES) == static_cast<size_t>(assetindex::TermCategory::COUNT), "Category names must match categories");
+
+	size_t category = 0;
+
+	for (; category < ARRAYSIZE(CATEGORY_NAMES); ++category)
+	{
+		if (!strcasecmp(args.Arg(1), CATEGORY_NAMES[category]))
+		{
+			break;
+		}
+	}
+
+	if (category == ARRAYSIZE(CATEGORY_NAMES))
+	{
+		Warning("Unknown category \"%s\"\n", args.Arg(1));
+		return;
+	}
+
+	assetindex::CAssetIndex index;
+
+	if (!OpenAssetIndex(index))
+	{
+		return;
+	}
+
+	PrintAssets(index, index.FindAssets(static_cast<assetindex::TermCategory>(category), args.Arg(2)));
+}
+
+void AssetIndex_Polygons(const util::CCommand& args)
+{
+	if (args.ArgC() < 2)
+	{
+		Message("Usage: assetindex_polys <minimum> [maximum]\n");
+		return;
+	}
+
+	const auto minimum = static_cast<std::uint32_t>(strtoul(args.Arg(1), nullptr, 10));
+	const auto maximum = args.ArgC() >= 3 ? static_cast<std::uint32_t>(strtoul(args.Arg(2), nullptr, 10)) : UINT32_MAX;
+
+	assetindex::CAssetIndex index;
+
+	if (!OpenAssetIndex(index))
+	{
+		return;
+	}
+
+	PrintAssets(index, index.FindAssetsByPolygonCount(minimum, maximum));
+}
+}
+
+static cvar::CConCommand assetindex_build("assetindex_build", &AssetIndex_Build, cvar::Flag::NONE,
+	"Builds or updates the asset index of the active game configuration. Pass \"full\" to reparse all files");
+
+static cvar::CConCommand assetindex_find("assetindex_find", &AssetIndex_Find, cvar::Flag::NONE,
+	"Finds models by bone, sequence, activity, texture or event sound name");
+
+static cvar::CConCommand assetindex_polys("assetindex_polys", &AssetIndex_Polygons, cvar::Flag::NONE,
+	"Finds models whose polygon count is in the given range");
+}
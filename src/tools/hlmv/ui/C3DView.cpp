@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <limits>
 #include <memory>
 
 #include <glm/mat4x4.hpp>
@@ -17,8 +19,14 @@
 #include "graphics/GraphicsUtils.h"
 #include "graphics/GraphicsHelpers.h"
 
+#include "shared/CProfiler.h"
+#include "shared/Utility.h"
+
+#include "shared/renderer/IRenderContext.h"
 #include "shared/renderer/studiomodel/IStudioModelRenderer.h"
 
+#include "engine/renderer/gl/CBaseGLRenderContext.h"
+
 #include "game/entity/CStudioModelEntity.h"
 
 #include "wx/CwxOpenGL.h"
@@ -30,6 +38,7 @@
 #include "C3DView.h"
 
 //TODO: remove
+extern renderer::IRenderContext* g_pRenderContext;
 extern studiomdl::IStudioModelRenderer* g_pStudioMdlRenderer;
 
 namespace hlmv
@@ -60,19 +69,32 @@ C3DView::~C3DView()
 void C3DView::PrepareForLoad()
 {
 	SetCurrent( *GetContext() );
+
+	//The picker references the model that is about to be freed
+	m_Picker.Clear();
+	m_HitboxQuery.Clear();
 }
 
 void C3DView::UpdateView()
 {
-	if( !m_pHLMV->GetState()->pause )
+	auto pState = m_pHLMV->GetState();
+
+	//Nothing to do if the last frame is still up to date
+	const bool bDraw = !pState->pause && pState->IsRedrawRequested();
+
+	if( bDraw )
 	{
 		Refresh();
 		Update();
 	}
+
+	pState->FrameFinished( bDraw );
 }
 
 void C3DView::Paint(wxPaintEvent& event)
 {
+	PROFILE_SCOPE("C3DView::Paint");
+
 	SetCurrent(*m_pContext);
 
 	//Can't use the DC to draw anything since OpenGL draws over it.
@@ -80,7 +102,10 @@ void C3DView::Paint(wxPaintEvent& event)
 
 	DrawScene();
 
-	SwapBuffers();
+	{
+		PROFILE_SCOPE("SwapBuffers");
+		SwapBuffers();
+	}
 
 	//Get any errors that were logged during this frame.
 	wxOpenGL().GetErrors();
@@ -88,6 +113,10 @@ void C3DView::Paint(wxPaintEvent& event)
 
 void C3DView::DrawScene()
 {
+	//Other code, like texture uploads, changes state without going through the render context.
+	g_pRenderContext->InvalidateState();
+	g_pRenderContext->ResetStateChangeStats();
+
 	const Color& backgroundColor = m_pHLMV->GetSettings()->GetBackgroundColor();
 
 	glClearColor( backgroundColor.GetRed() / 255.0f, backgroundColor.GetGreen() / 255.0f, backgroundColor.GetBlue() / 255.0f, 1.0 );
@@ -105,9 +134,10 @@ void C3DView::DrawScene()
 
 	glViewport( 0, 0, size.GetX(), size.GetY() );
 
-	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	g_pRenderContext->SetPolygonMode(renderer::PolygonMode::FILL);
 
 	m_pHLMV->GetState()->drawnPolys = 0;
+	m_pHLMV->GetState()->skinnedSubModels = 0;
 
 	if( m_pHLMV->GetState()->showTexture )
 	{
@@ -134,15 +164,15 @@ void C3DView::DrawScene()
 		glPushMatrix();
 		glLoadIdentity();
 
-		glDisable(GL_CULL_FACE);
+		g_pRenderContext->Disable(renderer::Capability::CULL_FACE);
 
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		g_pRenderContext->SetPolygonMode(renderer::PolygonMode::FILL);
 
-		glDisable(GL_TEXTURE_2D);
+		g_pRenderContext->Disable(renderer::Capability::TEXTURE_2D);
 
 		const Color& crosshairColor = m_pHLMV->GetSettings()->GetCrosshairColor();
 
-		glColor4f(crosshairColor.GetRed() / 255.0f, crosshairColor.GetGreen() / 255.0f, crosshairColor.GetBlue() / 255.0f, 1.0);
+		g_pRenderContext->SetColor(crosshairColor.GetRed() / 255.0f, crosshairColor.GetGreen() / 255.0f, crosshairColor.GetBlue() / 255.0f, 1.0);
 
 		glPointSize(CROSSHAIR_LINE_WIDTH);
 		glLineWidth(CROSSHAIR_LINE_WIDTH);
@@ -186,15 +216,15 @@ void C3DView::DrawScene()
 		glPushMatrix();
 		glLoadIdentity();
 
-		glDisable(GL_CULL_FACE);
+		g_pRenderContext->Disable(renderer::Capability::CULL_FACE);
 
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		g_pRenderContext->SetPolygonMode(renderer::PolygonMode::FILL);
 
-		glDisable(GL_TEXTURE_2D);
+		g_pRenderContext->Disable(renderer::Capability::TEXTURE_2D);
 
 		const Color& crosshairColor = m_pHLMV->GetSettings()->GetCrosshairColor();
 
-		glColor4f(crosshairColor.GetRed() / 255.0f, crosshairColor.GetGreen() / 255.0f, crosshairColor.GetBlue() / 255.0f, 1.0);
+		g_pRenderContext->SetColor(crosshairColor.GetRed() / 255.0f, crosshairColor.GetGreen() / 255.0f, crosshairColor.GetBlue() / 255.0f, 1.0);
 
 		glPointSize(GUIDELINES_LINE_WIDTH);
 		glLineWidth(GUIDELINES_LINE_WIDTH);
@@ -239,6 +269,127 @@ void C3DView::DrawScene()
 
 		glPopMatrix();
 	}
+
+	if (profiler::Profiler().IsHistoryEnabled())
+	{
+		DrawProfilerOverlay();
+	}
+}
+
+void C3DView::DrawProfilerOverlay()
+{
+	PROFILE_SCOPE("C3DView::DrawProfilerOverlay");
+
+	static const float ZONE_COLORS[][3] =
+	{
+		{0.90f, 0.30f, 0.25f},
+		{0.25f, 0.70f, 0.30f},
+		{0.25f, 0.50f, 0.90f},
+		{0.95f, 0.75f, 0.20f},
+		{0.70f, 0.35f, 0.85f},
+		{0.20f, 0.80f, 0.80f},
+		{0.95f, 0.50f, 0.15f},
+		{0.85f, 0.40f, 0.60f},
+		{0.55f, 0.75f, 0.20f},
+		{0.45f, 0.45f, 0.75f}
+	};
+
+	const auto& frameProfiler = profiler::Profiler();
+
+	const wxSize size = GetClientSize();
+
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+
+	glOrtho(0.0f, (float) size.GetX(), (float) size.GetY(), 0.0f, 1.0f, -1.0f);
+
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+
+	g_pRenderContext->Disable(renderer::Capability::CULL_FACE);
+	g_pRenderContext->Disable(renderer::Capability::DEPTH_TEST);
+	g_pRenderContext->Disable(renderer::Capability::TEXTURE_2D);
+
+	g_pRenderContext->SetPolygonMode(renderer::PolygonMode::FILL);
+
+	const float flLeft = PROFILER_OVERLAY_OFFSET;
+	const float flRight = flLeft + profiler::FRAME_HISTORY_SIZE * PROFILER_OVERLAY_BAR_WIDTH;
+	const float flBottom = static_cast<float>(size.GetY() - PROFILER_OVERLAY_OFFSET);
+	const float flTop = flBottom - PROFILER_OVERLAY_MAX_HEIGHT;
+
+	g_pRenderContext->Enable(renderer::Capability::BLEND);
+	g_pRenderContext->SetBlendFunc(renderer::BlendFactor::SRC_ALPHA, renderer::BlendFactor::ONE_MINUS_SRC_ALPHA);
+
+	g_pRenderContext->SetColor(0.0f, 0.0f, 0.0f, 0.5f);
+
+	glBegin(GL_QUADS);
+
+	glVertex2f(flLeft, flTop);
+	glVertex2f(flRight, flTop);
+	glVertex2f(flRight, flBottom);
+	glVertex2f(flLeft, flBottom);
+
+	const float flMaxHeight = static_cast<float>(PROFILER_OVERLAY_MAX_HEIGHT);
+
+	for (size_t frameIndex = 0; frameIndex < frameProfiler.GetFrameCount(); ++frameIndex)
+	{
+		const auto& frame = frameProfiler.GetFrame(frameIndex);
+
+		const float flX = flLeft + frameIndex * PROFILER_OVERLAY_BAR_WIDTH;
+
+		float flHeight = 0;
+
+		auto drawSegment = [&](const std::uint64_t duration)
+		{
+			const float flNewHeight = std::min(flHeight + (duration / 1000000.0f) * PROFILER_OVERLAY_SCALE, flMaxHeight);
+
+			glVertex2f(flX, flBottom - flNewHeight);
+			glVertex2f(flX + PROFILER_OVERLAY_BAR_WIDTH, flBottom - flNewHeight);
+			glVertex2f(flX + PROFILER_OVERLAY_BAR_WIDTH, flBottom - flHeight);
+			glVertex2f(flX, flBottom - flHeight);
+
+			flHeight = flNewHeight;
+		};
+
+		std::uint64_t timedDuration = 0;
+
+		for (size_t zone = 0; zone < frame.ZoneSelfTimes.size(); ++zone)
+		{
+			const auto& color = ZONE_COLORS[zone % ARRAYSIZE(ZONE_COLORS)];
+
+			g_pRenderContext->SetColor(color[0], color[1], color[2], 1.0f);
+
+			drawSegment(frame.ZoneSelfTimes[zone]);
+
+			timedDuration += frame.ZoneSelfTimes[zone];
+		}
+
+		g_pRenderContext->SetColor(0.6f, 0.6f, 0.6f, 1.0f);
+
+		drawSegment(frame.Duration > timedDuration ? frame.Duration - timedDuration : 0);
+	}
+
+	glEnd();
+
+	//Reference lines at 60 and 30 FPS
+	g_pRenderContext->SetColor(1.0f, 1.0f, 1.0f, 0.75f);
+
+	glBegin(GL_LINES);
+
+	for (const float flFrameTime : {1000.0f / 60.0f, 1000.0f / 30.0f})
+	{
+		const float flY = flBottom - flFrameTime * PROFILER_OVERLAY_SCALE;
+
+		glVertex2f(flLeft, flY);
+		glVertex2f(flRight, flY);
+	}
+
+	glEnd();
+
+	g_pRenderContext->Disable(renderer::Capability::BLEND);
+
+	glPopMatrix();
 }
 
 void C3DView::ApplyCameraToScene()
@@ -381,6 +532,8 @@ void C3DView::MouseEvents( wxMouseEvent& event )
 						}
 
 						g_pStudioMdlRenderer->SetLightVector( vecLightDir );
+
+						m_pHLMV->GetState()->RequestRedraw();
 					}
 				}
 				else if( event.GetModifiers() & wxMOD_SHIFT )
@@ -474,12 +627,115 @@ void C3DView::MouseEvents( wxMouseEvent& event )
 			}
 		}
 	}
+	else if( event.Moving() && !m_bTexPanelMouseData && !m_pHLMV->GetState()->showTexture )
+	{
+		UpdatePick( event.GetX(), event.GetY() );
+
+		event.Skip();
+	}
 	else
 	{
 		event.Skip();
 	}
 }
 
+void C3DView::UpdatePick( const int iX, const int iY )
+{
+	auto pMainWindow = m_pHLMV->GetMainWindow();
+
+	auto pEntity = m_pHLMV->GetState()->GetEntity();
+
+	if( !pEntity || !pEntity->GetModel() )
+	{
+		return;
+	}
+
+	auto pModel = pEntity->GetModel();
+
+	//Pose the entity as it is now, the last drawn pose is out of date if a redraw was skipped
+	auto& pose = pEntity->GetPose();
+
+	m_Picker.Update( pModel, pEntity->GetBodygroup(), pose.GetBoneTransforms() );
+	m_HitboxQuery.Update( pModel->GetStudioHeader(), pose );
+
+	const wxSize size = GetClientSize();
+
+	if( size.GetWidth() <= 0 || size.GetHeight() <= 0 )
+	{
+		return;
+	}
+
+	//Reconstruct the matrices used to draw the model, see DrawModel and CStudioModelRenderer::DrawModel
+	const auto projection = glm::perspective( glm::radians( m_pHLMV->GetState()->GetCurrentFOV() ),
+		static_cast<float>( size.GetWidth() ) / size.GetHeight(), 1.0f, static_cast<float>( 1 << 24 ) );
+
+	auto pCamera = m_pHLMV->GetState()->GetCurrentCamera();
+
+	const auto vecAngles = pCamera->GetViewDirection();
+
+	auto modelView = Mat4x4ModelView();
+
+	modelView *= glm::translate( -pCamera->GetOrigin() );
+	modelView *= glm::rotate( glm::radians( vecAngles[ 2 ] ), glm::vec3{ 1, 0, 0 } );
+	modelView *= glm::rotate( glm::radians( vecAngles[ 0 ] ), glm::vec3{ 0, 1, 0 } );
+	modelView *= glm::rotate( glm::radians( vecAngles[ 1 ] ), glm::vec3{ 0, 0, 1 } );
+
+	auto vecOrigin = pEntity->GetOrigin();
+
+	if( m_pHLMV->GetState()->UsingWeaponOrigin() )
+	{
+		vecOrigin.z -= 1;
+	}
+
+	const auto& vecEntityAngles = pEntity->GetAngles();
+
+	modelView *= glm::translate( vecOrigin );
+	modelView *= glm::rotate( glm::radians( vecEntityAngles[ 1 ] ), glm::vec3{ 0, 0, 1 } );
+	modelView *= glm::rotate( glm::radians( vecEntityAngles[ 0 ] ), glm::vec3{ 0, 1, 0 } );
+	modelView *= glm::rotate( glm::radians( vecEntityAngles[ 2 ] ), glm::vec3{ 1, 0, 0 } );
+	modelView *= glm::scale( pEntity->GetScale() );
+
+	const glm::vec4 viewport{ 0, 0, size.GetWidth(), size.GetHeight() };
+
+	const float flWindowY = static_cast<float>( size.GetHeight() - iY );
+
+	const auto vecNear = glm::unProject( glm::vec3{ iX, flWindowY, 0.0f }, modelView, projection, viewport );
+	const auto vecFar = glm::unProject( glm::vec3{ iX, flWindowY, 0.5f }, modelView, projection, viewport );
+
+	const auto pStudioHdr = pModel->GetStudioHeader();
+	const auto pTextureHdr = pModel->GetTextureHeader();
+
+	wxString szStatus;
+
+	studiomdl::PickResult result;
+
+	if( m_Picker.Pick( vecNear, vecFar - vecNear, pEntity->GetSkin(), result ) )
+	{
+		szStatus = wxString::Format( "Body part %d, mesh %d, texture \"%s\", bone \"%s\", vertex %d, UV (%.1f, %.1f)",
+			result.BodyPart, result.Mesh,
+			pTextureHdr->GetTexture( result.Texture )->name,
+			pStudioHdr->GetBone( result.Bone )->name,
+			result.Vertex, result.UV.x, result.UV.y );
+	}
+
+	studiomdl::HitboxRay ray;
+
+	ray.Origin = vecNear;
+	ray.Direction = vecFar - vecNear;
+	ray.MaxDistance = std::numeric_limits<float>::max();
+
+	studiomdl::HitboxHit hit;
+
+	if( m_HitboxQuery.TraceRay( ray, hit ) )
+	{
+		szStatus += szStatus.IsEmpty() ? "Hitbox" : ", hitbox";
+
+		szStatus += wxString::Format( " %d (group %d, bone \"%s\")", hit.Hitbox, hit.Group, pStudioHdr->GetBone( hit.Bone )->name );
+	}
+
+	pMainWindow->SetStatusText( szStatus );
+}
+
 void C3DView::SetupRenderMode( RenderMode renderMode )
 {
 	if( renderMode == RenderMode::INVALID )
@@ -532,33 +788,33 @@ void C3DView::DrawTexture( const int iXOffset, const int iYOffset, const int iWi
 		glPushMatrix();
 		glLoadIdentity();
 
-		glDisable( GL_CULL_FACE );
-		glDisable( GL_BLEND );
+		g_pRenderContext->Disable( renderer::Capability::CULL_FACE );
+		g_pRenderContext->Disable( renderer::Capability::BLEND );
 
 		if( texture.flags & STUDIO_NF_MASKED )
 		{
-			glEnable( GL_ALPHA_TEST );
-			glAlphaFunc( GL_GREATER, 0.5f );
+			g_pRenderContext->Enable( renderer::Capability::ALPHA_TEST );
+			g_pRenderContext->SetAlphaFunc( renderer::CompareFunc::GREATER, 0.5f );
 		}
 
-		glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+		g_pRenderContext->SetPolygonMode( renderer::PolygonMode::FILL );
 		float x = ( ( ( float ) iWidth - w ) / 2 ) + iXOffset;
 		float y = ( ( ( float ) iHeight - h ) / 2 ) + iYOffset;
 
-		glDisable( GL_DEPTH_TEST );
+		g_pRenderContext->Disable( renderer::Capability::DEPTH_TEST );
 
 		if( bShowUVMap && !bOverlayUVMap )
 		{
-			glColor4f( 0.0f, 0.0f, 0.0f, 1.0f );
-			glDisable( GL_TEXTURE_2D );
+			g_pRenderContext->SetColor( 0.0f, 0.0f, 0.0f, 1.0f );
+			g_pRenderContext->Disable( renderer::Capability::TEXTURE_2D );
 			glRectf( x, y, x + w, y + h );
 		}
 
 		if( !bShowUVMap || bOverlayUVMap )
 		{
-			glEnable( GL_TEXTURE_2D );
-			glColor4f( 1.0f, 1.0f, 1.0f, 1.0f );
-			glBindTexture( GL_TEXTURE_2D, pModel->GetTextureId( iTexture ) );
+			g_pRenderContext->Enable( renderer::Capability::TEXTURE_2D );
+			g_pRenderContext->SetColor( 1.0f, 1.0f, 1.0f, 1.0f );
+			g_pRenderContext->BindTexture( renderer::GLToTexHandle( pModel->GetTextureId( iTexture ) ) );
 
 			glBegin( GL_TRIANGLE_STRIP );
 
@@ -576,12 +832,12 @@ void C3DView::DrawTexture( const int iXOffset, const int iYOffset, const int iWi
 
 			glEnd();
 
-			glBindTexture( GL_TEXTURE_2D, 0 );
+			g_pRenderContext->BindTexture( NULL_TEXTURE_HANDLE );
 		}
 
 		if( bShowUVMap )
 		{
-			glColor4f( 1.0f, 1.0f, 1.0f, 1.0f );
+			g_pRenderContext->SetColor( 1.0f, 1.0f, 1.0f, 1.0f );
 
 			CStudioModelEntity::MeshList_t meshes;
 
@@ -598,8 +854,8 @@ void C3DView::DrawTexture( const int iXOffset, const int iYOffset, const int iWi
 
 			if( bAntiAliasLines )
 			{
-				glEnable( GL_BLEND );
-				glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+				g_pRenderContext->Enable( renderer::Capability::BLEND );
+				g_pRenderContext->SetBlendFunc( renderer::BlendFactor::SRC_ALPHA, renderer::BlendFactor::ONE_MINUS_SRC_ALPHA );
 				glEnable( GL_LINE_SMOOTH );
 			}
 
@@ -643,7 +899,7 @@ void C3DView::DrawTexture( const int iXOffset, const int iYOffset, const int iWi
 		glClear( GL_DEPTH_BUFFER_BIT );
 
 		if( texture.flags & STUDIO_NF_MASKED )
-			glDisable( GL_ALPHA_TEST );
+			g_pRenderContext->Disable( renderer::Capability::ALPHA_TEST );
 	}
 }
 
@@ -657,7 +913,7 @@ void C3DView::DrawModel()
 
 	if( m_pHLMV->GetState()->showBackground && m_BackgroundTexture != GL_INVALID_TEXTURE_ID && !m_pHLMV->GetState()->showTexture )
 	{
-		graphics::DrawBackground( m_BackgroundTexture );
+		graphics::DrawBackground( g_pRenderContext, m_BackgroundTexture );
 	}
 
 	graphics::SetProjection( m_pHLMV->GetState()->GetCurrentFOV(), size.GetWidth(), size.GetHeight() );
@@ -670,8 +926,8 @@ void C3DView::DrawModel()
 
 	if( m_pHLMV->GetState()->drawAxes )
 	{
-		glDisable( GL_TEXTURE_2D );
-		glEnable( GL_DEPTH_TEST );
+		g_pRenderContext->Disable( renderer::Capability::TEXTURE_2D );
+		g_pRenderContext->Enable( renderer::Capability::DEPTH_TEST );
 
 		const float flLength = 50.0f;
 
@@ -679,17 +935,17 @@ void C3DView::DrawModel()
 
 		glBegin( GL_LINES );
 
-		glColor3f( 1.0f, 0, 0 );
+		g_pRenderContext->SetColor( 1.0f, 0, 0 );
 
 		glVertex3f( 0, 0, 0 );
 		glVertex3f( flLength, 0, 0 );
 
-		glColor3f( 0, 1, 0 );
+		g_pRenderContext->SetColor( 0, 1, 0 );
 
 		glVertex3f( 0, 0, 0 );
 		glVertex3f( 0, flLength, 0 );
 
-		glColor3f( 0, 0, 1.0f );
+		g_pRenderContext->SetColor( 0, 0, 1.0f );
 
 		glVertex3f( 0, 0, 0 );
 		glVertex3f( 0, 0, flLength );
@@ -731,6 +987,7 @@ void C3DView::DrawModel()
 	g_pStudioMdlRenderer->SetViewerRight( -vecViewerRight );
 
 	const unsigned int uiOldPolys = g_pStudioMdlRenderer->GetDrawnPolygonsCount();
+	const unsigned int uiOldSkinnedSubModels = g_pStudioMdlRenderer->GetSkinnedSubModelsCount();
 
 	auto pEntity = m_pHLMV->GetState()->GetEntity();
 
@@ -755,7 +1012,7 @@ void C3DView::DrawModel()
 		//Determine if an odd number of scale values are negative. The cull face has to be changed if so.
 		const float flScale = vecScale.x * vecScale.y * vecScale.z;
 
-		glCullFace( flScale > 0 ? GL_FRONT : GL_BACK );
+		g_pRenderContext->SetCullFace( flScale > 0 ? renderer::CullFace::FRONT : renderer::CullFace::BACK );
 
 		renderer::DrawFlags_t flags = renderer::DrawFlag::NONE;
 
@@ -793,19 +1050,20 @@ void C3DView::DrawModel()
 	}
 
 	m_pHLMV->GetState()->drawnPolys = g_pStudioMdlRenderer->GetDrawnPolygonsCount() - uiOldPolys;
+	m_pHLMV->GetState()->skinnedSubModels = g_pStudioMdlRenderer->GetSkinnedSubModelsCount() - uiOldSkinnedSubModels;
 
 	if (m_pHLMV->GetState()->drawPlayerHitbox)
 	{
 		//Draw a transparent green box to display the player hitbox
-		glDisable(GL_TEXTURE_2D);
-		glDisable(GL_CULL_FACE);
-		glEnable(GL_DEPTH_TEST);
+		g_pRenderContext->Disable(renderer::Capability::TEXTURE_2D);
+		g_pRenderContext->Disable(renderer::Capability::CULL_FACE);
+		g_pRenderContext->Enable(renderer::Capability::DEPTH_TEST);
 
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		g_pRenderContext->SetPolygonMode(renderer::PolygonMode::FILL);
+		g_pRenderContext->Enable(renderer::Capability::BLEND);
+		g_pRenderContext->SetBlendFunc(renderer::BlendFactor::SRC_ALPHA, renderer::BlendFactor::ONE_MINUS_SRC_ALPHA);
 
-		glColor4f(0.0f, 1.0f, 0.0f, 0.5f);
+		g_pRenderContext->SetColor(0.0f, 1.0f, 0.0f, 0.5f);
 
 		const glm::vec3 bbmin{-16, -16, 0};
 		const glm::vec3 bbmax{16, 16, 72};
@@ -844,13 +1102,13 @@ void C3DView::DrawModel()
 		v[7][1] = bbmin[1];
 		v[7][2] = bbmax[2];
 
-		graphics::DrawBox(v);
+		graphics::DrawBox(g_pRenderContext, v);
 
 		//Draw dark green edges
-		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-		glColor4f(0.0f, 0.5f, 0.0f, 0.5f);
+		g_pRenderContext->SetPolygonMode(renderer::PolygonMode::LINE);
+		g_pRenderContext->SetColor(0.0f, 0.5f, 0.0f, 0.5f);
 
-		graphics::DrawBox(v);
+		graphics::DrawBox(g_pRenderContext, v);
 	}
 
 	glPopMatrix();
@@ -887,74 +1145,6 @@ void C3DView::UnloadGroundTexture()
 	glDeleteTexture( m_GroundTexture );
 }
 
-/*
-*	Saves the given texture's UV map.
-*/
-void C3DView::SaveUVMap( const wxString& szFilename, const int iTexture )
-{
-	auto pEntity = m_pHLMV->GetState()->GetEntity();
-
-	if( !pEntity )
-		return;
-
-	auto pModel = pEntity->GetModel();
-
-	const studiohdr_t* const pHdr = pModel->GetTextureHeader();
-
-	if( !pHdr )
-		return;
-
-	const mstudiotexture_t& texture = ( ( mstudiotexture_t* ) ( ( byte* ) pHdr + pHdr->textureindex ) )[ iTexture ];
-
-	SetCurrent( *GetContext() );
-
-	//Save off all settings we're about to modify
-	//Don't need to restore the viewport since it's reset every frame anyway
-	GLint oldReadBuffer;
-	GLint oldDrawBuffer;
-	GLint oldPackAlignment;
-
-	glGetIntegerv( GL_READ_BUFFER, &oldReadBuffer );
-	glGetIntegerv( GL_DRAW_BUFFER, &oldDrawBuffer );
-	glGetIntegerv( GL_PACK_ALIGNMENT, &oldPackAlignment );
-
-	//Use the back buffer to avoid modifying displayed data
-	glReadBuffer( GL_BACK );
-	glDrawBuffer( GL_BACK );
-
-	//Set pack alignment to 1 so no padding is added
-	glPixelStorei( GL_PACK_ALIGNMENT, 1 );
-
-	glViewport( 0, 0, texture.width, texture.height );
-
-	glClearColor( 0.0f, 0.0f, 0.0f, 1.0f );
-
-	glClear( GL_COLOR_BUFFER_BIT );
-
-	DrawTexture( 0, 0, texture.width, texture.height, pEntity, iTexture, 1.0f, true, false, false, m_pHLMV->GetState()->pUVMesh );
-
-	glFlush();
-	glFinish();
-
-	std::unique_ptr<byte[]> rgbData = std::make_unique<byte[]>( texture.width * texture.height * 3 );
-
-	glReadPixels( 0, 0, texture.width, texture.height, GL_RGB, GL_UNSIGNED_BYTE, rgbData.get() );
-
-	glReadBuffer( oldReadBuffer );
-	glDrawBuffer( oldDrawBuffer );
-	glPixelStorei( GL_PACK_ALIGNMENT, oldPackAlignment );
-
-	//We have to flip the image vertically, since OpenGL reads it upside down.
-	graphics::FlipImageVertically( texture.width, texture.height, rgbData.get() );
-
-	wxImage image( texture.width, texture.height, rgbData.get(), true );
-
-	if( !image.SaveFile( szFilename, wxBITMAP_TYPE_BMP ) )
-	{
-		wxMessageBox( wxString::Format( "Failed to save image \"%s\"!", szFilename.c_str() ) );
-	}
-}
-
 void C3DView::TakeScreenshot()
 {
 	SetCurrent( *GetContext() );
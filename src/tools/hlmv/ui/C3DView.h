@@ -16,6 +16,8 @@
 #include "graphics/CCamera.h"
 
 #include "shared/studiomodel/studio.h"
+#include "shared/studiomodel/CStudioHitboxQuery.h"
+#include "shared/studiomodel/CStudioModelPicker.h"
 
 class CStudioModelEntity;
 
@@ -39,6 +41,15 @@ private:
 
 	static const int GUIDELINES_EDGE_WIDTH = 4;
 
+	static const int PROFILER_OVERLAY_OFFSET = 10;
+	static const int PROFILER_OVERLAY_BAR_WIDTH = 2;
+	static const int PROFILER_OVERLAY_MAX_HEIGHT = 150;
+
+	/**
+	*	Vertical scale of the profiler overlay, in pixels per millisecond.
+	*/
+	static constexpr float PROFILER_OVERLAY_SCALE = 3.0f;
+
 public:
 	C3DView( wxWindow* pParent, CModelViewerApp* const pHLMV, CMainPanel* const pMainPanel);
 	~C3DView();
@@ -57,8 +68,6 @@ public:
 	bool LoadGroundTexture( const wxString& szFilename );
 	void UnloadGroundTexture();
 
-	void SaveUVMap( const wxString& szFilename, const int iTexture );
-
 	void TakeScreenshot();
 
 protected:
@@ -78,6 +87,13 @@ private:
 
 	void MouseEvents( wxMouseEvent& event );
 
+	/**
+	*	Finds what's under the cursor on the posed model and shows it in the status bar.
+	*	@param iX Cursor X position, in client coordinates
+	*	@param iY Cursor Y position, in client coordinates
+	*/
+	void UpdatePick( const int iX, const int iY );
+
 	void SetupRenderMode( RenderMode renderMode = RenderMode::INVALID );
 
 	void DrawTexture( const int iTexture, const float flTextureScale, const bool bShowUVMap, const bool bOverlayUVMap, const bool bAntiAliasLines, const mstudiomesh_t* const pUVMesh );
@@ -104,6 +120,11 @@ private:
 
 	void DrawModel();
 
+	/**
+	*	Draws the frame history of the profiler as stacked bars, one per frame. Each color is a timed zone; gray is time not covered by any zone.
+	*/
+	void DrawProfilerOverlay();
+
 private:
 	CModelViewerApp* const m_pHLMV;
 
@@ -125,6 +146,9 @@ private:
 
 	float m_flOldTextureScale;
 
+	studiomdl::CStudioModelPicker m_Picker;
+	studiomdl::CStudioHitboxQuery m_HitboxQuery;
+
 	GLuint m_BackgroundTexture	= GL_INVALID_TEXTURE_ID;
 	GLuint m_GroundTexture		= GL_INVALID_TEXTURE_ID;
 
@@ -16,6 +16,7 @@
 #include "controlpanels/CGlobalFlagsPanel.h"
 
 #include "shared/studiomodel/CStudioModel.h"
+#include "shared/studiomodel/CStudioModelCache.h"
 #include "shared/renderer/studiomodel/IStudioModelRenderer.h"
 #include "game/entity/CStudioModelEntity.h"
 #include "game/entity/CBaseEntityList.h"
@@ -65,7 +66,9 @@ CMainPanel::CMainPanel( wxWindow* pParent, CModelViewerApp* const pHLMV )
 
 	m_pDrawnPolys = new wxStaticText( m_pMainControlBar, wxID_ANY, "Drawn Polys: Undefined" );
 
-	m_pFPS = new wxStaticText( m_pMainControlBar, wxID_ANY, "FPS: 0" );
+	m_pSkinnedSubModels = new wxStaticText( m_pMainControlBar, wxID_ANY, "Skinned Submodels: Undefined" );
+
+	m_pFPS = new wxStaticText( m_pMainControlBar, wxID_ANY, "FPS: 0 (0 skipped)" );
 
 	m_pLightVector = new wxStaticText( m_pMainControlBar, wxID_ANY, "Light Vector: 0 0 0" );
 
@@ -120,6 +123,7 @@ CMainPanel::CMainPanel( wxWindow* pParent, CModelViewerApp* const pHLMV )
 
 	pBarSizer->Add( m_pViewOrigin, wxGBPosition( iRow++, 0 ), wxGBSpan( 1, 2 ) );
 	pBarSizer->Add( m_pDrawnPolys, wxGBPosition( iRow++, 0 ), wxGBSpan( 1, 1 ), wxALIGN_CENTER_VERTICAL );
+	pBarSizer->Add( m_pSkinnedSubModels, wxGBPosition( iRow++, 0 ), wxGBSpan( 1, 1 ), wxALIGN_CENTER_VERTICAL );
 	pBarSizer->Add( m_pFPS, wxGBPosition( iRow++, 0 ), wxGBSpan( 1, 1 ), wxALIGN_CENTER_VERTICAL );
 	pBarSizer->Add( m_pLightVector, wxGBPosition( iRow++, 0 ), wxGBSpan( 1, 1 ), wxALIGN_CENTER_VERTICAL | wxEXPAND );
 	pBarSizer->Add( m_pResetLightVector, wxGBPosition( iRow, 0 ), wxGBSpan( 1, 1 ), wxEXPAND);
@@ -202,14 +206,21 @@ void CMainPanel::SaveWindowSettings()
 
 void CMainPanel::RunFrame()
 {
-	++m_uiCurrentFPS;
-
 	const long long iCurrentTick = GetCurrentTick();
 
 	ForEachPanel( &CBaseControlPanel::ViewPreUpdate );
 
 	m_p3DView->UpdateView();
 
+	if( m_pHLMV->GetState()->WasLastFrameSkipped() )
+	{
+		++m_uiCurrentSkippedFrames;
+	}
+	else
+	{
+		++m_uiCurrentFPS;
+	}
+
 	//Don't update if it's identical. Prevents flickering.
 	if( m_uiOldDrawnPolys != m_pHLMV->GetState()->drawnPolys )
 	{
@@ -217,14 +228,21 @@ void CMainPanel::RunFrame()
 		m_pDrawnPolys->SetLabelText( wxString::Format( "Drawn Polys: %u", m_pHLMV->GetState()->drawnPolys ) );
 	}
 
+	if( m_uiOldSkinnedSubModels != m_pHLMV->GetState()->skinnedSubModels )
+	{
+		m_uiOldSkinnedSubModels = m_pHLMV->GetState()->skinnedSubModels;
+		m_pSkinnedSubModels->SetLabelText( wxString::Format( "Skinned Submodels: %u", m_pHLMV->GetState()->skinnedSubModels ) );
+	}
+
 	//Update FPS.
 	if( iCurrentTick - m_iLastFPSUpdate >= 1000 )
 	{
 		m_iLastFPSUpdate = iCurrentTick;
 
-		m_pFPS->SetLabelText( wxString::Format( "FPS: %u", m_uiCurrentFPS ) );
+		m_pFPS->SetLabelText( wxString::Format( "FPS: %u (%u skipped)", m_uiCurrentFPS, m_uiCurrentSkippedFrames ) );
 
 		m_uiCurrentFPS = 0;
+		m_uiCurrentSkippedFrames = 0;
 	}
 
 	const glm::vec3 vecLight = g_pStudioMdlRenderer->GetLightVector();
@@ -243,6 +261,8 @@ bool CMainPanel::LoadModel( const wxString& szFilename )
 {
 	m_p3DView->PrepareForLoad();
 
+	DetachChangedModel();
+
 	m_pHLMV->GetState()->ResetModelData();
 
 	m_pHLMV->GetState()->ClearEntity();
@@ -251,15 +271,15 @@ bool CMainPanel::LoadModel( const wxString& szFilename )
 
 	try
 	{
-		auto pModel = studiomdl::LoadStudioModel(szFilename.utf8_str());
-	
+		auto model = m_pHLMV->GetModelCache()->Load(szFilename.utf8_str());
+
 		CHLMVStudioModelEntity* pEntity = static_cast<CHLMVStudioModelEntity*>( CBaseEntity::Create( "studiomodel", glm::vec3(), glm::vec3(), false ) );
 
 		if( pEntity )
 		{
 			pEntity->m_pState = m_pHLMV->GetState();
 
-			pEntity->SetModel( pModel.release() );
+			pEntity->SetModel( std::move( model ) );
 
 			pEntity->Spawn();
 
@@ -284,14 +304,50 @@ void CMainPanel::FreeModel()
 {
 	m_p3DView->PrepareForLoad();
 
+	DetachChangedModel();
+
 	m_pHLMV->GetState()->ClearEntity();
 }
 
+bool CMainPanel::ReloadModel( studiomdl::StudioModelFiles&& files )
+{
+	auto pEntity = m_pHLMV->GetState()->GetEntity();
+
+	if( !pEntity )
+		return false;
+
+	m_p3DView->PrepareForLoad();
+
+	auto pOldModel = pEntity->GetModel();
+
+	//The new model takes the textures that didn't change from the old one, so the cache can't hand out the old one anymore
+	m_pHLMV->GetModelCache()->Detach( pOldModel );
+
+	pEntity->SetModel( studiomdl::CreateStudioModel( std::move( files ), pOldModel ) );
+
+	ForEachPanel( &CBaseControlPanel::ModelReloaded );
+
+	//The frame that reloads the model has already checked for changes
+	m_pHLMV->GetState()->RequestRedraw();
+
+	return true;
+}
+
+void CMainPanel::DetachChangedModel()
+{
+	if( auto pEntity = m_pHLMV->GetState()->GetEntity(); pEntity && m_pHLMV->GetState()->modelChanged )
+	{
+		m_pHLMV->GetModelCache()->Detach( pEntity->GetModel() );
+	}
+}
+
 void CMainPanel::InitializeUI()
 {
 	ForEachPanel( &CBaseControlPanel::InitializeUI );
 
 	g_pStudioMdlRenderer->SetLightVector( DEFAULT_LIGHT_VECTOR );
+
+	m_pHLMV->GetState()->RequestRedraw();
 }
 
 void CMainPanel::PageChanged( wxBookCtrlEvent& event )
@@ -334,11 +390,6 @@ void CMainPanel::UnloadGroundTexture()
 	m_p3DView->UnloadGroundTexture();
 }
 
-void CMainPanel::SaveUVMap( const wxString& szFilename, const int iTexture )
-{
-	m_p3DView->SaveUVMap( szFilename, iTexture );
-}
-
 void CMainPanel::TakeScreenshot()
 {
 	m_p3DView->TakeScreenshot();
@@ -360,6 +411,8 @@ void CMainPanel::ViewOriginChanged( wxCommandEvent& event )
 void CMainPanel::ResetLightVector( wxCommandEvent& event )
 {
 	g_pStudioMdlRenderer->SetLightVector( DEFAULT_LIGHT_VECTOR );
+
+	m_pHLMV->GetState()->RequestRedraw();
 }
 
 void CMainPanel::OnGoFullscreen(wxCommandEvent& event)
@@ -13,6 +13,11 @@
 
 #include "C3DView.h"
 
+namespace studiomdl
+{
+struct StudioModelFiles;
+}
+
 namespace hlmv
 {
 class CModelViewerApp;
@@ -57,6 +62,12 @@ public:
 
 	void FreeModel();
 
+	/**
+	*	@brief Replaces the current model with a newer version of its files, keeping the view and the entity's settings
+	*	@return Whether the model was replaced
+	*/
+	bool ReloadModel( studiomdl::StudioModelFiles&& files );
+
 	void InitializeUI();
 
 	void PageChanged( wxBookCtrlEvent& event );
@@ -67,8 +78,6 @@ public:
 	bool LoadGroundTexture( const wxString& szFilename );
 	void UnloadGroundTexture();
 
-	void SaveUVMap( const wxString& szFilename, const int iTexture );
-
 	void TakeScreenshot();
 
 protected:
@@ -92,6 +101,11 @@ private:
 		}
 	}
 
+	/**
+	*	@brief If the current model has unsaved changes, removes it from the model cache so it isn't given out again
+	*/
+	void DetachChangedModel();
+
 	void OnPostDraw( studiomdl::IStudioModelRenderer& renderer, const studiomdl::CModelRenderInfo& info ) override final;
 
 	void ViewOriginChanged( wxCommandEvent& event );
@@ -116,11 +130,14 @@ private:
 	wxButton* m_pGoFullscreen;
 
 	unsigned int m_uiOldDrawnPolys = -1;
+	unsigned int m_uiOldSkinnedSubModels = -1;
 
 	wxStaticText* m_pDrawnPolys;
+	wxStaticText* m_pSkinnedSubModels;
 
 	long long m_iLastFPSUpdate = GetCurrentTick();
 	unsigned int m_uiCurrentFPS = 0;
+	unsigned int m_uiCurrentSkippedFrames = 0;
 
 	wxStaticText* m_pFPS;
 
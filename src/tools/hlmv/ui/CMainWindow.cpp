@@ -1,6 +1,6 @@
 #include <cstdio>
+#include <filesystem>
 
-#include <wx/dir.h>
 #include <wx/filename.h>
 
 #include "wx/CwxOpenGL.h"
@@ -10,6 +10,7 @@
 #include "common/CProcessDialog.h"
 #include "wx/utility/wxUtil.h"
 
+#include "engine/shared/studiomodel/CStudioModelCache.h"
 #include "engine/shared/studiomodel/studio.h"
 
 #include "CModelViewerApp.h"
@@ -30,6 +31,14 @@
 
 namespace hlmv
 {
+static cvar::CCVar model_autoreload("model_autoreload",
+	cvar::CCVarArgsBuilder()
+	.Flags(cvar::Flag::ARCHIVE)
+	.FloatValue(1)
+	.MinValue(0)
+	.MaxValue(1)
+	.HelpInfo("Whether to reload the current model when its files change on disk"));
+
 wxBEGIN_EVENT_TABLE( CMainWindow, ui::CwxBaseFrame )
 	EVT_MENU( wxID_MAINWND_LOADMODEL, CMainWindow::LoadModel )
 	EVT_MENU(wxID_MAINWND_LOADPREVIOUSMODEL, CMainWindow::OnLoadPreviousModel)
@@ -57,6 +66,8 @@ CMainWindow::CMainWindow( CModelViewerApp* const pHLMV )
 	: CwxBaseFrame( nullptr, wxID_ANY, HLMV_TITLE, wxDefaultPosition, wxSize( 600, 400 ), wxDEFAULT_FRAME_STYLE | wxWANTS_CHARS)
 	, m_pHLMV( pHLMV )
 	, m_RecentFiles( pHLMV->GetSettings()->GetRecentFiles() )
+	//The frame loop stops when nothing changes, so it has to be restarted to pick up a reloaded model
+	, m_ModelFileWatcher( []{ wxWakeUpIdle(); } )
 {
 	pHLMV->SetMainWindow( this );
 
@@ -185,6 +196,8 @@ CMainWindow::~CMainWindow()
 
 void CMainWindow::RunFrame()
 {
+	ReloadChangedModel();
+
 	m_pMainPanel->RunFrame();
 }
 
@@ -233,11 +246,20 @@ bool CMainWindow::LoadModel( const wxString& szFilename )
 
 		m_RecentFiles.Refresh();
 
+		//Start scanning the model's directory now so next/previous model navigation doesn't have to wait for it
+		m_ModelDirectoryCache.SetDirectory(std::filesystem::u8path(file.GetPath().utf8_str().data()));
+
+		m_ModelFileWatcher.Watch(std::filesystem::u8path(szAbsFilename.utf8_str().data()));
+
 		Message( "Loaded model \"%s\"\n", szAbsFilename.utf8_str().data());
 	}
 	else
+	{
 		this->ClearTitleContent();
 
+		m_ModelFileWatcher.Stop();
+	}
+
 	m_pLoadPreviousModel->Enable(bSuccess);
 	m_pLoadNextModel->Enable(bSuccess);
 
@@ -276,13 +298,22 @@ bool CMainWindow::SaveModel( const wxString& szFilename, bool correctSequenceGro
 	{
 		auto pModel = m_pHLMV->GetState()->GetEntity()->GetModel();
 
-		studiomdl::SaveStudioModel(fullPath.utf8_str(), *pModel, correctSequenceGroupFileNames);
+		const auto result = studiomdl::SaveStudioModel(fullPath.utf8_str(), *pModel, correctSequenceGroupFileNames);
+
+		Message( "Saved model \"%s\": %zu files written (%ju bytes), %zu unchanged\n",
+			fullPath.utf8_str().data(), result.FilesWritten, result.BytesWritten, result.FilesUnchanged );
+
+		//The model no longer matches the file it was cached for
+		m_pHLMV->GetModelCache()->Detach(pModel);
 
 		m_pHLMV->GetState()->modelChanged = false;
 
 		//Update filename to match current model
 		pModel->SetFileName(fullPath.ToStdString());
 
+		//Watch the file that was saved to, without counting the save as a change
+		m_ModelFileWatcher.Watch(std::filesystem::u8path(fullPath.utf8_str().data()));
+
 		SetTitleContent(fullPath);
 
 		return true;
@@ -359,11 +390,6 @@ void CMainWindow::UnloadGroundTexture()
 	m_pMainPanel->UnloadGroundTexture();
 }
 
-void CMainWindow::SaveUVMap( const wxString& szFilename, const int iTexture )
-{
-	m_pMainPanel->SaveUVMap( szFilename, iTexture );
-}
-
 void CMainWindow::CenterView()
 {
 	m_pHLMV->GetState()->CenterView();
@@ -412,6 +438,36 @@ bool CMainWindow::ShowUnsavedWarning()
 	return dlg.ShowModal() == wxID_YES;
 }
 
+void CMainWindow::ReloadChangedModel()
+{
+	studiomdl::StudioModelFiles files;
+	std::string errorMessage;
+
+	if (!m_ModelFileWatcher.TakeChangedFiles(files, errorMessage) || !model_autoreload.GetBool())
+	{
+		return;
+	}
+
+	if (!files.MainHeader)
+	{
+		Warning("Couldn't reload the model: %s\n", errorMessage.c_str());
+		return;
+	}
+
+	if (m_pHLMV->GetState()->modelChanged)
+	{
+		Warning("The model \"%s\" changed on disk, but was not reloaded because it has unsaved changes\n", files.FileName.c_str());
+		return;
+	}
+
+	const auto fileName = files.FileName;
+
+	if (m_pMainPanel->ReloadModel(std::move(files)))
+	{
+		Message("Reloaded model \"%s\"\n", fileName.c_str());
+	}
+}
+
 void CMainWindow::LoadModel( wxCommandEvent& event )
 {
 	PromptLoadModel();
@@ -433,84 +489,16 @@ void CMainWindow::LoadModelRelativeToCurrent(bool next)
 
 		fileName.MakeAbsolute();
 
-		wxArrayString files;
+		const auto directory{std::filesystem::u8path(fileName.GetPath().utf8_str().data())};
 
-		wxDir::GetAllFiles(fileName.GetPath(), &files, "*.mdl", wxDIR_FILES | wxDIR_NO_FOLLOW);
+		m_ModelDirectoryCache.SetDirectory(directory);
 
-		const auto targetIndex = files.Index(fileName.GetFullPath());
+		//Only main headers are considered; texture and sequence group files can't be loaded by themselves
+		const auto result{m_ModelDirectoryCache.FindRelativeModel(directory / std::filesystem::u8path(fileName.GetFullName().utf8_str().data()), next)};
 
-		if (targetIndex != -1 && files.size() > 1)
+		if (!result.empty())
 		{
-			//A valid model file must be:
-			//1. a studio model version 10 file with header id IDST
-			//2. not be a texture file (name[0] == '\0')
-			auto testValidFile = [](const wxString& fileName)
-			{
-				bool isValid = false;
-
-				if (FILE* file = utf8_fopen(fileName.utf8_str(), "rb"); file)
-				{
-					studiohdr_t header;
-
-					if (fread(&header, sizeof(studiohdr_t), 1, file) == 1)
-					{
-						if (!strncmp(reinterpret_cast<const char*>(&header.id), STUDIOMDL_HDR_ID, 4))
-						{
-							if (header.version == STUDIO_VERSION)
-							{
-								if (header.name[0] != '\0')
-								{
-									isValid = true;
-								}
-							}
-						}
-					}
-
-					fclose(file);
-				}
-
-				return isValid;
-			};
-
-			wxString result;
-
-			if (next)
-			{
-				for (auto index = targetIndex + 1; index != targetIndex; ++index)
-				{
-					if (index >= files.size())
-					{
-						index = 0;
-					}
-
-					if (testValidFile(files[index]))
-					{
-						result = files[index];
-						break;
-					}
-				}
-			}
-			else
-			{
-				for (auto index = targetIndex - 1; index != targetIndex; --index)
-				{
-					if (index < 0)
-					{
-						index = files.size() - 1;
-					}
-
-					if (testValidFile(files[index]))
-					{
-						result = files[index];
-						break;
-					}
-				}
-			}
-
-			if (!result.empty())
-			{
-				LoadModel(result);
-			}
+			LoadModel(wxString::FromUTF8(result.u8string().c_str()));
 		}
 	}
 }
@@ -571,6 +559,8 @@ void CMainWindow::OnClose( wxCloseEvent& event )
 	//Clear the studio model here, while the context is still valid.
 	m_pMainPanel->FreeModel();
 
+	m_ModelFileWatcher.Stop();
+
 	Destroy();
 	DestroyChildren();
 
@@ -8,6 +8,9 @@
 #include "../settings/CHLMVSettings.h"
 #include "../CHLMVState.h"
 
+#include "engine/shared/studiomodel/CModelDirectoryCache.h"
+#include "engine/shared/studiomodel/CModelFileWatcher.h"
+
 #include "wx/utility/CwxRecentFiles.h"
 #include "common/CwxBaseFrame.h"
 
@@ -60,8 +63,6 @@ public:
 
 	void UnloadGroundTexture();
 
-	void SaveUVMap( const wxString& szFilename, const int iTexture );
-
 	void CenterView();
 
 	void SaveView();
@@ -79,6 +80,11 @@ private:
 
 	bool ShowUnsavedWarning();
 
+	/**
+	*	@brief Reloads the current model if its files changed on disk
+	*/
+	void ReloadChangedModel();
+
 	void LoadModel( wxCommandEvent& event );
 
 	void LoadModelRelativeToCurrent(bool next);
@@ -121,6 +127,10 @@ private:
 
 	ui::CwxRecentFiles m_RecentFiles;
 
+	studiomdl::CModelDirectoryCache m_ModelDirectoryCache;
+
+	studiomdl::CModelFileWatcher m_ModelFileWatcher;
+
 private:
 	CMainWindow( const CMainWindow& ) = delete;
 	CMainWindow& operator=( const CMainWindow& ) = delete;
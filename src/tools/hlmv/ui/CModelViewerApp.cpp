@@ -4,10 +4,13 @@
 #include <wx/private/timer.h>
 
 #include "shared/Logging.h"
+#include "utility/CCommand.h"
 #include "utility/PlatUtils.h"
 
+#include "core/shared/CProfiler.h"
 #include "core/shared/CWorldTime.h"
 
+#include "cvar/CConCommand.h"
 #include "cvar/CVar.h"
 #include "cvar/CCVarSystem.h"
 
@@ -21,9 +24,11 @@
 #include "soundsystem/ISoundSystem.h"
 
 #include "engine/renderer/gl/imode/CRenderContextIMode.h"
+#include "engine/renderer/gl/vbo/CRenderContextVBO.h"
 #include "engine/renderer/studiomodel/CStudioModelRenderer.h"
 #include "engine/shared/renderer/IRenderContext.h"
 #include "engine/shared/renderer/studiomodel/IStudioModelRenderer.h"
+#include "engine/shared/studiomodel/CStudioModelCache.h"
 
 #include "CFullscreenWindow.h"
 #include "CMainWindow.h"
@@ -65,6 +70,27 @@ static cvar::CCVar max_fps(
 	.Flags(cvar::Flag::ARCHIVE)
 );
 
+static void FrameStats(const util::CCommand& args)
+{
+	auto pState = wxGetApp().GetState();
+
+	const auto framesDrawn = pState->GetFramesDrawnCount();
+	const auto framesSkipped = pState->GetFramesSkippedCount();
+	const auto totalFrames = framesDrawn + framesSkipped;
+
+	Message("%llu frames drawn, %llu skipped because nothing changed (%.1f%%)\n",
+		framesDrawn, framesSkipped, totalFrames > 0 ? (100.0 * framesSkipped) / totalFrames : 0.0);
+
+	const auto& stateChanges = g_pRenderContext->GetStateChangeStats();
+	const auto totalStateChanges = stateChanges.uiIssued + stateChanges.uiFiltered;
+
+	Message("Last frame: %u state changes issued, %u filtered because they changed nothing (%.1f%%)\n",
+		stateChanges.uiIssued, stateChanges.uiFiltered, totalStateChanges > 0 ? (100.0 * stateChanges.uiFiltered) / totalStateChanges : 0.0);
+}
+
+static cvar::CConCommand frame_stats("frame_stats", &FrameStats, cvar::Flag::NONE,
+	"Prints how many frames the 3D view drew and how many it skipped because nothing changed, and how many state changes the last frame made");
+
 bool CModelViewerApp::OnInit()
 {
 	if (!wxApp::OnInit())
@@ -109,6 +135,8 @@ void CModelViewerApp::OnInitCmdLine( wxCmdLineParser& parser )
 {
 	wxApp::OnInitCmdLine( parser );
 
+	parser.AddOption( "renderer", wxEmptyString, "Renderer to use: \"imode\" (default) or \"vbo\"", wxCMD_LINE_VAL_STRING );
+
 	//Note: this works by setting all available parameters in the order that they appear on the command line.
 	//The model filename must be last for this to work with drag&drop.
 	parser.AddParam( "Filename of the model to load on startup", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL );
@@ -120,6 +148,8 @@ bool CModelViewerApp::OnCmdLineParsed( wxCmdLineParser& parser )
 	if( parser.GetParamCount() > 0 )
 		m_szModel = parser.GetParam( parser.GetParamCount() - 1 );
 
+	parser.Found( "renderer", &m_szRenderer );
+
 	return wxApp::OnCmdLineParsed( parser );
 }
 
@@ -186,8 +216,22 @@ bool CModelViewerApp::Startup()
 	m_pFileSystem = new filesystem::CFileSystem();
 	g_pCVar = new cvar::CCVarSystem();
 	g_pSoundSystem = m_pSoundSystem = new soundsystem::CSoundSystem();
-	g_pRenderContext = new renderer::CRenderContextIMode();
-	g_pStudioMdlRenderer = new studiomdl::CStudioModelRenderer();
+
+	if (m_szRenderer.IsEmpty() || m_szRenderer == "imode")
+	{
+		g_pRenderContext = new renderer::CRenderContextIMode();
+	}
+	else if (m_szRenderer == "vbo")
+	{
+		g_pRenderContext = new renderer::CRenderContextVBO();
+	}
+	else
+	{
+		Warning("Unknown renderer \"%s\", using immediate mode\n", m_szRenderer.c_str().AsChar());
+		g_pRenderContext = new renderer::CRenderContextIMode();
+	}
+
+	g_pStudioMdlRenderer = new studiomdl::CStudioModelRenderer(g_pRenderContext);
 
 	if (!g_pCVar->Initialize())
 	{
@@ -248,6 +292,7 @@ bool CModelViewerApp::Startup()
 
 	m_pState = new CHLMVState();
 	m_pSettings = new CHLMVSettings(m_pFileSystem);
+	m_pModelCache = new studiomdl::CStudioModelCache();
 
 	//TODO: fix on Linux - Solokiller
 	m_ToolIcon = wxICON(HLMV_ICON);
@@ -310,6 +355,13 @@ void CModelViewerApp::Shutdown()
 
 	EntityManager().Shutdown();
 
+	//Models own textures, so destroy them while the context still exists
+	if( m_pModelCache )
+	{
+		delete m_pModelCache;
+		m_pModelCache = nullptr;
+	}
+
 	if( m_pSettings )
 	{
 		delete m_pSettings;
@@ -368,7 +420,14 @@ void CModelViewerApp::Shutdown()
 
 void CModelViewerApp::RunFrame()
 {
-	EntityManager().RunFrame();
+	{
+		PROFILE_SCOPE("EntityManager::RunFrame");
+		EntityManager().RunFrame();
+	}
+
+	m_pState->CheckForChanges();
+
+	PROFILE_SCOPE("Window::RunFrame");
 
 	if( m_pFullscreenWindow )
 		m_pFullscreenWindow->RunFrame();
@@ -398,20 +457,71 @@ void CModelViewerApp::OnTick()
 
 	WorldTime.TimeChanged(flCurTime);
 
-	g_pCVar->RunFrame();
+	auto& frameProfiler = profiler::Profiler();
+
+	frameProfiler.BeginFrame();
+
+	{
+		PROFILE_SCOPE("CVarSystem::RunFrame");
+		g_pCVar->RunFrame();
+	}
 
-	g_pStudioMdlRenderer->RunFrame();
+	{
+		PROFILE_SCOPE("StudioModelRenderer::RunFrame");
+		g_pStudioMdlRenderer->RunFrame();
+	}
 
-	m_pSoundSystem->RunFrame();
+	{
+		PROFILE_SCOPE("SoundSystem::RunFrame");
+		m_pSoundSystem->RunFrame();
+	}
 
 	RunFrame();
+
+	frameProfiler.EndFrame();
 }
 
-void CModelViewerApp::OnIdle(wxIdleEvent& event)
+int CModelViewerApp::FilterEvent(wxEvent& event)
 {
-	event.RequestMore();
+	if (m_pState)
+	{
+		const auto type = event.GetEventType();
 
+		bool isUserInput = false;
+
+		if (event.IsCommandEvent())
+		{
+			//Update UI events are sent while idle, not in response to input
+			isUserInput = type != wxEVT_UPDATE_UI;
+		}
+		else if (type == wxEVT_KEY_DOWN || type == wxEVT_KEY_UP || type == wxEVT_CHAR || type == wxEVT_SIZE)
+		{
+			isUserInput = true;
+		}
+		else if (auto mouseEvent = dynamic_cast<const wxMouseEvent*>(&event); mouseEvent)
+		{
+			//Moving the mouse over a window doesn't change anything, clicking, dragging and scrolling might
+			isUserInput = mouseEvent->IsButton() || mouseEvent->ButtonIsDown(wxMOUSE_BTN_ANY) || type == wxEVT_MOUSEWHEEL;
+		}
+
+		if (isUserInput)
+		{
+			m_pState->RequestRedraw();
+		}
+	}
+
+	return Event_Skip;
+}
+
+void CModelViewerApp::OnIdle(wxIdleEvent& event)
+{
 	OnTick();
+
+	//Once nothing changes, stop ticking until the next event instead of spinning
+	if (!m_pState->WasLastFrameSkipped() || m_pState->IsRedrawRequested())
+	{
+		event.RequestMore();
+	}
 }
 
 void CModelViewerApp::OnTimerTick(wxTimerEvent& event)
@@ -601,8 +711,4 @@ void CModelViewerApp::UnloadGroundTexture()
 	m_pMainWindow->UnloadGroundTexture();
 }
 
-void CModelViewerApp::SaveUVMap( const wxString& szFilename, const int iTexture )
-{
-	m_pMainWindow->SaveUVMap( szFilename, iTexture );
-}
 }
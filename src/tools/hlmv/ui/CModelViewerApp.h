@@ -23,6 +23,11 @@ namespace soundsystem
 class ISoundSystem;
 }
 
+namespace studiomdl
+{
+class CStudioModelCache;
+}
+
 namespace ui
 {
 class CMessagesWindow;
@@ -48,10 +53,17 @@ public:
 
 	void HandleCVar(cvar::CCVar& cvar, const char* pszOldValue, float flOldValue) override;
 
+	/**
+	*	@brief Requests a redraw of the 3D view for any user input, since it could change any setting
+	*/
+	int FilterEvent(wxEvent& event) override;
+
 	CHLMVState* GetState() { return m_pState; }
 
 	CHLMVSettings* GetSettings() { return m_pSettings; }
 
+	studiomdl::CStudioModelCache* GetModelCache() { return m_pModelCache; }
+
 	CMainWindow* GetMainWindow() { return m_pMainWindow; }
 
 	void SetMainWindow( CMainWindow* const pMainWindow )
@@ -158,8 +170,6 @@ public:
 
 	void UnloadGroundTexture();
 
-	void SaveUVMap( const wxString& szFilename, const int iTexture );
-
 private:
 	filesystem::IFileSystem* m_pFileSystem = nullptr;
 	soundsystem::ISoundSystem* m_pSoundSystem = nullptr;
@@ -175,12 +185,15 @@ private:
 	CHLMVState* m_pState = nullptr;
 	CHLMVSettings* m_pSettings = nullptr;
 
+	studiomdl::CStudioModelCache* m_pModelCache = nullptr;
+
 	wxTimer* m_pTimer = nullptr;
 
 	CMainWindow* m_pMainWindow = nullptr;
 	CFullscreenWindow* m_pFullscreenWindow = nullptr;
 
 	wxString m_szModel;		//Model to load on startup, if any.
+	wxString m_szRenderer;	//Render context to use, if not the default.
 };
 }
 
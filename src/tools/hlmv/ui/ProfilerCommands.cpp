@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <vector>
+
+#include "shared/CProfiler.h"
+#include "shared/Logging.h"
+
+#include "cvar/CCVar.h"
+#include "cvar/CConCommand.h"
+
+#include "utility/CCommand.h"
+
+/**
+*	@file
+*
+*	Console variables and commands to control the frame profiler.
+*/
+
+namespace hlmv
+{
+namespace
+{
+const char* const DEFAULT_CAPTURE_FILENAME = "hlmv_trace.json";
+
+void ProfileOverlayChanged(cvar::CCVar& cvar, const char* pszOldValue, float flOldValue)
+{
+	profiler::Profiler().SetHistoryEnabled(cvar.GetBool());
+}
+
+void Profile_Capture(const util::CCommand& args)
+{
+	if (args.ArgC() < 2)
+	{
+		Message("Usage: profile_capture <frames> [filename]\nWrites the timings of the given number of frames to a Chrome trace file (default \"%s\")\n",
+			DEFAULT_CAPTURE_FILENAME);
+		return;
+	}
+
+	const auto uiFrameCount = static_cast<unsigned int>(strtoul(args.Arg(1), nullptr, 10));
+
+	if (uiFrameCount == 0)
+	{
+		Warning("profile_capture: the number of frames must be greater than 0\n");
+		return;
+	}
+
+	const auto fileName = std::filesystem::u8path(args.ArgC() >= 3 ? args.Arg(2) : DEFAULT_CAPTURE_FILENAME);
+
+	if (profiler::Profiler().StartCapture(uiFrameCount, fileName))
+	{
+		Message("Capturing %u frames\n", std::min(uiFrameCount, profiler::MAX_CAPTURE_FRAMES));
+	}
+}
+
+void Profile_Report(const util::CCommand& args)
+{
+	const auto& frameProfiler = profiler::Profiler();
+
+	const auto frameCount = frameProfiler.GetFrameCount();
+
+	if (frameCount == 0)
+	{
+		Message("No frames recorded, set profile_overlay to 1 to record frame timings\n");
+		return;
+	}
+
+	std::vector<std::uint64_t> totals(frameProfiler.GetZoneCount(), 0);
+	std::uint64_t totalDuration = 0;
+
+	for (size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+	{
+		const auto& frame = frameProfiler.GetFrame(frameIndex);
+
+		totalDuration += frame.Duration;
+
+		for (size_t zone = 0; zone < frame.ZoneSelfTimes.size(); ++zone)
+		{
+			totals[zone] += frame.ZoneSelfTimes[zone];
+		}
+	}
+
+	const double flScale = 1.0 / (frameCount * 1000000.0);
+
+	Message("Average self time over the last %u frames (%.3f ms per frame):\n", static_cast<unsigned int>(frameCount), totalDuration * flScale);
+
+	for (size_t zone = 0; zone < totals.size(); ++zone)
+	{
+		Message("%8.3f ms  %s\n", totals[zone] * flScale, frameProfiler.GetZoneName(zone));
+	}
+}
+}
+
+static cvar::CCVar profile_overlay("profile_overlay",
+	cvar::CCVarArgsBuilder().FloatValue(0).HelpInfo("Whether to record frame timings and show them as a histogram in the 3D view").Callback(&ProfileOverlayChanged));
+
+static cvar::CConCommand profile_capture("profile_capture", &Profile_Capture, cvar::Flag::NONE,
+	"Captures the timings of the given number of frames to a Chrome trace file");
+
+static cvar::CConCommand profile_report("profile_report", &Profile_Report, cvar::Flag::NONE,
+	"Prints the average time spent in each profiled zone over the recorded frame history");
+}
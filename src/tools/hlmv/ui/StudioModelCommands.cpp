@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "shared/Logging.h"
+
+#include "cvar/CConCommand.h"
+
+#include "engine/shared/studiomodel/CStudioModel.h"
+#include "engine/shared/studiomodel/StudioAnimationOptimizer.h"
+#include "engine/shared/studiomodel/StudioBounds.h"
+
+#include "game/entity/CStudioModelEntity.h"
+
+#include "utility/CCommand.h"
+
+#include "CModelViewerApp.h"
+
+/**
+*	@file
+*
+*	Console commands that work on the current model.
+*/
+
+namespace hlmv
+{
+namespace
+{
+void Studio_OptimizeAnims(const util::CCommand& args)
+{
+	auto pEntity = wxGetApp().GetState()->GetEntity();
+
+	if (!pEntity)
+	{
+		Warning("studio_optimize_anims: no model loaded\n");
+		return;
+	}
+
+	studiomdl::AnimationOptimizationSettings settings;
+
+	if (args.ArgC() >= 2)
+	{
+		settings.Tolerance = std::max(0, atoi(args.Arg(1)));
+	}
+
+	const auto pModel = pEntity->GetModel();
+
+	const auto results = studiomdl::OptimizeAnimations(*pModel, settings);
+
+	//The pose refers to the old animation data
+	pEntity->GetPose().Invalidate();
+
+	const auto pStudioHdr = pModel->GetStudioHeader();
+
+	std::size_t originalSize = 0;
+	std::size_t optimizedSize = 0;
+	double originalDecodeTime = 0;
+	double optimizedDecodeTime = 0;
+
+	for (const auto& result : results)
+	{
+		const auto pszName = pStudioHdr->GetSequence(result.Sequence)->label;
+
+		if (!result.Optimized)
+		{
+			Warning("%s: left as is, its animation data is shared, overlaps other data or is invalid\n", pszName);
+			continue;
+		}
+
+		Message("%s: %u -> %u bytes, %d -> %d channels, decoding %.1f -> %.1f us\n",
+			pszName,
+			static_cast<unsigned int>(result.OriginalSize), static_cast<unsigned int>(result.OptimizedSize),
+			result.OriginalChannels, result.OptimizedChannels,
+			result.OriginalDecodeTime * 1000000.0, result.OptimizedDecodeTime * 1000000.0);
+
+		originalSize += result.OriginalSize;
+		optimizedSize += result.OptimizedSize;
+		originalDecodeTime += result.OriginalDecodeTime;
+		optimizedDecodeTime += result.OptimizedDecodeTime;
+	}
+
+	if (optimizedSize == 0)
+	{
+		return;
+	}
+
+	Message("Animation data: %u -> %u bytes (%.1f%% saved), decoding %.1f -> %.1f us\n",
+		static_cast<unsigned int>(originalSize), static_cast<unsigned int>(optimizedSize),
+		originalSize > 0 ? (100.0 * (originalSize - optimizedSize)) / originalSize : 0.0,
+		originalDecodeTime * 1000000.0, optimizedDecodeTime * 1000000.0);
+
+	//Quantized frames can move the model outside of the bounds that were computed for the original frames
+	if (settings.Tolerance > 0)
+	{
+		const int updated = studiomdl::RecomputeSequenceBounds(*pModel);
+
+		Message("Recomputed the bounds of %d sequences\n", updated);
+	}
+
+	//The current pose and the hitboxes picked from it come from the old data until the model is drawn again
+	wxGetApp().GetState()->RequestRedraw();
+
+	wxGetApp().GetState()->modelChanged = true;
+}
+}
+
+static cvar::CConCommand studio_optimize_anims("studio_optimize_anims", &Studio_OptimizeAnims, cvar::Flag::NONE,
+	"Re-encodes the animations of the current model as compactly as possible. "
+	"Takes an optional tolerance: values that differ from the value before them by at most this much are made equal. "
+	"With the default of 0 every frame keeps its value, but poses between frames can change slightly where runs are merged");
+}
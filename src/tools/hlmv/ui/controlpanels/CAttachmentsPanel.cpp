@@ -119,7 +119,17 @@ void CAttachmentsPanel::InitializeUI()
 
 void CAttachmentsPanel::OnPostDraw( studiomdl::IStudioModelRenderer& renderer, const studiomdl::CModelRenderInfo& info )
 {
-	renderer.DrawSingleAttachment( m_pAttachments->GetSelection() );
+	auto pEntity = m_pHLMV->GetState()->GetEntity();
+
+	if( !pEntity || !pEntity->GetModel() )
+		return;
+
+	const int iAttachment = m_pAttachments->GetSelection();
+
+	if( iAttachment < 0 || iAttachment >= pEntity->GetModel()->GetStudioHeader()->numattachments )
+		return;
+
+	renderer.DrawSingleAttachment( pEntity->GetPose().GetAttachment( iAttachment ) );
 }
 
 void CAttachmentsPanel::SetAttachment( int iIndex )
@@ -36,6 +36,12 @@ public:
 
 	virtual void InitializeUI() {}
 
+	/**
+	*	Called when the model was replaced by a newer version of itself. The entity keeps its settings where possible.
+	*	Initializes the panel again by default.
+	*/
+	virtual void ModelReloaded() { InitializeUI(); }
+
 	//Called right before the 3D view is updated.
 	virtual void ViewPreUpdate() {}
 
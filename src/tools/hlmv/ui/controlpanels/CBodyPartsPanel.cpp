@@ -220,6 +220,42 @@ void CBodyPartsPanel::InitializeUI()
 	m_pBodyValue->SetValue( "0" );
 }
 
+void CBodyPartsPanel::ModelReloaded()
+{
+	auto pEntity = m_pHLMV->GetState()->GetEntity();
+
+	if( !pEntity )
+	{
+		InitializeUI();
+		return;
+	}
+
+	//Initializing resets the skin and shows the first submodel, so remember what the entity kept
+	const int iBodypart = m_pBodypart->GetSelection();
+	const int iController = m_pController->GetSelection();
+	const int iSkin = pEntity->GetSkin();
+
+	InitializeUI();
+
+	auto pModel = pEntity->GetModel();
+
+	if( pModel->GetStudioHeader()->numbodyparts > 0 )
+	{
+		SetBodypart( iBodypart );
+
+		m_pSubmodel->Select( pModel->GetBodygroupValue( m_pBodypart->GetSelection(), pEntity->GetBodygroup() ) );
+	}
+
+	m_pBodyValue->SetValue( wxString::Format( "%d", pEntity->GetBodygroup() ) );
+
+	if( iSkin < pModel->GetTextureHeader()->numskinfamilies )
+	{
+		SetSkin( iSkin );
+	}
+
+	SetController( iController );
+}
+
 void CBodyPartsPanel::BodypartChanged( wxCommandEvent& event )
 {
 	SetBodypart( m_pBodypart->GetSelection() );
@@ -23,6 +23,8 @@ public:
 
 	void InitializeUI() override;
 
+	void ModelReloaded() override;
+
 	void BodypartChanged( wxCommandEvent& event );
 
 	void SubmodelChanged( wxCommandEvent& event );
@@ -140,7 +140,17 @@ void CHitboxesPanel::InitializeUI()
 
 void CHitboxesPanel::OnPostDraw(studiomdl::IStudioModelRenderer& renderer, const studiomdl::CModelRenderInfo& info)
 {
-	renderer.DrawSingleHitbox(m_pHitboxes->GetSelection());
+	auto pEntity = m_pHLMV->GetState()->GetEntity();
+
+	if (!pEntity || !pEntity->GetModel())
+		return;
+
+	const int index = m_pHitboxes->GetSelection();
+
+	if (index < 0 || index >= pEntity->GetModel()->GetStudioHeader()->numhitboxes)
+		return;
+
+	renderer.DrawSingleHitbox(pEntity->GetPose().GetHitbox(index));
 }
 
 void CHitboxesPanel::SetHitbox(int index)
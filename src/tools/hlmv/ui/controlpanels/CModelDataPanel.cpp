@@ -1,10 +1,14 @@
 #include <cfloat>
+#include <chrono>
 #include <cstdint>
 
 #include <wx/gbsizer.h>
 #include <wx/textctrl.h>
 
+#include "shared/Logging.h"
+
 #include "shared/renderer/studiomodel/IStudioModelRenderer.h"
+#include "shared/studiomodel/StudioBounds.h"
 
 #include "../CModelViewerApp.h"
 #include "../../CHLMVState.h"
@@ -44,6 +48,10 @@ CModelDataPanel::CModelDataPanel(wxWindow* pParent, CModelViewerApp* const pHLMV
 	m_pBonesScale->SetRange(DBL_MIN, DBL_MAX);
 	m_pBonesScale->SetDigits(2);
 
+	m_pRecomputeBounds = new wxButton(elemParent, wxID_ANY, "Recompute Bounds");
+	m_pRecomputeBounds->SetToolTip("Recomputes the bounding box of each sequence from its animation and the model's meshes");
+	m_pRecomputeBounds->Bind(wxEVT_BUTTON, &CModelDataPanel::OnRecomputeBounds, this);
+
 	//Layout
 	auto sizer = new wxGridBagSizer(1, 1);
 
@@ -65,6 +73,8 @@ CModelDataPanel::CModelDataPanel(wxWindow* pParent, CModelViewerApp* const pHLMV
 	scaleSizer->Add(m_pBonesScale, wxGBPosition(1, 0), wxDefaultSpan, wxEXPAND);
 	scaleSizer->Add(m_pBonesScaleButton, wxGBPosition(1, 1), wxDefaultSpan, wxEXPAND);
 
+	scaleSizer->Add(m_pRecomputeBounds, wxGBPosition(2, 0), wxGBSpan(1, 2), wxEXPAND);
+
 	sizer->Add(scaleSizer, wxGBPosition(0, 2), wxGBSpan(4, 1), wxEXPAND, wxALL);
 
 	GetMainSizer()->Add(sizer);
@@ -168,4 +178,20 @@ void CModelDataPanel::OnScaleBones(wxCommandEvent& event)
 		m_pHLMV->GetState()->modelChanged = true;
 	}
 }
+
+void CModelDataPanel::OnRecomputeBounds(wxCommandEvent& event)
+{
+	if (auto entity = m_pHLMV->GetState()->GetEntity(); entity)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		const int updated = studiomdl::RecomputeSequenceBounds(*entity->GetModel());
+
+		const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+		Message("Recomputed the bounds of %d sequences in %lld ms\n", updated, static_cast<long long>(elapsed.count()));
+
+		m_pHLMV->GetState()->modelChanged = true;
+	}
+}
 }
\ No newline at end of file
@@ -47,6 +47,8 @@ private:
 
 	void OnScaleBones(wxCommandEvent& event);
 
+	void OnRecomputeBounds(wxCommandEvent& event);
+
 private:
 	wxSpinCtrlDouble* m_pOrigin[3];
 
@@ -60,6 +62,8 @@ private:
 	wxSpinCtrlDouble* m_pBonesScale;
 	wxButton* m_pBonesScaleButton;
 
+	wxButton* m_pRecomputeBounds;
+
 private:
 	CModelDataPanel(const CModelDataPanel&) = delete;
 	CModelDataPanel& operator=(const CModelDataPanel&) = delete;
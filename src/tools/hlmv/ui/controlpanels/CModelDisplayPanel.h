@@ -67,6 +67,9 @@ public:
 
 	void InitializeUI() override;
 
+	//Nothing here depends on the model's contents, so keep the user's settings
+	void ModelReloaded() override {}
+
 	void SetRenderMode( RenderMode renderMode );
 
 	//0..100
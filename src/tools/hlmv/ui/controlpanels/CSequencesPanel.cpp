@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cfloat>
 
 #include <wx/sizer.h>
@@ -314,6 +315,49 @@ void CSequencesPanel::InitializeUI()
 	this->Enable(bSuccess);
 }
 
+void CSequencesPanel::ModelReloaded()
+{
+	auto pEntity = m_pHLMV->GetState()->GetEntity();
+
+	if( !pEntity )
+	{
+		InitializeUI();
+		return;
+	}
+
+	//Initializing resets the sequence and its settings, so remember what the entity kept
+	const int iSequence = pEntity->GetSequence();
+	const float flFrame = pEntity->GetFrame();
+	const float flBlends[] = {pEntity->GetBlendingValue(0), pEntity->GetBlendingValue(1)};
+
+	InitializeUI();
+
+	SetSequence( iSequence );
+
+	if( m_pSequence->GetSelection() == iSequence )
+	{
+		SetFrame( static_cast<int>( flFrame ) );
+
+		for (int blender = 0; blender < 2; ++blender)
+		{
+			const auto spinner = m_pBlendsSpinners[blender];
+
+			if (spinner->IsEnabled())
+			{
+				const auto value = std::clamp(static_cast<double>(flBlends[blender]), spinner->GetMin(), spinner->GetMax());
+
+				spinner->SetValue(value);
+				m_pBlendsSliders[blender]->SetValue(static_cast<int>(value * m_BlendsScales[blender]));
+
+				pEntity->SetBlending(blender, static_cast<float>(value));
+			}
+		}
+	}
+
+	m_pAnimSpeed->SetValue(static_cast<int>(pEntity->GetFrameRate() * ANIMSPEED_SLIDER_MULTIPLIER));
+	m_pAnimSpeedSpinner->SetValue(pEntity->GetFrameRate());
+}
+
 void CSequencesPanel::SetSequence( int iIndex )
 {
 	if( auto pEntity = m_pHLMV->GetState()->GetEntity() )
@@ -716,7 +760,12 @@ void CSequencesPanel::OnEditEvents( wxCommandEvent& event )
 	UpdateEventInfo( m_pEvent->GetSelection() );
 
 	if( dlg.ChangesSaved() )
+	{
+		//Event frames may have changed
+		pModel->RebuildEventIndex();
+
 		m_pHLMV->GetState()->modelChanged = true;
+	}
 }
 
 void CSequencesPanel::PlaySoundChanged( wxCommandEvent& event )
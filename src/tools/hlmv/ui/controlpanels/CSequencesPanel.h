@@ -28,6 +28,8 @@ public:
 
 	void InitializeUI() override;
 
+	void ModelReloaded() override;
+
 	void SetSequence( int iIndex );
 
 	void SetFrame( int iFrame );
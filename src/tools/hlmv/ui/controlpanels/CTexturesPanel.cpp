@@ -1,9 +1,14 @@
+#include <algorithm>
 #include <new>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <wx/filename.h>
 #include <wx/gbsizer.h>
 #include <wx/image.h>
+#include <wx/progdlg.h>
+#include <wx/utils.h>
 
 #include "wx/utility/wxUtil.h"
 
@@ -13,6 +18,9 @@
 #include "graphics/BMPFile.h"
 
 #include "shared/studiomodel/CStudioModel.h"
+#include "shared/studiomodel/StudioTextureFiles.h"
+
+#include "utility/CBackgroundJobs.h"
 
 #include "../CModelViewerApp.h"
 #include "../../CHLMVState.h"
@@ -31,6 +39,7 @@ wxBEGIN_EVENT_TABLE( CTexturesPanel, CBaseControlPanel )
 	EVT_BUTTON( wxID_TEX_EXPORTTEXTURE, CTexturesPanel::ExportTexture )
 	EVT_BUTTON(wxID_TEX_EXPORTALLTEXTURES, CTexturesPanel::ExportAllTextures)
 	EVT_BUTTON( wxID_TEX_EXPORTUVMAP, CTexturesPanel::ExportUVMap )
+	EVT_BUTTON(wxID_TEX_EXPORTALLUVMAPS, CTexturesPanel::ExportAllUVMaps)
 wxEND_EVENT_TABLE()
 
 CTexturesPanel::CTexturesPanel( wxWindow* pParent, CModelViewerApp* const pHLMV )
@@ -56,6 +65,8 @@ CTexturesPanel::CTexturesPanel( wxWindow* pParent, CModelViewerApp* const pHLMV
 	m_pCheckBoxes[ CheckBox::SHOW_UV_MAP ]			= new wxCheckBox( pElemParent, wxID_TEX_CHECKBOX, "Show UV Map" );
 	m_pCheckBoxes[ CheckBox::OVERLAY_UV_MAP ]		= new wxCheckBox( pElemParent, wxID_TEX_CHECKBOX, "Overlay UV Map" );
 	m_pCheckBoxes[ CheckBox::ANTI_ALIAS_LINES ]		= new wxCheckBox( pElemParent, wxID_TEX_CHECKBOX, "Anti-Alias Lines" );
+	m_pCheckBoxes[ CheckBox::FILL_UV_ISLANDS ]		= new wxCheckBox( pElemParent, wxID_TEX_CHECKBOX, "Export Filled UV Islands" );
+	m_pCheckBoxes[ CheckBox::UV_OVERLAP_HEATMAP ]	= new wxCheckBox( pElemParent, wxID_TEX_CHECKBOX, "Export UV Overlap Heatmap" );
 
 	for( size_t uiIndex = CheckBox::FIRST; uiIndex < CheckBox::COUNT; ++uiIndex )
 	{
@@ -73,6 +84,7 @@ CTexturesPanel::CTexturesPanel( wxWindow* pParent, CModelViewerApp* const pHLMV
 	m_pExportTexButton = new wxButton(buttonsPanel, wxID_TEX_EXPORTTEXTURE, "Export Texture" );
 	m_pExportAllTexturesButton = new wxButton(buttonsPanel, wxID_TEX_EXPORTALLTEXTURES, "Export All Textures");
 	m_pExportUVButton = new wxButton(buttonsPanel, wxID_TEX_EXPORTUVMAP, "Export UV Map" );
+	m_pExportAllUVMapsButton = new wxButton(buttonsPanel, wxID_TEX_EXPORTALLUVMAPS, "Export All UV Maps");
 
 	for (auto& slider : m_pColorSliders)
 	{
@@ -117,6 +129,7 @@ CTexturesPanel::CTexturesPanel( wxWindow* pParent, CModelViewerApp* const pHLMV
 		buttonsSizer->Add(m_pExportTexButton, wxGBPosition(1, 0), wxDefaultSpan, wxEXPAND);
 		buttonsSizer->Add(m_pExportAllTexturesButton, wxGBPosition(1, 1), wxDefaultSpan, wxEXPAND);
 		buttonsSizer->Add(m_pExportUVButton, wxGBPosition(2, 0), wxDefaultSpan, wxEXPAND);
+		buttonsSizer->Add(m_pExportAllUVMapsButton, wxGBPosition(2, 1), wxDefaultSpan, wxEXPAND);
 
 		buttonsPanel->SetSizer(buttonsSizer);
 
@@ -448,6 +461,20 @@ void CTexturesPanel::CheckBoxChanged( wxCommandEvent& event )
 		{
 			m_pHLMV->GetState()->antiAliasUVLines = pCheckBox->GetValue();
 
+			break;
+		}
+
+	case CheckBox::FILL_UV_ISLANDS:
+		{
+			m_pHLMV->GetState()->fillUVIslands = pCheckBox->GetValue();
+
+			break;
+		}
+
+	case CheckBox::UV_OVERLAP_HEATMAP:
+		{
+			m_pHLMV->GetState()->uvOverlapHeatmap = pCheckBox->GetValue();
+
 			break;
 		}
 	}
@@ -459,6 +486,9 @@ void CTexturesPanel::CheckBoxChanged( wxCommandEvent& event )
 	case CheckBox::TRANSPARENT:
 	case CheckBox::FULLBRIGHT:
 		{
+			//Render modes decide the mesh draw order
+			pModel->UpdateMeshDrawOrder();
+
 			m_pHLMV->GetState()->modelChanged = true;
 
 			break;
@@ -481,73 +511,6 @@ void CTexturesPanel::MeshChanged( wxCommandEvent& event )
 	m_pHLMV->GetState()->pUVMesh = pMesh ? pMesh->m_pMesh : nullptr;
 }
 
-void CTexturesPanel::ImportTextureFrom(const wxString& fileName, studiomdl::CStudioModel* pStudioModel, studiohdr_t* pHdr, int textureIndex)
-{
-	//Must be BMP
-	wxImage image(fileName, wxBITMAP_TYPE_BMP);
-
-	if (!image.IsOk())
-	{
-		wxMessageBox(wxString::Format("Failed to load image \"%s\"!", fileName.c_str()));
-		return;
-	}
-
-	const wxPalette& palette = image.GetPalette();
-
-	if (!palette.IsOk())
-	{
-		wxMessageBox(wxString::Format("Palette for image \"%s\" does not exist!", fileName.c_str()));
-		return;
-	}
-
-	mstudiotexture_t& texture = ((mstudiotexture_t*) ((byte*) pHdr + pHdr->textureindex))[textureIndex];
-
-	if (texture.width != image.GetWidth() || texture.height != image.GetHeight())
-	{
-		wxMessageBox(wxString::Format("Image \"%s\" does not have matching dimensions to the current texture (src: %d x %d, dest: %d x %d)",
-			fileName.c_str(),
-			image.GetWidth(), image.GetHeight(),
-			texture.width, texture.height));
-		return;
-	}
-
-	//Convert to 8 bit palette based image.
-	std::unique_ptr<byte[]> texData = std::make_unique<byte[]>(image.GetWidth() * image.GetHeight());
-
-	byte* pDest = texData.get();
-
-	const unsigned char* pSourceData = image.GetData();
-
-	for (int i = 0; i < image.GetWidth() * image.GetHeight(); ++i, ++pDest, pSourceData += 3)
-	{
-		*pDest = palette.GetPixel(pSourceData[0], pSourceData[1], pSourceData[2]);
-	}
-
-	byte convPal[PALETTE_SIZE];
-
-	memset(convPal, 0, sizeof(convPal));
-
-	unsigned char r, g, b;
-
-	for (size_t uiIndex = 0; uiIndex < PALETTE_ENTRIES; ++uiIndex)
-	{
-		if (palette.GetRGB(uiIndex, &r, &g, &b))
-		{
-			convPal[uiIndex * PALETTE_CHANNELS] = r;
-			convPal[uiIndex * PALETTE_CHANNELS + 1] = g;
-			convPal[uiIndex * PALETTE_CHANNELS + 2] = b;
-		}
-	}
-
-	//Copy over the new image data to the texture.
-	memcpy((byte*) pHdr + texture.index, texData.get(), image.GetWidth() * image.GetHeight());
-	memcpy((byte*) pHdr + texture.index + image.GetWidth() * image.GetHeight(), convPal, PALETTE_SIZE);
-
-	pStudioModel->ReplaceTexture(&texture, texData.get(), convPal, pStudioModel->GetTextureId(textureIndex));
-
-	m_pHLMV->GetState()->modelChanged = true;
-}
-
 void CTexturesPanel::ImportTexture( wxCommandEvent& event )
 {
 	auto pEntity = m_pHLMV->GetState()->GetEntity();
@@ -575,7 +538,22 @@ void CTexturesPanel::ImportTexture( wxCommandEvent& event )
 
 	const wxString szFilename = dlg.GetPath();
 
-	ImportTextureFrom(szFilename, pStudioModel, pStudioModel->GetTextureHeader(), iTextureIndex);
+	std::vector<studiomdl::TextureImport> imports( 1 );
+
+	imports[ 0 ].Texture = iTextureIndex;
+	imports[ 0 ].FileName = szFilename.utf8_str().data();
+
+	studiomdl::LoadTextureImport( *pStudioModel->GetTextureHeader(), imports[ 0 ], studiomdl::ShouldResizeTexturesToPowerOf2() );
+
+	if( imports[ 0 ].Result != studiomdl::TextureFileResult::SUCCESS )
+	{
+		wxMessageBox( wxString::Format( "Failed to import image \"%s\": %s", szFilename.c_str(), studiomdl::TextureFileResultToString( imports[ 0 ].Result ) ) );
+		return;
+	}
+
+	studiomdl::ApplyTextureImports( *pStudioModel, imports );
+
+	m_pHLMV->GetState()->modelChanged = true;
 
 	RemapTexture(iTextureIndex);
 }
@@ -602,6 +580,8 @@ void CTexturesPanel::ImportAllTextures(wxCommandEvent& event)
 
 	//For each texture in the model, find if there is a file with the same name in the given directory
 	//If so, try to replace the texture
+	std::vector<studiomdl::TextureImport> imports;
+
 	for (int i = 0; i < pHdr->numtextures; ++i)
 	{
 		mstudiotexture_t& texture = ((mstudiotexture_t*) ((byte*) pHdr + pHdr->textureindex))[i];
@@ -612,11 +592,55 @@ void CTexturesPanel::ImportAllTextures(wxCommandEvent& event)
 
 		if (fileName.FileExists())
 		{
-			ImportTextureFrom(fileName.GetFullPath(), pStudioModel, pHdr, i);
+			auto& import = imports.emplace_back();
+
+			import.Texture = i;
+			import.FileName = fileName.GetFullPath().utf8_str().data();
 		}
 	}
 
+	if (imports.empty())
+	{
+		return;
+	}
+
+	//Files are loaded, checked and converted on worker threads, then uploaded here all at once
+	const bool bPowerOf2 = studiomdl::ShouldResizeTexturesToPowerOf2();
+
+	{
+		CBackgroundJobs jobs(imports.size(), [&](std::size_t index)
+			{
+				studiomdl::LoadTextureImport(*pHdr, imports[index], bPowerOf2);
+			});
+
+		//Nothing is changed if the import is cancelled
+		if (!WaitForJobs(jobs, "Importing textures"))
+		{
+			return;
+		}
+	}
+
+	if (studiomdl::ApplyTextureImports(*pStudioModel, imports) > 0)
+	{
+		m_pHLMV->GetState()->modelChanged = true;
+	}
+
 	RemapTextures();
+
+	wxString errors;
+
+	for (const auto& import : imports)
+	{
+		if (import.Result != studiomdl::TextureFileResult::SUCCESS)
+		{
+			errors += wxString::Format("\"%s\": %s\n", wxString::FromUTF8(import.FileName.c_str()), studiomdl::TextureFileResultToString(import.Result));
+		}
+	}
+
+	if (!errors.empty())
+	{
+		wxMessageBox(wxString::Format("Failed to import images:\n%s", errors.c_str()));
+	}
 }
 
 void CTexturesPanel::ExportTexture( wxCommandEvent& event )
@@ -678,7 +702,9 @@ void CTexturesPanel::ExportAllTextures(wxCommandEvent& event)
 
 	studiohdr_t* const pHdr = pStudioModel->GetTextureHeader();
 
-	wxString errors;
+	std::vector<std::string> fileNames;
+
+	fileNames.reserve(pHdr->numtextures);
 
 	for (int i = 0; i < pHdr->numtextures; ++i)
 	{
@@ -688,12 +714,28 @@ void CTexturesPanel::ExportAllTextures(wxCommandEvent& event)
 
 		fileName.SetName(texture.name);
 
-		auto fullPath = fileName.GetFullPath();
+		fileNames.emplace_back(fileName.GetFullPath().utf8_str().data());
+	}
+
+	std::vector<studiomdl::TextureFileResult> results(fileNames.size(), studiomdl::TextureFileResult::NOT_RUN);
+
+	{
+		CBackgroundJobs jobs(fileNames.size(), [&](std::size_t index)
+			{
+				results[index] = studiomdl::ExportTextureFile(*pHdr, static_cast<int>(index), fileNames[index].c_str());
+			});
+
+		WaitForJobs(jobs, "Exporting textures");
+	}
 
-		if (!graphics::bmpfile::SaveBMPFile(fullPath.c_str(), texture.width, texture.height,
-			(uint8_t*) pHdr + texture.index, (uint8_t*) pHdr + texture.index + texture.width * texture.height))
+	wxString errors;
+
+	for (size_t i = 0; i < fileNames.size(); ++i)
+	{
+		//Cancelled exports are not errors
+		if (results[i] != studiomdl::TextureFileResult::SUCCESS && results[i] != studiomdl::TextureFileResult::NOT_RUN)
 		{
-			errors += wxString::Format("\"%s\"\n", fullPath.c_str());
+			errors += wxString::Format("\"%s\"\n", wxString::FromUTF8(fileNames[i].c_str()));
 		}
 	}
 
@@ -730,7 +772,73 @@ void CTexturesPanel::ExportUVMap( wxCommandEvent& event )
 
 	const wxString szFilename = dlg.GetPath();
 
-	m_pHLMV->SaveUVMap( szFilename, iTextureIndex );
+	const auto image = studiomdl::DrawUVMap( *pStudioModel, iTextureIndex, GetUVMapSettings(), m_pHLMV->GetState()->pUVMesh );
+
+	if( !graphics::bmpfile::SaveRGBBMPFile( szFilename.utf8_str(), image.Width, image.Height, image.Pixels.data() ) )
+	{
+		wxMessageBox( wxString::Format( "Failed to save image \"%s\"!", szFilename.c_str() ) );
+	}
+}
+
+void CTexturesPanel::ExportAllUVMaps(wxCommandEvent& event)
+{
+	auto pEntity = m_pHLMV->GetState()->GetEntity();
+
+	if (!pEntity || !pEntity->GetModel())
+	{
+		wxMessageBox("No model loaded!");
+		return;
+	}
+
+	auto pStudioModel = pEntity->GetModel();
+
+	wxDirDialog dlg(this, "Select the directory to export all UV maps to", wxEmptyString, wxDD_DEFAULT_STYLE | wxDD_NEW_DIR_BUTTON);
+
+	if (dlg.ShowModal() == wxID_CANCEL)
+	{
+		return;
+	}
+
+	studiohdr_t* const pHdr = pStudioModel->GetTextureHeader();
+
+	//Build the file names up front so the threads that draw the UV maps can save them without touching wxWidgets
+	std::vector<std::string> fileNames;
+
+	fileNames.reserve(pHdr->numtextures);
+
+	for (int i = 0; i < pHdr->numtextures; ++i)
+	{
+		const auto& texture = ((mstudiotexture_t*) ((byte*) pHdr + pHdr->textureindex))[i];
+
+		wxFileName fileName(dlg.GetPath(), texture.name);
+
+		fileName.SetName(fileName.GetName() + "_uv");
+		fileName.SetExt("bmp");
+
+		fileNames.emplace_back(fileName.GetFullPath().utf8_str().data());
+	}
+
+	std::vector<char> succeeded(fileNames.size(), false);
+
+	studiomdl::DrawUVMaps(*pStudioModel, GetUVMapSettings(), [&](int texture, studiomdl::UVMapImage&& image)
+		{
+			succeeded[texture] = graphics::bmpfile::SaveRGBBMPFile(fileNames[texture].c_str(), image.Width, image.Height, image.Pixels.data());
+		});
+
+	wxString errors;
+
+	for (size_t i = 0; i < fileNames.size(); ++i)
+	{
+		if (!succeeded[i])
+		{
+			errors += wxString::Format("\"%s\"\n", wxString::FromUTF8(fileNames[i].c_str()));
+		}
+	}
+
+	if (!errors.empty())
+	{
+		wxMessageBox(wxString::Format("Failed to save images:\n%s", errors.c_str()));
+	}
 }
 
 void CTexturesPanel::OnColorSliderChanged(wxCommandEvent& event)
@@ -812,4 +920,41 @@ void CTexturesPanel::RemapTexture(int index)
 		entity->GetModel()->ReplaceTexture(texture, reinterpret_cast<byte*>(textureHeader) + texture->index, palette, textureId);
 	}
 }
+
+bool CTexturesPanel::WaitForJobs(CBackgroundJobs& jobs, const wxString& title)
+{
+	const auto count = static_cast<int>(jobs.GetCount());
+
+	wxProgressDialog dialog(title, wxString::Format("Processed 0 of %d textures", count), std::max(1, count), this,
+		wxPD_APP_MODAL | wxPD_CAN_ABORT | wxPD_AUTO_HIDE | wxPD_ELAPSED_TIME);
+
+	while (!jobs.IsDone())
+	{
+		const auto completed = static_cast<int>(jobs.GetCompletedCount());
+
+		if (!dialog.Update(completed, wxString::Format("Processed %d of %d textures", completed, count)))
+		{
+			jobs.Cancel();
+		}
+
+		wxMilliSleep(10);
+	}
+
+	jobs.Wait();
+
+	return !jobs.IsCancelled();
+}
+
+studiomdl::UVMapSettings CTexturesPanel::GetUVMapSettings() const
+{
+	const auto pState = m_pHLMV->GetState();
+
+	studiomdl::UVMapSettings settings;
+
+	settings.AntiAliasLines = pState->antiAliasUVLines;
+	settings.FillIslands = pState->fillUVIslands;
+	settings.OverlapHeatmap = pState->uvOverlapHeatmap;
+
+	return settings;
+}
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <wx/spinctrl.h>
 #include <wx/textctrl.h>
 
+#include "shared/studiomodel/StudioUVMap.h"
+
 #include "wx/utility/CMeshClientData.h"
 
 #include "CBaseControlPanel.h"
@@ -13,10 +15,11 @@
 #undef TRANSPARENT
 #endif
 
+class CBackgroundJobs;
+
 namespace studiomdl
 {
 class CStudioModel;
-struct studiohdr_t;
 }
 
 namespace hlmv
@@ -44,6 +47,8 @@ public:
 			SHOW_UV_MAP,
 			OVERLAY_UV_MAP,
 			ANTI_ALIAS_LINES,
+			FILL_UV_ISLANDS,
+			UV_OVERLAP_HEATMAP,
 
 			COUNT,
 			LAST				= COUNT - 1	//Must be last
@@ -96,19 +101,27 @@ protected:
 
 	void ExportUVMap( wxCommandEvent& event );
 
+	void ExportAllUVMaps(wxCommandEvent& event);
+
 	void OnColorSliderChanged(wxCommandEvent& event);
 
 	void OnColorSpinnerChanged(wxSpinEvent& event);
 
 private:
-	void ImportTextureFrom(const wxString& fileName, studiomdl::CStudioModel* pStudioModel, studiohdr_t* pHdr, int textureIndex);
-
 	void UpdateColorMapValue();
 
 	void RemapTextures();
 
 	void RemapTexture(int index);
 
+	studiomdl::UVMapSettings GetUVMapSettings() const;
+
+	/**
+	*	@brief Shows a progress dialog until the jobs are done. Cancelling the dialog cancels the jobs that have not started yet
+	*	@return Whether all jobs ran
+	*/
+	bool WaitForJobs(CBackgroundJobs& jobs, const wxString& title);
+
 private:
 	wxStaticText* m_pTextureSize;
 	wxChoice* m_pTexture;
@@ -125,6 +138,7 @@ private:
 	wxButton* m_pExportTexButton;
 	wxButton* m_pExportAllTexturesButton;
 	wxButton* m_pExportUVButton;
+	wxButton* m_pExportAllUVMapsButton;
 
 	wxSlider* m_pColorSliders[2];
 	wxSpinCtrl* m_pColorSpinners[2];
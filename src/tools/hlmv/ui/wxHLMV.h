@@ -109,6 +109,7 @@ enum wxIdentifier
 	wxID_TEX_EXPORTTEXTURE,
 	wxID_TEX_EXPORTALLTEXTURES,
 	wxID_TEX_EXPORTUVMAP,
+	wxID_TEX_EXPORTALLUVMAPS,
 
 	//Fullscreen panel
 	wxID_FULLSCREEN_GO,
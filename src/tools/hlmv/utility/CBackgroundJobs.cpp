@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <exception>
+
+#include "shared/Logging.h"
+
+#include "CBackgroundJobs.h"
+
+CBackgroundJobs::CBackgroundJobs(std::size_t count, Job job, unsigned int numThreads)
+	: m_Count(count)
+	, m_Job(std::move(job))
+{
+	if (numThreads == 0)
+	{
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	numThreads = static_cast<unsigned int>(std::min<std::size_t>(numThreads, std::max<std::size_t>(1, m_Count)));
+
+	m_ActiveThreads = numThreads;
+
+	m_Threads.reserve(numThreads);
+
+	for (unsigned int thread = 0; thread < numThreads; ++thread)
+	{
+		m_Threads.emplace_back(&CBackgroundJobs::Worker, this);
+	}
+}
+
+CBackgroundJobs::~CBackgroundJobs()
+{
+	Cancel();
+	Wait();
+}
+
+void CBackgroundJobs::Wait()
+{
+	for (auto& thread : m_Threads)
+	{
+		if (thread.joinable())
+		{
+			thread.join();
+		}
+	}
+
+	//Logging isn't thread safe, so failures are reported here
+	std::lock_guard<std::mutex> lock(m_ErrorMutex);
+
+	for (const auto& error : m_Errors)
+	{
+		Error("Background job %zu failed: %s\n", error.first, error.second.c_str());
+	}
+
+	m_Errors.clear();
+}
+
+void CBackgroundJobs::Worker()
+{
+	for (std::size_t index; !m_Cancelled && (index = m_NextJob++) < m_Count;)
+	{
+		//An exception escaping a thread would terminate the program, so only the job that threw fails
+		try
+		{
+			m_Job(index);
+		}
+		catch (const std::exception& e)
+		{
+			AddError(index, e.what());
+		}
+		catch (...)
+		{
+			AddError(index, "unknown exception");
+		}
+
+		++m_CompletedCount;
+	}
+
+	--m_ActiveThreads;
+}
+
+void CBackgroundJobs::AddError(std::size_t index, const char* pszMessage)
+{
+	std::lock_guard<std::mutex> lock(m_ErrorMutex);
+
+	m_Errors.emplace_back(index, pszMessage);
+}
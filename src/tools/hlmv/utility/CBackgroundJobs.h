@@ -0,0 +1,81 @@
+#ifndef UTILITY_CBACKGROUNDJOBS_H
+#define UTILITY_CBACKGROUNDJOBS_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+*	@brief Runs a number of independent jobs on worker threads in the background
+*	The thread that started the jobs is free to do other work, such as showing progress, while they run.
+*	Cancelling skips the jobs that have not started yet; jobs that are running are finished.
+*	If a job throws an exception the other jobs keep running. The failure is logged by Wait.
+*/
+class CBackgroundJobs final
+{
+public:
+	using Job = std::function<void(std::size_t index)>;
+
+	/**
+	*	@brief Starts running job(index) for each index in [0, count)
+	*	Jobs are started in order of their index.
+	*	@param numThreads Number of threads to use, or 0 to use all cores
+	*/
+	CBackgroundJobs(std::size_t count, Job job, unsigned int numThreads = 0);
+
+	/**
+	*	@brief Cancels the jobs that have not started yet and waits for the rest to finish
+	*/
+	~CBackgroundJobs();
+
+	std::size_t GetCount() const { return m_Count; }
+
+	/**
+	*	@return Number of jobs that have finished, including those that failed
+	*/
+	std::size_t GetCompletedCount() const { return m_CompletedCount; }
+
+	/**
+	*	@return Whether all threads are done, because all jobs finished or because the rest were cancelled
+	*/
+	bool IsDone() const { return m_ActiveThreads == 0; }
+
+	void Cancel() { m_Cancelled = true; }
+
+	bool IsCancelled() const { return m_Cancelled; }
+
+	/**
+	*	@brief Waits for all threads to be done, then logs the jobs that failed. Must be called from the thread that started the jobs
+	*/
+	void Wait();
+
+private:
+	void Worker();
+
+	void AddError(std::size_t index, const char* pszMessage);
+
+private:
+	const std::size_t m_Count;
+	const Job m_Job;
+
+	std::atomic<std::size_t> m_NextJob{0};
+	std::atomic<std::size_t> m_CompletedCount{0};
+	std::atomic<unsigned int> m_ActiveThreads{0};
+	std::atomic<bool> m_Cancelled{false};
+
+	std::mutex m_ErrorMutex;
+	std::vector<std::pair<std::size_t, std::string>> m_Errors;
+
+	std::vector<std::thread> m_Threads;
+
+private:
+	CBackgroundJobs(const CBackgroundJobs&) = delete;
+	CBackgroundJobs& operator=(const CBackgroundJobs&) = delete;
+};
+
+#endif //UTILITY_CBACKGROUNDJOBS_H
@@ -0,0 +1,140 @@
+#include <utility>
+
+#include "core/shared/Platform.h"
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "CMappedFile.h"
+
+CMappedFile::~CMappedFile()
+{
+	Close();
+}
+
+CMappedFile::CMappedFile(CMappedFile&& other) noexcept
+{
+	Swap(other);
+}
+
+CMappedFile& CMappedFile::operator=(CMappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		Close();
+		Swap(other);
+	}
+
+	return *this;
+}
+
+bool CMappedFile::Open(const std::filesystem::path& fileName)
+{
+	Close();
+
+#ifdef WIN32
+	HANDLE hFile = CreateFileW(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+
+	if (!GetFileSizeEx(hFile, &size) || size.QuadPart == 0 || static_cast<unsigned long long>(size.QuadPart) > SIZE_MAX)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+
+	HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (!hMapping)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+
+	void* pData = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+
+	if (!pData)
+	{
+		CloseHandle(hMapping);
+		CloseHandle(hFile);
+		return false;
+	}
+
+	m_hFile = hFile;
+	m_hMapping = hMapping;
+	m_pData = static_cast<const std::uint8_t*>(pData);
+	m_Size = static_cast<std::size_t>(size.QuadPart);
+#else
+	const int fd = open(fileName.c_str(), O_RDONLY);
+
+	if (fd == -1)
+	{
+		return false;
+	}
+
+	struct stat info;
+
+	if (fstat(fd, &info) == -1 || info.st_size <= 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	void* pData = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+	//The mapping stays valid after the descriptor is closed
+	close(fd);
+
+	if (pData == MAP_FAILED)
+	{
+		return false;
+	}
+
+	m_pData = static_cast<const std::uint8_t*>(pData);
+	m_Size = static_cast<std::size_t>(info.st_size);
+#endif
+
+	return true;
+}
+
+void CMappedFile::Close()
+{
+	if (!m_pData)
+	{
+		return;
+	}
+
+#ifdef WIN32
+	UnmapViewOfFile(m_pData);
+	CloseHandle(m_hMapping);
+	CloseHandle(m_hFile);
+
+	m_hMapping = nullptr;
+	m_hFile = nullptr;
+#else
+	munmap(const_cast<std::uint8_t*>(m_pData), m_Size);
+#endif
+
+	m_pData = nullptr;
+	m_Size = 0;
+}
+
+void CMappedFile::Swap(CMappedFile& other) noexcept
+{
+	std::swap(m_pData, other.m_pData);
+	std::swap(m_Size, other.m_Size);
+
+#ifdef WIN32
+	std::swap(m_hFile, other.m_hFile);
+	std::swap(m_hMapping, other.m_hMapping);
+#endif
+}
@@ -0,0 +1,51 @@
+#ifndef UTILITY_CMAPPEDFILE_H
+#define UTILITY_CMAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+/**
+*	@brief Read-only memory mapping of an entire file
+*/
+class CMappedFile final
+{
+public:
+	CMappedFile() = default;
+	~CMappedFile();
+
+	CMappedFile(CMappedFile&& other) noexcept;
+	CMappedFile& operator=(CMappedFile&& other) noexcept;
+
+	/**
+	*	@brief Maps the given file into memory. Any previously mapped file is closed first
+	*	@return Whether the file was mapped. Empty files cannot be mapped
+	*/
+	bool Open(const std::filesystem::path& fileName);
+
+	void Close();
+
+	bool IsOpen() const { return m_pData != nullptr; }
+
+	const std::uint8_t* GetData() const { return m_pData; }
+
+	std::size_t GetSize() const { return m_Size; }
+
+private:
+	void Swap(CMappedFile& other) noexcept;
+
+private:
+	const std::uint8_t* m_pData = nullptr;
+	std::size_t m_Size = 0;
+
+#ifdef WIN32
+	void* m_hFile = nullptr;
+	void* m_hMapping = nullptr;
+#endif
+
+private:
+	CMappedFile(const CMappedFile&) = delete;
+	CMappedFile& operator=(const CMappedFile&) = delete;
+};
+
+#endif //UTILITY_CMAPPEDFILE_H
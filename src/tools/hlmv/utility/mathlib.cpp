@@ -255,6 +255,30 @@ void QuaternionSlerp( const glm::vec4& p, glm::vec4& q, float t, glm::vec4& qt )
 	}
 }
 
+void QuaternionNlerp( const glm::vec4& p, const glm::vec4& q, float t, glm::vec4& qt )
+{
+	const float cosom = p[ 0 ] * q[ 0 ] + p[ 1 ] * q[ 1 ] + p[ 2 ] * q[ 2 ] + p[ 3 ] * q[ 3 ];
+
+	// flip q if it is backwards, as QuaternionSlerp does
+	const float sclp = 1.0f - t;
+	const float sclq = cosom < 0 ? -t : t;
+
+	float length = 0;
+
+	for( int i = 0; i < 4; ++i )
+	{
+		qt[ i ] = sclp * p[ i ] + sclq * q[ i ];
+		length += qt[ i ] * qt[ i ];
+	}
+
+	length = 1.0f / sqrt( length );
+
+	for( int i = 0; i < 4; ++i )
+	{
+		qt[ i ] *= length;
+	}
+}
+
 glm::vec3 VectorToAngles( const glm::vec3& vec )
 {
 	//Xash3D implementation
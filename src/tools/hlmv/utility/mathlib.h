@@ -146,6 +146,12 @@ void QuaternionMatrix( const glm::vec4& quaternion, glm::mat3x4& matrix );
 */
 void QuaternionSlerp( const glm::vec4& p, glm::vec4& q, float t, glm::vec4& qt );
 
+/**
+*	Normalized linear interpolation between p and q, along the shorter path like QuaternionSlerp.
+*	Cheaper than QuaternionSlerp, but only accurate when p and q are close together.
+*/
+void QuaternionNlerp( const glm::vec4& p, const glm::vec4& q, float t, glm::vec4& qt );
+
 /**
 *	Converts a vector to angles.
 *	@param vec Vector.